@@ -7,13 +7,26 @@
 
 #include "Common.fxh"
 
-float4x4   LightWVP;
+float4x4   LightWVP;	// light view-projection matrix if instancing is used
 
 struct VertexShaderOutput
 {
 	float4	positionH : SV_Position;
 };
 
+#ifdef USE_INSTANCING
+
+VertexShaderOutput VS_Main( rxVertex input, rxInstance instance )
+{
+	VertexShaderOutput  output;
+
+	float4 positionW = mul( float4( input.position, 1 ), GetInstanceTransform( instance ) );
+	output.positionH = mul( positionW, LightWVP );
+	return output;
+}
+
+#else
+
 VertexShaderOutput VS_Main( rxVertex input )
 {
 	VertexShaderOutput  output;
@@ -24,6 +37,8 @@ VertexShaderOutput VS_Main( rxVertex input )
 	return output;
 }
 
+#endif // !USE_INSTANCING
+
 void PS_Main( VertexShaderOutput input )
 {}
 
@@ -0,0 +1,10 @@
+/*
+=============================================================================
+	File:	BuildShadowMap_Instanced.fx
+	Desc:	HLSL code to write a hardware depth map (depth-stencil texture).
+		Per-object transforms are read from the instance stream.
+=============================================================================
+*/
+
+#define USE_INSTANCING
+#include "BuildShadowMap.fx"
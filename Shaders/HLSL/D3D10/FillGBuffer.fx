@@ -33,19 +33,36 @@ struct VertexShaderOutput
 	float2	texCoord  : TexCoord1;		// texture coordinates
 };
 
-VertexShaderOutput VS_Main( rxVertex input )
+VertexShaderOutput TransformVertex( rxVertex input, float4x4 worldTransform )
 {
 	VertexShaderOutput  output;
 
-	output.positionW 	= mul( float4( input.position, 1 ), WorldTransform );
+	output.positionW 	= mul( float4( input.position, 1 ), worldTransform );
 	output.positionH	= mul( float4( output.positionW ), ViewProjection );
-	output.normalW		= mul( input.normal, (float3x3)WorldTransform );
-	output.tangentW		= mul( input.tangent, (float3x3)WorldTransform );
+	output.normalW		= mul( input.normal, (float3x3)worldTransform );
+	output.tangentW		= mul( input.tangent, (float3x3)worldTransform );
 	output.texCoord		= input.texCoord;
 
 	return output;
 }
 
+#ifdef USE_INSTANCING
+
+// world transform is taken from the instance stream, 'WorldTransform' is not used
+VertexShaderOutput VS_Main( rxVertex input, rxInstance instance )
+{
+	return TransformVertex( input, GetInstanceTransform( instance ) );
+}
+
+#else
+
+VertexShaderOutput VS_Main( rxVertex input )
+{
+	return TransformVertex( input, WorldTransform );
+}
+
+#endif // !USE_INSTANCING
+
 //-------------------------------------------------------------------
 //	Fragment program.
 //-------------------------------------------------------------------
@@ -0,0 +1,10 @@
+/*
+=============================================================================
+	File:	FillGBuffer_Instanced.fx
+	Desc:	HLSL code to fill geometry buffer.
+		Per-object transforms are read from the instance stream.
+=============================================================================
+*/
+
+#define USE_INSTANCING
+#include "FillGBuffer.fx"
@@ -16,16 +16,22 @@
 #include <Types/Checks.h>			// Sanity types.
 
 #include <Memory/Memory.h>			// Memory management.
+#include <Memory/FrameArena/FrameArena.h>	// Per-frame scratch memory.
+#include <Memory/ConcurrentPool/ConcurrentPool.h>	// Thread-safe pools.
 
 #include <Lib/Lib.h>				// Foundation Library.
 
+#include <System/TaskPool.h>		// Worker threads.
+
 #include <Object/ObjectFactory.h>	// Class factory. NOTE: must be included before 'RTTI.h' !
 #include <Object/RTTI.h>			// Run-Time Type Information.
 #include <Object/Object.h>			// Base class. NOTE: must be included after 'RTTI.h' !
 #include <Object/Message.h>			// Messaging.
 
 #include <IO/DataStream.h>		// Input/Output system.
+#include <IO/BufferedStream.h>	// Buffered reads and writes.
 #include <IO/Files.h>			// File system.
+#include <IO/PackFile.h>		// Archives.
 
 #endif // !__MX_SHARED_BASE_H__
 
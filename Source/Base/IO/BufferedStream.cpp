@@ -0,0 +1,164 @@
+/*
+=============================================================================
+	File:	BufferedStream.cpp
+	Desc:	Buffering of reads and writes for any data stream.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+mxBufferedStream::mxBufferedStream( mxDataStream& stream, SizeT bufferSize )
+	: m_stream( stream )
+	, m_buffer( null )
+	, m_bufferSize( bufferSize )
+	, m_readPos( 0 )
+	, m_readEnd( 0 )
+	, m_writeSize( 0 )
+{
+	Assert( bufferSize > 0 );
+	m_buffer = new BYTE[ bufferSize ];
+}
+
+mxBufferedStream::~mxBufferedStream()
+{
+	Flush();
+	delete[] m_buffer;
+}
+
+void mxBufferedStream::Flush()
+{
+	if ( m_writeSize > 0 )
+	{
+		const SizeT bytesWritten = m_stream.Write( m_buffer, m_writeSize );
+		Assert( bytesWritten == m_writeSize );
+		(void) bytesWritten;
+		m_writeSize = 0;
+	}
+}
+
+void mxBufferedStream::DiscardReadBuffer()
+{
+	const SizeT unreadBytes = m_readEnd - m_readPos;
+	if ( unreadBytes > 0 ) {
+		m_stream.Skip( -static_cast< mxLong >( unreadBytes ) );
+	}
+	m_readPos = 0;
+	m_readEnd = 0;
+}
+
+SizeT mxBufferedStream::Read( void* pBuffer, SizeT numBytes )
+{
+	Flush();
+
+	BYTE * dest = static_cast< BYTE* >( pBuffer );
+
+	// copy what is left in the buffer
+	const SizeT bufferedBytes = Min( numBytes, m_readEnd - m_readPos );
+	if ( bufferedBytes > 0 )
+	{
+		MemCopy( dest, m_buffer + m_readPos, bufferedBytes );
+		m_readPos += bufferedBytes;
+		dest += bufferedBytes;
+		numBytes -= bufferedBytes;
+	}
+
+	if ( numBytes == 0 ) {
+		return bufferedBytes;
+	}
+
+	// large reads go directly into the destination
+	if ( numBytes >= m_bufferSize ) {
+		m_readPos = 0;
+		m_readEnd = 0;
+		return bufferedBytes + m_stream.Read( dest, numBytes );
+	}
+
+	m_readPos = 0;
+	m_readEnd = m_stream.Read( m_buffer, m_bufferSize );
+
+	const SizeT bytesFromRefill = Min( numBytes, m_readEnd );
+	if ( bytesFromRefill > 0 ) {
+		MemCopy( dest, m_buffer, bytesFromRefill );
+		m_readPos = bytesFromRefill;
+	}
+	return bufferedBytes + bytesFromRefill;
+}
+
+SizeT mxBufferedStream::Write( const void* pBuffer, SizeT numBytes )
+{
+	DiscardReadBuffer();
+
+	if ( m_writeSize + numBytes > m_bufferSize ) {
+		Flush();
+	}
+
+	// large writes bypass the buffer
+	if ( numBytes >= m_bufferSize ) {
+		return m_stream.Write( pBuffer, numBytes );
+	}
+
+	MemCopy( m_buffer + m_writeSize, pBuffer, numBytes );
+	m_writeSize += numBytes;
+	return numBytes;
+}
+
+void mxBufferedStream::Seek( const SizeT offset )
+{
+	Flush();
+
+	// seeking within the read buffer doesn't touch the underlying stream
+	if ( m_readEnd > 0 )
+	{
+		const SizeT bufferStart = m_stream.Tell() - m_readEnd;
+		if ( offset >= bufferStart && offset <= bufferStart + m_readEnd ) {
+			m_readPos = offset - bufferStart;
+			return;
+		}
+	}
+
+	m_readPos = 0;
+	m_readEnd = 0;
+	m_stream.Seek( offset );
+}
+
+void mxBufferedStream::Skip( mxLong offset )
+{
+	const mxLong newPosition = static_cast< mxLong >( Tell() ) + offset;
+	Seek( ( newPosition > 0 ) ? static_cast< SizeT >( newPosition ) : 0 );
+}
+
+SizeT mxBufferedStream::GetSize() const
+{
+	// buffered writes can extend the stream
+	return Max( m_stream.GetSize(), Tell() );
+}
+
+SizeT mxBufferedStream::Tell() const
+{
+	return m_stream.Tell() - ( m_readEnd - m_readPos ) + m_writeSize;
+}
+
+bool mxBufferedStream::IsOpen() const
+{
+	return m_stream.IsOpen();
+}
+
+bool mxBufferedStream::AtEnd() const
+{
+	return ( m_readPos == m_readEnd ) && m_stream.AtEnd();
+}
+
+bool mxBufferedStream::IsOk() const
+{
+	return m_stream.IsOk();
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,79 @@
+/*
+=============================================================================
+	File:	BufferedStream.h
+	Desc:	Buffering of reads and writes for any data stream.
+=============================================================================
+*/
+
+#ifndef __MX_BUFFERED_STREAM_H__
+#define __MX_BUFFERED_STREAM_H__
+
+namespace abc {
+
+//
+//	mxBufferedStream - reads and writes the underlying stream in large blocks.
+//
+//	Small reads (e.g. ReadInt(), ReadFloat()) are served from the buffer,
+//	so they don't result in a call to the C runtime or the OS for each value.
+//	Requests larger than the buffer bypass it.
+//
+//	The underlying stream is not owned and must outlive the buffered stream.
+//
+class mxBufferedStream : public mxDataStream {
+public:
+	enum {
+		DEFAULT_BUFFER_SIZE = 64 * 1024
+	};
+
+	mxBufferedStream( mxDataStream& stream, SizeT bufferSize = DEFAULT_BUFFER_SIZE );
+	~mxBufferedStream();	// flushes buffered writes
+
+	// Writes buffered data to the underlying stream.
+	void	Flush();
+
+	//
+	//	Override ( mxDataStream ) :
+	//
+	SizeT	Read( void* pBuffer, SizeT numBytes );
+	SizeT	Write( const void* pBuffer, SizeT numBytes );
+
+	void	Seek( const SizeT offset );
+
+	void	Skip( mxLong offset );
+
+	SizeT	GetSize() const;
+	SizeT	Tell() const;
+
+	bool	IsOpen() const;
+
+	bool	AtEnd() const;
+
+	bool	IsOk() const;
+
+private:
+	// Drops buffered (unread) data and moves the underlying stream back to the current position.
+	void	DiscardReadBuffer();
+
+private:
+	mxDataStream &	m_stream;
+
+	BYTE *	m_buffer;
+	SizeT	m_bufferSize;
+
+	// the buffer is used either for reading or for writing
+	SizeT	m_readPos;		// unread data is in [m_readPos, m_readEnd)
+	SizeT	m_readEnd;
+	SizeT	m_writeSize;	// number of buffered bytes not yet written
+
+private:
+	NO_COPY_CONSTRUCTOR( mxBufferedStream );
+	NO_ASSIGNMENT( mxBufferedStream );
+};
+
+}//End of namespace abc
+
+#endif // ! __MX_BUFFERED_STREAM_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
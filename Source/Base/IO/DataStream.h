@@ -78,6 +78,34 @@ public:
 		return result;
 	}
 
+	// Bulk reading/writing of plain data (e.g. vertices) - one virtual call per array
+	// instead of one call per element. Return the number of whole elements read/written.
+
+	template< typename T >
+	SizeT ReadArray( T* elements, SizeT numElements )
+	{
+		return this->Read( elements, numElements * sizeof(T) ) / sizeof(T);
+	}
+	template< typename T >
+	SizeT WriteArray( const T* elements, SizeT numElements )
+	{
+		return this->Write( elements, numElements * sizeof(T) ) / sizeof(T);
+	}
+
+	// Resizes the array and reads the elements, returns false if the stream ended too early.
+	template< typename T >
+	bool ReadArray( TArray< T > &OutElements, SizeT numElements )
+	{
+		OutElements.SetNum( numElements );
+		return ( numElements == 0 ) || ( ReadArray( OutElements.Ptr(), numElements ) == numElements );
+	}
+	template< typename T >
+	bool WriteArray( const TArray< T >& elements )
+	{
+		const SizeT numElements = elements.Num();
+		return ( numElements == 0 ) || ( WriteArray( elements.Ptr(), numElements ) == numElements );
+	}
+
 public:
 	virtual	~mxDataStream() {}
 };
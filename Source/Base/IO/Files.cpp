@@ -21,6 +21,36 @@ static mxFileSystem * GFileSys = null;	// singleton access
 
 }//end of anonymous namespace
 
+/*================================
+		mxNormalizeFileName
+================================*/
+
+bool mxNormalizeFileName( const mxChar* fileName, mxChar* buffer, mxUInt bufferSize )
+{
+	while ( fileName[0] == '.' && ( fileName[1] == '/' || fileName[1] == '\\' ) ) {
+		fileName += 2;
+	}
+
+	if ( fileName[0] == '\0' || fileName[0] == '/' || fileName[0] == '\\' ) {
+		return false;
+	}
+
+	mxUInt i = 0;
+	for ( ; fileName[i] != '\0'; i++ )
+	{
+		const mxChar c = fileName[i];
+		if ( i + 1 >= bufferSize || c == ':' ) {
+			return false;
+		}
+		if ( c == '.' && fileName[i+1] == '.' ) {
+			return false;
+		}
+		buffer[i] = ( c == '\\' ) ? '/' : String::ToLower( c );
+	}
+	buffer[i] = '\0';
+	return true;
+}
+
 /*================================
 		mxDir
 ================================*/
@@ -96,15 +126,15 @@ const mxChar * mxFilePath::GetExtension() const
 
 bool mxFilePath::Exists() const
 {
-	MX_OPTIMIZE( "too many FileExists() calls, many redundant ones" )
-
-	if ( sys::FileExists( this->fileName.ToChar() ) )
+	// the file system looks in the current directory first (it's the first search path),
+	// so it's not searched on the disk
+	if( !GFileSys )
 	{
-		return true;
+		return sys::FileExists( this->fileName.ToChar() );
 	}
 
 	String  tmp;
-	if( GFileSys && GFileSys->FindFile( *this, tmp ) )
+	if( GFileSys->FindFile( *this, tmp ) )
 	{
 		this->fileName = tmp;
 		return true;
@@ -123,6 +153,7 @@ bool mxFilePath::IsValid() const
 ================================*/
 
 mxFileSystem::mxFileSystem()
+	: bIndexIsDirty( true )
 {
 	// singleton
 	ENSURE_ONE_CALL;
@@ -133,6 +164,12 @@ mxFileSystem::mxFileSystem()
 
 mxFileSystem::~mxFileSystem()
 {
+	for ( mxUInt i = 0; i < this->changeNotifications.Num(); i++ )
+	{
+		if ( this->changeNotifications[i] != INVALID_HANDLE_VALUE ) {
+			::FindCloseChangeNotification( this->changeNotifications[i] );
+		}
+	}
 	GFileSys = null;
 }
 
@@ -151,7 +188,16 @@ void mxFileSystem::AddDir( const mxChar* path )
 		sys::Print( "Path '%s' is invalid\n", path );
 	}
 #else
+	sys::ScopedLock  scopedLock( this->lock );
+
 	this->folders.Append( path );
+
+	// the empty path is the current directory
+	const mxChar * watchedPath = ( path[0] != '\0' ) ? path : ".";
+	this->changeNotifications.Append( ::FindFirstChangeNotification( watchedPath, TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME ) );
+
+	this->bIndexIsDirty = true;
 #endif
 }
 
@@ -161,13 +207,177 @@ void mxFileSystem::AddDir( const mxChar* path )
 bool mxFileSystem::FindFile( const mxFilePath& fileName, String &OutFileName )
 {
 	Assert( fileName.IsValid() );
+	return Lookup( fileName.GetName(), OutFileName );
+}
+
+//
+//	mxFileSystem::FileExists
+//
+bool mxFileSystem::FileExists( const mxFilePath& fileName ) const
+{
+	Assert( fileName.IsValid() );
+	String  temp;
+	return Lookup( fileName.GetName(), temp );
+}
+
+void mxFileSystem::Rescan()
+{
+	sys::ScopedLock  scopedLock( this->lock );
+	this->bIndexIsDirty = true;
+}
+
+//
+//	mxFileSystem::CheckForChanges
+//
+void mxFileSystem::CheckForChanges()
+{
+	bool bChanged = false;
+
+	for ( mxUInt i = 0; i < this->changeNotifications.Num(); i++ )
+	{
+		const HANDLE hChange = this->changeNotifications[i];
+		if ( hChange != INVALID_HANDLE_VALUE
+			&& ::WaitForSingleObject( hChange, 0 ) == WAIT_OBJECT_0 )
+		{
+			::FindNextChangeNotification( hChange );
+			bChanged = true;
+		}
+	}
+
+	if ( bChanged ) {
+		Rescan();
+	}
+}
+
+//
+//	mxFileSystem::MountArchive
+//
+bool mxFileSystem::MountArchive( const mxChar* archiveName )
+{
+	AssertPtr( archiveName );
+
+	String  archivePath;
+	if ( ! Lookup( archiveName, archivePath ) ) {
+		sys::Warning( "Archive '%s' not found\n", archiveName );
+		return false;
+	}
+
+	RefPtr< mxPackFile >  archive( MX_NEW mxPackFile() );
+	if ( ! archive->Open( archivePath.ToChar() ) ) {
+		return false;
+	}
+
+	sys::ScopedLock  scopedLock( this->lock );
+	this->archives.Append( archive );
+	return true;
+}
+
+//
+//	mxFileSystem::OpenFile
+//
+mxDataStream * mxFileSystem::OpenFile( const mxChar* fileName )
+{
+	AssertPtr( fileName );
+
+	// loose files override packed ones
+	String  filePath;
+	if ( Lookup( fileName, filePath ) )
+	{
+		mxMappedFileStream * mappedFile = MX_NEW mxMappedFileStream();
+		if ( mappedFile->Open( filePath.ToChar() ) ) {
+			return mappedFile;
+		}
+		MX_FREE( mappedFile );
+
+		// empty files cannot be mapped
+		mxFile_ReadOnly * file = MX_NEW mxFile_ReadOnly( mxFilePath( filePath.ToChar() ) );
+		if ( file->IsOpen() ) {
+			return file;
+		}
+		MX_FREE( file );
+		return null;
+	}
+
+	mxChar  key[ sys::MAX_PATH_CHARS ];
+	if ( ! mxNormalizeFileName( fileName, key, ARRAY_SIZE(key) ) ) {
+		return null;
+	}
+
+	// archives mounted later have higher priority
+	RefPtr< mxPackFile >  archive;
+	INT  entryIndex = INDEX_NONE;
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+
+		for ( INT iArchive = (INT)this->archives.Num() - 1; iArchive >= 0; iArchive-- )
+		{
+			entryIndex = this->archives[ iArchive ]->FindNormalizedEntry( key );
+			if ( entryIndex != INDEX_NONE ) {
+				archive = this->archives[ iArchive ];
+				break;
+			}
+		}
+	}
+
+	// the entry is decompressed outside of the lock
+	// (the reference keeps the archive alive, references are atomic)
+	return ( entryIndex != INDEX_NONE ) ? archive->OpenEntry( entryIndex ) : null;
+}
+
+//
+//	mxFileSystem::Lookup
+//
+bool mxFileSystem::Lookup( const mxChar* fileName, String &OutFileName ) const
+{
+	mxChar  key[ sys::MAX_PATH_CHARS ];
+	const bool bIndexed = mxNormalizeFileName( fileName, key, ARRAY_SIZE(key) );
+	const mxChar * pKey = key;
+
+	sys::ScopedLock  scopedLock( this->lock );
+
+	if ( bIndexed )
+	{
+		if ( this->bIndexIsDirty ) {
+			RebuildIndex();
+		}
+		if ( const String * path = this->fileIndex.Find( pKey ) )
+		{
+			OutFileName = *path;
+			return true;
+		}
+		if ( this->missingFiles.Contains( pKey ) ) {
+			return false;
+		}
+	}
+
+	// the file may have been created after the folders were scanned
+	// (change notifications are only polled once per frame)
+	if ( ProbeFolders( fileName, OutFileName ) )
+	{
+		if ( bIndexed ) {
+			this->fileIndex.Set( pKey, OutFileName );
+		}
+		return true;
+	}
 
+	// don't probe the folders again until the next rescan
+	if ( bIndexed ) {
+		this->missingFiles.Set( pKey, true );
+	}
+	return false;
+}
+
+//
+//	mxFileSystem::ProbeFolders - searches the file on the disk.
+//
+bool mxFileSystem::ProbeFolders( const mxChar* fileName, String &OutFileName ) const
+{
 	for ( IndexT iDir = 0; iDir < folders.Num(); iDir++ )
 	{
 		const mxDir & dir = this->folders[ iDir ];
 		
 		OutFileName.Empty();
-		_sprintf( OutFileName, "%s%s", dir.GetName(), fileName.GetName() );
+		_sprintf( OutFileName, "%s%s", dir.GetName(), fileName );
 		if ( sys::FileExists( OutFileName.ToChar() ) )
 		{
 			return true;
@@ -177,22 +387,69 @@ bool mxFileSystem::FindFile( const mxFilePath& fileName, String &OutFileName )
 }
 
 //
-//	mxFileSystem::FileExists
+//	mxFileSystem::RebuildIndex
 //
-bool mxFileSystem::FileExists( const mxFilePath& fileName ) const
+void mxFileSystem::RebuildIndex() const
 {
-	Assert( fileName.IsValid() );
+	MX_PROFILE( "Scan folders" );
 
+	this->fileIndex.Clear();
+	this->missingFiles.Clear();
+
+	// folders are scanned in the search order, the first found file wins
+	const String  emptyPath;
 	for ( IndexT iDir = 0; iDir < folders.Num(); iDir++ )
 	{
-		const mxDir & dir = this->folders[ iDir ];
-		
-		if ( dir.ContainsFile( fileName ) )
+		ScanFolder( this->folders[ iDir ].GetName(), emptyPath );
+	}
+
+	this->bIndexIsDirty = false;
+}
+
+//
+//	mxFileSystem::ScanFolder - adds files in the folder and its subfolders to the index.
+//
+void mxFileSystem::ScanFolder( const String& folderName, const String& relativePath ) const
+{
+	String  searchPattern;
+	_sprintf( searchPattern, "%s%s*", folderName.ToChar(), relativePath.ToChar() );
+
+	WIN32_FIND_DATA  findData;
+	const HANDLE hFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+	if ( hFind == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+
+	do
+	{
+		// skip ".", ".." and hidden folders (e.g. of version control systems)
+		if ( findData.cFileName[0] == '.' ) {
+			continue;
+		}
+
+		String  relativeName( relativePath );
+		relativeName.Append( findData.cFileName );
+
+		if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
 		{
-			return true;
+			relativeName.Append( '/' );
+			ScanFolder( folderName, relativeName );
+			continue;
+		}
+
+		mxChar  key[ sys::MAX_PATH_CHARS ];
+		if ( mxNormalizeFileName( relativeName.ToChar(), key, ARRAY_SIZE(key) ) )
+		{
+			String  filePath( folderName );
+			filePath.Append( relativeName );
+
+			const mxChar * pKey = key;
+			this->fileIndex.Add( pKey, filePath );	// doesn't replace files found in previous folders
 		}
 	}
-	return false;
+	while ( ::FindNextFile( hFind, &findData ) );
+
+	::FindClose( hFind );
 }
 
 /*================================
@@ -210,10 +467,11 @@ mxFile_ReadOnly::mxFile_ReadOnly( const mxFilePath& filename )
 		return;
 	}
 
-	m_pFILE = fopen( filename.GetName(), "r" );
-	AssertPtr( m_pFILE );
+	// binary mode: text mode translates line endings and stops at Ctrl-Z
+	m_pFILE = fopen( filename.GetName(), "rb" );
 	if ( ! m_pFILE ) {
-		sys::Warning( "Failed to open file '%s' for reading", filename );
+		sys::Warning( "Failed to open file '%s' for reading", filename.GetName() );
+		return;
 	}
 
 	// Get the length of the file.
@@ -291,6 +549,219 @@ bool mxFile_ReadOnly::IsOk() const
 	return ( null != this->m_pFILE );
 }
 
+/*================================
+		mxMappedFile
+================================*/
+
+mxMappedFile::mxMappedFile()
+	: m_hFile( INVALID_HANDLE_VALUE )
+	, m_hMapping( null )
+	, m_data( null )
+	, m_size( 0 )
+{
+}
+
+mxMappedFile::~mxMappedFile()
+{
+	Close();
+}
+
+bool mxMappedFile::Open( const mxChar* filename )
+{
+	AssertPtr( filename );
+	Close();
+
+	m_hFile = ::CreateFile( filename, GENERIC_READ, FILE_SHARE_READ, null,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, null );
+	if ( m_hFile == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+
+	LARGE_INTEGER  fileSize;
+	if ( ! ::GetFileSizeEx( m_hFile, &fileSize ) || fileSize.HighPart != 0 || fileSize.LowPart == 0 ) {
+		Close();
+		return false;
+	}
+
+	// PAGE_WRITECOPY allows the caller to patch the data in place.
+	m_hMapping = ::CreateFileMapping( m_hFile, null, PAGE_WRITECOPY, 0, 0, null );
+	if ( ! m_hMapping ) {
+		sys::Warning( "Failed to create a file mapping for '%s'\n", filename );
+		Close();
+		return false;
+	}
+
+	m_data = static_cast< BYTE* >( ::MapViewOfFile( m_hMapping, FILE_MAP_COPY, 0, 0, 0 ) );
+	if ( ! m_data ) {
+		sys::Warning( "Failed to map file '%s'\n", filename );
+		Close();
+		return false;
+	}
+
+	m_size = fileSize.LowPart;
+	return true;
+}
+
+void mxMappedFile::Close()
+{
+	if ( m_data ) {
+		::UnmapViewOfFile( m_data );
+		m_data = null;
+	}
+	if ( m_hMapping ) {
+		::CloseHandle( m_hMapping );
+		m_hMapping = null;
+	}
+	if ( m_hFile != INVALID_HANDLE_VALUE ) {
+		::CloseHandle( m_hFile );
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+	m_size = 0;
+}
+
+bool mxMappedFile::IsOpen() const
+{
+	return ( null != m_data );
+}
+
+BYTE * mxMappedFile::GetData() const
+{
+	return m_data;
+}
+
+SizeT mxMappedFile::GetSize() const
+{
+	return m_size;
+}
+
+/*================================
+		mxMappedFileStream
+================================*/
+
+mxMappedFileStream::mxMappedFileStream()
+	: m_data( null )
+	, m_size( 0 )
+	, m_position( 0 )
+{
+}
+
+mxMappedFileStream::~mxMappedFileStream()
+{
+	Close();
+}
+
+bool mxMappedFileStream::Open( const mxChar* filename )
+{
+	mxMappedFilePtr  file( MX_NEW mxMappedFile() );
+	if ( ! file->Open( filename ) ) {
+		return false;
+	}
+	return Open( file, 0, file->GetSize() );
+}
+
+bool mxMappedFileStream::Open( mxMappedFile* file, SizeT offset, SizeT size )
+{
+	AssertPtr( file );
+	Close();
+
+	if ( ! file->IsOpen() || offset > file->GetSize() || size > file->GetSize() - offset ) {
+		return false;
+	}
+
+	m_file = file;
+	m_data = file->GetData() + offset;
+	m_size = size;
+	return true;
+}
+
+void mxMappedFileStream::Close()
+{
+	m_file = null;
+	m_data = null;
+	m_size = 0;
+	m_position = 0;
+}
+
+SizeT mxMappedFileStream::Read( void* pBuffer, SizeT numBytes )
+{
+	const SizeT bytesToRead = Min( numBytes, Remaining() );
+	if ( bytesToRead > 0 ) {
+		MemCopy( pBuffer, m_data + m_position, bytesToRead );
+		m_position += bytesToRead;
+	}
+	return bytesToRead;
+}
+
+SizeT mxMappedFileStream::Write( const void* pBuffer, SizeT numBytes )
+{
+	InvalidCall;
+	return 0;
+}
+
+void mxMappedFileStream::Seek( const SizeT offset )
+{
+	Assert( offset <= m_size );
+	m_position = Min( offset, m_size );
+}
+
+void mxMappedFileStream::Skip( mxLong offset )
+{
+	if ( offset < 0 ) {
+		const SizeT back = static_cast< SizeT >( -offset );
+		m_position = ( back < m_position ) ? m_position - back : 0;
+	} else {
+		m_position += Min( static_cast< SizeT >( offset ), Remaining() );
+	}
+}
+
+SizeT mxMappedFileStream::GetSize() const
+{
+	return m_size;
+}
+
+SizeT mxMappedFileStream::Tell() const
+{
+	return m_position;
+}
+
+bool mxMappedFileStream::IsOpen() const
+{
+	return ( null != m_data );
+}
+
+bool mxMappedFileStream::AtEnd() const
+{
+	return ( m_position >= m_size );
+}
+
+SizeT mxMappedFileStream::Remaining() const
+{
+	return m_size - m_position;
+}
+
+const BYTE * mxMappedFileStream::GetPtr() const
+{
+	return m_data + m_position;
+}
+
+const BYTE * mxMappedFileStream::GetPtr( SizeT offset, SizeT numBytes ) const
+{
+	if ( offset > m_size || numBytes > m_size - offset ) {
+		return null;
+	}
+	return m_data + offset;
+}
+
+const BYTE * mxMappedFileStream::ReadPtr( SizeT numBytes )
+{
+	if ( numBytes > Remaining() ) {
+		return null;
+	}
+	const BYTE * result = m_data + m_position;
+	m_position += numBytes;
+	return result;
+}
+
 }//End of namespace abc
 
 //--------------------------------------------------------------//
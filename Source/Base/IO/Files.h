@@ -22,6 +22,7 @@ namespace abc {
 class mxDir;
 class mxFilePath;
 class mxFile;
+class mxPackFile;
 
 //
 //	mxDirName - directory name.
@@ -33,6 +34,13 @@ typedef String	mxDirName;
 //
 typedef String	mxFileName;
 
+//
+//	mxNormalizeFileName - converts a relative file name into the key used by file lookups
+//	(lower case, forward slashes, without leading "./").
+//	Returns false if the name cannot be indexed (absolute paths, names with "..").
+//
+bool mxNormalizeFileName( const mxChar* fileName, mxChar* buffer, mxUInt bufferSize );
+
 //
 //	mxDir - represents a directory, a folder containing zero ore more files.
 //
@@ -91,6 +99,17 @@ private:
 //
 //	mxFileSystem - responsible for searching/creating/opening/etc files.
 //
+//	The registered folders (and their subfolders) are scanned into a hashed index
+//	of relative file names, so that file lookups don't touch the disk.
+//	Files created after the scan are still found (and added to the index) by probing the folders.
+//	Names which were not found are remembered, so that repeated misses don't touch the disk either.
+//	The index (and the list of missing files) is rebuilt when change notifications report
+//	that files have been added or removed, or after an explicit call to Rescan().
+//
+//	Files can also be read from mounted pack files (see PackFile.h).
+//	Loose files in the registered folders override packed files with the same name,
+//	so that edited assets can be tested without rebuilding the archives.
+//
 //	Notes: only one instance of mxFileSystem can be created!
 //
 class mxFileSystem {
@@ -107,6 +126,19 @@ public:
 			// returns 'true' if such file exists, 'false' otherwise.
 	bool	FileExists( const mxFilePath& fileName ) const;
 
+			// Rebuilds the index of files in the registered folders on the next lookup.
+	void	Rescan();
+
+			// Polls change notifications of the registered folders (called by the engine every frame).
+	void	CheckForChanges();
+
+			// Mounts a pack file, files in archives mounted later override files in earlier ones.
+	bool	MountArchive( const mxChar* archiveName );
+
+			// Opens a file for reading: loose files are searched first, then the mounted archives.
+			// Returns null if the file doesn't exist, the caller must delete the stream.
+	mxDataStream *	OpenFile( const mxChar* fileName );
+
 private:
 	// Only mxEngine can create/destroy mxFileSystem.
 	friend class mxEngine;
@@ -114,8 +146,26 @@ private:
 	mxFileSystem();
 	~mxFileSystem();
 
+	bool	Lookup( const mxChar* fileName, String &OutFileName ) const;
+	bool	ProbeFolders( const mxChar* fileName, String &OutFileName ) const;
+	void	RebuildIndex() const;
+	void	ScanFolder( const String& folderName, const String& relativePath ) const;
+
 private:
-	TArray< mxDir >	folders;	// search files in these directories
+	TArray< mxDir >		folders;	// search files in these directories
+	TArray< HANDLE >	changeNotifications;	// for each folder, INVALID_HANDLE_VALUE if not available
+
+	// normalized relative file name -> path to the file in the first folder which contains it
+	mutable THashMap< String, String >	fileIndex;
+
+	// normalized relative file names which were not found in any folder since the last scan
+	mutable THashMap< String, bool >	missingFiles;
+
+	mutable bool	bIndexIsDirty;
+
+	TArray< RefPtr< mxPackFile > >	archives;	// mounted pack files
+
+	mutable sys::CriticalSection	lock;	// files are searched by the background loading threads
 };
 
 //=====================================================================
@@ -209,6 +259,113 @@ private:
 	SizeT		m_length;	// file size, in bytes
 };
 
+//
+//	mxMappedFile - a file mapped into the address space of the process.
+//
+//	Pages are loaded by the OS on first access, so opening even a large file is cheap.
+//	The view is copy-on-write: the data can be modified in place,
+//	but changes are private to the process and are never written back to the file.
+//
+class mxMappedFile : public ReferenceCounted {
+public:
+	mxMappedFile();
+	~mxMappedFile();	// automatically unmaps and closes the file
+
+	bool	Open( const mxChar* filename );
+	void	Close();
+
+	bool	IsOpen() const;
+
+	// Returns the start of the mapped view (it is aligned to the page size).
+	BYTE *	GetData() const;
+
+	// Returns the size of the file, in bytes.
+	SizeT	GetSize() const;
+
+private:
+	HANDLE	m_hFile;
+	HANDLE	m_hMapping;
+	BYTE *	m_data;		// start of the mapped view
+	SizeT	m_size;		// size of the view, in bytes
+
+private:
+	NO_COPY_CONSTRUCTOR( mxMappedFile );
+	NO_ASSIGNMENT( mxMappedFile );
+};
+
+typedef RefPtr< mxMappedFile >	mxMappedFilePtr;
+
+//
+//	mxMappedFileStream - reads a memory-mapped file (or a part of it).
+//
+//	Reads are plain memory copies without system calls,
+//	the data can also be accessed in place through bounds-checked pointers.
+//
+class mxMappedFileStream : public mxDataStream {
+public:
+	mxMappedFileStream();
+	~mxMappedFileStream();
+
+	// Maps the whole file.
+	bool	Open( const mxChar* filename );
+
+	// Reads a range of an already mapped file (e.g. an entry in an archive).
+	bool	Open( mxMappedFile* file, SizeT offset, SizeT size );
+
+	void	Close();
+
+	//
+	//	Override ( mxDataStream ) :
+	//
+	SizeT	Read( void* pBuffer, SizeT numBytes );
+	SizeT	Write( const void* pBuffer, SizeT numBytes );
+
+	void	Seek( const SizeT offset );
+
+	void	Skip( mxLong offset );
+
+	SizeT	GetSize() const;
+	SizeT	Tell() const;
+
+	bool	IsOpen() const;
+
+	bool	AtEnd() const;
+
+	// Returns the number of bytes after the current position.
+	SizeT	Remaining() const;
+
+	// Zero-copy access, the pointers are valid while the stream is open.
+
+	// Returns the data at the current position.
+	const BYTE *	GetPtr() const;
+
+	// Returns the range of the stream or null if the range is out of bounds.
+	const BYTE *	GetPtr( SizeT offset, SizeT numBytes ) const;
+
+	// Returns the next 'numBytes' and moves past them;
+	// returns null (and doesn't move) if fewer bytes are left.
+	const BYTE *	ReadPtr( SizeT numBytes );
+
+	template< typename T >
+	const T * ReadArrayPtr( SizeT numElements )
+	{
+		if ( numElements > Remaining() / sizeof(T) ) {
+			return null;
+		}
+		return reinterpret_cast< const T* >( ReadPtr( numElements * sizeof(T) ) );
+	}
+
+private:
+	mxMappedFilePtr	m_file;
+	const BYTE *	m_data;		// start of the stream in the mapped view
+	SizeT			m_size;		// size of the stream, in bytes
+	SizeT			m_position;
+
+private:
+	NO_COPY_CONSTRUCTOR( mxMappedFileStream );
+	NO_ASSIGNMENT( mxMappedFileStream );
+};
+
 }//End of namespace abc
 
 #endif // ! __MX_FILE_SYSTEM_H__
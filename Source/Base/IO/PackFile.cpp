@@ -0,0 +1,539 @@
+/*
+=============================================================================
+	File:	PackFile.cpp
+	Desc:	Pack files - many small files stored in one archive.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+//
+//	mxPackFileStream - reads a decompressed file from memory.
+//	(Uncompressed files are read from the mapped archive with mxMappedFileStream.)
+//
+class mxPackFileStream : public mxDataStream {
+public:
+	// takes ownership of the data
+	mxPackFileStream( BYTE* data, SizeT size )
+		: m_data( data )
+		, m_size( size )
+		, m_position( 0 )
+	{}
+
+	~mxPackFileStream()
+	{
+		delete[] m_data;
+	}
+
+	//
+	//	Override ( mxDataStream ) :
+	//
+	SizeT Read( void* pBuffer, SizeT numBytes )
+	{
+		const SizeT bytesToRead = Min< SizeT >( numBytes, m_size - m_position );
+		if ( bytesToRead > 0 ) {
+			MemCopy( pBuffer, m_data + m_position, bytesToRead );
+			m_position += bytesToRead;
+		}
+		return bytesToRead;
+	}
+
+	SizeT Write( const void* pBuffer, SizeT numBytes )
+	{
+		InvalidCall;
+		return 0;
+	}
+
+	void Seek( const SizeT offset )
+	{
+		Assert( offset <= m_size );
+		m_position = Min< SizeT >( offset, m_size );
+	}
+
+	void Skip( mxLong offset )
+	{
+		if ( offset < 0 ) {
+			const SizeT back = static_cast< SizeT >( -offset );
+			m_position = ( back < m_position ) ? m_position - back : 0;
+		} else {
+			m_position = Min< SizeT >( m_position + offset, m_size );
+		}
+	}
+
+	SizeT GetSize() const
+	{
+		return m_size;
+	}
+
+	SizeT Tell() const
+	{
+		return m_position;
+	}
+
+	bool IsOpen() const
+	{
+		return true;
+	}
+
+	bool AtEnd() const
+	{
+		return ( m_position >= m_size );
+	}
+
+private:
+	BYTE *	m_data;
+	SizeT	m_size;
+	SizeT	m_position;
+};
+
+FORCEINLINE bool IsPowerOfTwo( UINT32 x )
+{
+	return ( x != 0 ) && ( ( x & ( x - 1 ) ) == 0 );
+}
+
+// Returns true if the range [offset, offset + size) lies within the file.
+FORCEINLINE bool IsInFile( UINT32 offset, UINT32 size, UINT32 fileSize )
+{
+	return ( offset <= fileSize ) && ( size <= fileSize - offset );
+}
+
+//
+//	ReadFileData - reads the contents of a file (which can be empty) into memory.
+//
+bool ReadFileData( const mxChar* filename, TArray< BYTE > &OutData )
+{
+	FILE * file = fopen( filename, "rb" );
+	if ( ! file ) {
+		return false;
+	}
+
+	fseek( file, 0, SEEK_END );
+	const long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	bool bOk = ( fileSize >= 0 );
+	if ( bOk )
+	{
+		OutData.SetNum( fileSize );
+		bOk = ( fileSize == 0 ) || ( fread( OutData.Ptr(), 1, fileSize, file ) == (size_t) fileSize );
+	}
+
+	fclose( file );
+	return bOk;
+}
+
+//
+//	WritePadding - writes zeros until the offset is a multiple of the alignment.
+//
+bool WritePadding( FILE* file, UINT32 &offset, UINT32 alignment )
+{
+	static const BYTE zeros[ mxPackFileHeader::DATA_ALIGNMENT ] = { 0 };
+	Assert( alignment <= ARRAY_SIZE(zeros) );
+
+	const UINT32 padding = ( alignment - offset % alignment ) % alignment;
+	offset += padding;
+	return ( padding == 0 ) || ( fwrite( zeros, 1, padding, file ) == padding );
+}
+
+}//End of anonymous namespace
+
+/*================================
+		mxPackFile
+================================*/
+
+mxPackFile::mxPackFile()
+	: header( null )
+	, entries( null )
+	, hashTable( null )
+	, names( null )
+{
+}
+
+mxPackFile::~mxPackFile()
+{
+	Close();
+}
+
+bool mxPackFile::Open( const mxChar* filename )
+{
+	AssertPtr( filename );
+	Close();
+
+	mxMappedFilePtr  mappedFile( MX_NEW mxMappedFile() );
+	if ( ! mappedFile->Open( filename ) ) {
+		sys::Warning( "Failed to open archive '%s'\n", filename );
+		return false;
+	}
+
+	const BYTE * data = mappedFile->GetData();
+
+	this->file = mappedFile;
+	this->name = filename;
+	this->header = reinterpret_cast< const mxPackFileHeader* >( data );
+
+	if ( ! Validate() ) {
+		sys::Warning( "Archive '%s' is corrupted or has unsupported version\n", filename );
+		Close();
+		return false;
+	}
+
+	this->entries = reinterpret_cast< const mxPackFileEntry* >( data + header->entriesOffset );
+	this->hashTable = reinterpret_cast< const UINT32* >( data + header->hashTableOffset );
+	this->names = reinterpret_cast< const mxChar* >( data + header->namesOffset );
+
+	return true;
+}
+
+//
+//	mxPackFile::Validate - checks the header and the table of contents,
+//	so that lookups and reads don't need to check offsets.
+//
+bool mxPackFile::Validate() const
+{
+	const UINT32 fileSize = this->file->GetSize();
+	if ( fileSize < sizeof(mxPackFileHeader) ) {
+		return false;
+	}
+
+	const mxPackFileHeader & h = *this->header;
+	if ( h.fourCC != mxPackFileHeader::FOURCC
+		|| h.version != mxPackFileHeader::VERSION
+		|| h.fileSize != fileSize )
+	{
+		return false;
+	}
+
+	if ( ! IsPowerOfTwo( h.numHashSlots ) || h.numHashSlots <= h.numEntries ) {
+		return false;
+	}
+
+	if ( h.entriesOffset % sizeof(UINT32) || h.hashTableOffset % sizeof(UINT32) ) {
+		return false;
+	}
+
+	if ( h.numEntries > fileSize / sizeof(mxPackFileEntry)
+		|| ! IsInFile( h.entriesOffset, h.numEntries * sizeof(mxPackFileEntry), fileSize )
+		|| h.numHashSlots > fileSize / sizeof(UINT32)
+		|| ! IsInFile( h.hashTableOffset, h.numHashSlots * sizeof(UINT32), fileSize )
+		|| h.namesOffset >= fileSize )
+	{
+		return false;
+	}
+
+	const BYTE * data = this->file->GetData();
+
+	// all names are terminated
+	if ( data[ fileSize - 1 ] != '\0' ) {
+		return false;
+	}
+
+	const mxPackFileEntry * entryArray = reinterpret_cast< const mxPackFileEntry* >( data + h.entriesOffset );
+	for ( UINT32 i = 0; i < h.numEntries; i++ )
+	{
+		const mxPackFileEntry & entry = entryArray[i];
+
+		if ( entry.nameOffset >= fileSize - h.namesOffset
+			|| ! IsInFile( entry.dataOffset, entry.packedSize, fileSize ) )
+		{
+			return false;
+		}
+		if ( ! ( entry.flags & PACK_ENTRY_COMPRESSED ) && entry.packedSize != entry.size ) {
+			return false;
+		}
+		// OpenEntry() allocates 'size' bytes, a corrupted size could not be decompressed anyway
+		if ( ( entry.flags & PACK_ENTRY_COMPRESSED ) && entry.size > mxDecompressBound( entry.packedSize ) ) {
+			return false;
+		}
+	}
+
+	// lookups stop at an empty slot, so there must be at least one
+	UINT32  numEmptySlots = 0;
+	const UINT32 * slots = reinterpret_cast< const UINT32* >( data + h.hashTableOffset );
+	for ( UINT32 i = 0; i < h.numHashSlots; i++ )
+	{
+		if ( slots[i] > h.numEntries ) {
+			return false;
+		}
+		numEmptySlots += ( slots[i] == 0 );
+	}
+
+	return ( numEmptySlots > 0 );
+}
+
+void mxPackFile::Close()
+{
+	this->file = null;
+	this->name.Empty();
+	this->header = null;
+	this->entries = null;
+	this->hashTable = null;
+	this->names = null;
+}
+
+bool mxPackFile::IsOpen() const
+{
+	return ( null != this->header );
+}
+
+const mxChar * mxPackFile::GetName() const
+{
+	return this->name.ToChar();
+}
+
+mxUInt mxPackFile::NumEntries() const
+{
+	return this->header ? this->header->numEntries : 0;
+}
+
+const mxPackFileEntry & mxPackFile::GetEntry( mxUInt index ) const
+{
+	Assert( index < NumEntries() );
+	return this->entries[ index ];
+}
+
+const mxChar * mxPackFile::GetEntryName( mxUInt index ) const
+{
+	return this->names + GetEntry( index ).nameOffset;
+}
+
+INT mxPackFile::FindEntry( const mxChar* fileName ) const
+{
+	mxChar  key[ sys::MAX_PATH_CHARS ];
+	if ( ! mxNormalizeFileName( fileName, key, ARRAY_SIZE(key) ) ) {
+		return INDEX_NONE;
+	}
+	return FindNormalizedEntry( key );
+}
+
+INT mxPackFile::FindNormalizedEntry( const mxChar* key ) const
+{
+	AssertPtr( key );
+	if ( ! IsOpen() ) {
+		return INDEX_NONE;
+	}
+
+	const UINT32 hash = mxHashString( key );
+	const UINT32 mask = this->header->numHashSlots - 1;
+
+	// linear probing, the table always has empty slots
+	for ( UINT32 slot = hash & mask; this->hashTable[ slot ] != 0; slot = ( slot + 1 ) & mask )
+	{
+		const UINT32 entryIndex = this->hashTable[ slot ] - 1;
+		const mxPackFileEntry & entry = this->entries[ entryIndex ];
+
+		if ( entry.nameHash == hash && String::Cmp( this->names + entry.nameOffset, key ) == 0 ) {
+			return (INT) entryIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool mxPackFile::ReadEntry( mxUInt index, void* buffer ) const
+{
+	const mxPackFileEntry & entry = GetEntry( index );
+	const BYTE * data = this->file->GetData() + entry.dataOffset;
+
+	if ( entry.flags & PACK_ENTRY_COMPRESSED ) {
+		return mxDecompressLZ( data, entry.packedSize, buffer, entry.size );
+	}
+
+	if ( entry.size > 0 ) {
+		MemCopy( buffer, data, entry.size );
+	}
+	return true;
+}
+
+mxDataStream * mxPackFile::OpenEntry( mxUInt index )
+{
+	const mxPackFileEntry & entry = GetEntry( index );
+
+	// uncompressed files are read directly from the mapped view
+	if ( ! ( entry.flags & PACK_ENTRY_COMPRESSED ) )
+	{
+		mxMappedFileStream * stream = MX_NEW mxMappedFileStream();
+		stream->Open( this->file, entry.dataOffset, entry.size );
+		return stream;
+	}
+
+	BYTE * decompressed = new BYTE[ entry.size ];
+	if ( ! ReadEntry( index, decompressed ) )
+	{
+		sys::Warning( "Failed to decompress '%s' from archive '%s'\n", GetEntryName( index ), GetName() );
+		delete[] decompressed;
+		return null;
+	}
+
+	return MX_NEW mxPackFileStream( decompressed, entry.size );
+}
+
+/*================================
+		mxWritePackFile
+================================*/
+
+bool mxWritePackFile( const mxChar* archiveName, const mxChar* rootFolder,
+					 const TArray< String >& fileNames, bool bCompress )
+{
+	AssertPtr( archiveName );
+	AssertPtr( rootFolder );
+
+	FILE * file = fopen( archiveName, "wb" );
+	if ( ! file ) {
+		sys::Warning( "Failed to create archive '%s'\n", archiveName );
+		return false;
+	}
+
+	mxPackFileHeader  header;
+	MemZero( &header, sizeof(header) );
+
+	// the header is written again when the offsets are known
+	bool bOk = ( fwrite( &header, sizeof(header), 1, file ) == 1 );
+	UINT32  offset = sizeof(header);
+
+	TArray< mxPackFileEntry >	entries;
+	TArray< mxChar >			names;
+	THashMap< String, UINT32 >	addedNames;
+
+	TArray< BYTE >	fileData;
+	TArray< BYTE >	packedData;
+
+	for ( mxUInt iFile = 0; bOk && iFile < fileNames.Num(); iFile++ )
+	{
+		const mxChar * fileName = fileNames[ iFile ].ToChar();
+
+		mxChar  key[ sys::MAX_PATH_CHARS ];
+		if ( ! mxNormalizeFileName( fileName, key, ARRAY_SIZE(key) ) ) {
+			sys::Warning( "Skipping '%s': only relative file names can be packed\n", fileName );
+			continue;
+		}
+		const mxChar * pKey = key;
+		if ( ! addedNames.Add( pKey, entries.Num() ) ) {
+			sys::Warning( "Skipping '%s': the file has already been added\n", fileName );
+			continue;
+		}
+
+		String  filePath;
+		_sprintf( filePath, "%s%s", rootFolder, fileName );
+		if ( ! ReadFileData( filePath.ToChar(), fileData ) ) {
+			sys::Warning( "Failed to read file '%s'\n", filePath.ToChar() );
+			bOk = false;
+			break;
+		}
+
+		mxPackFileEntry  entry;
+		entry.nameHash = mxHashString( key );
+		entry.nameOffset = names.Num();
+		entry.size = fileData.Num();
+		entry.packedSize = entry.size;
+		entry.flags = 0;
+
+		const BYTE * data = fileData.Ptr();
+
+		// store compressed data only if it's smaller
+		if ( bCompress && entry.size > 0 )
+		{
+			packedData.SetNum( mxCompressBound( entry.size ) );
+			const mxUInt packedSize = mxCompressLZ( fileData.Ptr(), entry.size, packedData.Ptr(), packedData.Num() );
+			if ( packedSize > 0 && packedSize < entry.size )
+			{
+				entry.packedSize = packedSize;
+				entry.flags |= PACK_ENTRY_COMPRESSED;
+				data = packedData.Ptr();
+			}
+		}
+
+		bOk = WritePadding( file, offset, mxPackFileHeader::DATA_ALIGNMENT );
+
+		if ( (UINT64)offset + entry.packedSize > MAX_SDWORD ) {
+			sys::Warning( "Archive '%s' is too large\n", archiveName );
+			bOk = false;
+			break;
+		}
+
+		entry.dataOffset = offset;
+		if ( entry.packedSize > 0 ) {
+			bOk = bOk && ( fwrite( data, 1, entry.packedSize, file ) == entry.packedSize );
+		}
+		offset += entry.packedSize;
+
+		const mxUInt nameLength = sys::StrLen( key ) + 1;
+		names.SetNum( entry.nameOffset + nameLength );
+		MemCopy( names.Ptr() + entry.nameOffset, key, nameLength );
+
+		entries.Append( entry );
+	}
+
+	if ( bOk )
+	{
+		// keep the load factor below one half
+		UINT32  numHashSlots = 16;
+		while ( numHashSlots < entries.Num() * 2 ) {
+			numHashSlots *= 2;
+		}
+
+		TArray< UINT32 >  hashTable;
+		hashTable.SetNum( numHashSlots );
+		MemZero( hashTable.Ptr(), numHashSlots * sizeof(UINT32) );
+
+		for ( mxUInt iEntry = 0; iEntry < entries.Num(); iEntry++ )
+		{
+			UINT32 slot = entries[ iEntry ].nameHash & ( numHashSlots - 1 );
+			while ( hashTable[ slot ] != 0 ) {
+				slot = ( slot + 1 ) & ( numHashSlots - 1 );
+			}
+			hashTable[ slot ] = iEntry + 1;
+		}
+
+		// the names block must not be empty, the file always ends with a null character
+		if ( names.Num() == 0 ) {
+			names.Append( '\0' );
+		}
+
+		bOk = WritePadding( file, offset, sizeof(UINT32) );
+
+		header.fourCC = mxPackFileHeader::FOURCC;
+		header.version = mxPackFileHeader::VERSION;
+		header.numEntries = entries.Num();
+		header.numHashSlots = numHashSlots;
+
+		header.entriesOffset = offset;
+		if ( entries.Num() > 0 ) {
+			bOk = bOk && ( fwrite( entries.Ptr(), sizeof(mxPackFileEntry), entries.Num(), file ) == entries.Num() );
+		}
+		offset += entries.Num() * sizeof(mxPackFileEntry);
+
+		header.hashTableOffset = offset;
+		bOk = bOk && ( fwrite( hashTable.Ptr(), sizeof(UINT32), numHashSlots, file ) == numHashSlots );
+		offset += numHashSlots * sizeof(UINT32);
+
+		header.namesOffset = offset;
+		bOk = bOk && ( fwrite( names.Ptr(), 1, names.Num(), file ) == names.Num() );
+		offset += names.Num();
+
+		header.fileSize = offset;
+
+		bOk = bOk && ( fseek( file, 0, SEEK_SET ) == 0 );
+		bOk = bOk && ( fwrite( &header, sizeof(header), 1, file ) == 1 );
+	}
+
+	// the file must be closed even after a failure, otherwise it can't be removed
+	const bool bClosed = ( fclose( file ) == 0 );
+	bOk = bOk && bClosed;
+
+	if ( ! bOk ) {
+		sys::Warning( "Failed to write archive '%s'\n", archiveName );
+		::remove( archiveName );
+	}
+	return bOk;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,133 @@
+/*
+=============================================================================
+	File:	PackFile.h
+	Desc:	Pack files - many small files stored in one archive.
+=============================================================================
+*/
+
+#ifndef __MX_PACK_FILE_H__
+#define __MX_PACK_FILE_H__
+
+namespace abc {
+
+//
+//	mxPackFileHeader - the header of a pack file.
+//
+//	File layout:
+//		header
+//		file data (each entry is aligned to DATA_ALIGNMENT)
+//		entries
+//		hash table (indices of entries plus one, zero marks an empty slot)
+//		file names (null-terminated normalized names, see mxNormalizeFileName())
+//
+struct mxPackFileHeader
+{
+	enum {
+		FOURCC	= 'P' | ('A' << 8) | ('C' << 16) | ('K' << 24),
+		VERSION	= 1,
+
+		// the offsets of the file data are aligned to this value
+		DATA_ALIGNMENT = 16,
+	};
+
+	UINT32	fourCC;
+	UINT32	version;
+
+	UINT32	numEntries;
+	UINT32	numHashSlots;		// power of two, greater than the number of entries
+
+	// from the start of the file
+	UINT32	entriesOffset;
+	UINT32	hashTableOffset;
+	UINT32	namesOffset;
+	UINT32	fileSize;
+};
+
+//
+//	EPackEntryFlags
+//
+enum EPackEntryFlags
+{
+	PACK_ENTRY_COMPRESSED	= BIT(0),	// the data is compressed with mxCompressLZ()
+};
+
+//
+//	mxPackFileEntry - describes a file stored in the archive.
+//
+struct mxPackFileEntry
+{
+	UINT32	nameHash;		// mxHashString() of the normalized file name
+	UINT32	nameOffset;		// from the start of the file names
+	UINT32	dataOffset;		// from the start of the file
+	UINT32	packedSize;		// size of the stored data, in bytes
+	UINT32	size;			// size of the original file, in bytes
+	UINT32	flags;			// EPackEntryFlags
+};
+
+//
+//	mxPackFile - a read-only archive mapped into memory.
+//
+//	Lookups don't allocate memory, uncompressed files are read directly from the mapped view.
+//	Pack files are usually mounted in the file system (see mxFileSystem::MountArchive()).
+//
+class mxPackFile : public ReferenceCounted {
+public:
+	mxPackFile();
+	~mxPackFile();
+
+	bool	Open( const mxChar* filename );
+	void	Close();
+
+	bool	IsOpen() const;
+
+	const mxChar *	GetName() const;
+
+	mxUInt	NumEntries() const;
+
+	const mxPackFileEntry &	GetEntry( mxUInt index ) const;
+	const mxChar *			GetEntryName( mxUInt index ) const;
+
+	// Returns the index of the entry with the given relative file name or INDEX_NONE if not found.
+	INT		FindEntry( const mxChar* fileName ) const;
+
+	// Same as above, but the name must be already normalized.
+	INT		FindNormalizedEntry( const mxChar* key ) const;
+
+	// Reads (and decompresses) the file into the buffer which must hold GetEntry( index ).size bytes.
+	bool	ReadEntry( mxUInt index, void* buffer ) const;
+
+	// Returns a new stream for reading the file (the caller must delete it) or null on failure.
+	// The stream remains valid after the archive has been closed.
+	mxDataStream *	OpenEntry( mxUInt index );
+
+private:
+	bool	Validate() const;
+
+private:
+	mxMappedFilePtr		file;
+	String				name;
+
+	const mxPackFileHeader *	header;
+	const mxPackFileEntry *		entries;
+	const UINT32 *				hashTable;
+	const mxChar *				names;
+
+private:
+	NO_COPY_CONSTRUCTOR( mxPackFile );
+	NO_ASSIGNMENT( mxPackFile );
+};
+
+typedef RefPtr< mxPackFile >	mxPackFilePtr;
+
+// Writes the files (relative to the root folder) into a new pack file, returns false on failure.
+// If 'bCompress' is true, files are compressed unless that doesn't make them smaller.
+bool mxWritePackFile( const mxChar* archiveName, const mxChar* rootFolder,
+					 const TArray< String >& fileNames, bool bCompress );
+
+}//End of namespace abc
+
+#endif // ! __MX_PACK_FILE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,165 @@
+/*
+=============================================================================
+	File:	CullingVolumes.cpp
+	Desc:	Arrays of bounding volumes in structure-of-arrays layout
+			for batch (SIMD) culling.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+	// Appends a group of zeroed elements to the end of the array.
+	FORCEINLINE void AppendPadding( TArray< FLOAT > & a, mxUInt count )
+	{
+		for( mxUInt i = 0; i < count; i++ ) {
+			a.Append( 0.0f );
+		}
+	}
+
+	// Returns the given number of elements rounded up to a multiple of 'width'.
+	FORCEINLINE mxUInt GetPaddedSize( mxUInt num, mxUInt width )
+	{
+		return ( num + width - 1 ) & ~( width - 1 );
+	}
+
+}//end of anonymous namespace
+
+/*================================
+		mxSphereSoA
+================================*/
+
+mxSphereSoA::mxSphereSoA( mxUInt granularity )
+	: x( granularity ), y( granularity ), z( granularity ), radius( granularity )
+	, num( 0 )
+{
+	StaticAssert( (SIMD_WIDTH & (SIMD_WIDTH - 1)) == 0 );
+}
+
+IndexT mxSphereSoA::Add( const Sphere& sphere )
+{
+	if( this->num == this->x.Num() )
+	{
+		AppendPadding( this->x, SIMD_WIDTH );
+		AppendPadding( this->y, SIMD_WIDTH );
+		AppendPadding( this->z, SIMD_WIDTH );
+		AppendPadding( this->radius, SIMD_WIDTH );
+	}
+	const IndexT newIndex = this->num++;
+	Set( newIndex, sphere );
+	return newIndex;
+}
+
+void mxSphereSoA::Set( IndexT index, const Sphere& sphere )
+{
+	Assert( index < this->num );
+	const Vec3D & origin = sphere.GetOrigin();
+	this->x[ index ] = origin.x;
+	this->y[ index ] = origin.y;
+	this->z[ index ] = origin.z;
+	this->radius[ index ] = sphere.GetRadius();
+}
+
+void mxSphereSoA::SetNum( mxUInt newNum )
+{
+	const mxUInt paddedSize = GetPaddedSize( newNum, SIMD_WIDTH );
+	this->x.SetNum( paddedSize, false );
+	this->y.SetNum( paddedSize, false );
+	this->z.SetNum( paddedSize, false );
+	this->radius.SetNum( paddedSize, false );
+	this->num = newNum;
+}
+
+void mxSphereSoA::Empty()
+{
+	SetNum( 0 );
+}
+
+void mxSphereSoA::Clear()
+{
+	this->x.Clear();
+	this->y.Clear();
+	this->z.Clear();
+	this->radius.Clear();
+	this->num = 0;
+}
+
+/*================================
+		mxAABBSoA
+================================*/
+
+mxAABBSoA::mxAABBSoA( mxUInt granularity )
+	: centerX( granularity ), centerY( granularity ), centerZ( granularity )
+	, extentX( granularity ), extentY( granularity ), extentZ( granularity )
+	, num( 0 )
+{
+	StaticAssert( (SIMD_WIDTH & (SIMD_WIDTH - 1)) == 0 );
+}
+
+IndexT mxAABBSoA::Add( const AABB& box )
+{
+	if( this->num == this->centerX.Num() )
+	{
+		AppendPadding( this->centerX, SIMD_WIDTH );
+		AppendPadding( this->centerY, SIMD_WIDTH );
+		AppendPadding( this->centerZ, SIMD_WIDTH );
+		AppendPadding( this->extentX, SIMD_WIDTH );
+		AppendPadding( this->extentY, SIMD_WIDTH );
+		AppendPadding( this->extentZ, SIMD_WIDTH );
+	}
+	const IndexT newIndex = this->num++;
+	Set( newIndex, box );
+	return newIndex;
+}
+
+void mxAABBSoA::Set( IndexT index, const AABB& box )
+{
+	Assert( index < this->num );
+	const Vec3D center( box.GetCenter() );
+	const Vec3D extent( box.GetHalfSize() );
+	this->centerX[ index ] = center.x;
+	this->centerY[ index ] = center.y;
+	this->centerZ[ index ] = center.z;
+	this->extentX[ index ] = extent.x;
+	this->extentY[ index ] = extent.y;
+	this->extentZ[ index ] = extent.z;
+}
+
+void mxAABBSoA::SetNum( mxUInt newNum )
+{
+	const mxUInt paddedSize = GetPaddedSize( newNum, SIMD_WIDTH );
+	this->centerX.SetNum( paddedSize, false );
+	this->centerY.SetNum( paddedSize, false );
+	this->centerZ.SetNum( paddedSize, false );
+	this->extentX.SetNum( paddedSize, false );
+	this->extentY.SetNum( paddedSize, false );
+	this->extentZ.SetNum( paddedSize, false );
+	this->num = newNum;
+}
+
+void mxAABBSoA::Empty()
+{
+	SetNum( 0 );
+}
+
+void mxAABBSoA::Clear()
+{
+	this->centerX.Clear();
+	this->centerY.Clear();
+	this->centerZ.Clear();
+	this->extentX.Clear();
+	this->extentY.Clear();
+	this->extentZ.Clear();
+	this->num = 0;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
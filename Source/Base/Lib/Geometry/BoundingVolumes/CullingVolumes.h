@@ -0,0 +1,139 @@
+/*
+=============================================================================
+	File:	CullingVolumes.h
+	Desc:	Arrays of bounding volumes in structure-of-arrays layout
+			for batch (SIMD) culling.
+=============================================================================
+*/
+
+#ifndef __MX_CULLING_VOLUMES_H__
+#define __MX_CULLING_VOLUMES_H__
+
+namespace abc {
+
+//
+//	Visibility mask - one bit per bounding volume
+//	(bit (i & 31) of the word (i >> 5) is set if the i-th volume is potentially visible).
+//
+FORCEINLINE mxUInt GetVisibilityMaskSize( mxUInt numVolumes ) {
+	return ( numVolumes + 31 ) >> 5;
+}
+FORCEINLINE bool IsVisible( const UDWORD* visibilityMask, IndexT index ) {
+	return ( visibilityMask[ index >> 5 ] & ( 1UL << ( index & 31 ) ) ) != 0;
+}
+
+//
+//	mxSphereSoA - bounding spheres stored in structure-of-arrays layout.
+//
+//	The arrays are padded to a multiple of SIMD_WIDTH elements,
+//	so that they can be processed in groups without special-casing the tail.
+//
+class mxSphereSoA {
+public:
+	enum { SIMD_WIDTH = 4 };
+
+			mxSphereSoA( mxUInt granularity = 64 );
+
+	mxUInt	Num() const;
+
+	IndexT	Add( const Sphere& sphere );
+	void	Set( IndexT index, const Sphere& sphere );
+	void	SetNum( mxUInt newNum );
+
+	void	Empty();	// sets the number of spheres to zero, doesn't free memory
+	void	Clear();	// frees memory
+
+	const FLOAT *	GetX() const;
+	const FLOAT *	GetY() const;
+	const FLOAT *	GetZ() const;
+	const FLOAT *	GetRadius() const;
+
+private:
+	TArray< FLOAT >		x;
+	TArray< FLOAT >		y;
+	TArray< FLOAT >		z;
+	TArray< FLOAT >		radius;
+	mxUInt				num;	// number of valid spheres (without padding)
+};
+
+FORCEINLINE mxUInt mxSphereSoA::Num() const {
+	return num;
+}
+FORCEINLINE const FLOAT * mxSphereSoA::GetX() const {
+	return x.Ptr();
+}
+FORCEINLINE const FLOAT * mxSphereSoA::GetY() const {
+	return y.Ptr();
+}
+FORCEINLINE const FLOAT * mxSphereSoA::GetZ() const {
+	return z.Ptr();
+}
+FORCEINLINE const FLOAT * mxSphereSoA::GetRadius() const {
+	return radius.Ptr();
+}
+
+//
+//	mxAABBSoA - axis-aligned bounding boxes stored in structure-of-arrays layout
+//	(as centers and half-sizes).
+//
+class mxAABBSoA {
+public:
+	enum { SIMD_WIDTH = 4 };
+
+			mxAABBSoA( mxUInt granularity = 64 );
+
+	mxUInt	Num() const;
+
+	IndexT	Add( const AABB& box );
+	void	Set( IndexT index, const AABB& box );
+	void	SetNum( mxUInt newNum );
+
+	void	Empty();	// sets the number of boxes to zero, doesn't free memory
+	void	Clear();	// frees memory
+
+	const FLOAT *	GetCenterX() const;
+	const FLOAT *	GetCenterY() const;
+	const FLOAT *	GetCenterZ() const;
+	const FLOAT *	GetExtentX() const;
+	const FLOAT *	GetExtentY() const;
+	const FLOAT *	GetExtentZ() const;
+
+private:
+	TArray< FLOAT >		centerX;
+	TArray< FLOAT >		centerY;
+	TArray< FLOAT >		centerZ;
+	TArray< FLOAT >		extentX;
+	TArray< FLOAT >		extentY;
+	TArray< FLOAT >		extentZ;
+	mxUInt				num;	// number of valid boxes (without padding)
+};
+
+FORCEINLINE mxUInt mxAABBSoA::Num() const {
+	return num;
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetCenterX() const {
+	return centerX.Ptr();
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetCenterY() const {
+	return centerY.Ptr();
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetCenterZ() const {
+	return centerZ.Ptr();
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetExtentX() const {
+	return extentX.Ptr();
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetExtentY() const {
+	return extentY.Ptr();
+}
+FORCEINLINE const FLOAT * mxAABBSoA::GetExtentZ() const {
+	return extentZ.Ptr();
+}
+
+}//End of namespace abc
+
+#endif // ! __MX_CULLING_VOLUMES_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -196,14 +196,11 @@ FASTBOOL mxViewFrustum::IntersectsAABB( const AABB& aabb ) const
 						+ boxCenter.z * p.c
 							+ p.d;
 
-		if( NP < MP ) {
-			// near vertex behind the clip plane so there is no intersection
+		// NOTE: the planes face inward (the original code assumed outward-facing planes).
+		if( MP + NP < 0.0f ) {
+			// far vertex behind the clip plane so there is no intersection
 			return False;
 		}
-		if( (-NP) < MP ) {
-			// near and far vertices on different sides of plane
-			return True;
-		}
 
 		planeIndex++;	// advance to next plane
 	}
@@ -244,6 +241,210 @@ FASTBOOL mxViewFrustum::IntersectSphere( const Sphere& theSphere ) const
     return True;
 }
 
+//
+//	mxViewFrustum::CullSpheres
+//
+//	A sphere is culled if it lies completely behind any of the frustum planes.
+//
+void mxViewFrustum::CullSpheres( const mxSphereSoA& spheres, UDWORD *OutVisibilityMask ) const
+{
+	AssertPtr( OutVisibilityMask );
+
+	const mxUInt numSpheres = spheres.Num();
+	const mxUInt numGroups = ( numSpheres + mxSphereSoA::SIMD_WIDTH - 1 ) / mxSphereSoA::SIMD_WIDTH;
+
+	MemSet( OutVisibilityMask, 0, GetVisibilityMaskSize( numSpheres ) * sizeof(UDWORD) );
+
+	const FLOAT * posX = spheres.GetX();
+	const FLOAT * posY = spheres.GetY();
+	const FLOAT * posZ = spheres.GetZ();
+	const FLOAT * radius = spheres.GetRadius();
+
+#ifdef MX_USE_SSE_ASM
+
+	// Broadcast plane equations into SIMD registers.
+	__m128	planeA[ NUM_PLANES_TO_USE ];
+	__m128	planeB[ NUM_PLANES_TO_USE ];
+	__m128	planeC[ NUM_PLANES_TO_USE ];
+	__m128	planeD[ NUM_PLANES_TO_USE ];
+
+	for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+	{
+		planeA[ iPlane ] = _mm_set1_ps( mPlanes[ iPlane ].a );
+		planeB[ iPlane ] = _mm_set1_ps( mPlanes[ iPlane ].b );
+		planeC[ iPlane ] = _mm_set1_ps( mPlanes[ iPlane ].c );
+		planeD[ iPlane ] = _mm_set1_ps( mPlanes[ iPlane ].d );
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	// Test 4 spheres at a time.
+	for( IndexT iGroup = 0; iGroup < numGroups; iGroup++ )
+	{
+		const IndexT first = iGroup * 4;
+
+		const __m128 x = _mm_loadu_ps( posX + first );
+		const __m128 y = _mm_loadu_ps( posY + first );
+		const __m128 z = _mm_loadu_ps( posZ + first );
+		const __m128 r = _mm_loadu_ps( radius + first );
+
+		__m128 outside = zero;
+
+		for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+		{
+			// distance = dot( plane.normal, center ) + plane.d + radius
+			__m128 distance = _mm_add_ps( _mm_mul_ps( x, planeA[ iPlane ] ), planeD[ iPlane ] );
+			distance = _mm_add_ps( distance, _mm_mul_ps( y, planeB[ iPlane ] ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( z, planeC[ iPlane ] ) );
+			distance = _mm_add_ps( distance, r );
+
+			outside = _mm_or_ps( outside, _mm_cmplt_ps( distance, zero ) );
+		}
+
+		const UDWORD visibleBits = ~_mm_movemask_ps( outside ) & 0xF;
+		OutVisibilityMask[ first >> 5 ] |= visibleBits << ( first & 31 );
+	}
+
+#else
+
+	for( IndexT iGroup = 0; iGroup < numGroups; iGroup++ )
+	{
+		for( IndexT i = iGroup * 4; i < iGroup * 4 + 4; i++ )
+		{
+			bool bVisible = true;
+			for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+			{
+				const mxPlane & p = mPlanes[ iPlane ];
+				if( p.a * posX[i] + p.b * posY[i] + p.c * posZ[i] + p.d + radius[i] < 0.0f ) {
+					bVisible = false;
+					break;
+				}
+			}
+			if( bVisible ) {
+				OutVisibilityMask[ i >> 5 ] |= 1UL << ( i & 31 );
+			}
+		}
+	}
+
+#endif // MX_USE_SSE_ASM
+
+	// Clear the bits of padding elements.
+	if( numSpheres & 31 ) {
+		OutVisibilityMask[ numSpheres >> 5 ] &= ( 1UL << ( numSpheres & 31 ) ) - 1;
+	}
+}
+
+//
+//	mxViewFrustum::CullBoxes
+//
+//	A box is culled if its 'most positive' vertex (along the plane normal)
+//	lies behind any of the frustum planes.
+//
+void mxViewFrustum::CullBoxes( const mxAABBSoA& boxes, UDWORD *OutVisibilityMask ) const
+{
+	AssertPtr( OutVisibilityMask );
+
+	const mxUInt numBoxes = boxes.Num();
+	const mxUInt numGroups = ( numBoxes + mxAABBSoA::SIMD_WIDTH - 1 ) / mxAABBSoA::SIMD_WIDTH;
+
+	MemSet( OutVisibilityMask, 0, GetVisibilityMaskSize( numBoxes ) * sizeof(UDWORD) );
+
+	const FLOAT * centerX = boxes.GetCenterX();
+	const FLOAT * centerY = boxes.GetCenterY();
+	const FLOAT * centerZ = boxes.GetCenterZ();
+	const FLOAT * extentX = boxes.GetExtentX();
+	const FLOAT * extentY = boxes.GetExtentY();
+	const FLOAT * extentZ = boxes.GetExtentZ();
+
+#ifdef MX_USE_SSE_ASM
+
+	// Broadcast plane equations (and absolute values of the normals) into SIMD registers.
+	__m128	planeA[ NUM_PLANES_TO_USE ];
+	__m128	planeB[ NUM_PLANES_TO_USE ];
+	__m128	planeC[ NUM_PLANES_TO_USE ];
+	__m128	planeD[ NUM_PLANES_TO_USE ];
+	__m128	absA[ NUM_PLANES_TO_USE ];
+	__m128	absB[ NUM_PLANES_TO_USE ];
+	__m128	absC[ NUM_PLANES_TO_USE ];
+
+	for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+	{
+		const mxPlane & p = mPlanes[ iPlane ];
+		planeA[ iPlane ] = _mm_set1_ps( p.a );
+		planeB[ iPlane ] = _mm_set1_ps( p.b );
+		planeC[ iPlane ] = _mm_set1_ps( p.c );
+		planeD[ iPlane ] = _mm_set1_ps( p.d );
+		absA[ iPlane ] = _mm_set1_ps( mxMath::Fabs( p.a ) );
+		absB[ iPlane ] = _mm_set1_ps( mxMath::Fabs( p.b ) );
+		absC[ iPlane ] = _mm_set1_ps( mxMath::Fabs( p.c ) );
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	// Test 4 boxes at a time.
+	for( IndexT iGroup = 0; iGroup < numGroups; iGroup++ )
+	{
+		const IndexT first = iGroup * 4;
+
+		const __m128 cx = _mm_loadu_ps( centerX + first );
+		const __m128 cy = _mm_loadu_ps( centerY + first );
+		const __m128 cz = _mm_loadu_ps( centerZ + first );
+		const __m128 ex = _mm_loadu_ps( extentX + first );
+		const __m128 ey = _mm_loadu_ps( extentY + first );
+		const __m128 ez = _mm_loadu_ps( extentZ + first );
+
+		__m128 outside = zero;
+
+		for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+		{
+			// distance = dot( plane.normal, center ) + plane.d + dot( abs( plane.normal ), extent )
+			__m128 distance = _mm_add_ps( _mm_mul_ps( cx, planeA[ iPlane ] ), planeD[ iPlane ] );
+			distance = _mm_add_ps( distance, _mm_mul_ps( cy, planeB[ iPlane ] ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( cz, planeC[ iPlane ] ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( ex, absA[ iPlane ] ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( ey, absB[ iPlane ] ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( ez, absC[ iPlane ] ) );
+
+			outside = _mm_or_ps( outside, _mm_cmplt_ps( distance, zero ) );
+		}
+
+		const UDWORD visibleBits = ~_mm_movemask_ps( outside ) & 0xF;
+		OutVisibilityMask[ first >> 5 ] |= visibleBits << ( first & 31 );
+	}
+
+#else
+
+	for( IndexT iGroup = 0; iGroup < numGroups; iGroup++ )
+	{
+		for( IndexT i = iGroup * 4; i < iGroup * 4 + 4; i++ )
+		{
+			bool bVisible = true;
+			for( IndexT iPlane = 0; iPlane < NUM_PLANES_TO_USE; iPlane++ )
+			{
+				const mxPlane & p = mPlanes[ iPlane ];
+				const FLOAT distance = p.a * centerX[i] + p.b * centerY[i] + p.c * centerZ[i] + p.d
+					+ mxMath::Fabs( p.a ) * extentX[i]
+					+ mxMath::Fabs( p.b ) * extentY[i]
+					+ mxMath::Fabs( p.c ) * extentZ[i];
+				if( distance < 0.0f ) {
+					bVisible = false;
+					break;
+				}
+			}
+			if( bVisible ) {
+				OutVisibilityMask[ i >> 5 ] |= 1UL << ( i & 31 );
+			}
+		}
+	}
+
+#endif // MX_USE_SSE_ASM
+
+	// Clear the bits of padding elements.
+	if( numBoxes & 31 ) {
+		OutVisibilityMask[ numBoxes >> 5 ] &= ( 1UL << ( numBoxes & 31 ) ) - 1;
+	}
+}
+
 //
 //	mxViewFrustum::ExtractFrustumPlanes
 //
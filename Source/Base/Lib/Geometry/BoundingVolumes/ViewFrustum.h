@@ -10,6 +10,9 @@
 
 namespace abc {
 
+class mxSphereSoA;
+class mxAABBSoA;
+
 //
 //	EFrustumPlane
 //
@@ -47,6 +50,16 @@ public:
 
 	FASTBOOL	IntersectSphere( const Sphere& theSphere ) const;
 
+	//
+	// Batch culling.
+	//
+	// Tests several bounding volumes at once (using SIMD instructions, if available)
+	// and writes a visibility mask with one bit per volume (see GetVisibilityMaskSize()).
+	// The results are the same as those of IntersectSphere() and IntersectsAABB().
+	//
+	void		CullSpheres( const mxSphereSoA& spheres, UDWORD *OutVisibilityMask ) const;
+	void		CullBoxes( const mxAABBSoA& boxes, UDWORD *OutVisibilityMask ) const;
+
 	//
 	// Builds frustum planes from the given matrix.
 	//
@@ -113,6 +113,55 @@ INLINE INT Hash32Bits_1( INT key )
 	return key;
 }
 
+//
+//	Well-distributed 32-bit hashes (all bits of the result are usable).
+//
+
+// FNV-1a.
+INLINE UINT32 mxHashString( const char *str ) {
+	UINT32 hash = 2166136261U;
+	while ( *str ) {
+		hash ^= (BYTE) *str++;
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+// FNV-1a hash of a block of memory, 'seed' can be used to hash several blocks.
+INLINE UINT32 mxHashBytes( const void* data, SizeT numBytes, UINT32 seed = 2166136261U ) {
+	const BYTE * bytes = static_cast< const BYTE* >( data );
+	UINT32 hash = seed;
+	for ( SizeT i = 0; i < numBytes; i++ ) {
+		hash ^= bytes[ i ];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+// Finalizer of MurmurHash3.
+INLINE UINT32 mxHashUInt32( UINT32 key ) {
+	key ^= key >> 16;
+	key *= 0x85EBCA6BU;
+	key ^= key >> 13;
+	key *= 0xC2B2AE35U;
+	key ^= key >> 16;
+	return key;
+}
+
+// Finalizer of MurmurHash3 (64-bit), folded to 32 bits.
+INLINE UINT32 mxHashUInt64( UINT64 key ) {
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return (UINT32) key;
+}
+
+INLINE UINT32 mxHashPointer( const void* ptr ) {
+	return mxHashUInt64( (UINT64) (size_t) ptr );
+}
+
 //
 //	Hash traits.
 //
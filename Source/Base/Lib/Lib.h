@@ -14,13 +14,14 @@
 
 #include <Lib/Templates/Templates.h>
 
+// Sorting algorithms (used by containers).
+#include <Lib/Utilities/Sort.h>
+
 #include <Lib/Hashing/HashFunctions.h>
 
-// Hash tables and maps.
-#include <Lib/Templates/Containers/HashMap/StringHash.h>
+// Trees and maps.
 //#include <Lib/Containers/HashMap/BTree.h>
 #include <Lib/Templates/Containers/HashMap/RBTreeMap.h>
-//#include <Lib/Containers/HashMap/TMap.h>
 //#include <Lib/Containers/HashMap/TKeyValue.h>
 //#include <Lib/Containers/HashMap/Dictionary.h>
 
@@ -36,6 +37,13 @@
 #include <Lib/Templates/Containers/Array/TStaticList.h>
 #include <Lib/Templates/Containers/Array/TFixedArray.h>
 #include <Lib/Templates/Containers/Array/TStatic2DArray.h>
+#include <Lib/Templates/Containers/Array/TAllocArray.h>
+
+// Hash tables (stored in arrays).
+#include <Lib/Templates/Containers/HashMap/HashMap.h>
+
+// Interned names (must be included after hash tables).
+#include <Lib/String/NameId.h>
 
 // Lists.
 #include <Lib/Templates/Containers/List/TLinkedList.h>
@@ -77,6 +85,7 @@
 #include <Lib/Geometry/BoundingVolumes/Sphere.h>
 #include <Lib/Geometry/BoundingVolumes/AABB.h>
 #include <Lib/Geometry/BoundingVolumes/OOBB.h>
+#include <Lib/Geometry/BoundingVolumes/CullingVolumes.h>
 #include <Lib/Geometry/BoundingVolumes/ViewFrustum.h>
 #include <Lib/Geometry/BoundingVolumes/Bounds.h>
 
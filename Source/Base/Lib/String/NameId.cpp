@@ -0,0 +1,286 @@
+/*
+=============================================================================
+	File:	NameId.cpp
+	Desc:	Interned names (unique strings identified by integer handles).
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+//
+//	NameEntry
+//
+struct NameEntry
+{
+	const char *	str;
+	UINT32			hash;
+	UINT32			length;
+};
+
+//
+//	NameKeyTraits - the name table is keyed by pointers to the stored strings.
+//
+struct NameKeyTraits
+{
+	static FORCEINLINE UINT32 GetHash( const char* key ) {
+		return mxHashString( key );
+	}
+	static FORCEINLINE bool Equals( const char* a, const char* b ) {
+		return ( String::Cmp( a, b ) == 0 );
+	}
+};
+
+//
+//	mxNameTable
+//
+//	Entries and characters are allocated in blocks which never move,
+//	so a string can be read by its index without locking the table.
+//
+class mxNameTable {
+public:
+	enum {
+		ENTRIES_PER_BLOCK	= 4096,
+		MAX_ENTRY_BLOCKS	= 1024,
+		CHARS_PER_BLOCK		= 64 * 1024,
+	};
+
+	mxNameTable();
+	~mxNameTable();
+
+	UINT32	Intern( const char* str );
+	UINT32	Find( const char* str );
+
+	const NameEntry &	GetEntry( UINT32 index ) const;
+
+	mxUInt	Num() const;
+
+private:
+	const char *	StoreString( const char* str, mxUInt length );
+	UINT32			AddEntry( const char* str, UINT32 hash, mxUInt length );
+
+private:
+	sys::CriticalSection	lock;
+
+	THashMap< const char*, UINT32, NameKeyTraits >	indices;
+
+	NameEntry *		entryBlocks[ MAX_ENTRY_BLOCKS ];
+	UINT32			numEntries;
+
+	TArray< char* >	charBlocks;		// all allocated blocks of characters
+	char *			currentBlock;	// short strings are packed into this block
+	mxUInt			charsUsed;		// in the current block
+};
+
+mxNameTable::mxNameTable()
+	: numEntries( 0 )
+	, currentBlock( null )
+	, charsUsed( 0 )
+{
+	MemZero( this->entryBlocks, sizeof(this->entryBlocks) );
+
+	// index zero is reserved for the empty name
+	AddEntry( "", mxHashString( "" ), 0 );
+}
+
+mxNameTable::~mxNameTable()
+{
+	for ( mxUInt i = 0; i < MAX_ENTRY_BLOCKS; i++ ) {
+		delete[] this->entryBlocks[ i ];
+	}
+	for ( mxUInt i = 0; i < this->charBlocks.Num(); i++ ) {
+		delete[] this->charBlocks[ i ];
+	}
+}
+
+const char * mxNameTable::StoreString( const char* str, mxUInt length )
+{
+	const mxUInt size = length + 1;
+
+	// long strings get their own blocks
+	if ( size > CHARS_PER_BLOCK / 4 )
+	{
+		char * newBlock = new char[ size ];
+		MemCopy( newBlock, str, size );
+		this->charBlocks.Append( newBlock );
+		return newBlock;
+	}
+
+	if ( !this->currentBlock || this->charsUsed + size > CHARS_PER_BLOCK )
+	{
+		this->currentBlock = new char[ CHARS_PER_BLOCK ];
+		this->charBlocks.Append( this->currentBlock );
+		this->charsUsed = 0;
+	}
+
+	char * dest = this->currentBlock + this->charsUsed;
+	MemCopy( dest, str, size );
+	this->charsUsed += size;
+
+	return dest;
+}
+
+UINT32 mxNameTable::AddEntry( const char* str, UINT32 hash, mxUInt length )
+{
+	const UINT32 index = this->numEntries;
+	const UINT32 blockIndex = index / ENTRIES_PER_BLOCK;
+
+	if ( blockIndex >= MAX_ENTRY_BLOCKS ) {
+		sys::Error( "Too many names (%u)", index );
+		return 0;
+	}
+
+	if ( !this->entryBlocks[ blockIndex ] ) {
+		this->entryBlocks[ blockIndex ] = new NameEntry[ ENTRIES_PER_BLOCK ];
+	}
+
+	NameEntry & newEntry = this->entryBlocks[ blockIndex ][ index % ENTRIES_PER_BLOCK ];
+	newEntry.str = StoreString( str, length );
+	newEntry.hash = hash;
+	newEntry.length = length;
+
+	this->indices.Set( newEntry.str, index );
+
+	// the entry is written before it becomes visible to other threads
+	this->numEntries = index + 1;
+
+	return index;
+}
+
+UINT32 mxNameTable::Intern( const char* str )
+{
+	AssertPtr( str );
+	if ( !*str ) {
+		return 0;
+	}
+
+	sys::ScopedLock  scopedLock( this->lock );
+
+	if ( const UINT32 * existing = this->indices.Find( str ) ) {
+		return *existing;
+	}
+
+	return AddEntry( str, mxHashString( str ), sys::StrLen( str ) );
+}
+
+UINT32 mxNameTable::Find( const char* str )
+{
+	AssertPtr( str );
+	if ( !*str ) {
+		return 0;
+	}
+
+	sys::ScopedLock  scopedLock( this->lock );
+
+	const UINT32 * existing = this->indices.Find( str );
+	return existing ? *existing : 0;
+}
+
+FORCEINLINE const NameEntry & mxNameTable::GetEntry( UINT32 index ) const
+{
+	Assert( index < this->numEntries );
+	return this->entryBlocks[ index / ENTRIES_PER_BLOCK ][ index % ENTRIES_PER_BLOCK ];
+}
+
+mxUInt mxNameTable::Num() const
+{
+	return this->numEntries;
+}
+
+//
+// Names are created by constructors of static objects (e.g. class names),
+// so the table is created on first use and never destroyed.
+// Function-local statics are not thread-safe in VC++ 2008 and the first use can happen
+// on several threads at once, so the construction is guarded with an interlocked flag
+// (the same way as the global heap is created).
+//
+enum ENameTableState
+{
+	NAME_TABLE_NOT_CREATED,
+	NAME_TABLE_BEING_CREATED,
+	NAME_TABLE_READY
+};
+
+// These variables are initialized statically, before any code runs.
+sys::AtomicInt	gNameTableState = NAME_TABLE_NOT_CREATED;
+mxNameTable *	gNameTable = null;
+
+union NameTableStorage
+{
+	BYTE	storage[ sizeof(mxNameTable) ];
+	double	alignment;
+};
+NameTableStorage	gNameTableStorage;
+
+mxNameTable & CreateNameTable()
+{
+	if ( sys::AtomicCompareExchange( &gNameTableState, NAME_TABLE_BEING_CREATED, NAME_TABLE_NOT_CREATED ) == NAME_TABLE_NOT_CREATED )
+	{
+		gNameTable = new( gNameTableStorage.storage ) mxNameTable();
+		sys::AtomicExchange( &gNameTableState, NAME_TABLE_READY );	// also a memory barrier
+	}
+	else
+	{
+		// Another thread is constructing the table.
+		while ( gNameTableState != NAME_TABLE_READY ) {
+			::SwitchToThread();
+		}
+	}
+	return *gNameTable;
+}
+
+FORCEINLINE mxNameTable & GetNameTable()
+{
+	if ( gNameTableState == NAME_TABLE_READY ) {
+		return *gNameTable;
+	}
+	return CreateNameTable();
+}
+
+}//End of anonymous namespace
+
+/*================================
+		mxNameId
+================================*/
+
+mxNameId::mxNameId( const char* str )
+	: index( GetNameTable().Intern( str ) )
+{}
+
+mxNameId mxNameId::Find( const char* str )
+{
+	mxNameId  result;
+	result.index = GetNameTable().Find( str );
+	return result;
+}
+
+const char * mxNameId::ToChar() const
+{
+	return GetNameTable().GetEntry( this->index ).str;
+}
+
+mxUInt mxNameId::Length() const
+{
+	return GetNameTable().GetEntry( this->index ).length;
+}
+
+UINT32 mxNameId::GetHash() const
+{
+	return GetNameTable().GetEntry( this->index ).hash;
+}
+
+mxUInt mxNameId::NumNames()
+{
+	return GetNameTable().Num();
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
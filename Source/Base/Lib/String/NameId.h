@@ -0,0 +1,103 @@
+/*
+=============================================================================
+	File:	NameId.h
+	Desc:	Interned names (unique strings identified by integer handles).
+=============================================================================
+*/
+
+#ifndef __MX_NAME_ID_H__
+#define __MX_NAME_ID_H__
+
+namespace abc {
+
+//
+//	mxNameId - a handle to a string in the global name table.
+//
+//	Each distinct string is stored only once, so names are compared as integers
+//	and can be used as hash keys without touching the characters.
+//	The hash of the string is computed once, when the string is added to the table.
+//
+//	Names are never removed from the table, it should only be used
+//	for identifiers (class names, resource names, etc), not for arbitrary text.
+//	The table is thread-safe and can be used during static initialization.
+//
+class mxNameId {
+public:
+					// Creates an empty name.
+					mxNameId();
+
+					// Adds the string to the name table if it isn't there yet.
+	explicit		mxNameId( const char* str );
+
+					// Returns an empty name if the string has not been added to the table
+					// (and doesn't add it, e.g. for looking up user input).
+	static mxNameId	Find( const char* str );
+
+	bool			IsEmpty() const;
+
+	const char *	ToChar() const;
+	const char *	c_str() const;
+
+	mxUInt			Length() const;
+
+					// Hash of the string (same as mxHashString()).
+	UINT32			GetHash() const;
+
+					// Unique index of the string in the name table, zero means an empty name.
+	UINT32			GetIndex() const;
+
+	bool	operator == ( const mxNameId& other ) const;
+	bool	operator != ( const mxNameId& other ) const;
+
+					// Returns the total number of names in the table.
+	static mxUInt	NumNames();
+
+private:
+	UINT32		index;
+};
+
+FORCEINLINE mxNameId::mxNameId()
+	: index( 0 )
+{}
+
+FORCEINLINE bool mxNameId::IsEmpty() const {
+	return ( this->index == 0 );
+}
+
+FORCEINLINE const char * mxNameId::c_str() const {
+	return this->ToChar();
+}
+
+FORCEINLINE UINT32 mxNameId::GetIndex() const {
+	return this->index;
+}
+
+FORCEINLINE bool mxNameId::operator == ( const mxNameId& other ) const {
+	return ( this->index == other.index );
+}
+
+FORCEINLINE bool mxNameId::operator != ( const mxNameId& other ) const {
+	return ( this->index != other.index );
+}
+
+//
+//	Names can be used as keys in hash maps.
+//
+template<>
+struct THashTraits< mxNameId >
+{
+	static FORCEINLINE UINT32 GetHash( const mxNameId& key ) {
+		return mxHashUInt32( key.GetIndex() );
+	}
+	static FORCEINLINE bool Equals( const mxNameId& a, const mxNameId& b ) {
+		return ( a == b );
+	}
+};
+
+}//End of namespace abc
+
+#endif // !__MX_NAME_ID_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
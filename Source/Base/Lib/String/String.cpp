@@ -36,8 +36,8 @@ void String::ReAllocate( INT amount, bool keepold ) {
 	}
 	alloced = newsize;
 
-#ifdef USE_STRING_POOL
-	newbuffer = ::abc::Allocate( alloced, EMemoryClass::MX_MEMORY_CLASS_STRING );
+#ifdef MX_USE_STRING_POOL
+	newbuffer = ( char* )::abc::Allocate( alloced, EMemoryClass::MX_MEMORY_CLASS_STRING );
 #else
 	//newbuffer = new char[ alloced ];	
 	newbuffer = ( char* )malloc( alloced );
@@ -50,7 +50,7 @@ void String::ReAllocate( INT amount, bool keepold ) {
 
 	if ( data && data != baseBuffer )
 	{
-#ifdef USE_STRING_POOL
+#ifdef MX_USE_STRING_POOL
 		::abc::Free( data, EMemoryClass::MX_MEMORY_CLASS_STRING );
 #else
 		//delete [] data;
@@ -71,7 +71,7 @@ void String::FreeData( void )
 	if ( data && data != baseBuffer )
 	{
 
-#ifdef USE_STRING_POOL
+#ifdef MX_USE_STRING_POOL
 		::abc::Free( data, EMemoryClass::MX_MEMORY_CLASS_STRING );
 #else
 		//delete [] data;
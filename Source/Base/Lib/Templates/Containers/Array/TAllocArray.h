@@ -0,0 +1,193 @@
+/*
+=============================================================================
+	File:	TAllocArray.h
+	Desc:	A growing array which takes memory from the given allocator.
+=============================================================================
+*/
+
+#ifndef __T_ALLOC_ARRAY_H__
+#define __T_ALLOC_ARRAY_H__
+
+namespace abc {
+
+//
+//	TAllocArray< type > - a dynamic array for POD types which uses an arbitrary memory allocator
+//	(e.g. the frame arena for temporary per-frame data).
+//
+//	NOTE: elements are copied with MemCopy(), constructors and destructors are not called.
+//	If the memory is taken from the frame arena, Clear() should be called every frame,
+//	because the arena recycles its memory.
+//
+template< class type >
+class TAllocArray {
+public:
+	explicit		TAllocArray( IMemoryAllocator* theAllocator = null, mxUInt newgranularity = 16 );
+					~TAllocArray();
+
+	void			Clear();									// frees memory
+	void			Empty();									// sets the number of elements to zero, doesn't free memory
+
+	mxUInt			Num() const;								// returns number of elements in list
+	mxUInt			NumAllocated() const;						// returns number of elements allocated for
+
+	IMemoryAllocator *	GetAllocator() const;
+
+	const type &	operator [] ( mxUInt index ) const;
+	type &			operator [] ( mxUInt index );
+
+	type *			Ptr();
+	const type *	Ptr() const;
+
+	void			Resize( mxUInt newsize );					// resizes list to the given number of elements
+	void			SetNum( mxUInt newnum );					// set number of elements in list, grows if necessary
+
+	type &			Alloc();									// returns reference to a new data element at the end of the list
+	mxUInt			Append( const type & obj );					// append element
+
+private:
+	void			Grow();
+
+private:
+	IMemoryAllocator *	allocator;
+	mxUInt		num;			// number of elements in list
+	mxUInt		size;			// number of allocated elements
+	mxUInt		granularity;	// minimum number of elements to allocate
+	type *		list;			// pointer to allocated memory
+
+private:
+	TAllocArray( const TAllocArray& );
+	TAllocArray & operator = ( const TAllocArray& );
+};
+
+template< class type >
+FORCEINLINE TAllocArray<type>::TAllocArray( IMemoryAllocator* theAllocator, mxUInt newgranularity )
+	: allocator( theAllocator ? theAllocator : Mem_GetAllocator() )
+	, num( 0 )
+	, size( 0 )
+	, granularity( newgranularity )
+	, list( null )
+{
+	Assert( newgranularity > 0 );
+}
+
+template< class type >
+FORCEINLINE TAllocArray<type>::~TAllocArray() {
+	Clear();
+}
+
+template< class type >
+FORCEINLINE void TAllocArray<type>::Clear() {
+	if ( list ) {
+		allocator->Free( list );
+	}
+	list = null;
+	num = 0;
+	size = 0;
+}
+
+template< class type >
+FORCEINLINE void TAllocArray<type>::Empty() {
+	num = 0;
+}
+
+template< class type >
+FORCEINLINE mxUInt TAllocArray<type>::Num() const {
+	return num;
+}
+
+template< class type >
+FORCEINLINE mxUInt TAllocArray<type>::NumAllocated() const {
+	return size;
+}
+
+template< class type >
+FORCEINLINE IMemoryAllocator * TAllocArray<type>::GetAllocator() const {
+	return allocator;
+}
+
+template< class type >
+FORCEINLINE const type & TAllocArray<type>::operator [] ( mxUInt index ) const {
+	Assert( index < num );
+	return list[ index ];
+}
+
+template< class type >
+FORCEINLINE type & TAllocArray<type>::operator [] ( mxUInt index ) {
+	Assert( index < num );
+	return list[ index ];
+}
+
+template< class type >
+FORCEINLINE type * TAllocArray<type>::Ptr() {
+	return list;
+}
+
+template< class type >
+FORCEINLINE const type * TAllocArray<type>::Ptr() const {
+	return list;
+}
+
+template< class type >
+void TAllocArray<type>::Resize( mxUInt newsize ) {
+	if ( newsize == 0 ) {
+		Clear();
+		return;
+	}
+	if ( newsize == size ) {
+		return;
+	}
+
+	type * newlist = static_cast< type* >( allocator->Allocate( newsize * sizeof(type) ) );
+	AssertPtr( newlist );
+
+	if ( num > newsize ) {
+		num = newsize;
+	}
+	if ( list ) {
+		if ( num ) {
+			MemCopy( newlist, list, num * sizeof(type) );
+		}
+		allocator->Free( list );
+	}
+	list = newlist;
+	size = newsize;
+}
+
+template< class type >
+FORCEINLINE void TAllocArray<type>::SetNum( mxUInt newnum ) {
+	if ( newnum > size ) {
+		Resize( ( newnum > size * 2 ) ? newnum : size * 2 );
+	}
+	num = newnum;
+}
+
+template< class type >
+FORCEINLINE void TAllocArray<type>::Grow() {
+	// grow geometrically, because memory from linear allocators is not reused
+	Resize( ( size * 2 > granularity ) ? size * 2 : granularity );
+}
+
+template< class type >
+FORCEINLINE type & TAllocArray<type>::Alloc() {
+	if ( num == size ) {
+		Grow();
+	}
+	return list[ num++ ];
+}
+
+template< class type >
+FORCEINLINE mxUInt TAllocArray<type>::Append( const type & obj ) {
+	if ( num == size ) {
+		Grow();
+	}
+	list[ num ] = obj;
+	return num++;
+}
+
+}//End of namespace abc
+
+#endif // ! __T_ALLOC_ARRAY_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -19,8 +19,13 @@ FORCEINLINE INT SortCompare( const type *a, const type *b ) {
 //	TArray< T > - dynamic array.
 //
 //	Does not allocate memory until the first item is added.
-//	Uses 'new' and 'delete' to reallocate its contents so pointers
-//	to TArray items can become invalid when TArrays are growing/shrinking
+//	Only the first Num() elements are constructed, the rest of the allocated memory is raw storage.
+//	The capacity grows geometrically (by half of the current size, but at least by 'granularity'),
+//	so appending N elements takes amortized O(N) time.
+//
+//	When the array is reallocated, plain old data (see TTypeTraits) is relocated with MemCopy(),
+//	other types are copy-constructed into the new memory and then destroyed,
+//	so pointers to TArray items can become invalid when TArrays are growing/shrinking
 //	(in that case handles (integer offsets) can be used instead of pointers).
 //
 //	Swiped from Id Software ( idList ).
@@ -30,7 +35,7 @@ template< typename type >
 class TArray {
 public:
 
-	typedef mxUInt	cmp_t( const type *, const type * );
+	typedef INT		cmp_t( const type *, const type * );
 	typedef type	new_t( void );
 
 					TArray( mxUInt newgranularity = 16 );
@@ -76,11 +81,26 @@ public:
 	mxUInt			IndexOf( const type *obj ) const;					// returns the index for the pointer to an element in the list
 	bool			RemoveIndex( mxUInt index );							// remove the element at the given index
 	bool			Remove( const type & obj );							// remove the element
-	void			Sort( cmp_t *compare = ( cmp_t * )&SortCompare<type> );
-	void			SortSubSection( mxUInt startIndex, mxUInt endIndex, cmp_t *compare = ( cmp_t * )&SortCompare<type> );
+	void			Sort( void );										// sort the list in increasing order using operator <
+	template< class LESS >
+	void			Sort( const LESS& less );							// sort the list using a comparator (see Sort.h)
+	void			Sort( cmp_t *compare );
+	void			SortSubSection( mxUInt startIndex, mxUInt endIndex, cmp_t *compare = &SortCompare<type> );
 	void			Swap( TArray<type> &other );						// swap the contents of the lists
 	void			DeleteContents( bool clear );						// delete the contents of the list
 
+	void			Reserve( mxUInt numElements );						// makes sure the list can hold the given number of elements without reallocating
+
+private:
+	void			Grow( mxUInt minSize );								// increases the capacity geometrically
+
+	static type *	AllocateElements( mxUInt count );
+	static void		FreeElements( type * elements );
+	static void		ConstructElements( type * elements, mxUInt count );
+	static void		CopyConstructElements( type * dest, const type * src, mxUInt count );
+	static void		DestructElements( type * elements, mxUInt count );
+	static void		RelocateElements( type * dest, type * src, mxUInt count );
+
 private:
 	mxUInt		num;			// number of elements in list
 	mxUInt		size;			// number of allocated elements
@@ -133,7 +153,8 @@ Frees up the memory allocated by the list.  Assumes that type automatically hand
 template< class type >
 FORCEINLINE void TArray<type>::Clear( void ) {
 	if ( list ) {
-		delete[] list;
+		DestructElements( list, num );
+		FreeElements( list );
 	}
 
 	list	= NULL;
@@ -164,8 +185,6 @@ FORCEINLINE void TArray<type>::DeleteContents( bool clear ) {
 
 	if ( clear ) {
 		Clear();
-	} else {
-		MemSet( list, 0, size * sizeof( type ) );
 	}
 }
 
@@ -232,15 +251,23 @@ FORCEINLINE mxUInt TArray<type>::NumAllocated( void ) const {
 ================
 TArray<type>::SetNum
 
-Resize to the exact size specified irregardless of granularity
+Resize to the exact size specified irregardless of granularity.
+New elements are default-constructed, removed elements are destroyed.
 ================
 */
 template< class type >
 FORCEINLINE void TArray<type>::SetNum( mxUInt newnum, bool resize ) {
 	Assert( newnum >= 0 );
+	if ( newnum < num ) {
+		DestructElements( list + newnum, num - newnum );
+		num = newnum;
+	}
 	if ( resize || newnum > size ) {
 		Resize( newnum );
 	}
+	if ( newnum > num ) {
+		ConstructElements( list + num, newnum - num );
+	}
 	num = newnum;
 }
 
@@ -303,13 +330,13 @@ FORCEINLINE void TArray<type>::Condense( void ) {
 TArray<type>::Resize
 
 Allocates memory for the amount of elements requested while keeping the contents intact.
-Contents are copied using their = operator so that data is correctly instantiated.
+Contents are relocated into the new memory (see RelocateElements()),
+elements which don't fit are destroyed.
 ================
 */
 template< class type >
 FORCEINLINE void TArray<type>::Resize( mxUInt newsize ) {
 	type	*temp;
-	mxUInt		i;
 
 	Assert( newsize >= 0 );
 
@@ -324,23 +351,21 @@ FORCEINLINE void TArray<type>::Resize( mxUInt newsize ) {
 		return;
 	}
 
+	if ( newsize < num ) {
+		DestructElements( list + newsize, num - newsize );
+		num = newsize;
+	}
+
 	temp	= list;
 	size	= newsize;
 
-	//MX_BUG( "added "|| num == 0"" );
-	if ( size < num ) {
-		num = size;
-	}
-
-	// copy the old list into our new one
-	list = new type[ size ];
-	for( i = 0; i < num; i++ ) {
-		list[ i ] = temp[ i ];
-	}
+	// move the old list into our new one
+	list = AllocateElements( size );
+	RelocateElements( list, temp, num );
 
 	// delete the old list if it exists
 	if ( temp ) {
-		delete[] temp;
+		FreeElements( temp );
 	}
 }
 
@@ -348,42 +373,62 @@ FORCEINLINE void TArray<type>::Resize( mxUInt newsize ) {
 ================
 TArray<type>::Resize
 
-Allocates memory for the amount of elements requested while keeping the contents intact.
-Contents are copied using their = operator so that data is correnctly instantiated.
+Allocates memory for the amount of elements requested while keeping the contents intact
+and sets new granularity.
 ================
 */
 template< class type >
 FORCEINLINE void TArray<type>::Resize( mxUInt newsize, mxUInt newgranularity ) {
-	type	*temp;
-	mxUInt		i;
-
-	Assert( newsize >= 0 );
-
 	Assert( newgranularity > 0 );
 	granularity = newgranularity;
 
-	// free up the list if no data is being reserved
-	if ( newsize <= 0 ) {
-		Clear();
-		return;
-	}
+	Resize( newsize );
+}
 
-	temp	= list;
-	size	= newsize;
-	if ( size < num ) {
-		num = size;
+/*
+================
+TArray<type>::Reserve
+
+Makes sure the list can hold the given number of elements without reallocating.
+Doesn't change the number of elements.
+================
+*/
+template< class type >
+FORCEINLINE void TArray<type>::Reserve( mxUInt numElements ) {
+	if ( numElements > size ) {
+		Resize( numElements );
 	}
+}
 
-	// copy the old list into our new one
-	list = new type[ size ];
-	for( i = 0; i < num; i++ ) {
-		list[ i ] = temp[ i ];
+/*
+================
+TArray<type>::Grow
+
+Increases the capacity to at least the given number of elements.
+The capacity grows geometrically, so that appending N elements takes amortized O(N) time.
+================
+*/
+template< class type >
+FORCEINLINE void TArray<type>::Grow( mxUInt minSize ) {
+	mxUInt newsize;
+
+	if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
+		granularity = 16;
 	}
 
-	// delete the old list if it exists
-	if ( temp ) {
-		delete[] temp;
+	newsize = size + size / 2;
+	if ( newsize < size + granularity ) {
+		newsize = size + granularity;
+	}
+	if ( newsize < minSize ) {
+		newsize = minSize;
 	}
+
+	// round up to the closest level of granularity
+	newsize += granularity - 1;
+	newsize -= newsize % granularity;
+
+	Resize( newsize );
 }
 
 /*
@@ -395,20 +440,11 @@ Makes sure the list has at least the given number of elements.
 */
 template< class type >
 FORCEINLINE void TArray<type>::AssureSize( mxUInt newSize ) {
-	mxUInt newNum = newSize;
-
 	if ( newSize > size ) {
-
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
-		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
-		Resize( newSize );
+		Grow( newSize );
 	}
 
-	num = newNum;
+	SetNum( newSize, false );
 }
 
 /*
@@ -420,25 +456,26 @@ Makes sure the list has at least the given number of elements and initialize any
 */
 template< class type >
 FORCEINLINE void TArray<type>::AssureSize( mxUInt newSize, const type &initValue ) {
-	mxUInt newNum = newSize;
+	if ( newSize <= num ) {
+		SetNum( newSize, false );
+		return;
+	}
 
 	if ( newSize > size ) {
+		// 'initValue' may point into this list
+		const type  value( initValue );
+		Grow( newSize );
 
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
+		for ( mxUInt i = num; i < newSize; i++ ) {
+			::new( &list[i] ) type( value );
 		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
-		num = size;
-		Resize( newSize );
-
+	} else {
 		for ( mxUInt i = num; i < newSize; i++ ) {
-			list[i] = initValue;
+			::new( &list[i] ) type( initValue );
 		}
 	}
 
-	num = newNum;
+	num = newSize;
 }
 
 /*
@@ -453,25 +490,20 @@ on non-pointer lists will cause a compiler error.
 */
 template< class type >
 FORCEINLINE void TArray<type>::AssureSizeAlloc( mxUInt newSize, new_t *allocator ) {
-	mxUInt newNum = newSize;
+	if ( newSize <= num ) {
+		SetNum( newSize, false );
+		return;
+	}
 
 	if ( newSize > size ) {
+		Grow( newSize );
+	}
 
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
-		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
-		num = size;
-		Resize( newSize );
-
-		for ( mxUInt i = num; i < newSize; i++ ) {
-			list[i] = (*allocator)();
-		}
+	for ( mxUInt i = num; i < newSize; i++ ) {
+		list[i] = (*allocator)();
 	}
 
-	num = newNum;
+	num = newSize;
 }
 
 /*
@@ -483,7 +515,9 @@ Copies the contents and size attributes of another list.
 */
 template< class type >
 FORCEINLINE TArray<type> &TArray<type>::operator=( const TArray<type> &other ) {
-	mxUInt	i;
+	if ( this == &other ) {
+		return *this;
+	}
 
 	Clear();
 
@@ -492,10 +526,8 @@ FORCEINLINE TArray<type> &TArray<type>::operator=( const TArray<type> &other ) {
 	granularity	= other.granularity;
 
 	if ( size ) {
-		list = new type[ size ];
-		for( i = 0; i < num; i++ ) {
-			list[ i ] = other.list[ i ];
-		}
+		list = AllocateElements( size );
+		CopyConstructElements( list, other.list, num );
 	}
 
 	return *this;
@@ -586,14 +618,12 @@ Returns a reference to a new data element at the end of the list.
 */
 template< class type >
 FORCEINLINE type &TArray<type>::Alloc( void ) {
-	if ( !list ) {
-		Resize( granularity );
-	}
-
 	if ( num == size ) {
-		Resize( size + granularity );
+		Grow( num + 1 );
 	}
 
+	ConstructElements( list + num, 1 );
+
 	return list[ num++ ];
 }
 
@@ -608,21 +638,15 @@ Returns the index of the new element.
 */
 template< class type >
 FORCEINLINE mxUInt TArray<type>::Append( type const & obj ) {
-	if ( !list ) {
-		Resize( granularity );
-	}
-
 	if ( num == size ) {
-		mxUInt newsize;
-
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
-		}
-		newsize = size + granularity;
-		Resize( newsize - newsize % granularity );
+		// 'obj' may point into this list
+		const type  value( obj );
+		Grow( num + 1 );
+		::new( &list[ num ] ) type( value );
+	} else {
+		::new( &list[ num ] ) type( obj );
 	}
 
-	list[ num ] = obj;
 	num++;
 
 	return num - 1;
@@ -641,31 +665,35 @@ Returns the index of the new element.
 */
 template< class type >
 FORCEINLINE mxUInt TArray<type>::Insert( type const & obj, mxUInt index ) {
-	if ( !list ) {
-		Resize( granularity );
-	}
-
-	if ( num == size ) {
-		mxUInt newsize;
-
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
-		}
-		newsize = size + granularity;
-		Resize( newsize - newsize % granularity );
-	}
-
 	if ( index < 0 ) {
 		index = 0;
 	}
 	else if ( index > num ) {
 		index = num;
 	}
-	for ( mxUInt i = num; i > index; --i ) {
-		list[i] = list[i-1];
+
+	if ( index == num ) {
+		return Append( obj );
+	}
+
+	// 'obj' may point into this list
+	const type  value( obj );
+
+	if ( num == size ) {
+		Grow( num + 1 );
+	}
+
+	if ( TTypeTraits< type >::IsPlainOldData ) {
+		MemMove( &list[ index + 1 ], &list[ index ], ( num - index ) * sizeof( type ) );
+		::new( &list[ index ] ) type( value );
+	} else {
+		::new( &list[ num ] ) type( list[ num - 1 ] );
+		for ( mxUInt i = num - 1; i > index; --i ) {
+			list[i] = list[i-1];
+		}
+		list[index] = value;
 	}
 	num++;
-	list[index] = obj;
 	return index;
 }
 
@@ -680,18 +708,16 @@ Returns the size of the new combined list
 */
 template< class type >
 FORCEINLINE mxUInt TArray<type>::Append( const TArray<type> &other ) {
-	if ( !list ) {
-		if ( granularity == 0 ) {	// this is a hack to fix our MemSet classes
-			granularity = 16;
-		}
-		Resize( granularity );
-	}
+	const mxUInt n = other.Num();
 
-	mxUInt n = other.Num();
-	for (mxUInt i = 0; i < n; i++) {
-		Append(other[i]);
+	if ( num + n > size ) {
+		// NOTE: if 'other' is this list, its pointer is updated too
+		Grow( num + n );
 	}
 
+	CopyConstructElements( list + num, other.list, n );
+	num += n;
+
 	return Num();
 }
 
@@ -807,7 +833,7 @@ TArray<type>::RemoveIndex
 
 Removes the element at the specified index and moves all data following the element down to fill in the gap.
 The number of elements in the list is reduced by one.  Returns false if the index is outside the bounds of the list.
-Note that the element is not destroyed, so any memory used by it may not be freed until the destruction of the list.
+The last element of the list is destroyed after the data has been moved.
 ================
 */
 template< class type >
@@ -823,8 +849,13 @@ FORCEINLINE bool TArray<type>::RemoveIndex( mxUInt index ) {
 	}
 
 	num--;
-	for( i = index; i < num; i++ ) {
-		list[ i ] = list[ i + 1 ];
+	if ( TTypeTraits< type >::IsPlainOldData ) {
+		MemMove( &list[ index ], &list[ index + 1 ], ( num - index ) * sizeof( type ) );
+	} else {
+		for( i = index; i < num; i++ ) {
+			list[ i ] = list[ i + 1 ];
+		}
+		DestructElements( list + num, 1 );
 	}
 
 	return true;
@@ -854,19 +885,24 @@ FORCEINLINE bool TArray<type>::Remove( type const & obj ) {
 ================
 TArray<type>::Sort
 
-Performs a qsort on the list using the supplied comparison function.  Note that the data is merely moved around the
+Sorts the list with an introsort (see Sort.h), the sort is not stable.  Note that the data is merely moved around the
 list, so any pointers to data within the list may no longer be valid.
 ================
 */
 template< class type >
-FORCEINLINE void TArray<type>::Sort( cmp_t *compare ) {
-	if ( !list ) {
-		return;
-	}
-	typedef mxUInt cmp_c(const void *, const void *);
+FORCEINLINE void TArray<type>::Sort( void ) {
+	mxIntroSort( list, num, TLess< type >() );
+}
 
-	cmp_c *vCompare = (cmp_c *)compare;
-	::qsort( ( void * )list, ( size_t )num, sizeof( type ), vCompare );
+template< class type >
+template< class LESS >
+FORCEINLINE void TArray<type>::Sort( const LESS& less ) {
+	mxIntroSort( list, num, less );
+}
+
+template< class type >
+FORCEINLINE void TArray<type>::Sort( cmp_t *compare ) {
+	mxIntroSort( list, num, TCompareFuncLess< type >( compare ) );
 }
 
 /*
@@ -890,10 +926,7 @@ FORCEINLINE void TArray<type>::SortSubSection( mxUInt startIndex, mxUInt endInde
 	if ( startIndex >= endIndex ) {
 		return;
 	}
-	typedef mxUInt cmp_c(const void *, const void *);
-
-	cmp_c *vCompare = (cmp_c *)compare;
-	::qsort( ( void * )( &list[startIndex] ), ( size_t )( endIndex - startIndex + 1 ), sizeof( type ), vCompare );
+	mxIntroSort( &list[startIndex], endIndex - startIndex + 1, TCompareFuncLess< type >( compare ) );
 }
 
 /*
@@ -905,10 +938,79 @@ Swaps the contents of two lists
 */
 template< class type >
 FORCEINLINE void TArray<type>::Swap( TArray<type> &other ) {
-	Swap( num, other.num );
-	Swap( size, other.size );
-	Swap( granularity, other.granularity );
-	Swap( list, other.list );
+	::abc::Swap( num, other.num );
+	::abc::Swap( size, other.size );
+	::abc::Swap( granularity, other.granularity );
+	::abc::Swap( list, other.list );
+}
+
+/*
+================
+TArray<type>::AllocateElements
+
+Allocates raw memory for the given number of elements, doesn't construct them.
+================
+*/
+template< class type >
+FORCEINLINE type * TArray<type>::AllocateElements( mxUInt count ) {
+	return static_cast< type* >( Allocate( count * sizeof( type ) ) );
+}
+
+template< class type >
+FORCEINLINE void TArray<type>::FreeElements( type * elements ) {
+	Free( elements );
+}
+
+/*
+================
+TArray<type>::ConstructElements
+
+Default-constructs elements in raw memory, does nothing for types with trivial constructors.
+================
+*/
+template< class type >
+FORCEINLINE void TArray<type>::ConstructElements( type * elements, mxUInt count ) {
+	if ( !TTypeTraits< type >::HasTrivialConstructor ) {
+		for ( mxUInt i = 0; i < count; i++ ) {
+			::new( &elements[ i ] ) type;
+		}
+	}
+}
+
+template< class type >
+FORCEINLINE void TArray<type>::CopyConstructElements( type * dest, const type * src, mxUInt count ) {
+	if ( TTypeTraits< type >::IsPlainOldData ) {
+		if ( count ) {
+			MemCopy( dest, src, count * sizeof( type ) );
+		}
+	} else {
+		for ( mxUInt i = 0; i < count; i++ ) {
+			::new( &dest[ i ] ) type( src[ i ] );
+		}
+	}
+}
+
+template< class type >
+FORCEINLINE void TArray<type>::DestructElements( type * elements, mxUInt count ) {
+	if ( !TTypeTraits< type >::IsPlainOldData ) {
+		for ( mxUInt i = 0; i < count; i++ ) {
+			elements[ i ].~type();
+		}
+	}
+}
+
+/*
+================
+TArray<type>::RelocateElements
+
+Moves elements into raw memory, the source elements are destroyed.
+Plain old data is moved with a single MemCopy().
+================
+*/
+template< class type >
+FORCEINLINE void TArray<type>::RelocateElements( type * dest, type * src, mxUInt count ) {
+	CopyConstructElements( dest, src, count );
+	DestructElements( src, count );
 }
 
 }//end of namespace abc
@@ -0,0 +1,530 @@
+/*
+=============================================================================
+	File:	HashMap.h
+	Desc:	Open-addressing hash map (Robin Hood hashing).
+=============================================================================
+*/
+
+#ifndef __MX_HASH_MAP_H__
+#define __MX_HASH_MAP_H__
+
+namespace abc {
+
+//
+//	THashTraits< KEY > - computes hashes of keys and compares keys.
+//
+//	A map can be searched with any type of key for which the traits provide
+//	GetHash() and Equals() overloads (e.g. a map with String keys can be searched with C strings),
+//	the hash must be the same for equal keys of different types.
+//
+template< typename KEY >
+struct THashTraits
+{
+	static FORCEINLINE UINT32 GetHash( const KEY& key ) {
+		return mxHashUInt32( (UINT32) key );
+	}
+	static FORCEINLINE bool Equals( const KEY& a, const KEY& b ) {
+		return ( a == b );
+	}
+};
+
+template< typename T >
+struct THashTraits< T* >
+{
+	static FORCEINLINE UINT32 GetHash( const T* key ) {
+		return mxHashPointer( key );
+	}
+	static FORCEINLINE bool Equals( const T* a, const T* b ) {
+		return ( a == b );
+	}
+};
+
+template<>
+struct THashTraits< UINT64 >
+{
+	static FORCEINLINE UINT32 GetHash( UINT64 key ) {
+		return mxHashUInt64( key );
+	}
+	static FORCEINLINE bool Equals( UINT64 a, UINT64 b ) {
+		return ( a == b );
+	}
+};
+
+template<>
+struct THashTraits< String >
+{
+	static FORCEINLINE UINT32 GetHash( const String& key ) {
+		return mxHashString( key.c_str() );
+	}
+	static FORCEINLINE UINT32 GetHash( const char* key ) {
+		return mxHashString( key );
+	}
+	static FORCEINLINE bool Equals( const String& a, const String& b ) {
+		return ( a == b );
+	}
+	static FORCEINLINE bool Equals( const String& a, const char* b ) {
+		return ( a == b );
+	}
+};
+
+/*
+=========================================================
+
+	THashMap< KEY, VALUE >
+
+	Maps unique keys to values.
+
+	Keys and values are stored in a dense array in insertion order
+	(removing an entry moves the last entry into its place).
+	The hash table only stores 32-bit hashes and indices of entries,
+	so probing touches a single small array and entries never move during insertion.
+	Collisions are resolved with Robin Hood linear probing
+	(an entry far from its home slot takes the place of an entry closer to its home),
+	which keeps probe sequences short even at high load factors.
+
+	The table grows automatically when it becomes 7/8 full.
+
+	Pointers to values become invalid when entries are added or removed.
+=========================================================
+*/
+template< typename KEY, typename VALUE, class TRAITS = THashTraits< KEY > >
+class THashMap {
+public:
+	struct Entry
+	{
+		KEY		key;
+		VALUE	value;
+		UINT32	hash;
+	};
+
+public:
+					THashMap( mxUInt initialCapacity = 0 );
+					~THashMap();
+
+					// Returns null if the map has no entry with the given key.
+	template< typename LOOKUP >
+	VALUE *			Find( const LOOKUP& key );
+
+	template< typename LOOKUP >
+	const VALUE *	Find( const LOOKUP& key ) const;
+
+	template< typename LOOKUP >
+	bool			Contains( const LOOKUP& key ) const;
+
+					// Inserts a new entry or overwrites the value of the existing one.
+	template< typename LOOKUP >
+	VALUE &			Set( const LOOKUP& key, const VALUE& value );
+
+					// Adds a ( key, value ) pair. Returns false, if the key already exists.
+	template< typename LOOKUP >
+	bool			Add( const LOOKUP& key, const VALUE& value );
+
+					// Returns false if the map has no entry with the given key.
+	template< typename LOOKUP >
+	bool			Remove( const LOOKUP& key );
+
+					// Removes all entries, doesn't free memory.
+	void			Clear();
+
+					// Removes all entries and frees memory.
+	void			Empty();
+
+					// Deletes the values (assuming that pointers are stored) and removes all entries.
+	void			DeleteContents();
+
+					// Makes room for the given number of entries so that the map doesn't grow while they are added.
+	void			Reserve( mxUInt numEntries );
+
+					// The entries can be iterated over, but the index of an entry changes when another entry is removed.
+	mxUInt			Num() const;
+	const KEY &		GetKeyAt( mxUInt index ) const;
+	VALUE &			GetValueAt( mxUInt index );
+	const VALUE &	GetValueAt( mxUInt index ) const;
+
+					// Returns the number of slots in the hash table.
+	mxUInt			GetCapacity() const;
+
+					// Returns total size of allocated memory.
+	size_t			Allocated() const;
+
+private:
+	struct Slot
+	{
+		UINT32	hash;	// zero marks an empty slot
+		UINT32	entry;	// index into 'entries'
+	};
+
+	enum {
+		MIN_CAPACITY = 16,	// must be a power of two
+	};
+
+	template< typename LOOKUP >
+	static UINT32	HashKey( const LOOKUP& key );
+
+					// Returns INDEX_NONE if the key is not found.
+	template< typename LOOKUP >
+	INT				FindSlot( const LOOKUP& key, UINT32 hash ) const;
+
+					// Places the entry index into the table, the key must not be in the table.
+	void			InsertSlot( UINT32 hash, UINT32 entryIndex );
+
+	void			Rehash( mxUInt newCapacity );
+	void			GrowIfNeeded( mxUInt numEntries );
+
+	mxUInt			ProbeDistance( mxUInt slotIndex, UINT32 hash ) const;
+
+private:
+	TArray< Slot >		slots;
+	TArray< Entry >		entries;
+	mxUInt				mask;		// number of slots - 1
+};
+
+/*
+================
+THashMap::THashMap
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE THashMap< KEY, VALUE, TRAITS >::THashMap( mxUInt initialCapacity )
+	: mask( 0 )
+{
+	if ( initialCapacity ) {
+		Reserve( initialCapacity );
+	}
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE THashMap< KEY, VALUE, TRAITS >::~THashMap()
+{}
+
+/*
+================
+THashMap::HashKey
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+FORCEINLINE UINT32 THashMap< KEY, VALUE, TRAITS >::HashKey( const LOOKUP& key )
+{
+	const UINT32 hash = TRAITS::GetHash( key );
+	return hash ? hash : 1;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE mxUInt THashMap< KEY, VALUE, TRAITS >::ProbeDistance( mxUInt slotIndex, UINT32 hash ) const
+{
+	return ( slotIndex - ( hash & mask ) ) & mask;
+}
+
+/*
+================
+THashMap::FindSlot
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+INLINE INT THashMap< KEY, VALUE, TRAITS >::FindSlot( const LOOKUP& key, UINT32 hash ) const
+{
+	if ( !entries.Num() ) {
+		return INDEX_NONE;
+	}
+
+	const Slot * table = slots.Ptr();
+	mxUInt pos = hash & mask;
+
+	for ( mxUInt dist = 0; ; dist++ )
+	{
+		const Slot & slot = table[ pos ];
+
+		// The key would have displaced an entry which is closer to its home slot.
+		if ( !slot.hash || dist > ProbeDistance( pos, slot.hash ) ) {
+			return INDEX_NONE;
+		}
+		if ( slot.hash == hash && TRAITS::Equals( entries[ slot.entry ].key, key ) ) {
+			return (INT) pos;
+		}
+		pos = ( pos + 1 ) & mask;
+	}
+}
+
+/*
+================
+THashMap::InsertSlot
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::InsertSlot( UINT32 hash, UINT32 entryIndex )
+{
+	Slot * table = slots.Ptr();
+
+	Slot current;
+	current.hash = hash;
+	current.entry = entryIndex;
+
+	mxUInt pos = hash & mask;
+	mxUInt dist = 0;
+
+	for ( ;; )
+	{
+		Slot & slot = table[ pos ];
+		if ( !slot.hash ) {
+			slot = current;
+			return;
+		}
+
+		// Take the place of an entry which is closer to its home slot.
+		const mxUInt existingDist = ProbeDistance( pos, slot.hash );
+		if ( existingDist < dist ) {
+			const Slot temp = slot;
+			slot = current;
+			current = temp;
+			dist = existingDist;
+		}
+
+		pos = ( pos + 1 ) & mask;
+		dist++;
+	}
+}
+
+/*
+================
+THashMap::Rehash
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::Rehash( mxUInt newCapacity )
+{
+	Assert( mxMath::IsPowerOfTwo( newCapacity ) );
+
+	slots.SetNum( newCapacity );
+	MemZero( slots.Ptr(), newCapacity * sizeof(Slot) );
+	mask = newCapacity - 1;
+
+	for ( mxUInt i = 0; i < entries.Num(); i++ ) {
+		InsertSlot( entries[ i ].hash, i );
+	}
+}
+
+/*
+================
+THashMap::GrowIfNeeded
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE void THashMap< KEY, VALUE, TRAITS >::GrowIfNeeded( mxUInt numEntries )
+{
+	// keep the load factor below 7/8
+	if ( numEntries * 8 > slots.Num() * 7 )
+	{
+		mxUInt newCapacity = Max< mxUInt >( slots.Num(), MIN_CAPACITY );
+		while ( numEntries * 8 > newCapacity * 7 ) {
+			newCapacity *= 2;
+		}
+		Rehash( newCapacity );
+	}
+
+	// grow the entries geometrically
+	if ( numEntries > entries.NumAllocated() ) {
+		entries.Resize( Max< mxUInt >( numEntries, entries.NumAllocated() * 2 ) );
+	}
+}
+
+/*
+================
+THashMap::Find
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+FORCEINLINE VALUE * THashMap< KEY, VALUE, TRAITS >::Find( const LOOKUP& key )
+{
+	const INT slotIndex = FindSlot( key, HashKey( key ) );
+	return ( slotIndex != INDEX_NONE ) ? &entries[ slots[ slotIndex ].entry ].value : NULL;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+FORCEINLINE const VALUE * THashMap< KEY, VALUE, TRAITS >::Find( const LOOKUP& key ) const
+{
+	const INT slotIndex = FindSlot( key, HashKey( key ) );
+	return ( slotIndex != INDEX_NONE ) ? &entries[ slots[ slotIndex ].entry ].value : NULL;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+FORCEINLINE bool THashMap< KEY, VALUE, TRAITS >::Contains( const LOOKUP& key ) const
+{
+	return ( FindSlot( key, HashKey( key ) ) != INDEX_NONE );
+}
+
+/*
+================
+THashMap::Set
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+INLINE VALUE & THashMap< KEY, VALUE, TRAITS >::Set( const LOOKUP& key, const VALUE& value )
+{
+	const UINT32 hash = HashKey( key );
+
+	const INT slotIndex = FindSlot( key, hash );
+	if ( slotIndex != INDEX_NONE ) {
+		VALUE & existingValue = entries[ slots[ slotIndex ].entry ].value;
+		existingValue = value;
+		return existingValue;
+	}
+
+	GrowIfNeeded( entries.Num() + 1 );
+
+	const mxUInt entryIndex = entries.Num();
+	Entry & newEntry = entries.Alloc();
+	newEntry.key = key;
+	newEntry.value = value;
+	newEntry.hash = hash;
+
+	InsertSlot( hash, entryIndex );
+
+	return newEntry.value;
+}
+
+/*
+================
+THashMap::Add
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+INLINE bool THashMap< KEY, VALUE, TRAITS >::Add( const LOOKUP& key, const VALUE& value )
+{
+	if ( Contains( key ) ) {
+		return false;
+	}
+	Set( key, value );
+	return true;
+}
+
+/*
+================
+THashMap::Remove
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+template< typename LOOKUP >
+INLINE bool THashMap< KEY, VALUE, TRAITS >::Remove( const LOOKUP& key )
+{
+	INT slotIndex = FindSlot( key, HashKey( key ) );
+	if ( slotIndex == INDEX_NONE ) {
+		return false;
+	}
+
+	Slot * table = slots.Ptr();
+	const UINT32 entryIndex = table[ slotIndex ].entry;
+
+	// Shift the following entries back until an empty slot or an entry in its home slot is found.
+	mxUInt pos = slotIndex;
+	for ( ;; )
+	{
+		const mxUInt next = ( pos + 1 ) & mask;
+		if ( !table[ next ].hash || !ProbeDistance( next, table[ next ].hash ) ) {
+			table[ pos ].hash = 0;
+			break;
+		}
+		table[ pos ] = table[ next ];
+		pos = next;
+	}
+
+	// Move the last entry into the hole.
+	const UINT32 lastIndex = entries.Num() - 1;
+	if ( entryIndex != lastIndex )
+	{
+		const UINT32 lastHash = entries[ lastIndex ].hash;
+
+		pos = lastHash & mask;
+		while ( table[ pos ].entry != lastIndex || table[ pos ].hash != lastHash ) {
+			pos = ( pos + 1 ) & mask;
+		}
+		table[ pos ].entry = entryIndex;
+
+		entries[ entryIndex ] = entries[ lastIndex ];
+	}
+	entries.SetNum( lastIndex, false );
+
+	return true;
+}
+
+/*
+================
+THashMap::Clear
+================
+*/
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::Clear()
+{
+	if ( slots.Num() ) {
+		MemZero( slots.Ptr(), slots.Num() * sizeof(Slot) );
+	}
+	entries.SetNum( 0, false );
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::Empty()
+{
+	slots.Clear();
+	entries.Clear();
+	mask = 0;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::DeleteContents()
+{
+	for ( mxUInt i = 0; i < entries.Num(); i++ ) {
+		delete entries[ i ].value;
+		entries[ i ].value = NULL;
+	}
+	Clear();
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE void THashMap< KEY, VALUE, TRAITS >::Reserve( mxUInt numEntries )
+{
+	GrowIfNeeded( numEntries );
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE mxUInt THashMap< KEY, VALUE, TRAITS >::Num() const {
+	return entries.Num();
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE const KEY & THashMap< KEY, VALUE, TRAITS >::GetKeyAt( mxUInt index ) const {
+	return entries[ index ].key;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE VALUE & THashMap< KEY, VALUE, TRAITS >::GetValueAt( mxUInt index ) {
+	return entries[ index ].value;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE const VALUE & THashMap< KEY, VALUE, TRAITS >::GetValueAt( mxUInt index ) const {
+	return entries[ index ].value;
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+FORCEINLINE mxUInt THashMap< KEY, VALUE, TRAITS >::GetCapacity() const {
+	return slots.Num();
+}
+
+template< typename KEY, typename VALUE, class TRAITS >
+INLINE size_t THashMap< KEY, VALUE, TRAITS >::Allocated() const {
+	return slots.Allocated() + entries.Allocated();
+}
+
+}//end namespace abc
+
+#endif // ! __MX_HASH_MAP_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -14,7 +14,7 @@ namespace abc {
 #ifdef MX_DEBUG
 
 // debug utils
-INT	ReferenceCounted::_totalNumReferences = 0;
+sys::AtomicInt	ReferenceCounted::_totalNumReferences = 0;
 
 #endif
 
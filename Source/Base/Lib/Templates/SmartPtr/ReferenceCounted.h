@@ -21,6 +21,9 @@ namespace abc {
 //
 //	ReferenceCounted
 //
+//	Grab() and Drop() are atomic, so references can be added and released
+//	from different threads (e.g. by the background loader).
+//
 class ReferenceCounted {
 public:
 	void	Grab() const;
@@ -33,12 +36,12 @@ protected:
 	virtual	~ReferenceCounted();
 
 private:
-	volatile mutable INT	referenceCounter;	// Number of references to this object.
+	mutable sys::AtomicInt	referenceCounter;	// Number of references to this object.
 
 #ifdef MX_DEBUG
 private:
 	// this value should be 0 at the application exit point
-	static INT	_totalNumReferences;
+	static sys::AtomicInt	_totalNumReferences;
 public:
 	static INT	GetTotalReferenceCount() { return _totalNumReferences; }
 #endif // MX_DEBUG
@@ -80,23 +83,24 @@ FORCEINLINE ReferenceCounted::~ReferenceCounted()
 }
 
 FORCEINLINE void ReferenceCounted::Grab() const {
-	++referenceCounter;
+	sys::AtomicIncrement( &referenceCounter );
 
 #ifdef MX_DEBUG
-	++_totalNumReferences;
+	sys::AtomicIncrement( &_totalNumReferences );
 #endif // MX_DEBUG
 }
 
 FORCEINLINE bool ReferenceCounted::Drop() const
 {	Assert( referenceCounter != 0 );
-	--referenceCounter;
 
 #ifdef MX_DEBUG
-	--_totalNumReferences;
-	Assert( _totalNumReferences >= 0 );
+	const INT totalNumReferences = sys::AtomicDecrement( &_totalNumReferences );
+	Assert( totalNumReferences >= 0 );
+	(void) totalNumReferences;
 #endif // MX_DEBUG
 
-	if ( referenceCounter == 0 ) {
+	// only the thread which releases the last reference sees zero
+	if ( sys::AtomicDecrement( &referenceCounter ) == 0 ) {
 		delete this;
 		return true;
 	}
@@ -43,6 +43,24 @@ template< typename T >
 void UnusedParameter( const T& param )
 { (void)param; }
 
+//
+//	TTypeTraits< T > - compile-time properties of types, used by containers.
+//
+//	Relies on compiler intrinsics (supported by MSVC 2005+ and GCC 4.3+).
+//
+template< typename T >
+struct TTypeTraits
+{
+	enum
+	{
+		// the default constructor does nothing (e.g. built-in types, pointers and plain structs)
+		HasTrivialConstructor = __has_trivial_constructor( T ),
+
+		// can be copied and relocated with MemCopy() and doesn't need to be destroyed
+		IsPlainOldData = __has_trivial_copy( T ) && __has_trivial_destructor( T ),
+	};
+};
+
 //=============================================================================
 
 //
@@ -0,0 +1,251 @@
+/*
+=============================================================================
+	File:	Compression.cpp
+	Desc:	Fast lossless compression (LZ4 block format).
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+enum
+{
+	MIN_MATCH			= 4,
+	HASH_BITS			= 12,
+	HASH_TABLE_SIZE		= 1 << HASH_BITS,
+	MAX_OFFSET			= 65535,
+
+	// the format requires the last bytes of the input to be stored as literals
+	LAST_LITERALS		= 5,
+	MIN_LENGTH_FOR_MATCH	= 12,
+};
+
+FORCEINLINE UINT32 Read32( const BYTE* p )
+{
+	UINT32 value;
+	MemCopy( &value, p, sizeof(value) );
+	return value;
+}
+
+FORCEINLINE UINT32 HashSequence( UINT32 sequence )
+{
+	return ( sequence * 2654435761U ) >> ( 32 - HASH_BITS );
+}
+
+// Writes the extra bytes of a literal or match length.
+FORCEINLINE BYTE* WriteLength( BYTE* op, mxUInt length )
+{
+	while ( length >= 255 ) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (BYTE) length;
+	return op;
+}
+
+}//End of anonymous namespace
+
+mxUInt mxCompressBound( mxUInt srcSize )
+{
+	return srcSize + srcSize / 255 + 16;
+}
+
+UINT64 mxDecompressBound( mxUInt srcSize )
+{
+	// a match takes at least three bytes (the token and the offset) and yields at most 19 bytes,
+	// each extra length byte adds at most 255 bytes
+	return (UINT64)srcSize * 255;
+}
+
+mxUInt mxCompressLZ( const void* src, mxUInt srcSize, void* dest, mxUInt destCapacity )
+{
+	const BYTE * const input = static_cast< const BYTE* >( src );
+	const BYTE * const inputEnd = input + srcSize;
+
+	BYTE * const output = static_cast< BYTE* >( dest );
+	BYTE * const outputEnd = output + destCapacity;
+
+	BYTE * op = output;
+	const BYTE * ip = input;
+	const BYTE * anchor = input;	// start of pending literals
+
+	if ( srcSize >= MIN_LENGTH_FOR_MATCH )
+	{
+		// positions of recently seen 4-byte sequences
+		UINT32  hashTable[ HASH_TABLE_SIZE ];
+		MemZero( hashTable, sizeof(hashTable) );
+
+		const BYTE * const matchLimit = inputEnd - LAST_LITERALS;
+		const BYTE * const lastMatchStart = inputEnd - MIN_LENGTH_FOR_MATCH;
+
+		ip++;
+		while ( ip <= lastMatchStart )
+		{
+			const UINT32 sequence = Read32( ip );
+			const UINT32 hash = HashSequence( sequence );
+			const BYTE * match = input + hashTable[ hash ];
+			hashTable[ hash ] = (UINT32)( ip - input );
+
+			if ( match >= ip || ip - match > MAX_OFFSET || Read32( match ) != sequence ) {
+				ip++;
+				continue;
+			}
+
+			// extend the match backwards over pending literals
+			while ( ip > anchor && match > input && ip[-1] == match[-1] ) {
+				ip--;
+				match--;
+			}
+
+			// extend the match forwards
+			const BYTE * matchEnd = ip + MIN_MATCH;
+			const BYTE * ref = match + MIN_MATCH;
+			while ( matchEnd < matchLimit && *matchEnd == *ref ) {
+				matchEnd++;
+				ref++;
+			}
+
+			const mxUInt literalLength = (mxUInt)( ip - anchor );
+			const mxUInt matchLength = (mxUInt)( matchEnd - ip ) - MIN_MATCH;
+
+			// token, literals, extra length bytes and the offset
+			if ( op + 1 + literalLength + literalLength / 255 + 1 + 2 + matchLength / 255 + 1 > outputEnd ) {
+				return 0;
+			}
+
+			BYTE * token = op++;
+			*token = (BYTE)( ( literalLength < 15 ? literalLength : 15 ) << 4 );
+			if ( literalLength >= 15 ) {
+				op = WriteLength( op, literalLength - 15 );
+			}
+			MemCopy( op, anchor, literalLength );
+			op += literalLength;
+
+			const mxUInt offset = (mxUInt)( ip - match );
+			*op++ = (BYTE)( offset & 0xFF );
+			*op++ = (BYTE)( offset >> 8 );
+
+			*token |= (BYTE)( matchLength < 15 ? matchLength : 15 );
+			if ( matchLength >= 15 ) {
+				op = WriteLength( op, matchLength - 15 );
+			}
+
+			// index a position inside the match to find overlapping repetitions
+			if ( matchEnd - 2 > input ) {
+				hashTable[ HashSequence( Read32( matchEnd - 2 ) ) ] = (UINT32)( matchEnd - 2 - input );
+			}
+
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	// the last sequence contains only literals
+	const mxUInt lastLiterals = (mxUInt)( inputEnd - anchor );
+	if ( op + 1 + lastLiterals + lastLiterals / 255 + 1 > outputEnd ) {
+		return 0;
+	}
+
+	*op++ = (BYTE)( ( lastLiterals < 15 ? lastLiterals : 15 ) << 4 );
+	if ( lastLiterals >= 15 ) {
+		op = WriteLength( op, lastLiterals - 15 );
+	}
+	if ( lastLiterals > 0 ) {
+		MemCopy( op, anchor, lastLiterals );
+		op += lastLiterals;
+	}
+
+	return (mxUInt)( op - output );
+}
+
+bool mxDecompressLZ( const void* src, mxUInt srcSize, void* dest, mxUInt destSize )
+{
+	const BYTE * ip = static_cast< const BYTE* >( src );
+	const BYTE * const inputEnd = ip + srcSize;
+
+	BYTE * const output = static_cast< BYTE* >( dest );
+	BYTE * op = output;
+	BYTE * const outputEnd = output + destSize;
+
+	while ( ip < inputEnd )
+	{
+		const mxUInt token = *ip++;
+
+		// copy literals
+		mxUInt literalLength = token >> 4;
+		if ( literalLength == 15 )
+		{
+			mxUInt extra;
+			do {
+				if ( ip >= inputEnd ) {
+					return false;
+				}
+				extra = *ip++;
+				literalLength += extra;
+			} while ( extra == 255 );
+		}
+
+		if ( literalLength > (mxUInt)( inputEnd - ip ) || literalLength > (mxUInt)( outputEnd - op ) ) {
+			return false;
+		}
+		if ( literalLength > 0 ) {
+			MemCopy( op, ip, literalLength );
+		}
+		ip += literalLength;
+		op += literalLength;
+
+		// the last sequence has no match
+		if ( ip == inputEnd ) {
+			break;
+		}
+
+		// copy the match
+		if ( inputEnd - ip < 2 ) {
+			return false;
+		}
+		const mxUInt offset = ip[0] | ( ip[1] << 8 );
+		ip += 2;
+
+		if ( offset == 0 || offset > (mxUInt)( op - output ) ) {
+			return false;
+		}
+
+		mxUInt matchLength = ( token & 15 );
+		if ( matchLength == 15 )
+		{
+			mxUInt extra;
+			do {
+				if ( ip >= inputEnd ) {
+					return false;
+				}
+				extra = *ip++;
+				matchLength += extra;
+			} while ( extra == 255 );
+		}
+		matchLength += MIN_MATCH;
+
+		if ( matchLength > (mxUInt)( outputEnd - op ) ) {
+			return false;
+		}
+
+		// the source may overlap the destination (repeated patterns), so copy byte by byte
+		const BYTE * match = op - offset;
+		for ( mxUInt i = 0; i < matchLength; i++ ) {
+			op[i] = match[i];
+		}
+		op += matchLength;
+	}
+
+	return ( op == outputEnd );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
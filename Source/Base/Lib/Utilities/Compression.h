@@ -0,0 +1,40 @@
+/*
+=============================================================================
+	File:	Compression.h
+	Desc:	Fast lossless compression (LZ4 block format).
+=============================================================================
+*/
+
+#ifndef __MX_COMPRESSION_H__
+#define __MX_COMPRESSION_H__
+
+namespace abc {
+
+//
+//	The compressed data is a sequence of LZ4 blocks: literals and back-references
+//	into the already decompressed data. Decompression doesn't need any memory
+//	besides the output buffer and runs at memory bandwidth speed,
+//	so it's well suited for data which is packed once and loaded many times.
+//
+
+// Returns the maximum size of the compressed data (for incompressible input).
+mxUInt	mxCompressBound( mxUInt srcSize );
+
+// Returns the maximum size of the data which can be decompressed from 'srcSize' bytes
+// (a length byte extends a match by at most 255 bytes).
+UINT64	mxDecompressBound( mxUInt srcSize );
+
+// Compresses the data and returns the size of the compressed data,
+// returns 0 if the compressed data doesn't fit into the destination buffer.
+mxUInt	mxCompressLZ( const void* src, mxUInt srcSize, void* dest, mxUInt destCapacity );
+
+// Decompresses exactly 'destSize' bytes, returns false if the compressed data is corrupted.
+bool	mxDecompressLZ( const void* src, mxUInt srcSize, void* dest, mxUInt destSize );
+
+}//End of namespace abc
+
+#endif // ! __MX_COMPRESSION_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,96 @@
+/*
+=============================================================================
+	File:	Sort.cpp
+	Desc:	Templated sorting algorithms.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+enum
+{
+	// smaller arrays are not worth the overhead of scheduling tasks
+	MIN_ELEMENTS_PER_SORT_CHUNK	= 16 * 1024,
+	MAX_SORT_CHUNKS				= 32,
+};
+
+//
+//	SortJobTask
+//
+class SortJobTask : public mxTask {
+public:
+	SortJobTask()
+		: func( null ), context( null ), jobIndex( 0 )
+	{}
+
+	void Execute()
+	{
+		(*this->func)( this->context, this->jobIndex );
+	}
+
+public:
+	mxSortJobFunc *	func;
+	void *			context;
+	mxUInt			jobIndex;
+};
+
+}//End of anonymous namespace
+
+mxUInt mxGetNumSortChunks( mxUInt num )
+{
+	const mxTaskPool &  taskPool = GetGlobalTaskPool();
+	if( ! taskPool.IsInitialized() ) {
+		return 1;
+	}
+
+	const mxUInt  maxChunks = Min< mxUInt >( ( taskPool.GetNumWorkerThreads() + 1 ) * 2, MAX_SORT_CHUNKS );
+
+	mxUInt  numChunks = 1;
+	while( numChunks * 2 <= maxChunks && num / ( numChunks * 2 ) >= MIN_ELEMENTS_PER_SORT_CHUNK ) {
+		numChunks *= 2;
+	}
+	return numChunks;
+}
+
+void mxRunSortJobs( mxSortJobFunc* func, void* context, mxUInt numJobs )
+{
+	AssertPtr( func );
+	Assert( numJobs <= MAX_SORT_CHUNKS );
+
+	if( numJobs == 0 ) {
+		return;
+	}
+
+	SortJobTask  tasks[ MAX_SORT_CHUNKS ];
+
+	// The first job is executed on this thread.
+	mxTaskPool &  taskPool = GetGlobalTaskPool();
+	mxTaskCounter  counter;
+
+	for( mxUInt iJob = 0; iJob < numJobs; iJob++ )
+	{
+		tasks[ iJob ].func = func;
+		tasks[ iJob ].context = context;
+		tasks[ iJob ].jobIndex = iJob;
+
+		if( iJob > 0 ) {
+			taskPool.Submit( &tasks[ iJob ], &counter );
+		}
+	}
+
+	tasks[ 0 ].Execute();
+
+	taskPool.Wait( counter );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
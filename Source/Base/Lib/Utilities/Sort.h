@@ -0,0 +1,547 @@
+/*
+=============================================================================
+	File:	Sort.h
+	Desc:	Templated sorting algorithms.
+=============================================================================
+*/
+
+#ifndef __MX_SORT_H__
+#define __MX_SORT_H__
+
+namespace abc {
+
+//
+//	Comparators are function objects with 'bool operator () ( const T& a, const T& b ) const'
+//	which return true if 'a' must go before 'b'. They are passed by reference and can be inlined
+//	(unlike comparison functions passed to ::qsort()).
+//
+
+//
+//	TLess< T > - sorts in increasing order using operator <.
+//
+template< typename T >
+struct TLess
+{
+	FORCEINLINE bool operator () ( const T& a, const T& b ) const {
+		return ( a < b );
+	}
+};
+
+//
+//	TGreater< T > - sorts in decreasing order using operator >.
+//
+template< typename T >
+struct TGreater
+{
+	FORCEINLINE bool operator () ( const T& a, const T& b ) const {
+		return ( a > b );
+	}
+};
+
+//
+//	TCompareFuncLess< T > - wraps a qsort-style comparison function (returns negative if a < b).
+//
+template< typename T >
+struct TCompareFuncLess
+{
+	typedef INT CompareFunc( const T* a, const T* b );
+
+	CompareFunc *	compare;
+
+	TCompareFuncLess( CompareFunc* compareFunc )
+		: compare( compareFunc )
+	{}
+	FORCEINLINE bool operator () ( const T& a, const T& b ) const {
+		return ( (*compare)( &a, &b ) < 0 );
+	}
+};
+
+/*
+=====================================================================
+
+	Comparison sorts.
+
+=====================================================================
+*/
+
+namespace SortInternal {
+
+enum
+{
+	// partitions smaller than this are left for the final insertion sort
+	INTRO_SORT_THRESHOLD = 16,
+
+	// runs of this length are sorted with insertion sort before merging
+	MERGE_SORT_RUN_LENGTH = 32,
+};
+
+template< typename T, class LESS >
+FORCEINLINE void InsertionSort( T* first, T* last, const LESS& less )
+{
+	for( T* i = first + 1; i < last; i++ )
+	{
+		if( less( *i, *first ) )
+		{
+			// the new smallest element, shift the whole range
+			const T  value( *i );
+			for( T* j = i; j > first; j-- ) {
+				*j = *(j - 1);
+			}
+			*first = value;
+		}
+		else
+		{
+			// there is a smaller element at 'first', so no bounds check is needed
+			const T  value( *i );
+			T* j = i;
+			while( less( value, *(j - 1) ) ) {
+				*j = *(j - 1);
+				j--;
+			}
+			*j = value;
+		}
+	}
+}
+
+template< typename T, class LESS >
+FORCEINLINE void SiftDown( T* heap, mxUInt root, mxUInt num, const LESS& less )
+{
+	const T  value( heap[ root ] );
+	for(;;)
+	{
+		mxUInt  child = root * 2 + 1;
+		if( child >= num ) {
+			break;
+		}
+		if( child + 1 < num && less( heap[ child ], heap[ child + 1 ] ) ) {
+			child++;
+		}
+		if( !less( value, heap[ child ] ) ) {
+			break;
+		}
+		heap[ root ] = heap[ child ];
+		root = child;
+	}
+	heap[ root ] = value;
+}
+
+template< typename T, class LESS >
+void HeapSort( T* first, T* last, const LESS& less )
+{
+	const mxUInt  num = (mxUInt)( last - first );
+	for( mxUInt i = num / 2; i > 0; i-- ) {
+		SiftDown( first, i - 1, num, less );
+	}
+	for( mxUInt i = num - 1; i > 0; i-- ) {
+		Swap( first[ 0 ], first[ i ] );
+		SiftDown( first, 0, i, less );
+	}
+}
+
+// Orders *a, *b, *c and returns b (the median).
+template< typename T, class LESS >
+FORCEINLINE T* MedianOfThree( T* a, T* b, T* c, const LESS& less )
+{
+	if( less( *b, *a ) ) {
+		Swap( *a, *b );
+	}
+	if( less( *c, *b ) ) {
+		Swap( *b, *c );
+		if( less( *b, *a ) ) {
+			Swap( *a, *b );
+		}
+	}
+	return b;
+}
+
+template< typename T, class LESS >
+void IntroSortLoop( T* first, T* last, mxUInt depthLimit, const LESS& less )
+{
+	while( last - first > INTRO_SORT_THRESHOLD )
+	{
+		if( depthLimit == 0 )
+		{
+			// too many bad partitions, switch to guaranteed O(n*log(n))
+			HeapSort( first, last, less );
+			return;
+		}
+		depthLimit--;
+
+		// the median of three elements is used as a pivot, the first and the last elements act as sentinels
+		T* middle = first + ( last - first ) / 2;
+		MedianOfThree( first, middle, last - 1, less );
+		const T  pivot( *middle );
+
+		T* left = first + 1;
+		T* right = last - 2;
+		for(;;)
+		{
+			while( less( *left, pivot ) ) {
+				left++;
+			}
+			while( less( pivot, *right ) ) {
+				right--;
+			}
+			if( left >= right ) {
+				break;
+			}
+			Swap( *left, *right );
+			left++;
+			right--;
+		}
+		T* split = left;
+
+		// recurse into the smaller part, loop on the larger one
+		if( split - first < last - split ) {
+			IntroSortLoop( first, split, depthLimit, less );
+			first = split;
+		} else {
+			IntroSortLoop( split, last, depthLimit, less );
+			last = split;
+		}
+	}
+}
+
+// Merges two sorted ranges into 'dest', elements from the first range go first if they are equal.
+template< typename T, class LESS >
+FORCEINLINE void Merge( const T* a, const T* aEnd, const T* b, const T* bEnd, T* dest, const LESS& less )
+{
+	while( a < aEnd && b < bEnd )
+	{
+		if( less( *b, *a ) ) {
+			*dest++ = *b++;
+		} else {
+			*dest++ = *a++;
+		}
+	}
+	while( a < aEnd ) {
+		*dest++ = *a++;
+	}
+	while( b < bEnd ) {
+		*dest++ = *b++;
+	}
+}
+
+}//End of namespace SortInternal
+
+//
+//	mxInsertionSort - stable, O(n^2), fast for small or nearly sorted arrays.
+//
+template< typename T, class LESS >
+FORCEINLINE void mxInsertionSort( T* data, mxUInt num, const LESS& less )
+{
+	if( num > 1 ) {
+		SortInternal::InsertionSort( data, data + num, less );
+	}
+}
+
+//
+//	mxIntroSort - quick sort which falls back to heap sort on bad inputs, O(n*log(n)) worst case.
+//	Not stable.
+//
+template< typename T, class LESS >
+void mxIntroSort( T* data, mxUInt num, const LESS& less )
+{
+	if( num < 2 ) {
+		return;
+	}
+
+	mxUInt  depthLimit = 0;
+	for( mxUInt i = num; i > 1; i >>= 1 ) {
+		depthLimit += 2;
+	}
+
+	SortInternal::IntroSortLoop( data, data + num, depthLimit, less );
+	SortInternal::InsertionSort( data, data + num, less );
+}
+
+template< typename T >
+FORCEINLINE void mxIntroSort( T* data, mxUInt num )
+{
+	mxIntroSort( data, num, TLess< T >() );
+}
+
+//
+//	mxMergeSort - stable, O(n*log(n)), needs a temporary buffer of the same size.
+//
+template< typename T, class LESS >
+void mxMergeSort( T* data, T* scratch, mxUInt num, const LESS& less )
+{
+	if( num < 2 ) {
+		return;
+	}
+	AssertPtr( scratch );
+
+	// sort short runs in place
+	for( mxUInt start = 0; start < num; start += SortInternal::MERGE_SORT_RUN_LENGTH )
+	{
+		const mxUInt  end = ( num - start > SortInternal::MERGE_SORT_RUN_LENGTH ) ? start + SortInternal::MERGE_SORT_RUN_LENGTH : num;
+		SortInternal::InsertionSort( data + start, data + end, less );
+	}
+
+	// merge runs of doubling length, swapping the buffers after each pass
+	T* src = data;
+	T* dst = scratch;
+
+	for( mxUInt width = SortInternal::MERGE_SORT_RUN_LENGTH; width < num; width *= 2 )
+	{
+		for( mxUInt start = 0; start < num; start += width * 2 )
+		{
+			const mxUInt  middle = ( num - start > width ) ? start + width : num;
+			const mxUInt  end = ( num - middle > width ) ? middle + width : num;
+			SortInternal::Merge( src + start, src + middle, src + middle, src + end, dst + start, less );
+		}
+		Swap( src, dst );
+	}
+
+	if( src != data ) {
+		for( mxUInt i = 0; i < num; i++ ) {
+			data[ i ] = src[ i ];
+		}
+	}
+}
+
+/*
+=====================================================================
+
+	Radix sort.
+
+=====================================================================
+*/
+
+//
+//	TRadixKey< T > - maps keys to unsigned integers with the same order.
+//
+template< typename T >
+struct TRadixKey;
+
+template<>
+struct TRadixKey< UINT32 >
+{
+	typedef UINT32 Type;
+	static FORCEINLINE UINT32 Get( UINT32 key ) { return key; }
+};
+
+template<>
+struct TRadixKey< INT32 >
+{
+	typedef UINT32 Type;
+	static FORCEINLINE UINT32 Get( INT32 key ) { return (UINT32)key ^ 0x80000000UL; }
+};
+
+template<>
+struct TRadixKey< UINT64 >
+{
+	typedef UINT64 Type;
+	static FORCEINLINE UINT64 Get( UINT64 key ) { return key; }
+};
+
+template<>
+struct TRadixKey< INT64 >
+{
+	typedef UINT64 Type;
+	static FORCEINLINE UINT64 Get( INT64 key ) { return (UINT64)key ^ ( (UINT64)1 << 63 ); }
+};
+
+template<>
+struct TRadixKey< FLOAT >
+{
+	typedef UINT32 Type;
+	static FORCEINLINE UINT32 Get( FLOAT key ) {
+		union { FLOAT f; UINT32 u; } bits;
+		bits.f = key;
+		// negative numbers are flipped entirely, positive ones get the sign bit set
+		const UINT32  mask = (UINT32)( -(INT32)( bits.u >> 31 ) ) | 0x80000000UL;
+		return bits.u ^ mask;
+	}
+};
+
+//
+//	mxRadixSortByKey - stable least-significant-digit radix sort, one byte of the key per pass.
+//
+//	'getKey' is a function object which returns an unsigned integer key (UINT32 or UINT64) of an element.
+//	Passes over bytes which are the same in all keys are skipped.
+//	Elements are moved with the assignment operator, so they should be small structs (e.g. key-index pairs).
+//	'scratch' must hold 'num' elements.
+//
+template< typename T, class GET_KEY >
+void mxRadixSortByKey( T* data, T* scratch, mxUInt num, const GET_KEY& getKey )
+{
+	if( num < 2 ) {
+		return;
+	}
+	AssertPtr( scratch );
+
+	enum { NUM_PASSES = sizeof( getKey( *data ) ) };
+
+	// Build histograms for all passes at once.
+	mxUInt  counts[ NUM_PASSES ][ 256 ];
+	MemZero( counts, sizeof(counts) );
+
+	for( mxUInt i = 0; i < num; i++ )
+	{
+		const UINT64  key = getKey( data[ i ] );
+		for( mxUInt iPass = 0; iPass < NUM_PASSES; iPass++ ) {
+			counts[ iPass ][ (key >> (iPass * 8)) & 0xFF ]++;
+		}
+	}
+
+	T* src = data;
+	T* dst = scratch;
+
+	for( mxUInt iPass = 0; iPass < NUM_PASSES; iPass++ )
+	{
+		const mxUInt  shift = iPass * 8;
+		mxUInt * passCounts = counts[ iPass ];
+
+		// Skip the pass if all keys have the same value of this byte.
+		if( passCounts[ ((UINT64)getKey( src[0] ) >> shift) & 0xFF ] == num ) {
+			continue;
+		}
+
+		// Convert counts to offsets.
+		mxUInt  offset = 0;
+		for( mxUInt iBucket = 0; iBucket < 256; iBucket++ )
+		{
+			const mxUInt  count = passCounts[ iBucket ];
+			passCounts[ iBucket ] = offset;
+			offset += count;
+		}
+
+		for( mxUInt i = 0; i < num; i++ )
+		{
+			const mxUInt  bucket = (mxUInt)( ((UINT64)getKey( src[ i ] ) >> shift) & 0xFF );
+			dst[ passCounts[ bucket ]++ ] = src[ i ];
+		}
+
+		Swap( src, dst );
+	}
+
+	if( src != data ) {
+		for( mxUInt i = 0; i < num; i++ ) {
+			data[ i ] = src[ i ];
+		}
+	}
+}
+
+namespace SortInternal {
+
+template< typename T >
+struct RadixKeyOfValue
+{
+	FORCEINLINE typename TRadixKey< T >::Type operator () ( const T& value ) const {
+		return TRadixKey< T >::Get( value );
+	}
+};
+
+}//End of namespace SortInternal
+
+//
+//	mxRadixSort - sorts integers or floats in increasing order (see TRadixKey).
+//
+template< typename T >
+FORCEINLINE void mxRadixSort( T* data, T* scratch, mxUInt num )
+{
+	mxRadixSortByKey( data, scratch, num, SortInternal::RadixKeyOfValue< T >() );
+}
+
+/*
+=====================================================================
+
+	Parallel sort.
+
+=====================================================================
+*/
+
+// Called for each job by mxRunSortJobs().
+typedef void mxSortJobFunc( void* context, mxUInt jobIndex );
+
+// Returns the number of chunks (a power of two) to split the given number of elements into,
+// 1 means that the array is too small or there are no worker threads.
+mxUInt	mxGetNumSortChunks( mxUInt num );
+
+// Executes the jobs on worker threads of the global task pool, returns when all of them have finished.
+void	mxRunSortJobs( mxSortJobFunc* func, void* context, mxUInt numJobs );
+
+namespace SortInternal {
+
+template< typename T, class LESS >
+struct ParallelMergeContext
+{
+	T *				src;
+	T *				dst;
+	mxUInt			num;
+	mxUInt			numChunks;
+	mxUInt			width;		// length of the runs being merged
+	const LESS *	less;
+
+	static void SortChunk( void* context, mxUInt jobIndex )
+	{
+		ParallelMergeContext & c = *static_cast< ParallelMergeContext* >( context );
+		const mxUInt  start = (mxUInt)( (UINT64)c.num * jobIndex / c.numChunks );
+		const mxUInt  end = (mxUInt)( (UINT64)c.num * ( jobIndex + 1 ) / c.numChunks );
+		mxMergeSort( c.src + start, c.dst + start, end - start, *c.less );
+	}
+
+	static void MergeRuns( void* context, mxUInt jobIndex )
+	{
+		ParallelMergeContext & c = *static_cast< ParallelMergeContext* >( context );
+		const mxUInt  firstChunk = jobIndex * c.width * 2;
+		const mxUInt  start = (mxUInt)( (UINT64)c.num * firstChunk / c.numChunks );
+		const mxUInt  middle = (mxUInt)( (UINT64)c.num * ( firstChunk + c.width ) / c.numChunks );
+		const mxUInt  end = (mxUInt)( (UINT64)c.num * ( firstChunk + c.width * 2 ) / c.numChunks );
+		Merge( c.src + start, c.src + middle, c.src + middle, c.src + end, c.dst + start, *c.less );
+	}
+};
+
+}//End of namespace SortInternal
+
+//
+//	mxParallelMergeSort - stable merge sort which uses the global task pool for large arrays.
+//
+//	The array is split into chunks which are sorted concurrently,
+//	then pairs of sorted chunks are merged concurrently until one run is left.
+//	The result is the same as with mxMergeSort(). 'scratch' must hold 'num' elements.
+//
+template< typename T, class LESS >
+void mxParallelMergeSort( T* data, T* scratch, mxUInt num, const LESS& less )
+{
+	const mxUInt  numChunks = mxGetNumSortChunks( num );
+	if( numChunks < 2 ) {
+		mxMergeSort( data, scratch, num, less );
+		return;
+	}
+
+	typedef SortInternal::ParallelMergeContext< T, LESS >	Context;
+
+	Context  context;
+	context.src = data;
+	context.dst = scratch;
+	context.num = num;
+	context.numChunks = numChunks;
+	context.width = 1;
+	context.less = &less;
+
+	mxRunSortJobs( &Context::SortChunk, &context, numChunks );
+
+	for( mxUInt width = 1; width < numChunks; width *= 2 )
+	{
+		context.width = width;
+		mxRunSortJobs( &Context::MergeRuns, &context, numChunks / ( width * 2 ) );
+		Swap( context.src, context.dst );
+	}
+
+	if( context.src != data ) {
+		for( mxUInt i = 0; i < num; i++ ) {
+			data[ i ] = context.src[ i ];
+		}
+	}
+}
+
+}//End of namespace abc
+
+#endif // ! __MX_SORT_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -12,6 +12,7 @@
 //#include <Lib/Utilities/Platform/PlatformUtils.h>
 
 #include <Lib/Utilities/FourCC.h>
+#include <Lib/Utilities/Compression.h>
 
 //============================================================
 
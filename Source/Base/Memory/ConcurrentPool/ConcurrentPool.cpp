@@ -0,0 +1,476 @@
+/*
+=============================================================================
+	File:	ConcurrentPool.cpp
+	Desc:	Thread-safe pooled allocators with per-thread caches.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+// The tagged pointer packs a 32-bit address and a 32-bit counter into a single 64-bit value.
+StaticAssert( sizeof(void*) == sizeof(UINT32) );
+
+namespace {
+
+	FORCEINLINE LONGLONG MakeTaggedPointer( const void* ptr, UINT32 tag )
+	{
+		return (LONGLONG)( ( (ULONGLONG)tag << 32 ) | (UINT32)ptr );
+	}
+
+	FORCEINLINE mxLockFreeStack::Node * GetPointer( LONGLONG taggedPointer )
+	{
+		return (mxLockFreeStack::Node*) (UINT32) taggedPointer;
+	}
+
+	FORCEINLINE UINT32 GetTag( LONGLONG taggedPointer )
+	{
+		return (UINT32)( (ULONGLONG)taggedPointer >> 32 );
+	}
+
+	// Each thread gets its own index into the caches of all concurrent pools.
+	// Indices are released by mxConcurrentPool::ReleaseThreadCaches() and reused by new threads.
+	MX_THREAD_LOCAL mxUInt	tls_threadCacheIndex = 0;	// index + 1, zero if not assigned yet
+	sys::AtomicInt			gUsedThreadCacheIndices = 0;	// bit mask of indices in use
+
+	StaticAssert( mxConcurrentPool::MAX_THREAD_CACHES <= sizeof(sys::AtomicInt) * 8 );
+
+	// Returns MAX_THREAD_CACHES if all indices are in use.
+	mxUInt AcquireThreadCacheIndex()
+	{
+		for(;;)
+		{
+			const LONG  usedMask = gUsedThreadCacheIndices;
+
+			mxUInt  index = 0;
+			while( index < mxConcurrentPool::MAX_THREAD_CACHES && ( usedMask & BIT(index) ) ) {
+				index++;
+			}
+			if( index == mxConcurrentPool::MAX_THREAD_CACHES ) {
+				return index;
+			}
+
+			if( sys::AtomicCompareExchange( &gUsedThreadCacheIndices, usedMask | BIT(index), usedMask ) == usedMask ) {
+				return index;
+			}
+		}
+	}
+
+	void ReleaseThreadCacheIndex( mxUInt index )
+	{
+		for(;;)
+		{
+			const LONG  usedMask = gUsedThreadCacheIndices;
+			Assert( usedMask & BIT(index) );
+
+			if( sys::AtomicCompareExchange( &gUsedThreadCacheIndices, usedMask & ~BIT(index), usedMask ) == usedMask ) {
+				return;
+			}
+		}
+	}
+
+	FORCEINLINE mxUInt GetThreadCacheIndex()
+	{
+		// A thread which didn't get a cache uses the shared lists until it exits.
+		if( tls_threadCacheIndex == 0 ) {
+			tls_threadCacheIndex = AcquireThreadCacheIndex() + 1;
+		}
+		return tls_threadCacheIndex - 1;
+	}
+
+	// The list of live pools is protected by a spin lock
+	// (pools can be constructed during static initialization, before any critical section).
+	mxConcurrentPool *	gPoolList = null;
+	sys::AtomicInt		gPoolListLock = 0;
+
+	class PoolListLock {
+	public:
+		PoolListLock()
+		{
+			while( sys::AtomicCompareExchange( &gPoolListLock, 1, 0 ) != 0 ) {
+				::SwitchToThread();
+			}
+		}
+		~PoolListLock()
+		{
+			sys::AtomicExchange( &gPoolListLock, 0 );
+		}
+	};
+
+}//end of anonymous namespace
+
+/*================================
+		mxLockFreeStack
+================================*/
+
+mxLockFreeStack::mxLockFreeStack()
+	: head( 0 )
+{
+}
+
+void mxLockFreeStack::Push( Node* node )
+{
+	PushList( node, node );
+}
+
+void mxLockFreeStack::PushList( Node* first, Node* last )
+{
+	AssertPtr( first );
+	AssertPtr( last );
+
+	for(;;)
+	{
+		// The two halves may be read non-atomically, but then the exchange below will fail.
+		const LONGLONG  oldHead = this->head;
+		last->next = GetPointer( oldHead );
+
+		const LONGLONG  newHead = MakeTaggedPointer( first, GetTag( oldHead ) + 1 );
+		if( sys::AtomicCompareExchange64( &this->head, newHead, oldHead ) == oldHead ) {
+			return;
+		}
+	}
+}
+
+mxLockFreeStack::Node * mxLockFreeStack::Pop()
+{
+	for(;;)
+	{
+		const LONGLONG  oldHead = this->head;
+		Node * node = GetPointer( oldHead );
+		if( node == null ) {
+			return null;
+		}
+
+		// The node may have been popped by another thread already;
+		// its memory is still readable and the tag check rejects the stale value.
+		const LONGLONG  newHead = MakeTaggedPointer( node->next, GetTag( oldHead ) + 1 );
+		if( sys::AtomicCompareExchange64( &this->head, newHead, oldHead ) == oldHead ) {
+			return node;
+		}
+	}
+}
+
+mxLockFreeStack::Node * mxLockFreeStack::PopAll()
+{
+	for(;;)
+	{
+		const LONGLONG  oldHead = this->head;
+		Node * node = GetPointer( oldHead );
+		if( node == null ) {
+			return null;
+		}
+
+		const LONGLONG  newHead = MakeTaggedPointer( null, GetTag( oldHead ) + 1 );
+		if( sys::AtomicCompareExchange64( &this->head, newHead, oldHead ) == oldHead ) {
+			return node;
+		}
+	}
+}
+
+bool mxLockFreeStack::IsEmpty() const
+{
+	return ( GetPointer( this->head ) == null );
+}
+
+/*================================
+		mxConcurrentPool
+================================*/
+
+namespace {
+
+	FORCEINLINE SizeT CalcItemStride( SizeT itemSize, SizeT itemAlignment )
+	{
+		const SizeT  minSize = ( itemSize > 2 * sizeof(void*) ) ? itemSize : 2 * sizeof(void*);
+		const SizeT  alignment = ( itemAlignment > sizeof(void*) ) ? itemAlignment : sizeof(void*);
+		return ( minSize + alignment - 1 ) & ~( alignment - 1 );
+	}
+
+}//end of anonymous namespace
+
+mxConcurrentPool::mxConcurrentPool( SizeT theItemSize, SizeT theItemAlignment, mxUInt theItemsPerChunk )
+	: threadCaches( null )
+	, chunks( null )
+	, cursor( null )
+	, chunkEnd( null )
+	, numChunks( 0 )
+	, memoryUsed( 0 )
+	, prevPool( null )
+	, nextPool( null )
+	, itemSize( CalcItemStride( theItemSize, theItemAlignment ) )
+	, itemAlignment( ( theItemAlignment > sizeof(void*) ) ? theItemAlignment : sizeof(void*) )
+	, itemsPerChunk( ( theItemsPerChunk > MAGAZINE_SIZE ) ? theItemsPerChunk : MAGAZINE_SIZE )
+{
+	Assert( theItemSize > 0 );
+	Assert( ( theItemAlignment & ( theItemAlignment - 1 ) ) == 0 );
+
+	StaticAssert( sizeof(ThreadCache) == CACHE_LINE_SIZE );
+
+	this->threadCaches = static_cast< ThreadCache* >( ::abc::Allocate( sizeof(ThreadCache) * MAX_THREAD_CACHES ) );
+	MemZero( this->threadCaches, sizeof(ThreadCache) * MAX_THREAD_CACHES );
+
+	PoolListLock  scopedLock;
+	this->nextPool = gPoolList;
+	if( gPoolList != null ) {
+		gPoolList->prevPool = this;
+	}
+	gPoolList = this;
+}
+
+mxConcurrentPool::~mxConcurrentPool()
+{
+	{
+		PoolListLock  scopedLock;
+		if( this->prevPool != null ) {
+			this->prevPool->nextPool = this->nextPool;
+		} else {
+			gPoolList = this->nextPool;
+		}
+		if( this->nextPool != null ) {
+			this->nextPool->prevPool = this->prevPool;
+		}
+	}
+
+	Clear();
+	::abc::Free( this->threadCaches );
+}
+
+//
+//	mxConcurrentPool::Allocate
+//
+void * mxConcurrentPool::Allocate()
+{
+	ThreadCache * cache = GetThreadCache();
+	if( cache == null ) {
+		return AllocateShared();
+	}
+
+	if( cache->items == null ) {
+		Refill( *cache );
+	}
+
+	FreeItem * item = cache->items;
+	cache->items = item->next;
+	cache->numItems--;
+
+	return item;
+}
+
+//
+//	mxConcurrentPool::Free
+//
+void mxConcurrentPool::Free( void* pItem )
+{
+	if( pItem == null ) {
+		return;
+	}
+
+	FreeItem * item = static_cast< FreeItem* >( pItem );
+
+	ThreadCache * cache = GetThreadCache();
+	if( cache == null ) {
+		this->sharedItems.Push( &item->link );
+		return;
+	}
+
+	item->next = cache->items;
+	cache->items = item;
+	cache->numItems++;
+
+	// Keep one magazine for the following allocations, return the other one.
+	if( cache->numItems >= 2 * MAGAZINE_SIZE ) {
+		ReturnMagazine( *cache );
+	}
+}
+
+//
+//	mxConcurrentPool::ReleaseThreadCaches
+//
+void mxConcurrentPool::ReleaseThreadCaches()
+{
+	const mxUInt  index = tls_threadCacheIndex - 1;
+	if( tls_threadCacheIndex == 0 || index >= MAX_THREAD_CACHES ) {
+		tls_threadCacheIndex = 0;
+		return;
+	}
+
+	{
+		PoolListLock  scopedLock;
+		for( mxConcurrentPool * pool = gPoolList; pool != null; pool = pool->nextPool ) {
+			pool->FlushThreadCache( pool->threadCaches[ index ] );
+		}
+	}
+
+	// The slot can be taken by a new thread only after the cache has been emptied.
+	tls_threadCacheIndex = 0;
+	ReleaseThreadCacheIndex( index );
+}
+
+//
+//	mxConcurrentPool::Clear
+//
+void mxConcurrentPool::Clear()
+{
+	Chunk * chunk = this->chunks;
+	while( chunk != null )
+	{
+		Chunk * next = chunk->next;
+		::abc::Free( chunk );
+		chunk = next;
+	}
+	this->chunks = null;
+	this->cursor = null;
+	this->chunkEnd = null;
+	this->numChunks = 0;
+	this->memoryUsed = 0;
+
+	this->depot.PopAll();
+	this->sharedItems.PopAll();
+
+	MemZero( this->threadCaches, sizeof(ThreadCache) * MAX_THREAD_CACHES );
+}
+
+mxConcurrentPool::ThreadCache * mxConcurrentPool::GetThreadCache()
+{
+	const mxUInt  index = GetThreadCacheIndex();
+	return ( index < MAX_THREAD_CACHES ) ? &this->threadCaches[ index ] : null;
+}
+
+void mxConcurrentPool::Refill( ThreadCache & cache )
+{
+	Assert( cache.items == null );
+
+	// Take a full magazine from the depot.
+	FreeItem * magazine = reinterpret_cast< FreeItem* >( this->depot.Pop() );
+	if( magazine != null ) {
+		cache.items = magazine;
+		cache.numItems = MAGAZINE_SIZE;
+		return;
+	}
+
+	// Take single items freed by other threads.
+	FreeItem * items = null;
+	mxUInt  numItems = 0;
+	while( numItems < MAGAZINE_SIZE )
+	{
+		FreeItem * item = reinterpret_cast< FreeItem* >( this->sharedItems.Pop() );
+		if( item == null ) {
+			break;
+		}
+		item->next = items;
+		items = item;
+		numItems++;
+	}
+	if( numItems > 0 ) {
+		cache.items = items;
+		cache.numItems = numItems;
+		return;
+	}
+
+	// Take new items from the memory chunk.
+	cache.items = CarveItems( MAGAZINE_SIZE );
+	cache.numItems = MAGAZINE_SIZE;
+}
+
+void mxConcurrentPool::ReturnMagazine( ThreadCache & cache )
+{
+	Assert( cache.numItems >= MAGAZINE_SIZE );
+
+	FreeItem * magazine = cache.items;
+
+	FreeItem * last = magazine;
+	for( mxUInt i = 1; i < MAGAZINE_SIZE; i++ ) {
+		last = last->next;
+	}
+
+	cache.items = last->next;
+	cache.numItems -= MAGAZINE_SIZE;
+
+	last->next = null;
+	this->depot.Push( &magazine->link );
+}
+
+void mxConcurrentPool::FlushThreadCache( ThreadCache & cache )
+{
+	while( cache.numItems >= MAGAZINE_SIZE ) {
+		ReturnMagazine( cache );
+	}
+
+	FreeItem * item = cache.items;
+	while( item != null )
+	{
+		FreeItem * next = item->next;
+		this->sharedItems.Push( &item->link );
+		item = next;
+	}
+
+	cache.items = null;
+	cache.numItems = 0;
+}
+
+void * mxConcurrentPool::AllocateShared()
+{
+	FreeItem * item = reinterpret_cast< FreeItem* >( this->sharedItems.Pop() );
+	if( item != null ) {
+		return item;
+	}
+
+	// Split a magazine into single items.
+	FreeItem * magazine = reinterpret_cast< FreeItem* >( this->depot.Pop() );
+	if( magazine != null )
+	{
+		FreeItem * rest = magazine->next;
+		while( rest != null )
+		{
+			FreeItem * next = rest->next;
+			this->sharedItems.Push( &rest->link );
+			rest = next;
+		}
+		return magazine;
+	}
+
+	return CarveItems( 1 );
+}
+
+mxConcurrentPool::FreeItem * mxConcurrentPool::CarveItems( mxUInt numItems )
+{
+	sys::ScopedLock  scopedLock( this->chunkLock );
+
+	FreeItem * items = null;
+
+	for( mxUInt i = 0; i < numItems; i++ )
+	{
+		if( this->cursor == this->chunkEnd )
+		{
+			const SizeT  chunkSize = sizeof(Chunk) + this->itemAlignment - 1 + this->itemSize * this->itemsPerChunk;
+
+			Chunk * chunk = static_cast< Chunk* >( ::abc::Allocate( chunkSize ) );
+			AssertPtr( chunk );
+			chunk->next = this->chunks;
+			chunk->size = chunkSize;
+			this->chunks = chunk;
+
+			this->cursor = Align( (BYTE*)( chunk + 1 ), this->itemAlignment );
+			this->chunkEnd = this->cursor + this->itemSize * this->itemsPerChunk;
+
+			this->numChunks++;
+			this->memoryUsed += chunkSize;
+		}
+
+		FreeItem * item = reinterpret_cast< FreeItem* >( this->cursor );
+		this->cursor += this->itemSize;
+
+		item->next = items;
+		items = item;
+	}
+
+	return items;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,219 @@
+/*
+=============================================================================
+	File:	ConcurrentPool.h
+	Desc:	Thread-safe pooled allocators with per-thread caches.
+=============================================================================
+*/
+
+#ifndef __MX_CONCURRENT_POOL_H__
+#define __MX_CONCURRENT_POOL_H__
+
+namespace abc {
+
+//
+//	mxLockFreeStack - an intrusive LIFO list of memory blocks which can be used by many threads at once.
+//
+//	The head pointer is stored together with a counter which is incremented on every change,
+//	so that a compare-and-swap fails if the head has been popped and pushed back
+//	by another thread in the meantime (the ABA problem).
+//
+//	NOTE: popped nodes must stay readable while the stack is in use
+//	(nodes are taken from memory chunks which are only released by their owner).
+//
+class mxLockFreeStack {
+public:
+	struct Node
+	{
+		Node *	next;
+	};
+
+			mxLockFreeStack();
+
+	void	Push( Node* node );
+
+			// Pushes a linked list of nodes ('last->next' is overwritten).
+	void	PushList( Node* first, Node* last );
+
+			// Returns null if the stack is empty.
+	Node *	Pop();
+
+			// Removes all the nodes and returns the old head of the list.
+	Node *	PopAll();
+
+	bool	IsEmpty() const;
+
+private:
+	volatile LONGLONG	head;	// pointer to the first node (low 32 bits) and the change counter (high 32 bits)
+
+private:
+	mxLockFreeStack( const mxLockFreeStack& );
+	mxLockFreeStack & operator = ( const mxLockFreeStack& );
+};
+
+//
+//	mxConcurrentPool - a thread-safe pool of fixed-size memory blocks.
+//
+//	Each thread allocates from and frees to its own cache (a "magazine" of free items),
+//	so most calls don't touch any shared data.
+//	When a thread cache becomes empty, it's refilled with a full magazine from the shared depot;
+//	when it grows too large, a full magazine is returned to the depot.
+//	The depot is a lock-free stack; a lock is only taken when a new memory chunk has to be allocated.
+//
+//	Threads which don't get a cache (at most MAX_THREAD_CACHES threads have caches at once)
+//	use a shared lock-free list of single items.
+//
+//	Threads must call ReleaseThreadCaches() before they exit, so that their cached items
+//	can be used by other threads and their cache slot can be given to a new thread.
+//
+//	NOTE: memory is returned to the system only by Clear() and by the destructor.
+//
+class mxConcurrentPool {
+public:
+	enum {
+		MAGAZINE_SIZE		= 32,	// number of items moved between thread caches and the depot at once
+		MAX_THREAD_CACHES	= 32,	// cache slots are tracked with bits of a 32-bit integer
+	};
+
+			mxConcurrentPool( SizeT theItemSize, SizeT theItemAlignment = 8, mxUInt theItemsPerChunk = 256 );
+			~mxConcurrentPool();
+
+	void *	Allocate();
+	void	Free( void* pItem );
+
+			// Returns the items cached by the calling thread in all pools to the shared lists
+			// and frees the thread's cache slot. Must be called by threads before they exit.
+	static void	ReleaseThreadCaches();
+
+			// Releases all the memory at once, destructors are not called.
+			// NOTE: not thread-safe, the pool must not be used by other threads at the moment.
+	void	Clear();
+
+	SizeT	GetItemSize() const;
+	mxUInt	GetNumChunks() const;
+	SizeT	GetMemoryUsed() const;	// in bytes, including overhead
+
+private:
+	// Free items are linked into lists.
+	struct FreeItem
+	{
+		mxLockFreeStack::Node	link;	// link to the next magazine in the depot (or to the next item in 'sharedItems')
+		FreeItem *				next;	// next item in the same magazine (or in the thread cache)
+	};
+
+	// Cached free items of a single thread, padded to avoid false sharing.
+	struct ThreadCache
+	{
+		FreeItem *	items;
+		mxUInt		numItems;
+		BYTE		pad[ CACHE_LINE_SIZE - sizeof(FreeItem*) - sizeof(mxUInt) ];
+	};
+
+	struct Chunk
+	{
+		Chunk *		next;
+		SizeT		size;
+	};
+
+	ThreadCache *	GetThreadCache();
+	void			Refill( ThreadCache & cache );
+	void			ReturnMagazine( ThreadCache & cache );
+	void			FlushThreadCache( ThreadCache & cache );
+
+	void *			AllocateShared();
+
+					// Takes items from the current memory chunk, allocates a new one if needed.
+	FreeItem *		CarveItems( mxUInt numItems );
+
+private:
+	mxLockFreeStack		depot;			// full magazines
+	mxLockFreeStack		sharedItems;	// single items freed by threads without caches
+
+	ThreadCache *		threadCaches;	// [MAX_THREAD_CACHES]
+
+	Chunk *				chunks;			// linked list of all allocated chunks
+	BYTE *				cursor;			// next unused item in the current chunk
+	BYTE *				chunkEnd;
+	mxUInt				numChunks;
+	SizeT				memoryUsed;
+	sys::CriticalSection	chunkLock;	// protects the chunk list
+
+	// All live pools are linked into a list, so that exiting threads can flush their caches.
+	mxConcurrentPool *	prevPool;
+	mxConcurrentPool *	nextPool;
+
+	const SizeT			itemSize;
+	const SizeT			itemAlignment;
+	const mxUInt		itemsPerChunk;
+
+private:
+	mxConcurrentPool( const mxConcurrentPool& );
+	mxConcurrentPool & operator = ( const mxConcurrentPool& );
+};
+
+FORCEINLINE SizeT mxConcurrentPool::GetItemSize() const {
+	return itemSize;
+}
+
+FORCEINLINE mxUInt mxConcurrentPool::GetNumChunks() const {
+	return numChunks;
+}
+
+FORCEINLINE SizeT mxConcurrentPool::GetMemoryUsed() const {
+	return memoryUsed;
+}
+
+//
+//	TConcurrentPool< T > - a thread-safe pool of objects of the given type.
+//
+template< typename T >
+class TConcurrentPool : public mxConcurrentPool {
+public:
+	TConcurrentPool( mxUInt itemsPerChunk = 256 )
+		: mxConcurrentPool( sizeof(T), ALIGNMENT(T), itemsPerChunk )
+	{}
+
+	T * New()
+	{
+		return new( Allocate() ) T();
+	}
+
+	void Delete( T* pObject )
+	{
+		if( pObject ) {
+			pObject->~T();
+			Free( pObject );
+		}
+	}
+
+	// For compatibility with mxMemoryPool.
+	void * New( const size_t size )
+	{
+		Assert( sizeof(T) == size );
+		(void) size;
+		return Allocate();
+	}
+};
+
+}//End of namespace abc
+
+//---------------------------------------------------------------------------------------
+
+// operators 'new' and 'delete'
+
+template< class T >
+void * operator new( size_t size, ::abc::TConcurrentPool<T> & rMemPool )
+{
+	return rMemPool.New( size );
+}
+
+template< class T >
+void operator delete( void* p, ::abc::TConcurrentPool<T> & rMemPool )
+{
+	rMemPool.Free( p );
+}
+
+#endif // ! __MX_CONCURRENT_POOL_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
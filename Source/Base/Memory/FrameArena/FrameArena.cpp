@@ -0,0 +1,214 @@
+/*
+=============================================================================
+	File:	FrameArena.cpp
+	Desc:	Double-buffered linear allocator for per-frame scratch data.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+namespace {
+
+	// Precedes each allocated block.
+	struct AllocHeader
+	{
+		UINT32	size;	// requested size of the block, in bytes
+		UINT32	pad;
+	};
+
+}//end of anonymous namespace
+
+/*================================
+		mxFrameArena
+================================*/
+
+mxFrameArena::mxFrameArena()
+	: current( 0 )
+	, frameNumber( 0 )
+	, highWaterMark( 0 )
+	, totalNumAllocations( 0 )
+	, totalNumOverflows( 0 )
+{
+	MemZero( buffers, sizeof(buffers) );
+}
+
+mxFrameArena::~mxFrameArena()
+{
+	Shutdown();
+}
+
+//
+//	mxFrameArena::Initialize
+//
+void mxFrameArena::Initialize( SizeT bufferSize )
+{
+	Assert( !IsInitialized() );
+	Assert( bufferSize > 0 );
+
+	for( mxUInt iBuffer = 0; iBuffer < ARRAY_SIZE(buffers); iBuffer++ )
+	{
+		Buffer & buffer = this->buffers[ iBuffer ];
+		Recycle( buffer );
+		buffer.memory = static_cast< BYTE* >( ::abc::Allocate( bufferSize ) );
+		buffer.capacity = bufferSize;
+	}
+}
+
+//
+//	mxFrameArena::Shutdown
+//
+void mxFrameArena::Shutdown()
+{
+	for( mxUInt iBuffer = 0; iBuffer < ARRAY_SIZE(buffers); iBuffer++ )
+	{
+		Buffer & buffer = this->buffers[ iBuffer ];
+		Recycle( buffer );
+		::abc::Free( buffer.memory );
+		buffer.memory = null;
+		buffer.capacity = 0;
+	}
+}
+
+//
+//	mxFrameArena::BeginFrame
+//
+void mxFrameArena::BeginFrame()
+{
+	// The buffer used in the previous frame is complete, update statistics.
+	{
+		const Buffer & finished = this->buffers[ this->current ];
+		const SizeT bytesUsed = Min< SizeT >( finished.used, finished.capacity ) + finished.overflowBytes;
+		this->highWaterMark = Max( this->highWaterMark, bytesUsed );
+		this->totalNumAllocations += finished.numAllocations;
+	}
+
+	this->current ^= 1;
+	this->frameNumber++;
+
+	Recycle( this->buffers[ this->current ] );
+}
+
+//
+//	mxFrameArena::Allocate
+//
+void * mxFrameArena::Allocate( size_t numBytes, SizeT alignment )
+{
+	Assert( alignment > 0 && (alignment & (alignment - 1)) == 0 );
+
+	Buffer & buffer = this->buffers[ this->current ];
+
+	sys::AtomicIncrement( &buffer.numAllocations );
+
+	const SizeT  reservedSize = numBytes + sizeof(AllocHeader) + alignment - 1;
+	const SizeT  offset = sys::AtomicAdd( &buffer.used, (LONG)reservedSize );
+
+	if( offset + reservedSize > buffer.capacity ) {
+		return AllocateOverflow( buffer, numBytes, alignment );
+	}
+
+	BYTE * pMemory = Align( buffer.memory + offset + sizeof(AllocHeader), alignment );
+	( (AllocHeader*) pMemory - 1 )->size = (UINT32) numBytes;
+
+	return pMemory;
+}
+
+void * mxFrameArena::AllocateOverflow( Buffer & buffer, size_t numBytes, SizeT alignment )
+{
+	const SizeT  blockSize = sizeof(OverflowBlock) + sizeof(AllocHeader) + alignment - 1 + numBytes;
+
+	OverflowBlock * block = static_cast< OverflowBlock* >( ::abc::Allocate( blockSize ) );
+	AssertPtr( block );
+	block->size = blockSize;
+
+	{
+		sys::ScopedLock  scopedLock( this->overflowLock );
+		block->next = buffer.overflowBlocks;
+		buffer.overflowBlocks = block;
+		this->totalNumOverflows++;
+	}
+	sys::AtomicAdd( &buffer.overflowBytes, (LONG)numBytes );
+
+	BYTE * pMemory = Align( (BYTE*)( block + 1 ) + sizeof(AllocHeader), alignment );
+	( (AllocHeader*) pMemory - 1 )->size = (UINT32) numBytes;
+
+	return pMemory;
+}
+
+void mxFrameArena::Recycle( Buffer & buffer )
+{
+	OverflowBlock * block = buffer.overflowBlocks;
+	while( block != null )
+	{
+		OverflowBlock * next = block->next;
+		::abc::Free( block );
+		block = next;
+	}
+	buffer.overflowBlocks = null;
+
+	buffer.used = 0;
+	buffer.overflowBytes = 0;
+	buffer.numAllocations = 0;
+}
+
+void * mxFrameArena::Allocate( size_t numBytes )
+{
+	return Allocate( numBytes, DEFAULT_MEMORY_ALIGNMENT );
+}
+
+void * mxFrameArena::Reallocate( void* oldMemory, size_t numBytes )
+{
+	void * newMemory = Allocate( numBytes );
+	if( oldMemory != null ) {
+		MemCopy( newMemory, oldMemory, Min< SizeT >( SizeOf( oldMemory ), numBytes ) );
+	}
+	return newMemory;
+}
+
+void mxFrameArena::Free( void* pMemory )
+{
+	(void) pMemory;
+}
+
+SizeT mxFrameArena::SizeOf( void* ptr ) const
+{
+	AssertPtr( ptr );
+	return ( (const AllocHeader*) ptr - 1 )->size;
+}
+
+void mxFrameArena::GetStats( mxMemoryStats &OutStats )
+{
+	const Buffer & buffer = this->buffers[ this->current ];
+
+	OutStats.Reset();
+	OutStats.totalBytesUsed			= Min< SizeT >( buffer.used, buffer.capacity ) + buffer.overflowBytes;
+	OutStats.peakBytesUsed			= Max( this->highWaterMark, OutStats.totalBytesUsed );
+	OutStats.numAllocations			= buffer.numAllocations;
+	OutStats.totalNumAllocations	= this->totalNumAllocations + buffer.numAllocations;
+}
+
+void mxFrameArena::DumpStats() const
+{
+	mxMemoryStats  stats;
+	const_cast< mxFrameArena* >( this )->GetStats( stats );
+
+	sys::Print( TEXT("Frame arena: %u KiB per buffer, high-water mark: %u bytes, %u allocations, %u overflows\n"),
+		this->buffers[0].capacity / 1024, stats.peakBytesUsed, stats.totalNumAllocations, this->totalNumOverflows );
+}
+
+//---------------------------------------------------------------------------
+
+mxFrameArena & GetFrameArena()
+{
+	static mxFrameArena  theFrameArena;
+	return theFrameArena;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,116 @@
+/*
+=============================================================================
+	File:	FrameArena.h
+	Desc:	Double-buffered linear allocator for per-frame scratch data.
+=============================================================================
+*/
+
+#ifndef __MX_FRAME_ARENA_H__
+#define __MX_FRAME_ARENA_H__
+
+namespace abc {
+
+//
+//	mxFrameArena - a linear allocator for temporary data which lives no longer than two frames.
+//
+//	Allocation is a pointer increment (thread-safe), memory is never freed individually.
+//	There are two buffers which are switched at the start of each frame,
+//	so memory allocated during a frame stays valid until the end of the next frame.
+//
+//	If the current buffer is full (or the arena has not been initialized),
+//	memory is taken from the general heap and released when the buffer is recycled.
+//	The high-water mark (which includes such overflows) tells how large the buffers should be.
+//
+class mxFrameArena : public IMemoryAllocator {
+public:
+	enum { DEFAULT_BUFFER_SIZE = 1024 * 1024 };
+
+				mxFrameArena();
+				~mxFrameArena();
+
+	void		Initialize( SizeT bufferSize = DEFAULT_BUFFER_SIZE );
+	void		Shutdown();
+
+	bool		IsInitialized() const;
+
+				// Recycles the buffer used in the frame before the previous one.
+				// Must be called once per frame (the engine calls it at the start of each frame).
+	void		BeginFrame();
+
+	void *		Allocate( size_t numBytes, SizeT alignment );
+
+	mxUInt		GetFrameNumber() const;
+
+				// Returns the largest number of bytes allocated during a single frame.
+	SizeT		GetHighWaterMark() const;
+
+	//
+	//	Override ( IMemoryAllocator ) :
+	//
+	void *		Allocate( size_t numBytes );
+	void *		Reallocate( void* oldMemory, size_t numBytes );
+	void		Free( void* pMemory );	// does nothing
+	SizeT		SizeOf( void* ptr ) const;
+	void		GetStats( mxMemoryStats &OutStats );
+	void		DumpStats() const;
+
+private:
+	struct OverflowBlock
+	{
+		OverflowBlock *	next;
+		SizeT			size;
+	};
+
+	struct Buffer
+	{
+		BYTE *			memory;
+		SizeT			capacity;
+		sys::AtomicInt	used;			// offset of unused memory, can exceed 'capacity' after overflows
+		sys::AtomicInt	overflowBytes;	// number of bytes allocated from the heap
+		sys::AtomicInt	numAllocations;
+		OverflowBlock *	overflowBlocks;	// blocks allocated from the heap
+	};
+
+	void *	AllocateOverflow( Buffer & buffer, size_t numBytes, SizeT alignment );
+	void	Recycle( Buffer & buffer );
+
+private:
+	Buffer			buffers[2];
+	mxUInt			current;		// index of the buffer used in this frame
+	mxUInt			frameNumber;
+
+	SizeT			highWaterMark;
+	SizeT			totalNumAllocations;
+	SizeT			totalNumOverflows;
+
+	sys::CriticalSection	overflowLock;	// protects lists of overflow blocks
+
+private:
+	mxFrameArena( const mxFrameArena& );
+	mxFrameArena & operator = ( const mxFrameArena& );
+};
+
+FORCEINLINE bool mxFrameArena::IsInitialized() const {
+	return ( buffers[0].memory != null );
+}
+
+FORCEINLINE mxUInt mxFrameArena::GetFrameNumber() const {
+	return frameNumber;
+}
+
+FORCEINLINE SizeT mxFrameArena::GetHighWaterMark() const {
+	return highWaterMark;
+}
+
+//
+// Returns the global frame arena (it's initialized and shut down by the engine).
+//
+mxFrameArena &	GetFrameArena();
+
+}//End of namespace abc
+
+#endif // ! __MX_FRAME_ARENA_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
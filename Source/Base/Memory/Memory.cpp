@@ -1,8 +1,7 @@
 /*
 =============================================================================
 	File:	Memory.cpp
-	Desc:
-	Note:	Undone.
+	Desc:	Memory management: size-class heap with per-memory-class accounting.
 =============================================================================
 */
 
@@ -14,105 +13,459 @@ namespace abc {
 
 MX_FIXME( "memory allocation functions may return NULL sometimes" )
 
-#if 0
+namespace {
 
-//
-//	Global variables.
-//
-namespace _hidden {
+	//
+	//	BlockHeader - precedes each allocated block.
+	//
+	//	NOTE: the size of the header must be a multiple of DEFAULT_MEMORY_ALIGNMENT
+	//	to keep the returned memory aligned.
+	//
+	struct BlockHeader
+	{
+		UINT32	size;		// requested size of the block, in bytes
+		BYTE	memClass;	// EMemoryClass
+		BYTE	sizeClass;	// index of the size class or LARGE_BLOCK
+		UINT16	magic;		// for catching invalid pointers and double frees
+	};
 
-	static mxMemoryHeap< EAllocationSize::Alloc_Medium, 16 >	heaps[ NUM_MEMORY_CLASSES ];
+	enum
+	{
+		LARGE_BLOCK		= 0xFF,
 
-}//end of namespace _hidden
+		MAGIC_ALLOCATED	= 0xA110,
+		MAGIC_FREED		= 0xDEAD,
 
-void *	Allocate( size_t numBytes, EMemoryClass memClass )
-{
-	void * pMem = _hidden::heaps[ memClass ].Allocate( numBytes );
-	Assert( pMem );
-	return pMem;
-}
+		SLAB_SIZE		= 64 * 1024,	// size of memory chunks from which small blocks are carved
 
-void	Free( void* pMemory, EMemoryClass memClass )
-{
-	return _hidden::heaps[ memClass ].Free( pMemory );
-}
+		MAX_SMALL_SIZE	= 2048,			// blocks larger than this (including the header) go to the OS
+	};
 
-void *	Allocate( size_t numBytes, const char* file, int line, EMemoryClass memClass )
-{
-	void * pMem = _hidden::heaps[ memClass ].Allocate( numBytes, file, line );
-	Assert( pMem );
-	return pMem;
-}
+	// Slot sizes (including the header) of all size classes.
+	static const UINT32 gSlotSizes[] =
+	{
+		// Tiny
+		16, 24, 32, 48, 64,
+		// Small
+		96, 128, 192, 256,
+		// Medium
+		384, 512, 768, 1024, 1536, 2048
+	};
 
-void	Free( void* pMemory, const char* file, int line, EMemoryClass memClass )
-{
-	return _hidden::heaps[ memClass ].Free( pMemory, file, line );
-}
+	enum { NUM_SIZE_CLASSES = ARRAY_SIZE( gSlotSizes ) };
+
+	FORCEINLINE EAllocationSize GetAllocationSize( UINT32 slotSize )
+	{
+		return ( slotSize <= 64 ) ? Alloc_Tiny : ( slotSize <= 256 ) ? Alloc_Small : Alloc_Medium;
+	}
+
+	//
+	//	SizeClass - allocates blocks of the same size from slabs.
+	//	Slabs are never returned to the OS, freed blocks are reused.
+	//
+	struct SizeClass
+	{
+		struct FreeSlot {
+			FreeSlot *	next;
+		};
+
+		sys::CriticalSection	lock;
+
+		FreeSlot *	freeList;	// recently freed slots
+		BYTE *		cursor;		// unused memory in the current slab
+		BYTE *		end;
+		UINT32		slotSize;
+		mxUInt		numSlabs;
+
+	public:
+		void * Allocate()
+		{
+			sys::ScopedLock  scopedLock( lock );
+
+			if( freeList != null )
+			{
+				FreeSlot * slot = freeList;
+				freeList = slot->next;
+				return slot;
+			}
+
+			if( cursor + slotSize > end )
+			{
+				BYTE * newSlab = (BYTE*) ::VirtualAlloc( NULL, SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+				if( newSlab == NULL ) {
+					return null;
+				}
+				cursor = newSlab;
+				end = newSlab + SLAB_SIZE;
+				numSlabs++;
+			}
+
+			void * slot = cursor;
+			cursor += slotSize;
+			return slot;
+		}
+
+		void Free( void* pMemory )
+		{
+			sys::ScopedLock  scopedLock( lock );
+
+			FreeSlot * slot = static_cast< FreeSlot* >( pMemory );
+			slot->next = freeList;
+			freeList = slot;
+		}
+	};
+
+	//
+	//	MemoryClassStats - memory usage counters of a single memory class.
+	//
+	struct MemoryClassStats
+	{
+		sys::AtomicInt	bytesUsed;
+		sys::AtomicInt	peakBytesUsed;
+		sys::AtomicInt	numAllocations;
+		sys::AtomicInt	totalNumAllocations;
+		sys::AtomicInt	numAllocationsBySize[ NUM_ALLOCATION_SIZES ];
+
+	public:
+		void OnAllocate( UINT32 numBytes, EAllocationSize allocSize )
+		{
+			const LONG newBytesUsed = sys::AtomicAdd( &bytesUsed, numBytes ) + numBytes;
+
+			// Update the peak value (it can be changed by other threads meanwhile).
+			LONG oldPeak = peakBytesUsed;
+			while( newBytesUsed > oldPeak )
+			{
+				const LONG prevPeak = sys::AtomicCompareExchange( &peakBytesUsed, newBytesUsed, oldPeak );
+				if( prevPeak == oldPeak ) {
+					break;
+				}
+				oldPeak = prevPeak;
+			}
+
+			sys::AtomicIncrement( &numAllocations );
+			sys::AtomicIncrement( &totalNumAllocations );
+			sys::AtomicIncrement( &numAllocationsBySize[ allocSize ] );
+		}
+
+		void OnFree( UINT32 numBytes )
+		{
+			sys::AtomicAdd( &bytesUsed, -(LONG)numBytes );
+			sys::AtomicDecrement( &numAllocations );
+		}
+	};
+
+	//
+	//	mxHeapAllocator - provides access to the memory of the given class.
+	//
+	class mxHeapAllocator : public IMemoryAllocator {
+	public:
+		mxHeapAllocator()
+			: memClass( MX_MEMORY_CLASS_GENERIC )
+		{}
+
+		void SetMemoryClass( EMemoryClass newMemClass )
+		{
+			memClass = newMemClass;
+		}
+
+		//
+		//	Override ( IMemoryAllocator ) :
+		//
+		void * Allocate( size_t numBytes )
+		{
+			return ::abc::Allocate( numBytes, memClass );
+		}
+
+		void * Reallocate( void* oldMemory, size_t numBytes )
+		{
+			if( oldMemory == null ) {
+				return Allocate( numBytes );
+			}
+			void * newMemory = Allocate( numBytes );
+			if( newMemory != null ) {
+				MemCopy( newMemory, oldMemory, Min< SizeT >( SizeOf( oldMemory ), numBytes ) );
+			}
+			Free( oldMemory );
+			return newMemory;
+		}
+
+		void Free( void* pMemory )
+		{
+			::abc::Free( pMemory, memClass );
+		}
+
+		SizeT SizeOf( void* ptr ) const
+		{
+			AssertPtr( ptr );
+			const BlockHeader * header = static_cast< const BlockHeader* >( ptr ) - 1;
+			Assert( header->magic == MAGIC_ALLOCATED );
+			return header->size;
+		}
+
+		void GetStats( mxMemoryStats &OutStats );
+
+		void DumpStats() const;
+
+	private:
+		EMemoryClass	memClass;
+	};
+
+	//
+	//	mxHeap - the global heap.
+	//
+	struct mxHeap
+	{
+		SizeClass			sizeClasses[ NUM_SIZE_CLASSES ];
+		BYTE				sizeClassBySize[ (MAX_SMALL_SIZE >> 3) + 1 ];	// size class for each size in 8-byte units
+
+		MemoryClassStats	stats[ NUM_MEMORY_CLASSES ];
+		mxHeapAllocator		allocators[ NUM_MEMORY_CLASSES ];
+
+	public:
+		mxHeap()
+		{
+			StaticAssert( sizeof(BlockHeader) % DEFAULT_MEMORY_ALIGNMENT == 0 );
+
+			BYTE  iSizeClass = 0;
+			for( UINT32 iUnit = 0; iUnit < ARRAY_SIZE(sizeClassBySize); iUnit++ )
+			{
+				while( gSlotSizes[ iSizeClass ] < (iUnit << 3) ) {
+					iSizeClass++;
+				}
+				sizeClassBySize[ iUnit ] = iSizeClass;
+			}
+
+			for( UINT iSizeClass = 0; iSizeClass < NUM_SIZE_CLASSES; iSizeClass++ )
+			{
+				SizeClass & sizeClass = sizeClasses[ iSizeClass ];
+				sizeClass.freeList = null;
+				sizeClass.cursor = null;
+				sizeClass.end = null;
+				sizeClass.slotSize = gSlotSizes[ iSizeClass ];
+				sizeClass.numSlabs = 0;
+			}
+
+			MemZero( stats, sizeof(stats) );
+
+			for( UINT iMemClass = 0; iMemClass < NUM_MEMORY_CLASSES; iMemClass++ )
+			{
+				allocators[ iMemClass ].SetMemoryClass( (EMemoryClass) iMemClass );
+			}
+		}
+	};
+
+	//
+	// Returns the global heap.
+	// The heap is constructed on first use (memory can be allocated during static initialization)
+	// and it's never destroyed (memory can be freed by destructors of static objects).
+	// The first use can happen on several threads at once (e.g. in static constructors of a DLL
+	// loaded by a worker thread), so the construction is guarded with an interlocked flag.
+	//
+	enum EHeapState
+	{
+		HEAP_NOT_CREATED,
+		HEAP_BEING_CREATED,
+		HEAP_READY
+	};
+
+	// These variables are initialized statically, before any code runs.
+	sys::AtomicInt	gHeapState = HEAP_NOT_CREATED;
+	mxHeap *		gHeap = null;
 
-#elif 1
+	union HeapStorage
+	{
+		BYTE	storage[ sizeof(mxHeap) ];
+		double	alignment;
+	};
+	HeapStorage		gHeapStorage;
+
+	mxHeap & CreateHeap()
+	{
+		if( sys::AtomicCompareExchange( &gHeapState, HEAP_BEING_CREATED, HEAP_NOT_CREATED ) == HEAP_NOT_CREATED )
+		{
+			gHeap = new( gHeapStorage.storage ) mxHeap();
+			sys::AtomicExchange( &gHeapState, HEAP_READY );	// also a memory barrier
+		}
+		else
+		{
+			// Another thread is constructing the heap.
+			while( gHeapState != HEAP_READY ) {
+				::SwitchToThread();
+			}
+		}
+		return *gHeap;
+	}
+
+	FORCEINLINE mxHeap & GetHeap()
+	{
+		if( gHeapState == HEAP_READY ) {
+			return *gHeap;
+		}
+		return CreateHeap();
+	}
+
+	//
+	//	AllocateBlock
+	//
+	void * AllocateBlock( size_t numBytes, EMemoryClass memClass, const char* file, int line )
+	{
+		Assert( memClass < NUM_MEMORY_CLASSES );
+
+		mxHeap & heap = GetHeap();
+
+		const size_t  blockSize = numBytes + sizeof(BlockHeader);
+
+		BlockHeader *	header;
+		BYTE			sizeClass;
+		EAllocationSize	allocSize;
+
+		if( blockSize <= MAX_SMALL_SIZE )
+		{
+			sizeClass = heap.sizeClassBySize[ (blockSize + 7) >> 3 ];
+			allocSize = GetAllocationSize( gSlotSizes[ sizeClass ] );
+			header = static_cast< BlockHeader* >( heap.sizeClasses[ sizeClass ].Allocate() );
+		}
+		else
+		{
+			sizeClass = LARGE_BLOCK;
+			allocSize = Alloc_Huge;
+		#ifdef MX_DEBUG_MEMORY
+			header = static_cast< BlockHeader* >( ::_malloc_dbg( blockSize, _NORMAL_BLOCK, file, line ) );
+		#else
+			(void) file, (void) line;
+			header = static_cast< BlockHeader* >( ::malloc( blockSize ) );
+		#endif
+		}
+
+		Assert( header );
+		if( header == null ) {
+			return null;
+		}
+
+		header->size = (UINT32) numBytes;
+		header->memClass = (BYTE) memClass;
+		header->sizeClass = sizeClass;
+		header->magic = MAGIC_ALLOCATED;
+
+		heap.stats[ memClass ].OnAllocate( (UINT32) numBytes, allocSize );
+
+		return header + 1;
+	}
+
+	//
+	//	FreeBlock
+	//
+	void FreeBlock( void* pMemory )
+	{
+		if( pMemory == null ) {
+			return;
+		}
+
+		mxHeap & heap = GetHeap();
+
+		BlockHeader * header = static_cast< BlockHeader* >( pMemory ) - 1;
+		Assert2( header->magic == MAGIC_ALLOCATED, "invalid pointer or double free" );
+		header->magic = MAGIC_FREED;
+
+		heap.stats[ header->memClass ].OnFree( header->size );
+
+		if( header->sizeClass != LARGE_BLOCK ) {
+			heap.sizeClasses[ header->sizeClass ].Free( header );
+		} else {
+			::free( header );
+		}
+	}
+
+	void mxHeapAllocator::GetStats( mxMemoryStats &OutStats )
+	{
+		const MemoryClassStats & stats = GetHeap().stats[ memClass ];
 
+		OutStats.totalBytesUsed			= stats.bytesUsed;
+		OutStats.peakBytesUsed			= stats.peakBytesUsed;
+		OutStats.numAllocations			= stats.numAllocations;
+		OutStats.totalNumAllocations	= stats.totalNumAllocations;
+		for( UINT i = 0; i < NUM_ALLOCATION_SIZES; i++ ) {
+			OutStats.numAllocationsBySize[i] = stats.numAllocationsBySize[i];
+		}
+	}
+
+	void mxHeapAllocator::DumpStats() const
+	{
+		mxMemoryStats  stats;
+		const_cast< mxHeapAllocator* >( this )->GetStats( stats );
+
+		sys::Print( TEXT("%s: %u bytes in %u blocks (peak: %u bytes), %u allocations (tiny: %u, small: %u, medium: %u, huge: %u)\n"),
+			Mem_GetMemoryClassName( memClass ),
+			stats.totalBytesUsed, stats.numAllocations, stats.peakBytesUsed, stats.totalNumAllocations,
+			stats.numAllocationsBySize[ Alloc_Tiny ], stats.numAllocationsBySize[ Alloc_Small ],
+			stats.numAllocationsBySize[ Alloc_Medium ], stats.numAllocationsBySize[ Alloc_Huge ] );
+	}
+
+}//end of anonymous namespace
 
 void *	Allocate( size_t numBytes, EMemoryClass memClass )
 {
-	(void) memClass;
-	void * pMem = malloc( numBytes );
-	Assert( pMem );
-	return pMem;
+	return AllocateBlock( numBytes, memClass, null, 0 );
 }
 
 void	Free( void* pMemory, EMemoryClass memClass )
 {
 	(void) memClass;
-	return free( pMemory );
+	FreeBlock( pMemory );
 }
 
 void *	Allocate( size_t numBytes, const char* file, int line, EMemoryClass memClass )
 {
-	(void) memClass;
-	void * pMem = _malloc_dbg( numBytes, _NORMAL_BLOCK, file, line );
-	Assert( pMem );
-	return pMem;
+	return AllocateBlock( numBytes, memClass, file, line );
 }
 
 void	Free( void* pMemory, const char* file, int line, EMemoryClass memClass )
 {
 	(void) memClass, (void) file, (void) line;
-	return _free_dbg( pMemory, _NORMAL_BLOCK );
+	FreeBlock( pMemory );
 }
 
-
-#else
-
-void *	Allocate( size_t numBytes, EMemoryClass memClass )
+IMemoryAllocator *	Mem_GetAllocator( EMemoryClass memClass )
 {
-	(void) memClass;
-	void * pMem = malloc( numBytes );
-	Assert( pMem );
-	return pMem;
+	Assert( memClass < NUM_MEMORY_CLASSES );
+	return &GetHeap().allocators[ memClass ];
 }
 
-void	Free( void* pMemory, EMemoryClass memClass )
+const mxChar * Mem_GetMemoryClassName( EMemoryClass memClass )
 {
-	(void) memClass;
-	return free( pMemory );
+	switch( memClass )
+	{
+	case MX_MEMORY_CLASS_GENERIC :		return TEXT("Generic");
+	case MX_MEMORY_CLASS_GEOMETRY :		return TEXT("Geometry");
+	case MX_MEMORY_CLASS_RENDER :		return TEXT("Render");
+	case MX_MEMORY_CLASS_PHYSICS :		return TEXT("Physics");
+	case MX_MEMORY_CLASS_SOUND :		return TEXT("Sound");
+	case MX_MEMORY_CLASS_SCENE_DATA :	return TEXT("Scene data");
+	case MX_MEMORY_CLASS_MESSAGES :		return TEXT("Messages");
+	case MX_MEMORY_CLASS_STRING :		return TEXT("String");
+	case MX_MEMORY_CLASS_SCRIPT :		return TEXT("Script");
+	default:	Unreachable;
+	}
+	return TEXT("Unknown");
 }
 
-void *	Allocate( size_t numBytes, const char* file, int line, EMemoryClass memClass )
+void Mem_DumpStats()
 {
-	(void) memClass, (void) file, (void) line;
-	void * pMem = malloc( numBytes );
-	Assert( pMem );
-	return pMem;
-}
+	sys::Print( TEXT("=== Memory usage ===\n") );
 
-void	Free( void* pMemory, const char* file, int line, EMemoryClass memClass )
-{
-	(void) memClass, (void) file, (void) line;
-	return free( pMemory );
-}
+	for( UINT iMemClass = 0; iMemClass < NUM_MEMORY_CLASSES; iMemClass++ )
+	{
+		Mem_GetAllocator( (EMemoryClass) iMemClass )->DumpStats();
+	}
 
-#endif
+	mxHeap & heap = GetHeap();
 
+	mxUInt  numSlabs = 0;
+	for( UINT iSizeClass = 0; iSizeClass < NUM_SIZE_CLASSES; iSizeClass++ ) {
+		numSlabs += heap.sizeClasses[ iSizeClass ].numSlabs;
+	}
+	sys::Print( TEXT("Slabs: %u KiB\n"), numSlabs * (SLAB_SIZE / 1024) );
+}
 
 /*
 const mxMemoryStats & mxMemoryManager::GetStats() const
@@ -60,10 +60,12 @@ enum EMemoryClass
 //
 enum EAllocationSize
 {
-	Alloc_Tiny,
-	Alloc_Small,
-	Alloc_Medium,
-	Alloc_Huge
+	Alloc_Tiny,		// up to 64 bytes, served from slabs
+	Alloc_Small,	// up to 256 bytes, served from slabs
+	Alloc_Medium,	// up to 2 KiB, served from slabs
+	Alloc_Huge,		// passed through to the OS
+
+	NUM_ALLOCATION_SIZES
 };
 
 //
@@ -71,9 +73,29 @@ enum EAllocationSize
 //
 class mxMemoryStats {
 public:
-	SizeT	totalBytesUsed;
+	SizeT	totalBytesUsed;			// number of bytes currently allocated (as requested by the user)
+	SizeT	peakBytesUsed;			// the highest value of 'totalBytesUsed'
+	SizeT	numAllocations;			// number of live allocations
+	SizeT	totalNumAllocations;	// number of allocations made since startup
+
+	// number of allocations made since startup, by size
+	SizeT	numAllocationsBySize[ NUM_ALLOCATION_SIZES ];
 
-	// Work in progress...
+public:
+	mxMemoryStats()
+	{
+		Reset();
+	}
+	void Reset()
+	{
+		totalBytesUsed = 0;
+		peakBytesUsed = 0;
+		numAllocations = 0;
+		totalNumAllocations = 0;
+		for( UINT i = 0; i < NUM_ALLOCATION_SIZES; i++ ) {
+			numAllocationsBySize[i] = 0;
+		}
+	}
 };
 
 //
@@ -216,12 +238,16 @@ private:
 	}
 };
 
-MX_OPTIMIZE("Use an optimized memory pool allocator for extremely small-sized allocations.")
-
 //===========================================================================
 //
 //	Memory management functions.
 //
+//	Small blocks (see EAllocationSize) are allocated from segregated size-class slabs,
+//	larger blocks are passed through to the OS.
+//	Each block remembers its memory class and size,
+//	so the memory class passed to Free() is only a hint.
+//	These functions are thread-safe.
+//
 
 void *	Allocate( size_t numBytes, EMemoryClass memClass = MX_MEMORY_CLASS_GENERIC );
 void	Free( void* pMemory, EMemoryClass memClass = MX_MEMORY_CLASS_GENERIC );
@@ -258,6 +284,17 @@ public:
 //
 IMemoryAllocator *	Mem_GetAllocator( EMemoryClass memClass = MX_MEMORY_CLASS_GENERIC );
 
+//
+//	Mem_GetMemoryClassName
+//
+const mxChar *	Mem_GetMemoryClassName( EMemoryClass memClass );
+
+//
+//	Mem_DumpStats
+//	Logs memory usage of all memory classes.
+//
+void	Mem_DumpStats();
+
 /*
 MX_TODO(:)
 
@@ -26,6 +26,7 @@ public:
 	bool	IsA( const mxTypeInfo& type ) const;
 	bool	IsA( const FourCC& typeCode ) const;
 	bool	IsA( const String& typeName ) const;
+	bool	IsA( const mxNameId& typeName ) const;
 
 	bool	IsInstanceOf( const mxTypeInfo& type ) const;
 	bool	IsInstanceOf( const FourCC& typeCode ) const;
@@ -85,6 +86,12 @@ bool mxObject::IsA( const String& typeName ) const
 	return this->GetType()->IsDerivedFrom( typeName );
 }
 
+MX_INLINE
+bool mxObject::IsA( const mxNameId& typeName ) const
+{
+	return this->GetType()->IsDerivedFrom( typeName );
+}
+
 MX_INLINE
 bool mxObject::IsInstanceOf( const mxTypeInfo& type ) const
 {
@@ -85,13 +85,18 @@ void mxObjectFactory::RegisterClass( const mxTypeInfo* typeInfo, const String& c
     }
 
     // register with lookup tables
-    this->typesByName.Set( className, typeInfo );
+    this->typesByName.Set( typeInfo->GetClassNameId(), typeInfo );
 	this->typesByID.Insert( typeCode, typeInfo );
 }
 
 bool mxObjectFactory::ClassExists( const String& className ) const
 {
-	return this->typesByName.Contains( className.c_str() );
+	return this->ClassExists( mxNameId::Find( className.c_str() ) );
+}
+
+bool mxObjectFactory::ClassExists( const mxNameId& className ) const
+{
+	return !className.IsEmpty() && this->typesByName.Contains( className );
 }
 
 bool mxObjectFactory::ClassExists( const FourCC& typeCode ) const
@@ -100,9 +105,14 @@ bool mxObjectFactory::ClassExists( const FourCC& typeCode ) const
 }
 
 const mxTypeInfo * mxObjectFactory::GetTypeInfo( const String& className ) const
+{
+	return this->GetTypeInfo( mxNameId::Find( className.c_str() ) );
+}
+
+const mxTypeInfo * mxObjectFactory::GetTypeInfo( const mxNameId& className ) const
 {
 	Assert( this->ClassExists( className ) );
-    return this->typesByName[ className ];
+    return *this->typesByName.Find( className );
 }
 
 const mxTypeInfo * mxObjectFactory::GetTypeInfo( const FourCC& typeCode ) const
@@ -112,6 +122,17 @@ const mxTypeInfo * mxObjectFactory::GetTypeInfo( const FourCC& typeCode ) const
 }
 
 mxObject * mxObjectFactory::Create( const String& className ) const
+{
+	const mxNameId  nameId = mxNameId::Find( className.c_str() );
+	if ( nameId.IsEmpty() )
+	{
+		sys::Error( "Failed to create class '%s'. Did you forget to register it?", className.ToChar() );
+		return null;
+	}
+	return this->Create( nameId );
+}
+
+mxObject * mxObjectFactory::Create( const mxNameId& className ) const
 {
 	if ( ! this->ClassExists( className ) )
 	{
@@ -119,7 +140,7 @@ mxObject * mxObjectFactory::Create( const String& className ) const
 		return null;
 	}
 
-	const mxTypeInfo* pRtti = this->typesByName[ className.ToChar() ];
+	const mxTypeInfo* pRtti = *this->typesByName.Find( className );
 	AssertPtr( pRtti );
 
 	return pRtti->CreateInstance();
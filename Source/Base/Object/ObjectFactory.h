@@ -17,6 +17,7 @@ namespace abc {
 class mxTypeInfo;
 class String;
 class FourCC;
+class mxNameId;
 
 class mxObject;
 
@@ -38,13 +39,16 @@ public:
 	void	RegisterClass( const mxTypeInfo* typeInfo, const String& className, const FourCC& typeCode );
 
 	bool	ClassExists( const String& className ) const;
+	bool	ClassExists( const mxNameId& className ) const;
 	bool	ClassExists( const FourCC& typeCode ) const;
 
 	const mxTypeInfo *	GetTypeInfo( const String& className ) const;
+	const mxTypeInfo *	GetTypeInfo( const mxNameId& className ) const;
 	const mxTypeInfo *	GetTypeInfo( const FourCC& typeCode ) const;
 
 				// Create an object by its class name.
 	mxObject *	Create( const String& className ) const;
+	mxObject *	Create( const mxNameId& className ) const;
 
 				// Create an object by its type code.
 	mxObject *	Create( const FourCC typeCode ) const;
@@ -54,7 +58,7 @@ private:
 	mxObjectFactory();
 	~mxObjectFactory();
 
-	TStringHash< const mxTypeInfo* >		typesByName;	// for fast lookup by class name
+	THashMap< mxNameId, const mxTypeInfo* >	typesByName;	// for fast lookup by (interned) class name
 	RBTreeMap< FourCC, const mxTypeInfo* >	typesByID;		// for fast lookup by FourCC code
 
 private:
@@ -22,6 +22,7 @@ mxTypeInfo::mxTypeInfo( const char* theClassName, FourCC theTypeCode,
 	
 	: fourCC( theTypeCode )
 	, name( theClassName )
+	, nameId( theClassName )
 	, parent( theParent )
 	, instanceSize( theInstanceSize )
 	, createFunc( theCreateFunction )
@@ -65,10 +66,21 @@ bool mxTypeInfo::IsDerivedFrom( const mxTypeInfo& other ) const
 }
 
 bool  mxTypeInfo::IsDerivedFrom( const String& className ) const
+{
+	// all class names are interned, so an unknown name can't be a name of a parent class
+	const mxNameId  nameId = mxNameId::Find( className.c_str() );
+	if ( nameId.IsEmpty() )
+	{
+		return false;
+	}
+	return this->IsDerivedFrom( nameId );
+}
+
+bool  mxTypeInfo::IsDerivedFrom( const mxNameId& className ) const
 {
 	for ( const mxTypeInfo * current = this; current != 0; current = current->GetParent() )
 	{
-		if ( current->GetClassName() == className )
+		if ( current->GetClassNameId() == className )
 		{
 			return true;
 		}
@@ -92,6 +92,7 @@ public:
 	bool	operator != ( const mxTypeInfo& other ) const;
 
 	const String &	GetClassName() const;
+	const mxNameId&	GetClassNameId() const;
 	FourCC			GetTypeCode() const;
 
 	const mxTypeInfo *	GetParent() const;
@@ -101,6 +102,7 @@ public:
 
 	bool	IsDerivedFrom( const mxTypeInfo& other ) const;
 	bool	IsDerivedFrom( const String& className ) const;
+	bool	IsDerivedFrom( const mxNameId& className ) const;	// compares integers, not strings
 	bool	IsDerivedFrom( const FourCC& typeCode ) const;
 
 public:
@@ -115,6 +117,7 @@ public:
 private:
 	const FourCC	fourCC;		// 32-bit type code
 	const String	name;		// name of the class
+	const mxNameId	nameId;		// interned name of the class
 	const mxTypeInfo *	parent;		// parent class of this class
 	const mxSizeT	instanceSize;	// size of a single instance of the class
 	const CreateFunc createFunc;
@@ -142,6 +145,12 @@ const String & mxTypeInfo::GetClassName() const
 	return this->name;
 }
 
+FORCEINLINE
+const mxNameId & mxTypeInfo::GetClassNameId() const
+{
+	return this->nameId;
+}
+
 FORCEINLINE
 FourCC mxTypeInfo::GetTypeCode() const
 {
@@ -350,6 +350,9 @@ bool PathExists( const mxChar* pathname );
 // Returns true if a file or path with the given name exists.
 bool FileOrPathExists( const mxChar* path );
 
+// Returns the last modification time of the file (returns 0 if the file doesn't exist).
+UINT64 GetFileTimestamp( const mxChar* filename );
+
 bool IsValidFileName( const mxChar* filename );
 bool IsValidPathName( const mxChar* pathname );
 
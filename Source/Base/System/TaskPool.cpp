@@ -0,0 +1,278 @@
+/*
+=============================================================================
+	File:	TaskPool.cpp
+	Desc:	A pool of worker threads for executing independent tasks.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Base.h>
+
+namespace abc {
+
+/*================================
+		mxTaskPool
+================================*/
+
+mxTaskPool::mxTaskPool()
+	: head( 0 )
+	, numPending( 0 )
+	, semaphore( NULL )
+	, taskFinished( NULL )
+	, numWaiters( 0 )
+	, numThreads( 0 )
+	, bQuit( false )
+{
+}
+
+mxTaskPool::~mxTaskPool()
+{
+	Shutdown();
+}
+
+//
+//	mxTaskPool::Initialize
+//
+void mxTaskPool::Initialize( mxUInt numWorkerThreads )
+{
+	Assert( !IsInitialized() );
+
+	if( numWorkerThreads == 0 )
+	{
+		sys::SystemInfo_s  sysInfo;
+		sys::GetSystemInfo( sysInfo );
+		numWorkerThreads = ( sysInfo.NumProcessors > 1 ) ? sysInfo.NumProcessors - 1 : 0;
+	}
+	numWorkerThreads = Min< mxUInt >( numWorkerThreads, MAX_WORKER_THREADS );
+
+	if( numWorkerThreads == 0 ) {
+		return;	// tasks will be executed on the calling thread
+	}
+
+	this->bQuit = false;
+	this->semaphore = ::CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+	Assert( this->semaphore != NULL );
+	this->taskFinished = ::CreateEvent( NULL, FALSE, FALSE, NULL );
+	Assert( this->taskFinished != NULL );
+
+	for( mxUInt iThread = 0; iThread < numWorkerThreads; iThread++ )
+	{
+		const uintptr_t hThread = ::_beginthreadex( NULL, 0, &WorkerThreadFunc, this, 0, NULL );
+		if( !hThread ) {
+			sys::Warning( TEXT("Failed to create a worker thread\n") );
+			break;
+		}
+		this->threads[ this->numThreads++ ] = (HANDLE) hThread;
+	}
+}
+
+//
+//	mxTaskPool::Shutdown
+//
+void mxTaskPool::Shutdown()
+{
+	if( !IsInitialized() ) {
+		return;
+	}
+
+	// Pending tasks are still executed by the worker threads.
+	this->bQuit = true;
+	::ReleaseSemaphore( this->semaphore, this->numThreads, NULL );
+
+	::WaitForMultipleObjects( this->numThreads, this->threads, TRUE, INFINITE );
+
+	for( mxUInt iThread = 0; iThread < this->numThreads; iThread++ ) {
+		::CloseHandle( this->threads[ iThread ] );
+	}
+	this->numThreads = 0;
+
+	::CloseHandle( this->semaphore );
+	this->semaphore = NULL;
+
+	// Execute the remaining tasks (if any) to release waiting threads.
+	while( TryExecuteOne() )
+		;
+
+	::CloseHandle( this->taskFinished );
+	this->taskFinished = NULL;
+}
+
+//
+//	mxTaskPool::Submit
+//
+void mxTaskPool::Submit( mxTask* task, mxTaskCounter* counter )
+{
+	AssertPtr( task );
+
+	if( counter ) {
+		sys::AtomicIncrement( &counter->count );
+	}
+
+	const Entry  newEntry = { task, counter };
+
+	if( IsInitialized() && !this->bQuit )
+	{
+		bool bQueued = false;
+		{
+			sys::ScopedLock  scopedLock( this->lock );
+			if( this->numPending < MAX_PENDING_TASKS )
+			{
+				this->queue[ (this->head + this->numPending) % MAX_PENDING_TASKS ] = newEntry;
+				this->numPending++;
+				bQueued = true;
+			}
+		}
+		if( bQueued ) {
+			::ReleaseSemaphore( this->semaphore, 1, NULL );
+			return;
+		}
+	}
+
+	// Execute the task immediately.
+	ExecuteEntry( newEntry );
+}
+
+//
+//	mxTaskPool::Wait
+//
+void mxTaskPool::Wait( mxTaskCounter & counter )
+{
+	while( !counter.IsDone() )
+	{
+		// Help executing pending tasks instead of blocking.
+		if( TryExecuteOne() ) {
+			continue;
+		}
+
+		if( this->taskFinished == NULL ) {
+			// not initialized, the remaining tasks are being executed by other threads
+			sys::YieldThread();
+			continue;
+		}
+
+		// The remaining tasks are being executed by worker threads, sleep until one of the counters is done.
+		// The event wakes up only one thread, so several waiting threads could miss a signal:
+		// the short timeout makes them check their counters and the queue again.
+		sys::AtomicIncrement( &this->numWaiters );
+		if( !counter.IsDone() ) {
+			::WaitForSingleObject( this->taskFinished, 1 );
+		}
+		sys::AtomicDecrement( &this->numWaiters );
+	}
+}
+
+//
+//	mxTaskPool::TryExecuteOne
+//
+bool mxTaskPool::TryExecuteOne()
+{
+	Entry  entry;
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+		if( this->numPending == 0 ) {
+			return false;
+		}
+		entry = this->queue[ this->head ];
+		this->head = ( this->head + 1 ) % MAX_PENDING_TASKS;
+		this->numPending--;
+	}
+	ExecuteEntry( entry );
+	return true;
+}
+
+void mxTaskPool::ExecuteEntry( const Entry& entry )
+{
+	entry.task->Execute();
+
+	if( entry.counter ) {
+		if( sys::AtomicDecrement( &entry.counter->count ) == 0 && this->numWaiters > 0 ) {
+			::SetEvent( this->taskFinished );
+		}
+	}
+}
+
+//
+//	mxTaskPool::WorkerThreadFunc
+//
+unsigned int __stdcall mxTaskPool::WorkerThreadFunc( void* param )
+{
+	mxTaskPool * pool = static_cast< mxTaskPool* >( param );
+
+	for(;;)
+	{
+		::WaitForSingleObject( pool->semaphore, INFINITE );
+
+		// Tasks can also be taken by waiting threads,
+		// so the semaphore count is only a hint; drain the queue.
+		while( pool->TryExecuteOne() )
+			;
+
+		if( pool->bQuit ) {
+			break;
+		}
+	}
+
+	mxConcurrentPool::ReleaseThreadCaches();
+	return 0;
+}
+
+//---------------------------------------------------------------------------
+
+namespace {
+
+//
+// Function-local statics are not thread-safe in VC++ 2008 and the pool can be first used
+// on several threads at once, so the construction is guarded with an interlocked flag
+// (the same way as the global heap is created).
+//
+enum ETaskPoolState
+{
+	TASK_POOL_NOT_CREATED,
+	TASK_POOL_BEING_CREATED,
+	TASK_POOL_READY
+};
+
+// These variables are initialized statically, before any code runs.
+sys::AtomicInt	gTaskPoolState = TASK_POOL_NOT_CREATED;
+mxTaskPool *	gTaskPool = null;
+
+union TaskPoolStorage
+{
+	BYTE	storage[ sizeof(mxTaskPool) ];
+	double	alignment;
+};
+TaskPoolStorage		gTaskPoolStorage;
+
+mxTaskPool & CreateTaskPool()
+{
+	if( sys::AtomicCompareExchange( &gTaskPoolState, TASK_POOL_BEING_CREATED, TASK_POOL_NOT_CREATED ) == TASK_POOL_NOT_CREATED )
+	{
+		gTaskPool = new( gTaskPoolStorage.storage ) mxTaskPool();
+		sys::AtomicExchange( &gTaskPoolState, TASK_POOL_READY );	// also a memory barrier
+	}
+	else
+	{
+		// Another thread is constructing the pool.
+		while( gTaskPoolState != TASK_POOL_READY ) {
+			::SwitchToThread();
+		}
+	}
+	return *gTaskPool;
+}
+
+}//End of anonymous namespace
+
+mxTaskPool & GetGlobalTaskPool()
+{
+	if( gTaskPoolState == TASK_POOL_READY ) {
+		return *gTaskPool;
+	}
+	return CreateTaskPool();
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,128 @@
+/*
+=============================================================================
+	File:	TaskPool.h
+	Desc:	A pool of worker threads for executing independent tasks.
+=============================================================================
+*/
+
+#ifndef __MX_TASK_POOL_H__
+#define __MX_TASK_POOL_H__
+
+namespace abc {
+
+//
+//	mxTask - a unit of work which can be executed on any thread.
+//
+class mxTask {
+public:
+	virtual void	Execute() = 0;
+
+protected:
+	virtual	~mxTask() {}
+};
+
+//
+//	mxTaskCounter - counts unfinished tasks, used for waiting on a group of tasks.
+//
+class mxTaskCounter {
+public:
+	mxTaskCounter()
+		: count( 0 )
+	{}
+
+	bool IsDone() const
+	{
+		return ( count == 0 );
+	}
+
+private:
+	friend class mxTaskPool;
+	sys::AtomicInt	count;
+};
+
+//
+//	mxTaskPool
+//
+//	A thread that waits for tasks to complete executes pending tasks meanwhile,
+//	so tasks can spawn and wait for other tasks (e.g. in recursive divide-and-conquer algorithms)
+//	without deadlocking the pool.
+//
+//	If the pool has not been initialized (or the queue is full),
+//	submitted tasks are executed immediately on the calling thread.
+//
+class mxTaskPool {
+public:
+	enum {
+		MAX_WORKER_THREADS	= 16,
+		MAX_PENDING_TASKS	= 1024,
+	};
+
+				mxTaskPool();
+				~mxTaskPool();
+
+				// Creates worker threads. Pass zero to create one thread per processor, except the calling one.
+	void		Initialize( mxUInt numWorkerThreads = 0 );
+
+				// Waits for all worker threads to finish.
+	void		Shutdown();
+
+	bool		IsInitialized() const;
+	mxUInt		GetNumWorkerThreads() const;
+
+				// Schedules the task for execution. The counter (if any) is decremented when the task has finished.
+				// NOTE: the task object must stay valid until it has been executed.
+	void		Submit( mxTask* task, mxTaskCounter* counter = null );
+
+				// Blocks until all the tasks associated with the counter have finished.
+				// Pending tasks are executed on the calling thread meanwhile.
+	void		Wait( mxTaskCounter & counter );
+
+private:
+	struct Entry
+	{
+		mxTask *			task;
+		mxTaskCounter *		counter;
+	};
+
+	bool	TryExecuteOne();
+	void	ExecuteEntry( const Entry& entry );
+
+	static unsigned int __stdcall WorkerThreadFunc( void* param );
+
+private:
+	Entry		queue[ MAX_PENDING_TASKS ];	// ring buffer of pending tasks
+	mxUInt		head;			// index of the first pending task
+	mxUInt		numPending;		// number of pending tasks
+
+	sys::CriticalSection	lock;	// protects the queue
+
+	HANDLE		semaphore;		// signalled when a new task has been submitted
+	HANDLE		taskFinished;	// auto-reset event, signalled when a counter reaches zero while someone is waiting
+	sys::AtomicInt	numWaiters;	// number of threads blocked in Wait()
+	HANDLE		threads[ MAX_WORKER_THREADS ];
+	mxUInt		numThreads;
+
+	volatile bool	bQuit;
+};
+
+FORCEINLINE bool mxTaskPool::IsInitialized() const {
+	return ( numThreads > 0 );
+}
+
+FORCEINLINE mxUInt mxTaskPool::GetNumWorkerThreads() const {
+	return numThreads;
+}
+
+//
+// Returns the global task pool (it's initialized and shut down by the engine).
+// The pool object is created on first use and never destroyed.
+//
+mxTaskPool &	GetGlobalTaskPool();
+
+}//End of namespace abc
+
+#endif // ! __MX_TASK_POOL_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -702,6 +702,18 @@ bool FileOrPathExists( const mxChar* path )
 	return ( GetFileAttributes( path ) != INVALID_FILE_ATTRIBUTES );
 }
 
+UINT64 GetFileTimestamp( const mxChar* filename )
+{
+	WIN32_FILE_ATTRIBUTE_DATA  attribs;
+	if ( ! GetFileAttributesEx( filename, GetFileExInfoStandard, &attribs ) ) {
+		return 0;
+	}
+	ULARGE_INTEGER  lastWriteTime;
+	lastWriteTime.LowPart = attribs.ftLastWriteTime.dwLowDateTime;
+	lastWriteTime.HighPart = attribs.ftLastWriteTime.dwHighDateTime;
+	return lastWriteTime.QuadPart;
+}
+
 bool IsValidFileName( const mxChar* filename )
 {
 	// TODO: more checks.
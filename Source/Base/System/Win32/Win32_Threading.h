@@ -54,6 +54,108 @@ namespace sys {
 		virtual void	YieldTime( void ) = 0;	// Yield is already defined.
 	};
 
+	//
+	//	CriticalSection - a lightweight mutex (can only be used within a single process).
+	//
+	class CriticalSection {
+	public:
+		CriticalSection()
+		{
+			::InitializeCriticalSectionAndSpinCount( &cs, 4000 );
+		}
+		~CriticalSection()
+		{
+			::DeleteCriticalSection( &cs );
+		}
+
+		FORCEINLINE void Enter()
+		{
+			::EnterCriticalSection( &cs );
+		}
+		FORCEINLINE bool TryEnter()
+		{
+			return ::TryEnterCriticalSection( &cs ) != FALSE;
+		}
+		FORCEINLINE void Leave()
+		{
+			::LeaveCriticalSection( &cs );
+		}
+
+	private:
+		CRITICAL_SECTION	cs;
+
+	private:
+		CriticalSection( const CriticalSection& );
+		CriticalSection & operator = ( const CriticalSection& );
+	};
+
+	//
+	//	ScopedLock - enters the critical section in the constructor and leaves it in the destructor.
+	//
+	class ScopedLock {
+	public:
+		ScopedLock( CriticalSection & theCS )
+			: cs( theCS )
+		{
+			cs.Enter();
+		}
+		~ScopedLock()
+		{
+			cs.Leave();
+		}
+
+	private:
+		CriticalSection &	cs;
+
+	private:
+		ScopedLock( const ScopedLock& );
+		ScopedLock & operator = ( const ScopedLock& );
+	};
+
+	//
+	//	Atomic operations (they also act as full memory barriers).
+	//
+	typedef volatile LONG	AtomicInt;
+
+	// Returns the incremented value.
+	FORCEINLINE LONG AtomicIncrement( AtomicInt* pValue ) {
+		return ::InterlockedIncrement( pValue );
+	}
+	// Returns the decremented value.
+	FORCEINLINE LONG AtomicDecrement( AtomicInt* pValue ) {
+		return ::InterlockedDecrement( pValue );
+	}
+	// Returns the initial value.
+	FORCEINLINE LONG AtomicAdd( AtomicInt* pValue, LONG amount ) {
+		return ::InterlockedExchangeAdd( pValue, amount );
+	}
+	// Returns the initial value.
+	FORCEINLINE LONG AtomicExchange( AtomicInt* pValue, LONG newValue ) {
+		return ::InterlockedExchange( pValue, newValue );
+	}
+	// Stores 'newValue' only if the current value is equal to 'comparand'. Returns the initial value.
+	FORCEINLINE LONG AtomicCompareExchange( AtomicInt* pValue, LONG newValue, LONG comparand ) {
+		return ::InterlockedCompareExchange( pValue, newValue, comparand );
+	}
+	// Returns the initial value.
+	FORCEINLINE void* AtomicCompareExchangePointer( void* volatile* pDest, void* newValue, void* comparand ) {
+		return ::InterlockedCompareExchangePointer( pDest, newValue, comparand );
+	}
+	// 64-bit version of AtomicCompareExchange(). Returns the initial value.
+	FORCEINLINE LONGLONG AtomicCompareExchange64( volatile LONGLONG* pValue, LONGLONG newValue, LONGLONG comparand ) {
+		return ::_InterlockedCompareExchange64( pValue, newValue, comparand );
+	}
+
+	// Returns a value which identifies the calling thread.
+	FORCEINLINE ThreadID GetCurrentThreadID() {
+		return ::GetCurrentThreadId();
+	}
+
+	// Gives up the remainder of the calling thread's time slice.
+	FORCEINLINE void YieldThread() {
+		::SwitchToThread();
+	}
+
 }//End of namespace sys
 }//End of namespace abc
 
@@ -0,0 +1,243 @@
+/*
+=============================================================================
+	File:	ArrayBenchmarks.cpp
+	Desc:	Appending elements to dynamic arrays.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	MAX_OLD_ELEMENTS	= 100000,	// the old array is quadratic, larger counts are extrapolated
+};
+
+//
+//	OldArray - the growth of TArray before geometric growth: the capacity was increased by 'granularity'
+//	and the elements were copied with operator = into a new array created with new[].
+//
+template< typename TYPE >
+class OldArray {
+public:
+	OldArray()
+		: list( null ), num( 0 ), size( 0 ), granularity( 16 )
+	{}
+
+	~OldArray()
+	{
+		delete[] list;
+	}
+
+	void Append( const TYPE& obj )
+	{
+		if ( ! list ) {
+			Resize( granularity );
+		}
+		if ( num == size ) {
+			const mxUInt  newsize = size + granularity;
+			Resize( newsize - newsize % granularity );
+		}
+		list[ num ] = obj;
+		num++;
+	}
+
+	mxUInt Num() const {
+		return num;
+	}
+
+	const TYPE & operator [] ( mxUInt index ) const {
+		return list[ index ];
+	}
+
+private:
+	void Resize( mxUInt newsize )
+	{
+		TYPE * temp = list;
+		size = newsize;
+
+		list = new TYPE[ size ];
+		for ( mxUInt i = 0; i < num; i++ ) {
+			list[i] = temp[i];
+		}
+		delete[] temp;
+	}
+
+private:
+	TYPE *	list;
+	mxUInt	num;
+	mxUInt	size;
+	mxUInt	granularity;
+};
+
+//
+//	Element types: a vertex and a pointer are copied with MemCopy, a string has a copy constructor.
+//
+struct VertexElements
+{
+	static const char * Name() {
+		return "rxVertex";
+	}
+	static rxVertex Make( UINT i )
+	{
+		rxVertex  vertex;
+		MemZero( &vertex, sizeof(vertex) );
+		vertex[0] = (FLOAT) i;
+		return vertex;
+	}
+	static bool Check( const rxVertex& vertex, UINT i ) {
+		return ( vertex[0] == (FLOAT) i );
+	}
+};
+
+struct PointerElements
+{
+	static const char * Name() {
+		return "pointer";
+	}
+	static const void * Make( UINT i ) {
+		return reinterpret_cast< const void* >( (size_t) i * 4 );
+	}
+	static bool Check( const void* pointer, UINT i ) {
+		return ( pointer == Make( i ) );
+	}
+};
+
+struct StringElements
+{
+	static const char * Name() {
+		return "String";
+	}
+	static String Make( UINT i ) {
+		return String( (int) i );
+	}
+	static bool Check( const String& str, UINT i ) {
+		return ( str == Make( i ) );
+	}
+};
+
+// Returns the number of wrong elements.
+template< class ELEMENTS, class ARRAY, typename TYPE >
+UINT CheckElements( const ARRAY& array, const TArray< TYPE >& elements )
+{
+	UINT  numErrors = ( array.Num() == elements.Num() ) ? 0 : 1;
+	for ( UINT i = 0; i < array.Num(); i++ ) {
+		if ( ! ELEMENTS::Check( array[i], i ) ) {
+			numErrors++;
+		}
+	}
+	return numErrors;
+}
+
+template< class ELEMENTS, typename TYPE >
+bool MeasureAppends( UINT numElements )
+{
+	// the elements are created in advance, only appending is timed
+	TArray< TYPE >  elements;
+	elements.SetNum( numElements );
+	for ( UINT i = 0; i < numElements; i++ ) {
+		elements[i] = ELEMENTS::Make( i );
+	}
+
+	UINT  numErrors = 0;
+
+	mxTimer  timer;
+	FLOAT  newTime;
+	{
+		TArray< TYPE >  array;
+		for ( UINT i = 0; i < numElements; i++ ) {
+			array.Append( elements[i] );
+		}
+		newTime = ElapsedMilliseconds( timer );
+		numErrors += CheckElements< ELEMENTS >( array, elements );
+	}
+
+	timer.Reset();
+	FLOAT  reservedTime;
+	{
+		TArray< TYPE >  array;
+		array.Reserve( numElements );
+		for ( UINT i = 0; i < numElements; i++ ) {
+			array.Append( elements[i] );
+		}
+		reservedTime = ElapsedMilliseconds( timer );
+		numErrors += CheckElements< ELEMENTS >( array, elements );
+	}
+
+	FLOAT  oldTime;
+	char  oldTimeSuffix = ' ';
+	{
+		// quadratic cost: the time for a large count is estimated from MAX_OLD_ELEMENTS
+		const UINT  numOldElements = Min< UINT >( numElements, MAX_OLD_ELEMENTS );
+
+		timer.Reset();
+		OldArray< TYPE >  array;
+		for ( UINT i = 0; i < numOldElements; i++ ) {
+			array.Append( elements[i] );
+		}
+		oldTime = ElapsedMilliseconds( timer );
+
+		for ( UINT i = 0; i < array.Num(); i++ ) {
+			if ( ! ELEMENTS::Check( array[i], i ) ) {
+				numErrors++;
+			}
+		}
+
+		if ( numOldElements < numElements )
+		{
+			const FLOAT  scale = (FLOAT) numElements / numOldElements;
+			oldTime *= scale * scale;
+			oldTimeSuffix = '~';
+		}
+	}
+
+	sys::Print( "%10s %10u %12.3f %12.3f %12.1f%c %8u\n",
+		ELEMENTS::Name(), numElements, newTime, reservedTime, oldTime, oldTimeSuffix, numErrors );
+
+	if ( numErrors ) {
+		sys::Print( "%u elements of type %s: wrong contents\n", numElements, ELEMENTS::Name() );
+		return false;
+	}
+	return true;
+}
+
+//
+//	ArrayAppend - times appending elements one by one to TArray (with and without Reserve())
+//	and to an array with the old fixed growth, and checks the contents.
+//
+bool ArrayAppend( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT elementCounts[] = { 10000, 100000, 1000000 };
+
+	sys::Print( "'~' marks old times extrapolated from %u elements\n", (UINT)MAX_OLD_ELEMENTS );
+	sys::Print( "%10s %10s %12s %12s %13s %8s\n",
+		"type", "elements", "append ms", "reserved ms", "old ms", "errors" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(elementCounts); iCount++ )
+	{
+		const UINT  numElements = elementCounts[ iCount ];
+
+		bOk &= MeasureAppends< VertexElements, rxVertex >( numElements );
+		bOk &= MeasureAppends< PointerElements, const void* >( numElements );
+		bOk &= MeasureAppends< StringElements, String >( numElements );
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( ArrayAppend, "appending 10k-1M elements to TArray against the old fixed growth" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
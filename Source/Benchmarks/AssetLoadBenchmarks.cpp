@@ -0,0 +1,374 @@
+/*
+=============================================================================
+	File:	AssetLoadBenchmarks.cpp
+	Desc:	Loading a folder of assets on the main thread and with the background loader.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <stdlib.h>
+
+#include <Engine.h>
+#include <MiniSG.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum EAssetType
+{
+	Asset_Mesh,
+	Asset_Material,	// material script
+	Asset_Texture,
+
+	NUM_ASSET_TYPES
+};
+
+struct AssetFile
+{
+	String		name;
+	EAssetType	type;
+};
+
+bool HasExtension( const String& fileName, const mxChar* extension )
+{
+	const mxChar * fileExtension = strrchr( fileName.ToChar(), '.' );
+	return fileExtension && String::Icmp( fileExtension, extension ) == 0;
+}
+
+// Lists the files in the folder and its subfolders.
+void ScanFolder( const String& folder, TArray< String > &OutFiles, TArray< String > &OutFolders )
+{
+	OutFolders.Append( folder );
+
+	String  searchPattern;
+	_sprintf( searchPattern, "%s/*", folder.ToChar() );
+
+	WIN32_FIND_DATA  findData;
+	const HANDLE hFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+	if ( hFind == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+	do
+	{
+		if ( findData.cFileName[0] == '.' ) {
+			continue;
+		}
+		String  fileName;
+		_sprintf( fileName, "%s/%s", folder.ToChar(), findData.cFileName );
+
+		if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+			ScanFolder( fileName, OutFiles, OutFolders );
+		} else {
+			OutFiles.Append( fileName );
+		}
+	}
+	while ( ::FindNextFile( hFind, &findData ) );
+
+	::FindClose( hFind );
+}
+
+// Material scripts are text files, image files are textures, other files are meshes.
+void FindAssets( const TArray< String >& files, TArray< AssetFile > &OutAssets )
+{
+	static const mxChar* imageExtensions[] = { ".dds", ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+	for ( UINT i = 0; i < files.Num(); i++ )
+	{
+		const String & fileName = files[i];
+
+		// skip the mesh cache files written by LoadMeshFromFile()
+		if ( HasExtension( fileName, ".mesh" ) || HasExtension( fileName, ".tmp" ) ) {
+			continue;
+		}
+
+		AssetFile & asset = OutAssets.Alloc();
+		asset.name = fileName;
+		asset.type = HasExtension( fileName, ".txt" ) ? Asset_Material : Asset_Mesh;
+
+		for ( UINT iExtension = 0; iExtension < ARRAY_SIZE(imageExtensions); iExtension++ ) {
+			if ( HasExtension( fileName, imageExtensions[ iExtension ] ) ) {
+				asset.type = Asset_Texture;
+			}
+		}
+	}
+}
+
+// Drops all files of the folder (including the mesh cache files) from the system file cache.
+void EvictFolderFromFileCache( const String& folder )
+{
+	TArray< String >  files;
+	TArray< String >  folders;
+	ScanFolder( folder, files, folders );
+
+	for ( UINT i = 0; i < files.Num(); i++ ) {
+		EvictFromFileCache( files[i].ToChar() );
+	}
+}
+
+bool ReadFileData( const mxChar* filename, TArray< BYTE > &OutData )
+{
+	mxDataStream * file = mxEngine::get().GetFileSystem().OpenFile( filename );
+	if ( ! file ) {
+		return false;
+	}
+	OutData.SetNum( file->GetSize() );
+	const bool bOk = ( OutData.Num() > 0 ) && ( file->Read( OutData.Ptr(), OutData.Num() ) == OutData.Num() );
+	MX_FREE( file );
+	return bOk;
+}
+
+UINT32 MeshChecksum( const mxMesh* mesh )
+{
+	UINT32  sum = 0;
+
+	const UINT32 * vertexWords = reinterpret_cast< const UINT32* >( mesh->vertices );
+	const UINT  numVertexWords = mesh->numVertices * sizeof(rxVertex) / sizeof(UINT32);
+	for ( UINT i = 0; i < numVertexWords; i++ ) {
+		sum += vertexWords[i];
+	}
+	for ( UINT i = 0; i < mesh->numIndices; i++ ) {
+		sum += mesh->indices[i];
+	}
+	return sum;
+}
+
+//
+//	Loads the assets one by one on the main thread, the way the engine loaded them before the background loader.
+//	Material scripts are parsed and their textures are read, but the materials are only created
+//	by the background loader (a material can be created only once).
+//
+FLOAT LoadOnMainThread( const TArray< AssetFile >& assets, TArray< bool > &OutLoaded, TArray< UINT32 > &OutChecksums )
+{
+	rxResources & resources = mxEngine::get().GetRenderer().GetResources();
+
+	OutLoaded.SetNum( assets.Num() );
+	OutChecksums.SetNum( assets.Num() );
+
+	mxTimer  timer;
+	for ( UINT i = 0; i < assets.Num(); i++ )
+	{
+		const AssetFile & asset = assets[i];
+		OutChecksums[i] = 0;
+
+		switch ( asset.type )
+		{
+		case Asset_Mesh :
+			{
+				const mxMeshPtr  mesh( LoadMeshFromFile( asset.name.ToChar() ) );
+				OutLoaded[i] = ( mesh != null );
+				if ( mesh != null ) {
+					OutChecksums[i] = MeshChecksum( mesh );
+				}
+			}
+			break;
+
+		case Asset_Material :
+			{
+				MaterialDefinitions  definitions;
+				OutLoaded[i] = ParseMaterialScript( asset.name.ToChar(), definitions ) && definitions.Num() > 0;
+
+				TArray< BYTE >  data;
+				for ( UINT iMaterial = 0; iMaterial < definitions.Num(); iMaterial++ ) {
+					for ( UINT iLayer = 0; iLayer < TL_Num_Layers; iLayer++ ) {
+						if ( ! definitions[ iMaterial ].textureFiles[ iLayer ].IsEmpty() ) {
+							ReadFileData( definitions[ iMaterial ].textureFiles[ iLayer ].ToChar(), data );
+						}
+					}
+				}
+			}
+			break;
+
+		case Asset_Texture :
+			{
+				TArray< BYTE >  data;
+				OutLoaded[i] = ReadFileData( asset.name.ToChar(), data )
+					&& resources.LoadTextureFromMemory( asset.name.ToChar(), data.Ptr(), data.Num() ) != null;
+			}
+			break;
+		}
+	}
+	return ElapsedMilliseconds( timer );
+}
+
+//
+//	Submits all assets to the background loader and commits them on the main thread until all have finished.
+//	Returns the total time, 'OutMainThreadTime' is the time spent on the main thread in submitting and committing.
+//
+FLOAT LoadInBackground( const TArray< AssetFile >& assets, mxUInt numThreads,
+	TArray< mxLoadRequestPtr > &OutRequests, FLOAT &OutMainThreadTime )
+{
+	mxAsyncLoader  loader;
+	loader.Initialize( numThreads );
+
+	OutRequests.SetNum( assets.Num() );
+
+	mxTimer  timer;
+	mxTimer  mainThreadTimer;
+
+	for ( UINT i = 0; i < assets.Num(); i++ )
+	{
+		const mxChar * filename = assets[i].name.ToChar();
+		switch ( assets[i].type )
+		{
+		case Asset_Mesh :		OutRequests[i] = loader.LoadMesh( filename );		break;
+		case Asset_Material :	OutRequests[i] = loader.LoadMaterials( filename );	break;
+		case Asset_Texture :	OutRequests[i] = loader.LoadTexture( filename );	break;
+		}
+	}
+	OutMainThreadTime = ElapsedMilliseconds( mainThreadTimer );
+
+	while ( loader.NumUnfinishedRequests() > 0 )
+	{
+		mainThreadTimer.Reset();
+		const mxUInt  numCommitted = loader.Update();
+		OutMainThreadTime += ElapsedMilliseconds( mainThreadTimer );
+
+		if ( ! numCommitted ) {
+			sys::Sleep( 0 );	// Sleep( 1 ) would add the timer resolution to the measured time
+		}
+	}
+	const FLOAT  totalTime = ElapsedMilliseconds( timer );
+
+	loader.Shutdown();
+	return totalTime;
+}
+
+bool MeasureAssetFolder( const String& folder, mxUInt numThreads )
+{
+	TArray< String >  files;
+	TArray< String >  folders;
+	ScanFolder( folder, files, folders );
+
+	// material scripts refer to textures by names relative to the asset folders
+	mxFileSystem & fileSystem = mxEngine::get().GetFileSystem();
+	for ( UINT i = 0; i < folders.Num(); i++ ) {
+		fileSystem.AddDir( ( folders[i] + String( "/" ) ).ToChar() );
+	}
+
+	TArray< AssetFile >  assets;
+	FindAssets( files, assets );
+
+	UINT  numAssetsOfType[ NUM_ASSET_TYPES ] = { 0 };
+	for ( UINT i = 0; i < assets.Num(); i++ ) {
+		numAssetsOfType[ assets[i].type ]++;
+	}
+
+	if ( assets.Num() == 0 ) {
+		sys::Print( "no assets found in '%s'\n", folder.ToChar() );
+		return false;
+	}
+
+	// import the meshes and write their cache files first, both passes load the meshes from the cache
+	mxTimer  timer;
+	for ( UINT i = 0; i < assets.Num(); i++ ) {
+		if ( assets[i].type == Asset_Mesh ) {
+			const mxMeshPtr  mesh( LoadMeshFromFile( assets[i].name.ToChar() ) );
+		}
+	}
+	const FLOAT  importTime = ElapsedMilliseconds( timer );
+
+	TArray< bool >  loaded;
+	TArray< UINT32 >  checksums;
+	EvictFolderFromFileCache( folder );
+	const FLOAT  mainThreadTime = LoadOnMainThread( assets, loaded, checksums );
+
+	TArray< mxLoadRequestPtr >  requests;
+	FLOAT  committingTime = 0.0f;
+	EvictFolderFromFileCache( folder );
+	const FLOAT  backgroundTime = LoadInBackground( assets, numThreads, requests, committingTime );
+
+	UINT  numMismatches = 0;
+	for ( UINT i = 0; i < assets.Num(); i++ )
+	{
+		const mxLoadRequest * request = requests[i];
+		if ( request->Succeeded() != loaded[i] ) {
+			numMismatches++;
+		}
+		else if ( assets[i].type == Asset_Mesh && loaded[i] && MeshChecksum( request->GetMesh() ) != checksums[i] ) {
+			numMismatches++;
+		}
+	}
+
+	sys::Print( "'%s': %u meshes, %u material scripts, %u textures, %u loader threads (from a cold file cache)\n",
+		folder.ToChar(), numAssetsOfType[ Asset_Mesh ], numAssetsOfType[ Asset_Material ],
+		numAssetsOfType[ Asset_Texture ], numThreads );
+	sys::Print( "%12s %12s %12s %12s %10s\n", "import ms", "main ms", "loader ms", "commit ms", "mismatches" );
+	sys::Print( "%12.3f %12.3f %12.3f %12.3f %10u\n",
+		importTime, mainThreadTime, backgroundTime, committingTime, numMismatches );
+
+	if ( numMismatches ) {
+		sys::Print( "%u assets loaded by the background loader differ from loading on the main thread\n", numMismatches );
+		return false;
+	}
+	return true;
+}
+
+//
+//	AssetLoad - loads all meshes, material scripts and textures in a folder (and its subfolders)
+//	on the main thread and then with the background loader, and checks that both give the same results.
+//	Runs in a headless engine, so textures are not decoded.
+//	Usage: AssetLoad <folder> [number of loader threads]
+//
+class AssetLoadApp : public mxApplication
+{
+public:
+	String	folder;
+	mxUInt	numThreads;
+	bool	bOk;
+
+public:
+	AssetLoadApp()
+		: numThreads( mxAsyncLoader::DEFAULT_NUM_THREADS )
+		, bOk( false )
+	{}
+
+	override( mxApplication ) bool Create()
+	{
+		this->bOk = MeasureAssetFolder( this->folder, this->numThreads );
+		return true;
+	}
+};
+
+bool AssetLoad( const TArray< String >& args )
+{
+	if ( args.Num() == 0 ) {
+		sys::Print( "skipped: no asset folder, run 'Benchmarks AssetLoad <folder> [threads]'\n" );
+		return true;
+	}
+
+	if ( ! BeginEngineBenchmark( "AssetLoad" ) ) {
+		return true;
+	}
+
+	// the system keeps a pointer to the application until the process exits
+	AssetLoadApp * app = new AssetLoadApp();
+	app->folder = args[0];
+	if ( args.Num() > 1 ) {
+		app->numThreads = Clamp< mxUInt >( atoi( args[1].ToChar() ), 1, mxAsyncLoader::MAX_LOADER_THREADS );
+	}
+
+	mxSystemCreationInfo  cInfo;
+	cInfo.pUserApp = app;
+	cInfo.driverType = EDriverType::GAPI_None;
+	cInfo.numFramesToRun = 1;
+
+	mxEngine * engine = CreateEngine( cInfo );
+	if ( engine == null ) {
+		sys::Print( "failed to create the engine with the null render system\n" );
+		return false;
+	}
+
+	engine->Run();
+
+	return app->bOk;
+}
+
+MX_REGISTER_BENCHMARK( AssetLoad, "loading a folder of assets on the main thread and with the background loader, headless" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,65 @@
+/*
+=============================================================================
+	File:	Benchmarks.h
+	Desc:	Registry of benchmarks which can be run from the command line.
+=============================================================================
+*/
+
+#ifndef __BENCHMARKS_H__
+#define __BENCHMARKS_H__
+
+#include <Base.h>
+
+namespace abc {
+
+//
+//	mxBenchmarkFunction - runs a benchmark and prints the results.
+//	Returns false if the benchmark has found a problem (e.g. results differ from the reference).
+//	'args' are the command-line arguments following the name of the benchmark.
+//
+typedef bool mxBenchmarkFunction( const TArray< String >& args );
+
+//
+//	mxBenchmark - a static instance registers the benchmark (see MX_REGISTER_BENCHMARK).
+//
+struct mxBenchmark
+{
+	const char *			name;
+	const char *			description;
+	mxBenchmarkFunction *	function;
+	mxBenchmark *			next;
+
+	mxBenchmark( const char* theName, const char* theDescription, mxBenchmarkFunction* theFunction );
+
+	static mxBenchmark *	Head();	// all registered benchmarks
+	static mxBenchmark *	Find( const char* name );
+};
+
+#define MX_REGISTER_BENCHMARK( FUNCTION, DESCRIPTION )\
+	static ::abc::mxBenchmark	gBenchmark_##FUNCTION( #FUNCTION, DESCRIPTION, &FUNCTION )
+
+// Returns the time in milliseconds measured with the given timer (with microsecond precision).
+FLOAT	ElapsedMilliseconds( mxTimer & timer );
+
+// Returns a pseudo-random number (the sequence is the same on each run).
+UINT32	BenchmarkRandom( UINT32 & seed );
+FLOAT	BenchmarkRandomFloat( UINT32 & seed, FLOAT minValue, FLOAT maxValue );
+
+// Keeps the compiler from optimizing away the computed values.
+void	BenchmarkConsume( UINT32 value );
+
+// The engine can only be created once per process. Returns false (and prints a note)
+// if another benchmark has already created it, the benchmark must then be run on its own.
+bool	BeginEngineBenchmark( const char* benchmarkName );
+
+// Drops the pages of the file from the system file cache (if no other handle to the file is open),
+// so that the next read has to go to the disk.
+void	EvictFromFileCache( const mxChar* filename );
+
+}//End of namespace abc
+
+#endif // ! __BENCHMARKS_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,368 @@
+/*
+=============================================================================
+	File:	CSGBenchmarks.cpp
+	Desc:	Solid BSP tree construction with different splitter heuristics
+			and partial mesh updates after CSG operations.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+#include <MiniSG.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	GRID_SIZE		= 8,		// boxes along each axis
+	NUM_BUILDS		= 5,
+	NUM_POINTS		= 100000,
+	NUM_QUERIES		= 10,		// passes over the query points
+	NUM_SEQUENCES	= 8,		// of CSG operations on a new tree
+	NUM_UPDATES		= 3,		// CSG operations in each sequence
+};
+
+const FLOAT CELL_SIZE = 10.0f;
+
+// All box faces lie on multiples of this step,
+// query points lie halfway between them and never touch a splitting plane.
+const FLOAT GRID_STEP = 0.5f;
+
+struct TestBox
+{
+	Vec3D	mins;
+	Vec3D	maxs;
+};
+
+void AppendBox( const mxMesh* unitBox, const TestBox& box, DynamicMesh &OutMesh )
+{
+	const Vec3D  center( ( box.mins + box.maxs ) * 0.5f );
+	const Vec3D  size( box.maxs - box.mins );
+
+	const rxIndex  firstVertex = (rxIndex) OutMesh.vertices.Num();
+
+	for ( UINT iVertex = 0; iVertex < unitBox->numVertices; iVertex++ )
+	{
+		HVertex  v( unitBox->vertices[ iVertex ] );
+		v.XYZ.x = center.x + v.XYZ.x * size.x;
+		v.XYZ.y = center.y + v.XYZ.y * size.y;
+		v.XYZ.z = center.z + v.XYZ.z * size.z;
+		OutMesh.vertices.Append( v );
+	}
+
+	for ( UINT i = 0; i < unitBox->numIndices; i += 3 )
+	{
+		OutMesh.triangles.Append( IndexTriple(
+			(rxIndex)( firstVertex + unitBox->indices[ i + 0 ] ),
+			(rxIndex)( firstVertex + unitBox->indices[ i + 1 ] ),
+			(rxIndex)( firstVertex + unitBox->indices[ i + 2 ] ) ) );
+	}
+}
+
+//
+// Fills the mesh with disjoint axis-aligned boxes of random sizes, one box in each cell of the grid.
+//
+void BuildTestSolid( DynamicMesh &OutMesh, TArray< TestBox > &OutBoxes )
+{
+	mxMeshPtr  unitBox( MakeMesh_Box( 1.0f, 1.0f, 1.0f ) );
+
+	OutMesh.Reset();
+	OutBoxes.SetNum( 0, false );
+
+	UINT32  seed = 2468;
+	for ( mxUInt iCell = 0; iCell < GRID_SIZE * GRID_SIZE * GRID_SIZE; iCell++ )
+	{
+		const Vec3D  cellMins(
+			CELL_SIZE * ( iCell % GRID_SIZE ),
+			CELL_SIZE * ( ( iCell / GRID_SIZE ) % GRID_SIZE ),
+			CELL_SIZE * ( iCell / ( GRID_SIZE * GRID_SIZE ) ) );
+
+		// leave a gap of 1..8 grid steps on each side of the box
+		TestBox  box;
+		for ( mxUInt iAxis = 0; iAxis < 3; iAxis++ )
+		{
+			box.mins[ iAxis ] = cellMins[ iAxis ] + GRID_STEP * ( 1 + BenchmarkRandom( seed ) % 8 );
+			box.maxs[ iAxis ] = cellMins[ iAxis ] + CELL_SIZE - GRID_STEP * ( 1 + BenchmarkRandom( seed ) % 8 );
+		}
+		OutBoxes.Append( box );
+		AppendBox( unitBox, box, OutMesh );
+	}
+}
+
+bool IsInsideTestBoxes( const TArray< TestBox >& boxes, const Vec3D& point )
+{
+	// the point can only be inside the box of its own cell
+	const mxUInt  x = (mxUInt)( point.x / CELL_SIZE );
+	const mxUInt  y = (mxUInt)( point.y / CELL_SIZE );
+	const mxUInt  z = (mxUInt)( point.z / CELL_SIZE );
+	const TestBox & box = boxes[ ( z * GRID_SIZE + y ) * GRID_SIZE + x ];
+
+	return point.x > box.mins.x && point.x < box.maxs.x
+		&& point.y > box.mins.y && point.y < box.maxs.y
+		&& point.z > box.mins.z && point.z < box.maxs.z;
+}
+
+struct TreeStats
+{
+	mxUInt	numInternalNodes;
+	mxUInt	numPolygons;	// polygons stored in the tree (including the fragments created by splits)
+	mxUInt	depth;
+};
+
+void GatherTreeStats_R( const BSPNode* node, mxUInt depth, TreeStats &stats )
+{
+	if ( node->IsLeaf() ) {
+		stats.depth = Max( stats.depth, depth );
+		return;
+	}
+
+	stats.numInternalNodes++;
+	for ( const HPoly * poly = node->polys; poly != null; poly = poly->GetNext() ) {
+		stats.numPolygons++;
+	}
+
+	GatherTreeStats_R( node->front, depth + 1, stats );
+	GatherTreeStats_R( node->back, depth + 1, stats );
+}
+
+// Returns the number of planes tested to classify the point.
+mxUInt GetQueryDepth( const BSPNode* node, const Vec3D& point )
+{
+	mxUInt  depth = 0;
+	while ( node->IsInternal() )
+	{
+		node = ( node->plane.Distance( point ) > 0.0f ) ? node->front : node->back;
+		depth++;
+	}
+	return depth;
+}
+
+//
+//	BuildBSP - builds a solid BSP tree from the same mesh with each splitter heuristic
+//	and compares build times, tree sizes and point classification times.
+//
+bool BuildBSP( const TArray< String >& args )
+{
+	(void) args;
+
+	DynamicMesh			mesh;
+	TArray< TestBox >	boxes;
+	BuildTestSolid( mesh, boxes );
+
+	const mxUInt  numSteps = (mxUInt)( GRID_SIZE * CELL_SIZE / GRID_STEP );
+
+	TArray< Vec3D >  points;
+	points.SetNum( NUM_POINTS );
+
+	UINT32  seed = 1357;
+	for ( mxUInt i = 0; i < NUM_POINTS; i++ )
+	{
+		points[i].x = GRID_STEP * ( BenchmarkRandom( seed ) % numSteps ) + GRID_STEP * 0.5f;
+		points[i].y = GRID_STEP * ( BenchmarkRandom( seed ) % numSteps ) + GRID_STEP * 0.5f;
+		points[i].z = GRID_STEP * ( BenchmarkRandom( seed ) % numSteps ) + GRID_STEP * 0.5f;
+	}
+
+	sys::Print( "%u boxes, %u triangles, %u query points (single-threaded builds)\n",
+		boxes.Num(), mesh.NumTriangles(), (mxUInt)NUM_POINTS );
+	sys::Print( "%-10s %10s %8s %8s %6s %12s %10s\n",
+		"heuristic", "build ms", "nodes", "polys", "depth", "avg. query", "query ms" );
+
+	bool  bOk = true;
+
+	for ( mxUInt iHeuristic = 0; iHeuristic < NUM_SPLITTER_HEURISTICS; iHeuristic++ )
+	{
+		BSPBuildSettings  settings;
+		settings.heuristic = (ESplitterHeuristic) iHeuristic;
+		settings.parallelThreshold = 0;
+
+		SolidBSP  tree;
+		tree.SetBuildSettings( settings );
+
+		mxTimer  timer;
+		for ( mxUInt iBuild = 0; iBuild < NUM_BUILDS; iBuild++ ) {
+			tree.Build( mesh );
+		}
+		const FLOAT buildTime = ElapsedMilliseconds( timer ) / NUM_BUILDS;
+
+		TreeStats  stats;
+		MemZero( &stats, sizeof(stats) );
+		GatherTreeStats_R( tree.GetRoot(), 0, stats );
+
+		mxUInt  numMismatches = 0;
+		mxUInt  totalQueryDepth = 0;
+		for ( mxUInt i = 0; i < NUM_POINTS; i++ )
+		{
+			if ( tree.IsSolidAt( points[i] ) != IsInsideTestBoxes( boxes, points[i] ) ) {
+				numMismatches++;
+			}
+			totalQueryDepth += GetQueryDepth( tree.GetRoot(), points[i] );
+		}
+
+		mxUInt  numSolid = 0;
+		timer.Reset();
+		for ( mxUInt iQuery = 0; iQuery < NUM_QUERIES; iQuery++ ) {
+			for ( mxUInt i = 0; i < NUM_POINTS; i++ ) {
+				numSolid += tree.IsSolidAt( points[i] );
+			}
+		}
+		const FLOAT queryTime = ElapsedMilliseconds( timer ) / NUM_QUERIES;
+		BenchmarkConsume( numSolid );
+
+		sys::Print( "%-10s %10.2f %8u %8u %6u %12.1f %10.3f\n",
+			GetSplitterHeuristicName( settings.heuristic ), buildTime,
+			stats.numInternalNodes, stats.numPolygons, stats.depth,
+			(FLOAT) totalQueryDepth / NUM_POINTS, queryTime );
+
+		if ( numMismatches ) {
+			sys::Print( "%s: %u points classified incorrectly\n",
+				GetSplitterHeuristicName( settings.heuristic ), numMismatches );
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( BuildBSP, "solid BSP construction with each splitter heuristic" );
+
+bool IsSameMesh( const DynamicMesh& a, const DynamicMesh& b )
+{
+	return a.NumVertices() == b.NumVertices()
+		&& a.NumTriangles() == b.NumTriangles()
+		&& memcmp( a.vertices.Ptr(), b.vertices.Ptr(), a.NumVertices() * sizeof(HVertex) ) == 0
+		&& memcmp( a.triangles.Ptr(), b.triangles.Ptr(), a.NumTriangles() * sizeof(IndexTriple) ) == 0;
+}
+
+// Returns the number of nodes whose geometry is stored at different locations in the meshes of two trees
+// with the same structure.
+mxUInt CompareNodeRanges_R( const BSPNode* a, const BSPNode* b )
+{
+	if ( a->IsLeaf() || b->IsLeaf() ) {
+		return ( a->IsLeaf() && b->IsLeaf() ) ? 0 : 1;
+	}
+
+	mxUInt  numMismatches = 0;
+	if ( a->firstVertex != b->firstVertex || a->numVertices != b->numVertices
+		|| a->firstTriangle != b->firstTriangle || a->numTriangles != b->numTriangles )
+	{
+		numMismatches++;
+	}
+	numMismatches += CompareNodeRanges_R( a->front, b->front );
+	numMismatches += CompareNodeRanges_R( a->back, b->back );
+	return numMismatches;
+}
+
+// Cuts a corner off the box in a random cell, this adds polygons to the subtree containing the box,
+// so that the geometry of the subtrees emitted after it is shifted.
+void MakeCutter( const TArray< TestBox >& boxes, UINT32 & seed, DynamicMesh &OutMesh )
+{
+	const TestBox & box = boxes[ BenchmarkRandom( seed ) % boxes.Num() ];
+
+	// the boxes are at least 4 grid steps wide
+	TestBox  cutter;
+	for ( mxUInt iAxis = 0; iAxis < 3; iAxis++ )
+	{
+		cutter.mins[ iAxis ] = box.mins[ iAxis ] - GRID_STEP;
+		cutter.maxs[ iAxis ] = box.mins[ iAxis ] + GRID_STEP * ( 1 + BenchmarkRandom( seed ) % 3 );
+	}
+
+	mxMeshPtr  unitBox( MakeMesh_Box( 1.0f, 1.0f, 1.0f ) );
+	OutMesh.Reset();
+	AppendBox( unitBox, cutter, OutMesh );
+}
+
+//
+//	UpdateBSPMesh - applies several CSG operations in a row to the test solid and re-emits only the changed subtrees,
+//	the meshes and the locations of all nodes must be the same as after emitting the whole tree.
+//	The first operation shifts unchanged subtrees, the following ones change nodes inside the shifted subtrees.
+//
+bool UpdateBSPMesh( const TArray< String >& args )
+{
+	(void) args;
+
+	DynamicMesh			solid;
+	TArray< TestBox >	boxes;
+	BuildTestSolid( solid, boxes );
+
+	BSPBuildSettings  settings;
+	settings.parallelThreshold = 0;
+
+	FLOAT  emitTimes[ NUM_UPDATES ] = { 0 };
+	FLOAT  updateTimes[ NUM_UPDATES ] = { 0 };
+	mxUInt  numMeshMismatches[ NUM_UPDATES ] = { 0 };
+	mxUInt  numNodeMismatches[ NUM_UPDATES ] = { 0 };
+
+	UINT32  seed = 8642;
+	for ( mxUInt iSequence = 0; iSequence < NUM_SEQUENCES; iSequence++ )
+	{
+		// the updated tree and the reference, which is emitted completely after each operation
+		SolidBSP  updated;
+		SolidBSP  reference;
+		updated.SetBuildSettings( settings );
+		reference.SetBuildSettings( settings );
+		updated.Build( solid );
+		reference.Build( solid );
+
+		DynamicMesh  updatedMesh;
+		DynamicMesh  referenceMesh;
+		updated.EmitMesh( updatedMesh );
+
+		for ( mxUInt iUpdate = 0; iUpdate < NUM_UPDATES; iUpdate++ )
+		{
+			DynamicMesh  cutter;
+			MakeCutter( boxes, seed, cutter );
+
+			updated.DoCSG( ESetOp::CSG_Difference, cutter );
+			reference.DoCSG( ESetOp::CSG_Difference, cutter );
+
+			mxUInt  firstChangedVertex, firstChangedTriangle;
+			mxTimer  timer;
+			updated.UpdateMesh( updatedMesh, firstChangedVertex, firstChangedTriangle );
+			updateTimes[ iUpdate ] += ElapsedMilliseconds( timer );
+
+			timer.Reset();
+			reference.EmitMesh( referenceMesh );
+			emitTimes[ iUpdate ] += ElapsedMilliseconds( timer );
+
+			if ( ! IsSameMesh( updatedMesh, referenceMesh ) ) {
+				numMeshMismatches[ iUpdate ]++;
+			}
+			numNodeMismatches[ iUpdate ] += CompareNodeRanges_R( updated.GetRoot(), reference.GetRoot() );
+		}
+	}
+
+	sys::Print( "%u boxes, %u sequences of %u subtractions
+", boxes.Num(), (mxUInt)NUM_SEQUENCES, (mxUInt)NUM_UPDATES );
+	sys::Print( "%8s %10s %10s %10s %10s
+", "update", "emit ms", "update ms", "meshes", "nodes" );
+
+	bool  bOk = true;
+	for ( mxUInt iUpdate = 0; iUpdate < NUM_UPDATES; iUpdate++ )
+	{
+		sys::Print( "%8u %10.3f %10.3f %10u %10u
+", iUpdate + 1,
+			emitTimes[ iUpdate ] / NUM_SEQUENCES, updateTimes[ iUpdate ] / NUM_SEQUENCES,
+			numMeshMismatches[ iUpdate ], numNodeMismatches[ iUpdate ] );
+
+		if ( numMeshMismatches[ iUpdate ] || numNodeMismatches[ iUpdate ] ) {
+			bOk = false;
+		}
+	}
+	if ( ! bOk ) {
+		sys::Print( "updated meshes differ from emitting the whole tree
+" );
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( UpdateBSPMesh, "re-emitting only the changed BSP subtrees after CSG operations" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
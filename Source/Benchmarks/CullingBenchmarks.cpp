@@ -0,0 +1,194 @@
+/*
+=============================================================================
+	File:	CullingBenchmarks.cpp
+	Desc:	Batch (SoA) frustum culling against per-object tests.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_VOLUMES		= 100000,
+	NUM_ITERATIONS	= 20,
+};
+
+const FLOAT WORLD_SIZE = 1000.0f;
+
+void BuildTestFrustum( mxViewFrustum &OutFrustum )
+{
+	Matrix4  view;
+	view.BuildView( Vec3D( 0.0f, 0.0f, 0.0f ), Vec3D( 0.3f, 0.1f, 1.0f ), Vec3D( 0.0f, 1.0f, 0.0f ) );
+
+	Matrix4  projection;
+	projection.BuildProjection( mxMath::HALF_PI, 4.0f / 3.0f, 1.0f, WORLD_SIZE * 0.5f );
+
+	OutFrustum.ExtractFrustumPlanes( view * projection );
+}
+
+Vec3D RandomPoint( UINT32 & seed )
+{
+	const FLOAT h = WORLD_SIZE * 0.5f;
+	return Vec3D( BenchmarkRandomFloat( seed, -h, h ),
+		BenchmarkRandomFloat( seed, -h, h ),
+		BenchmarkRandomFloat( seed, -h, h ) );
+}
+
+void SetBit( TArray< UDWORD > & mask, mxUInt index )
+{
+	mask[ index >> 5 ] |= 1UL << ( index & 31 );
+}
+
+// Returns the number of set bits, or -1 if the masks differ.
+INT CompareMasks( const TArray< UDWORD >& a, const TArray< UDWORD >& b )
+{
+	INT  numVisible = 0;
+	for ( mxUInt i = 0; i < a.Num(); i++ )
+	{
+		if ( a[i] != b[i] ) {
+			return -1;
+		}
+		for ( UDWORD bits = a[i]; bits; bits &= bits - 1 ) {
+			numVisible++;
+		}
+	}
+	return numVisible;
+}
+
+//
+//	CullSpheres - mxViewFrustum::CullSpheres() against IntersectSphere() in a loop.
+//
+bool CullSpheres( const TArray< String >& args )
+{
+	(void) args;
+
+	mxViewFrustum  frustum;
+	BuildTestFrustum( frustum );
+
+	TArray< Sphere >	spheres;
+	mxSphereSoA			spheresSoA;
+
+	UINT32  seed = 12345;
+	for ( mxUInt i = 0; i < NUM_VOLUMES; i++ )
+	{
+		const Sphere s( RandomPoint( seed ), BenchmarkRandomFloat( seed, 0.5f, 10.0f ) );
+		spheres.Append( s );
+		spheresSoA.Add( s );
+	}
+
+	const mxUInt maskSize = GetVisibilityMaskSize( NUM_VOLUMES );
+
+	TArray< UDWORD >  scalarMask;
+	scalarMask.SetNum( maskSize );
+
+	mxTimer  timer;
+	for ( mxUInt iter = 0; iter < NUM_ITERATIONS; iter++ )
+	{
+		MemZero( scalarMask.Ptr(), maskSize * sizeof(UDWORD) );
+		for ( mxUInt i = 0; i < NUM_VOLUMES; i++ ) {
+			if ( frustum.IntersectSphere( spheres[i] ) ) {
+				SetBit( scalarMask, i );
+			}
+		}
+	}
+	const FLOAT scalarTime = ElapsedMilliseconds( timer ) / NUM_ITERATIONS;
+
+	TArray< UDWORD >  batchMask;
+	batchMask.SetNum( maskSize );
+
+	timer.Reset();
+	for ( mxUInt iter = 0; iter < NUM_ITERATIONS; iter++ ) {
+		frustum.CullSpheres( spheresSoA, batchMask.Ptr() );
+	}
+	const FLOAT batchTime = ElapsedMilliseconds( timer ) / NUM_ITERATIONS;
+
+	const INT numVisible = CompareMasks( scalarMask, batchMask );
+
+	sys::Print( "%u spheres, %d visible\n", (mxUInt)NUM_VOLUMES, numVisible );
+	sys::Print( "IntersectSphere(): %.3f ms\n", scalarTime );
+	sys::Print( "CullSpheres():     %.3f ms (%.1fx)\n", batchTime, scalarTime / Max( batchTime, 1e-3f ) );
+
+	if ( numVisible < 0 ) {
+		sys::Print( "the batch results differ from IntersectSphere()\n" );
+		return false;
+	}
+	return true;
+}
+
+//
+//	CullBoxes - mxViewFrustum::CullBoxes() against IntersectsAABB() in a loop.
+//
+bool CullBoxes( const TArray< String >& args )
+{
+	(void) args;
+
+	mxViewFrustum  frustum;
+	BuildTestFrustum( frustum );
+
+	TArray< AABB >	boxes;
+	mxAABBSoA		boxesSoA;
+
+	UINT32  seed = 54321;
+	for ( mxUInt i = 0; i < NUM_VOLUMES; i++ )
+	{
+		const Vec3D center( RandomPoint( seed ) );
+		const Vec3D halfSize( BenchmarkRandomFloat( seed, 0.5f, 10.0f ),
+			BenchmarkRandomFloat( seed, 0.5f, 10.0f ),
+			BenchmarkRandomFloat( seed, 0.5f, 10.0f ) );
+
+		const AABB box( center - halfSize, center + halfSize );
+		boxes.Append( box );
+		boxesSoA.Add( box );
+	}
+
+	const mxUInt maskSize = GetVisibilityMaskSize( NUM_VOLUMES );
+
+	TArray< UDWORD >  scalarMask;
+	scalarMask.SetNum( maskSize );
+
+	mxTimer  timer;
+	for ( mxUInt iter = 0; iter < NUM_ITERATIONS; iter++ )
+	{
+		MemZero( scalarMask.Ptr(), maskSize * sizeof(UDWORD) );
+		for ( mxUInt i = 0; i < NUM_VOLUMES; i++ ) {
+			if ( frustum.IntersectsAABB( boxes[i] ) ) {
+				SetBit( scalarMask, i );
+			}
+		}
+	}
+	const FLOAT scalarTime = ElapsedMilliseconds( timer ) / NUM_ITERATIONS;
+
+	TArray< UDWORD >  batchMask;
+	batchMask.SetNum( maskSize );
+
+	timer.Reset();
+	for ( mxUInt iter = 0; iter < NUM_ITERATIONS; iter++ ) {
+		frustum.CullBoxes( boxesSoA, batchMask.Ptr() );
+	}
+	const FLOAT batchTime = ElapsedMilliseconds( timer ) / NUM_ITERATIONS;
+
+	const INT numVisible = CompareMasks( scalarMask, batchMask );
+
+	sys::Print( "%u boxes, %d visible\n", (mxUInt)NUM_VOLUMES, numVisible );
+	sys::Print( "IntersectsAABB(): %.3f ms\n", scalarTime );
+	sys::Print( "CullBoxes():      %.3f ms (%.1fx)\n", batchTime, scalarTime / Max( batchTime, 1e-3f ) );
+
+	if ( numVisible < 0 ) {
+		sys::Print( "the batch results differ from IntersectsAABB()\n" );
+		return false;
+	}
+	return true;
+}
+
+MX_REGISTER_BENCHMARK( CullSpheres, "batch frustum culling of bounding spheres" );
+MX_REGISTER_BENCHMARK( CullBoxes, "batch frustum culling of bounding boxes" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,202 @@
+/*
+=============================================================================
+	File:	HashMapBenchmarks.cpp
+	Desc:	String-keyed lookups in THashMap and in the old chained hash table.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	MAX_LOOKUPS		= 100000,	// per pass (the old table is too slow for 1M lookups)
+	OLD_TABLE_SIZE	= 65536,	// buckets of the old table (only 2048 of them can be used)
+};
+
+//
+//	OldStringHash - the removed TStringHash: a table of sorted chains of separately allocated nodes,
+//	indexed by NameHash() which never exceeds DEFINEHASHSIZE - 1.
+//
+class OldStringHash {
+public:
+	OldStringHash( INT tableSize )
+		: tableSizeMask( tableSize - 1 )
+	{
+		heads.SetNum( tableSize );
+		for ( INT i = 0; i < tableSize; i++ ) {
+			heads[i] = null;
+		}
+	}
+
+	~OldStringHash()
+	{
+		for ( UINT i = 0; i < heads.Num(); i++ )
+		{
+			Node * node = heads[i];
+			while ( node != null ) {
+				Node * next = node->next;
+				delete node;
+				node = next;
+			}
+		}
+	}
+
+	void Set( const char* key, UINT value )
+	{
+		Node ** nextPtr = &heads[ GetHash( key ) ];
+		Node * node = *nextPtr;
+		for ( ; node != null; nextPtr = &node->next, node = *nextPtr )
+		{
+			const INT  s = strcmp( node->key.c_str(), key );
+			if ( s == 0 ) {
+				node->value = value;
+				return;
+			}
+			if ( s > 0 ) {
+				break;
+			}
+		}
+		*nextPtr = new Node( key, value, node );
+	}
+
+	const UINT * Find( const char* key ) const
+	{
+		for ( const Node * node = heads[ GetHash( key ) ]; node != null; node = node->next )
+		{
+			const INT  s = strcmp( node->key.c_str(), key );
+			if ( s == 0 ) {
+				return &node->value;
+			}
+			if ( s > 0 ) {
+				break;
+			}
+		}
+		return null;
+	}
+
+private:
+	struct Node
+	{
+		String	key;
+		UINT	value;
+		Node *	next;
+
+		Node( const char* k, UINT v, Node* n ) : key( k ), value( v ), next( n ) {}
+	};
+
+	INT GetHash( const char* key ) const {
+		return NameHash( key ) & tableSizeMask;
+	}
+
+	TArray< Node* >	heads;
+	INT				tableSizeMask;
+};
+
+//
+//	HashMapLookup - inserts names of objects into THashMap and into the old table,
+//	times lookups of existing and missing names and checks the found values.
+//
+bool HashMapLookup( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT keyCounts[] = { 1000, 100000, 1000000 };
+
+	sys::Print( "%8s %12s %12s %12s %12s %10s\n",
+		"keys", "insert ms", "old insert", "lookup ms", "old lookup", "errors" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(keyCounts); iCount++ )
+	{
+		const UINT  numKeys = keyCounts[ iCount ];
+		const UINT  numLookups = Min< UINT >( numKeys, MAX_LOOKUPS );
+
+		TArray< String >  keys;
+		keys.SetNum( numKeys );
+		for ( UINT i = 0; i < numKeys; i++ ) {
+			keys[i] = String( "object_" ) + String( (int) i );
+		}
+
+		// half of the lookups are misses
+		TArray< String >  lookups;
+		TArray< UINT >  expected;
+		lookups.SetNum( numLookups );
+		expected.SetNum( numLookups );
+
+		UINT32  seed = 777 + numKeys;
+		for ( UINT i = 0; i < numLookups; i++ )
+		{
+			const UINT  keyIndex = BenchmarkRandom( seed ) % numKeys;
+			if ( i & 1 ) {
+				lookups[i] = String( "missing_" ) + String( (int) keyIndex );
+				expected[i] = MAX_UINT32;
+			} else {
+				lookups[i] = keys[ keyIndex ];
+				expected[i] = keyIndex;
+			}
+		}
+
+		mxTimer  timer;
+		THashMap< String, UINT >  map;
+		for ( UINT i = 0; i < numKeys; i++ ) {
+			map.Set( keys[i], i );
+		}
+		const FLOAT insertTime = ElapsedMilliseconds( timer );
+
+		timer.Reset();
+		OldStringHash  oldMap( OLD_TABLE_SIZE );
+		for ( UINT i = 0; i < numKeys; i++ ) {
+			oldMap.Set( keys[i].c_str(), i );
+		}
+		const FLOAT oldInsertTime = ElapsedMilliseconds( timer );
+
+		UINT  numErrors = 0;
+
+		timer.Reset();
+		for ( UINT i = 0; i < numLookups; i++ )
+		{
+			const UINT * value = map.Find( lookups[i].c_str() );
+			if ( ( value ? *value : MAX_UINT32 ) != expected[i] ) {
+				numErrors++;
+			}
+		}
+		const FLOAT lookupTime = ElapsedMilliseconds( timer );
+
+		timer.Reset();
+		for ( UINT i = 0; i < numLookups; i++ )
+		{
+			const UINT * value = oldMap.Find( lookups[i].c_str() );
+			if ( ( value ? *value : MAX_UINT32 ) != expected[i] ) {
+				numErrors++;
+			}
+		}
+		const FLOAT oldLookupTime = ElapsedMilliseconds( timer );
+
+		if ( map.Num() != numKeys ) {
+			numErrors++;
+		}
+
+		sys::Print( "%8u %12.3f %12.3f %12.3f %12.3f %10u\n",
+			numKeys, insertTime, oldInsertTime, lookupTime, oldLookupTime, numErrors );
+
+		if ( numErrors ) {
+			sys::Print( "%u keys: wrong values have been found\n", numKeys );
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( HashMapLookup, "string-keyed THashMap against the old chained hash table" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
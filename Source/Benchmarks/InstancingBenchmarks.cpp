@@ -0,0 +1,190 @@
+/*
+=============================================================================
+	File:	InstancingBenchmarks.cpp
+	Desc:	Lookup of hardware buffers shared by models created from the same mesh data.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_VERTICES	= 24,	// per mesh, like a box with unshared corners
+	NUM_INDICES		= 36,
+};
+
+struct TestMesh
+{
+	rxVertex	vertices[ NUM_VERTICES ];
+	rxIndex		indices[ NUM_INDICES ];
+};
+
+void FillTestMesh( TestMesh &OutMesh, UINT32 & seed )
+{
+	for ( UINT i = 0; i < NUM_VERTICES; i++ )
+	{
+		for ( UINT iComponent = 0; iComponent < sizeof(rxVertex) / sizeof(FLOAT); iComponent++ ) {
+			OutMesh.vertices[i][ iComponent ] = BenchmarkRandomFloat( seed, -1.0f, 1.0f );
+		}
+	}
+	for ( UINT i = 0; i < NUM_INDICES; i++ ) {
+		OutMesh.indices[i] = (rxIndex)( BenchmarkRandom( seed ) % NUM_VERTICES );
+	}
+}
+
+rxMeshDescription MakeMeshDescription( const TestMesh& mesh )
+{
+	rxMeshDescription  desc;
+	desc.Vertices.VertexCount	= NUM_VERTICES;
+	desc.Vertices.VertexSize	= sizeof(rxVertex);
+	desc.Vertices.Data			= mesh.vertices;
+	desc.Indices.IndexCount		= NUM_INDICES;
+	desc.Indices.IndexSize		= sizeof(rxIndex);
+	desc.Indices.Data			= mesh.indices;
+	desc.PrimitiveType			= EPrimitiveType::PT_TriangleList;
+	return desc;
+}
+
+//
+//	The old lookup: a linear scan over pointers and sizes, then a byte-wise FNV-1a checksum of the matching mesh.
+//
+struct LinearEntry
+{
+	const void *	vertexData;
+	const void *	indexData;
+	UINT32			checksum;
+};
+
+UINT32 CalcLinearChecksum( const rxMeshDescription& desc )
+{
+	const UINT32  checksum = mxHashBytes( desc.Vertices.Data, desc.Vertices.VertexCount * desc.Vertices.VertexSize );
+	return mxHashBytes( desc.Indices.Data, desc.Indices.IndexCount * desc.Indices.IndexSize, checksum );
+}
+
+INT FindLinear( const TArray< LinearEntry >& entries, const rxMeshDescription& desc )
+{
+	for ( UINT i = 0; i < entries.Num(); i++ )
+	{
+		if ( entries[i].vertexData == desc.Vertices.Data
+			&& entries[i].indexData == desc.Indices.Data
+			&& entries[i].checksum == CalcLinearChecksum( desc ) )
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+//
+//	SharedMeshLookup - times finding shared buffers by rxMeshKey in a hash map
+//	against the old linear scan and checks that changed mesh data is never matched.
+//
+bool SharedMeshLookup( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT meshCounts[] = { 1000, 10000 };
+
+	sys::Print( "%u vertices and %u indices per mesh\n", (UINT)NUM_VERTICES, (UINT)NUM_INDICES );
+	sys::Print( "%8s %12s %12s %10s\n", "meshes", "hash map ms", "linear ms", "misses" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(meshCounts); iCount++ )
+	{
+		const UINT  numMeshes = meshCounts[ iCount ];
+
+		TArray< TestMesh >  meshes;
+		meshes.SetNum( numMeshes );
+
+		UINT32  seed = 1122 + numMeshes;
+		for ( UINT i = 0; i < numMeshes; i++ ) {
+			FillTestMesh( meshes[i], seed );
+		}
+
+		THashMap< rxMeshKey, UINT >  meshMap;
+		TArray< LinearEntry >  linearEntries;
+		linearEntries.SetNum( numMeshes );
+
+		for ( UINT i = 0; i < numMeshes; i++ )
+		{
+			const rxMeshDescription  desc( MakeMeshDescription( meshes[i] ) );
+			meshMap.Set( rxMeshKey( desc ), i );
+
+			linearEntries[i].vertexData = desc.Vertices.Data;
+			linearEntries[i].indexData = desc.Indices.Data;
+			linearEntries[i].checksum = CalcLinearChecksum( desc );
+		}
+
+		// Look up each mesh as if a model was created from it (the key is computed each time).
+		UINT  numMisses = 0;
+
+		mxTimer  timer;
+		for ( UINT i = 0; i < numMeshes; i++ )
+		{
+			const UINT * found = meshMap.Find( rxMeshKey( MakeMeshDescription( meshes[i] ) ) );
+			if ( found == null || *found != i ) {
+				numMisses++;
+			}
+		}
+		const FLOAT hashTime = ElapsedMilliseconds( timer );
+
+		timer.Reset();
+		for ( UINT i = 0; i < numMeshes; i++ )
+		{
+			if ( FindLinear( linearEntries, MakeMeshDescription( meshes[i] ) ) != (INT)i ) {
+				numMisses++;
+			}
+		}
+		const FLOAT linearTime = ElapsedMilliseconds( timer );
+
+		sys::Print( "%8u %12.3f %12.3f %10u\n", numMeshes, hashTime, linearTime, numMisses );
+
+		if ( numMisses ) {
+			sys::Print( "%u meshes: meshes with unchanged data have not been found\n", numMeshes );
+			bOk = false;
+		}
+
+		// Reuse the memory of every other mesh for new data, the old buffers must not be matched.
+		UINT  numStaleMatches = 0;
+		for ( UINT i = 0; i < numMeshes; i += 2 )
+		{
+			meshes[i].indices[ i % NUM_INDICES ] ^= 1;	// a single changed index
+
+			if ( meshMap.Contains( rxMeshKey( MakeMeshDescription( meshes[i] ) ) ) ) {
+				numStaleMatches++;
+			}
+			if ( ! meshMap.Contains( rxMeshKey( MakeMeshDescription( meshes[i + 1] ) ) ) ) {
+				numMisses++;
+			}
+		}
+
+		// The same data at another address is another mesh (its buffers are created separately).
+		TestMesh  copy( meshes[1] );
+		if ( meshMap.Contains( rxMeshKey( MakeMeshDescription( copy ) ) ) ) {
+			numStaleMatches++;
+		}
+
+		if ( numStaleMatches || numMisses ) {
+			sys::Print( "%u meshes: %u changed meshes matched, %u unchanged meshes not found\n",
+				numMeshes, numStaleMatches, numMisses );
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( SharedMeshLookup, "finding hardware buffers shared by models with the same mesh data" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
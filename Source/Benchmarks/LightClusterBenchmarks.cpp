@@ -0,0 +1,203 @@
+/*
+=============================================================================
+	File:	LightClusterBenchmarks.cpp
+	Desc:	Assignment of local lights to view frustum clusters.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_ITERATIONS	= 20,
+	NUM_SAMPLES		= 10000,	// points tested against all lights
+};
+
+const FLOAT NEAR_Z = 1.0f;
+const FLOAT FAR_Z = 1000.0f;
+
+// Points closer to the surface of a light volume than this fraction of its radius are not checked
+// (rounding errors of the cluster bounds are not considered misses).
+const FLOAT SAMPLE_MARGIN = 0.01f;
+
+struct TestLight
+{
+	Vec3D	position;
+	Vec3D	direction;
+	FLOAT	radius;
+	FLOAT	cosAngle;	// zero for point lights
+	bool	bSpot;
+};
+
+void SetupTestProjection( rxLightClusters & clusters, FLOAT &OutXScale, FLOAT &OutYScale )
+{
+	Matrix4  projection;
+	projection.BuildProjection( mxMath::HALF_PI, 16.0f / 9.0f, NEAR_Z, FAR_Z );
+
+	OutXScale = projection[0].x;
+	OutYScale = projection[1].y;
+	clusters.SetProjection( OutXScale, OutYScale, NEAR_Z, FAR_Z );
+}
+
+void CreateTestLights( UINT numLights, FLOAT xScale, FLOAT yScale, TArray< TestLight > &OutLights )
+{
+	OutLights.SetNum( numLights );
+
+	UINT32  seed = 97531 + numLights;
+	for ( UINT i = 0; i < numLights; i++ )
+	{
+		TestLight & light = OutLights[i];
+
+		// around the view frustum, some lights cross the near plane or lie outside
+		const FLOAT  z = BenchmarkRandomFloat( seed, -20.0f, FAR_Z * 0.5f );
+		const FLOAT  extent = Max( z, NEAR_Z ) * 1.2f;
+		light.position.Set(
+			BenchmarkRandomFloat( seed, -extent, extent ) / xScale,
+			BenchmarkRandomFloat( seed, -extent, extent ) / yScale,
+			z );
+		light.radius = BenchmarkRandomFloat( seed, 2.0f, 40.0f );
+
+		light.bSpot = ( i & 1 ) != 0;
+		if ( light.bSpot )
+		{
+			light.direction.Set(
+				BenchmarkRandomFloat( seed, -1.0f, 1.0f ),
+				BenchmarkRandomFloat( seed, -1.0f, 1.0f ),
+				BenchmarkRandomFloat( seed, -1.0f, 1.0f ) );
+			if ( light.direction.Normalize() < 1e-3f ) {
+				light.direction.Set( 0.0f, 0.0f, 1.0f );
+			}
+			light.cosAngle = BenchmarkRandomFloat( seed, 0.5f, 0.95f );
+		}
+		else
+		{
+			light.direction.Set( 0.0f, 0.0f, 0.0f );
+			light.cosAngle = 0.0f;
+		}
+	}
+}
+
+// Returns true if the point is inside the light volume by at least SAMPLE_MARGIN.
+bool IsPointLit( const TestLight& light, const Vec3D& point )
+{
+	const Vec3D  d( point - light.position );
+	const FLOAT  distance = d.Length();
+	const FLOAT  margin = light.radius * SAMPLE_MARGIN;
+
+	if ( distance > light.radius - margin ) {
+		return false;
+	}
+	if ( light.bSpot ) {
+		return ( d * light.direction ) > distance * light.cosAngle + margin;
+	}
+	return true;
+}
+
+bool IsLightInList( const UINT16* lights, UINT numLights, UINT lightIndex )
+{
+	for ( UINT i = 0; i < numLights; i++ ) {
+		if ( lights[i] == lightIndex ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//
+//	LightClusters - times rxLightClusters::Build() and checks that each light is listed
+//	in the clusters of random points inside its volume (computed without the cluster code).
+//
+bool LightClusters( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT lightCounts[] = { 256, 1024, 4096 };
+
+	rxLightClusters  clusters;
+
+	FLOAT  xScale, yScale;
+	SetupTestProjection( clusters, xScale, yScale );
+
+	sys::Print( "%u clusters, %u sample points\n", clusters.NumClusters(), (UINT)NUM_SAMPLES );
+	sys::Print( "%8s %10s %14s %8s\n", "lights", "build ms", "lights/cluster", "misses" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(lightCounts); iCount++ )
+	{
+		TArray< TestLight >  testLights;
+		CreateTestLights( lightCounts[ iCount ], xScale, yScale, testLights );
+
+		clusters.Clear();
+		for ( UINT i = 0; i < testLights.Num(); i++ )
+		{
+			const TestLight & light = testLights[i];
+			if ( light.bSpot ) {
+				clusters.AddSpotLight( light.position, light.direction, light.radius, light.cosAngle );
+			} else {
+				clusters.AddPointLight( light.position, light.radius );
+			}
+		}
+
+		mxTimer  timer;
+		for ( UINT iter = 0; iter < NUM_ITERATIONS; iter++ ) {
+			clusters.Build();
+		}
+		const FLOAT buildTime = ElapsedMilliseconds( timer ) / NUM_ITERATIONS;
+
+		if ( ! clusters.CheckAgainstReference() ) {
+			sys::Print( "%u lights: the results differ from the scalar tests\n", testLights.Num() );
+			bOk = false;
+		}
+
+		// Sample points inside the view frustum, depth is distributed like the slices.
+		UINT  numMisses = 0;
+		UINT32  seed = 8642;
+		for ( UINT iSample = 0; iSample < NUM_SAMPLES; iSample++ )
+		{
+			const FLOAT  z = NEAR_Z * mxMath::Pow( FAR_Z / NEAR_Z, BenchmarkRandomFloat( seed, 0.001f, 0.999f ) );
+			const Vec3D  point(
+				BenchmarkRandomFloat( seed, -0.999f, 0.999f ) * z / xScale,
+				BenchmarkRandomFloat( seed, -0.999f, 0.999f ) * z / yScale,
+				z );
+
+			UINT  numClusterLights;
+			const UINT16 * clusterLights = clusters.GetLights( clusters.FindCluster( point ), numClusterLights );
+
+			for ( UINT iLight = 0; iLight < testLights.Num(); iLight++ )
+			{
+				if ( IsPointLit( testLights[ iLight ], point )
+					&& ! IsLightInList( clusterLights, numClusterLights, iLight ) )
+				{
+					numMisses++;
+				}
+			}
+		}
+
+		const FLOAT  lightsPerCluster = (FLOAT) clusters.NumLightIndices() / clusters.NumClusters();
+
+		sys::Print( "%8u %10.3f %14.2f %8u\n",
+			testLights.Num(), buildTime, lightsPerCluster, numMisses );
+
+		if ( numMisses ) {
+			sys::Print( "%u lights: lit points in clusters which don't list the light\n", testLights.Num() );
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( LightClusters, "assignment of point and spot lights to view frustum clusters" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
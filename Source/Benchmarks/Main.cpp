@@ -0,0 +1,161 @@
+/*
+=============================================================================
+	File:	Main.cpp
+	Desc:	Command-line tool for running benchmarks.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <stdlib.h>
+
+namespace abc {
+
+namespace {
+
+	mxBenchmark *	gBenchmarks = null;
+
+}//End of anonymous namespace
+
+mxBenchmark::mxBenchmark( const char* theName, const char* theDescription, mxBenchmarkFunction* theFunction )
+	: name( theName )
+	, description( theDescription )
+	, function( theFunction )
+	, next( gBenchmarks )
+{
+	gBenchmarks = this;
+}
+
+mxBenchmark * mxBenchmark::Head()
+{
+	return gBenchmarks;
+}
+
+mxBenchmark * mxBenchmark::Find( const char* name )
+{
+	for ( mxBenchmark * benchmark = gBenchmarks; benchmark != null; benchmark = benchmark->next )
+	{
+		if ( String::Icmp( benchmark->name, name ) == 0 ) {
+			return benchmark;
+		}
+	}
+	return null;
+}
+
+FLOAT ElapsedMilliseconds( mxTimer & timer )
+{
+	return timer.GetTimeMicroseconds() * 0.001f;
+}
+
+UINT32 BenchmarkRandom( UINT32 & seed )
+{
+	// xorshift
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+FLOAT BenchmarkRandomFloat( UINT32 & seed, FLOAT minValue, FLOAT maxValue )
+{
+	const FLOAT  fraction = ( BenchmarkRandom( seed ) & 0xFFFFFF ) / (FLOAT)0x1000000;
+	return minValue + ( maxValue - minValue ) * fraction;
+}
+
+namespace {
+
+	volatile UINT32	gConsumedValue = 0;
+
+	bool	gEngineCreated = false;	// see BeginEngineBenchmark()
+
+}//End of anonymous namespace
+
+void BenchmarkConsume( UINT32 value )
+{
+	gConsumedValue += value;
+}
+
+bool BeginEngineBenchmark( const char* benchmarkName )
+{
+	if ( gEngineCreated ) {
+		sys::Print( "skipped: the engine has already been created, run 'Benchmarks %s' on its own\n", benchmarkName );
+		return false;
+	}
+	gEngineCreated = true;
+	return true;
+}
+
+void EvictFromFileCache( const mxChar* filename )
+{
+	// opening the file without buffering and closing it drops its pages from the cache
+	const HANDLE hFile = ::CreateFile( filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, NULL );
+	if ( hFile != INVALID_HANDLE_VALUE ) {
+		::CloseHandle( hFile );
+	}
+}
+
+}//End of namespace abc
+
+using namespace ::abc;
+
+namespace {
+
+void PrintUsage()
+{
+	sys::Print( "\nUsage: Benchmarks <name> [arguments]\n" );
+	sys::Print( "       Benchmarks all\n" );
+	sys::Print( "\nThe exit code is non-zero if a benchmark has failed its checks.\n" );
+	sys::Print( "\nBenchmarks:\n" );
+	for ( mxBenchmark * benchmark = mxBenchmark::Head(); benchmark != null; benchmark = benchmark->next ) {
+		sys::Print( "\t%s\t%s\n", benchmark->name, benchmark->description );
+	}
+}
+
+bool RunBenchmark( mxBenchmark & benchmark, const TArray< String >& args )
+{
+	sys::Print( "\n=== %s ===\n", benchmark.name );
+
+	const bool bOk = (*benchmark.function)( args );
+	if ( ! bOk ) {
+		sys::Print( "%s: FAILED\n", benchmark.name );
+	}
+	return bOk;
+}
+
+}//End of anonymous namespace
+
+int main( int argc, char *argv[] )
+{
+	if ( argc < 2 ) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	TArray< String >  args;
+	for ( int i = 2; i < argc; i++ ) {
+		args.Append( String( argv[i] ) );
+	}
+
+	// benchmarks which need arguments skip themselves when run all at once
+	if ( String::Icmp( argv[1], "all" ) == 0 )
+	{
+		bool  bOk = true;
+		for ( mxBenchmark * benchmark = mxBenchmark::Head(); benchmark != null; benchmark = benchmark->next ) {
+			bOk &= RunBenchmark( *benchmark, args );
+		}
+		return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	mxBenchmark * benchmark = mxBenchmark::Find( argv[1] );
+	if ( benchmark == null ) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	return RunBenchmark( *benchmark, args ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,391 @@
+/*
+=============================================================================
+	File:	MeshCacheBenchmarks.cpp
+	Desc:	Loading of meshes from binary mesh cache files.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+#include <MiniSG.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_MESHES		= 16,
+	MIN_VERTICES	= 32 * 1024,
+	MAX_VERTICES	= 64 * 1024,
+	NUM_ITERATIONS	= 5,	// warm loads
+};
+
+// Reads all vertex and index data of the mesh, a mapped mesh is only loaded from the file when accessed.
+UINT32 TouchMesh( const mxMesh* mesh )
+{
+	UINT32  sum = 0;
+
+	const UINT32 * vertexWords = reinterpret_cast< const UINT32* >( mesh->vertices );
+	const UINT  numVertexWords = mesh->numVertices * sizeof(rxVertex) / sizeof(UINT32);
+	for ( UINT i = 0; i < numVertexWords; i++ ) {
+		sum += vertexWords[i];
+	}
+	for ( UINT i = 0; i < mesh->numIndices; i++ ) {
+		sum += mesh->indices[i];
+	}
+	return sum;
+}
+
+mxMesh* MakeTestMesh( UINT32 & seed )
+{
+	mxMesh * mesh = MX_NEW mxMesh();
+
+	mesh->numVertices = MIN_VERTICES + BenchmarkRandom( seed ) % ( MAX_VERTICES - MIN_VERTICES );
+	mesh->vertices = MX_NEW rxVertex[ mesh->numVertices ];
+	for ( UINT i = 0; i < mesh->numVertices; i++ )
+	{
+		for ( UINT iComponent = 0; iComponent < sizeof(rxVertex) / sizeof(FLOAT); iComponent++ ) {
+			mesh->vertices[i][ iComponent ] = BenchmarkRandomFloat( seed, -100.0f, 100.0f );
+		}
+	}
+
+	mesh->numIndices = mesh->numVertices * 3;
+	mesh->indices = MX_NEW rxIndex[ mesh->numIndices ];
+	for ( UINT i = 0; i < mesh->numIndices; i++ ) {
+		mesh->indices[i] = (rxIndex)( BenchmarkRandom( seed ) % mesh->numVertices );
+	}
+
+	mesh->RecalculateBounds();
+	return mesh;
+}
+
+bool IsSameMesh( const mxMesh* a, const mxMesh* b )
+{
+	return ( a->numVertices == b->numVertices )
+		&& ( a->numIndices == b->numIndices )
+		&& ( memcmp( a->vertices, b->vertices, a->numVertices * sizeof(rxVertex) ) == 0 )
+		&& ( memcmp( a->indices, b->indices, a->numIndices * sizeof(rxIndex) ) == 0 )
+		&& ( a->bounds.GetMin() == b->bounds.GetMin() )
+		&& ( a->bounds.GetMax() == b->bounds.GetMax() )
+		&& ( a->sphere.GetOrigin() == b->sphere.GetOrigin() )
+		&& ( a->sphere.GetRadius() == b->sphere.GetRadius() )
+		;
+}
+
+//
+//	The loading of a binary file without mapping: the vertices and indices are read into new arrays.
+//
+mxMesh* ReadMeshCopy( const mxChar* filename )
+{
+	FILE * file = fopen( filename, "rb" );
+	if ( ! file ) {
+		return null;
+	}
+
+	mxMeshCacheHeader  header;
+	if ( fread( &header, sizeof(header), 1, file ) != 1 ) {
+		fclose( file );
+		return null;
+	}
+
+	mxMesh * mesh = MX_NEW mxMesh();
+	mesh->numVertices = header.numVertices;
+	mesh->vertices = MX_NEW rxVertex[ header.numVertices ];
+	mesh->numIndices = header.numIndices;
+	mesh->indices = MX_NEW rxIndex[ header.numIndices ];
+
+	fseek( file, header.verticesOffset, SEEK_SET );
+	fread( mesh->vertices, sizeof(rxVertex), header.numVertices, file );
+	fseek( file, header.indicesOffset, SEEK_SET );
+	fread( mesh->indices, sizeof(rxIndex), header.numIndices, file );
+	fclose( file );
+
+	mesh->bounds.GetMin() = header.boundsMin;
+	mesh->bounds.GetMax() = header.boundsMax;
+	mesh->sphere.SetOrigin( header.sphereCenter );
+	mesh->sphere.SetRadius( header.sphereRadius );
+	return mesh;
+}
+
+// Returns the time in milliseconds, or a negative value if a mesh could not be loaded.
+FLOAT MeasureMappedLoad( const TArray< String >& fileNames, const mxMeshCacheKey& key, UINT32 &OutSum )
+{
+	mxTimer  timer;
+	for ( UINT i = 0; i < fileNames.Num(); i++ )
+	{
+		const mxMeshPtr  mesh( LoadMeshCache( fileNames[i].ToChar(), key ) );
+		if ( mesh == null ) {
+			return -1.0f;
+		}
+		OutSum += TouchMesh( mesh );
+	}
+	return ElapsedMilliseconds( timer );
+}
+
+FLOAT MeasureCopyLoad( const TArray< String >& fileNames, UINT32 &OutSum )
+{
+	mxTimer  timer;
+	for ( UINT i = 0; i < fileNames.Num(); i++ )
+	{
+		const mxMeshPtr  mesh( ReadMeshCopy( fileNames[i].ToChar() ) );
+		if ( mesh == null ) {
+			return -1.0f;
+		}
+		OutSum += TouchMesh( mesh );
+	}
+	return ElapsedMilliseconds( timer );
+}
+
+//
+//	Writes generated meshes into cache files in the temporary folder and loads them back.
+//
+bool MeasureGeneratedMeshes()
+{
+	mxChar  tempPath[ sys::MAX_PATH_CHARS ];
+	if ( ! ::GetTempPath( ARRAY_SIZE(tempPath), tempPath ) ) {
+		sys::Print( "failed to get the temporary folder\n" );
+		return false;
+	}
+
+	mxMeshCacheKey  key;
+	key.sourceTimestamp = 0x12345678;
+	key.optionsHash = 0xBE7C4;
+
+	TArray< mxMeshPtr >  meshes;
+	TArray< String >  fileNames;
+	meshes.SetNum( NUM_MESHES );
+	fileNames.SetNum( NUM_MESHES );
+
+	UINT32  seed = 13579;
+	UINT32  expectedSum = 0;
+	SizeT  totalBytes = 0;
+	bool  bOk = true;
+
+	for ( UINT i = 0; i < NUM_MESHES; i++ )
+	{
+		meshes[i] = MakeTestMesh( seed );
+		expectedSum += TouchMesh( meshes[i] );
+		totalBytes += meshes[i]->numVertices * sizeof(rxVertex) + meshes[i]->numIndices * sizeof(rxIndex);
+
+		_sprintf( fileNames[i], "%sbenchmark_mesh_%u.mesh", tempPath, i );
+		bOk &= SaveMeshCache( meshes[i], fileNames[i].ToChar(), key );
+	}
+
+	if ( ! bOk ) {
+		sys::Print( "failed to write mesh cache files into '%s'\n", tempPath );
+	}
+
+	FLOAT  coldTime = -1.0f;
+	FLOAT  warmTime = -1.0f;
+	FLOAT  copyTime = -1.0f;
+	UINT32  coldSum = 0;
+	UINT32  warmSum = 0;
+	UINT32  copySum = 0;
+
+	if ( bOk )
+	{
+		for ( UINT i = 0; i < fileNames.Num(); i++ ) {
+			EvictFromFileCache( fileNames[i].ToChar() );
+		}
+		coldTime = MeasureMappedLoad( fileNames, key, coldSum );
+
+		warmTime = 0.0f;
+		for ( UINT iter = 0; iter < NUM_ITERATIONS && warmTime >= 0.0f; iter++ )
+		{
+			UINT32  sum = 0;
+			const FLOAT  time = MeasureMappedLoad( fileNames, key, sum );
+			warmTime = ( time >= 0.0f ) ? warmTime + time / NUM_ITERATIONS : time;
+			warmSum = sum;
+		}
+
+		copyTime = 0.0f;
+		for ( UINT iter = 0; iter < NUM_ITERATIONS && copyTime >= 0.0f; iter++ )
+		{
+			UINT32  sum = 0;
+			const FLOAT  time = MeasureCopyLoad( fileNames, sum );
+			copyTime = ( time >= 0.0f ) ? copyTime + time / NUM_ITERATIONS : time;
+			copySum = sum;
+		}
+	}
+
+	const FLOAT  totalMB = (FLOAT) totalBytes / ( 1024.0f * 1024.0f );
+
+	sys::Print( "%u generated meshes, %.1f MB\n", (UINT)NUM_MESHES, totalMB );
+	sys::Print( "%14s %14s %14s\n", "cold map ms", "warm map ms", "warm read ms" );
+	sys::Print( "%14.3f %14.3f %14.3f\n", coldTime, warmTime, copyTime );
+	if ( warmTime > 0.0f ) {
+		sys::Print( "warm mapped loads: %.1f MB/s\n", totalMB * 1000.0f / warmTime );
+	}
+
+	if ( bOk && ( coldTime < 0.0f || warmTime < 0.0f || copyTime < 0.0f ) ) {
+		sys::Print( "valid mesh cache files could not be loaded\n" );
+		bOk = false;
+	}
+	if ( bOk && ( coldSum != expectedSum || warmSum != expectedSum || copySum != expectedSum ) ) {
+		sys::Print( "loaded mesh data differs from the saved data\n" );
+		bOk = false;
+	}
+
+	if ( bOk )
+	{
+		UINT  numErrors = 0;
+		for ( UINT i = 0; i < NUM_MESHES; i++ )
+		{
+			const mxMeshPtr  mesh( LoadMeshCache( fileNames[i].ToChar(), key ) );
+			if ( mesh == null || mesh->storage == null || ! IsSameMesh( mesh, meshes[i] ) ) {
+				numErrors++;
+			}
+		}
+
+		// files from other source data or import options must be rejected
+		mxMeshCacheKey  otherKey( key );
+		otherKey.optionsHash++;
+		if ( mxMeshPtr( LoadMeshCache( fileNames[0].ToChar(), otherKey ) ) != null ) {
+			numErrors++;
+		}
+		otherKey = key;
+		otherKey.sourceTimestamp++;
+		if ( mxMeshPtr( LoadMeshCache( fileNames[0].ToChar(), otherKey ) ) != null ) {
+			numErrors++;
+		}
+
+		if ( numErrors ) {
+			sys::Print( "%u mesh cache files have been loaded incorrectly\n", numErrors );
+			bOk = false;
+		}
+	}
+
+	for ( UINT i = 0; i < fileNames.Num(); i++ ) {
+		::DeleteFile( fileNames[i].ToChar() );
+	}
+
+	return bOk;
+}
+
+//
+//	Loads all meshes in the folder with LoadMeshFromFile(), which imports them and writes cache files
+//	the first time, then loads them again from the (warm and evicted) cache files.
+//
+bool MeasureMeshFolder( const String& folder )
+{
+	String  searchPattern;
+	_sprintf( searchPattern, "%s/*", folder.ToChar() );
+
+	TArray< String >  sourceFiles;
+	TArray< String >  cacheFiles;
+
+	WIN32_FIND_DATA  findData;
+	const HANDLE hFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+	if ( hFind != INVALID_HANDLE_VALUE )
+	{
+		do
+		{
+			if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+				continue;
+			}
+			String  fileName;
+			_sprintf( fileName, "%s/%s", folder.ToChar(), findData.cFileName );
+
+			const mxChar * extension = strrchr( findData.cFileName, '.' );
+			if ( extension && ( String::Icmp( extension, ".mesh" ) == 0 || String::Icmp( extension, ".tmp" ) == 0 ) ) {
+				continue;
+			}
+			sourceFiles.Append( fileName );
+		}
+		while ( ::FindNextFile( hFind, &findData ) );
+
+		::FindClose( hFind );
+	}
+
+	if ( sourceFiles.Num() == 0 ) {
+		sys::Print( "no files found in '%s'\n", folder.ToChar() );
+		return false;
+	}
+
+	FLOAT  passTimes[3];
+	UINT32  passSums[3];
+	UINT  numLoaded = 0;
+	UINT  numMapped = 0;
+
+	for ( UINT iPass = 0; iPass < ARRAY_SIZE(passTimes); iPass++ )
+	{
+		if ( iPass == 2 )
+		{
+			// the cache files of the folder have been written during the first pass
+			_sprintf( searchPattern, "%s/*.mesh", folder.ToChar() );
+			const HANDLE hCacheFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+			if ( hCacheFind != INVALID_HANDLE_VALUE )
+			{
+				do
+				{
+					String  fileName;
+					_sprintf( fileName, "%s/%s", folder.ToChar(), findData.cFileName );
+					EvictFromFileCache( fileName.ToChar() );
+				}
+				while ( ::FindNextFile( hCacheFind, &findData ) );
+
+				::FindClose( hCacheFind );
+			}
+		}
+
+		passSums[ iPass ] = 0;
+		numLoaded = 0;
+		numMapped = 0;
+
+		mxTimer  timer;
+		for ( UINT i = 0; i < sourceFiles.Num(); i++ )
+		{
+			const mxMeshPtr  mesh( LoadMeshFromFile( sourceFiles[i].ToChar() ) );
+			if ( mesh != null )
+			{
+				passSums[ iPass ] += TouchMesh( mesh );
+				numLoaded++;
+				if ( mesh->storage != null ) {
+					numMapped++;
+				}
+			}
+		}
+		passTimes[ iPass ] = ElapsedMilliseconds( timer );
+	}
+
+	sys::Print( "'%s': %u files, %u meshes, %u of them from the mesh cache\n",
+		folder.ToChar(), sourceFiles.Num(), numLoaded, numMapped );
+	sys::Print( "%14s %14s %14s\n", "first load ms", "warm cache ms", "cold cache ms" );
+	sys::Print( "%14.3f %14.3f %14.3f\n", passTimes[0], passTimes[1], passTimes[2] );
+
+	if ( numMapped != numLoaded ) {
+		sys::Print( "%u meshes have not been loaded from the mesh cache\n", numLoaded - numMapped );
+		return false;
+	}
+	if ( passSums[1] != passSums[0] || passSums[2] != passSums[0] ) {
+		sys::Print( "cached meshes differ from the imported meshes\n" );
+		return false;
+	}
+	return true;
+}
+
+//
+//	MeshCacheLoad - times cold (evicted from the system file cache) and warm loads of mapped mesh cache files,
+//	compares them with reading the same files into memory and checks the loaded meshes.
+//	Usage: MeshCacheLoad [folder with source meshes]
+//
+bool MeshCacheLoad( const TArray< String >& args )
+{
+	bool  bOk = MeasureGeneratedMeshes();
+
+	if ( args.Num() > 0 ) {
+		bOk &= MeasureMeshFolder( args[0] );
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( MeshCacheLoad, "cold and warm loads of memory-mapped mesh cache files [folder]" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
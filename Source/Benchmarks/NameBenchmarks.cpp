@@ -0,0 +1,230 @@
+/*
+=============================================================================
+	File:	NameBenchmarks.cpp
+	Desc:	Interning of names and lookups by name handles.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <process.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_LOOKUPS			= 1000000,
+	NUM_THREADS			= 4,
+	NUM_SHARED_NAMES	= 10000,	// interned by all threads at once
+};
+
+void MakeNames( const char* prefix, UINT numNames, TArray< String > &OutNames )
+{
+	OutNames.SetNum( numNames );
+	for ( UINT i = 0; i < numNames; i++ ) {
+		OutNames[i] = String( prefix ) + String( (int) i );
+	}
+}
+
+// Returns the number of names which are not stored correctly.
+UINT CheckNames( const TArray< String >& names, const TArray< mxNameId >& ids )
+{
+	UINT  numErrors = 0;
+	for ( UINT i = 0; i < names.Num(); i++ )
+	{
+		const mxNameId & id = ids[i];
+		if ( id.IsEmpty()
+			|| String::Cmp( id.ToChar(), names[i].c_str() ) != 0
+			|| id.Length() != (mxUInt) names[i].Length()
+			|| id.GetHash() != mxHashString( names[i].c_str() )
+			|| mxNameId( names[i].c_str() ) != id
+			|| mxNameId::Find( names[i].c_str() ) != id )
+		{
+			numErrors++;
+		}
+	}
+	return numErrors;
+}
+
+struct InternContext
+{
+	const TArray< String > *	names;
+	TArray< mxNameId >			ids;
+	HANDLE						startEvent;
+};
+
+unsigned int __stdcall InternThreadFunc( void* param )
+{
+	InternContext & context = *static_cast< InternContext* >( param );
+
+	::WaitForSingleObject( context.startEvent, INFINITE );
+
+	const TArray< String > & names = *context.names;
+	for ( UINT i = 0; i < names.Num(); i++ ) {
+		context.ids[i] = mxNameId( names[i].c_str() );
+	}
+	return 0;
+}
+
+// Interns the same names on several threads, all threads must get the same handles.
+bool CheckConcurrentInterning()
+{
+	TArray< String >  names;
+	MakeNames( "benchmark_shared_name_", NUM_SHARED_NAMES, names );
+
+	const mxUInt  numNamesBefore = mxNameId::NumNames();
+
+	InternContext	contexts[ NUM_THREADS ];
+	HANDLE			threads[ NUM_THREADS ];
+
+	const HANDLE startEvent = ::CreateEvent( NULL, TRUE, FALSE, NULL );
+
+	for ( UINT iThread = 0; iThread < NUM_THREADS; iThread++ )
+	{
+		contexts[ iThread ].names = &names;
+		contexts[ iThread ].ids.SetNum( names.Num() );
+		contexts[ iThread ].startEvent = startEvent;
+
+		threads[ iThread ] = (HANDLE) ::_beginthreadex( NULL, 0, &InternThreadFunc, &contexts[ iThread ], 0, NULL );
+		Assert( threads[ iThread ] != NULL );
+	}
+
+	::SetEvent( startEvent );
+	::WaitForMultipleObjects( NUM_THREADS, threads, TRUE, INFINITE );
+
+	for ( UINT iThread = 0; iThread < NUM_THREADS; iThread++ ) {
+		::CloseHandle( threads[ iThread ] );
+	}
+	::CloseHandle( startEvent );
+
+	UINT  numErrors = CheckNames( names, contexts[0].ids );
+	for ( UINT iThread = 1; iThread < NUM_THREADS; iThread++ )
+	{
+		for ( UINT i = 0; i < names.Num(); i++ ) {
+			if ( contexts[ iThread ].ids[i] != contexts[0].ids[i] ) {
+				numErrors++;
+			}
+		}
+	}
+
+	const mxUInt  numAdded = mxNameId::NumNames() - numNamesBefore;
+	if ( numErrors || numAdded != NUM_SHARED_NAMES ) {
+		sys::Print( "%u threads: %u wrong handles, %u names added instead of %u\n",
+			(UINT)NUM_THREADS, numErrors, numAdded, (UINT)NUM_SHARED_NAMES );
+		return false;
+	}
+	return true;
+}
+
+//
+//	NameLookup - times interning of names and lookups in maps keyed by strings (as resources were before)
+//	and by name handles, from strings and from handles. Checks the name table, also when used by several threads.
+//
+bool NameLookup( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT nameCounts[] = { 1000, 100000 };
+
+	sys::Print( "%u lookups per pass\n", (UINT)NUM_LOOKUPS );
+	sys::Print( "%8s %10s %12s %12s %12s %8s\n",
+		"names", "intern ms", "string ms", "find id ms", "by id ms", "errors" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(nameCounts); iCount++ )
+	{
+		const UINT  numNames = nameCounts[ iCount ];
+
+		// a different prefix for each pass, names are never removed from the table
+		TArray< String >  names;
+		MakeNames( ( String( "benchmark_name_" ) + String( (int) numNames ) + String( "_" ) ).c_str(), numNames, names );
+
+		const mxUInt  numNamesBefore = mxNameId::NumNames();
+
+		TArray< mxNameId >  ids;
+		ids.SetNum( numNames );
+
+		mxTimer  timer;
+		for ( UINT i = 0; i < numNames; i++ ) {
+			ids[i] = mxNameId( names[i].c_str() );
+		}
+		const FLOAT internTime = ElapsedMilliseconds( timer );
+
+		UINT  numErrors = CheckNames( names, ids );
+		if ( mxNameId::NumNames() - numNamesBefore != numNames ) {
+			numErrors++;
+		}
+
+		THashMap< String, UINT >  stringMap;
+		THashMap< mxNameId, UINT >  idMap;
+		for ( UINT i = 0; i < numNames; i++ ) {
+			stringMap.Set( names[i], i );
+			idMap.Set( ids[i], i );
+		}
+
+		TArray< UINT >  lookups;
+		lookups.SetNum( NUM_LOOKUPS );
+		UINT32  seed = 2468 + numNames;
+		for ( UINT i = 0; i < NUM_LOOKUPS; i++ ) {
+			lookups[i] = BenchmarkRandom( seed ) % numNames;
+		}
+
+		UINT32  sum = 0;
+
+		timer.Reset();
+		for ( UINT i = 0; i < NUM_LOOKUPS; i++ ) {
+			sum += *stringMap.Find( names[ lookups[i] ].c_str() );
+		}
+		const FLOAT stringTime = ElapsedMilliseconds( timer );
+
+		timer.Reset();
+		for ( UINT i = 0; i < NUM_LOOKUPS; i++ ) {
+			sum += *idMap.Find( mxNameId::Find( names[ lookups[i] ].c_str() ) );
+		}
+		const FLOAT findIdTime = ElapsedMilliseconds( timer );
+
+		timer.Reset();
+		for ( UINT i = 0; i < NUM_LOOKUPS; i++ ) {
+			sum += *idMap.Find( ids[ lookups[i] ] );
+		}
+		const FLOAT byIdTime = ElapsedMilliseconds( timer );
+
+		BenchmarkConsume( sum );
+
+		// looking up unknown names must not add them to the table
+		const mxUInt  numNamesAfter = mxNameId::NumNames();
+		for ( UINT i = 0; i < numNames; i += 16 )
+		{
+			const String  unknown( names[i] + String( "_unknown" ) );
+			if ( ! mxNameId::Find( unknown.c_str() ).IsEmpty() ) {
+				numErrors++;
+			}
+		}
+		if ( mxNameId::NumNames() != numNamesAfter ) {
+			numErrors++;
+		}
+
+		sys::Print( "%8u %10.3f %12.3f %12.3f %12.3f %8u\n",
+			numNames, internTime, stringTime, findIdTime, byIdTime, numErrors );
+
+		if ( numErrors ) {
+			sys::Print( "%u names: the name table is wrong\n", numNames );
+			bOk = false;
+		}
+	}
+
+	bOk &= CheckConcurrentInterning();
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( NameLookup, "interning of names and lookups by strings and by name handles" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,194 @@
+/*
+=============================================================================
+	File:	NullRendererBenchmarks.cpp
+	Desc:	Runs the whole engine headless with the null render system.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+#include <MiniSG.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	GRID_SIZE		= 16,		// boxes along each axis
+	NUM_MATERIALS	= 32,
+	NUM_LIGHTS		= 256,
+	NUM_FRAMES		= 500,
+};
+
+const FLOAT BOX_SPACING = 4.0f;
+
+//
+//	NullRenderTestApp - fills the scene with boxes and lights and collects renderer statistics after each frame.
+//
+class NullRenderTestApp : public mxApplication
+{
+public:
+	mxUInt	numFrames;
+
+	// statistics of the first frame, all other frames must give the same numbers
+	rxStatistics	firstFrameStats;
+	mxUInt			numMismatchedFrames;
+
+	mxTimer		timer;	// started before the first frame
+
+public:
+	NullRenderTestApp()
+		: numFrames( 0 )
+		, numMismatchedFrames( 0 )
+	{}
+
+	override( mxApplication ) bool Create()
+	{
+		mxEngine & engine( mxEngine::get() );
+		rxResources & resources = engine.GetRenderer().GetResources();
+
+		this->scene = engine.CreateScene();
+		this->sceneMgr = new SceneGraph( this->scene );
+
+		// look along the diagonal of the grid
+		mxCamera & camera = this->scene->GetActiveCamera();
+		camera.SetPosition( Vec3D( -BOX_SPACING, -BOX_SPACING, -BOX_SPACING ) );
+		camera.SetLookAt( Vec3D( 1.0f, 1.0f, 1.0f ).GetNormalized() );
+
+		rxMaterial *	materials[ NUM_MATERIALS ];
+		for ( mxUInt iMaterial = 0; iMaterial < NUM_MATERIALS; iMaterial++ )
+		{
+			rxMaterialDescription  desc;
+			desc.name = String( "benchmark_material_" ) + String( (int) iMaterial );
+			materials[ iMaterial ] = resources.CreateMaterial( desc );
+		}
+
+		UINT32  seed = 4321;
+		for ( mxUInt iBox = 0; iBox < GRID_SIZE * GRID_SIZE * GRID_SIZE; iBox++ )
+		{
+			Model * box = this->sceneMgr->AddBox( 1.0f, 1.0f, 1.0f );
+			box->SetOrigin( Vec3D(
+				BOX_SPACING * ( iBox % GRID_SIZE ),
+				BOX_SPACING * ( ( iBox / GRID_SIZE ) % GRID_SIZE ),
+				BOX_SPACING * ( iBox / ( GRID_SIZE * GRID_SIZE ) ) ) );
+			box->SetMaterial( materials[ BenchmarkRandom( seed ) % NUM_MATERIALS ] );
+		}
+
+		const FLOAT  gridExtent = BOX_SPACING * GRID_SIZE;
+		for ( mxUInt iLight = 0; iLight < NUM_LIGHTS; iLight++ )
+		{
+			LightCreationInfo  cInfo;
+			cInfo.Type		= ( iLight & 1 ) ? ELightType::Light_Spot : ELightType::Light_Point;
+			cInfo.Position	= Vec3D(
+				BenchmarkRandomFloat( seed, 0.0f, gridExtent ),
+				BenchmarkRandomFloat( seed, 0.0f, gridExtent ),
+				BenchmarkRandomFloat( seed, 0.0f, gridExtent ) );
+			cInfo.Direction	= Vec3D( 0.0f, -1.0f, 0.0f );
+			cInfo.Range		= BenchmarkRandomFloat( seed, BOX_SPACING, BOX_SPACING * 4.0f );
+			cInfo.bCastShadows = false;
+
+			this->sceneMgr->AddLight( cInfo );
+		}
+
+		return true;
+	}
+
+	override( mxApplication ) void Loaded()
+	{
+		this->timer.Reset();
+	}
+
+	override( mxApplication ) void Destroy()
+	{
+		this->scene = null;
+		this->sceneMgr = null;
+	}
+
+	override( mxApplication ) void PostFrame( const mxTime elapsedTime )
+	{
+		(void) elapsedTime;
+
+		const rxStatistics & stats = mxEngine::get().GetRenderer().GetStats();
+
+		if ( this->numFrames == 0 ) {
+			this->firstFrameStats = stats;
+		}
+		else if ( stats.numEntities != firstFrameStats.numEntities
+			|| stats.numBatches != firstFrameStats.numBatches
+			|| stats.numMaterialChanges != firstFrameStats.numMaterialChanges )
+		{
+			this->numMismatchedFrames++;
+		}
+
+		this->numFrames++;
+	}
+
+private:
+	TPtr< mxScene >			scene;
+	RefPtr< SceneGraph >	sceneMgr;
+};
+
+//
+//	RenderNull - creates the engine with the null render system (no window, no GPU),
+//	renders a static scene for a fixed number of frames and checks that all frames give the same statistics.
+//
+bool RenderNull( const TArray< String >& args )
+{
+	(void) args;
+
+	if ( ! BeginEngineBenchmark( "RenderNull" ) ) {
+		return true;
+	}
+
+	// the system keeps a pointer to the application until the process exits
+	NullRenderTestApp * app = new NullRenderTestApp();
+
+	mxSystemCreationInfo  cInfo;
+	cInfo.pUserApp = app;
+	cInfo.driverType = EDriverType::GAPI_None;
+	cInfo.numFramesToRun = NUM_FRAMES;
+
+	mxEngine * engine = CreateEngine( cInfo );
+	if ( engine == null ) {
+		sys::Print( "failed to create the engine with the null render system\n" );
+		return false;
+	}
+
+	engine->Run();
+
+	const FLOAT  frameTime = ElapsedMilliseconds( app->timer ) / Max< mxUInt >( app->numFrames, 1 );
+	const rxStatistics & stats = app->firstFrameStats;
+
+	sys::Print( "%u boxes, %u lights, %u materials, %u frames\n",
+		(mxUInt)( GRID_SIZE * GRID_SIZE * GRID_SIZE ), (mxUInt)NUM_LIGHTS, (mxUInt)NUM_MATERIALS, app->numFrames );
+	sys::Print( "%10s %10s %10s %12s\n", "frame ms", "entities", "batches", "mtl. binds" );
+	sys::Print( "%10.3f %10u %10u %12u\n",
+		frameTime, stats.numEntities, stats.numBatches, stats.numMaterialChanges );
+
+	bool  bOk = true;
+
+	if ( app->numFrames != NUM_FRAMES ) {
+		sys::Print( "rendered %u frames instead of %u\n", app->numFrames, (mxUInt)NUM_FRAMES );
+		bOk = false;
+	}
+	if ( stats.numEntities == 0 || stats.numBatches == 0 ) {
+		sys::Print( "nothing has been drawn\n" );
+		bOk = false;
+	}
+	if ( app->numMismatchedFrames ) {
+		sys::Print( "%u frames of a static scene differ from the first one\n", app->numMismatchedFrames );
+		bOk = false;
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( RenderNull, "whole engine frames with the null render system, headless" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
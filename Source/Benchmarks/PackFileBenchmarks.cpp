@@ -0,0 +1,297 @@
+/*
+=============================================================================
+	File:	PackFileBenchmarks.cpp
+	Desc:	Opening and reading files through the file system, from pack files and loose files.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <stdio.h>
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_OPEN_ITERATIONS		= 20,
+	NUM_READ_ITERATIONS		= 5,
+};
+
+// Adds names of files in the folder and its subfolders, relative to the root folder.
+void CollectFiles( const String& rootFolder, const String& relativePath, TArray< String > &OutFileNames )
+{
+	String  searchPattern;
+	_sprintf( searchPattern, "%s%s*", rootFolder.ToChar(), relativePath.ToChar() );
+
+	WIN32_FIND_DATA  findData;
+	const HANDLE hFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+	if ( hFind == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+	do
+	{
+		if ( findData.cFileName[0] == '.' ) {
+			continue;
+		}
+		String  relativeName( relativePath );
+		relativeName.Append( findData.cFileName );
+
+		if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+			relativeName.Append( '/' );
+			CollectFiles( rootFolder, relativeName, OutFileNames );
+		} else {
+			OutFileNames.Append( relativeName );
+		}
+	}
+	while ( ::FindNextFile( hFind, &findData ) );
+
+	::FindClose( hFind );
+}
+
+// Reads the file directly, without the file system.
+bool ReadLooseFile( const String& fileName, TArray< BYTE > &OutData )
+{
+	FILE * file = fopen( fileName.ToChar(), "rb" );
+	if ( ! file ) {
+		return false;
+	}
+	fseek( file, 0, SEEK_END );
+	OutData.SetNum( (UINT) ftell( file ) );
+	fseek( file, 0, SEEK_SET );
+	const bool bOk = ( fread( OutData.Ptr(), 1, OutData.Num(), file ) == OutData.Num() );
+	fclose( file );
+	return bOk;
+}
+
+FLOAT MegabytesPerSecond( UINT64 numBytes, FLOAT milliseconds )
+{
+	return (FLOAT) numBytes / ( 1024.0f * 1024.0f ) / ( Max( milliseconds, 0.001f ) * 0.001f );
+}
+
+struct PackFileTest
+{
+	TArray< String >	fileNames;		// relative to the root folder
+	TArray< UINT32 >	checksums;		// of the loose files, read without the file system
+	mxUInt				maxFileSize;
+	UINT64				totalBytes;
+};
+
+//
+//	Opens and reads the files through mxFileSystem::OpenFile() and prints a row of the table.
+//	Returns the number of files which could not be read or whose contents differ from the loose files.
+//
+UINT MeasureOpenFile( const char* source, const PackFileTest& test )
+{
+	mxFileSystem & fileSystem = mxEngine::get().GetFileSystem();
+	const UINT  numFiles = test.fileNames.Num();
+
+	TArray< BYTE >  buffer;
+	buffer.SetNum( test.maxFileSize + 1 );
+
+	// lookups: opening without reading (compressed entries are decompressed when opened)
+	mxTimer  openTimer;
+	for ( UINT iter = 0; iter < NUM_OPEN_ITERATIONS; iter++ )
+	{
+		for ( UINT i = 0; i < numFiles; i++ )
+		{
+			mxDataStream * file = fileSystem.OpenFile( test.fileNames[i].ToChar() );
+			if ( file ) {
+				BenchmarkConsume( (UINT32) file->GetSize() );
+				MX_FREE( file );
+			}
+		}
+	}
+	const FLOAT  openTime = ElapsedMilliseconds( openTimer );
+
+	// reads of whole files, the first pass is checked against the loose files
+	UINT  numErrors = 0;
+	mxTimer  readTimer;
+	for ( UINT iter = 0; iter < NUM_READ_ITERATIONS; iter++ )
+	{
+		for ( UINT i = 0; i < numFiles; i++ )
+		{
+			mxDataStream * file = fileSystem.OpenFile( test.fileNames[i].ToChar() );
+			if ( ! file ) {
+				numErrors += ( iter == 0 );
+				continue;
+			}
+			const SizeT  size = file->GetSize();
+			const SizeT  numRead = ( size <= test.maxFileSize ) ? file->Read( buffer.Ptr(), size ) : 0;
+			MX_FREE( file );
+
+			if ( iter == 0 && ( numRead != size || mxHashBytes( buffer.Ptr(), numRead ) != test.checksums[i] ) ) {
+				numErrors++;
+			}
+		}
+	}
+	const FLOAT  readTime = ElapsedMilliseconds( readTimer );
+
+	sys::Print( "%12s %14.2f %10.1f %10.1f %8u\n", source,
+		openTime * 1000.0f / ( NUM_OPEN_ITERATIONS * Max< UINT >( numFiles, 1 ) ),
+		readTime / NUM_READ_ITERATIONS,
+		MegabytesPerSecond( test.totalBytes * NUM_READ_ITERATIONS, readTime ),
+		numErrors );
+
+	return numErrors;
+}
+
+//
+//	Packs the folder into a stored and a compressed archive in the temporary folder
+//	and reads the files through the file system from each archive and then as loose files.
+//	The archives stay mapped by the file system until the process exits,
+//	so they are overwritten by the next run instead of being deleted.
+//
+bool MeasurePackFiles( const String& folder )
+{
+	String  rootFolder( folder );
+	const mxChar lastChar = rootFolder.IsEmpty() ? '\0' : rootFolder[ rootFolder.Length() - 1 ];
+	if ( lastChar != '/' && lastChar != '\\' ) {
+		rootFolder.Append( '/' );
+	}
+
+	mxChar  tempPath[ sys::MAX_PATH_CHARS ];
+	if ( ! ::GetTempPath( ARRAY_SIZE(tempPath), tempPath ) ) {
+		sys::Print( "failed to get the temporary folder\n" );
+		return false;
+	}
+
+	mxFileSystem & fileSystem = mxEngine::get().GetFileSystem();
+
+	TArray< String >  allFiles;
+	CollectFiles( rootFolder, String(), allFiles );
+
+	PackFileTest  test;
+	test.maxFileSize = 0;
+	test.totalBytes = 0;
+
+	TArray< BYTE >  fileData;
+	UINT  numShadowed = 0;
+	for ( UINT i = 0; i < allFiles.Num(); i++ )
+	{
+		// files which the file system already finds elsewhere (e.g. in the current folder) would override the packed ones
+		if ( fileSystem.FileExists( mxFilePath( allFiles[i].ToChar() ) ) ) {
+			numShadowed++;
+			continue;
+		}
+		if ( ! ReadLooseFile( rootFolder + allFiles[i], fileData ) ) {
+			continue;
+		}
+		test.fileNames.Append( allFiles[i] );
+		test.checksums.Append( mxHashBytes( fileData.Ptr(), fileData.Num() ) );
+		test.maxFileSize = Max< mxUInt >( test.maxFileSize, fileData.Num() );
+		test.totalBytes += fileData.Num();
+	}
+
+	if ( test.fileNames.IsEmpty() ) {
+		sys::Print( "no files to pack in '%s'\n", rootFolder.ToChar() );
+		return false;
+	}
+
+	String  storedArchive;
+	String  compressedArchive;
+	_sprintf( storedArchive, "%sbenchmark_stored.pak", tempPath );
+	_sprintf( compressedArchive, "%sbenchmark_compressed.pak", tempPath );
+
+	if ( ! mxWritePackFile( storedArchive.ToChar(), rootFolder.ToChar(), test.fileNames, false )
+		|| ! mxWritePackFile( compressedArchive.ToChar(), rootFolder.ToChar(), test.fileNames, true ) )
+	{
+		sys::Print( "failed to write the archives into '%s'\n", tempPath );
+		return false;
+	}
+
+	sys::Print( "%u files, %.1f MB", test.fileNames.Num(), (FLOAT) test.totalBytes / ( 1024.0f * 1024.0f ) );
+	if ( numShadowed ) {
+		sys::Print( " (%u files skipped, they are found outside of the folder)", numShadowed );
+	}
+	sys::Print( "\nthe loose files are in the system file cache after packing\n" );
+	sys::Print( "%12s %14s %10s %10s %8s\n", "source", "open us/file", "read ms", "MB/s", "errors" );
+
+	UINT  numErrors = 0;
+
+	if ( ! fileSystem.MountArchive( storedArchive.ToChar() ) ) {
+		return false;
+	}
+	numErrors += MeasureOpenFile( "stored", test );
+
+	// archives mounted later override earlier ones
+	if ( ! fileSystem.MountArchive( compressedArchive.ToChar() ) ) {
+		return false;
+	}
+	numErrors += MeasureOpenFile( "compressed", test );
+
+	// loose files override packed files
+	fileSystem.AddDir( rootFolder.ToChar() );
+	numErrors += MeasureOpenFile( "loose", test );
+
+	if ( numErrors ) {
+		sys::Print( "%u reads failed or differ from the loose files\n", numErrors );
+		return false;
+	}
+	return true;
+}
+
+//
+//	PackFiles - packs a folder (and its subfolders) and compares opening and reading the files
+//	through the file system from pack files and from loose files. Runs in a headless engine.
+//	Usage: PackFiles <folder>
+//
+class PackFilesApp : public mxApplication
+{
+public:
+	String	folder;
+	bool	bOk;
+
+public:
+	PackFilesApp()
+		: bOk( false )
+	{}
+
+	override( mxApplication ) bool Create()
+	{
+		this->bOk = MeasurePackFiles( this->folder );
+		return true;
+	}
+};
+
+bool PackFiles( const TArray< String >& args )
+{
+	if ( args.Num() == 0 ) {
+		sys::Print( "skipped: no folder, run 'Benchmarks PackFiles <folder>'\n" );
+		return true;
+	}
+
+	if ( ! BeginEngineBenchmark( "PackFiles" ) ) {
+		return true;
+	}
+
+	// the system keeps a pointer to the application until the process exits
+	PackFilesApp * app = new PackFilesApp();
+	app->folder = args[0];
+
+	mxSystemCreationInfo  cInfo;
+	cInfo.pUserApp = app;
+	cInfo.driverType = EDriverType::GAPI_None;
+	cInfo.numFramesToRun = 1;
+
+	mxEngine * engine = CreateEngine( cInfo );
+	if ( engine == null ) {
+		sys::Print( "failed to create the engine with the null render system\n" );
+		return false;
+	}
+
+	engine->Run();
+
+	return app->bOk;
+}
+
+MX_REGISTER_BENCHMARK( PackFiles, "opening and reading files through the file system from pack files and loose files, headless" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
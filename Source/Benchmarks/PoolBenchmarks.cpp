@@ -0,0 +1,206 @@
+/*
+=============================================================================
+	File:	PoolBenchmarks.cpp
+	Desc:	Contention benchmark for thread-safe pools.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <process.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	MAX_THREADS			= 16,
+	ITEMS_PER_BATCH		= 64,
+	NUM_BATCHES			= 20000,	// per thread
+};
+
+// The size of BSP nodes and polygons is in this range.
+struct PoolItem
+{
+	UINT32	owner;
+	UINT32	sequence;
+	BYTE	payload[ 40 ];
+};
+
+//
+//	LockedPool - the previous approach: a single-threaded pool behind a lock.
+//
+class LockedPool {
+public:
+	void * Allocate()
+	{
+		sys::ScopedLock  scopedLock( m_lock );
+		return m_pool.New( sizeof(PoolItem) );
+	}
+	void Free( void* item )
+	{
+		sys::ScopedLock  scopedLock( m_lock );
+		m_pool.Delete( item );
+	}
+
+private:
+	mxMemoryPool< PoolItem >	m_pool;
+	sys::CriticalSection		m_lock;
+};
+
+//
+//	ConcurrentPool - mxConcurrentPool with the same interface.
+//
+class ConcurrentPool {
+public:
+	ConcurrentPool()
+		: m_pool( sizeof(PoolItem), ALIGNMENT(PoolItem) )
+	{}
+	void * Allocate()
+	{
+		return m_pool.Allocate();
+	}
+	void Free( void* item )
+	{
+		m_pool.Free( item );
+	}
+
+private:
+	mxConcurrentPool	m_pool;
+};
+
+template< class POOL >
+struct WorkerContext
+{
+	POOL *			pool;
+	HANDLE			startEvent;
+	UINT32			threadIndex;
+	bool			bOk;
+};
+
+//
+//	Each thread allocates batches of items, fills them and frees them in a different order.
+//	The items are checked before they are freed, so overlapping allocations are detected.
+//
+template< class POOL >
+unsigned int __stdcall WorkerThreadFunc( void* param )
+{
+	WorkerContext< POOL > & context = *static_cast< WorkerContext< POOL >* >( param );
+
+	::WaitForSingleObject( context.startEvent, INFINITE );
+
+	PoolItem *	items[ ITEMS_PER_BATCH ];
+	UINT32		seed = context.threadIndex * 7919 + 1;
+
+	for ( UINT32 iBatch = 0; iBatch < NUM_BATCHES; iBatch++ )
+	{
+		for ( UINT32 i = 0; i < ITEMS_PER_BATCH; i++ )
+		{
+			items[i] = static_cast< PoolItem* >( context.pool->Allocate() );
+			items[i]->owner = context.threadIndex;
+			items[i]->sequence = iBatch * ITEMS_PER_BATCH + i;
+		}
+
+		// free in random order
+		for ( UINT32 i = ITEMS_PER_BATCH - 1; i > 0; i-- )
+		{
+			const UINT32 j = BenchmarkRandom( seed ) % ( i + 1 );
+			PoolItem * temp = items[i];
+			items[i] = items[j];
+			items[j] = temp;
+		}
+
+		for ( UINT32 i = 0; i < ITEMS_PER_BATCH; i++ )
+		{
+			if ( items[i]->owner != context.threadIndex
+				|| items[i]->sequence / ITEMS_PER_BATCH != iBatch )
+			{
+				context.bOk = false;
+			}
+			context.pool->Free( items[i] );
+		}
+	}
+
+	mxConcurrentPool::ReleaseThreadCaches();
+	return 0;
+}
+
+// Returns the number of allocations and frees per microsecond, or a negative value on failure.
+template< class POOL >
+FLOAT MeasureThroughput( mxUInt numThreads )
+{
+	POOL  pool;
+
+	WorkerContext< POOL >	contexts[ MAX_THREADS ];
+	HANDLE					threads[ MAX_THREADS ];
+
+	const HANDLE startEvent = ::CreateEvent( NULL, TRUE, FALSE, NULL );
+
+	for ( mxUInt iThread = 0; iThread < numThreads; iThread++ )
+	{
+		contexts[ iThread ].pool = &pool;
+		contexts[ iThread ].startEvent = startEvent;
+		contexts[ iThread ].threadIndex = iThread;
+		contexts[ iThread ].bOk = true;
+
+		threads[ iThread ] = (HANDLE) ::_beginthreadex( NULL, 0, &WorkerThreadFunc< POOL >, &contexts[ iThread ], 0, NULL );
+		Assert( threads[ iThread ] != NULL );
+	}
+
+	mxTimer  timer;
+	::SetEvent( startEvent );
+	::WaitForMultipleObjects( numThreads, threads, TRUE, INFINITE );
+	const FLOAT elapsed = ElapsedMilliseconds( timer );
+
+	bool  bOk = true;
+	for ( mxUInt iThread = 0; iThread < numThreads; iThread++ ) {
+		::CloseHandle( threads[ iThread ] );
+		bOk &= contexts[ iThread ].bOk;
+	}
+	::CloseHandle( startEvent );
+
+	if ( ! bOk ) {
+		return -1.0f;
+	}
+
+	const FLOAT numOperations = 2.0f * numThreads * NUM_BATCHES * ITEMS_PER_BATCH;
+	return numOperations / Max( elapsed * 1000.0f, 1.0f );
+}
+
+//
+//	PoolContention - compares the concurrent pool with a locked single-threaded pool.
+//
+bool PoolContention( const TArray< String >& args )
+{
+	(void) args;
+
+	sys::Print( "%u batches of %u items per thread, operations per microsecond:\n",
+		(mxUInt)NUM_BATCHES, (mxUInt)ITEMS_PER_BATCH );
+	sys::Print( "threads\tlocked pool\tconcurrent pool\n" );
+
+	static const mxUInt threadCounts[] = { 1, 4, MAX_THREADS };
+
+	bool  bOk = true;
+
+	for ( mxUInt iCount = 0; iCount < ARRAY_SIZE(threadCounts); iCount++ )
+	{
+		const mxUInt  numThreads = threadCounts[ iCount ];
+		const FLOAT locked = MeasureThroughput< LockedPool >( numThreads );
+		const FLOAT concurrent = MeasureThroughput< ConcurrentPool >( numThreads );
+
+		sys::Print( "%u\t%.1f\t\t%.1f\n", numThreads, locked, concurrent );
+
+		bOk &= ( locked >= 0.0f ) && ( concurrent >= 0.0f );
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( PoolContention, "allocations from thread-safe pools by 1, 4 and 16 threads" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,198 @@
+/*
+=============================================================================
+	File:	SortBenchmarks.cpp
+	Desc:	Sorting of draw lists by their sort keys and radix sorting of floats.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_ITERATIONS	= 10,
+	NUM_MATERIALS	= 64,
+	NUM_DEPTHS		= 1024,	// few distinct depths, so that many keys are equal
+	NUM_FLOATS		= 256 * 1024,
+};
+
+struct GetEntryKey
+{
+	FORCEINLINE rxSortKey operator () ( const rxDrawList::Entry& entry ) const {
+		return entry.key;
+	}
+};
+
+//
+//	SortDrawList - compares rxDrawList::Sort(), which merge sorts large lists on worker threads,
+//	with the single-threaded radix sort and checks that both give the same order.
+//
+bool SortDrawList( const TArray< String >& args )
+{
+	(void) args;
+
+	static const UINT drawCounts[] = { 4 * 1024, 64 * 1024, 1024 * 1024 };
+
+	// the engine isn't running, so start the worker threads here
+	mxTaskPool &  taskPool = GetGlobalTaskPool();
+	const bool  bStartedTaskPool = ! taskPool.IsInitialized();
+	if ( bStartedTaskPool ) {
+		taskPool.Initialize();
+	}
+
+	sys::Print( "%u worker threads\n", taskPool.GetNumWorkerThreads() );
+	sys::Print( "%10s %8s %12s %12s %10s\n", "draws", "chunks", "Sort() ms", "radix ms", "errors" );
+
+	bool  bOk = true;
+
+	for ( UINT iCount = 0; iCount < ARRAY_SIZE(drawCounts); iCount++ )
+	{
+		const UINT  numDraws = drawCounts[ iCount ];
+
+		TArray< rxSortKey >  keys;
+		keys.SetNum( numDraws );
+
+		UINT32  seed = 5555 + numDraws;
+		for ( UINT i = 0; i < numDraws; i++ ) {
+			const UINT32  material = BenchmarkRandom( seed ) % NUM_MATERIALS;
+			const FLOAT  depth = (FLOAT)( BenchmarkRandom( seed ) % NUM_DEPTHS ) / NUM_DEPTHS;
+			keys[i] = rxMakeSortKey_FrontToBack( 0, material, depth );
+		}
+
+		rxDrawList  drawList;
+		FLOAT  sortTime = 0.0f;
+		for ( UINT iter = 0; iter < NUM_ITERATIONS; iter++ )
+		{
+			drawList.Clear();
+			for ( UINT i = 0; i < numDraws; i++ ) {
+				drawList.Add( keys[i], i );
+			}
+
+			mxTimer  timer;
+			drawList.Sort();
+			sortTime += ElapsedMilliseconds( timer );
+		}
+
+		TArray< rxDrawList::Entry >  reference;
+		TArray< rxDrawList::Entry >  scratch;
+		reference.SetNum( numDraws );
+		scratch.SetNum( numDraws );
+
+		FLOAT  radixTime = 0.0f;
+		for ( UINT iter = 0; iter < NUM_ITERATIONS; iter++ )
+		{
+			for ( UINT i = 0; i < numDraws; i++ ) {
+				reference[i].key = keys[i];
+				reference[i].index = i;
+			}
+
+			mxTimer  timer;
+			mxRadixSortByKey( reference.Ptr(), scratch.Ptr(), numDraws, GetEntryKey() );
+			radixTime += ElapsedMilliseconds( timer );
+		}
+
+		// Many keys are equal, so this also checks that the order of equal keys is kept.
+		UINT  numErrors = 0;
+		for ( UINT i = 0; i < numDraws; i++ ) {
+			if ( drawList[i].key != reference[i].key || drawList[i].index != reference[i].index ) {
+				numErrors++;
+			}
+		}
+
+		sys::Print( "%10u %8u %12.3f %12.3f %10u\n", numDraws, mxGetNumSortChunks( numDraws ),
+			sortTime / NUM_ITERATIONS, radixTime / NUM_ITERATIONS, numErrors );
+
+		if ( numErrors ) {
+			sys::Print( "%u draws: the order differs from the radix sort\n", numDraws );
+			bOk = false;
+		}
+	}
+
+	if ( bStartedTaskPool ) {
+		taskPool.Shutdown();
+	}
+
+	return bOk;
+}
+
+MX_REGISTER_BENCHMARK( SortDrawList, "sorting of draw lists, parallel merge sort against radix sort" );
+
+//
+//	SortFloats - radix sorts floats (see TRadixKey< FLOAT >) and checks the result against a comparison sort.
+//
+bool SortFloats( const TArray< String >& args )
+{
+	(void) args;
+
+	TArray< FLOAT >  values;
+	values.SetNum( NUM_FLOATS );
+
+	// negative and positive values of very different magnitudes, many duplicates and both zeros
+	UINT32  seed = 777;
+	for ( UINT i = 0; i < NUM_FLOATS; i++ )
+	{
+		const UINT32  r = BenchmarkRandom( seed );
+		switch ( r % 8 )
+		{
+		case 0 :	values[i] = 0.0f;	break;
+		case 1 :	values[i] = -0.0f;	break;
+		case 2 :	values[i] = (FLOAT)( (INT32)( r % 64 ) - 32 );	break;
+		case 3 :	values[i] = BenchmarkRandomFloat( seed, -1e-30f, 1e-30f );	break;
+		case 4 :	values[i] = BenchmarkRandomFloat( seed, -1e30f, 1e30f );	break;
+		default:	values[i] = BenchmarkRandomFloat( seed, -1000.0f, 1000.0f );	break;
+		}
+	}
+
+	TArray< FLOAT >  reference;
+	TArray< FLOAT >  sorted;
+	TArray< FLOAT >  scratch;
+	reference.SetNum( NUM_FLOATS );
+	sorted.SetNum( NUM_FLOATS );
+	scratch.SetNum( NUM_FLOATS );
+
+	FLOAT  introTime = 0.0f;
+	FLOAT  radixTime = 0.0f;
+	for ( UINT iter = 0; iter < NUM_ITERATIONS; iter++ )
+	{
+		MemCopy( reference.Ptr(), values.Ptr(), NUM_FLOATS * sizeof(FLOAT) );
+		mxTimer  introTimer;
+		mxIntroSort( reference.Ptr(), NUM_FLOATS );
+		introTime += ElapsedMilliseconds( introTimer );
+
+		MemCopy( sorted.Ptr(), values.Ptr(), NUM_FLOATS * sizeof(FLOAT) );
+		mxTimer  radixTimer;
+		mxRadixSort( sorted.Ptr(), scratch.Ptr(), NUM_FLOATS );
+		radixTime += ElapsedMilliseconds( radixTimer );
+	}
+
+	// -0 and +0 compare equal, so the comparison sort may put them in any order
+	UINT  numErrors = 0;
+	for ( UINT i = 0; i < NUM_FLOATS; i++ ) {
+		if ( sorted[i] != reference[i] || ( i > 0 && sorted[i] < sorted[i-1] ) ) {
+			numErrors++;
+		}
+	}
+
+	sys::Print( "%10s %12s %12s %10s\n", "floats", "intro ms", "radix ms", "errors" );
+	sys::Print( "%10u %12.3f %12.3f %10u\n", (UINT)NUM_FLOATS,
+		introTime / NUM_ITERATIONS, radixTime / NUM_ITERATIONS, numErrors );
+
+	if ( numErrors ) {
+		sys::Print( "the radix sort order of floats differs from mxIntroSort\n" );
+		return false;
+	}
+	return true;
+}
+
+MX_REGISTER_BENCHMARK( SortFloats, "radix sort of floats against a comparison sort" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,474 @@
+/*
+=============================================================================
+	File:	SpatialBenchmarks.cpp
+	Desc:	Queries of spatial databases with many moving objects.
+=============================================================================
+*/
+
+#include "Benchmarks.h"
+
+#include <Engine.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_FRAMES		= 20,
+	NUM_QUERIES		= 100,	// of each kind per frame
+	MOVING_PERCENT	= 10,	// of the objects are moved each frame
+	TELEPORT_CHANCE	= 50,	// one of this many moved objects jumps to a random place
+};
+
+const FLOAT WORLD_HALF_SIZE = 500.0f;
+const FLOAT VIEW_DISTANCE = 300.0f;
+
+enum ETiming
+{
+	Timing_Insert,
+	Timing_Update,
+	Timing_Visible,
+	Timing_Point,
+	Timing_Box,
+	Timing_Sphere,
+
+	NUM_TIMINGS
+};
+
+//
+//	TestObjects - bounds and transforms of the objects, the proxies keep references to the transforms.
+//
+struct TestObjects
+{
+	TArray< Matrix4 >	transforms;
+	TArray< AABB >		localBounds;
+	TArray< AABB >		worldBounds;	// computed the same way as by the proxies
+};
+
+//
+//	TestDatabase - a spatial database with its own entities (a proxy can only be inserted into one database).
+//
+struct TestDatabase
+{
+	const char *						name;
+	mxSpatialDatabase *					database;
+	TArray< mxEntity* >					entities;
+	THashMap< const mxEntity*, UINT >	indices;	// of the objects
+	FLOAT								times[ NUM_TIMINGS ];
+	UINT								numMismatches;
+};
+
+Vec3D RandomPoint( UINT32 & seed, FLOAT halfSize )
+{
+	return Vec3D( BenchmarkRandomFloat( seed, -halfSize, halfSize ),
+		BenchmarkRandomFloat( seed, -halfSize, halfSize ),
+		BenchmarkRandomFloat( seed, -halfSize, halfSize ) );
+}
+
+Vec3D RandomHalfSize( UINT32 & seed, FLOAT maxHalfSize )
+{
+	return Vec3D( BenchmarkRandomFloat( seed, 0.1f, maxHalfSize ),
+		BenchmarkRandomFloat( seed, 0.1f, maxHalfSize ),
+		BenchmarkRandomFloat( seed, 0.1f, maxHalfSize ) );
+}
+
+void CreateTestObjects( UINT numObjects, TestObjects &OutObjects )
+{
+	OutObjects.transforms.SetNum( numObjects );
+	OutObjects.localBounds.SetNum( numObjects );
+	OutObjects.worldBounds.SetNum( numObjects );
+
+	UINT32  seed = 31337 + numObjects;
+	for ( UINT i = 0; i < numObjects; i++ )
+	{
+		// some objects are outside the world bounds
+		OutObjects.transforms[i] = Matrix4::CreateTranslation( RandomPoint( seed, WORLD_HALF_SIZE * 1.02f ) );
+
+		// mostly small objects and a few large ones
+		const UINT32  sizeClass = BenchmarkRandom( seed ) % 100;
+		const FLOAT  maxHalfSize = ( sizeClass < 90 ) ? 4.0f : ( sizeClass < 99 ) ? 40.0f : 150.0f;
+		const Vec3D  halfSize( RandomHalfSize( seed, maxHalfSize ) );
+
+		OutObjects.localBounds[i] = AABB( -halfSize, halfSize );
+	}
+}
+
+void MoveTestObjects( TestObjects & objects, UINT32 & seed )
+{
+	const UINT  numMoved = objects.transforms.Num() * MOVING_PERCENT / 100;
+	for ( UINT iMoved = 0; iMoved < numMoved; iMoved++ )
+	{
+		Matrix4 & transform = objects.transforms[ BenchmarkRandom( seed ) % objects.transforms.Num() ];
+
+		if ( BenchmarkRandom( seed ) % TELEPORT_CHANCE == 0 ) {
+			transform.SetTranslation( RandomPoint( seed, WORLD_HALF_SIZE * 1.02f ) );
+		} else {
+			transform.SetTranslation( transform.GetTranslation() + RandomPoint( seed, 5.0f ) );
+		}
+	}
+}
+
+void CreateEntities( TestDatabase & db, TestObjects & objects )
+{
+	db.entities.SetNum( objects.transforms.Num() );
+	for ( UINT i = 0; i < db.entities.Num(); i++ )
+	{
+		mxEntity * entity = MX_NEW mxEntity();
+		entity->SetSpatialProxy( MX_NEW mxSpatialProxy_Box( objects.localBounds[i], objects.transforms[i] ) );
+
+		db.entities[i] = entity;
+		db.indices.Set( entity, i );
+	}
+
+	mxTimer  timer;
+	for ( UINT i = 0; i < db.entities.Num(); i++ ) {
+		db.database->Add( db.entities[i] );
+	}
+	db.times[ Timing_Insert ] = ElapsedMilliseconds( timer );
+}
+
+void DestroyEntities( TestDatabase & db )
+{
+	for ( UINT i = 0; i < db.entities.Num(); i++ )
+	{
+		db.database->Remove( db.entities[i] );
+		MX_FREE( db.entities[i] );
+	}
+	db.entities.Clear();
+	db.indices.Clear();
+}
+
+//
+//	The query results are compared as sorted lists of object indices.
+//
+void GetSortedIndices( const TestDatabase& db, mxEntity** entities, UINT numEntities, TArray< UINT > &OutIndices )
+{
+	OutIndices.SetNum( numEntities, false );
+	for ( UINT i = 0; i < numEntities; i++ )
+	{
+		const UINT * index = db.indices.Find( entities[i] );
+		OutIndices[i] = index ? *index : MAX_UINT32;
+	}
+	OutIndices.Sort();
+}
+
+bool IsSameResult( const TArray< UINT >& a, const TArray< UINT >& b )
+{
+	if ( a.Num() != b.Num() ) {
+		return false;
+	}
+	for ( UINT i = 0; i < a.Num(); i++ ) {
+		if ( a[i] != b[i] ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//
+//	TestQueries - queries of one frame and their results computed by testing all objects.
+//
+struct TestQueries
+{
+	mxSceneView		view;
+	Vec3D			points[ NUM_QUERIES ];
+	AABB			boxes[ NUM_QUERIES ];
+	Sphere			spheres[ NUM_QUERIES ];
+
+	TArray< UINT >	visibleResult;
+	TArray< UINT >	pointResults[ NUM_QUERIES ];
+	TArray< UINT >	boxResults[ NUM_QUERIES ];
+	TArray< UINT >	sphereResults[ NUM_QUERIES ];
+
+	FLOAT			bruteForceTimes[ NUM_TIMINGS ];
+};
+
+void CreateTestQueries( TestQueries & queries, UINT32 & seed )
+{
+	Vec3D  direction;
+	do {
+		direction = RandomPoint( seed, 1.0f );
+		direction.y *= 0.5f;	// not too close to the up vector
+	} while ( direction.Normalize() < 0.1f );
+
+	queries.view.SetLens( mxMath::HALF_PI, 16.0f / 9.0f, 2.0f, VIEW_DISTANCE );
+	queries.view.SetView( RandomPoint( seed, WORLD_HALF_SIZE * 0.8f ), direction );
+
+	for ( UINT i = 0; i < NUM_QUERIES; i++ )
+	{
+		queries.points[i] = RandomPoint( seed, WORLD_HALF_SIZE );
+
+		const Vec3D  center( RandomPoint( seed, WORLD_HALF_SIZE ) );
+		const Vec3D  halfSize( RandomHalfSize( seed, 30.0f ) );
+		queries.boxes[i] = AABB( center - halfSize, center + halfSize );
+
+		queries.spheres[i].SetOrigin( RandomPoint( seed, WORLD_HALF_SIZE ) );
+		queries.spheres[i].SetRadius( BenchmarkRandomFloat( seed, 1.0f, 30.0f ) );
+	}
+}
+
+// Tests each object against each query, the databases must give the same results.
+void ComputeBruteForceResults( TestQueries & queries, TestObjects & objects )
+{
+	const UINT  numObjects = objects.transforms.Num();
+
+	mxTimer  timer;
+	for ( UINT i = 0; i < numObjects; i++ ) {
+		objects.worldBounds[i] = objects.localBounds[i].Trasform( objects.transforms[i] );
+	}
+	queries.bruteForceTimes[ Timing_Update ] = ElapsedMilliseconds( timer );
+
+	timer.Reset();
+	const mxViewFrustum & frustum = queries.view.GetFrustum();
+	queries.visibleResult.SetNum( 0, false );
+	for ( UINT i = 0; i < numObjects; i++ ) {
+		if ( frustum.IntersectsAABB( objects.worldBounds[i] ) ) {
+			queries.visibleResult.Append( i );
+		}
+	}
+	queries.bruteForceTimes[ Timing_Visible ] = ElapsedMilliseconds( timer );
+
+	timer.Reset();
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		queries.pointResults[ iQuery ].SetNum( 0, false );
+		for ( UINT i = 0; i < numObjects; i++ ) {
+			if ( objects.worldBounds[i].ContainsPoint( queries.points[ iQuery ] ) ) {
+				queries.pointResults[ iQuery ].Append( i );
+			}
+		}
+	}
+	queries.bruteForceTimes[ Timing_Point ] = ElapsedMilliseconds( timer );
+
+	timer.Reset();
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		queries.boxResults[ iQuery ].SetNum( 0, false );
+		for ( UINT i = 0; i < numObjects; i++ ) {
+			if ( objects.worldBounds[i].IntersectsBounds( queries.boxes[ iQuery ] ) ) {
+				queries.boxResults[ iQuery ].Append( i );
+			}
+		}
+	}
+	queries.bruteForceTimes[ Timing_Box ] = ElapsedMilliseconds( timer );
+
+	timer.Reset();
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		const Sphere & sphere = queries.spheres[ iQuery ];
+		queries.sphereResults[ iQuery ].SetNum( 0, false );
+		for ( UINT i = 0; i < numObjects; i++ ) {
+			if ( SphereIntersectsAABB( sphere.GetOrigin(), sphere.GetRadius(), objects.worldBounds[i] ) ) {
+				queries.sphereResults[ iQuery ].Append( i );
+			}
+		}
+	}
+	queries.bruteForceTimes[ Timing_Sphere ] = ElapsedMilliseconds( timer );
+}
+
+void RunTestQueries( TestDatabase & db, const TestQueries& queries )
+{
+	mxEntityCache  result;
+	TArray< UINT >  indices;
+	mxTimer  timer;
+
+	mxTime  deltaTime;
+	deltaTime.fTime = 1.0f / 60.0f;
+	deltaTime.iTime = 16;
+
+	timer.Reset();
+	db.database->Update( deltaTime );
+	db.times[ Timing_Update ] += ElapsedMilliseconds( timer );
+
+	mxVisibleSet  visibleSet;
+	timer.Reset();
+	db.database->GetVisibleSet( queries.view, visibleSet );
+	db.times[ Timing_Visible ] += ElapsedMilliseconds( timer );
+
+	result.SetNum( visibleSet.GetNum(), false );
+	for ( UINT i = 0; i < result.Num(); i++ ) {
+		result[i] = visibleSet.Get( i );
+	}
+	GetSortedIndices( db, result.Ptr(), result.Num(), indices );
+	if ( ! IsSameResult( indices, queries.visibleResult ) ) {
+		db.numMismatches++;
+	}
+
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		result.SetNum( 0, false );
+		timer.Reset();
+		db.database->GetEntitiesInPoint( queries.points[ iQuery ], result );
+		db.times[ Timing_Point ] += ElapsedMilliseconds( timer );
+
+		GetSortedIndices( db, result.Ptr(), result.Num(), indices );
+		if ( ! IsSameResult( indices, queries.pointResults[ iQuery ] ) ) {
+			db.numMismatches++;
+		}
+	}
+
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		const AABB & box = queries.boxes[ iQuery ];
+		result.SetNum( 0, false );
+		timer.Reset();
+		db.database->GetEntitiesInBox( box.GetMin(), box.GetMax(), result );
+		db.times[ Timing_Box ] += ElapsedMilliseconds( timer );
+
+		GetSortedIndices( db, result.Ptr(), result.Num(), indices );
+		if ( ! IsSameResult( indices, queries.boxResults[ iQuery ] ) ) {
+			db.numMismatches++;
+		}
+	}
+
+	for ( UINT iQuery = 0; iQuery < NUM_QUERIES; iQuery++ )
+	{
+		const Sphere & sphere = queries.spheres[ iQuery ];
+		result.SetNum( 0, false );
+		timer.Reset();
+		db.database->GetEntitiesInSphere( sphere.GetOrigin(), sphere.GetRadius(), result );
+		db.times[ Timing_Sphere ] += ElapsedMilliseconds( timer );
+
+		GetSortedIndices( db, result.Ptr(), result.Num(), indices );
+		if ( ! IsSameResult( indices, queries.sphereResults[ iQuery ] ) ) {
+			db.numMismatches++;
+		}
+	}
+}
+
+void PrintTimes( const char* name, const FLOAT* times, UINT numMismatches )
+{
+	sys::Print( "%12s %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10u\n", name,
+		times[ Timing_Insert ], times[ Timing_Update ] / NUM_FRAMES, times[ Timing_Visible ] / NUM_FRAMES,
+		times[ Timing_Point ] / NUM_FRAMES, times[ Timing_Box ] / NUM_FRAMES, times[ Timing_Sphere ] / NUM_FRAMES,
+		numMismatches );
+}
+
+bool MeasureSpatialQueries( UINT numObjects )
+{
+	TestObjects  objects;
+	CreateTestObjects( numObjects, objects );
+
+	const mxBounds  worldBounds( Vec3D( -WORLD_HALF_SIZE, -WORLD_HALF_SIZE, -WORLD_HALF_SIZE ),
+		Vec3D( WORLD_HALF_SIZE, WORLD_HALF_SIZE, WORLD_HALF_SIZE ) );
+
+	TestDatabase  databases[2];
+	databases[0].name = "loose octree";
+	databases[0].database = MX_NEW mxSpatialDatabase_LooseOctree( worldBounds );
+	databases[1].name = "AABB tree";
+	databases[1].database = MX_NEW mxSpatialDatabase_AABBTree();
+
+	for ( UINT iDB = 0; iDB < ARRAY_SIZE(databases); iDB++ )
+	{
+		MemZero( databases[ iDB ].times, sizeof(databases[ iDB ].times) );
+		databases[ iDB ].numMismatches = 0;
+		CreateEntities( databases[ iDB ], objects );
+	}
+
+	FLOAT  bruteForceTimes[ NUM_TIMINGS ];
+	MemZero( bruteForceTimes, sizeof(bruteForceTimes) );
+
+	TestQueries  queries;
+	UINT32  seed = 24680 + numObjects;
+
+	for ( UINT iFrame = 0; iFrame < NUM_FRAMES; iFrame++ )
+	{
+		MoveTestObjects( objects, seed );
+		CreateTestQueries( queries, seed );
+		ComputeBruteForceResults( queries, objects );
+
+		for ( UINT iTiming = 0; iTiming < NUM_TIMINGS; iTiming++ ) {
+			bruteForceTimes[ iTiming ] += queries.bruteForceTimes[ iTiming ];
+		}
+		for ( UINT iDB = 0; iDB < ARRAY_SIZE(databases); iDB++ ) {
+			RunTestQueries( databases[ iDB ], queries );
+		}
+	}
+
+	sys::Print( "%u objects, %u%% moving, %u queries of each kind per frame\n",
+		numObjects, (UINT)MOVING_PERCENT, (UINT)NUM_QUERIES );
+	sys::Print( "%12s %10s %10s %10s %10s %10s %10s %10s\n",
+		"ms", "insert", "update", "visible", "points", "boxes", "spheres", "mismatches" );
+
+	PrintTimes( "brute force", bruteForceTimes, 0 );
+
+	bool  bOk = true;
+	for ( UINT iDB = 0; iDB < ARRAY_SIZE(databases); iDB++ )
+	{
+		TestDatabase & db = databases[ iDB ];
+		PrintTimes( db.name, db.times, db.numMismatches );
+
+		if ( db.numMismatches ) {
+			sys::Print( "%s: %u queries differ from testing all objects\n", db.name, db.numMismatches );
+			bOk = false;
+		}
+
+		DestroyEntities( db );
+		MX_FREE( db.database );
+	}
+
+	return bOk;
+}
+
+//
+//	SpatialQueries - inserts moving objects into the loose octree and the AABB tree,
+//	times updates, visible set and point/box/sphere queries, and checks the results against testing all objects.
+//	The entities need the engine, so the benchmark runs in a headless engine.
+//
+class SpatialQueryApp : public mxApplication
+{
+public:
+	bool	bOk;
+
+public:
+	SpatialQueryApp()
+		: bOk( false )
+	{}
+
+	override( mxApplication ) bool Create()
+	{
+		static const UINT objectCounts[] = { 4096, 32768 };
+
+		this->bOk = true;
+		for ( UINT iCount = 0; iCount < ARRAY_SIZE(objectCounts); iCount++ ) {
+			this->bOk &= MeasureSpatialQueries( objectCounts[ iCount ] );
+		}
+		return true;
+	}
+};
+
+bool SpatialQueries( const TArray< String >& args )
+{
+	(void) args;
+
+	if ( ! BeginEngineBenchmark( "SpatialQueries" ) ) {
+		return true;
+	}
+
+	// the system keeps a pointer to the application until the process exits
+	SpatialQueryApp * app = new SpatialQueryApp();
+
+	mxSystemCreationInfo  cInfo;
+	cInfo.pUserApp = app;
+	cInfo.driverType = EDriverType::GAPI_None;
+	cInfo.numFramesToRun = 1;
+
+	mxEngine * engine = CreateEngine( cInfo );
+	if ( engine == null ) {
+		sys::Print( "failed to create the engine with the null render system\n" );
+		return false;
+	}
+
+	engine->Run();
+
+	return app->bOk;
+}
+
+MX_REGISTER_BENCHMARK( SpatialQueries, "queries of the loose octree and the AABB tree with moving objects, headless" );
+
+}//End of anonymous namespace
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -22,7 +22,9 @@ const mxChar* GetDriverName( EDriverType driver )
 		case EDriverType::GAPI_AutomaticSelection :
 			return "unknown";
 
-		case EDriverType::GAPI_None :	// fallthru
+		case EDriverType::GAPI_None :
+			return "Null";
+
 		default:						// fallthru
 			;
 	}
@@ -69,7 +71,7 @@ void mxGraphicsSettings::SetDefaultValues()
 bool mxGraphicsSettings::IsValid() const
 {
 	return screen.IsValid()
-		&& (driverType != EDriverType::GAPI_None);
+		&& (driverType < EDriverType::NUM_GRAPHICS_APIs);
 }
 
 /*================================
@@ -84,6 +86,7 @@ mxSystemSettings::mxSystemSettings()
 void mxSystemSettings::SetDefaultValues()
 {
 	bCreateConsole = g_bDebugMode;
+	numFramesToRun = 0;
 }
 
 bool mxSystemSettings::IsValid() const
@@ -76,6 +76,10 @@ struct ENGINE_API mxSystemSettings
 	// if true then an CRT text console will be created.
 	bool	bCreateConsole;
 
+	// if not zero then the main loop exits after running this many frames
+	// (used for benchmarking, applications without a window can't be closed otherwise).
+	mxUInt	numFramesToRun;
+
 	// Work in progress...
 	// Memory requirements, target frame rate, expected CPU load, etc.
 
@@ -40,7 +40,12 @@
 #include <Renderer/Texture.h>
 #include <Renderer/Material.h>
 #include <Renderer/Geometry.h>
+#include <Renderer/MeshCache.h>
+#include <Renderer/DrawList.h>
+#include <Renderer/CommandBuffer.h>
+#include <Renderer/LightClusters.h>
 #include <Renderer/Renderer.h>
+#include <Renderer/Instancing.h>
 #include <Renderer/DebugDrawer.h>
 #include <Renderer/Messaging.h>
 
@@ -57,6 +62,11 @@
 #include <Scene/SpatialProxy.h>
 #include <Scene/SpatialDatabase.h>
 #include <Scene/SpatialDatabase_Simple.h>
+#include <Scene/SpatialDatabase_AABBTree.h>
+#include <Scene/SpatialDatabase_LooseOctree.h>
+
+// Render queues (generated from visible sets of scenes).
+#include <Renderer/RenderQueue.h>
 
 #endif // !__MX_PUBLIC_SHARED_ENGINE_H__
 
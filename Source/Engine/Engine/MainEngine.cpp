@@ -104,6 +104,12 @@ void mxEngine::Tick( const mxTime elapsedTime )
 {
 	MX_PROFILE( "mxEngine::Tick" );
 
+	// Recycle scratch memory allocated two frames ago.
+	GetFrameArena().BeginFrame();
+
+	// Rescan asset folders if files have been added or removed.
+	GetFileSystem().CheckForChanges();
+
 	GetEntitySystem().Tick( elapsedTime );
 
 	// Update all scenes.
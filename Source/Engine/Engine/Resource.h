@@ -16,92 +16,35 @@ namespace abc {
 ===========================================================
 */
 
-// Maximum allowed length of a single resource name.
-enum { MAX_NAME_CHARS = 32 };
-
-//
-//	TName
 //
-template
-<
-	typename TChar = mxChar,
-	mxUInt MaxChars = MAX_NAME_CHARS
->
-class TName {
-public:
-	TName()
-	{
-		Empty();
-	}
-	TName( const TChar* name )
-	{
-		Set( name );
-	}
-
-	operator const TChar* () const
-	{
-		return m_data.Ptr();
-	}
-	mxUInt	GetSize() const
-	{
-		return m_data.Num()-1; // last mxChar is null
-	}
-	void Set( const TChar* pSrc )
-	{
-		Assert( pSrc );
-		const SizeT size = sys::StrLen( pSrc ) * sizeof(TChar);
-		Assert( size <= sizeof(m_data) );
-
-		m_data.SetNum( size + 1 );
-		MemCopy( m_data.Ptr(), pSrc, size );
-		m_data[ size ] = null;
-	}
-	void Empty()
-	{
-		m_data.SetNum( 0 );
-		m_data.Ptr()[0] = '\0';
-	}
-
-	mxUInt GetCapacity() const
-	{
-		return MaxChars;
-	}
-
-private:
-
-	// actual string data is kept here;
-	// static array is used to minimize memory fragmentation
-	//
-	TStaticList< TChar, MaxChars >	m_data;
-};
-
+//	NamedResource
 //
-//	TNamedElement
+//	The name is interned (see mxNameId), so it has no length limit
+//	and it can be used as a key in resource sets without hashing the characters.
 //
-template
-<
-	typename TChar = mxChar,
-	mxUInt MaxChars = MAX_NAME_CHARS
->
-class TNamedElement {
+class NamedResource {
 public:
-	TNamedElement()
+	NamedResource()
 	{}
-	TNamedElement( const TChar* name )
+	NamedResource( const mxChar* name )
 		: m_name( name )
 	{}
 
-	void SetName( const TChar* name )
+	void SetName( const mxChar* name )
+	{
+		m_name = mxNameId( name );
+	}
+	const mxChar * GetName() const
 	{
-		m_name.Set( name );
+		return m_name.ToChar();
 	}
-	const TChar * GetName() const
+	const mxNameId & GetNameId() const
 	{
 		return m_name;
 	}
 
 private:
-	TName< TChar, MaxChars >	m_name;	// unique name of this object
+	mxNameId	m_name;	// unique name of this object
 };
 
 /*
@@ -112,8 +55,6 @@ private:
 ===========================================================
 */
 
-typedef	TNamedElement< mxChar, MAX_NAME_CHARS >	NamedResource;
-
 //
 //	mxResourceLoader
 //
@@ -133,6 +74,7 @@ public:
 //	TResourceSet< T >
 //
 //	Used for hashing resources by name for quick access.
+//	Names are interned, so lookups by mxNameId don't touch the characters.
 //
 template< class TResourceType >
 class TResourceSet {
@@ -142,7 +84,7 @@ public:
 	{	AssertPtr( name );
 		if( name )
 		{
-			this->resourceHash.Set( name, pResource );
+			this->resourceHash.Set( mxNameId( name ), pResource );
 		}
 	}
 
@@ -160,8 +102,15 @@ public:
 	TResourceType * Find( const mxChar* name )
 	{
 		AssertPtr( name );
-		TResourceType ** ppResource = null;
-		if ( this->resourceHash.Get( name, &ppResource ) )
+		return Find( mxNameId::Find( name ) );
+	}
+
+	TResourceType * Find( const mxNameId& name )
+	{
+		if ( name.IsEmpty() ) {
+			return null;
+		}
+		if ( TResourceType ** ppResource = this->resourceHash.Find( name ) )
 		{
 			return *ppResource;
 		}
@@ -172,7 +121,10 @@ public:
 	void Remove( const mxChar* name )
 	{
 		AssertPtr( name );
-		this->resourceHash.Remove( name );
+		const mxNameId  nameId = mxNameId::Find( name );
+		if ( ! nameId.IsEmpty() ) {
+			this->resourceHash.Remove( nameId );
+		}
 	}
 
 	// Removes all entries from the hash table.
@@ -194,7 +146,7 @@ public:
 	{}
 
 private:
-	TStringHash< TResourceType* >	resourceHash;	// maps resources to their names
+	THashMap< mxNameId, TResourceType* >	resourceHash;	// maps resources to their names
 };
 
 //
@@ -213,17 +165,16 @@ public:
 	{	Assert( name );
 		if( name )
 		{
-			this->resourceHash.Set( name, pointer );
+			this->Insert( name, pointer );
 		}
 	}
 
 	TResourceType * GetByName( const mxChar* name )
 	{
 		Assert( name );
-		TResourceType ** ppResource = null;
-		if ( this->resourceHash.Get( name, &ppResource ) )
+		if ( TResourceType * pResource = this->Find( name ) )
 		{
-			return *ppResource;
+			return pResource;
 		}
 		TResourceType * result = null;
 		OnResourceNotFound( name, result );
@@ -9,6 +9,7 @@
 #include <Engine.h>
 
 #include <Renderer/D3D/D3DRenderSystem.h>
+#include <Renderer/Null/NullRenderSystem.h>
 
 #include <fcntl.h>
 
@@ -76,6 +77,10 @@ private:
 
 	// returns null on failure
 	rxRenderer* InitD3D10Driver( const rxRenderDeviceCreationInfo& cInfo );
+	rxRenderer* InitNullDriver( const rxRenderDeviceCreationInfo& cInfo );
+
+	// Creates and activates the application's main window, returns false on failure.
+	bool	CreateMainWindow( const mxScreenSettings& screen );
 
 private:
 	// Explicitly create a console window for simple text I/O.
@@ -102,6 +107,9 @@ private:
 	// This value will be strictly increasing.
 	mxUInt		frameCount;
 
+	// The main loop exits after rendering this many frames (zero = run until the window is closed).
+	mxUInt		numFramesToRun;
+
 	// Current virtual time (elapsed since the application was started), in milliseconds.
 	// This value will be strictly increasing.
 	mxUInt		currentTime;
@@ -213,8 +221,10 @@ HWND GetWindowHandle()
 
 void GetWindowPosition( mxUInt &Left, mxUInt &Top, mxUInt &Right, mxUInt &Bottom )
 {
-	RECT  rect;
-	::GetWindowRect( GetWindowHandle(), &rect );
+	RECT  rect = { 0, 0, 0, 0 };	// stays empty when running headless
+	if ( GetWindowHandle() ) {
+		::GetWindowRect( GetWindowHandle(), &rect );
+	}
 
 	Left	= rect.left;
 	Top		= rect.top;
@@ -538,6 +548,7 @@ mxSystem::mxSystem()
 	, m_bIsInitialized( false )
 {
 	this->frameCount	= 0;
+	this->numFramesToRun = 0;
 	this->currentTime	= 0;
 	this->lastTime		= 0;
 	this->lastFrameTime	= 0;
@@ -598,6 +609,17 @@ bool mxSystem::Create( const mxSystemCreationInfo& creationInfo )
 			sys::GetCpuTypeName( sysInfo.Cpu ), sysInfo.NumProcessors, cpuFreq, sysInfo.ProcessorPageSize );
 	}
 
+	//
+	//	Start worker threads.
+	//
+	GetGlobalTaskPool().Initialize();
+	sys::Print( TEXT("Num. worker threads = %u\n"), GetGlobalTaskPool().GetNumWorkerThreads() );
+
+	//
+	//	Allocate memory for per-frame scratch data.
+	//
+	GetFrameArena().Initialize();
+
 	//
 	//	Initialize the pointer to the user application.
 	//
@@ -609,65 +631,21 @@ bool mxSystem::Create( const mxSystemCreationInfo& creationInfo )
 	m_userApp = creationInfo.pUserApp;
 	AssertPtr( m_userApp );
 
+	this->numFramesToRun = creationInfo.numFramesToRun;
+
 	//
 	// Create a window.
+	// The null driver doesn't present anything, so it runs headless (e.g. on build machines).
 	//
 	m_hInstance = GetModuleHandle( NULL );
 
-	const mxChar * classname = TEXT("The Engine");
-
-	const WNDCLASSEX wc = {
-		sizeof( WNDCLASSEX ),
-		CS_CLASSDC,
-		sys::win32::G_WindowsMsgProc,
-		0L, 0L,
-		m_hInstance,
-		LoadIcon( m_hInstance, MAKEINTRESOURCE(IDI_APPLICATION) ),
-		LoadCursor( NULL, IDC_ARROW ),
-		NULL, NULL,
-		classname, NULL };
-
-	RegisterClassEx( &wc );	// Register the window class ( adding our own icon to this window ).
-
-	// Create the application's window - ensure the visible viewport starts at a given size.
-
-	RECT initSize = {
-		0,
-		0,
-		creationInfo.screen.width,
-		creationInfo.screen.height
-	};
-
-	const DWORD windowStyle = WS_OVERLAPPEDWINDOW;
-	AdjustWindowRect( &initSize, windowStyle, FALSE );
-
-	m_hWnd = CreateWindow(
-		classname,
-		TEXT( "3D Engine" ),
-		windowStyle,
-		CW_USEDEFAULT,
-		CW_USEDEFAULT,
-		initSize.right - initSize.left,
-		initSize.bottom - initSize.top,
-		NULL,
-		NULL,
-		wc.hInstance,
-		NULL
-	);
-
-	if ( NULL == m_hWnd )
+	if ( creationInfo.driverType != EDriverType::GAPI_None )
 	{
-		::MessageBox( NULL, TEXT("Failed to create a window"), TEXT("Error!"), MB_OK );
-		return false;
+		if ( ! CreateMainWindow( creationInfo.screen ) ) {
+			return false;
+		}
 	}
 
-	// Make the primary window active.
-	ShowWindow( m_hWnd, SW_SHOW );
-	UpdateWindow( m_hWnd );
-
-	SetActiveWindow( m_hWnd );
-	SetForegroundWindow( m_hWnd );
-
 	//
 	// Create the render system.
 	//
@@ -681,7 +659,9 @@ bool mxSystem::Create( const mxSystemCreationInfo& creationInfo )
 	switch ( creationInfo.driverType )
 	{
 	case EDriverType::GAPI_None :
-		Unimplemented;
+		{
+			renderSys = InitNullDriver( cInfo );
+		}
 		break;
 
 #ifdef MX_D3DX9
@@ -789,6 +769,68 @@ bool mxSystem::Create( const mxSystemCreationInfo& creationInfo )
 	return true;
 }
 
+//
+//	mxSystem::CreateMainWindow
+//
+bool mxSystem::CreateMainWindow( const mxScreenSettings& screen )
+{
+	const mxChar * classname = TEXT("The Engine");
+
+	const WNDCLASSEX wc = {
+		sizeof( WNDCLASSEX ),
+		CS_CLASSDC,
+		sys::win32::G_WindowsMsgProc,
+		0L, 0L,
+		m_hInstance,
+		LoadIcon( m_hInstance, MAKEINTRESOURCE(IDI_APPLICATION) ),
+		LoadCursor( NULL, IDC_ARROW ),
+		NULL, NULL,
+		classname, NULL };
+
+	RegisterClassEx( &wc );	// Register the window class ( adding our own icon to this window ).
+
+	// Create the application's window - ensure the visible viewport starts at a given size.
+
+	RECT initSize = {
+		0,
+		0,
+		screen.width,
+		screen.height
+	};
+
+	const DWORD windowStyle = WS_OVERLAPPEDWINDOW;
+	AdjustWindowRect( &initSize, windowStyle, FALSE );
+
+	m_hWnd = CreateWindow(
+		classname,
+		TEXT( "3D Engine" ),
+		windowStyle,
+		CW_USEDEFAULT,
+		CW_USEDEFAULT,
+		initSize.right - initSize.left,
+		initSize.bottom - initSize.top,
+		NULL,
+		NULL,
+		wc.hInstance,
+		NULL
+	);
+
+	if ( NULL == m_hWnd )
+	{
+		::MessageBox( NULL, TEXT("Failed to create a window"), TEXT("Error!"), MB_OK );
+		return false;
+	}
+
+	// Make the primary window active.
+	ShowWindow( m_hWnd, SW_SHOW );
+	UpdateWindow( m_hWnd );
+
+	SetActiveWindow( m_hWnd );
+	SetForegroundWindow( m_hWnd );
+
+	return true;
+}
+
 //
 //	mxSystem::EnterMainLoop
 //
@@ -824,8 +866,10 @@ void mxSystem::EnterMainLoop()
 	}
 
 	// Show the window.
-	ShowWindow( m_hWnd, SW_SHOWDEFAULT );
-	UpdateWindow( m_hWnd );
+	if ( m_hWnd ) {
+		ShowWindow( m_hWnd, SW_SHOWDEFAULT );
+		UpdateWindow( m_hWnd );
+	}
 
 	// Enter the message loop.
 	MSG msg;
@@ -842,6 +886,11 @@ void mxSystem::EnterMainLoop()
 			if ( m_bIsActive ) {
 				// Main game loop.
 				RunFrame();
+
+				// Without a window this is the only way to leave the loop.
+				if ( this->numFramesToRun && GetFrameCount() >= this->numFramesToRun ) {
+					PostQuitMessage( 0 );
+				}
 			} else {
 				::Sleep( 1000 );
 			}
@@ -935,6 +984,10 @@ void mxSystem::Shutdown()
 
 	if ( !bHasAlreadyBeenShutdown )
 	{
+	#ifdef MX_DEBUG
+		const bool bHasWindow = ( m_hWnd != NULL );	// false when running headless
+	#endif
+
 		if ( this->IsInitialized() )
 		{
 			isRunning = false;
@@ -981,13 +1034,26 @@ void mxSystem::Shutdown()
 		// Destroy the type system.
 		mxObjectFactory::Destroy();
 
+		GetGlobalTaskPool().Shutdown();
+
+		#ifdef MX_DEVELOPER
+			GetFrameArena().DumpStats();
+		#endif
+		GetFrameArena().Shutdown();
+
+		#ifdef MX_DEVELOPER
+			Mem_DumpStats();
+		#endif
+
 		Platform_Shutdown();
 
 		#ifdef MX_DEBUG
 			MX_TODO("Here's a convenient place to dump memory leaks, resource usage, etc.")
-			::MessageBox( GetWindowHandle(), TEXT("Done"),
-				TEXT("Success"),
-				MB_OK );
+			if ( bHasWindow ) {
+				::MessageBox( GetWindowHandle(), TEXT("Done"),
+					TEXT("Success"),
+					MB_OK );
+			}
 		#endif
 
 		bHasAlreadyBeenShutdown = true;
@@ -1116,6 +1182,24 @@ rxRenderer* mxSystem::InitD3D10Driver( const rxRenderDeviceCreationInfo& cInfo )
 	}
 }
 
+//
+//	mxSystem::InitNullDriver
+//
+rxRenderer* mxSystem::InitNullDriver( const rxRenderDeviceCreationInfo& cInfo )
+{
+	rxRenderer * r = MX_NEW NullRenderer();
+
+	if ( r->Create( cInfo ) )
+	{
+		return r;
+	}
+	else
+	{
+		r->Destroy();
+		return null;
+	}
+}
+
 }//End of namespace abc
 
 //--------------------------------------------------------------//
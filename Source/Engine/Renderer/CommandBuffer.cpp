@@ -0,0 +1,238 @@
+/*
+=============================================================================
+	File:	CommandBuffer.cpp
+	Desc:	Backend-agnostic render command buffers, parallel recording.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+/*================================
+		rxCommandBuffer
+================================*/
+
+rxCommandBuffer::rxCommandBuffer()
+{
+	this->commands.SetGranularity( 1024 );
+	this->packets.SetGranularity( 256 );
+	this->constants.SetGranularity( 16384 );
+}
+
+rxCommandBuffer::~rxCommandBuffer()
+{
+}
+
+void rxCommandBuffer::BeginPacket( rxSortKey key )
+{
+	this->order.Add( key, this->packets.Num() );
+
+	Packet & newPacket = this->packets.Alloc();
+	newPacket.key = key;
+	newPacket.firstCommand = this->commands.Num();
+	newPacket.numCommands = 0;
+}
+
+void rxCommandBuffer::SetConstants( const void* data, UINT size )
+{
+	AssertPtr( data );
+
+	// Keep the data 16-byte aligned relative to the start of the storage.
+	const mxUInt  offset = this->constants.Num();
+	const mxUInt  alignedSize = ( size + 15 ) & ~15;
+	this->constants.SetNum( offset + alignedSize, false );
+	MemCopy( this->constants.Ptr() + offset, data, size );
+
+	Command & newCommand = AddCommand( Cmd_SetConstants );
+	newCommand.arg = offset;
+	newCommand.size = size;
+}
+
+//
+//	rxCommandBuffer::Append
+//
+void rxCommandBuffer::Append( const rxCommandBuffer& other, UINT32 objectIndexBase )
+{
+	const mxUInt  commandBase = this->commands.Num();
+	const mxUInt  packetBase = this->packets.Num();
+	const mxUInt  constantBase = this->constants.Num();
+
+	const mxUInt  numCommands = other.commands.Num();
+	const mxUInt  numPackets = other.packets.Num();
+	const mxUInt  numConstantBytes = other.constants.Num();
+
+	// Copy the commands, rebasing offsets and indices.
+	this->commands.SetNum( commandBase + numCommands, false );
+
+	Command * dstCommands = this->commands.Ptr() + commandBase;
+	const Command * srcCommands = other.commands.Ptr();
+
+	for( mxUInt i = 0; i < numCommands; i++ )
+	{
+		Command & cmd = dstCommands[ i ];
+		cmd = srcCommands[ i ];
+
+		if( cmd.type == Cmd_SetConstants ) {
+			cmd.arg += constantBase;
+		}
+		else if( cmd.type == Cmd_Draw ) {
+			cmd.arg += objectIndexBase;
+		}
+	}
+
+	this->packets.SetNum( packetBase + numPackets, false );
+
+	Packet * dstPackets = this->packets.Ptr() + packetBase;
+	const Packet * srcPackets = other.packets.Ptr();
+
+	// The other buffer may have been sorted already, so the packets are added in their recorded order.
+	for( mxUInt i = 0; i < numPackets; i++ )
+	{
+		dstPackets[ i ].key = srcPackets[ i ].key;
+		dstPackets[ i ].firstCommand = srcPackets[ i ].firstCommand + commandBase;
+		dstPackets[ i ].numCommands = srcPackets[ i ].numCommands;
+
+		this->order.Add( srcPackets[ i ].key, packetBase + i );
+	}
+
+	if( numConstantBytes > 0 )
+	{
+		this->constants.SetNum( constantBase + numConstantBytes, false );
+		MemCopy( this->constants.Ptr() + constantBase, other.constants.Ptr(), numConstantBytes );
+	}
+}
+
+void rxCommandBuffer::Clear()
+{
+	this->commands.SetNum( 0, false );
+	this->packets.SetNum( 0, false );
+	this->constants.SetNum( 0, false );
+	this->order.Clear();
+}
+
+void rxCommandBuffer::Sort()
+{
+	this->order.Sort();
+}
+
+//
+//	rxCommandBuffer::Replay
+//
+void rxCommandBuffer::Replay( rxCommandReplayer& replayer ) const
+{
+	const Command * commands = this->commands.Ptr();
+	const Packet * packets = this->packets.Ptr();
+	const BYTE * constants = this->constants.Ptr();
+
+	for( mxUInt iPacket = 0; iPacket < this->order.Num(); iPacket++ )
+	{
+		const Packet & packet = packets[ this->order[ iPacket ].index ];
+
+		for( UINT32 iCmd = 0; iCmd < packet.numCommands; iCmd++ )
+		{
+			const Command & cmd = commands[ packet.firstCommand + iCmd ];
+
+			switch( cmd.type )
+			{
+			case Cmd_BindMaterial :
+				replayer.BindMaterial( cmd.material );
+				break;
+
+			case Cmd_SetConstants :
+				replayer.SetConstants( constants + cmd.arg, cmd.size );
+				break;
+
+			case Cmd_Draw :
+				replayer.Draw( cmd.arg );
+				break;
+
+			default:
+				Unreachable;
+			}
+		}
+	}
+}
+
+/*================================
+		Parallel recording
+================================*/
+
+namespace {
+
+//
+//	RecordChunkTask
+//
+class RecordChunkTask : public mxTask {
+public:
+	RecordChunkTask()
+		: recorder( null ), chunkIndex( 0 ), firstObject( 0 ), numObjects( 0 )
+	{}
+
+	void Execute()
+	{
+		this->recorder->RecordChunk( this->chunkIndex, this->firstObject, this->numObjects );
+	}
+
+public:
+	rxChunkRecorder *	recorder;
+	UINT	chunkIndex;
+	UINT	firstObject;
+	UINT	numObjects;
+};
+
+}//End of anonymous namespace
+
+UINT rxGetNumRecordingChunks( UINT numObjects )
+{
+	const mxTaskPool &  taskPool = GetGlobalTaskPool();
+	if( ! taskPool.IsInitialized() || ! taskPool.GetNumWorkerThreads() ) {
+		return 1;
+	}
+
+	// A few chunks per thread, so that threads which finish early can help the others.
+	const UINT  maxChunks = Min< UINT >( ( taskPool.GetNumWorkerThreads() + 1 ) * 2, MAX_RECORDING_CHUNKS );
+	const UINT  numChunks = numObjects / MIN_OBJECTS_PER_CHUNK;
+
+	return Clamp< UINT >( numChunks, 1, maxChunks );
+}
+
+void rxRecordInParallel( rxChunkRecorder& recorder, UINT numObjects, UINT numChunks )
+{
+	MX_PROFILE( "Record in parallel" );
+
+	Assert( numChunks > 0 && numChunks <= MAX_RECORDING_CHUNKS );
+
+	RecordChunkTask  tasks[ MAX_RECORDING_CHUNKS ];
+
+	for( UINT iChunk = 0; iChunk < numChunks; iChunk++ )
+	{
+		const UINT  start = (UINT)( (UINT64)numObjects * iChunk / numChunks );
+		const UINT  end = (UINT)( (UINT64)numObjects * ( iChunk + 1 ) / numChunks );
+
+		tasks[ iChunk ].recorder = &recorder;
+		tasks[ iChunk ].chunkIndex = iChunk;
+		tasks[ iChunk ].firstObject = start;
+		tasks[ iChunk ].numObjects = end - start;
+	}
+
+	// The first chunk is recorded on this thread.
+	mxTaskPool &  taskPool = GetGlobalTaskPool();
+	mxTaskCounter  counter;
+
+	for( UINT iChunk = 1; iChunk < numChunks; iChunk++ )
+	{
+		taskPool.Submit( &tasks[ iChunk ], &counter );
+	}
+
+	tasks[ 0 ].Execute();
+
+	taskPool.Wait( counter );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
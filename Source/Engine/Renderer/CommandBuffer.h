@@ -0,0 +1,180 @@
+/*
+=============================================================================
+	File:	CommandBuffer.h
+	Desc:	Backend-agnostic render command buffers, parallel recording.
+=============================================================================
+*/
+
+#ifndef __RX_COMMAND_BUFFER_H__
+#define __RX_COMMAND_BUFFER_H__
+
+namespace abc {
+
+class rxMaterial;
+
+/*
+=====================================================================
+
+	Command buffer.
+
+=====================================================================
+*/
+
+//
+//	rxCommandReplayer - receives the commands of a command buffer during replay.
+//
+Interface( rxCommandReplayer )
+{
+	virtual void	BindMaterial( const rxMaterial* material ) = 0;
+
+				// The data stays valid until the command buffer is modified.
+	virtual void	SetConstants( const void* data, UINT size ) = 0;
+
+				// 'objectIndex' is an index of the object in the render queue the buffer belongs to.
+	virtual void	Draw( UINT32 objectIndex ) = 0;
+};
+
+//
+//	rxCommandBuffer - a list of render commands grouped into packets.
+//
+//	Each packet is a short sequence of commands (e.g. bind material, set constants, draw)
+//	which is moved as a whole when the packets are sorted by their keys.
+//	The buffer doesn't depend on any graphics API, commands are executed by the backend during replay.
+//
+//	Separate buffers can be recorded on different threads and then merged on a single thread.
+//	The sort is stable, so if the buffers are appended in the same order as the objects were visited
+//	the result is identical to recording everything into one buffer.
+//
+class rxCommandBuffer {
+public:
+	enum ECommand
+	{
+		Cmd_BindMaterial,
+		Cmd_SetConstants,
+		Cmd_Draw,
+	};
+
+	struct Command
+	{
+		UINT32	type;	// ECommand
+		UINT32	arg;	// Cmd_SetConstants - offset into the constant storage, Cmd_Draw - object index
+		union {
+			const rxMaterial *	material;	// Cmd_BindMaterial
+			UINT32				size;		// Cmd_SetConstants - size of the data, in bytes
+		};
+	};
+
+	struct Packet
+	{
+		rxSortKey	key;
+		UINT32		firstCommand;
+		UINT32		numCommands;
+	};
+
+public:
+				rxCommandBuffer();
+				~rxCommandBuffer();
+
+				// Starts a new packet, the following commands are added to it.
+	void		BeginPacket( rxSortKey key );
+
+	void		BindMaterial( const rxMaterial* material );
+
+				// Copies the data into the buffer.
+	void		SetConstants( const void* data, UINT size );
+
+	void		Draw( UINT32 objectIndex );
+
+				// Appends the packets of another buffer in their recorded order,
+				// 'objectIndexBase' is added to object indices of draw commands.
+	void		Append( const rxCommandBuffer& other, UINT32 objectIndexBase );
+
+				// Removes all commands, doesn't free memory.
+	void		Clear();
+
+				// Sorts the packets by their keys in increasing order (stable radix sort).
+	void		Sort();
+
+				// Executes the commands in the order of packets, must be called after Sort().
+	void		Replay( rxCommandReplayer& replayer ) const;
+
+	mxUInt		NumPackets() const;
+	mxUInt		NumCommands() const;
+
+private:
+	Command &	AddCommand( ECommand type );
+
+private:
+	TArray< Command >	commands;
+	TArray< Packet >	packets;
+	TArray< BYTE >		constants;	// storage for Cmd_SetConstants data
+	rxDrawList			order;		// packet indices, sorted by Sort()
+};
+
+FORCEINLINE rxCommandBuffer::Command & rxCommandBuffer::AddCommand( ECommand type ) {
+	Assert( this->packets.Num() > 0 );	// BeginPacket() must be called first
+	this->packets.GetLast().numCommands++;
+	Command & newCommand = this->commands.Alloc();
+	newCommand.type = type;
+	return newCommand;
+}
+
+FORCEINLINE void rxCommandBuffer::BindMaterial( const rxMaterial* material ) {
+	Command & newCommand = AddCommand( Cmd_BindMaterial );
+	newCommand.arg = 0;
+	newCommand.material = material;
+}
+
+FORCEINLINE void rxCommandBuffer::Draw( UINT32 objectIndex ) {
+	Command & newCommand = AddCommand( Cmd_Draw );
+	newCommand.arg = objectIndex;
+	newCommand.material = null;
+}
+
+FORCEINLINE mxUInt rxCommandBuffer::NumPackets() const {
+	return this->packets.Num();
+}
+
+FORCEINLINE mxUInt rxCommandBuffer::NumCommands() const {
+	return this->commands.Num();
+}
+
+/*
+=====================================================================
+
+	Parallel recording.
+
+=====================================================================
+*/
+
+//
+//	rxChunkRecorder - records a contiguous range of visible objects into a separate render queue.
+//
+//	Chunks are recorded concurrently, so RecordChunk() must only write to the queue of the given chunk
+//	and to the objects in the given range.
+//
+Interface( rxChunkRecorder )
+{
+	virtual void	RecordChunk( UINT chunkIndex, UINT firstObject, UINT numObjects ) = 0;
+};
+
+enum ERecordingLimits
+{
+	MIN_OBJECTS_PER_CHUNK	= 256,	// smaller sets are not worth the overhead of scheduling tasks
+	MAX_RECORDING_CHUNKS	= 32,
+};
+
+// Returns the number of chunks to split the given number of objects into (1 means "record on this thread").
+UINT rxGetNumRecordingChunks( UINT numObjects );
+
+// Splits the objects into the given number of chunks and records them on worker threads of the global task pool.
+// Returns when all chunks have been recorded. The chunks are ordered by the indices of their objects.
+void rxRecordInParallel( rxChunkRecorder& recorder, UINT numObjects, UINT numChunks );
+
+}//End of namespace abc
+
+#endif // !__RX_COMMAND_BUFFER_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -440,6 +440,43 @@ rxTexture* D3D10Resources::LoadTexture( const mxFilePath& filename )
 	return pNewTexture;
 }
 
+//
+//	D3D10Resources::LoadTextureFromMemory
+//
+rxTexture* D3D10Resources::LoadTextureFromMemory( const mxChar* name, const void* pFileData, mxUInt numBytes )
+{
+	AssertPtr( name );
+	AssertPtr( pFileData );
+
+	if ( rxTexture * pTexture = this->textures.Find( name ) )
+	{
+		return pTexture;
+	}
+
+	ID3D10ShaderResourceView * pSRV = null;
+
+	HRESULT hr = D3DX10CreateShaderResourceViewFromMemory(
+		d3d10::device,
+		pFileData,
+		numBytes,
+		null,	// D3DX10_IMAGE_LOAD_INFO *
+		null,	// ID3DX10ThreadPump *
+		&pSRV,
+		null	// HRESULT *
+	);
+
+	if ( FAILED(hr) ) {
+		sys::Error( "Failed to load texture %s", name );
+		return null;
+	}
+
+	AssertPtr( pSRV );
+
+	D3D10Texture * pNewTexture = MX_NEW D3D10Texture( pSRV );
+	this->textures.Insert( name, pNewTexture );
+	return pNewTexture;
+}
+
 //
 //	D3D10Resources::CreateTexture
 //
@@ -454,8 +491,12 @@ Unimplemented;
 //
 rxTexture * D3D10Resources::GetTexture( const mxChar* name )
 {
-Unimplemented;
-	return null;
+	return this->textures.Find( name );
+}
+
+rxTexture * D3D10Resources::GetTexture( const mxNameId& name )
+{
+	return this->textures.Find( name );
 }
 
 //
@@ -561,6 +602,16 @@ rxMaterial * D3D10Resources::GetMaterial( const mxChar* name )
 	return null;
 }
 
+rxMaterial * D3D10Resources::GetMaterial( const mxNameId& name )
+{
+	if ( rxMaterial * pMaterial = this->materials.Find( name ) )
+	{
+		return pMaterial;
+	}
+	sys::Warning( "Failed to find material '%s', switching to fallback", name.ToChar() );
+	return null;
+}
+
 //
 //	D3D10Resources::GetStats
 //
@@ -215,8 +215,10 @@ public:
 	//--------------------------------------------------------
 
 	rxTexture *		LoadTexture( const mxFilePath& filename );
+	rxTexture *		LoadTextureFromMemory( const mxChar* name, const void* pFileData, mxUInt numBytes );
 	rxTexture *		CreateTexture( const void* pData, mxUInt numBytes, const rxTextureDescription& desc );
 	rxTexture *		GetTexture( const mxChar* name );
+	rxTexture *		GetTexture( const mxNameId& name );
 
 	//--------------------------------------------------------
 	//	Render materials.
@@ -225,6 +227,7 @@ public:
 	rxMaterial *	LoadMaterial( const mxFilePath& filename );
 	rxMaterial *	CreateMaterial( const rxMaterialDescription& desc );
 	rxMaterial *	GetMaterial( const mxChar* name );
+	rxMaterial *	GetMaterial( const mxNameId& name );
 
 	//--------------------------------------------------------
 	// Testing & Debugging.
@@ -357,8 +357,42 @@ ID3D10InputLayout * D3D10FullScreenQuad::GetScreenVertexLayout()
 		D3D10Model
 ================================*/
 
+namespace {
+
+	// Copies the given data into the specified byte range of a buffer created with D3D10_USAGE_DEFAULT.
+	void UpdateBufferRange( ID3D10Buffer* pBuffer, const void* pData, UINT offset, UINT size )
+	{
+		if( size == 0 ) {
+			return;
+		}
+
+		D3D10_BOX  destRegion;
+		destRegion.left		= offset;
+		destRegion.right	= offset + size;
+		destRegion.top		= 0;
+		destRegion.bottom	= 1;
+		destRegion.front	= 0;
+		destRegion.back		= 1;
+
+		d3d10::device->UpdateSubresource( pBuffer, 0, &destRegion, pData, 0, 0 );
+	}
+
+	// Incremented each time a model is created, removed, moved or its geometry is changed;
+	// used for detecting changes in shadow casters.
+	UINT	gSceneVersion = 0;
+
+	FORCEINLINE UINT NextModelVersion() {
+		return ++gSceneVersion;
+	}
+
+}//End of anonymous namespace
+
 D3D10Model::D3D10Model()
 	: worldTransform( _InitIdentity )
+	, bStaleGeometry( false )
+	, version( NextModelVersion() )
+	, bDynamicCaster( false )
+	, bWasDrawn( false )
 {}
 
 D3D10Model::~D3D10Model()
@@ -377,6 +411,11 @@ void D3D10Model::Setup( const rxModelDescription& desc )
 
 	const bool bCsgModel = ( desc.flags & EModelFlags::MF_DynamicGeometry );
 
+	this->version = NextModelVersion();
+	this->bDynamicCaster = bCsgModel;
+	this->bWasDrawn = false;
+	this->bStaleGeometry = false;
+
 	
 	if( bCsgModel )
 	{
@@ -388,80 +427,105 @@ void D3D10Model::Setup( const rxModelDescription& desc )
 
 
 
-	const D3D10_USAGE  bufferUsage = bCsgModel ? D3D10_USAGE_DYNAMIC : D3D10_USAGE_IMMUTABLE;
+	// Geometry of CSG models is usually changed partially, so their buffers are updated with UpdateSubresource().
+	const D3D10_USAGE  bufferUsage = bCsgModel ? D3D10_USAGE_DEFAULT : D3D10_USAGE_IMMUTABLE;
 
-	const UINT INITIAL_SIZE = MAX_UINT16;	// 64K
+	const SizeT vertexCount = desc.meshDesc.Vertices.VertexCount;
+	const SizeT vertexSize = desc.meshDesc.Vertices.VertexSize;
+	const SizeT indexCount = desc.meshDesc.Indices.IndexCount;
+	const SizeT indexSize = desc.meshDesc.Indices.IndexSize;
 
-	// Create vertex buffer.
+	if( bCsgModel )
 	{
-		const SizeT vertexCount = desc.meshDesc.Vertices.VertexCount;
-		const SizeT vertexSize = desc.meshDesc.Vertices.VertexSize;
+		Assert( vertexSize == sizeof(rxVertex) && indexSize == sizeof(rxIndex) );
 
-		D3D10_BUFFER_DESC vbd;
-		vbd.Usage			= bufferUsage;
-		vbd.ByteWidth		= bCsgModel ? (Max( vertexCount, INITIAL_SIZE ) * vertexSize) : vertexCount*vertexSize;
-		vbd.BindFlags		= D3D10_BIND_VERTEX_BUFFER;
-		vbd.CPUAccessFlags	= bCsgModel ? D3D10_CPU_ACCESS_WRITE : 0;
-		vbd.MiscFlags		= 0;
+		this->dynamicGeom = desc.dynamicGeom;
 
-		D3D10_SUBRESOURCE_DATA vinitData;	// initial data
-		vinitData.pSysMem = desc.meshDesc.Vertices.Data;
+		// Determine initial capacity of the buffers.
+		SizeT  vertexCapacity = vertexCount;
+		SizeT  indexCapacity = indexCount;
 
-		ensure( d3d10::device->CreateBuffer(
-			&vbd,
-			bCsgModel ? null : &vinitData,
-			&this->pVB.Ptr
-		));
+		switch( desc.dynamicGeom.allocationType )
+		{
+		case EHWBufferAlloc::HWA_Reserve :
+			vertexCapacity = Max( vertexCapacity, desc.dynamicGeom.bufferSize / vertexSize );
+			indexCapacity = Max( indexCapacity, desc.dynamicGeom.bufferSize / indexSize );
+			break;
 
-		AssertPtr( this->pVB );
+		case EHWBufferAlloc::HWA_Discardable :
+			{
+				const UINT INITIAL_SIZE = MAX_UINT16;	// 64K
+				vertexCapacity = Max( vertexCapacity, INITIAL_SIZE );
+				indexCapacity = Max( indexCapacity, INITIAL_SIZE );
+			}
+			break;
 
-		if( bCsgModel )
-		{
-			void * pData;
-			check( pVB->Map( D3D10_MAP::D3D10_MAP_WRITE_DISCARD, 0, &pData ) );
-			MemCopy( pData, desc.meshDesc.Vertices.Data, vertexCount * vertexSize );
-			pVB->Unmap();
+		default:
+			;
 		}
 
-		this->batch.StartVertex = 0;
-		this->batch.VertexCount = vertexCount;
-	}
+		CreateDynamicBuffers( vertexCapacity, indexCapacity );
 
-	// Create index buffer.
+		UpdateBufferRange( pVB, desc.meshDesc.Vertices.Data, 0, vertexCount * vertexSize );
+		UpdateBufferRange( pIB, desc.meshDesc.Indices.Data, 0, indexCount * indexSize );
+	}
+	else
 	{
-		const SizeT indexCount = desc.meshDesc.Indices.IndexCount;
-		const SizeT indexSize = desc.meshDesc.Indices.IndexSize;
-
-		D3D10_BUFFER_DESC ibd;
-		ibd.Usage			= bufferUsage;
-		ibd.ByteWidth		= bCsgModel ? (Max( indexCount, INITIAL_SIZE ) * indexSize) : indexCount*indexSize;
-		ibd.BindFlags		= D3D10_BIND_INDEX_BUFFER;
-		ibd.CPUAccessFlags	= bCsgModel ? D3D10_CPU_ACCESS_WRITE : 0;
-		ibd.MiscFlags		= 0;
-
-		D3D10_SUBRESOURCE_DATA iinitData;	// initial data
-		iinitData.pSysMem = desc.meshDesc.Indices.Data;
+		const rxMeshKey  meshKey( desc.meshDesc );
 
-		ensure( d3d10::device->CreateBuffer(
-			&ibd,
-			bCsgModel ? null : &iinitData,
-			&this->pIB.Ptr
-		));
+		if( !d3d10::scene->GetMeshCache().Find( meshKey, this->pVB, this->pIB ) )
+		{
+			// Create vertex buffer.
+			{
+				D3D10_BUFFER_DESC vbd;
+				vbd.Usage			= bufferUsage;
+				vbd.ByteWidth		= vertexCount*vertexSize;
+				vbd.BindFlags		= D3D10_BIND_VERTEX_BUFFER;
+				vbd.CPUAccessFlags	= 0;
+				vbd.MiscFlags		= 0;
+
+				D3D10_SUBRESOURCE_DATA vinitData;	// initial data
+				vinitData.pSysMem = desc.meshDesc.Vertices.Data;
+
+				ensure( d3d10::device->CreateBuffer(
+					&vbd,
+					&vinitData,
+					&this->pVB.Ptr
+				));
+
+				AssertPtr( this->pVB );
+			}
 
-		AssertPtr( this->pIB );
+			// Create index buffer.
+			{
+				D3D10_BUFFER_DESC ibd;
+				ibd.Usage			= bufferUsage;
+				ibd.ByteWidth		= indexCount*indexSize;
+				ibd.BindFlags		= D3D10_BIND_INDEX_BUFFER;
+				ibd.CPUAccessFlags	= 0;
+				ibd.MiscFlags		= 0;
+
+				D3D10_SUBRESOURCE_DATA iinitData;	// initial data
+				iinitData.pSysMem = desc.meshDesc.Indices.Data;
+
+				ensure( d3d10::device->CreateBuffer(
+					&ibd,
+					&iinitData,
+					&this->pIB.Ptr
+				));
+
+				AssertPtr( this->pIB );
+			}
 
-		if( bCsgModel )
-		{
-			void * pData;
-			check( pIB->Map( D3D10_MAP::D3D10_MAP_WRITE_DISCARD, 0, &pData ) );
-			MemCopy( pData, desc.meshDesc.Indices.Data, indexCount * indexSize );
-			pIB->Unmap();
+			d3d10::scene->GetMeshCache().Add( meshKey, this->pVB, this->pIB );
 		}
-
-		this->batch.StartIndex = 0;
-		this->batch.IndexCount = indexCount;
 	}
 
+	this->batch.StartVertex = 0;
+	this->batch.VertexCount = vertexCount;
+	this->batch.StartIndex = 0;
+	this->batch.IndexCount = indexCount;
+
 
 
 	this->depth = 0.f;
@@ -477,13 +541,24 @@ void D3D10Model::Destroy()
 
 void D3D10Model::Render( const rxView& view, rxQueue& queue )
 {
-	ToD3D10Queue( queue ).models.Add( this );
+	D3D10RenderQueue & renderQueue = ToD3D10Queue( queue );
+	renderQueue.models.Add( this );
+
+	this->bWasDrawn = true;
 
 	Vec4D  worldPosition( this->GetOrigin(), 1.0f );
 	Vec4D  worldPositionH( worldPosition * ToD3D10View( view ).ViewProjMatrix );
 	FLOAT  invW = mxMath::Reciprocal( worldPositionH.w );
 
 	this->depth = worldPositionH.z * invW;
+
+	renderQueue.AddModelDraw( renderQueue.models.Num() - 1, this->material, this->worldTransform, this->depth );
+}
+
+void D3D10Model::AddToBatch( rxInstanceBatcher& batcher, const rxMaterial* material,
+							const Matrix4& transform, UINT32 userIndex ) const
+{
+	batcher.Add( this->pVB, this->pIB, this->batch, material, transform, userIndex );
 }
 
 void D3D10Model::Remove()
@@ -494,6 +569,12 @@ void D3D10Model::Remove()
 void D3D10Model::SetTransform( const Matrix4& newWorldTransform )
 {
 	this->worldTransform = newWorldTransform;
+	this->version = NextModelVersion();
+
+	// Models which are placed before being drawn are considered static.
+	if( this->bWasDrawn ) {
+		this->bDynamicCaster = true;
+	}
 }
 
 void D3D10Model::SetMaterial( rxMaterial* newMaterial )
@@ -508,29 +589,46 @@ void D3D10Model::SetGeometry( const rxDynMeshData* newMesh )
 		DEBUG_CODE( sys::Warning("attempted to modify geometry of a static mesh") );
 		return;
 	}
-	
+
 	D3D10_BUFFER_DESC vbDesc;
 	this->pVB->GetDesc( &vbDesc );
 
 	D3D10_BUFFER_DESC ibDesc;
 	this->pIB->GetDesc( &ibDesc );
 
-	if( vbDesc.ByteWidth > newMesh->numVertices * sizeof(rxVertex)
-		&& ibDesc.ByteWidth > newMesh->numIndices * sizeof(rxIndex) )
+	const bool bFits = ( vbDesc.ByteWidth >= newMesh->numVertices * sizeof(rxVertex) )
+		&& ( ibDesc.ByteWidth >= newMesh->numIndices * sizeof(rxIndex) );
+
+	const bool bCanGrow = ( this->dynamicGeom.updateType == EHWBufferUpdate::HWU_GrowAsNeeded )
+		|| ( this->dynamicGeom.updateType == EHWBufferUpdate::HWU_GrowByChunks );
+
+	if( !bFits && bCanGrow )
 	{
-		{
-			void * pData;
-			check( pVB->Map( D3D10_MAP::D3D10_MAP_WRITE_DISCARD, 0, &pData ) );
-			MemCopy( pData, newMesh->vertices, newMesh->numVertices * sizeof(rxVertex) );
-			pVB->Unmap();
-		}
+		// Recreate the buffers with some space reserved for further growth.
+		CreateDynamicBuffers( newMesh->numVertices * 3 / 2, newMesh->numIndices * 3 / 2 );
 
-		{
-			void * pData;
-			check( pIB->Map( D3D10_MAP::D3D10_MAP_WRITE_DISCARD, 0, &pData ) );
-			MemCopy( pData, newMesh->indices, newMesh->numIndices * sizeof(rxIndex) );
-			pIB->Unmap();
-		}
+		UpdateBufferRange( pVB, newMesh->vertices, 0, newMesh->numVertices * sizeof(rxVertex) );
+		UpdateBufferRange( pIB, newMesh->indices, 0, newMesh->numIndices * sizeof(rxIndex) );
+
+		this->batch.StartVertex = 0;
+		this->batch.VertexCount = newMesh->numVertices;
+		this->batch.StartIndex = 0;
+		this->batch.IndexCount = newMesh->numIndices;
+	}
+	else if( bFits )
+	{
+		// Upload only the changed parts of the mesh.
+		// The unchanged parts are valid only if the previous update has been uploaded.
+		const UINT  firstVertex = this->bStaleGeometry ? 0 : Min( newMesh->firstChangedVertex, newMesh->numVertices );
+		const UINT  firstIndex = this->bStaleGeometry ? 0 : Min( newMesh->firstChangedIndex, newMesh->numIndices );
+
+		UpdateBufferRange( pVB, newMesh->vertices + firstVertex,
+			firstVertex * sizeof(rxVertex),
+			(newMesh->numVertices - firstVertex) * sizeof(rxVertex) );
+
+		UpdateBufferRange( pIB, newMesh->indices + firstIndex,
+			firstIndex * sizeof(rxIndex),
+			(newMesh->numIndices - firstIndex) * sizeof(rxIndex) );
 
 		this->batch.StartVertex = 0;
 		this->batch.VertexCount = newMesh->numVertices;
@@ -539,8 +637,44 @@ void D3D10Model::SetGeometry( const rxDynMeshData* newMesh )
 	}
 	else
 	{
-		Unimplemented;
+		DEBUG_CODE( sys::Warning("the new geometry doesn't fit into the model's buffers") );
+
+		// Nothing has been uploaded, the model keeps rendering its old geometry.
+		this->bStaleGeometry = true;
+		return;
 	}
+
+	this->bStaleGeometry = false;
+	this->version = NextModelVersion();
+}
+
+void D3D10Model::CreateDynamicBuffers( SizeT vertexCapacity, SizeT indexCapacity )
+{
+	// Buffers of zero size cannot be created.
+	enum { MIN_CAPACITY = 64 };
+
+	this->pVB.Release();
+	this->pIB.Release();
+
+	D3D10_BUFFER_DESC vbd;
+	vbd.Usage			= D3D10_USAGE_DEFAULT;
+	vbd.ByteWidth		= Max< SizeT >( vertexCapacity, MIN_CAPACITY ) * sizeof(rxVertex);
+	vbd.BindFlags		= D3D10_BIND_VERTEX_BUFFER;
+	vbd.CPUAccessFlags	= 0;
+	vbd.MiscFlags		= 0;
+
+	ensure( d3d10::device->CreateBuffer( &vbd, null, &this->pVB.Ptr ) );
+	AssertPtr( this->pVB );
+
+	D3D10_BUFFER_DESC ibd;
+	ibd.Usage			= D3D10_USAGE_DEFAULT;
+	ibd.ByteWidth		= Max< SizeT >( indexCapacity, MIN_CAPACITY ) * sizeof(rxIndex);
+	ibd.BindFlags		= D3D10_BIND_INDEX_BUFFER;
+	ibd.CPUAccessFlags	= 0;
+	ibd.MiscFlags		= 0;
+
+	ensure( d3d10::device->CreateBuffer( &ibd, null, &this->pIB.Ptr ) );
+	AssertPtr( this->pIB );
 }
 
 void D3D10Model::RenderGeometry()
@@ -581,6 +715,48 @@ void D3D10Model::RenderGeometry()
 	}
 }
 
+void D3D10Model::RenderGeometryInstanced( UINT numInstances, UINT firstInstance )
+{
+	d3d10::device->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+
+	const UINT vertexSize = sizeof(rxVertex);
+	const UINT offset = 0;
+
+	d3d10::device->IASetVertexBuffers(
+		0,				// StartSlot
+		1,				// NumBuffers
+		& this->pVB.Ptr,
+		& vertexSize,
+		& offset
+	);
+
+	if( this->pIB != null )
+	{
+		d3d10::device->IASetIndexBuffer(
+			this->pIB,
+			DXGI_FORMAT_R32_UINT,
+			0	// Offset
+		);
+
+		d3d10::device->DrawIndexedInstanced(
+			this->batch.IndexCount,
+			numInstances,
+			0,	// StartIndexLocation
+			0,	// BaseVertexLocation
+			firstInstance
+		);
+	}
+	else
+	{
+		d3d10::device->DrawInstanced(
+			this->batch.VertexCount,
+			numInstances,
+			0,	// StartVertexLocation
+			firstInstance
+		);
+	}
+}
+
 void D3D10Model::RenderShadowMap()
 {
 	RenderGeometry();
@@ -595,6 +771,78 @@ bool D3D10Model::IsOk() const
 		;
 }
 
+/*================================
+		D3D10MeshCache
+================================*/
+
+D3D10MeshCache::D3D10MeshCache()
+{}
+
+D3D10MeshCache::~D3D10MeshCache()
+{
+	Clear();
+}
+
+bool D3D10MeshCache::Find( const rxMeshKey& key, DXPtr< ID3D10Buffer > &OutVB, DXPtr< ID3D10Buffer > &OutIB ) const
+{
+	Entry *const * entry = this->entries.Find( key );
+	if( entry == null ) {
+		return false;
+	}
+	OutVB = (*entry)->pVB;
+	OutIB = (*entry)->pIB;
+	return true;
+}
+
+void D3D10MeshCache::Add( const rxMeshKey& key, ID3D10Buffer* pVB, ID3D10Buffer* pIB )
+{
+	AssertPtr( pVB );
+	Assert( ! this->entries.Contains( key ) );
+
+	Entry * newEntry = MX_NEW Entry();
+	newEntry->key	= key;
+	newEntry->pVB	= pVB;
+	newEntry->pIB	= pIB;
+
+	this->entries.Set( key, newEntry );
+	this->entriesByVB.Set( pVB, newEntry );
+}
+
+void D3D10MeshCache::ReleaseUnused( ID3D10Buffer* pVB )
+{
+	if( pVB == null ) {
+		return;
+	}
+	Entry *const * found = this->entriesByVB.Find( pVB );
+	if( found == null ) {
+		return;	// dynamic geometry is not shared
+	}
+	Entry * entry = *found;
+
+	// Get the reference count of the buffer.
+	pVB->AddRef();
+	const ULONG  refCount = pVB->Release();
+
+	// The only reference is held by the cache.
+	if( refCount == 1 )
+	{
+		this->entriesByVB.Remove( pVB );
+		this->entries.Remove( entry->key );
+		MX_FREE( entry );
+	}
+}
+
+void D3D10MeshCache::Clear()
+{
+	for( UINT iEntry = 0; iEntry < this->entries.Num(); iEntry++ )
+	{
+		Entry * entry = this->entries.GetValueAt( iEntry );
+		MX_FREE( entry );
+	}
+	this->entries.Clear();
+	this->entriesByVB.Clear();
+}
+
 const Vec3D & D3D10Model::GetOrigin() const {
 	return this->worldTransform.GetTranslation();
 }
@@ -616,6 +864,41 @@ D3D10RenderQueue::D3D10RenderQueue()
 D3D10RenderQueue::~D3D10RenderQueue()
 {}
 
+//
+//	D3D10RenderQueue::Append
+//
+void D3D10RenderQueue::Append( const D3D10RenderQueue& other )
+{
+	Assert( this->Num() + other.Num() <= MAX_QUEUE_SIZE );
+
+	const UINT32  firstModel = this->models.Num();
+	const UINT32  firstTranslucent = this->translucent.Num();
+
+	for( UINT i = 0; i < other.models.Num(); i++ ) {
+		this->models.Add( other.models[i] );
+	}
+	for( UINT i = 0; i < other.translucent.Num(); i++ ) {
+		this->translucent.Add( other.translucent[i] );
+	}
+	for( UINT i = 0; i < other.globalLights.Num(); i++ ) {
+		this->globalLights.Add( other.globalLights[i] );
+	}
+	for( UINT i = 0; i < other.localLights.Num(); i++ ) {
+		this->localLights.Add( other.localLights[i] );
+	}
+	for( UINT i = 0; i < other.miniLights.Num(); i++ ) {
+		this->miniLights.Add( other.miniLights[i] );
+	}
+	for( UINT i = 0; i < other.portals.Num(); i++ ) {
+		this->portals.Add( other.portals[i] );
+	}
+	for( UINT i = 0; i < other.skies.Num(); i++ ) {
+		this->skies.Add( other.skies[i] );
+	}
+
+	this->AppendDraws( other, firstModel, firstTranslucent );
+}
+
 /*================================
 		D3D10RenderStage
 ================================*/
@@ -702,7 +985,8 @@ void D3D10GeometryStage::Initialize()
 {
 	// Load shaders.
 	{
-		this->fxFillGBuffer			.Load( PATH_TO_SHADERS_"FillGBuffer.fx" );
+		this->fxFillGBuffer				.Load( PATH_TO_SHADERS_"FillGBuffer.fx" );
+		this->fxFillGBuffer_Instanced	.Load( PATH_TO_SHADERS_"FillGBuffer_Instanced.fx" );
 	}
 
 	// Create vertex declarations.
@@ -725,34 +1009,96 @@ void D3D10GeometryStage::Initialize()
 			& this->geometryVertexLayout.Ptr )
 		);
 	}
+
+	// Create vertex declaration for instancing ( world transforms are read from the slot 1 ).
+	{
+		D3D10_INPUT_ELEMENT_DESC vertexDesc[] =
+		{
+			{ TEXT("POSITION"),   0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 0,  D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ TEXT("NORMAL"),     0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ TEXT("TANGENT"),    0, DXGI_FORMAT_R32G32B32_FLOAT,		0, 24, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ TEXT("TEXCOORD"),   0, DXGI_FORMAT_R32G32_FLOAT,			0, 36, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ TEXT("WORLD"),      0, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, 0,  D3D10_INPUT_PER_INSTANCE_DATA, 1 },
+			{ TEXT("WORLD"),      1, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, 16, D3D10_INPUT_PER_INSTANCE_DATA, 1 },
+			{ TEXT("WORLD"),      2, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, 32, D3D10_INPUT_PER_INSTANCE_DATA, 1 },
+			{ TEXT("WORLD"),      3, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, 48, D3D10_INPUT_PER_INSTANCE_DATA, 1 },
+		};
+
+		D3D10_PASS_DESC passDesc;
+		this->fxFillGBuffer_Instanced.GetActivePass()->GetDesc( &passDesc );
+
+		check( d3d10::device->CreateInputLayout(
+			vertexDesc, ARRAY_SIZE( vertexDesc ),
+			passDesc.pIAInputSignature,
+			passDesc.IAInputSignatureSize,
+			& this->instancedVertexLayout.Ptr )
+		);
+	}
+
+	this->instanceBuffer.Initialize();
 }
 
 void D3D10GeometryStage::Shutdown()
 {
-	this->fxFillGBuffer		.Unload();
+	this->fxFillGBuffer				.Unload();
+	this->fxFillGBuffer_Instanced	.Unload();
 
 	this->geometryVertexLayout = null;
+	this->instancedVertexLayout = null;
+
+	this->instanceBuffer.Shutdown();
 }
 
 void D3D10GeometryStage::Render( const D3D10ViewConstants& view, D3D10RenderQueue& renderQueue )
 {
 	D3D10RenderStage::PrepareRender();
 
-	d3d10::device->IASetInputLayout( this->geometryVertexLayout );
+	// Group solid objects with the same geometry and material.
+	rxBatchOpaqueDraws( renderQueue, this->instanceBatcher );
+
+	this->instanceBuffer.Update( this->instanceBatcher.GetInstanceTransforms(), this->instanceBatcher.NumDraws() );
 
 	// Render solid objects.
-	for ( IndexT iModel = 0; iModel < renderQueue.models.Num(); iModel++ )
+	rxGroupDrawState  drawState( d3d10::stats );
+
+	this->fxFillGBuffer_Instanced.SetMatrices( Matrix4::mat4_identity, view.ViewProjMatrix );
+	this->instanceBuffer.Bind( 1 );
+
+	for ( UINT iGroup = 0; iGroup < this->instanceBatcher.NumGroups(); iGroup++ )
 	{
-		D3D10Model * model = renderQueue.models[ iModel ];
+		const rxInstanceBatcher::Group & group = this->instanceBatcher.GetGroup( iGroup );
+
+		// all models in the group have the same geometry and material
+		D3D10Model * model = renderQueue.models[ this->instanceBatcher.GetInstanceIndices()[ group.firstInstance ] ];
+
+		const bool bInstanced = rxGroupDrawState::IsInstanced( group );
+
+		D3D10Shader_FillGBuffer & shader = bInstanced ? this->fxFillGBuffer_Instanced : this->fxFillGBuffer;
+
+		if ( drawState.BeginGroup( group ) )
+		{
+			shader.SetMaterial( model->material );
+		}
+
+		if ( bInstanced )
+		{
+			d3d10::device->IASetInputLayout( this->instancedVertexLayout );
+			shader.Apply();
 
-		this->fxFillGBuffer.SetMatrices( model->worldTransform, view.ViewProjMatrix );
-		this->fxFillGBuffer.SetMaterial( model->material );
-		this->fxFillGBuffer.Apply();
-		
-		model->RenderGeometry();
+			model->RenderGeometryInstanced( group.numInstances, group.firstInstance );
+		}
+		else
+		{
+			d3d10::device->IASetInputLayout( this->geometryVertexLayout );
+			shader.SetMatrices( model->worldTransform, view.ViewProjMatrix );
+			shader.Apply();
+
+			model->RenderGeometry();
+		}
 	}
 
 	this->fxFillGBuffer.Unbind();
+	this->fxFillGBuffer_Instanced.Unbind();
 }
 
 /*================================
@@ -918,6 +1264,46 @@ void D3D10PointLight::RenderLocalLight( const D3D10ViewConstants& view )
 	shader.Unbind();
 }
 
+void D3D10PointLight::AddToClusters( const D3D10ViewConstants& view, rxLightClusters & clusters ) const
+{
+	Vec3D  viewPosition( this->data.position );
+	view.ViewMatrix.TransformVector( viewPosition );
+
+	clusters.AddPointLight( viewPosition, this->data.range );
+}
+
+/*================================
+		D3D10ShadowCache
+================================*/
+
+D3D10ShadowCache::D3D10ShadowCache()
+	: lightViewProj( _InitIdentity )
+	, resolution( 0 )
+	, sceneVersion( 0 )
+	, bValid( false )
+{}
+
+D3D10ShadowCache::~D3D10ShadowCache()
+{
+	Shutdown();
+}
+
+void D3D10ShadowCache::Initialize( UINT maximumResolution )
+{
+	this->staticLayer.Initialize( maximumResolution );
+	this->shadowMap.Initialize( maximumResolution );
+	this->bValid = false;
+}
+
+void D3D10ShadowCache::Shutdown()
+{
+	this->staticLayer.Shutdown();
+	this->shadowMap.Shutdown();
+	this->staticCasters.Clear();
+	this->dynamicCasters.Clear();
+	this->bValid = false;
+}
+
 /*================================
 		D3D10SpotLight
 ================================*/
@@ -928,6 +1314,7 @@ D3D10SpotLight::D3D10SpotLight(
 	   FLOAT range, FLOAT innerAngle, FLOAT outerAngle
 	)
 	: view( _NoInit )
+	, shadowCache( null )
 {
 	rxLight::Init( desc );
 
@@ -949,7 +1336,12 @@ D3D10SpotLight::D3D10SpotLight(
 }
 
 D3D10SpotLight::~D3D10SpotLight()
-{}
+{
+	if( this->shadowCache != null ) {
+		MX_FREE( this->shadowCache );
+		this->shadowCache = null;
+	}
+}
 
 void D3D10SpotLight::RecalcViewAndTransform() const
 {
@@ -1116,8 +1508,13 @@ void D3D10SpotLight::RenderLocalLight( const D3D10ViewConstants& view )
 	{
 		Matrix4 lightVP = this->view.ViewMatrix * this->view.ProjMatrix;
 
+		if( this->shadowCache == null ) {
+			this->shadowCache = MX_NEW D3D10ShadowCache();
+			this->shadowCache->Initialize( DEFAULT_SHADOWMAP_RESOLUTION );
+		}
+
 		UINT smResolution = DEFAULT_SHADOWMAP_RESOLUTION;
-		D3D10DepthMap & shadowMap = d3d10::scene->GetLightStage().BuildShadowMap( this->view, smResolution );
+		D3D10DepthMap & shadowMap = d3d10::scene->GetLightStage().BuildShadowMap( this->view, smResolution, *this->shadowCache );
 
 		// reverse backface cull mode when the eye is inside the light volume
 		if ( this->ContainsPoint( view.EyePosition ) ) {
@@ -1152,11 +1549,23 @@ void D3D10SpotLight::RenderLocalLight( const D3D10ViewConstants& view )
 	}
 }
 
+void D3D10SpotLight::AddToClusters( const D3D10ViewConstants& view, rxLightClusters & clusters ) const
+{
+	Vec3D  viewPosition( this->data.position );
+	view.ViewMatrix.TransformVector( viewPosition );
+
+	Vec3D  viewDirection( this->data.direction );
+	view.ViewMatrix.TransformNormal( viewDirection );
+
+	clusters.AddSpotLight( viewPosition, viewDirection, this->data.range, this->data.cosPhi );
+}
+
 /*================================
 		D3D10LightStageData
 ================================*/
 
 D3D10LightStageData::D3D10LightStageData()
+	: tempVisibleSet( &GetFrameArena() )
 {}
 
 D3D10LightStageData::~D3D10LightStageData()
@@ -1164,10 +1573,6 @@ D3D10LightStageData::~D3D10LightStageData()
 
 void D3D10LightStageData::Initialize()
 {
-	// Initialize render target for shadow mapping first
-	// so that they are placed in the best (fastest) portion of VRAM.
-	this->shadowMap.Initialize( DEFAULT_SHADOWMAP_RESOLUTION );
-
 	// Load shaders.
 	{
 		this->fxAmbientLight		.Load( PATH_TO_SHADERS_"AmbientLight.fx" );
@@ -1176,10 +1581,13 @@ void D3D10LightStageData::Initialize()
 		this->fxSpotLight			.Load( PATH_TO_SHADERS_"Light_Spot.fx" );
 
 		this->fxBuildShadowMap		.Load( PATH_TO_SHADERS_"BuildShadowMap.fx" );
+		this->fxBuildShadowMap_Instanced	.Load( PATH_TO_SHADERS_"BuildShadowMap_Instanced.fx" );
 
 		this->fxSpotLight_Shadowed	.Load( PATH_TO_SHADERS_"Light_Spot_Shadowed.fx" );
 	}
 
+	this->shadowInstanceBuffer.Initialize();
+
 	// Create vertex declarations for drawing light shapes.
 	{
 		D3D10_INPUT_ELEMENT_DESC vertexDesc[] =
@@ -1257,14 +1665,14 @@ void D3D10LightStageData::Initialize()
 
 void D3D10LightStageData::Shutdown()
 {
-	this->shadowMap.Shutdown();
-
 	this->fxAmbientLight		.Unload();
 	this->fxDirectionalLight	.Unload();
 	this->fxPointLight			.Unload();
 	this->fxSpotLight			.Unload();
 
 	this->fxBuildShadowMap		.Unload();
+	this->fxBuildShadowMap_Instanced	.Unload();
+	this->shadowInstanceBuffer.Shutdown();
 
 	this->fxSpotLight_Shadowed	.Unload();
 
@@ -1339,6 +1747,11 @@ void D3D10LightStage::Render( const D3D10ViewConstants& view, D3D10RenderQueue&
 		}
 	}
 
+#if RX_LIGHT_CLUSTERS
+	// Assign local lights to clusters of the view frustum.
+	BuildLightClusters( view, renderQueue );
+#endif
+
 	// Render local lights.
 	{
 		d3d10::device->IASetInputLayout( this->data.lightShapeVertexLayout );
@@ -1351,42 +1764,200 @@ void D3D10LightStage::Render( const D3D10ViewConstants& view, D3D10RenderQueue&
 	}
 }
 
-D3D10DepthMap & D3D10LightStage::BuildShadowMap( const mxSceneView& lightView, UINT resolution )
+void D3D10LightStage::BuildLightClusters( const D3D10ViewConstants& view, D3D10RenderQueue& renderQueue )
+{
+	this->lightClusters.SetProjection( view.ProjectionMatrix );
+	this->lightClusters.Clear();
+
+	for ( IndexT iLight = 0; iLight < renderQueue.localLights.Num(); iLight++ )
+	{
+		renderQueue.localLights[ iLight ]->AddToClusters( view, this->lightClusters );
+	}
+
+	this->lightClusters.Build();
+
+#if RX_DEBUG_LIGHT_CLUSTERS
+	Assert( this->lightClusters.CheckAgainstReference() );
+#endif
+}
+
+namespace {
+
+	// Updates the cached caster at the given index, returns 'true' if it has changed.
+	bool UpdateShadowCaster( TArray< D3D10ShadowCache::Caster > & casters, UINT index, const D3D10Model* model )
+	{
+		if( index < casters.Num() )
+		{
+			D3D10ShadowCache::Caster & caster = casters[ index ];
+			if( caster.model == model && caster.version == model->version ) {
+				return false;
+			}
+		}
+		else
+		{
+			casters.SetNum( index + 1, false );
+		}
+		casters[ index ].model = model;
+		casters[ index ].version = model->version;
+		return true;
+	}
+
+	// Updates the cached list of casters (static or dynamic), returns 'true' if it has changed.
+	bool UpdateShadowCasters( TArray< D3D10ShadowCache::Caster > & casters, const D3D10RenderQueue& queue, bool bDynamic )
+	{
+		bool bChanged = false;
+		UINT numCasters = 0;
+		for( IndexT iModel = 0; iModel < queue.models.Num(); iModel++ )
+		{
+			const D3D10Model * model = queue.models[ iModel ];
+			if( model->bDynamicCaster == bDynamic )
+			{
+				bChanged |= UpdateShadowCaster( casters, numCasters, model );
+				numCasters++;
+			}
+		}
+		if( numCasters != casters.Num() )
+		{
+			casters.SetNum( numCasters, false );
+			bChanged = true;
+		}
+		return bChanged;
+	}
+
+}//End of anonymous namespace
+
+//
+//	D3D10LightStage::BuildShadowMap
+//
+//	The light frustum is only culled if something in the scene has changed since the last update.
+//	The static layer is re-rendered only if the light or static casters in its frustum have changed;
+//	otherwise, if some dynamic casters have changed, they are drawn over a copy of the static layer.
+//
+D3D10DepthMap & D3D10LightStage::BuildShadowMap( const mxSceneView& lightView, UINT resolution, D3D10ShadowCache & cache )
 {
 	D3D10_STAT_COUNTER( d3d10::stats.shadowMapRenderTime );
 
+	const Matrix4  lightViewProj( lightView.ViewMatrix * lightView.ProjMatrix );
+
+	const bool bSameLight = cache.bValid
+		&& ( cache.resolution == resolution )
+		&& ( cache.lightViewProj == lightViewProj );
+
+	// Nothing has changed since the last update.
+	if( bSameLight && ( cache.sceneVersion == gSceneVersion ) )
+	{
+		d3d10::stats.numShadowCacheHits++;
+		return cache.shadowMap;
+	}
+
+	// Find shadow casters.
 	D3D10View  fullLightView;
 	d3d10::scene->BuildRenderQueue( lightView,
 						fullLightView, this->data.tempVisibleSet, this->data.tempRenderQueue );
 
 	this->data.tempVisibleSet.Empty();
 
-	this->data.shadowMap.Bind( resolution );
-/**/
-	// Render shadow-casting geometry.
+	const bool bStaticChanged = UpdateShadowCasters( cache.staticCasters, this->data.tempRenderQueue, false );
+	const bool bDynamicChanged = UpdateShadowCasters( cache.dynamicCasters, this->data.tempRenderQueue, true );
+
+	cache.lightViewProj = lightViewProj;
+	cache.resolution = resolution;
+	cache.sceneVersion = gSceneVersion;
+
+	if( bSameLight && !bStaticChanged && !bDynamicChanged )
+	{
+		// Only objects outside the light frustum have changed.
+		this->data.tempRenderQueue.Clear();
+		d3d10::stats.numShadowCacheHits++;
+		return cache.shadowMap;
+	}
 
 	DXPtr< ID3D10InputLayout > pOldIL;
 	d3d10::device->IAGetInputLayout( & pOldIL.Ptr );
 
 	MX_OPTIMIZE("use separate vertex stream (positions only) to render depth shadows, don't use full vertex format")
-	d3d10::device->IASetInputLayout( d3d10::scene->GetGeometryStage().geometryVertexLayout );
 
-	for( IndexT iModel = 0; iModel < this->data.tempRenderQueue.models.Num(); iModel++ )
+	if( !bSameLight || bStaticChanged )
 	{
-		D3D10Model * model = this->data.tempRenderQueue.models[ iModel ];
+		// Render static shadow-casting geometry.
+		cache.staticLayer.Bind( resolution );
+		RenderShadowCasters( fullLightView, false );
+		cache.staticLayer.Unbind();
 
-		Matrix4 lightWVP( model->worldTransform * fullLightView.constants.ViewProjMatrix );
-		this->data.fxBuildShadowMap.Bind( lightWVP );
-		this->data.fxBuildShadowMap.Apply();
-		
-		model->RenderShadowMap();
+		d3d10::stats.numShadowCacheMisses++;
+	}
+	else
+	{
+		d3d10::stats.numShadowDynamicUpdates++;
 	}
+
+	// Render dynamic shadow-casting geometry on top of the static layer.
+	d3d10::device->CopyResource( cache.shadowMap.pTexture, cache.staticLayer.pTexture );
+
+	cache.shadowMap.Bind( resolution, false );
+	RenderShadowCasters( fullLightView, true );
+	cache.shadowMap.Unbind();
+
 	this->data.tempRenderQueue.Clear();
 
 	d3d10::device->IASetInputLayout( pOldIL );
 
-	this->data.shadowMap.Unbind();
-	return this->data.shadowMap;
+	cache.bValid = true;
+
+	return cache.shadowMap;
+}
+
+void D3D10LightStage::RenderShadowCasters( const D3D10View& lightView, bool bDynamic )
+{
+	D3D10RenderQueue & queue = this->data.tempRenderQueue;
+	rxInstanceBatcher & batcher = this->data.shadowCasterBatcher;
+
+	// Group casters with the same geometry (materials don't matter for depth-only rendering).
+	batcher.Clear();
+
+	for( IndexT iModel = 0; iModel < queue.models.Num(); iModel++ )
+	{
+		const D3D10Model * model = queue.models[ iModel ];
+		if( model->bDynamicCaster != bDynamic ) {
+			continue;
+		}
+		model->AddToBatch( batcher, null, model->worldTransform, iModel );
+	}
+
+	batcher.Build();
+	this->data.shadowInstanceBuffer.Update( batcher.GetInstanceTransforms(), batcher.NumDraws() );
+	this->data.shadowInstanceBuffer.Bind( 1 );
+
+	this->data.fxBuildShadowMap_Instanced.Bind( lightView.constants.ViewProjMatrix );
+
+	for( UINT iGroup = 0; iGroup < batcher.NumGroups(); iGroup++ )
+	{
+		const rxInstanceBatcher::Group & group = batcher.GetGroup( iGroup );
+		D3D10Model * model = queue.models[ batcher.GetInstanceIndices()[ group.firstInstance ] ];
+
+		if( rxGroupDrawState::IsInstanced( group ) )
+		{
+			d3d10::device->IASetInputLayout( d3d10::scene->GetGeometryStage().instancedVertexLayout );
+			this->data.fxBuildShadowMap_Instanced.Apply();
+
+			model->RenderGeometryInstanced( group.numInstances, group.firstInstance );
+
+			d3d10::stats.numInstancedBatches++;
+			d3d10::stats.numBatchesSaved += group.numInstances - 1;
+		}
+		else
+		{
+			d3d10::device->IASetInputLayout( d3d10::scene->GetGeometryStage().geometryVertexLayout );
+
+			Matrix4 lightWVP( model->worldTransform * lightView.constants.ViewProjMatrix );
+			this->data.fxBuildShadowMap.Bind( lightWVP );
+			this->data.fxBuildShadowMap.Apply();
+
+			model->RenderShadowMap();
+		}
+
+		d3d10::stats.numBatches++;
+	}
 }
 
 rxParallelLight * D3D10LightStage::CreateParallelLight( const Vec3D& direction,
@@ -1443,13 +2014,13 @@ void D3D10AlphaStage::Render( const D3D10ViewConstants& view, D3D10RenderQueue&
 {
 	D3D10RenderStage::PrepareRender();
 
-	// Render billboards.
+	// Render billboards (sorted back-to-front).
 	{
 		Matrix4  invView( view.ViewMatrix.Inverse() );
 
-		for( IndexT iObj = 0; iObj < renderQueue.translucent.Num(); iObj++ )
+		for( IndexT iDraw = 0; iDraw < renderQueue.translucentDraws.Num(); iDraw++ )
 		{
-			D3D10Billboard * pObj = renderQueue.translucent[ iObj ];
+			D3D10Billboard * pObj = renderQueue.translucent[ renderQueue.translucentDraws[ iDraw ].index ];
 			
 			// Construct billboard matrix.
 			Matrix4  wvp;
@@ -1526,7 +2097,13 @@ void D3D10Billboard::SetSize( const Vec2D& newSize )
 
 void D3D10Billboard::Render( const rxView& view, rxQueue& queue )
 {
-	ToD3D10Queue( queue ).translucent.Add( this );
+	D3D10RenderQueue & renderQueue = ToD3D10Queue( queue );
+	renderQueue.translucent.Add( this );
+
+	Vec4D  worldPositionH( Vec4D( this->origin, 1.0f ) * ToD3D10View( view ).ViewProjMatrix );
+	const FLOAT  depth = worldPositionH.z * mxMath::Reciprocal( worldPositionH.w );
+
+	renderQueue.AddTranslucentDraw( renderQueue.translucent.Num() - 1, depth );
 }
 
 void D3D10Billboard::Remove()
@@ -2442,6 +3019,7 @@ void D3D10MiscData::Shutdown()
 ================================*/
 
 D3D10Scene::D3D10Scene()
+	: visibleSet( &GetFrameArena() )
 {
 	ENSURE_ONE_CALL;
 }
@@ -2510,10 +3088,12 @@ void D3D10Scene::Shutdown()
 
 	this->renderQueue.Clear();
 	this->visibleSet.Empty();
+	this->chunkQueues.DeleteContents( true );
 
 	this->miscData.Shutdown();
 
 	this->allModels.DeleteContents( true );
+	this->meshCache.Clear();
 	this->allBillboards.DeleteContents( true );
 	this->allSkies.DeleteContents( true );
 	this->allPortals.DeleteContents( true );
@@ -2532,15 +3112,7 @@ void D3D10Scene::BuildRenderQueue( const mxSceneView& view,
 	}
 
 	// Render the visible set. Generate a render queue from the visible set.
-	{
-		MX_PROFILE( "Gen render queue" );
-		OutQueue.Clear();
-		for( SizeT iEnt = 0; iEnt < OutVisibleSet.GetNum(); iEnt++ )
-		{
-			mxEntity * pEnt = OutVisibleSet.Get( iEnt );
-			pEnt->GetGraphics()->Render( OutFullView, OutQueue );
-		}
-	}
+	rxRecordRenderQueue( OutFullView, OutVisibleSet, this->chunkQueues, OutQueue );
 }
 
 //
@@ -2677,8 +3249,13 @@ rxPostEffectManager* D3D10Scene::GetPostEffectManager()
 void D3D10Scene::RemoveModel( D3D10Model* theModel )
 {
 	AssertPtr( theModel );
+	NextModelVersion();
 	this->allModels.Remove( theModel );
+
+	ID3D10Buffer * pSharedVB = theModel->pVB;
 	MX_FREE( theModel );
+
+	this->meshCache.ReleaseUnused( pSharedVB );
 }
 
 void D3D10Scene::RemoveSky( D3D10Sky* theSky )
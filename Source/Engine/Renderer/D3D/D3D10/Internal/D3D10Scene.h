@@ -179,7 +179,7 @@ class D3D10Sky;
 //
 //	D3D10RenderQueue - collection of objects that can be rendered.
 //
-struct D3D10RenderQueue : public rxQueue {
+struct D3D10RenderQueue : public rxRenderQueue {
 public:
 	enum ELimits
 	{
@@ -238,7 +238,12 @@ public:
 		miniLights	.Reset();
 		portals		.Reset();
 		skies		.Reset();
+
+		ClearDraws();
 	}
+
+	// Appends the objects and draws of another queue (e.g. recorded on another thread).
+	void Append( const D3D10RenderQueue& other );
 };
 
 FORCEINLINE
@@ -285,13 +290,24 @@ public:
 	// render geometry for filling G-buffer
 	void	RenderGeometry();
 
+	// render several instances of the geometry (the instance stream must be bound to the slot 1)
+	void	RenderGeometryInstanced( UINT numInstances, UINT firstInstance );
+
 	// render shadow for shadow mapping
 	void	RenderShadowMap();
 
+	// adds a draw of this model to the batcher (see rxBatchOpaqueDraws())
+	void	AddToBatch( rxInstanceBatcher& batcher, const rxMaterial* material,
+				const Matrix4& transform, UINT32 userIndex ) const;
+
 //	void	RenderShadowVolume( const rxView& view );
 
 	const Vec3D & GetOrigin() const;
 
+private:
+	// Creates buffers for dynamic geometry (the old buffers are released).
+	void	CreateDynamicBuffers( SizeT vertexCapacity, SizeT indexCapacity );
+
 public:
 	Matrix4					worldTransform;
 	
@@ -300,9 +316,51 @@ public:
 	
 	rxBatch			batch;
 
+	rxDynamicGeometry	dynamicGeom;	// settings for managing dynamic geometry
+	bool				bStaleGeometry;	// the buffers don't hold the last mesh, partial updates cannot be used
+
 	TPtr< D3D10Material >	material;
 
 	FLOAT		depth;	// for sorting primitives by depth
+
+	// For caching shadow maps.
+	UINT		version;		// changes whenever the geometry or the placement of the model changes
+	bool		bDynamicCaster;	// true if the model has dynamic geometry or has been moved after it was first drawn
+	bool		bWasDrawn;
+};
+
+//
+//	D3D10MeshCache - allows static models created from the same mesh data to share hardware buffers
+//	(so that they can be drawn with instancing).
+//
+//	Meshes are identified by pointers to their data, sizes and checksums of their contents (see rxMeshKey).
+//
+class D3D10MeshCache {
+public:
+			D3D10MeshCache();
+			~D3D10MeshCache();
+
+	// Returns 'true' and the shared buffers if buffers for the same mesh data have been created before.
+	bool	Find( const rxMeshKey& key, DXPtr< ID3D10Buffer > &OutVB, DXPtr< ID3D10Buffer > &OutIB ) const;
+
+	void	Add( const rxMeshKey& key, ID3D10Buffer* pVB, ID3D10Buffer* pIB );
+
+	// Releases the buffers if they are not used by any models.
+	void	ReleaseUnused( ID3D10Buffer* pVB );
+
+	void	Clear();
+
+private:
+	struct Entry
+	{
+		rxMeshKey	key;
+
+		DXPtr< ID3D10Buffer >	pVB;
+		DXPtr< ID3D10Buffer >	pIB;
+	};
+
+	THashMap< rxMeshKey, Entry* >			entries;
+	THashMap< const ID3D10Buffer*, Entry* >	entriesByVB;	// for releasing buffers of removed models
 };
 
 /*
@@ -350,6 +408,9 @@ struct D3D10LocalLight : D3D10Light
 	{}
 
 	virtual void RenderLocalLight( const D3D10ViewConstants& view ) = 0;
+
+	// Adds the bounding volume of this light (in view space) to the cluster grid.
+	virtual void AddToClusters( const D3D10ViewConstants& view, rxLightClusters & clusters ) const = 0;
 };
 
 //
@@ -421,11 +482,47 @@ struct D3D10PointLight : D3D10LocalLight, public rxPointLight
 	//	Override ( D3D10LocalLight ) :
 	//
 	void			RenderLocalLight( const D3D10ViewConstants& view );
+	void			AddToClusters( const D3D10ViewConstants& view, rxLightClusters & clusters ) const;
 
 public:
 	D3D10PointLightData		data;	// light data sent to the shader
 };
 
+//
+//	D3D10ShadowCache - shadow map of a light which is kept between frames.
+//
+//	Shadow casters are split into two layers:
+//	static casters are rendered into a separate depth map which is only updated
+//	when the light or any static caster inside the light frustum changes;
+//	dynamic casters are drawn over a copy of the static layer when any of them changes.
+//
+struct D3D10ShadowCache
+{
+	struct Caster
+	{
+		const D3D10Model *	model;	// only used for comparison, never dereferenced
+		UINT				version;
+	};
+
+	D3D10DepthMap		staticLayer;	// contains only static casters
+	D3D10DepthMap		shadowMap;		// contains all casters
+
+	Matrix4				lightViewProj;	// light transform the maps were rendered with
+	UINT				resolution;
+	UINT				sceneVersion;	// version of the scene at the time of the last update
+	bool				bValid;
+
+	TArray< Caster >	staticCasters;
+	TArray< Caster >	dynamicCasters;
+
+public:
+	D3D10ShadowCache();
+	~D3D10ShadowCache();
+
+	void	Initialize( UINT maximumResolution );
+	void	Shutdown();
+};
+
 //
 //	D3D10SpotLight
 //
@@ -479,6 +576,7 @@ struct D3D10SpotLight : D3D10LocalLight, public rxSpotLight
 	//	Override ( D3D10LocalLight ) :
 	//
 	void			RenderLocalLight( const D3D10ViewConstants& view );
+	void			AddToClusters( const D3D10ViewConstants& view, rxLightClusters & clusters ) const;
 
 private:
 	void RecalcViewAndTransform() const;
@@ -491,6 +589,8 @@ public:
 
 	// projective image (additively blended with backbuffer)
 	DXPtr< ID3D10ShaderResourceView >	projector;
+
+	D3D10ShadowCache *		shadowCache;	// created when the light casts shadows for the first time
 };
 
 FORCEINLINE
@@ -561,6 +661,13 @@ struct D3D10GeometryStage : D3D10RenderStage
 public://private:
 	D3D10Shader_FillGBuffer		fxFillGBuffer;
 	DXPtr< ID3D10InputLayout >	geometryVertexLayout;
+
+	// For drawing models with the same geometry and material in one batch.
+	D3D10Shader_FillGBuffer		fxFillGBuffer_Instanced;
+	DXPtr< ID3D10InputLayout >	instancedVertexLayout;	// vertex stream + instance stream
+
+	rxInstanceBatcher			instanceBatcher;
+	D3D10InstanceBuffer			instanceBuffer;
 };
 
 //========================================================================
@@ -611,9 +718,6 @@ FORCEINLINE void D3D10DebugStage::SetMode( EDebugRenderMode newMode ) {
 //
 struct D3D10LightStageData
 {
-	// Render targets for shadow mapping.
-	D3D10DepthMap						shadowMap;
-
 	//-- Shaders ------------------------------------------------
 
 	D3D10Shader_AmbientLight			fxAmbientLight;
@@ -622,6 +726,7 @@ struct D3D10LightStageData
 	D3D10Shader_SpotLight				fxSpotLight;
 
 	D3D10Shader_BuildShadowMap			fxBuildShadowMap;
+	D3D10Shader_BuildShadowMap			fxBuildShadowMap_Instanced;
 
 	D3D10Shader_SpotLight_Shadowed		fxSpotLight_Shadowed;
 
@@ -647,6 +752,10 @@ struct D3D10LightStageData
 	mxVisibleSet		tempVisibleSet;
 	D3D10RenderQueue 	tempRenderQueue;
 
+	// for drawing shadow casters with instancing
+	rxInstanceBatcher	shadowCasterBatcher;
+	D3D10InstanceBuffer	shadowInstanceBuffer;
+
 public:
 	D3D10LightStageData();
 	~D3D10LightStageData();
@@ -672,11 +781,16 @@ public:
 
 	D3D10LightStageData &	GetData();
 
-	D3D10DepthMap &	BuildShadowMap( const mxSceneView& lightView, UINT resolution );
+	// updates the cached shadow map of the light if needed
+	D3D10DepthMap &	BuildShadowMap( const mxSceneView& lightView, UINT resolution, D3D10ShadowCache & cache );
 
 	// returns the total number of all created lights
 	UINT	NumCreatedLights() const;
 
+	// returns visible local lights assigned to clusters of the view frustum
+	// (valid after Render(), only built if RX_LIGHT_CLUSTERS is enabled)
+	const rxLightClusters &	GetLightClusters() const;
+
 public:
 	rxParallelLight *	CreateParallelLight( const Vec3D& direction,
 								const rxLightDescription& desc = rxLightDescription() );
@@ -701,6 +815,11 @@ private:
 	// render shadow-casting scene geometry into shadow map
 	//void	RenderSceneToShadowMap( const mxSceneView& lightView );
 
+	void	BuildLightClusters( const D3D10ViewConstants& view, D3D10RenderQueue& renderQueue );
+
+	// render static or dynamic shadow casters from the temporary render queue
+	void	RenderShadowCasters( const D3D10View& lightView, bool bDynamic );
+
 private:
 	D3D10LightStageData		data;
 
@@ -709,6 +828,10 @@ private:
 	//-- Persistent data. ---------------------------------------
 
 	TArray< D3D10Light* >	spawnedLights;	// all created lights
+
+	//-- Per-frame data. ----------------------------------------
+
+	rxLightClusters			lightClusters;	// indices into 'localLights' of the render queue
 };
 
 FORCEINLINE
@@ -716,6 +839,11 @@ D3D10LightStageData & D3D10LightStage::GetData() {
 	return this->data;
 }
 
+FORCEINLINE
+const rxLightClusters & D3D10LightStage::GetLightClusters() const {
+	return this->lightClusters;
+}
+
 //========================================================================
 
 //
@@ -1266,6 +1394,8 @@ public:
 
 	D3D10MiscData &				GetMiscData();
 
+	D3D10MeshCache &			GetMeshCache();
+
 	//
 	//	Override ( rxScene ) :
 	//
@@ -1364,10 +1494,14 @@ private:
 	D3D10RenderQueue 	renderQueue;
 	mxVisibleSet		visibleSet;
 
+	TArray< D3D10RenderQueue* >	chunkQueues;	// used for recording parts of the visible set on worker threads
+
 	//----------------------------------
 
 	D3D10MiscData		miscData;
 
+	D3D10MeshCache		meshCache;	// hardware buffers shared by static models
+
 	TArray< D3D10Model* >		allModels;	// all created render models
 	TArray< D3D10Billboard* >	allBillboards;	MX_TODO("<- move this into alpha stage")
 	TArray< D3D10Sky* >			allSkies;
@@ -1427,6 +1561,11 @@ D3D10MiscData & D3D10Scene::GetMiscData() {
 	return this->miscData;
 }
 
+FORCEINLINE
+D3D10MeshCache & D3D10Scene::GetMeshCache() {
+	return this->meshCache;
+}
+
 }//End of namespace abc
 
 #endif // !__MX_D3D10_SCENE_H__
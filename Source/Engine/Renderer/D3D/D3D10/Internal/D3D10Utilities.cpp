@@ -121,13 +121,15 @@ void D3D10DepthMap::Shutdown()
 	pSRV = null;
 }
 
-void D3D10DepthMap::Bind( UINT resolution )
+void D3D10DepthMap::Bind( UINT resolution, bool bClearDepth )
 {
 	Assert( resolution <= this->maxResolution );
 
 	ID3D10RenderTargetView * renderTargets[1] = { null };
 	d3d10::device->OMSetRenderTargets( 1, renderTargets, pDSV );
-	d3d10::device->ClearDepthStencilView( pDSV, D3D10_CLEAR_DEPTH, 1.0f, 0 );
+	if( bClearDepth ) {
+		d3d10::device->ClearDepthStencilView( pDSV, D3D10_CLEAR_DEPTH, 1.0f, 0 );
+	}
 
 	viewport.Height = viewport.Width = resolution;
 	d3d10::device->RSSetViewports( 1, &viewport );
@@ -143,6 +145,67 @@ void D3D10DepthMap::Clear( FLOAT fDepth )
 	d3d10::device->ClearDepthStencilView( pDSV, D3D10_CLEAR_DEPTH, fDepth, 0 );
 }
 
+/*================================
+		D3D10InstanceBuffer
+================================*/
+
+D3D10InstanceBuffer::D3D10InstanceBuffer()
+	: capacity( 0 )
+{}
+
+D3D10InstanceBuffer::~D3D10InstanceBuffer()
+{}
+
+void D3D10InstanceBuffer::Initialize( UINT initialCapacity )
+{
+	Assert( initialCapacity > 0 );
+
+	D3D10_BUFFER_DESC bufferDesc;
+	bufferDesc.Usage			= D3D10_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth		= initialCapacity * sizeof(Matrix4);
+	bufferDesc.BindFlags		= D3D10_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags	= D3D10_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags		= 0;
+
+	this->pVB = null;
+	check( d3d10::device->CreateBuffer( &bufferDesc, null, & this->pVB.Ptr ) );
+
+	this->capacity = initialCapacity;
+}
+
+void D3D10InstanceBuffer::Shutdown()
+{
+	this->pVB = null;
+	this->capacity = 0;
+}
+
+void D3D10InstanceBuffer::Update( const Matrix4* transforms, UINT numInstances )
+{
+	if( numInstances == 0 ) {
+		return;
+	}
+	if( numInstances > this->capacity )
+	{
+		UINT  newCapacity = Max< UINT >( this->capacity, DEFAULT_CAPACITY );
+		while( newCapacity < numInstances ) {
+			newCapacity *= 2;
+		}
+		Initialize( newCapacity );
+	}
+
+	void * pData = null;
+	check( this->pVB->Map( D3D10_MAP_WRITE_DISCARD, 0, &pData ) );
+	MemCopy( pData, transforms, numInstances * sizeof(Matrix4) );
+	this->pVB->Unmap();
+}
+
+void D3D10InstanceBuffer::Bind( UINT slot )
+{
+	const UINT stride = sizeof(Matrix4);
+	const UINT offset = 0;
+	d3d10::device->IASetVertexBuffers( slot, 1, & this->pVB.Ptr, &stride, &offset );
+}
+
 /*================================
 		D3D10LightShape
 ================================*/
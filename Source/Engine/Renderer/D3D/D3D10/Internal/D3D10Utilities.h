@@ -188,7 +188,7 @@ public:
 	void	Initialize( UINT maximumResolution );
 	void	Shutdown();
 
-	void	Bind( UINT resolution );
+	void	Bind( UINT resolution, bool bClearDepth = true );
 	void	Unbind();
 
 	void	Clear( FLOAT fDepth );
@@ -217,6 +217,31 @@ namespace d3d10
 
 }//end of namespace d3d10
 
+//
+//	D3D10InstanceBuffer - dynamic vertex buffer with per-instance world transforms.
+//
+class D3D10InstanceBuffer {
+public:
+	enum { DEFAULT_CAPACITY = 1024 };	// in instances
+
+public:
+			D3D10InstanceBuffer();
+			~D3D10InstanceBuffer();
+
+	void	Initialize( UINT initialCapacity = DEFAULT_CAPACITY );
+	void	Shutdown();
+
+	// Discards the old contents and uploads new instance data, the buffer grows if needed.
+	void	Update( const Matrix4* transforms, UINT numInstances );
+
+	// Binds the buffer to the given input slot.
+	void	Bind( UINT slot );
+
+public:
+	DXPtr< ID3D10Buffer >	pVB;
+	UINT					capacity;	// max number of instances
+};
+
 //-----------------------------------------------------------
 //		Geometry for rendering light shapes.
 //-----------------------------------------------------------
@@ -0,0 +1,89 @@
+/*
+=============================================================================
+	File:	DrawList.cpp
+	Desc:	Sort keys and sorted lists of draw calls.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+/*================================
+		rxDrawList
+================================*/
+
+rxDrawList::rxDrawList()
+{
+	this->entries.SetGranularity( 256 );
+	this->sortBuffer.SetGranularity( 256 );
+}
+
+rxDrawList::~rxDrawList()
+{
+}
+
+//
+//	rxDrawList::Append
+//
+void rxDrawList::Append( const rxDrawList& other, UINT32 indexBase )
+{
+	const mxUInt  oldNum = this->entries.Num();
+	const mxUInt  num = other.entries.Num();
+
+	this->entries.SetNum( oldNum + num, false );
+
+	Entry * dst = this->entries.Ptr() + oldNum;
+	const Entry * src = other.entries.Ptr();
+
+	for( mxUInt i = 0; i < num; i++ )
+	{
+		dst[ i ].key = src[ i ].key;
+		dst[ i ].index = src[ i ].index + indexBase;
+	}
+}
+
+namespace {
+
+struct GetEntryKey
+{
+	FORCEINLINE rxSortKey operator () ( const rxDrawList::Entry& entry ) const {
+		return entry.key;
+	}
+};
+
+struct EntryKeyLess
+{
+	FORCEINLINE bool operator () ( const rxDrawList::Entry& a, const rxDrawList::Entry& b ) const {
+		return ( a.key < b.key );
+	}
+};
+
+}//End of anonymous namespace
+
+//
+//	rxDrawList::Sort
+//
+void rxDrawList::Sort()
+{
+	const mxUInt  num = this->entries.Num();
+	if( num < 2 ) {
+		return;
+	}
+
+	this->sortBuffer.SetNum( num, false );
+
+	// Both sorts are stable, so the order is the same whichever is used.
+	if( mxGetNumSortChunks( num ) > 1 ) {
+		mxParallelMergeSort( this->entries.Ptr(), this->sortBuffer.Ptr(), num, EntryKeyLess() );
+	} else {
+		mxRadixSortByKey( this->entries.Ptr(), this->sortBuffer.Ptr(), num, GetEntryKey() );
+	}
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
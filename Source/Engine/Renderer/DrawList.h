@@ -0,0 +1,149 @@
+/*
+=============================================================================
+	File:	DrawList.h
+	Desc:	Sort keys and sorted lists of draw calls.
+=============================================================================
+*/
+
+#ifndef __RX_DRAW_LIST_H__
+#define __RX_DRAW_LIST_H__
+
+namespace abc {
+
+/*
+=====================================================================
+
+	Sort keys.
+
+=====================================================================
+*/
+
+//
+//	rxSortKey - 64-bit key which determines the order of draw calls.
+//
+//	Front-to-back keys (for opaque geometry):
+//		[63..60] - stage
+//		[59..36] - material id (draws with the same material are grouped together)
+//		[35..12] - quantized depth (increasing)
+//
+//	Back-to-front keys (for translucent geometry, blending requires strict depth order):
+//		[63..60] - stage
+//		[59..36] - quantized depth (decreasing)
+//		[35..12] - material id
+//
+//	The lowest bits are not used (the sort skips passes over constant bytes).
+//
+typedef UINT64	rxSortKey;
+
+enum ESortKeyLayout
+{
+	SORT_KEY_STAGE_BITS		= 4,
+	SORT_KEY_MATERIAL_BITS	= 24,
+	SORT_KEY_DEPTH_BITS		= 24,
+
+	SORT_KEY_STAGE_SHIFT	= 60,
+	SORT_KEY_HIGH_SHIFT		= 36,
+	SORT_KEY_LOW_SHIFT		= 12,
+};
+
+// Maps the depth in range [0..1] to an integer (values outside the range are clamped).
+FORCEINLINE UINT32 rxQuantizeDepth( FLOAT depth )
+{
+	const UINT32  maxValue = (1UL << SORT_KEY_DEPTH_BITS) - 1;
+	if( !(depth > 0.0f) ) {
+		return 0;
+	}
+	if( depth >= 1.0f ) {
+		return maxValue;
+	}
+	return (UINT32)( depth * (FLOAT)maxValue );
+}
+
+FORCEINLINE rxSortKey rxMakeSortKey_FrontToBack( UINT32 stage, UINT32 materialId, FLOAT depth )
+{
+	const UINT32  materialMask = (1UL << SORT_KEY_MATERIAL_BITS) - 1;
+	return ( (rxSortKey)stage << SORT_KEY_STAGE_SHIFT )
+		| ( (rxSortKey)( materialId & materialMask ) << SORT_KEY_HIGH_SHIFT )
+		| ( (rxSortKey)rxQuantizeDepth( depth ) << SORT_KEY_LOW_SHIFT );
+}
+
+FORCEINLINE rxSortKey rxMakeSortKey_BackToFront( UINT32 stage, UINT32 materialId, FLOAT depth )
+{
+	const UINT32  materialMask = (1UL << SORT_KEY_MATERIAL_BITS) - 1;
+	const UINT32  depthMask = (1UL << SORT_KEY_DEPTH_BITS) - 1;
+	return ( (rxSortKey)stage << SORT_KEY_STAGE_SHIFT )
+		| ( (rxSortKey)( depthMask - rxQuantizeDepth( depth ) ) << SORT_KEY_HIGH_SHIFT )
+		| ( (rxSortKey)( materialId & materialMask ) << SORT_KEY_LOW_SHIFT );
+}
+
+/*
+=====================================================================
+
+	Draw list.
+
+=====================================================================
+*/
+
+//
+//	rxDrawList - a list of draw calls ordered by their sort keys.
+//
+//	Each entry stores a sort key and an index into an array of objects kept by the caller.
+//
+class rxDrawList {
+public:
+	struct Entry
+	{
+		rxSortKey	key;
+		UINT32		index;	// index of the object to draw
+	};
+
+public:
+				rxDrawList();
+				~rxDrawList();
+
+	void		Add( rxSortKey key, UINT32 index );
+
+				// Appends the entries of another list, adding 'indexBase' to their indices.
+	void		Append( const rxDrawList& other, UINT32 indexBase );
+
+				// Removes all entries, doesn't free memory.
+	void		Clear();
+
+				// Sorts the entries by their keys in increasing order, keeping the order of equal keys
+				// (radix sort, large lists are merge sorted on worker threads).
+	void		Sort();
+
+	mxUInt		Num() const;
+
+	const Entry &	operator [] ( mxUInt i ) const;
+
+private:
+	TArray< Entry >		entries;
+	TArray< Entry >		sortBuffer;	// temporary storage used by Sort()
+};
+
+FORCEINLINE void rxDrawList::Add( rxSortKey key, UINT32 index ) {
+	Entry & newEntry = this->entries.Alloc();
+	newEntry.key = key;
+	newEntry.index = index;
+}
+
+FORCEINLINE void rxDrawList::Clear() {
+	this->entries.SetNum( 0, false );
+}
+
+FORCEINLINE mxUInt rxDrawList::Num() const {
+	return this->entries.Num();
+}
+
+FORCEINLINE const rxDrawList::Entry & rxDrawList::operator [] ( mxUInt i ) const {
+	return this->entries[ i ];
+}
+
+}//End of namespace abc
+
+#endif // !__RX_DRAW_LIST_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
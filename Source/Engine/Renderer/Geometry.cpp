@@ -256,6 +256,7 @@ mxMesh::mxMesh()
 //	, primType		( EPrimitiveType::PT_Unknown )
 {
 	bounds.Clear();
+	sphere.Clear();
 }
 
 mxMesh::~mxMesh()
@@ -280,6 +281,23 @@ void mxMesh::RecalculateBounds()
 	{
 		this->bounds.AddPoint( this->vertices[iVertex].XYZ );
 	}
+
+	this->sphere.Clear();
+	if( this->numVertices > 0 )
+	{
+		// tighter than the sphere around the box, centered at the box center
+		const Vec3D center( this->bounds.GetCenter() );
+		FLOAT maxDistanceSqr = 0.0f;
+		for( UINT iVertex = 0; iVertex < this->numVertices; iVertex++ )
+		{
+			const FLOAT distanceSqr = ( this->vertices[iVertex].XYZ - center ).LengthSqr();
+			if( distanceSqr > maxDistanceSqr ) {
+				maxDistanceSqr = distanceSqr;
+			}
+		}
+		this->sphere.SetOrigin( center );
+		this->sphere.SetRadius( mxMath::Sqrt( maxDistanceSqr ) );
+	}
 }
 
 void mxMesh::FlipNormals()
@@ -308,7 +326,7 @@ void mxMesh::Transform( const Matrix4& mat )
 		mat.TransformNormal( vertex.Tangent );
 	}
 
-	this->bounds.TrasformSelf( mat );
+	RecalculateBounds();
 }
 
 void mxMesh::Copy( const mxMesh* other )
@@ -326,20 +344,28 @@ void mxMesh::Copy( const mxMesh* other )
 	
 //	this->primType = other->primType;
 	this->bounds = other->bounds;
+	this->sphere = other->sphere;
 }
 
 void mxMesh::Clear()
 {
+	// mapped data is released together with the file
+	if( this->storage == null )
+	{
+		MX_FREE( vertices );
+		MX_FREE( indices );
+	}
+	this->storage = null;
+
 	numVertices = 0;
-	MX_FREE( vertices );
 	vertices = null;
 
 	numIndices = 0;
-	MX_FREE( indices );
 	indices = null;
 
 //	this->primType = EPrimitiveType::PT_Unknown;
 	this->bounds.Clear();
+	this->sphere.Clear();
 }
 
 /*
@@ -605,8 +605,13 @@ public:
 	//UINT			primType;	// EPrimitiveType - type of primitives in this buffer
 
 	mxBounds		bounds;	// mesh bounds in local space
+	Sphere			sphere;	// bounding sphere in local space
+
+	// if not null, vertices and indices point into this file (see MeshCache.h)
+	mxMappedFilePtr	storage;
 
 public:
+	// recomputes the bounding box and the bounding sphere
 	void RecalculateBounds();
 
 	void FlipNormals();	// reverses the order of indices
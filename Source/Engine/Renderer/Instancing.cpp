@@ -0,0 +1,264 @@
+/*
+=============================================================================
+	File:	Instancing.cpp
+	Desc:	Grouping of identical draw calls for hardware instancing.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+namespace {
+
+	FORCEINLINE UINT32 HashPointer( const void* ptr )
+	{
+		UINT32  key = (UINT32)(size_t) ptr;
+		key = ( key ^ ( key >> 16 ) ) * 0x45D9F3B;
+		key = ( key ^ ( key >> 16 ) ) * 0x45D9F3B;
+		return key ^ ( key >> 16 );
+	}
+
+	FORCEINLINE bool SameBatch( const rxBatch& a, const rxBatch& b )
+	{
+		return ( a.StartIndex == b.StartIndex )
+			&& ( a.IndexCount == b.IndexCount )
+			&& ( a.StartVertex == b.StartVertex )
+			&& ( a.VertexCount == b.VertexCount );
+	}
+
+	// MurmurHash3 (32-bit) of the given bytes, hashes four bytes at a time
+	// (mesh data is hashed each time a static model is created).
+	UINT32 HashMeshData( const void* data, SizeT numBytes, UINT32 seed )
+	{
+		const UINT32 * words = static_cast< const UINT32* >( data );	// x86 allows unaligned reads
+		const SizeT  numWords = numBytes / sizeof(UINT32);
+
+		UINT32  hash = seed;
+		for( SizeT i = 0; i < numWords; i++ )
+		{
+			UINT32  k = words[ i ];
+			k *= 0xCC9E2D51U;
+			k = ( k << 15 ) | ( k >> 17 );
+			k *= 0x1B873593U;
+
+			hash ^= k;
+			hash = ( hash << 13 ) | ( hash >> 19 );
+			hash = hash * 5 + 0xE6546B64U;
+		}
+
+		// remaining bytes
+		hash = mxHashBytes( words + numWords, numBytes % sizeof(UINT32), hash );
+
+		return mxHashUInt32( hash ^ (UINT32) numBytes );
+	}
+
+}//end of anonymous namespace
+
+/*================================
+		rxInstanceBatcher
+================================*/
+
+rxInstanceBatcher::rxInstanceBatcher()
+{
+	this->draws.SetGranularity( 256 );
+	this->groups.SetGranularity( 64 );
+	this->instanceTransforms.SetGranularity( 256 );
+	this->instanceIndices.SetGranularity( 256 );
+}
+
+rxInstanceBatcher::~rxInstanceBatcher()
+{
+}
+
+void rxInstanceBatcher::Clear()
+{
+	this->draws.SetNum( 0, false );
+	this->groups.SetNum( 0, false );
+	this->instanceTransforms.SetNum( 0, false );
+	this->instanceIndices.SetNum( 0, false );
+}
+
+void rxInstanceBatcher::Add( const void* vertexBuffer, const void* indexBuffer, const rxBatch& batch,
+							const void* material, const Matrix4& worldTransform, UINT32 userIndex )
+{
+	Draw & newDraw = this->draws.Alloc();
+	newDraw.vertexBuffer	= vertexBuffer;
+	newDraw.indexBuffer		= indexBuffer;
+	newDraw.material		= material;
+	newDraw.batch			= batch;
+	newDraw.worldTransform	= &worldTransform;
+	newDraw.userIndex		= userIndex;
+	newDraw.groupIndex		= 0;
+}
+
+//
+//	rxInstanceBatcher::Build
+//
+void rxInstanceBatcher::Build()
+{
+	const UINT  numDraws = this->draws.Num();
+
+	this->groups.SetNum( 0, false );
+	this->instanceTransforms.SetNum( numDraws, false );
+	this->instanceIndices.SetNum( numDraws, false );
+
+	if( numDraws == 0 ) {
+		return;
+	}
+
+	// Keep the load factor of the hash table below one half.
+	UINT  tableSize = 16;
+	while( tableSize < numDraws * 2 ) {
+		tableSize *= 2;
+	}
+	this->hashTable.SetNum( tableSize, false );
+	MemZero( this->hashTable.Ptr(), tableSize * sizeof(UINT32) );
+
+	// Assign draw calls to groups and count instances in each group.
+	Draw * draws = this->draws.Ptr();
+	for( UINT iDraw = 0; iDraw < numDraws; iDraw++ )
+	{
+		const UINT32  groupIndex = FindOrAddGroup( draws[ iDraw ] );
+		draws[ iDraw ].groupIndex = groupIndex;
+		this->groups[ groupIndex ].numInstances++;
+	}
+
+	// Convert counts to offsets.
+	UINT32  offset = 0;
+	for( UINT iGroup = 0; iGroup < this->groups.Num(); iGroup++ )
+	{
+		Group & group = this->groups[ iGroup ];
+		group.firstInstance = offset;
+		offset += group.numInstances;
+		group.numInstances = 0;
+	}
+
+	// Pack instance data.
+	Matrix4 * transforms = this->instanceTransforms.Ptr();
+	UINT32 * indices = this->instanceIndices.Ptr();
+
+	for( UINT iDraw = 0; iDraw < numDraws; iDraw++ )
+	{
+		const Draw & draw = draws[ iDraw ];
+		Group & group = this->groups[ draw.groupIndex ];
+
+		const UINT32  instanceIndex = group.firstInstance + group.numInstances;
+		group.numInstances++;
+
+		transforms[ instanceIndex ] = *draw.worldTransform;
+		indices[ instanceIndex ] = draw.userIndex;
+	}
+}
+
+UINT32 rxInstanceBatcher::FindOrAddGroup( const Draw& draw )
+{
+	const UINT32  mask = this->hashTable.Num() - 1;
+
+	UINT32  hash = HashPointer( draw.vertexBuffer );
+	hash = hash * 31 + HashPointer( draw.indexBuffer );
+	hash = hash * 31 + HashPointer( draw.material );
+	hash = hash * 31 + draw.batch.StartIndex + draw.batch.StartVertex;
+
+	UINT32 * slots = this->hashTable.Ptr();
+	UINT32  slot = hash & mask;
+
+	for(;;)
+	{
+		if( slots[ slot ] == 0 )
+		{
+			Group & newGroup = this->groups.Alloc();
+			newGroup.vertexBuffer	= draw.vertexBuffer;
+			newGroup.indexBuffer	= draw.indexBuffer;
+			newGroup.material		= draw.material;
+			newGroup.batch			= draw.batch;
+			newGroup.firstInstance	= 0;
+			newGroup.numInstances	= 0;
+
+			slots[ slot ] = this->groups.Num();
+			return this->groups.Num() - 1;
+		}
+
+		const UINT32  groupIndex = slots[ slot ] - 1;
+		const Group & group = this->groups[ groupIndex ];
+
+		if( group.vertexBuffer == draw.vertexBuffer
+			&& group.indexBuffer == draw.indexBuffer
+			&& group.material == draw.material
+			&& SameBatch( group.batch, draw.batch ) )
+		{
+			return groupIndex;
+		}
+
+		slot = ( slot + 1 ) & mask;
+	}
+}
+
+/*================================
+		rxGroupDrawState
+================================*/
+
+rxGroupDrawState::rxGroupDrawState( rxStatistics & stats )
+	: stats( stats )
+	, currentMaterial( null )
+	, currentInstancedMaterial( null )
+{}
+
+bool rxGroupDrawState::BeginGroup( const rxInstanceBatcher::Group& group )
+{
+	const bool  bInstanced = IsInstanced( group );
+
+	const void *& shaderMaterial = bInstanced ? this->currentInstancedMaterial : this->currentMaterial;
+
+	bool  bBindMaterial = false;
+	if( group.material != shaderMaterial )
+	{
+		shaderMaterial = group.material;
+		this->stats.numMaterialChanges++;
+		bBindMaterial = true;
+	}
+	else
+	{
+		this->stats.numStateChangesAvoided++;
+	}
+
+	if( bInstanced )
+	{
+		this->stats.numInstancedBatches++;
+		this->stats.numBatchesSaved += group.numInstances - 1;
+	}
+
+	this->stats.numBatches++;
+
+	return bBindMaterial;
+}
+
+/*================================
+		rxMeshKey
+================================*/
+
+rxMeshKey::rxMeshKey()
+	: vertexData( null )
+	, indexData( null )
+	, vertexDataSize( 0 )
+	, indexDataSize( 0 )
+	, checksum( 0 )
+{}
+
+rxMeshKey::rxMeshKey( const rxMeshDescription& desc )
+{
+	this->vertexData		= desc.Vertices.Data;
+	this->indexData			= desc.Indices.Data;
+	this->vertexDataSize	= desc.Vertices.VertexCount * desc.Vertices.VertexSize;
+	this->indexDataSize		= desc.Indices.IndexCount * desc.Indices.IndexSize;
+
+	const UINT32  vertexHash = HashMeshData( this->vertexData, this->vertexDataSize, 0 );
+	this->checksum = HashMeshData( this->indexData, this->indexDataSize, vertexHash );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,183 @@
+/*
+=============================================================================
+	File:	Instancing.h
+	Desc:	Grouping of identical draw calls for hardware instancing.
+=============================================================================
+*/
+
+#ifndef __RX_INSTANCING_H__
+#define __RX_INSTANCING_H__
+
+namespace abc {
+
+//
+//	rxInstanceBatcher - groups draw calls with the same geometry and material
+//	and packs their world transforms into a single array of instance data.
+//
+//	The batcher doesn't know anything about the graphics API,
+//	buffers and materials are only used as keys for grouping.
+//
+//	Groups are listed in the order of their first draw call,
+//	and instances within each group keep the order in which they were added,
+//	so that the sorting of the draw list is preserved as much as possible.
+//
+class rxInstanceBatcher {
+public:
+	struct Group
+	{
+		const void *	vertexBuffer;
+		const void *	indexBuffer;
+		const void *	material;
+		rxBatch			batch;
+		UINT32			firstInstance;	// index of the first instance in the packed arrays
+		UINT32			numInstances;
+	};
+
+public:
+				rxInstanceBatcher();
+				~rxInstanceBatcher();
+
+				// Removes all draw calls, doesn't free memory.
+	void		Clear();
+
+				// The world transform must stay valid until Build() is called.
+				// 'userIndex' is stored with the packed transform (e.g. index of the model in the render queue).
+	void		Add( const void* vertexBuffer, const void* indexBuffer, const rxBatch& batch,
+					const void* material, const Matrix4& worldTransform, UINT32 userIndex );
+
+				// Groups the added draw calls and packs their transforms.
+	void		Build();
+
+	UINT		NumDraws() const;		// number of added draw calls
+	UINT		NumGroups() const;		// number of draw calls after grouping
+
+	const Group &	GetGroup( UINT groupIndex ) const;
+
+				// Packed instance data, [NumDraws()] elements, each group occupies a contiguous range.
+	const Matrix4 *	GetInstanceTransforms() const;
+	const UINT32 *	GetInstanceIndices() const;
+
+private:
+	struct Draw
+	{
+		const void *	vertexBuffer;
+		const void *	indexBuffer;
+		const void *	material;
+		rxBatch			batch;
+		const Matrix4 *	worldTransform;
+		UINT32			userIndex;
+		UINT32			groupIndex;
+	};
+
+	UINT32	FindOrAddGroup( const Draw& draw );
+
+private:
+	TArray< Draw >		draws;
+	TArray< Group >		groups;
+
+	// Open-addressing hash table of groups (group index + 1, zero if the slot is free).
+	TArray< UINT32 >	hashTable;
+
+	// Results.
+	TArray< Matrix4 >	instanceTransforms;
+	TArray< UINT32 >	instanceIndices;
+};
+
+FORCEINLINE UINT rxInstanceBatcher::NumDraws() const {
+	return this->draws.Num();
+}
+
+FORCEINLINE UINT rxInstanceBatcher::NumGroups() const {
+	return this->groups.Num();
+}
+
+FORCEINLINE const rxInstanceBatcher::Group & rxInstanceBatcher::GetGroup( UINT groupIndex ) const {
+	return this->groups[ groupIndex ];
+}
+
+FORCEINLINE const Matrix4 * rxInstanceBatcher::GetInstanceTransforms() const {
+	return this->instanceTransforms.Ptr();
+}
+
+FORCEINLINE const UINT32 * rxInstanceBatcher::GetInstanceIndices() const {
+	return this->instanceIndices.Ptr();
+}
+
+// Groups with fewer draws are drawn one by one, without instancing.
+const UINT MIN_INSTANCES_PER_BATCH = 2;
+
+//
+//	rxGroupDrawState - tracks the materials bound while the groups of an rxInstanceBatcher are drawn
+//	and counts the batches in the statistics.
+//
+//	Instanced and non-instanced groups are drawn with different shaders,
+//	so each kind of groups has its own current material.
+//
+class rxGroupDrawState {
+public:
+				rxGroupDrawState( rxStatistics & stats );
+
+				// Must be called for each group in order, before it is drawn.
+				// Returns true if the material of the group has to be bound.
+	bool		BeginGroup( const rxInstanceBatcher::Group& group );
+
+	static bool	IsInstanced( const rxInstanceBatcher::Group& group );
+
+private:
+	rxStatistics &	stats;
+	const void *	currentMaterial;
+	const void *	currentInstancedMaterial;
+};
+
+FORCEINLINE bool rxGroupDrawState::IsInstanced( const rxInstanceBatcher::Group& group ) {
+	return ( group.numInstances >= MIN_INSTANCES_PER_BATCH );
+}
+
+//
+//	rxMeshKey - identifies mesh data passed to the renderer,
+//	so that static models created from the same data can share hardware buffers (and be instanced).
+//
+//	The memory of a released mesh could be reused for another one,
+//	so the key includes a checksum of the contents in addition to the pointers and sizes.
+//
+struct rxMeshKey
+{
+	const void *	vertexData;
+	const void *	indexData;
+	UINT32			vertexDataSize;
+	UINT32			indexDataSize;
+	UINT32			checksum;
+
+public:
+	rxMeshKey();
+	explicit rxMeshKey( const rxMeshDescription& desc );	// hashes the vertex and index data
+
+	bool operator == ( const rxMeshKey& other ) const;
+};
+
+FORCEINLINE bool rxMeshKey::operator == ( const rxMeshKey& other ) const {
+	return ( this->vertexData == other.vertexData )
+		&& ( this->indexData == other.indexData )
+		&& ( this->vertexDataSize == other.vertexDataSize )
+		&& ( this->indexDataSize == other.indexDataSize )
+		&& ( this->checksum == other.checksum );
+}
+
+template<>
+struct THashTraits< rxMeshKey >
+{
+	static FORCEINLINE UINT32 GetHash( const rxMeshKey& key ) {
+		return mxHashUInt32( mxHashPointer( key.vertexData ) ^ mxHashPointer( key.indexData ) ^ key.checksum );
+	}
+	static FORCEINLINE bool Equals( const rxMeshKey& a, const rxMeshKey& b ) {
+		return ( a == b );
+	}
+};
+
+}//End of namespace abc
+
+#endif // !__RX_INSTANCING_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,509 @@
+/*
+=============================================================================
+	File:	LightClusters.cpp
+	Desc:	Assignment of local lights to view frustum clusters.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+namespace {
+
+	const FLOAT	EMPTY_BOX_EXTENT = 1e30f;
+
+	// Clamps the value to [0..maxValue].
+	FORCEINLINE UINT ClampIndex( FLOAT value, UINT maxValue )
+	{
+		if( !(value > 0.0f) ) {
+			return 0;
+		}
+		const UINT  index = (UINT) value;
+		return ( index < maxValue ) ? index : maxValue;
+	}
+
+}//end of anonymous namespace
+
+/*================================
+		rxLightClusters
+================================*/
+
+rxLightClusters::rxLightClusters()
+	: numTilesX( 0 ), numTilesY( 0 ), numSlices( 0 ), strideX( 0 )
+	, xScale( 1.0f ), yScale( 1.0f )
+	, nearZ( 1.0f ), farZ( 1000.0f )
+	, sliceScale( 0.0f )
+	, bBoundsValid( false )
+{
+	Setup();
+}
+
+rxLightClusters::~rxLightClusters()
+{
+}
+
+//
+//	rxLightClusters::Setup
+//
+void rxLightClusters::Setup( UINT newTilesX, UINT newTilesY, UINT newSlices )
+{
+	Assert( newTilesX > 0 && newTilesY > 0 && newSlices > 0 );
+
+	this->numTilesX = newTilesX;
+	this->numTilesY = newTilesY;
+	this->numSlices = newSlices;
+	this->strideX = ( newTilesX + 3 ) & ~3;
+
+	Assert( NumClusters() <= MAX_CLUSTERS );
+
+	this->bBoundsValid = false;
+	this->clusterOffsets.SetNum( 0, false );
+	this->lightIndices.SetNum( 0, false );
+}
+
+//
+//	rxLightClusters::SetProjection
+//
+void rxLightClusters::SetProjection( FLOAT newXScale, FLOAT newYScale, FLOAT newNearZ, FLOAT newFarZ )
+{
+	Assert( newXScale > 0.0f && newYScale > 0.0f );
+	Assert( newNearZ > 0.0f && newNearZ < newFarZ );
+
+	if( this->bBoundsValid
+		&& this->xScale == newXScale && this->yScale == newYScale
+		&& this->nearZ == newNearZ && this->farZ == newFarZ )
+	{
+		return;
+	}
+
+	this->xScale = newXScale;
+	this->yScale = newYScale;
+	this->nearZ = newNearZ;
+	this->farZ = newFarZ;
+	this->sliceScale = (FLOAT)this->numSlices / mxMath::Log( newFarZ / newNearZ );
+
+	CalcClusterBounds();
+	this->bBoundsValid = true;
+}
+
+void rxLightClusters::SetProjection( const Matrix4& projectionMatrix )
+{
+	const Matrix4 & proj = projectionMatrix;
+	const FLOAT  nearZ = -proj[3].z / proj[2].z;
+	const FLOAT  farZ = proj[3].z / ( 1.0f - proj[2].z );
+
+	SetProjection( proj[0].x, proj[1].y, nearZ, farZ );
+}
+
+void rxLightClusters::Clear()
+{
+	this->lights.SetNum( 0, false );
+}
+
+UINT rxLightClusters::AddPointLight( const Vec3D& viewPosition, FLOAT radius )
+{
+	Assert( radius >= 0.0f );
+	Assert( this->lights.Num() < MAX_LIGHTS );
+
+	Light & newLight = this->lights.Alloc();
+	newLight.position[0] = viewPosition.x;
+	newLight.position[1] = viewPosition.y;
+	newLight.position[2] = viewPosition.z;
+	newLight.radius = radius;
+	newLight.direction[0] = newLight.direction[1] = newLight.direction[2] = 0.0f;
+	newLight.cosAngle = 0.0f;
+	newLight.sinAngle = 1.0f;
+	newLight.bSpot = false;
+
+	return this->lights.Num() - 1;
+}
+
+UINT rxLightClusters::AddSpotLight( const Vec3D& viewPosition, const Vec3D& viewDirection, FLOAT range, FLOAT cosHalfAngle )
+{
+	Assert( range >= 0.0f );
+	Assert( cosHalfAngle >= 0.0f && cosHalfAngle <= 1.0f );
+	Assert( this->lights.Num() < MAX_LIGHTS );
+
+	Light & newLight = this->lights.Alloc();
+	newLight.position[0] = viewPosition.x;
+	newLight.position[1] = viewPosition.y;
+	newLight.position[2] = viewPosition.z;
+	newLight.radius = range;
+	newLight.direction[0] = viewDirection.x;
+	newLight.direction[1] = viewDirection.y;
+	newLight.direction[2] = viewDirection.z;
+	newLight.cosAngle = cosHalfAngle;
+	newLight.sinAngle = mxMath::Sqrt( 1.0f - cosHalfAngle * cosHalfAngle );
+	newLight.bSpot = true;
+
+	return this->lights.Num() - 1;
+}
+
+//
+//	rxLightClusters::Build
+//
+void rxLightClusters::Build()
+{
+	Assert( this->bBoundsValid );
+
+	this->pairs.SetNum( 0, false );
+
+	for( UINT iLight = 0; iLight < this->lights.Num(); iLight++ ) {
+		AssignLight( iLight );
+	}
+
+	// Sort (cluster, light) pairs by cluster with a counting sort,
+	// light indices within each cluster remain in increasing order.
+	const UINT  numClusters = NumClusters();
+	const UINT  numPairs = this->pairs.Num();
+
+	this->clusterOffsets.SetNum( numClusters + 1, false );
+	MemZero( this->clusterOffsets.Ptr(), this->clusterOffsets.Num() * sizeof(UINT32) );
+
+	UINT32 * offsets = this->clusterOffsets.Ptr();
+
+	for( UINT iPair = 0; iPair < numPairs; iPair++ ) {
+		offsets[ (this->pairs[ iPair ] >> 16) + 1 ]++;
+	}
+	for( UINT iCluster = 0; iCluster < numClusters; iCluster++ ) {
+		offsets[ iCluster + 1 ] += offsets[ iCluster ];
+	}
+
+	this->lightIndices.SetNum( numPairs, false );
+
+	// Use the offsets as insertion cursors, then restore them.
+	for( UINT iPair = 0; iPair < numPairs; iPair++ )
+	{
+		const UINT32  pair = this->pairs[ iPair ];
+		this->lightIndices[ offsets[ pair >> 16 ]++ ] = (UINT16)( pair & 0xFFFF );
+	}
+	for( UINT iCluster = numClusters; iCluster > 0; iCluster-- ) {
+		offsets[ iCluster ] = offsets[ iCluster - 1 ];
+	}
+	offsets[ 0 ] = 0;
+}
+
+UINT rxLightClusters::FindCluster( const Vec3D& viewPosition ) const
+{
+	Assert( viewPosition.z > 0.0f );
+
+	const FLOAT  invZ = 1.0f / viewPosition.z;
+	return GetClusterIndex(
+		GetTileX( viewPosition.x * this->xScale * invZ ),
+		GetTileY( viewPosition.y * this->yScale * invZ ),
+		GetSlice( viewPosition.z ) );
+}
+
+const UINT16 * rxLightClusters::GetLights( UINT clusterIndex, UINT &OutNumLights ) const
+{
+	Assert( clusterIndex < NumClusters() );
+
+	if( this->clusterOffsets.Num() == 0 ) {
+		OutNumLights = 0;
+		return null;
+	}
+
+	const UINT32  start = this->clusterOffsets[ clusterIndex ];
+	OutNumLights = this->clusterOffsets[ clusterIndex + 1 ] - start;
+	return this->lightIndices.Ptr() + start;
+}
+
+//
+//	rxLightClusters::CalcClusterBounds
+//
+void rxLightClusters::CalcClusterBounds()
+{
+	const UINT  numClusters = NumClusters();
+
+	TArray< FLOAT > * arrays[] = {
+		&boxMinX, &boxMinY, &boxMinZ,
+		&boxMaxX, &boxMaxY, &boxMaxZ,
+		&sphereX, &sphereY, &sphereZ, &sphereRadius
+	};
+	for( UINT i = 0; i < ARRAY_SIZE(arrays); i++ ) {
+		arrays[i]->SetNum( numClusters, false );
+	}
+
+	const FLOAT  invXScale = 1.0f / this->xScale;
+	const FLOAT  invYScale = 1.0f / this->yScale;
+	const FLOAT  depthRatio = this->farZ / this->nearZ;
+
+	for( UINT z = 0; z < this->numSlices; z++ )
+	{
+		const FLOAT  z0 = this->nearZ * mxMath::Pow( depthRatio, (FLOAT)z / this->numSlices );
+		const FLOAT  z1 = this->nearZ * mxMath::Pow( depthRatio, (FLOAT)(z + 1) / this->numSlices );
+
+		for( UINT y = 0; y < this->numTilesY; y++ )
+		{
+			// Tile rows go from the top of the screen.
+			const FLOAT  ndcMaxY = 1.0f - 2.0f * y / this->numTilesY;
+			const FLOAT  ndcMinY = 1.0f - 2.0f * (y + 1) / this->numTilesY;
+
+			for( UINT x = 0; x < this->strideX; x++ )
+			{
+				const UINT  index = GetClusterIndex( x, y, z );
+
+				if( x >= this->numTilesX )
+				{
+					// Padding, never intersects anything.
+					boxMinX[ index ] = boxMinY[ index ] = boxMinZ[ index ] = EMPTY_BOX_EXTENT;
+					boxMaxX[ index ] = boxMaxY[ index ] = boxMaxZ[ index ] = -EMPTY_BOX_EXTENT;
+					sphereX[ index ] = sphereY[ index ] = sphereZ[ index ] = EMPTY_BOX_EXTENT;
+					sphereRadius[ index ] = 0.0f;
+					continue;
+				}
+
+				const FLOAT  ndcMinX = -1.0f + 2.0f * x / this->numTilesX;
+				const FLOAT  ndcMaxX = -1.0f + 2.0f * (x + 1) / this->numTilesX;
+
+				// The cluster is a frustum, take the box enclosing its near and far faces.
+				const FLOAT  minX = Min( ndcMinX * z0, ndcMinX * z1 ) * invXScale;
+				const FLOAT  maxX = Max( ndcMaxX * z0, ndcMaxX * z1 ) * invXScale;
+				const FLOAT  minY = Min( ndcMinY * z0, ndcMinY * z1 ) * invYScale;
+				const FLOAT  maxY = Max( ndcMaxY * z0, ndcMaxY * z1 ) * invYScale;
+
+				boxMinX[ index ] = minX;	boxMaxX[ index ] = maxX;
+				boxMinY[ index ] = minY;	boxMaxY[ index ] = maxY;
+				boxMinZ[ index ] = z0;		boxMaxZ[ index ] = z1;
+
+				const FLOAT  halfX = (maxX - minX) * 0.5f;
+				const FLOAT  halfY = (maxY - minY) * 0.5f;
+				const FLOAT  halfZ = (z1 - z0) * 0.5f;
+
+				sphereX[ index ] = minX + halfX;
+				sphereY[ index ] = minY + halfY;
+				sphereZ[ index ] = z0 + halfZ;
+				sphereRadius[ index ] = mxMath::Sqrt( halfX * halfX + halfY * halfY + halfZ * halfZ );
+			}
+		}
+	}
+}
+
+FORCEINLINE UINT rxLightClusters::GetSlice( FLOAT viewZ ) const
+{
+	if( viewZ <= this->nearZ ) {
+		return 0;
+	}
+	return ClampIndex( mxMath::Log( viewZ / this->nearZ ) * this->sliceScale, this->numSlices - 1 );
+}
+
+FORCEINLINE UINT rxLightClusters::GetTileX( FLOAT ndcX ) const
+{
+	return ClampIndex( (ndcX + 1.0f) * 0.5f * this->numTilesX, this->numTilesX - 1 );
+}
+
+FORCEINLINE UINT rxLightClusters::GetTileY( FLOAT ndcY ) const
+{
+	return ClampIndex( (1.0f - ndcY) * 0.5f * this->numTilesY, this->numTilesY - 1 );
+}
+
+bool rxLightClusters::GetClusterRange( const Light& light, UINT &x0, UINT &y0, UINT &z0, UINT &x1, UINT &y1, UINT &z1 ) const
+{
+	const FLOAT  cx = light.position[0];
+	const FLOAT  cy = light.position[1];
+	const FLOAT  cz = light.position[2];
+	const FLOAT  r = light.radius;
+
+	const FLOAT  minZ = cz - r;
+	const FLOAT  maxZ = cz + r;
+
+	if( maxZ < this->nearZ || minZ > this->farZ ) {
+		return false;
+	}
+
+	z0 = GetSlice( minZ );
+	z1 = GetSlice( maxZ );
+
+	if( minZ <= this->nearZ )
+	{
+		// The light crosses the near plane, its projection is unbounded.
+		x0 = 0;		x1 = this->numTilesX - 1;
+		y0 = 0;		y1 = this->numTilesY - 1;
+		return true;
+	}
+
+	// Project the bounding box of the light sphere.
+	const FLOAT  invMinZ = 1.0f / minZ;
+	const FLOAT  invMaxZ = 1.0f / maxZ;
+
+	const FLOAT  ndcMinX = Min( (cx - r) * invMinZ, (cx - r) * invMaxZ ) * this->xScale;
+	const FLOAT  ndcMaxX = Max( (cx + r) * invMinZ, (cx + r) * invMaxZ ) * this->xScale;
+	const FLOAT  ndcMinY = Min( (cy - r) * invMinZ, (cy - r) * invMaxZ ) * this->yScale;
+	const FLOAT  ndcMaxY = Max( (cy + r) * invMinZ, (cy + r) * invMaxZ ) * this->yScale;
+
+	if( ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f ) {
+		return false;
+	}
+
+	x0 = GetTileX( ndcMinX );
+	x1 = GetTileX( ndcMaxX );
+	y0 = GetTileY( ndcMaxY );
+	y1 = GetTileY( ndcMinY );
+
+	return true;
+}
+
+//
+//	rxLightClusters::AssignLight
+//
+void rxLightClusters::AssignLight( UINT lightIndex )
+{
+	const Light & light = this->lights[ lightIndex ];
+
+	UINT  x0, y0, z0, x1, y1, z1;
+	if( !GetClusterRange( light, x0, y0, z0, x1, y1, z1 ) ) {
+		return;
+	}
+
+	const __m128  lightX = _mm_set1_ps( light.position[0] );
+	const __m128  lightY = _mm_set1_ps( light.position[1] );
+	const __m128  lightZ = _mm_set1_ps( light.position[2] );
+	const __m128  radius = _mm_set1_ps( light.radius );
+	const __m128  radiusSq = _mm_set1_ps( light.radius * light.radius );
+
+	const __m128  dirX = _mm_set1_ps( light.direction[0] );
+	const __m128  dirY = _mm_set1_ps( light.direction[1] );
+	const __m128  dirZ = _mm_set1_ps( light.direction[2] );
+	const __m128  cosAngle = _mm_set1_ps( light.cosAngle );
+	const __m128  sinAngle = _mm_set1_ps( light.sinAngle );
+	const __m128  zero = _mm_setzero_ps();
+
+	const UINT  firstGroup = x0 & ~3;
+
+	for( UINT z = z0; z <= z1; z++ )
+	{
+		for( UINT y = y0; y <= y1; y++ )
+		{
+			for( UINT x = firstGroup; x <= x1; x += 4 )
+			{
+				const UINT  index = GetClusterIndex( x, y, z );
+
+				// Sphere vs box: squared distance from the light center to the box.
+				__m128  dx = _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( &boxMinX[ index ] ), lightX ), _mm_sub_ps( lightX, _mm_loadu_ps( &boxMaxX[ index ] ) ) );
+				__m128  dy = _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( &boxMinY[ index ] ), lightY ), _mm_sub_ps( lightY, _mm_loadu_ps( &boxMaxY[ index ] ) ) );
+				__m128  dz = _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( &boxMinZ[ index ] ), lightZ ), _mm_sub_ps( lightZ, _mm_loadu_ps( &boxMaxZ[ index ] ) ) );
+				dx = _mm_max_ps( dx, zero );
+				dy = _mm_max_ps( dy, zero );
+				dz = _mm_max_ps( dz, zero );
+
+				const __m128  distSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+				int  mask = _mm_movemask_ps( _mm_cmple_ps( distSq, radiusSq ) );
+
+				if( mask && light.bSpot )
+				{
+					// Cone vs bounding sphere of the cluster.
+					const __m128  clusterRadius = _mm_loadu_ps( &sphereRadius[ index ] );
+					const __m128  vx = _mm_sub_ps( _mm_loadu_ps( &sphereX[ index ] ), lightX );
+					const __m128  vy = _mm_sub_ps( _mm_loadu_ps( &sphereY[ index ] ), lightY );
+					const __m128  vz = _mm_sub_ps( _mm_loadu_ps( &sphereZ[ index ] ), lightZ );
+
+					const __m128  lenSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) );
+					const __m128  v1 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, dirX ), _mm_mul_ps( vy, dirY ) ), _mm_mul_ps( vz, dirZ ) );
+					const __m128  distToAxis = _mm_sqrt_ps( _mm_max_ps( _mm_sub_ps( lenSq, _mm_mul_ps( v1, v1 ) ), zero ) );
+					const __m128  distToCone = _mm_sub_ps( _mm_mul_ps( cosAngle, distToAxis ), _mm_mul_ps( v1, sinAngle ) );
+
+					const __m128  bAngleCull = _mm_cmpgt_ps( distToCone, clusterRadius );
+					const __m128  bFrontCull = _mm_cmpgt_ps( v1, _mm_add_ps( clusterRadius, radius ) );
+					const __m128  bBackCull = _mm_cmplt_ps( v1, _mm_sub_ps( zero, clusterRadius ) );
+
+					mask &= ~_mm_movemask_ps( _mm_or_ps( _mm_or_ps( bAngleCull, bFrontCull ), bBackCull ) );
+				}
+
+				// Ignore clusters outside the range (the first and the last group can be partially outside).
+				for( UINT i = 0; i < 4; i++ )
+				{
+					if( ( mask & (1 << i) ) && ( x + i >= x0 ) && ( x + i <= x1 ) ) {
+						this->pairs.Append( ( (index + i) << 16 ) | lightIndex );
+					}
+				}
+			}
+		}
+	}
+}
+
+bool rxLightClusters::TestClusterScalar( UINT index, const Light& light ) const
+{
+	FLOAT  distSq = 0.0f;
+	const FLOAT * boxMin[3] = { &boxMinX[ index ], &boxMinY[ index ], &boxMinZ[ index ] };
+	const FLOAT * boxMax[3] = { &boxMaxX[ index ], &boxMaxY[ index ], &boxMaxZ[ index ] };
+	for( UINT i = 0; i < 3; i++ )
+	{
+		const FLOAT  d = Max( Max( *boxMin[i] - light.position[i], light.position[i] - *boxMax[i] ), 0.0f );
+		distSq += d * d;
+	}
+	if( distSq > light.radius * light.radius ) {
+		return false;
+	}
+
+	if( light.bSpot )
+	{
+		const FLOAT  vx = sphereX[ index ] - light.position[0];
+		const FLOAT  vy = sphereY[ index ] - light.position[1];
+		const FLOAT  vz = sphereZ[ index ] - light.position[2];
+		const FLOAT  clusterRadius = sphereRadius[ index ];
+
+		const FLOAT  lenSq = vx * vx + vy * vy + vz * vz;
+		const FLOAT  v1 = vx * light.direction[0] + vy * light.direction[1] + vz * light.direction[2];
+		const FLOAT  distToCone = light.cosAngle * mxMath::Sqrt( Max( lenSq - v1 * v1, 0.0f ) ) - v1 * light.sinAngle;
+
+		if( distToCone > clusterRadius || v1 > clusterRadius + light.radius || v1 < -clusterRadius ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//
+//	rxLightClusters::CheckAgainstReference
+//
+bool rxLightClusters::CheckAgainstReference() const
+{
+	if( this->clusterOffsets.Num() != NumClusters() + 1 ) {
+		return false;
+	}
+
+	for( UINT z = 0; z < this->numSlices; z++ ) {
+	for( UINT y = 0; y < this->numTilesY; y++ ) {
+	for( UINT x = 0; x < this->numTilesX; x++ )
+	{
+		const UINT  index = GetClusterIndex( x, y, z );
+
+		UINT  numLights;
+		const UINT16 * clusterLights = GetLights( index, numLights );
+
+		UINT  numFound = 0;
+		for( UINT iLight = 0; iLight < this->lights.Num(); iLight++ )
+		{
+			const Light & light = this->lights[ iLight ];
+
+			UINT  x0, y0, z0, x1, y1, z1;
+			const bool  bInRange = GetClusterRange( light, x0, y0, z0, x1, y1, z1 )
+				&& x >= x0 && x <= x1 && y >= y0 && y <= y1 && z >= z0 && z <= z1;
+
+			if( bInRange && TestClusterScalar( index, light ) )
+			{
+				if( numFound >= numLights || clusterLights[ numFound ] != iLight )
+				{
+					DEBUG_CODE( sys::Print( TEXT("Light clusters: light %u is missing in cluster (%u, %u, %u)\n"), iLight, x, y, z ) );
+					return false;
+				}
+				numFound++;
+			}
+		}
+		if( numFound != numLights )
+		{
+			DEBUG_CODE( sys::Print( TEXT("Light clusters: cluster (%u, %u, %u) has extra lights\n"), x, y, z ) );
+			return false;
+		}
+	}}}
+
+	return true;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,172 @@
+/*
+=============================================================================
+	File:	LightClusters.h
+	Desc:	Assignment of local lights to view frustum clusters.
+=============================================================================
+*/
+
+#ifndef __RX_LIGHT_CLUSTERS_H__
+#define __RX_LIGHT_CLUSTERS_H__
+
+// Set to 1 to assign visible local lights to clusters every frame.
+// Off by default: the deferred lighting stage still draws a volume per light
+// and nothing reads the cluster lists until there is a clustered lighting shader.
+#ifndef RX_LIGHT_CLUSTERS
+#define RX_LIGHT_CLUSTERS			0
+#endif
+
+// Set to 1 to validate the cluster assignment against the brute-force reference every frame (slow).
+#ifndef RX_DEBUG_LIGHT_CLUSTERS
+#define RX_DEBUG_LIGHT_CLUSTERS		0
+#endif
+
+namespace abc {
+
+//
+//	rxLightClusters - splits the view frustum into a grid of clusters ("froxels")
+//	and builds a compact list of lights affecting each cluster.
+//
+//	The grid consists of screen-space tiles and depth slices with exponentially increasing thickness.
+//	All positions are given in view space (left-handed, looking along +Z).
+//
+//	Each light is only tested against the clusters which overlap its screen-space rectangle and depth range;
+//	four clusters in a row are tested at once with SSE (sphere vs box for point lights, cone vs sphere for spot lights).
+//
+//	The results are stored in two arrays which can be uploaded to the GPU for shading all lights in a single pass:
+//	per-cluster offsets into the light index list and the light index list itself.
+//
+class rxLightClusters {
+public:
+	enum {
+		DEFAULT_TILES_X	= 16,
+		DEFAULT_TILES_Y	= 8,
+		DEFAULT_SLICES	= 24,
+
+		MAX_LIGHTS		= 0xFFFF,	// light indices are 16-bit
+		MAX_CLUSTERS	= 0xFFFF,
+	};
+
+public:
+				rxLightClusters();
+				~rxLightClusters();
+
+				// Sets the grid resolution.
+	void		Setup( UINT newTilesX = DEFAULT_TILES_X, UINT newTilesY = DEFAULT_TILES_Y, UINT newSlices = DEFAULT_SLICES );
+
+				// Sets projection parameters (scale factors are the diagonal elements of the projection matrix).
+				// Cluster bounds are recalculated only if the parameters have changed.
+	void		SetProjection( FLOAT newXScale, FLOAT newYScale, FLOAT newNearZ, FLOAT newFarZ );
+
+				// Extracts the parameters from a left-handed perspective projection matrix.
+	void		SetProjection( const Matrix4& projectionMatrix );
+
+				// Removes all lights.
+	void		Clear();
+
+				// Both functions return the index of the added light.
+	UINT		AddPointLight( const Vec3D& viewPosition, FLOAT radius );
+	UINT		AddSpotLight( const Vec3D& viewPosition, const Vec3D& viewDirection, FLOAT range, FLOAT cosHalfAngle );
+
+				// Assigns the added lights to clusters.
+	void		Build();
+
+	UINT		NumLights() const;
+	UINT		NumClusters() const;	// including padding
+	UINT		NumLightIndices() const;
+
+	UINT		GetClusterIndex( UINT tileX, UINT tileY, UINT slice ) const;
+
+				// Returns the index of the cluster containing the given point (the point must be inside the frustum).
+	UINT		FindCluster( const Vec3D& viewPosition ) const;
+
+				// Returns the indices of lights affecting the given cluster.
+	const UINT16 *	GetLights( UINT clusterIndex, UINT &OutNumLights ) const;
+
+				// For uploading to the GPU: [NumClusters() + 1] offsets into [NumLightIndices()] light indices.
+	const UINT32 *	GetClusterOffsets() const;
+	const UINT16 *	GetLightIndices() const;
+
+				// Performs the same assignment with brute force, for testing. Returns 'false' if results differ.
+	bool		CheckAgainstReference() const;
+
+private:
+	struct Light
+	{
+		FLOAT	position[3];
+		FLOAT	radius;
+		FLOAT	direction[3];	// only for spot lights
+		FLOAT	cosAngle;		// cosine of half angle, zero for point lights
+		FLOAT	sinAngle;
+		bool	bSpot;
+	};
+
+	void	CalcClusterBounds();
+
+	UINT	GetSlice( FLOAT viewZ ) const;
+	UINT	GetTileX( FLOAT ndcX ) const;
+	UINT	GetTileY( FLOAT ndcY ) const;
+
+			// Returns 'false' if the light is outside the frustum.
+	bool	GetClusterRange( const Light& light, UINT &x0, UINT &y0, UINT &z0, UINT &x1, UINT &y1, UINT &z1 ) const;
+
+	void	AssignLight( UINT lightIndex );
+
+	bool	TestClusterScalar( UINT clusterIndex, const Light& light ) const;
+
+private:
+	UINT	numTilesX;
+	UINT	numTilesY;
+	UINT	numSlices;
+	UINT	strideX;		// 'numTilesX' rounded up to a multiple of four
+
+	FLOAT	xScale, yScale;
+	FLOAT	nearZ, farZ;
+	FLOAT	sliceScale;		// for converting depth to slice index
+	bool	bBoundsValid;
+
+	// Bounds of clusters in view space (structure of arrays).
+	TArray< FLOAT >		boxMinX, boxMinY, boxMinZ;
+	TArray< FLOAT >		boxMaxX, boxMaxY, boxMaxZ;
+	TArray< FLOAT >		sphereX, sphereY, sphereZ, sphereRadius;
+
+	TArray< Light >		lights;
+
+	// Temporary list of (cluster index << 16 | light index) pairs.
+	TArray< UINT32 >	pairs;
+
+	// Results.
+	TArray< UINT32 >	clusterOffsets;
+	TArray< UINT16 >	lightIndices;
+};
+
+FORCEINLINE UINT rxLightClusters::NumLights() const {
+	return lights.Num();
+}
+
+FORCEINLINE UINT rxLightClusters::NumClusters() const {
+	return strideX * numTilesY * numSlices;
+}
+
+FORCEINLINE UINT rxLightClusters::NumLightIndices() const {
+	return lightIndices.Num();
+}
+
+FORCEINLINE UINT rxLightClusters::GetClusterIndex( UINT tileX, UINT tileY, UINT slice ) const {
+	return ( slice * numTilesY + tileY ) * strideX + tileX;
+}
+
+FORCEINLINE const UINT32 * rxLightClusters::GetClusterOffsets() const {
+	return clusterOffsets.Ptr();
+}
+
+FORCEINLINE const UINT16 * rxLightClusters::GetLightIndices() const {
+	return lightIndices.Ptr();
+}
+
+}//End of namespace abc
+
+#endif // !__RX_LIGHT_CLUSTERS_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
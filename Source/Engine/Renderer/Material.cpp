@@ -48,6 +48,18 @@ const FColor	FColor::CYAN				( 0.0f, 	1.0f, 	1.0f, 	1.0f );
 const FColor	FColor::MAGENTA				( 1.0f, 	0.0f, 	1.0f, 	1.0f );
 const FColor	FColor::DARKBROWN			( 0.45f,	0.39f,	0.34f,	1.0f );
 
+/*================================
+		rxMaterial
+================================*/
+
+namespace {
+	sys::AtomicInt	gNumMaterialsCreated = 0;
+}
+
+rxMaterial::rxMaterial()
+	: sortId( (UINT32) sys::AtomicIncrement( &gNumMaterialsCreated ) )
+{}
+
 //-----------------------------------------------------
 
 }//End of namespace abc
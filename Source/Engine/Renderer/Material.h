@@ -548,10 +548,15 @@ public:
 //
 class rxMaterial {
 public:
-	// ...
+	// Returns a small number which identifies this material (used for sorting draw calls by material).
+	UINT32	GetSortId() const { return sortId; }
 
 protected:
+	rxMaterial();
 	virtual ~rxMaterial() {}
+
+private:
+	const UINT32	sortId;
 };
 
 }//End of namespace abc
@@ -0,0 +1,158 @@
+/*
+=============================================================================
+	File:	MeshCache.cpp
+	Desc:	Binary mesh cache - meshes converted once and memory-mapped later.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+namespace {
+
+FORCEINLINE UINT32 AlignOffset( UINT32 offset )
+{
+	const UINT32 alignment = mxMeshCacheHeader::DATA_ALIGNMENT;
+	return ( offset + alignment - 1 ) & ~( alignment - 1 );
+}
+
+bool WritePadding( FILE* file, UINT32 currentOffset, UINT32 alignedOffset )
+{
+	static const BYTE zeros[ mxMeshCacheHeader::DATA_ALIGNMENT ] = { 0 };
+	const UINT32 numBytes = alignedOffset - currentOffset;
+	return ( fwrite( zeros, 1, numBytes, file ) == numBytes );
+}
+
+}//End of anonymous namespace
+
+bool SaveMeshCache( const mxMesh* mesh, const mxChar* filename, const mxMeshCacheKey& key )
+{
+	AssertPtr( mesh );
+	AssertPtr( filename );
+	Assert( mesh->IsValid() );
+
+	const UINT32 verticesSize = mesh->numVertices * sizeof(rxVertex);
+	const UINT32 indicesSize = mesh->numIndices * sizeof(rxIndex);
+
+	mxMeshCacheHeader  header;
+	MemZero( &header, sizeof(header) );
+
+	header.fourCC			= mxMeshCacheHeader::FOURCC;
+	header.version			= mxMeshCacheHeader::VERSION;
+	header.vertexSize		= sizeof(rxVertex);
+	header.indexSize		= sizeof(rxIndex);
+	header.sourceTimestamp	= key.sourceTimestamp;
+	header.optionsHash		= key.optionsHash;
+	header.numVertices		= mesh->numVertices;
+	header.numIndices		= mesh->numIndices;
+	header.verticesOffset	= AlignOffset( sizeof(header) );
+	header.indicesOffset	= AlignOffset( header.verticesOffset + verticesSize );
+	header.fileSize			= header.indicesOffset + indicesSize;
+	header.boundsMin		= mesh->bounds.GetMin();
+	header.boundsMax		= mesh->bounds.GetMax();
+	header.sphereCenter		= mesh->sphere.GetOrigin();
+	header.sphereRadius		= mesh->sphere.GetRadius();
+
+	// The data is written into a temporary file which then replaces the cache file,
+	// so that a loader (or a crash) never sees a partially written cache file.
+	// The name is unique per thread because several threads can import the same mesh.
+	String  tempFileName;
+	_sprintf( tempFileName, "%s.%u.tmp", filename, (UINT32) sys::GetCurrentThreadID() );
+
+	FILE * file = fopen( tempFileName.ToChar(), "wb" );
+	if ( ! file ) {
+		return false;
+	}
+
+	bool bOk =
+		( fwrite( &header, sizeof(header), 1, file ) == 1 )
+		&& WritePadding( file, sizeof(header), header.verticesOffset )
+		&& ( fwrite( mesh->vertices, 1, verticesSize, file ) == verticesSize )
+		&& WritePadding( file, header.verticesOffset + verticesSize, header.indicesOffset )
+		&& ( fwrite( mesh->indices, 1, indicesSize, file ) == indicesSize )
+		;
+
+	const bool bClosed = ( fclose( file ) == 0 );
+	bOk = bOk && bClosed;
+
+	// fails if the old cache file is mapped by another thread, it will be replaced next time
+	bOk = bOk && ( ::MoveFileEx( tempFileName.ToChar(), filename, MOVEFILE_REPLACE_EXISTING ) != FALSE );
+
+	if ( ! bOk ) {
+		::remove( tempFileName.ToChar() );
+	}
+	return bOk;
+}
+
+mxMesh* LoadMeshCache( const mxChar* filename, const mxMeshCacheKey& key )
+{
+	AssertPtr( filename );
+
+	mxMappedFilePtr  file( MX_NEW mxMappedFile() );
+	if ( ! file->Open( filename ) ) {
+		return null;
+	}
+
+	const BYTE * data = file->GetData();
+	const SizeT fileSize = file->GetSize();
+
+	if ( fileSize < sizeof(mxMeshCacheHeader) ) {
+		return null;
+	}
+
+	const mxMeshCacheHeader & header = *reinterpret_cast< const mxMeshCacheHeader* >( data );
+
+	if ( header.fourCC != mxMeshCacheHeader::FOURCC
+		|| header.version != mxMeshCacheHeader::VERSION
+		|| header.vertexSize != sizeof(rxVertex)
+		|| header.indexSize != sizeof(rxIndex) )
+	{
+		return null;
+	}
+
+	if ( header.sourceTimestamp != key.sourceTimestamp
+		|| header.optionsHash != key.optionsHash )
+	{
+		return null;
+	}
+
+	// reject truncated or corrupted files
+	if ( header.fileSize != fileSize
+		|| header.numVertices == 0 || header.numIndices == 0
+		|| header.verticesOffset < sizeof(mxMeshCacheHeader)
+		|| header.indicesOffset < header.verticesOffset + header.numVertices * sizeof(rxVertex)
+		|| header.fileSize < header.indicesOffset + header.numIndices * sizeof(rxIndex)
+		|| ( header.verticesOffset % mxMeshCacheHeader::DATA_ALIGNMENT ) != 0
+		|| ( header.indicesOffset % mxMeshCacheHeader::DATA_ALIGNMENT ) != 0 )
+	{
+		sys::Warning( "Mesh cache file '%s' is corrupted\n", filename );
+		return null;
+	}
+
+	mxMesh * newMesh = MX_NEW mxMesh();
+
+	// the mesh keeps the file mapped until it's cleared
+	newMesh->storage = file;
+
+	newMesh->numVertices = header.numVertices;
+	newMesh->vertices = reinterpret_cast< rxVertex* >( file->GetData() + header.verticesOffset );
+
+	newMesh->numIndices = header.numIndices;
+	newMesh->indices = reinterpret_cast< rxIndex* >( file->GetData() + header.indicesOffset );
+
+	newMesh->bounds.GetMin() = header.boundsMin;
+	newMesh->bounds.GetMax() = header.boundsMax;
+
+	newMesh->sphere.SetOrigin( header.sphereCenter );
+	newMesh->sphere.SetRadius( header.sphereRadius );
+
+	return newMesh;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
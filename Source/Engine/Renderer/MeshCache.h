@@ -0,0 +1,84 @@
+/*
+=============================================================================
+	File:	MeshCache.h
+	Desc:	Binary mesh cache - meshes converted once and memory-mapped later.
+=============================================================================
+*/
+
+#ifndef __RX_MESH_CACHE_H__
+#define __RX_MESH_CACHE_H__
+
+namespace abc {
+
+//
+//	mxMeshCacheKey - identifies the source data the cached mesh was built from.
+//
+//	A cache file is rejected if the source file was modified
+//	or if the mesh was imported with different options.
+//
+struct mxMeshCacheKey
+{
+	UINT64	sourceTimestamp;	// last modification time of the source file
+	UINT32	optionsHash;		// hash of the import options (transform, texture coordinate scale, etc)
+
+public:
+	mxMeshCacheKey()
+		: sourceTimestamp( 0 )
+		, optionsHash( 0 )
+	{}
+};
+
+//
+//	mxMeshCacheHeader - the header of a mesh cache file.
+//
+//	The header is followed by the vertex and index data
+//	which can be used directly from the mapped file.
+//
+struct mxMeshCacheHeader
+{
+	enum {
+		FOURCC	= 'M' | ('S' << 8) | ('H' << 16) | ('C' << 24),
+		VERSION	= 1,
+
+		// the offsets of the vertex and index blobs are aligned to this value
+		DATA_ALIGNMENT = 16,
+	};
+
+	UINT32	fourCC;
+	UINT32	version;
+
+	// must match the current build, the data is not converted on load
+	UINT32	vertexSize;		// sizeof(rxVertex)
+	UINT32	indexSize;		// sizeof(rxIndex)
+
+	UINT64	sourceTimestamp;
+	UINT32	optionsHash;
+
+	UINT32	numVertices;
+	UINT32	numIndices;
+	UINT32	verticesOffset;	// from the start of the file
+	UINT32	indicesOffset;	// from the start of the file
+	UINT32	fileSize;
+
+	// precomputed bounding volumes in local space
+	Vec3D	boundsMin;
+	Vec3D	boundsMax;
+	Vec3D	sphereCenter;
+	FLOAT	sphereRadius;
+};
+
+// Writes the mesh into the cache file, returns false on failure.
+// The existing cache file is replaced only after the new one has been completely written.
+bool SaveMeshCache( const mxMesh* mesh, const mxChar* filename, const mxMeshCacheKey& key );
+
+// Maps the cache file and returns a new mesh whose vertices and indices point into the mapped file.
+// Returns null if the file doesn't exist, is corrupted or out of date.
+mxMesh* LoadMeshCache( const mxChar* filename, const mxMeshCacheKey& key );
+
+}//End of namespace abc
+
+#endif // !__RX_MESH_CACHE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
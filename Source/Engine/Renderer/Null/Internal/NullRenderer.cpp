@@ -0,0 +1,285 @@
+/*
+=============================================================================
+	File:	NullRenderer.cpp
+	Desc:	Null render system (doesn't use any graphics API).
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+#include <Renderer/Null/NullRenderSystem.h>
+
+namespace abc {
+
+//
+//	Global variables
+//
+namespace nullrx {
+
+	TPtr< NullRenderer >		renderer;
+	TPtr< NullResources >		resources;
+
+	NullScene			theScene;
+	TPtr< NullScene >	scene( &theScene );
+
+	NullStats					stats;
+
+}//End of namespace nullrx
+
+/*================================
+		NullDebugText
+================================*/
+
+void NullDebugText::SetText( const char* format, ... )
+{}
+
+void NullDebugText::SetColor( const FColor& newColor )
+{}
+
+void NullDebugText::SetPosition( mxUInt x, mxUInt y )
+{}
+
+/*================================
+		NullDebugMesh
+================================*/
+
+void NullDebugMesh::SetMaterial( rxMaterial* material )
+{}
+
+void NullDebugMesh::SetWorldTransform( const Matrix4& transform )
+{}
+
+/*================================
+		NullDebugAxes
+================================*/
+
+void NullDebugAxes::SetColor( const FColor& newColor )
+{}
+
+void NullDebugAxes::SetTransform( const Vec3D& translation, const Quat& orientation )
+{}
+
+/*================================
+		NullDebugDrawer
+================================*/
+
+NullDebugDrawer::NullDebugDrawer()
+{}
+
+NullDebugDrawer::~NullDebugDrawer()
+{
+	Shutdown();
+}
+
+void NullDebugDrawer::Shutdown()
+{
+	this->texts.DeleteContents( true );
+	this->meshes.DeleteContents( true );
+	this->axes.DeleteContents( true );
+}
+
+void NullDebugDrawer::DebugPoint( const Vec3D& position, const FLOAT radius, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugLine( const Vec3D& start, const Vec3D& end, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugArrow( const Vec3D& start, const Vec3D& end, const mxUInt size, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugCircle( const Vec3D& origin, const Vec3D& axis, const FLOAT radius, const mxUInt numSteps, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugSphere( const Sphere &sphere, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugAABB( const AABB& aabb, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugOBB( const OOBB& obb, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugCone( const Vec3D& apex, const Vec3D& dir, const FLOAT radius1, const FLOAT radius2, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugAxis( const Vec3D& origin, const Matrix3 &axis, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugFrustum( const mxViewFrustum &frustum, const rxDebugDrawOptions& drawOptions )
+{}
+
+void NullDebugDrawer::DebugClear( mxUInt lifetimeThreshMs )
+{}
+
+void NullDebugDrawer::DebugText( const char *text, const Vec3D& origin, const Matrix3& viewAxis, const FLOAT size, const rxDebugDrawOptions& drawOptions )
+{}
+
+rxDebugText * NullDebugDrawer::CreateText( const rxDebugTextDesc& desc )
+{
+	NullDebugText * pNewText = MX_NEW NullDebugText();
+	this->texts.Append( pNewText );
+	return pNewText;
+}
+
+rxDebugMesh * NullDebugDrawer::CreateMesh()
+{
+	NullDebugMesh * pNewMesh = MX_NEW NullDebugMesh();
+	this->meshes.Append( pNewMesh );
+	return pNewMesh;
+}
+
+rxDebugMesh * NullDebugDrawer::CreateTeapot()
+{
+	return CreateMesh();
+}
+
+rxDebugMesh * NullDebugDrawer::CreateBox( FLOAT width, FLOAT height, FLOAT depth )
+{
+	return CreateMesh();
+}
+
+rxDebugMesh * NullDebugDrawer::CreateSphere( FLOAT radius, UINT slices, UINT stacks )
+{
+	return CreateMesh();
+}
+
+rxDebugMesh * NullDebugDrawer::CreateCylinder( FLOAT radius1, FLOAT radius2, FLOAT length, UINT slices, UINT stacks )
+{
+	return CreateMesh();
+}
+
+rxDebugMesh * NullDebugDrawer::CreateTorus( FLOAT innerRadius, FLOAT outerRadius, UINT sides, UINT rings )
+{
+	return CreateMesh();
+}
+
+void NullDebugDrawer::RemoveMesh( rxDebugMesh* pMesh )
+{
+	AssertPtr( pMesh );
+	NullDebugMesh * pNullMesh = checked_cast< NullDebugMesh*, rxDebugMesh* >( pMesh );
+	this->meshes.Remove( pNullMesh );
+	MX_FREE( pNullMesh );
+}
+
+rxDebugAxes * NullDebugDrawer::CreateDebugAxes()
+{
+	NullDebugAxes * pNewAxes = MX_NEW NullDebugAxes();
+	this->axes.Append( pNewAxes );
+	return pNewAxes;
+}
+
+/*================================
+		NullRenderer
+================================*/
+
+NullRenderer::NullRenderer()
+{
+	ENSURE_ONE_CALL;
+}
+
+NullRenderer::~NullRenderer()
+{}
+
+//
+//	NullRenderer::Create
+//
+bool NullRenderer::Create( const rxRenderDeviceCreationInfo& creationInfo )
+{
+	//	Initialize our device data for the first time.
+	{
+		this->rendererInfo.Clear();
+
+		this->rendererInfo.DriverType = EDriverType::GAPI_None;
+		this->rendererInfo.pWindowHandle = creationInfo.pWindowHandle;
+
+		this->rendererInfo.DisplayMode.screen = creationInfo.screen;
+		this->rendererInfo.DisplayMode.refreshRateHz = creationInfo.refreshRateHz;
+	}
+
+	// Initialize global pointer variables.
+	{
+		nullrx::renderer	= this;
+		nullrx::resources	= & this->resources;
+
+		nullrx::stats.Reset();
+	}
+
+	nullrx::theScene.Initialize();
+
+	this->resources.Initialize();
+
+	return true;
+}
+
+//
+//	NullRenderer::Destroy
+//
+void NullRenderer::Destroy()
+{
+	Shutdown();
+
+	MX_FREE( this );
+}
+
+//
+//	NullRenderer::Shutdown
+//
+void NullRenderer::Shutdown()
+{
+	nullrx::theScene.Shutdown();
+
+	this->debugDrawer.Shutdown();
+
+	this->resources.Shutdown();
+	nullrx::resources = null;
+
+	nullrx::renderer = null;
+}
+
+rxScene & NullRenderer::GetScene()
+{
+	return nullrx::theScene;
+}
+
+//
+//	NullRenderer::RenderScene
+//
+void NullRenderer::RenderScene( const mxSceneView& view, mxScene* scene )
+{
+	// reset performance counters
+	nullrx::stats.Reset();
+
+	NullStatCounter  frameTime( nullrx::stats.renderTime );
+
+	nullrx::theScene.DrawScene( view, scene );
+}
+
+rxResources & NullRenderer::GetResources()
+{
+	return this->resources;
+}
+
+rxDebugDrawer & NullRenderer::GetDebugDrawer()
+{
+	return this->debugDrawer;
+}
+
+const rxStatistics & NullRenderer::GetStats() const
+{
+	return nullrx::stats;
+}
+
+const rxRendererInfo & NullRenderer::GetInfo() const
+{
+	return this->rendererInfo;
+}
+
+void NullRenderer::HandleMessage( const TMessagePtr& aMsg )
+{
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,175 @@
+/*
+=============================================================================
+	File:	NullRenderer.h
+	Desc:	Null render system (doesn't use any graphics API).
+=============================================================================
+*/
+
+#ifndef __MX_NULL_RENDERER_H__
+#define __MX_NULL_RENDERER_H__
+
+namespace abc {
+
+//
+//	NullDebugText
+//
+class NullDebugText : public rxDebugText {
+public:
+	void	SetText( const char* format, ... );
+	void	SetColor( const FColor& newColor );
+	void	SetPosition( mxUInt x, mxUInt y );
+};
+
+//
+//	NullDebugMesh
+//
+class NullDebugMesh : public rxDebugMesh {
+public:
+	void	SetMaterial( rxMaterial* material );
+	void	SetWorldTransform( const Matrix4& transform );
+};
+
+//
+//	NullDebugAxes
+//
+class NullDebugAxes : public rxDebugAxes {
+public:
+	void	SetColor( const FColor& newColor );
+	void	SetTransform( const Vec3D& translation, const Quat& orientation );
+};
+
+//
+//	NullDebugDrawer - ignores all debug drawing requests.
+//
+class NullDebugDrawer : public rxDebugDrawer {
+public:
+			NullDebugDrawer();
+			~NullDebugDrawer();
+
+	void	Shutdown();
+
+	//
+	//	Override ( rxDebugDrawer ) :
+	//
+	void	DebugPoint( const Vec3D& position, const FLOAT radius = 1.0f,
+					const rxDebugDrawOptions& drawOptions = rxDebugDrawOptions() );
+
+	void	DebugLine( const Vec3D& start, const Vec3D& end,
+					const rxDebugDrawOptions& drawOptions = rxDebugDrawOptions() );
+
+	void	DebugArrow( const Vec3D& start, const Vec3D& end, const mxUInt size,
+					const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugCircle( const Vec3D& origin, const Vec3D& axis, const FLOAT radius, const mxUInt numSteps = 8,
+					const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugSphere( const Sphere &sphere, const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugAABB( const AABB& aabb, const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugOBB( const OOBB& obb, const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugCone( const Vec3D& apex, const Vec3D& dir, const FLOAT radius1, const FLOAT radius2,
+					const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugAxis( const Vec3D& origin, const Matrix3 &axis, const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugFrustum( const mxViewFrustum &frustum, const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	void	DebugClear( mxUInt lifetimeThreshMs );
+
+	void	DebugText( const char *text, const Vec3D& origin, const Matrix3& viewAxis, const FLOAT size = 1.0f,
+					const rxDebugDrawOptions& = rxDebugDrawOptions() );
+
+	rxDebugText *	CreateText( const rxDebugTextDesc& desc = rxDebugTextDesc() );
+
+	rxDebugMesh *	CreateTeapot();
+	rxDebugMesh *	CreateBox( FLOAT width, FLOAT height, FLOAT depth );
+	rxDebugMesh *	CreateSphere( FLOAT radius, UINT slices, UINT stacks );
+	rxDebugMesh *	CreateCylinder( FLOAT radius1, FLOAT radius2, FLOAT length, UINT slices, UINT stacks );
+	rxDebugMesh *	CreateTorus( FLOAT innerRadius, FLOAT outerRadius, UINT sides, UINT rings );
+	void			RemoveMesh( rxDebugMesh* pMesh );
+
+	rxDebugAxes *	CreateDebugAxes();
+
+private:
+	rxDebugMesh *	CreateMesh();
+
+private:
+	TArray< NullDebugText* >	texts;
+	TArray< NullDebugMesh* >	meshes;
+	TArray< NullDebugAxes* >	axes;
+};
+
+//
+//	NullRendererInfo
+//
+struct NullRendererInfo : public rxRendererInfo
+{
+public:
+	NullRendererInfo()
+	{
+		DriverType = EDriverType::GAPI_None;
+	}
+	void Clear()
+	{
+		MemZero( this, sizeof(*this) );
+	}
+};
+
+//
+//	NullRenderer
+//
+class NullRenderer : public rxRenderer {
+public:
+			NullRenderer();
+			~NullRenderer();
+
+	//
+	// Override ( rxRenderer ) :
+	//
+
+	bool	Create( const rxRenderDeviceCreationInfo& creationInfo );
+	void	Destroy();
+
+	//--- Rendering ----------------------------------------------------------------
+
+	rxScene &	GetScene();
+
+	void	RenderScene( const mxSceneView& view, mxScene* scene );
+
+	//--- Graphics resource management. --------------------------------------------
+
+	rxResources &		GetResources();
+
+	//--- Testing and Debugging ----------------------------------------------------
+
+	rxDebugDrawer &		GetDebugDrawer();
+
+	const rxStatistics &	GetStats() const;
+
+	const rxRendererInfo &	GetInfo() const;
+
+	//
+	// Override ( mxMessagePort ) :
+	//
+	void HandleMessage( const TMessagePtr& msg );
+
+private:	// Internal functions.
+
+	void	Shutdown();
+
+private:
+	NullResources		resources;
+	NullDebugDrawer		debugDrawer;
+
+	NullRendererInfo	rendererInfo;
+};
+
+}//End of namespace abc
+
+#endif // !__MX_NULL_RENDERER_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
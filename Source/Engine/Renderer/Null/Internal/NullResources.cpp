@@ -0,0 +1,311 @@
+/*
+=============================================================================
+	File:	NullResources.cpp
+	Desc:	Graphics resources of the null render system (kept in main memory).
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+#include <Renderer/Null/NullRenderSystem.h>
+
+namespace abc {
+
+/*================================
+		NullVertexFormat
+================================*/
+
+NullVertexFormat::NullVertexFormat( const rxVertexDeclaration& decl )
+	: Declaration( decl )
+{}
+
+NullVertexFormat::~NullVertexFormat()
+{}
+
+mxUInt NullVertexFormat::GetNumElements() const
+{
+	return this->Declaration.GetNumElements();
+}
+
+const rxVertexElement & NullVertexFormat::GetElement( mxUInt index ) const
+{
+	return this->Declaration.GetElement( index );
+}
+
+mxUInt NullVertexFormat::GetSize() const
+{
+	return this->Declaration.GetSize();
+}
+
+/*================================
+		NullVertexBuffer
+================================*/
+
+NullVertexBuffer::NullVertexBuffer( SizeT theVertexCount, SizeT theVertexSize )
+	: VertexSize( theVertexSize )
+{
+	this->VertexCount = theVertexCount;
+}
+
+NullVertexBuffer::~NullVertexBuffer()
+{}
+
+/*================================
+		NullIndexBuffer
+================================*/
+
+NullIndexBuffer::NullIndexBuffer( SizeT theIndexCount, SizeT theIndexSize )
+	: NumIndices( theIndexCount )
+	, IndexSize( theIndexSize )
+{}
+
+NullIndexBuffer::~NullIndexBuffer()
+{}
+
+/*================================
+		NullTexture
+================================*/
+
+NullTexture::NullTexture()
+{}
+
+NullTexture::~NullTexture()
+{}
+
+rxTexture* NullTexture::MakeNormalMap( FLOAT amplitude )
+{
+	return this;
+}
+
+/*================================
+		NullMaterial
+================================*/
+
+NullMaterial::NullMaterial()
+{}
+
+NullMaterial::~NullMaterial()
+{}
+
+void NullMaterial::Setup( const rxMaterialDescription& desc )
+{
+	this->Desc = desc;
+}
+
+/*================================
+		NullResources
+================================*/
+
+NullResources::NullResources()
+{
+	MemZero( &this->stats, sizeof(this->stats) );
+}
+
+NullResources::~NullResources()
+{
+	Shutdown();
+}
+
+//
+//	NullResources::Initialize
+//
+void NullResources::Initialize()
+{
+	MemZero( &this->stats, sizeof(this->stats) );
+}
+
+//
+//	NullResources::Shutdown
+//
+void NullResources::Shutdown()
+{
+	this->materials.		Delete();
+	this->textures.			Delete();
+	this->unnamedTextures.	DeleteContents(true);
+	this->vertexFormats.	DeleteContents(true);
+	this->vertexBuffers.	DeleteContents(true);
+	this->indexBuffers.		DeleteContents(true);
+
+	MemZero( &this->stats, sizeof(this->stats) );
+}
+
+//
+//	NullResources::CreateVertexFormat
+//
+rxVertexFormat* NullResources::CreateVertexFormat( const rxVertexDeclaration& decl, rxMaterial* material )
+{
+	Assert( decl.IsValid() );
+
+	NullVertexFormat * pNewVertexFormat = MX_NEW NullVertexFormat( decl );
+	this->vertexFormats.Append( pNewVertexFormat );
+
+	this->stats.numVertexFormats++;
+
+	return pNewVertexFormat;
+}
+
+//
+//	NullResources::AllocateVertexBuffer
+//
+rxVertices * NullResources::AllocateVertexBuffer( const rxVertexBufferDescription& desc )
+{
+	Assert( desc.IsValid() );
+
+	NullVertexBuffer * pNewVertexBuffer = MX_NEW NullVertexBuffer( desc.VertexCount, desc.VertexSize );
+	this->vertexBuffers.Append( pNewVertexBuffer );
+
+	this->stats.numVertexBuffers++;
+
+	return pNewVertexBuffer;
+}
+
+//
+//	NullResources::AllocateIndexBuffer
+//
+rxIndices * NullResources::AllocateIndexBuffer( const rxIndexBufferDescription& desc )
+{
+	Assert( desc.IsValid() );
+
+	NullIndexBuffer * pNewIndexBuffer = MX_NEW NullIndexBuffer( desc.IndexCount, desc.IndexSize );
+	this->indexBuffers.Append( pNewIndexBuffer );
+
+	this->stats.numIndexBuffers++;
+
+	return pNewIndexBuffer;
+}
+
+//
+//	NullResources::LoadTexture
+//
+rxTexture* NullResources::LoadTexture( const mxFilePath& filename )
+{
+	// The image is never read, textures are only identified by their file names.
+	if ( rxTexture * pTexture = this->textures.Find( filename.GetName() ) )
+	{
+		return pTexture;
+	}
+
+	NullTexture * pNewTexture = MX_NEW NullTexture();
+	this->textures.Insert( filename.GetName(), pNewTexture );
+
+	return pNewTexture;
+}
+
+//
+//	NullResources::LoadTextureFromMemory
+//
+rxTexture* NullResources::LoadTextureFromMemory( const mxChar* name, const void* pFileData, mxUInt numBytes )
+{
+	AssertPtr( name );
+	if ( rxTexture * pTexture = this->textures.Find( name ) )
+	{
+		return pTexture;
+	}
+
+	NullTexture * pNewTexture = MX_NEW NullTexture();
+	this->textures.Insert( name, pNewTexture );
+
+	return pNewTexture;
+}
+
+//
+//	NullResources::CreateTexture
+//
+rxTexture * NullResources::CreateTexture( const void* pData, mxUInt numBytes, const rxTextureDescription& desc )
+{
+	Assert( desc.IsValid() );
+
+	NullTexture * pNewTexture = MX_NEW NullTexture();
+	this->unnamedTextures.Append( pNewTexture );
+
+	return pNewTexture;
+}
+
+//
+//	NullResources::GetTexture
+//
+rxTexture * NullResources::GetTexture( const mxChar* name )
+{
+	return this->textures.Find( name );
+}
+
+rxTexture * NullResources::GetTexture( const mxNameId& name )
+{
+	return this->textures.Find( name );
+}
+
+//
+//	NullResources::LoadMaterial
+//
+rxMaterial* NullResources::LoadMaterial( const mxFilePath& filename )
+{
+	// Materials are hashed by their base names.
+	if ( rxMaterial * pMaterial = this->materials.Find( filename.GetBaseName() ) )
+	{
+		return pMaterial;
+	}
+
+	// The file is not parsed, the material is created with default parameters.
+	rxMaterialDescription  desc;
+	desc.name = filename.GetBaseName();
+
+	return CreateMaterial( desc );
+}
+
+//
+//	NullResources::CreateMaterial
+//
+rxMaterial * NullResources::CreateMaterial( const rxMaterialDescription& desc )
+{
+	Assert( desc.IsOk() );
+
+	if ( NullMaterial * pMaterial = this->materials.Find( desc.name.ToChar() ) )
+	{
+		sys::Warning( "material with name '%s' already exists", desc.name.ToChar() );
+		return pMaterial;
+	}
+
+	NullMaterial * pNewMaterial = MX_NEW NullMaterial();
+	pNewMaterial->Setup( desc );
+
+	this->materials.Insert( desc.name.ToChar(), pNewMaterial );
+
+	return pNewMaterial;
+}
+
+//
+//	NullResources::GetMaterial
+//
+rxMaterial * NullResources::GetMaterial( const mxChar* name )
+{
+	if ( rxMaterial * pMaterial = this->materials.Find( name ) )
+	{
+		return pMaterial;
+	}
+	sys::Warning( "Failed to find material '%s'", name );
+	return null;
+}
+
+rxMaterial * NullResources::GetMaterial( const mxNameId& name )
+{
+	if ( rxMaterial * pMaterial = this->materials.Find( name ) )
+	{
+		return pMaterial;
+	}
+	sys::Warning( "Failed to find material '%s'", name.ToChar() );
+	return null;
+}
+
+//
+//	NullResources::GetStats
+//
+const rxResourceStats & NullResources::GetStats() const
+{
+	return this->stats;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,160 @@
+/*
+=============================================================================
+	File:	NullResources.h
+	Desc:	Graphics resources of the null render system (kept in main memory).
+=============================================================================
+*/
+
+#ifndef __MX_NULL_RESOURCES_H__
+#define __MX_NULL_RESOURCES_H__
+
+namespace abc {
+
+//
+//	NullVertexFormat
+//
+class NullVertexFormat : public rxVertexFormat {
+public:
+	//
+	// Override ( rxVertexFormat ) :
+	//
+	mxUInt	GetNumElements() const;
+
+	const rxVertexElement &	GetElement( mxUInt index ) const;
+
+	mxUInt	GetSize() const;
+
+public:
+	NullVertexFormat( const rxVertexDeclaration& decl );
+	~NullVertexFormat();
+
+public:
+	rxVertexDeclaration		Declaration;
+};
+
+//
+//	NullVertexBuffer
+//
+class NullVertexBuffer : public rxVertices {
+public:
+	NullVertexBuffer( SizeT theVertexCount, SizeT theVertexSize );
+	~NullVertexBuffer();
+
+public:
+	const UINT		VertexSize;
+};
+
+//
+//	NullIndexBuffer
+//
+class NullIndexBuffer : public rxIndices {
+public:
+	NullIndexBuffer( SizeT theIndexCount, SizeT theIndexSize );
+	~NullIndexBuffer();
+
+public:
+	const mxUInt	NumIndices;
+	const UINT		IndexSize;
+};
+
+//
+//	NullTexture
+//
+class NullTexture : public rxTexture {
+public:
+		NullTexture();
+		~NullTexture();
+
+	//
+	// Override ( rxTexture ) :
+	//
+	rxTexture* MakeNormalMap( FLOAT amplitude = 1.0f );
+};
+
+//
+//	NullMaterial
+//
+class NullMaterial : public rxMaterial {
+public:
+	NullMaterial();
+	~NullMaterial();
+
+	void Setup( const rxMaterialDescription& desc );
+
+public:
+	rxMaterialDescription	Desc;
+};
+
+//
+//	NullResources
+//
+class NullResources : public rxResources {
+public:
+	//
+	//	Override ( rxResources ) :
+	//
+
+	//--------------------------------------------------------
+	//	Renderable geometry.
+	//--------------------------------------------------------
+
+	rxVertexFormat *	CreateVertexFormat( const rxVertexDeclaration& decl, rxMaterial* material );
+
+	rxVertices *	AllocateVertexBuffer( const rxVertexBufferDescription& desc );
+
+	rxIndices *		AllocateIndexBuffer( const rxIndexBufferDescription& desc );
+
+	//--------------------------------------------------------
+	// Texture resources.
+	//--------------------------------------------------------
+
+	rxTexture *		LoadTexture( const mxFilePath& filename );
+	rxTexture *		LoadTextureFromMemory( const mxChar* name, const void* pFileData, mxUInt numBytes );
+	rxTexture *		CreateTexture( const void* pData, mxUInt numBytes, const rxTextureDescription& desc );
+	rxTexture *		GetTexture( const mxChar* name );
+	rxTexture *		GetTexture( const mxNameId& name );
+
+	//--------------------------------------------------------
+	//	Render materials.
+	//--------------------------------------------------------
+
+	rxMaterial *	LoadMaterial( const mxFilePath& filename );
+	rxMaterial *	CreateMaterial( const rxMaterialDescription& desc );
+	rxMaterial *	GetMaterial( const mxChar* name );
+	rxMaterial *	GetMaterial( const mxNameId& name );
+
+	//--------------------------------------------------------
+	//	Stats.
+	//--------------------------------------------------------
+
+	const rxResourceStats &	GetStats() const;
+
+private:
+	// Internal functions.
+
+	friend class NullRenderer;
+
+			NullResources();
+			~NullResources();
+
+	void	Initialize();
+	void	Shutdown();		// Free all allocated resources.
+
+private:
+	TResourceSet< NullMaterial >	materials;
+	TResourceSet< NullTexture >		textures;
+	TArray< NullTexture* >			unnamedTextures;	// created from memory
+	TArray< NullVertexFormat* >		vertexFormats;
+	TArray< NullVertexBuffer* >		vertexBuffers;
+	TArray< NullIndexBuffer* >		indexBuffers;
+
+	rxResourceStats		stats;
+};
+
+}//End of namespace abc
+
+#endif // !__MX_NULL_RESOURCES_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,866 @@
+/*
+=============================================================================
+	File:	NullScene.cpp
+	Desc:	Graphics scene of the null render system.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+#include <Renderer/Null/NullRenderSystem.h>
+
+namespace abc {
+
+namespace {
+
+	template< class ENTITY >
+	void RemoveAndDelete( TArray< ENTITY* > & entities, ENTITY* theEntity )
+	{
+		AssertPtr( theEntity );
+		entities.Remove( theEntity );
+		MX_FREE( theEntity );
+	}
+
+	FORCEINLINE FLOAT GetProjectedDepth( const Vec3D& worldPosition, const NullView& view )
+	{
+		Vec4D  worldPositionH( Vec4D( worldPosition, 1.0f ) * view.ViewProjMatrix );
+		return worldPositionH.z * mxMath::Reciprocal( worldPositionH.w );
+	}
+
+}//end of anonymous namespace
+
+/*================================
+		NullRenderQueue
+================================*/
+
+NullRenderQueue::NullRenderQueue()
+{
+	this->models.SetGranularity( 256 );
+	this->translucent.SetGranularity( 64 );
+	this->localLights.SetGranularity( 64 );
+}
+
+NullRenderQueue::~NullRenderQueue()
+{}
+
+void NullRenderQueue::Clear()
+{
+	this->models		.SetNum( 0, false );
+	this->translucent	.SetNum( 0, false );
+	this->globalLights	.SetNum( 0, false );
+	this->localLights	.SetNum( 0, false );
+	this->portals		.SetNum( 0, false );
+	this->skies			.SetNum( 0, false );
+
+	this->ClearDraws();
+}
+
+void NullRenderQueue::Append( const NullRenderQueue& other )
+{
+	const UINT32  firstModel = this->models.Num();
+	const UINT32  firstTranslucent = this->translucent.Num();
+
+	this->models		.Append( other.models );
+	this->translucent	.Append( other.translucent );
+	this->globalLights	.Append( other.globalLights );
+	this->localLights	.Append( other.localLights );
+	this->portals		.Append( other.portals );
+	this->skies			.Append( other.skies );
+
+	this->AppendDraws( other, firstModel, firstTranslucent );
+}
+
+/*================================
+			NullModel
+================================*/
+
+NullModel::NullModel()
+	: worldTransform( _InitIdentity )
+	, vertexData( null )
+	, indexData( null )
+	, depth( 0.0f )
+{}
+
+NullModel::~NullModel()
+{}
+
+void NullModel::Setup( const rxModelDescription& desc )
+{
+	Assert( desc.IsOk() );
+
+	this->worldTransform.SetIdentity();
+
+	this->flags = desc.flags;
+
+	if( desc.flags & EModelFlags::MF_DynamicGeometry )
+	{
+		// Dynamic geometry is never shared.
+		this->vertexData = this;
+		this->indexData = this;
+	}
+	else
+	{
+		this->vertexData = desc.meshDesc.Vertices.Data;
+		this->indexData = desc.meshDesc.Indices.Data;
+	}
+
+	this->batch.StartIndex	= 0;
+	this->batch.IndexCount	= desc.meshDesc.Indices.IndexCount;
+	this->batch.StartVertex	= 0;
+	this->batch.VertexCount	= desc.meshDesc.Vertices.VertexCount;
+}
+
+void NullModel::Render( const rxView& view, rxQueue& queue )
+{
+	NullRenderQueue & renderQueue = ToNullQueue( queue );
+	renderQueue.models.Append( this );
+
+	this->depth = GetProjectedDepth( this->GetOrigin(), ToNullView( view ) );
+
+	renderQueue.AddModelDraw( renderQueue.models.Num() - 1, this->material, this->worldTransform, this->depth );
+}
+
+void NullModel::AddToBatch( rxInstanceBatcher& batcher, const rxMaterial* material,
+						   const Matrix4& transform, UINT32 userIndex ) const
+{
+	batcher.Add( this->vertexData, this->indexData, this->batch, material, transform, userIndex );
+}
+
+void NullModel::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullModel::SetTransform( const Matrix4& newWorldTransform )
+{
+	this->worldTransform = newWorldTransform;
+}
+
+void NullModel::SetMaterial( rxMaterial* newMaterial )
+{
+	AssertPtr( newMaterial );
+	this->material = checked_cast< NullMaterial*, rxMaterial* >( newMaterial );
+}
+
+void NullModel::SetGeometry( const rxDynMeshData* newMesh )
+{
+	if( ! (this->flags & EModelFlags::MF_DynamicGeometry) ) {
+		DEBUG_CODE( sys::Warning("attempted to modify geometry of a static mesh") );
+		return;
+	}
+
+	this->batch.IndexCount	= newMesh->numIndices;
+	this->batch.VertexCount	= newMesh->numVertices;
+}
+
+bool NullModel::IsOk() const
+{
+	return ( this->vertexData != null );
+}
+
+const Vec3D & NullModel::GetOrigin() const {
+	return this->worldTransform.GetTranslation();
+}
+
+/*================================
+		NullParallelLight
+================================*/
+
+NullParallelLight::NullParallelLight( const Vec3D& direction, const rxLightDescription& desc )
+{
+	rxLight::Init( desc );
+
+	this->direction = direction;
+	this->color = desc.color;
+}
+
+NullParallelLight::~NullParallelLight()
+{}
+
+void NullParallelLight::Render( const rxView& view, rxQueue& queue )
+{
+	if( this->IsEnabled() ) {
+		ToNullQueue( queue ).globalLights.Append( this );
+	}
+}
+
+void NullParallelLight::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullParallelLight::SetColor( const ColorRGB& newDiffuseColor )
+{
+	this->color = newDiffuseColor;
+}
+
+const Vec3D & NullParallelLight::GetDirection() const
+{
+	return this->direction;
+}
+
+void NullParallelLight::SetDirection( const Vec3D& newDir )
+{
+	this->direction = newDir;
+}
+
+/*================================
+		NullPointLight
+================================*/
+
+NullPointLight::NullPointLight( const Vec3D& center, FLOAT radius, const rxLightDescription& desc )
+{
+	rxLight::Init( desc );
+
+	this->position = center;
+	this->range = radius;
+	this->color = desc.color;
+}
+
+NullPointLight::~NullPointLight()
+{}
+
+void NullPointLight::Render( const rxView& view, rxQueue& queue )
+{
+	if( this->IsEnabled() ) {
+		ToNullQueue( queue ).localLights.Append( this );
+	}
+}
+
+void NullPointLight::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullPointLight::SetColor( const ColorRGB& newDiffuseColor )
+{
+	this->color = newDiffuseColor;
+}
+
+const Vec3D & NullPointLight::GetOrigin() const
+{
+	return this->position;
+}
+
+void NullPointLight::SetOrigin( const Vec3D& newOrigin )
+{
+	this->position = newOrigin;
+}
+
+FLOAT NullPointLight::GetRange() const
+{
+	return this->range;
+}
+
+void NullPointLight::SetRange( FLOAT newRange )
+{
+	this->range = newRange;
+}
+
+void NullPointLight::AddToClusters( const NullView& view, rxLightClusters & clusters ) const
+{
+	Vec3D  viewPosition( this->position );
+	view.ViewMatrix.TransformVector( viewPosition );
+
+	clusters.AddPointLight( viewPosition, this->range );
+}
+
+/*================================
+		NullSpotLight
+================================*/
+
+NullSpotLight::NullSpotLight( const Vec3D& center, const Vec3D& direction, FLOAT range,
+							 FLOAT innerAngle, FLOAT outerAngle, const rxLightDescription& desc )
+{
+	rxLight::Init( desc );
+
+	this->position	= center;
+	this->direction	= direction;
+	this->range		= range;
+	this->cosTheta	= mxMath::Cos( innerAngle * 0.5f );
+	this->cosPhi	= mxMath::Cos( outerAngle * 0.5f );
+	this->color		= desc.color;
+}
+
+NullSpotLight::~NullSpotLight()
+{}
+
+void NullSpotLight::Render( const rxView& view, rxQueue& queue )
+{
+	if( this->IsEnabled() ) {
+		ToNullQueue( queue ).localLights.Append( this );
+	}
+}
+
+void NullSpotLight::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullSpotLight::SetColor( const ColorRGB& newDiffuseColor )
+{
+	this->color = newDiffuseColor;
+}
+
+const Vec3D & NullSpotLight::GetOrigin() const
+{
+	return this->position;
+}
+
+void NullSpotLight::SetOrigin( const Vec3D& newOrigin )
+{
+	this->position = newOrigin;
+}
+
+FLOAT NullSpotLight::GetRange() const
+{
+	return this->range;
+}
+
+void NullSpotLight::SetRange( FLOAT newRange )
+{
+	this->range = newRange;
+}
+
+void NullSpotLight::SetInnerConeAngle( FLOAT theta )
+{
+	this->cosTheta = mxMath::Cos( theta * 0.5f );
+}
+
+void NullSpotLight::SetOuterConeAngle( FLOAT phi )
+{
+	this->cosPhi = mxMath::Cos( phi * 0.5f );
+}
+
+const Vec3D & NullSpotLight::GetDirection() const
+{
+	return this->direction;
+}
+
+void NullSpotLight::SetDirection( const Vec3D& newDir )
+{
+	this->direction = newDir;
+}
+
+void NullSpotLight::SetProjector( rxTexture* texture )
+{
+	this->projector = texture;
+}
+
+void NullSpotLight::AddToClusters( const NullView& view, rxLightClusters & clusters ) const
+{
+	Vec3D  viewPosition( this->position );
+	view.ViewMatrix.TransformVector( viewPosition );
+
+	Vec3D  viewDirection( this->direction );
+	view.ViewMatrix.TransformNormal( viewDirection );
+
+	clusters.AddSpotLight( viewPosition, viewDirection, this->range, this->cosPhi );
+}
+
+/*================================
+		NullBillboard
+================================*/
+
+NullBillboard::NullBillboard( rxTexture* texture, const Vec3D& origin, const Vec2D& size, const ColorRGB& color )
+	: texture( texture )
+	, origin( origin )
+	, size( size )
+	, color( color )
+{}
+
+NullBillboard::~NullBillboard()
+{}
+
+void NullBillboard::Render( const rxView& view, rxQueue& queue )
+{
+	NullRenderQueue & renderQueue = ToNullQueue( queue );
+	renderQueue.translucent.Append( this );
+
+	const FLOAT  depth = GetProjectedDepth( this->origin, ToNullView( view ) );
+
+	renderQueue.AddTranslucentDraw( renderQueue.translucent.Num() - 1, depth );
+}
+
+void NullBillboard::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullBillboard::SetColor( const ColorRGB& newColor )
+{
+	this->color = newColor;
+}
+
+void NullBillboard::SetTexture( rxTexture* newTexture )
+{
+	this->texture = newTexture;
+}
+
+void NullBillboard::SetOrigin( const Vec3D& newOrigin )
+{
+	this->origin = newOrigin;
+}
+
+void NullBillboard::SetSize( const Vec2D& newSize )
+{
+	this->size = newSize;
+}
+
+/*================================
+			NullSky
+================================*/
+
+NullSky::NullSky( rxTexture* sides[AABB::NUM_SIDES] )
+	: orientation( _InitIdentity )
+{
+	SetTextures( sides );
+}
+
+NullSky::~NullSky()
+{}
+
+void NullSky::Render( const rxView& view, rxQueue& queue )
+{
+	ToNullQueue( queue ).skies.Append( this );
+}
+
+void NullSky::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullSky::SetOrientation( const Quat& newOrientation )
+{
+	this->orientation = newOrientation;
+}
+
+void NullSky::SetTextures( rxTexture* sides[AABB::NUM_SIDES] )
+{
+	for( UINT iSide = 0; iSide < AABB::NUM_SIDES; iSide++ )
+	{
+		this->textures[iSide] = sides[iSide];
+	}
+}
+
+/*================================
+			NullPortal
+================================*/
+
+NullPortal::NullPortal( FLOAT width, FLOAT height )
+	: worldTransform( _InitIdentity )
+	, lookAt( Vec3D::UNIT_Z )
+{
+	SetSize( width, height );
+}
+
+NullPortal::~NullPortal()
+{}
+
+void NullPortal::Render( const rxView& view, rxQueue& queue )
+{
+	ToNullQueue( queue ).portals.Append( this );
+}
+
+void NullPortal::Remove()
+{
+	nullrx::scene->RemoveEntity( this );
+}
+
+void NullPortal::SetLookAt( const Vec3D& lookAt )
+{
+	Assert( lookAt.IsNormalized() );
+	this->lookAt = lookAt;
+}
+
+void NullPortal::SetWorldTransform( const Matrix4& localToWorld )
+{
+	this->worldTransform = localToWorld;
+}
+
+void NullPortal::SetSize( FLOAT width, FLOAT height )
+{
+	Assert( IsInRange( width, 0.0f, MAX_PORTAL_SIZE ) && IsInRange( height, 0.0f, MAX_PORTAL_SIZE ) );
+
+	this->width = Clamp( width, 1.0f, MAX_PORTAL_SIZE );
+	this->height = Clamp( height, 1.0f, MAX_PORTAL_SIZE );
+}
+
+void NullPortal::SetBuddy( rxPortal* other )
+{
+	this->buddy = checked_cast< NullPortal*, rxPortal* >( other );
+}
+
+rxPortal * NullPortal::GetBuddy()
+{
+	return this->buddy;
+}
+
+/*================================
+		NullPostEffect
+================================*/
+
+NullPostEffect::NullPostEffect( EPostFx theType )
+	: rxPostEffect( theType )
+{}
+
+NullPostEffect::~NullPostEffect()
+{}
+
+void NullPostEffect::Remove()
+{
+	nullrx::scene->GetPostEffects().RemoveEffect( this );
+}
+
+/*================================
+		NullPostEffectManager
+================================*/
+
+NullPostEffectManager::NullPostEffectManager()
+{}
+
+NullPostEffectManager::~NullPostEffectManager()
+{
+	Shutdown();
+}
+
+void NullPostEffectManager::Shutdown()
+{
+	this->effects.DeleteContents( true );
+}
+
+void NullPostEffectManager::RemoveEffect( NullPostEffect* theEffect )
+{
+	RemoveAndDelete( this->effects, theEffect );
+}
+
+UINT NullPostEffectManager::NumEnabledEffects() const
+{
+	UINT  numEnabled = 0;
+	for( UINT iEffect = 0; iEffect < this->effects.Num(); iEffect++ )
+	{
+		if( this->effects[ iEffect ]->IsEnabled() ) {
+			numEnabled++;
+		}
+	}
+	return numEnabled;
+}
+
+void NullPostEffectManager::ToggleAllEffects( bool bEnable )
+{
+	for( UINT iEffect = 0; iEffect < this->effects.Num(); iEffect++ )
+	{
+		this->effects[ iEffect ]->SetEnabled( bEnable );
+	}
+}
+
+rxPostEffect * NullPostEffectManager::AddEffect( EPostFx type )
+{
+	NullPostEffect * pNewEffect = MX_NEW NullPostEffect( type );
+	this->effects.Append( pNewEffect );
+	return pNewEffect;
+}
+
+rxPostEffect * NullPostEffectManager::AddColoring()			{ return AddEffect( PostFx_Coloring ); }
+rxPostEffect * NullPostEffectManager::AddGrayScale()		{ return AddEffect( PostFx_GrayScale ); }
+rxPostEffect * NullPostEffectManager::AddBlackAndWhite()	{ return AddEffect( PostFx_BlackAndWhite ); }
+rxPostEffect * NullPostEffectManager::AddInvertColor()		{ return AddEffect( PostFx_InvertColor ); }
+rxPostEffect * NullPostEffectManager::AddEmboss()			{ return AddEffect( PostFx_Emboss ); }
+rxPostEffect * NullPostEffectManager::AddSharpen()			{ return AddEffect( PostFx_Sharpen ); }
+rxPostEffect * NullPostEffectManager::AddSepia()			{ return AddEffect( PostFx_Sepia ); }
+rxPostEffect * NullPostEffectManager::AddCellShading()		{ return AddEffect( PostFx_CellShading ); }
+rxPostEffect * NullPostEffectManager::AddModulatingWave()	{ return AddEffect( PostFx_ModulatingWave ); }
+rxPostEffect * NullPostEffectManager::AddBlur()				{ return AddEffect( PostFx_Blur ); }
+rxPostEffect * NullPostEffectManager::AddGBlur()			{ return AddEffect( PostFx_GBlur ); }
+rxPostEffect * NullPostEffectManager::AddBloom()			{ return AddEffect( PostFx_Bloom ); }
+rxPostEffect * NullPostEffectManager::AddDepthOfField()		{ return AddEffect( PostFx_DoF ); }
+rxPostEffect * NullPostEffectManager::AddMotionBlur()		{ return AddEffect( PostFx_MotionBlur ); }
+rxPostEffect * NullPostEffectManager::AddRadialBlur()		{ return AddEffect( PostFx_RadialBlur ); }
+rxPostEffect * NullPostEffectManager::AddHDR()				{ return AddEffect( PostFx_HDR ); }
+rxPostEffect * NullPostEffectManager::AddSSAO()				{ return AddEffect( PostFx_SSAO ); }
+
+/*================================
+			NullScene
+================================*/
+
+NullScene::NullScene()
+	: ambientColor( FColor::BLACK )
+{}
+
+NullScene::~NullScene()
+{
+	Shutdown();
+}
+
+void NullScene::Initialize()
+{
+	this->lightClusters.Setup();
+}
+
+void NullScene::Shutdown()
+{
+	this->spatialHash = null;
+
+	this->renderQueue.Clear();
+	this->visibleSet.Empty();
+	this->chunkQueues.DeleteContents( true );
+	this->instanceBatcher.Clear();
+	this->lightClusters.Clear();
+
+	this->postEffects.Shutdown();
+
+	this->allModels			.DeleteContents( true );
+	this->allParallelLights	.DeleteContents( true );
+	this->allPointLights	.DeleteContents( true );
+	this->allSpotLights		.DeleteContents( true );
+	this->allBillboards		.DeleteContents( true );
+	this->allSkies			.DeleteContents( true );
+	this->allPortals		.DeleteContents( true );
+}
+
+void NullScene::BuildRenderQueue( const mxSceneView& view,
+		NullView &OutFullView, mxVisibleSet &OutVisibleSet, NullRenderQueue &OutQueue )
+{
+	OutFullView.Refresh( view );
+
+	// Find visible objects.
+	{
+		MX_PROFILE( "Get visible set" );
+		NullStatCounter  cullTime( nullrx::stats.Cpu_cull_time_milliseconds );
+		OutVisibleSet.Empty();
+		this->spatialHash->GetVisibleSet( view, OutVisibleSet );
+	}
+
+	// Render the visible set. Generate a render queue from the visible set.
+	rxRecordRenderQueue( OutFullView, OutVisibleSet, this->chunkQueues, OutQueue );
+}
+
+//
+//	NullScene::DrawScene
+//
+void NullScene::DrawScene( const mxSceneView& view, mxScene* scene )
+{
+	AssertPtr( scene );
+	this->spatialHash = & scene->GetSpatialDatabase();
+
+	this->BuildRenderQueue( view, this->cachedView, this->visibleSet, this->renderQueue );
+
+	nullrx::stats.numEntities = this->renderQueue.Num();
+
+	{
+		MX_PROFILE( "Replay render stages" );
+
+		this->ReplayGeometryStage( this->cachedView, this->renderQueue );
+		this->ReplayLightingStage( this->cachedView, this->renderQueue );
+
+		// skies
+		nullrx::stats.numBatches += this->renderQueue.skies.Num();
+
+		this->ReplayAlphaStage( this->cachedView, this->renderQueue );
+
+		// full-screen post-processing passes
+		nullrx::stats.numBatches += this->postEffects.NumEnabledEffects();
+	}
+
+	this->renderQueue.Clear();
+
+	this->spatialHash = null;
+}
+
+//
+//	NullScene::ReplayGeometryStage - mirrors filling the G-buffer.
+//
+void NullScene::ReplayGeometryStage( const NullView& view, NullRenderQueue& renderQueue )
+{
+	// Group solid objects with the same geometry and material.
+	rxBatchOpaqueDraws( renderQueue, this->instanceBatcher );
+
+	rxGroupDrawState  drawState( nullrx::stats );
+
+	for ( UINT iGroup = 0; iGroup < this->instanceBatcher.NumGroups(); iGroup++ )
+	{
+		const rxInstanceBatcher::Group & group = this->instanceBatcher.GetGroup( iGroup );
+
+		// all models in the group have the same geometry and material
+		const NullModel * model = renderQueue.models[ this->instanceBatcher.GetInstanceIndices()[ group.firstInstance ] ];
+
+		drawState.BeginGroup( group );
+
+		nullrx::stats.numTriangles += ( model->batch.IndexCount / 3 ) * group.numInstances;
+	}
+}
+
+//
+//	NullScene::ReplayLightingStage - mirrors deferred lighting.
+//
+void NullScene::ReplayLightingStage( const NullView& view, NullRenderQueue& renderQueue )
+{
+	// ambient light
+	nullrx::stats.numBatches++;
+
+	// full-screen passes for global lights
+	nullrx::stats.numBatches += renderQueue.globalLights.Num();
+	nullrx::stats.numLightsDrawn += renderQueue.globalLights.Num();
+
+#if RX_LIGHT_CLUSTERS
+	// Assign local lights to clusters.
+	{
+		this->lightClusters.SetProjection( view.ProjectionMatrix );
+		this->lightClusters.Clear();
+
+		for ( UINT iLight = 0; iLight < renderQueue.localLights.Num(); iLight++ )
+		{
+			renderQueue.localLights[ iLight ]->AddToClusters( view, this->lightClusters );
+		}
+
+		this->lightClusters.Build();
+
+	#if RX_DEBUG_LIGHT_CLUSTERS
+		Assert( this->lightClusters.CheckAgainstReference() );
+	#endif
+
+		nullrx::stats.numClusterLightIndices = this->lightClusters.NumLightIndices();
+	}
+#endif
+
+	// light shapes for local lights
+	nullrx::stats.numBatches += renderQueue.localLights.Num();
+	nullrx::stats.numLightsDrawn += renderQueue.localLights.Num();
+}
+
+//
+//	NullScene::ReplayAlphaStage - mirrors drawing translucent objects.
+//
+void NullScene::ReplayAlphaStage( const NullView& view, NullRenderQueue& renderQueue )
+{
+	const rxTexture * currentTexture = null;
+
+	for ( UINT iDraw = 0; iDraw < renderQueue.translucentDraws.Num(); iDraw++ )
+	{
+		const NullBillboard * billboard = renderQueue.translucent[ renderQueue.translucentDraws[ iDraw ].index ];
+
+		if ( billboard->texture != currentTexture )
+		{
+			currentTexture = billboard->texture;
+			nullrx::stats.numMaterialChanges++;
+		}
+		else
+		{
+			nullrx::stats.numStateChangesAvoided++;
+		}
+
+		nullrx::stats.numBatches++;
+		nullrx::stats.numTriangles += 2;
+	}
+}
+
+rxModel * NullScene::CreateModel( const rxModelDescription& desc )
+{
+	NullModel * newRenderModel = MX_NEW NullModel();
+	newRenderModel->Setup( desc );
+	this->allModels.Append( newRenderModel );
+	return newRenderModel;
+}
+
+rxParallelLight * NullScene::CreateParallelLight( const Vec3D& direction,
+											   const rxLightDescription& desc )
+{
+	NullParallelLight * newLight = MX_NEW NullParallelLight( direction, desc );
+	this->allParallelLights.Append( newLight );
+	return newLight;
+}
+
+rxPointLight * NullScene::CreatePointLight( const Vec3D& center, FLOAT radius,
+										 const rxLightDescription& desc )
+{
+	NullPointLight * newLight = MX_NEW NullPointLight( center, radius, desc );
+	this->allPointLights.Append( newLight );
+	return newLight;
+}
+
+rxSpotLight * NullScene::CreateSpotLight( const Vec3D& center, const Vec3D& direction, FLOAT range,
+										FLOAT innerAngle, FLOAT outerAngle,
+										const rxLightDescription& desc )
+{
+	NullSpotLight * newLight = MX_NEW NullSpotLight( center, direction, range, innerAngle, outerAngle, desc );
+	this->allSpotLights.Append( newLight );
+	return newLight;
+}
+
+void NullScene::SetAmbientLightColor( const FColor& ambientColor )
+{
+	this->ambientColor = ambientColor;
+}
+
+const FColor & NullScene::GetAmbientLightColor() const
+{
+	return this->ambientColor;
+}
+
+rxBillboard * NullScene::CreateBillboard( rxTexture* texture, const Vec3D& origin,
+				const Vec2D& size, const ColorRGB& color )
+{
+	NullBillboard * pNewBillboard = MX_NEW NullBillboard( texture, origin, size, color );
+	this->allBillboards.Append( pNewBillboard );
+	return pNewBillboard;
+}
+
+rxSky * NullScene::CreateSkybox( rxTexture* sides[AABB::NUM_SIDES] )
+{
+	NullSky * skyBox = MX_NEW NullSky( sides );
+	this->allSkies.Append( skyBox );
+	return skyBox;
+}
+
+rxPortal * NullScene::CreatePortal( FLOAT width, FLOAT height )
+{
+	NullPortal * portal = MX_NEW NullPortal( width, height );
+	this->allPortals.Append( portal );
+	return portal;
+}
+
+rxPostEffectManager* NullScene::GetPostEffectManager()
+{
+	return &this->postEffects;
+}
+
+void NullScene::RemoveEntity( NullModel* theModel )
+{
+	RemoveAndDelete( this->allModels, theModel );
+}
+
+void NullScene::RemoveEntity( NullParallelLight* theLight )
+{
+	RemoveAndDelete( this->allParallelLights, theLight );
+}
+
+void NullScene::RemoveEntity( NullPointLight* theLight )
+{
+	RemoveAndDelete( this->allPointLights, theLight );
+}
+
+void NullScene::RemoveEntity( NullSpotLight* theLight )
+{
+	RemoveAndDelete( this->allSpotLights, theLight );
+}
+
+void NullScene::RemoveEntity( NullBillboard* theBillboard )
+{
+	RemoveAndDelete( this->allBillboards, theBillboard );
+}
+
+void NullScene::RemoveEntity( NullSky* theSky )
+{
+	RemoveAndDelete( this->allSkies, theSky );
+}
+
+void NullScene::RemoveEntity( NullPortal* thePortal )
+{
+	RemoveAndDelete( this->allPortals, thePortal );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
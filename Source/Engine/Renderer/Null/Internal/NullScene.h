@@ -0,0 +1,583 @@
+/*
+=============================================================================
+	File:	NullScene.h
+	Desc:	Graphics scene of the null render system.
+=============================================================================
+*/
+
+#ifndef __MX_NULL_SCENE_H__
+#define __MX_NULL_SCENE_H__
+
+namespace abc {
+
+// Forward declarations.
+class NullModel;
+class NullBillboard;
+class NullSky;
+class NullPortal;
+class NullParallelLight;
+struct NullLocalLight;
+
+/*
+======================================================================
+
+		View.
+
+======================================================================
+*/
+
+//
+//	NullView
+//
+struct NullView : public rxView
+{
+public:
+	Matrix4		ViewMatrix;
+	Matrix4		ProjectionMatrix;
+	Matrix4		ViewProjMatrix;
+
+public:
+	NullView()
+	{
+		ViewMatrix = ProjectionMatrix = ViewProjMatrix = Matrix4::mat4_identity;
+	}
+
+	// Refresh - must be called after changing the render view.
+	void Refresh( const mxSceneView& view )
+	{
+		ViewMatrix			= view.GetViewMatrix();
+		ProjectionMatrix	= view.GetProjectionMatrix();
+		ViewProjMatrix		= ViewMatrix * ProjectionMatrix;
+	}
+};
+
+FORCEINLINE
+const NullView & ToNullView( const rxView& theView )
+{
+	return *checked_cast< const NullView*, const rxView* >( &theView );
+}
+
+/*
+======================================================================
+
+		Render queue.
+
+======================================================================
+*/
+
+//
+//	NullRenderQueue - collection of objects that can be rendered.
+//
+//	Unlike the hardware render queues this one is not limited in size.
+//
+struct NullRenderQueue : public rxRenderQueue {
+public:
+	TArray< NullModel* >			models;
+	TArray< NullBillboard* >		translucent;
+	TArray< NullParallelLight* >	globalLights;
+	TArray< NullLocalLight* >		localLights;
+	TArray< NullPortal* >			portals;
+	TArray< NullSky* >				skies;
+
+public:
+				NullRenderQueue();
+				~NullRenderQueue();
+
+	// Returns the total number of objects in this render queue.
+	SizeT Num() const
+	{
+		return models.Num()
+			+ translucent.Num()
+			+ globalLights.Num() + localLights.Num()
+			+ portals.Num()
+			+ skies.Num();
+	}
+
+	// Empties the internal lists of objects, doesn't free memory.
+	void Clear();
+
+	// Appends the objects and draws of another queue (e.g. recorded on another thread).
+	void Append( const NullRenderQueue& other );
+};
+
+FORCEINLINE
+NullRenderQueue & ToNullQueue( rxQueue& theQueue )
+{
+	return *checked_cast< NullRenderQueue*, rxQueue* >( &theQueue );
+}
+
+/*
+======================================================================
+
+		Mesh drawing.
+
+======================================================================
+*/
+
+//
+//	NullModel
+//
+class NullModel : public rxModel {
+public:
+			NullModel();
+			~NullModel();
+
+	void	Setup( const rxModelDescription& desc );
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxModel ) :
+	//
+	void	SetTransform( const Matrix4& newWorldTransform );
+	void	SetMaterial( rxMaterial* newMaterial );
+	void	SetGeometry( const rxDynMeshData* newMesh );
+	bool	IsOk() const;
+
+public:
+	const Vec3D & GetOrigin() const;
+
+	// Adds a draw of this model to the batcher (see rxBatchOpaqueDraws()).
+	void	AddToBatch( rxInstanceBatcher& batcher, const rxMaterial* material,
+				const Matrix4& transform, UINT32 userIndex ) const;
+
+public:
+	Matrix4			worldTransform;
+
+	// Identify the geometry for grouping instances:
+	// static models created from the same mesh data share these,
+	// models with dynamic geometry point to themselves.
+	const void *	vertexData;
+	const void *	indexData;
+
+	rxBatch			batch;
+
+	TPtr< NullMaterial >	material;
+
+	FLOAT		depth;	// for sorting primitives by depth
+};
+
+/*
+======================================================================
+
+		Scene lighting.
+
+======================================================================
+*/
+
+//
+//	NullParallelLight
+//
+class NullParallelLight : public rxParallelLight {
+public:
+			NullParallelLight( const Vec3D& direction, const rxLightDescription& desc );
+			~NullParallelLight();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxLight ) :
+	//
+	void	SetColor( const ColorRGB& newDiffuseColor );
+
+	//
+	//	Override ( rxParallelLight ) :
+	//
+	const Vec3D &	GetDirection() const;
+	void			SetDirection( const Vec3D& newDir );
+
+public:
+	Vec3D		direction;
+	ColorRGB	color;
+};
+
+//
+//	NullLocalLight - base class for lights affecting a limited region of space.
+//
+struct NullLocalLight {
+public:
+	// Adds this light to the cluster grid.
+	virtual void	AddToClusters( const NullView& view, rxLightClusters & clusters ) const = 0;
+
+	virtual ~NullLocalLight() {}
+};
+
+//
+//	NullPointLight
+//
+class NullPointLight : public rxPointLight, public NullLocalLight {
+public:
+			NullPointLight( const Vec3D& center, FLOAT radius, const rxLightDescription& desc );
+			~NullPointLight();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxLight ) :
+	//
+	void	SetColor( const ColorRGB& newDiffuseColor );
+
+	//
+	//	Override ( rxPointLight ) :
+	//
+	const Vec3D &	GetOrigin() const;
+	void			SetOrigin( const Vec3D& newOrigin );
+
+	FLOAT			GetRange() const;
+	void			SetRange( FLOAT newRange );
+
+	//
+	//	Override ( NullLocalLight ) :
+	//
+	void	AddToClusters( const NullView& view, rxLightClusters & clusters ) const;
+
+public:
+	Vec3D		position;
+	FLOAT		range;
+	ColorRGB	color;
+};
+
+//
+//	NullSpotLight
+//
+class NullSpotLight : public rxSpotLight, public NullLocalLight {
+public:
+			NullSpotLight( const Vec3D& center, const Vec3D& direction, FLOAT range,
+							FLOAT innerAngle, FLOAT outerAngle, const rxLightDescription& desc );
+			~NullSpotLight();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxLight ) :
+	//
+	void	SetColor( const ColorRGB& newDiffuseColor );
+
+	//
+	//	Override ( rxPointLight ) :
+	//
+	const Vec3D &	GetOrigin() const;
+	void			SetOrigin( const Vec3D& newOrigin );
+
+	FLOAT			GetRange() const;
+	void			SetRange( FLOAT newRange );
+
+	//
+	//	Override ( rxSpotLight ) :
+	//
+	void	SetInnerConeAngle( FLOAT theta );
+	void	SetOuterConeAngle( FLOAT phi );
+
+	const Vec3D &	GetDirection() const;
+	void			SetDirection( const Vec3D& newDir );
+
+	void	SetProjector( rxTexture* texture );
+
+	//
+	//	Override ( NullLocalLight ) :
+	//
+	void	AddToClusters( const NullView& view, rxLightClusters & clusters ) const;
+
+public:
+	Vec3D		position;
+	Vec3D		direction;
+	FLOAT		range;
+	FLOAT		cosTheta;	// cosine of half inner cone angle
+	FLOAT		cosPhi;		// cosine of half outer cone angle
+	ColorRGB	color;
+
+	TPtr< rxTexture >	projector;
+};
+
+/*
+======================================================================
+
+		Miscellaneous entities.
+
+======================================================================
+*/
+
+//
+//	NullBillboard
+//
+class NullBillboard : public rxBillboard {
+public:
+			NullBillboard( rxTexture* texture, const Vec3D& origin, const Vec2D& size, const ColorRGB& color );
+			~NullBillboard();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxBillboard ) :
+	//
+	void	SetColor( const ColorRGB& newColor );
+	void	SetTexture( rxTexture* newTexture );
+	void	SetOrigin( const Vec3D& newOrigin );
+	void	SetSize( const Vec2D& newSize );
+
+public:
+	TPtr< rxTexture >	texture;
+	Vec3D				origin;
+	Vec2D				size;
+	ColorRGB			color;
+};
+
+//
+//	NullSky
+//
+class NullSky : public rxSky {
+public:
+			NullSky( rxTexture* sides[AABB::NUM_SIDES] );
+			~NullSky();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxSky ) :
+	//
+	void	SetOrientation( const Quat& newOrientation );
+	void	SetTextures( rxTexture* sides[AABB::NUM_SIDES] );
+
+public:
+	Quat				orientation;
+	TPtr< rxTexture >	textures[ AABB::NUM_SIDES ];
+};
+
+//
+//	NullPortal
+//
+class NullPortal : public rxPortal {
+public:
+			NullPortal( FLOAT width, FLOAT height );
+			~NullPortal();
+
+	//
+	//	Override ( rxDrawEntity ) :
+	//
+	void	Render( const rxView& view, rxQueue& queue );
+	void	Remove();
+
+	//
+	//	Override ( rxPortal ) :
+	//
+	void	SetLookAt( const Vec3D& lookAt );
+	void	SetWorldTransform( const Matrix4& localToWorld );
+	void	SetSize( FLOAT width, FLOAT height );
+
+	void		SetBuddy( rxPortal* other );
+	rxPortal *	GetBuddy();
+
+public:
+	Matrix4		worldTransform;
+	Vec3D		lookAt;
+	FLOAT		width, height;
+
+	TPtr< NullPortal >	buddy;
+};
+
+/*
+======================================================================
+
+		Post-processing.
+
+======================================================================
+*/
+
+//
+//	NullPostEffect
+//
+class NullPostEffect : public rxPostEffect {
+public:
+			NullPostEffect( EPostFx theType );
+			~NullPostEffect();
+
+	//
+	//	Override ( rxPostEffect ) :
+	//
+	void	Remove();
+};
+
+//
+//	NullPostEffectManager
+//
+class NullPostEffectManager : public rxPostEffectManager {
+public:
+			NullPostEffectManager();
+			~NullPostEffectManager();
+
+	void	Shutdown();
+
+	void	RemoveEffect( NullPostEffect* theEffect );
+
+	// Returns the number of full-screen passes that would be drawn.
+	UINT	NumEnabledEffects() const;
+
+	//
+	//	Override ( rxPostEffectManager ) :
+	//
+	void	ToggleAllEffects( bool bEnable );
+
+	rxPostEffect *	AddColoring();
+	rxPostEffect *	AddGrayScale();
+	rxPostEffect *	AddBlackAndWhite();
+	rxPostEffect *	AddInvertColor();
+	rxPostEffect *	AddEmboss();
+	rxPostEffect *	AddSharpen();
+	rxPostEffect *	AddSepia();
+	rxPostEffect *	AddCellShading();
+	rxPostEffect *	AddModulatingWave();
+
+	rxPostEffect *	AddBlur();
+	rxPostEffect *	AddGBlur();
+
+	rxPostEffect *	AddBloom();
+	rxPostEffect *	AddDepthOfField();
+
+	rxPostEffect *	AddMotionBlur();
+	rxPostEffect *	AddRadialBlur();
+
+	rxPostEffect *	AddHDR();
+	rxPostEffect *	AddSSAO();
+
+private:
+	rxPostEffect *	AddEffect( EPostFx type );
+
+private:
+	TArray< NullPostEffect* >	effects;
+};
+
+/*
+======================================================================
+
+		Graphics scene.
+
+======================================================================
+*/
+
+//
+//	NullScene
+//
+//	Performs the same CPU-side work as the hardware scene renderers
+//	(culling, building and sorting the render queue, grouping instances, assigning lights to clusters)
+//	and counts draw calls and state changes instead of issuing them.
+//	Shadow map passes are not simulated.
+//
+class NullScene : public rxScene {
+public:
+			NullScene();
+			~NullScene();
+
+	void	Initialize();
+	void	Shutdown();
+
+	void	DrawScene( const mxSceneView& view, mxScene* scene );
+
+	//
+	//	Override ( rxScene ) :
+	//
+	rxModel *			CreateModel( const rxModelDescription& desc );
+
+	rxParallelLight *	CreateParallelLight( const Vec3D& direction,
+											const rxLightDescription& desc = rxLightDescription() );
+
+	rxPointLight *		CreatePointLight( const Vec3D& center, FLOAT radius,
+											const rxLightDescription& desc = rxLightDescription() );
+
+	rxSpotLight *		CreateSpotLight(
+											const Vec3D& center, const Vec3D& direction, FLOAT range,
+											FLOAT innerAngle, FLOAT outerAngle,
+											const rxLightDescription& desc = rxLightDescription() );
+
+	void				SetAmbientLightColor( const FColor& ambientColor );
+	const FColor &		GetAmbientLightColor() const;
+
+	rxBillboard *		CreateBillboard( rxTexture* texture, const Vec3D& origin,
+											const Vec2D& size, const ColorRGB& color = FColor::WHITE );
+
+	rxSky *				CreateSkybox( rxTexture* sides[AABB::NUM_SIDES] );
+
+	rxPortal *			CreatePortal( FLOAT width, FLOAT height );
+
+	rxPostEffectManager *	GetPostEffectManager();
+
+public:
+	// These are called when render entities are removed from the scene.
+	void	RemoveEntity( NullModel* theModel );
+	void	RemoveEntity( NullParallelLight* theLight );
+	void	RemoveEntity( NullPointLight* theLight );
+	void	RemoveEntity( NullSpotLight* theLight );
+	void	RemoveEntity( NullBillboard* theBillboard );
+	void	RemoveEntity( NullSky* theSky );
+	void	RemoveEntity( NullPortal* thePortal );
+
+	NullPostEffectManager &	GetPostEffects();
+
+private:
+	void	BuildRenderQueue( const mxSceneView& view,
+				NullView &OutFullView, mxVisibleSet &OutVisibleSet, NullRenderQueue &OutQueue );
+
+	// These count the draw calls that would be issued by the corresponding render stages.
+	void	ReplayGeometryStage( const NullView& view, NullRenderQueue& renderQueue );
+	void	ReplayLightingStage( const NullView& view, NullRenderQueue& renderQueue );
+	void	ReplayAlphaStage( const NullView& view, NullRenderQueue& renderQueue );
+
+private:
+	TPtr< mxSpatialDatabase >	spatialHash;
+
+	NullView			cachedView;
+	mxVisibleSet		visibleSet;
+	NullRenderQueue		renderQueue;
+
+	TArray< NullRenderQueue* >	chunkQueues;	// used for recording parts of the visible set on worker threads
+
+	rxInstanceBatcher	instanceBatcher;
+	rxLightClusters		lightClusters;
+
+	FColor				ambientColor;
+
+	NullPostEffectManager	postEffects;
+
+	TArray< NullModel* >			allModels;
+	TArray< NullParallelLight* >	allParallelLights;
+	TArray< NullPointLight* >		allPointLights;
+	TArray< NullSpotLight* >		allSpotLights;
+	TArray< NullBillboard* >		allBillboards;
+	TArray< NullSky* >				allSkies;
+	TArray< NullPortal* >			allPortals;
+};
+
+FORCEINLINE NullPostEffectManager & NullScene::GetPostEffects() {
+	return this->postEffects;
+}
+
+}//End of namespace abc
+
+#endif // !__MX_NULL_SCENE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,115 @@
+/*
+=============================================================================
+	File:	NullRenderSystem.h
+	Desc:	Null render system includes.
+=============================================================================
+*/
+
+#ifndef __MX_NULL_RENDER_SYSTEM_H__
+#define __MX_NULL_RENDER_SYSTEM_H__
+
+//
+//	The null render system doesn't use any graphics API.
+//	It performs all the CPU-side work of the real renderer (culling, building and sorting render queues,
+//	grouping instances, assigning lights to clusters) and counts draw calls and state changes
+//	which would be issued to the GPU.
+//	It is used for benchmarking the CPU side of the pipeline and for running the engine headless:
+//	the system doesn't create a window for EDriverType::GAPI_None
+//	(see 'Benchmarks RenderNull', mxSystemSettings::numFramesToRun stops the main loop).
+//
+
+//------------------------------------------------------------------------
+//	Declarations
+//------------------------------------------------------------------------
+
+namespace abc {
+
+// Forward declarations.
+class NullRenderer;
+class NullResources;
+class NullScene;
+
+//
+//	NullStatCounter - adds the time spent in the current scope to the given counter.
+//
+struct NullStatCounter
+{
+	mxUInt &	timeCounter;
+	mxUInt		startTime;
+
+	NullStatCounter( mxUInt& theCounter )
+		: timeCounter( theCounter )
+		, startTime( sys::GetClockTicks() )
+	{}
+
+	~NullStatCounter()
+	{
+		mxUInt currTime = sys::GetClockTicks();
+		timeCounter += currTime - startTime;
+	}
+};
+
+//
+//	NullStats - performance counters.
+//
+struct NullStats : public rxStatistics
+{
+	mxUInt	numTriangles;	// number of triangles that would be rendered in the last frame
+
+	mxUInt	numLightsDrawn;	// number of light sources that would be applied in the last frame
+
+	mxUInt	numClusterLightIndices;	// number of light indices in the light cluster grid (zero unless RX_LIGHT_CLUSTERS is enabled)
+
+public:
+	NullStats()
+	{
+		// Initialize performance counters for the first time.
+		Reset();
+	}
+
+	// This function should be called at the beginning (or end) of each frame.
+	void Reset()
+	{
+		MemZero( this, sizeof(*this) );
+		rxStatistics::Reset();
+	}
+};
+
+}//End of namespace abc
+
+//------------------------------------------------------------------------
+//	Global variables
+//------------------------------------------------------------------------
+
+namespace abc {
+
+namespace nullrx
+{
+	//
+	// These are initialized by the render system upon start up.
+	//
+
+	extern TPtr< NullRenderer >		renderer;	// [ read-only ]
+	extern TPtr< NullResources >	resources;	// [ read-only ]
+
+	extern TPtr< NullScene >		scene;		// [ read-only ]
+
+	extern NullStats				stats;	// [ read-write ]
+
+}//End of namespace nullrx
+
+}//End of namespace abc
+
+//------------------------------------------------------------------------
+//	Includes
+//------------------------------------------------------------------------
+
+#include "Internal/NullResources.h"
+#include "Internal/NullScene.h"
+#include "Internal/NullRenderer.h"
+
+#endif // !__MX_NULL_RENDER_SYSTEM_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,54 @@
+/*
+=============================================================================
+	File:	RenderQueue.cpp
+	Desc:	Backend-agnostic parts of render queues: recording, merging and batching of draws.
+=============================================================================
+*/
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+/*================================
+		rxRenderQueue
+================================*/
+
+void rxRenderQueue::AddModelDraw( UINT32 modelIndex, const rxMaterial* material, const Matrix4& worldTransform, FLOAT depth )
+{
+	const UINT32  materialId = material ? material->GetSortId() : 0;
+
+	this->opaqueCommands.BeginPacket( rxMakeSortKey_FrontToBack( Stage_FillGBuffer, materialId, depth ) );
+	this->opaqueCommands.BindMaterial( material );
+	this->opaqueCommands.SetConstants( &worldTransform, sizeof(worldTransform) );
+	this->opaqueCommands.Draw( modelIndex );
+}
+
+void rxRenderQueue::AddTranslucentDraw( UINT32 objectIndex, FLOAT depth )
+{
+	this->translucentDraws.Add( rxMakeSortKey_BackToFront( Stage_Translucent, 0, depth ), objectIndex );
+}
+
+void rxRenderQueue::Sort()
+{
+	this->opaqueCommands.Sort();
+	this->translucentDraws.Sort();
+}
+
+void rxRenderQueue::ClearDraws()
+{
+	this->opaqueCommands.Clear();
+	this->translucentDraws.Clear();
+}
+
+void rxRenderQueue::AppendDraws( const rxRenderQueue& other, UINT32 firstModel, UINT32 firstTranslucent )
+{
+	this->opaqueCommands.Append( other.opaqueCommands, firstModel );
+	this->translucentDraws.Append( other.translucentDraws, firstTranslucent );
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,214 @@
+/*
+=============================================================================
+	File:	RenderQueue.h
+	Desc:	Backend-agnostic parts of render queues: recording, merging and batching of draws.
+=============================================================================
+*/
+
+#ifndef __RX_RENDER_QUEUE_H__
+#define __RX_RENDER_QUEUE_H__
+
+namespace abc {
+
+/*
+=====================================================================
+
+	Render queue.
+
+=====================================================================
+*/
+
+//
+//	rxRenderQueue - draw lists of a render queue.
+//
+//	Backends derive their render queues from this struct and add lists of their own objects,
+//	draws refer to the objects by their indices in these lists.
+//
+struct rxRenderQueue : public rxQueue {
+public:
+	// Stages stored in sort keys.
+	enum EDrawStage
+	{
+		Stage_FillGBuffer	= 0,
+		Stage_Translucent	= 1,
+	};
+
+public:
+	rxCommandBuffer	opaqueCommands;		// draws of models, sorted by material, then front-to-back
+	rxDrawList		translucentDraws;	// indices of translucent objects, sorted back-to-front
+
+public:
+				// Records a draw of the model with the given index in the backend's list of models.
+	void		AddModelDraw( UINT32 modelIndex, const rxMaterial* material, const Matrix4& worldTransform, FLOAT depth );
+
+				// Records a draw of the translucent object with the given index.
+	void		AddTranslucentDraw( UINT32 objectIndex, FLOAT depth );
+
+				// Sorts the draw lists, should be called after the queue has been filled.
+	void		Sort();
+
+protected:
+				// Removes all draws, doesn't free memory.
+	void		ClearDraws();
+
+				// Appends the draws of another queue, 'firstModel' and 'firstTranslucent'
+				// are the numbers of objects in this queue before the objects of the other queue were appended.
+	void		AppendDraws( const rxRenderQueue& other, UINT32 firstModel, UINT32 firstTranslucent );
+};
+
+/*
+=====================================================================
+
+	Recording.
+
+=====================================================================
+*/
+
+//
+//	TChunkQueueRecorder< QUEUE > - records chunks of the visible set into separate render queues.
+//
+template< class QUEUE >
+class TChunkQueueRecorder : public rxChunkRecorder {
+public:
+	TChunkQueueRecorder( const rxView& view, mxVisibleSet& visibleSet, QUEUE** chunkQueues )
+		: view( view )
+		, visibleSet( visibleSet )
+		, chunkQueues( chunkQueues )
+	{}
+
+	void RecordChunk( UINT chunkIndex, UINT firstObject, UINT numObjects )
+	{
+		QUEUE & queue = *this->chunkQueues[ chunkIndex ];
+		queue.Clear();
+
+		for( UINT iEnt = firstObject; iEnt < firstObject + numObjects; iEnt++ )
+		{
+			mxEntity * pEnt = this->visibleSet.Get( iEnt );
+			pEnt->GetGraphics()->Render( this->view, queue );
+		}
+	}
+
+private:
+	const rxView &		view;
+	mxVisibleSet &		visibleSet;
+	QUEUE **			chunkQueues;
+};
+
+//
+//	rxRecordRenderQueue - generates a render queue from the visible set and sorts it.
+//
+//	Large visible sets are recorded in chunks on worker threads ('chunkQueues' grows as needed)
+//	and the chunks are merged in their original order, so that the queue is the same as if it were recorded on this thread.
+//	QUEUE must derive from rxRenderQueue and have Clear() and Append( const QUEUE& ).
+//
+template< class QUEUE >
+void rxRecordRenderQueue( const rxView& view, mxVisibleSet& visibleSet, TArray< QUEUE* >& chunkQueues, QUEUE& OutQueue )
+{
+	{
+		MX_PROFILE( "Gen render queue" );
+		OutQueue.Clear();
+
+		const UINT  numObjects = visibleSet.GetNum();
+		const UINT  numChunks = rxGetNumRecordingChunks( numObjects );
+
+		if( numChunks > 1 )
+		{
+			while( chunkQueues.Num() < numChunks ) {
+				chunkQueues.Append( MX_NEW QUEUE() );
+			}
+
+			TChunkQueueRecorder< QUEUE >  recorder( view, visibleSet, chunkQueues.Ptr() );
+			rxRecordInParallel( recorder, numObjects, numChunks );
+
+			for( UINT iChunk = 0; iChunk < numChunks; iChunk++ ) {
+				OutQueue.Append( *chunkQueues[ iChunk ] );
+			}
+		}
+		else
+		{
+			for( UINT iEnt = 0; iEnt < numObjects; iEnt++ )
+			{
+				mxEntity * pEnt = visibleSet.Get( iEnt );
+				pEnt->GetGraphics()->Render( view, OutQueue );
+			}
+		}
+	}
+
+	{
+		MX_PROFILE( "Sort render queue" );
+		OutQueue.Sort();
+	}
+}
+
+/*
+=====================================================================
+
+	Replay.
+
+=====================================================================
+*/
+
+//
+//	TGeometryReplayer< QUEUE > - feeds the recorded draws of solid objects into an instance batcher.
+//
+//	Models of the queue must have AddToBatch(), which passes their geometry buffers to the batcher.
+//
+template< class QUEUE >
+class TGeometryReplayer : public rxCommandReplayer {
+public:
+	TGeometryReplayer( rxInstanceBatcher & batcher, const QUEUE & queue )
+		: instanceBatcher( batcher )
+		, renderQueue( queue )
+		, material( null )
+		, worldTransform( null )
+	{}
+
+	void BindMaterial( const rxMaterial* newMaterial )
+	{
+		this->material = newMaterial;
+	}
+
+	void SetConstants( const void* data, UINT size )
+	{
+		Assert( size == sizeof(Matrix4) );
+		this->worldTransform = static_cast< const Matrix4* >( data );
+	}
+
+	void Draw( UINT32 objectIndex )
+	{
+		AssertPtr( this->worldTransform );
+		this->renderQueue.models[ objectIndex ]->AddToBatch( this->instanceBatcher,
+			this->material, *this->worldTransform, objectIndex );
+	}
+
+private:
+	rxInstanceBatcher &		instanceBatcher;
+	const QUEUE &			renderQueue;
+	const rxMaterial *		material;
+	const Matrix4 *			worldTransform;
+};
+
+//
+//	rxBatchOpaqueDraws - groups the recorded draws of solid objects with the same geometry and material.
+//
+//	The draws are sorted by material, then front-to-back, and groups are listed in the order of their first draws.
+//	User indices of the batched instances are indices of the models in the queue.
+//
+template< class QUEUE >
+void rxBatchOpaqueDraws( const QUEUE& queue, rxInstanceBatcher& batcher )
+{
+	batcher.Clear();
+
+	TGeometryReplayer< QUEUE >  replayer( batcher, queue );
+	queue.opaqueCommands.Replay( replayer );
+
+	batcher.Build();
+}
+
+}//End of namespace abc
+
+#endif // !__RX_RENDER_QUEUE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
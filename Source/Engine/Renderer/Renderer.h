@@ -273,10 +273,16 @@ struct rxDynMeshData
 	const rxIndex *		indices;	// index data (readable by CPU)
 	mxBounds			bounds;		// bounds in local space
 
+	// Vertices and indices before these are the same as in the previous update
+	// and don't need to be uploaded again.
+	UINT				firstChangedVertex;
+	UINT				firstChangedIndex;
+
 	rxDynMeshData()
 		: numVertices(0), vertices(null)
 		, numIndices(0), indices(null)
 		, bounds(mxBounds::INFINITE_EXTENT)
+		, firstChangedVertex(0), firstChangedIndex(0)
 	{}
 };
 
@@ -799,10 +805,17 @@ public:
 	//--------------------------------------------------------
 
 	virtual rxTexture*	LoadTexture( const mxFilePath& filename ) = 0;
+
+						// Creates a texture from the contents of an image file which has already been read into memory
+						// (e.g. by a background loader). The texture is registered under the given name,
+						// so that LoadTexture() with the same file name returns it.
+	virtual rxTexture*	LoadTextureFromMemory( const mxChar* name, const void* pFileData, mxUInt numBytes ) = 0;
+
 	virtual rxTexture*	CreateTexture( const void* pData, mxUInt numBytes, const rxTextureDescription& desc ) = 0;
 
 						// Returns the texture given its name (returns null if not found).
 	virtual rxTexture*	GetTexture( const mxChar* name ) = 0;
+	virtual rxTexture*	GetTexture( const mxNameId& name ) = 0;
 
 	//--------------------------------------------------------
 	//	Render materials.
@@ -817,6 +830,9 @@ public:
 
 	virtual rxMaterial*	GetMaterial( const mxChar* name ) = 0;
 
+						// Faster version, doesn't hash the string (returns null if not found).
+	virtual rxMaterial*	GetMaterial( const mxNameId& name ) = 0;
+
 	//--------------------------------------------------------
 	//	Resource usage statistics.
 	//--------------------------------------------------------
@@ -849,6 +865,16 @@ public:
 	mxUInt	numBatches;		// number of draw calls issued in the last frame
 	mxUInt	numEntities;	// number of objects rendered in the last frame
 
+	mxUInt	numMaterialChanges;			// number of times a material was bound in the last frame
+	mxUInt	numStateChangesAvoided;		// number of redundant material binds skipped thanks to sorting
+
+	mxUInt	numShadowCacheHits;			// number of shadow maps reused without re-rendering any casters
+	mxUInt	numShadowCacheMisses;		// number of shadow maps whose static layer had to be re-rendered
+	mxUInt	numShadowDynamicUpdates;	// number of shadow maps where only dynamic casters were re-rendered
+
+	mxUInt	numInstancedBatches;		// number of instanced draw calls (included in 'numBatches')
+	mxUInt	numBatchesSaved;			// number of draw calls saved by instancing
+
 //	mxUInt	numVisibleLights;
 
 	mxUInt	Cpu_cull_time_milliseconds;	// total time spent on high-level culling
@@ -868,6 +894,13 @@ public:
 	{
 		numBatches = 0;
 		numEntities = 0;
+		numMaterialChanges = 0;
+		numStateChangesAvoided = 0;
+		numShadowCacheHits = 0;
+		numShadowCacheMisses = 0;
+		numShadowDynamicUpdates = 0;
+		numInstancedBatches = 0;
+		numBatchesSaved = 0;
 //		numVisibleLights = 0;
 		Cpu_cull_time_milliseconds = 0;
 //		scene_geometry_culled_percents = 0;
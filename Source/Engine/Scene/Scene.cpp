@@ -389,9 +389,19 @@ void mxCamera::_UpdateOnTransformChanged()
 ================================*/
 
 mxVisibleSet::mxVisibleSet( SizeT initialCount /* = 256 */ )
-	: m_visibleObjects( initialCount )
+	: m_visibleObjects( Mem_GetAllocator( MX_MEMORY_CLASS_SCENE_DATA ), initialCount )
+	, m_frameArena( null )
+	, m_frameNumber( 0 )
 {}
 
+mxVisibleSet::mxVisibleSet( mxFrameArena* frameArena, SizeT initialCount /* = 256 */ )
+	: m_visibleObjects( frameArena, initialCount )
+	, m_frameArena( frameArena )
+	, m_frameNumber( frameArena->GetFrameNumber() )
+{
+	AssertPtr( frameArena );
+}
+
 mxVisibleSet::~mxVisibleSet()
 {}
 
@@ -424,7 +434,16 @@ mxEntity * mxVisibleSet::Get( IndexT index )
 //
 void mxVisibleSet::Empty()
 {
-	m_visibleObjects.SetNum( 0, false /* don't resize */ );
+	if( m_frameArena && m_frameNumber != m_frameArena->GetFrameNumber() )
+	{
+		// The arena will recycle the memory of the previous frames,
+		// move to the memory of this frame without growing again (nothing is copied).
+		const mxUInt capacity = m_visibleObjects.NumAllocated();
+		m_visibleObjects.Clear();
+		m_visibleObjects.Resize( capacity );
+		m_frameNumber = m_frameArena->GetFrameNumber();
+	}
+	m_visibleObjects.Empty();
 }
 
 /*================================
@@ -445,8 +464,6 @@ mxScene::~mxScene()
 //
 void mxScene::Initialize( const mxSceneDescription& creationInfo )
 {
-	(void) creationInfo;
-
 	if( null == activeCamera )
 	{
 		activeCamera = MX_NEW mxCamera();
@@ -454,7 +471,22 @@ void mxScene::Initialize( const mxSceneDescription& creationInfo )
 
 	if( null == spatialHash )
 	{
-		spatialHash = MX_NEW mxSpatialDatabase_Simple();
+		// A loose octree handles lots of moving objects better,
+		// but it needs to know the size of the world in advance.
+		const Vec3D & worldMin = creationInfo.Bounds.GetMin();
+		const Vec3D & worldMax = creationInfo.Bounds.GetMax();
+		const bool bFiniteWorld =
+			( Min3( worldMin.x, worldMin.y, worldMin.z ) >= -MAX_SCENE_SIZE )
+			&& ( Max3( worldMax.x, worldMax.y, worldMax.z ) <= MAX_SCENE_SIZE );
+
+		if( creationInfo.Options.DataVariance == EDataVariance::Variance_Dynamic && bFiniteWorld )
+		{
+			spatialHash = MX_NEW mxSpatialDatabase_LooseOctree( creationInfo.Bounds );
+		}
+		else
+		{
+			spatialHash = MX_NEW mxSpatialDatabase_AABBTree();
+		}
 		spatialHash->Setup( *this );
 	}
 }
@@ -485,7 +517,12 @@ void mxScene::Add( mxEntity* entity )
 void mxScene::Remove( mxEntity* entity )
 {
 	AssertPtr( entity );
-	Unimplemented;
+
+	GetSpatialDatabase().Remove( entity );
+
+	const bool bRemoved = entities.Remove( entity );
+	Assert( bRemoved );
+	(void) bRemoved;
 }
 
 //
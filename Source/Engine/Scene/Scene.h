@@ -357,10 +357,14 @@ FORCEINLINE const Vec3D & mxCamera::GetLookAt() const {
 // For now it's a simple array, but in the future
 // it will be a data structure which will probably not require
 // complete rebuilding in each frame.
+//
+// If the set is created with the frame arena, its memory is only valid for the current frame
+// and the set must be emptied every frame (Empty() keeps the capacity of the previous frames).
 
 class mxVisibleSet {
 public:
 			mxVisibleSet( SizeT initialCount = 256 );
+			mxVisibleSet( mxFrameArena* frameArena, SizeT initialCount = 256 );
 			~mxVisibleSet();
 
 	void		Add( mxEntity* pObject );
@@ -370,7 +374,9 @@ public:
 	void	Empty();	// Empties this set.
 
 private:
-	TArray< mxEntity* >	m_visibleObjects;
+	TAllocArray< mxEntity* >	m_visibleObjects;
+	mxFrameArena *				m_frameArena;	// null if the memory is taken from the heap
+	mxUInt						m_frameNumber;	// of the frame arena when the memory was allocated
 };
 
 //
@@ -0,0 +1,1156 @@
+/*
+=============================================================================
+	File:	SpatialDatabase_AABBTree.cpp
+	Desc:	Spatial database based on a dynamic AABB tree.
+	Note:	Tree maintenance (insertion cost heuristic, rotations)
+			follows the dynamic tree from Box2D by Erin Catto.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+namespace {
+
+	// Maximum depth of the explicit traversal stack.
+	// The tree is kept balanced so this is more than enough.
+	enum { MAX_STACK_DEPTH = 256 };
+
+	FORCEINLINE FLOAT SurfaceArea( const AABB& box )
+	{
+		const Vec3D d( box.GetMax() - box.GetMin() );
+		return 2.0f * ( d.x * d.y + d.y * d.z + d.z * d.x );
+	}
+
+	FORCEINLINE AABB Combine( const AABB& a, const AABB& b )
+	{
+		return AABB(
+			Vec3D( Min( a.GetMin().x, b.GetMin().x ), Min( a.GetMin().y, b.GetMin().y ), Min( a.GetMin().z, b.GetMin().z ) ),
+			Vec3D( Max( a.GetMax().x, b.GetMax().x ), Max( a.GetMax().y, b.GetMax().y ), Max( a.GetMax().z, b.GetMax().z ) )
+		);
+	}
+
+}//end of anonymous namespace
+
+/*================================
+	mxSpatialDatabase_AABBTree
+================================*/
+
+mxSpatialDatabase_AABBTree::mxSpatialDatabase_AABBTree( FLOAT fatMargin )
+	: nodes( 256 )
+	, root( NULL_NODE )
+	, freeList( NULL_NODE )
+	, numProxies( 0 )
+	, fatMargin( fatMargin )
+	, bounds( mxBounds::INFINITE_EXTENT )
+{
+	Assert( fatMargin >= 0.0f );
+}
+
+mxSpatialDatabase_AABBTree::~mxSpatialDatabase_AABBTree()
+{
+}
+
+void mxSpatialDatabase_AABBTree::Setup( mxScene& theParentScene )
+{
+	mxSpatialDatabase::Setup( theParentScene );
+
+	this->bounds = mxBounds::INFINITE_EXTENT;
+}
+
+void mxSpatialDatabase_AABBTree::Close()
+{
+	for( IndexT iNode = 0; iNode < this->nodes.Num(); iNode++ )
+	{
+		if( this->nodes[ iNode ].proxy ) {
+			this->nodes[ iNode ].proxy->spatialHandle = INDEX_NONE;
+		}
+	}
+	this->nodes.Clear();
+	this->root = NULL_NODE;
+	this->freeList = NULL_NODE;
+	this->numProxies = 0;
+
+	this->unbounded.Clear();
+
+	mxSpatialDatabase::Close();
+}
+
+//
+//	mxSpatialDatabase_AABBTree::IsUnbounded
+//
+bool mxSpatialDatabase_AABBTree::IsUnbounded( const AABB& worldBounds )
+{
+	for( INT i = 0; i < 3; i++ )
+	{
+		if( !( worldBounds.GetMin()[i] >= -MAX_SCENE_SIZE )
+			|| !( worldBounds.GetMax()[i] <= MAX_SCENE_SIZE ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::AllocateNode
+//
+INT32 mxSpatialDatabase_AABBTree::AllocateNode()
+{
+	// Expand the node pool as needed.
+	if( this->freeList == NULL_NODE )
+	{
+		const IndexT oldNum = this->nodes.Num();
+		const IndexT newNum = Max< IndexT >( oldNum * 2, 16 );
+
+		// the pool grows geometrically
+		this->nodes.SetNum( newNum, false );
+
+		// Build a linked list for the free list.
+		for( IndexT i = oldNum; i < newNum; i++ )
+		{
+			Node & node = this->nodes[ i ];
+			node.next = (i + 1 < newNum) ? INT32(i + 1) : NULL_NODE;
+			node.height = -1;
+			node.proxy = null;
+		}
+		this->freeList = oldNum;
+	}
+
+	// Peel a node off the free list.
+	const INT32 nodeId = this->freeList;
+	Node & node = this->nodes[ nodeId ];
+
+	this->freeList = node.next;
+
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.proxy = null;
+
+	return nodeId;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::FreeNode
+//
+void mxSpatialDatabase_AABBTree::FreeNode( INT32 nodeId )
+{
+	Assert( 0 <= nodeId && nodeId < (INT32)this->nodes.Num() );
+
+	Node & node = this->nodes[ nodeId ];
+	node.next = this->freeList;
+	node.height = -1;
+	node.proxy = null;
+
+	this->freeList = nodeId;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::CreateProxy
+//
+INT32 mxSpatialDatabase_AABBTree::CreateProxy( mxSpatialProxy* proxy, const AABB& worldBounds )
+{
+	const INT32 leafId = AllocateNode();
+
+	Node & leaf = this->nodes[ leafId ];
+	leaf.box = worldBounds.Expand( this->fatMargin );
+	leaf.bounds = worldBounds;
+	leaf.proxy = proxy;
+	leaf.height = 0;
+
+	InsertLeaf( leafId );
+
+	this->numProxies++;
+
+	return leafId;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::DestroyProxy
+//
+void mxSpatialDatabase_AABBTree::DestroyProxy( INT32 leafId )
+{
+	Assert( this->nodes[ leafId ].IsLeaf() );
+
+	RemoveLeaf( leafId );
+	FreeNode( leafId );
+
+	this->numProxies--;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::MoveProxy
+//
+//	Returns true if the tree had to be modified.
+//
+bool mxSpatialDatabase_AABBTree::MoveProxy( INT32 leafId, const AABB& worldBounds )
+{
+	Node & leaf = this->nodes[ leafId ];
+	Assert( leaf.IsLeaf() );
+
+	leaf.bounds = worldBounds;
+
+	if( leaf.box.Contains( worldBounds ) ) {
+		// the proxy is still inside its fat box
+		return false;
+	}
+
+	RemoveLeaf( leafId );
+
+	this->nodes[ leafId ].box = worldBounds.Expand( this->fatMargin );
+
+	InsertLeaf( leafId );
+
+	return true;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::RelocateProxy
+//
+void mxSpatialDatabase_AABBTree::RelocateProxy( mxSpatialProxy* proxy, const AABB& worldBounds )
+{
+	const bool bUnbounded = IsUnbounded( worldBounds );
+
+	if( proxy->spatialHandle == INDEX_NONE )
+	{
+		if( !bUnbounded )
+		{
+			// the bounds have become finite, the proxy can be culled by the tree
+			const bool bRemoved = this->unbounded.Remove( proxy );
+			Assert( bRemoved );
+			(void) bRemoved;
+			proxy->spatialHandle = CreateProxy( proxy, worldBounds );
+		}
+		return;
+	}
+
+	if( bUnbounded )
+	{
+		// infinite bounds would break the node boxes
+		DestroyProxy( proxy->spatialHandle );
+		proxy->spatialHandle = INDEX_NONE;
+		this->unbounded.Append( proxy );
+		return;
+	}
+
+	MoveProxy( proxy->spatialHandle, worldBounds );
+}
+
+//
+//	mxSpatialDatabase_AABBTree::InsertLeaf
+//
+void mxSpatialDatabase_AABBTree::InsertLeaf( INT32 leafId )
+{
+	if( this->root == NULL_NODE )
+	{
+		this->root = leafId;
+		this->nodes[ this->root ].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling for this node
+	// (descend while it's cheaper than creating a new parent here).
+
+	const AABB leafBox( this->nodes[ leafId ].box );
+
+	INT32 index = this->root;
+	while( !this->nodes[ index ].IsLeaf() )
+	{
+		const INT32 child1 = this->nodes[ index ].child1;
+		const INT32 child2 = this->nodes[ index ].child2;
+
+		const FLOAT area = SurfaceArea( this->nodes[ index ].box );
+
+		const AABB combinedBox( Combine( this->nodes[ index ].box, leafBox ) );
+		const FLOAT combinedArea = SurfaceArea( combinedBox );
+
+		// Cost of creating a new parent for this node and the new leaf.
+		const FLOAT cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		const FLOAT inheritanceCost = 2.0f * ( combinedArea - area );
+
+		// Cost of descending into child1.
+		FLOAT cost1;
+		{
+			const Node & c = this->nodes[ child1 ];
+			const FLOAT newArea = SurfaceArea( Combine( leafBox, c.box ) );
+			cost1 = c.IsLeaf()
+				? ( newArea + inheritanceCost )
+				: ( newArea - SurfaceArea( c.box ) + inheritanceCost );
+		}
+
+		// Cost of descending into child2.
+		FLOAT cost2;
+		{
+			const Node & c = this->nodes[ child2 ];
+			const FLOAT newArea = SurfaceArea( Combine( leafBox, c.box ) );
+			cost2 = c.IsLeaf()
+				? ( newArea + inheritanceCost )
+				: ( newArea - SurfaceArea( c.box ) + inheritanceCost );
+		}
+
+		// Descend according to the minimum cost.
+		if( cost < cost1 && cost < cost2 ) {
+			break;
+		}
+
+		index = ( cost1 < cost2 ) ? child1 : child2;
+	}
+
+	const INT32 sibling = index;
+
+	// Create a new parent.
+	const INT32 oldParent = this->nodes[ sibling ].parent;
+	const INT32 newParent = AllocateNode();	// NOTE: may reallocate the node pool.
+	{
+		Node & parent = this->nodes[ newParent ];
+		parent.parent = oldParent;
+		parent.proxy = null;
+		parent.box = Combine( leafBox, this->nodes[ sibling ].box );
+		parent.height = this->nodes[ sibling ].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leafId;
+	}
+
+	if( oldParent != NULL_NODE )
+	{
+		// The sibling was not the root.
+		if( this->nodes[ oldParent ].child1 == sibling ) {
+			this->nodes[ oldParent ].child1 = newParent;
+		} else {
+			this->nodes[ oldParent ].child2 = newParent;
+		}
+	}
+	else
+	{
+		// The sibling was the root.
+		this->root = newParent;
+	}
+	this->nodes[ sibling ].parent = newParent;
+	this->nodes[ leafId ].parent = newParent;
+
+	// Walk back up the tree fixing heights and boxes.
+	index = this->nodes[ leafId ].parent;
+	while( index != NULL_NODE )
+	{
+		index = Balance( index );
+
+		const INT32 child1 = this->nodes[ index ].child1;
+		const INT32 child2 = this->nodes[ index ].child2;
+
+		Assert( child1 != NULL_NODE );
+		Assert( child2 != NULL_NODE );
+
+		this->nodes[ index ].height = 1 + Max( this->nodes[ child1 ].height, this->nodes[ child2 ].height );
+		this->nodes[ index ].box = Combine( this->nodes[ child1 ].box, this->nodes[ child2 ].box );
+
+		index = this->nodes[ index ].parent;
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::RemoveLeaf
+//
+void mxSpatialDatabase_AABBTree::RemoveLeaf( INT32 leafId )
+{
+	if( leafId == this->root )
+	{
+		this->root = NULL_NODE;
+		return;
+	}
+
+	const INT32 parent = this->nodes[ leafId ].parent;
+	const INT32 grandParent = this->nodes[ parent ].parent;
+	const INT32 sibling = ( this->nodes[ parent ].child1 == leafId )
+		? this->nodes[ parent ].child2
+		: this->nodes[ parent ].child1;
+
+	if( grandParent != NULL_NODE )
+	{
+		// Destroy the parent and connect the sibling to the grand parent.
+		if( this->nodes[ grandParent ].child1 == parent ) {
+			this->nodes[ grandParent ].child1 = sibling;
+		} else {
+			this->nodes[ grandParent ].child2 = sibling;
+		}
+		this->nodes[ sibling ].parent = grandParent;
+		FreeNode( parent );
+
+		// Adjust ancestor bounds.
+		INT32 index = grandParent;
+		while( index != NULL_NODE )
+		{
+			index = Balance( index );
+
+			const INT32 child1 = this->nodes[ index ].child1;
+			const INT32 child2 = this->nodes[ index ].child2;
+
+			this->nodes[ index ].box = Combine( this->nodes[ child1 ].box, this->nodes[ child2 ].box );
+			this->nodes[ index ].height = 1 + Max( this->nodes[ child1 ].height, this->nodes[ child2 ].height );
+
+			index = this->nodes[ index ].parent;
+		}
+	}
+	else
+	{
+		this->root = sibling;
+		this->nodes[ sibling ].parent = NULL_NODE;
+		FreeNode( parent );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Balance
+//
+//	Performs a left or right rotation if node A is imbalanced.
+//	Returns the new root index.
+//
+INT32 mxSpatialDatabase_AABBTree::Balance( INT32 iA )
+{
+	Assert( iA != NULL_NODE );
+
+	Node * A = &this->nodes[ iA ];
+	if( A->IsLeaf() || A->height < 2 ) {
+		return iA;
+	}
+
+	const INT32 iB = A->child1;
+	const INT32 iC = A->child2;
+
+	Node * B = &this->nodes[ iB ];
+	Node * C = &this->nodes[ iC ];
+
+	const INT32 balance = C->height - B->height;
+
+	// Rotate C up.
+	if( balance > 1 )
+	{
+		const INT32 iF = C->child1;
+		const INT32 iG = C->child2;
+		Node * F = &this->nodes[ iF ];
+		Node * G = &this->nodes[ iG ];
+
+		// Swap A and C.
+		C->child1 = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		// A's old parent should point to C.
+		if( C->parent != NULL_NODE )
+		{
+			if( this->nodes[ C->parent ].child1 == iA ) {
+				this->nodes[ C->parent ].child1 = iC;
+			} else {
+				Assert( this->nodes[ C->parent ].child2 == iA );
+				this->nodes[ C->parent ].child2 = iC;
+			}
+		}
+		else
+		{
+			this->root = iC;
+		}
+
+		// Rotate.
+		if( F->height > G->height )
+		{
+			C->child2 = iF;
+			A->child2 = iG;
+			G->parent = iA;
+			A->box = Combine( B->box, G->box );
+			C->box = Combine( A->box, F->box );
+
+			A->height = 1 + Max( B->height, G->height );
+			C->height = 1 + Max( A->height, F->height );
+		}
+		else
+		{
+			C->child2 = iG;
+			A->child2 = iF;
+			F->parent = iA;
+			A->box = Combine( B->box, F->box );
+			C->box = Combine( A->box, G->box );
+
+			A->height = 1 + Max( B->height, F->height );
+			C->height = 1 + Max( A->height, G->height );
+		}
+
+		return iC;
+	}
+
+	// Rotate B up.
+	if( balance < -1 )
+	{
+		const INT32 iD = B->child1;
+		const INT32 iE = B->child2;
+		Node * D = &this->nodes[ iD ];
+		Node * E = &this->nodes[ iE ];
+
+		// Swap A and B.
+		B->child1 = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		// A's old parent should point to B.
+		if( B->parent != NULL_NODE )
+		{
+			if( this->nodes[ B->parent ].child1 == iA ) {
+				this->nodes[ B->parent ].child1 = iB;
+			} else {
+				Assert( this->nodes[ B->parent ].child2 == iA );
+				this->nodes[ B->parent ].child2 = iB;
+			}
+		}
+		else
+		{
+			this->root = iB;
+		}
+
+		// Rotate.
+		if( D->height > E->height )
+		{
+			B->child2 = iD;
+			A->child1 = iE;
+			E->parent = iA;
+			A->box = Combine( C->box, E->box );
+			B->box = Combine( A->box, D->box );
+
+			A->height = 1 + Max( C->height, E->height );
+			B->height = 1 + Max( A->height, D->height );
+		}
+		else
+		{
+			B->child2 = iE;
+			A->child1 = iD;
+			D->parent = iA;
+			A->box = Combine( C->box, D->box );
+			B->box = Combine( A->box, E->box );
+
+			A->height = 1 + Max( C->height, D->height );
+			B->height = 1 + Max( A->height, E->height );
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Add
+//
+void mxSpatialDatabase_AABBTree::Add( mxEntity* entity )
+{
+	AssertPtr( entity );
+
+	mxSpatialProxy * spatialProxy = entity->GetSpatialProxy();
+	if( !spatialProxy ) {
+		return;
+	}
+	Assert2( spatialProxy->spatialHandle == INDEX_NONE, "the proxy has already been added" );
+
+	mxBounds  worldBounds;
+	spatialProxy->GetBoundsWorld( worldBounds );
+
+	if( IsUnbounded( worldBounds ) ) {
+		this->unbounded.Append( spatialProxy );
+		return;
+	}
+
+	spatialProxy->spatialHandle = CreateProxy( spatialProxy, worldBounds );
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Remove
+//
+void mxSpatialDatabase_AABBTree::Remove( mxEntity* entity )
+{
+	AssertPtr( entity );
+
+	mxSpatialProxy * spatialProxy = entity->GetSpatialProxy();
+	if( !spatialProxy ) {
+		return;
+	}
+
+	if( spatialProxy->spatialHandle == INDEX_NONE )
+	{
+		const bool bRemoved = this->unbounded.Remove( spatialProxy );
+		Assert( bRemoved );
+		(void) bRemoved;
+		return;
+	}
+
+	Assert( this->nodes[ spatialProxy->spatialHandle ].proxy == spatialProxy );
+	DestroyProxy( spatialProxy->spatialHandle );
+	spatialProxy->spatialHandle = INDEX_NONE;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Refit
+//
+void mxSpatialDatabase_AABBTree::Refit( mxSpatialProxy* proxy )
+{
+	AssertPtr( proxy );
+
+	mxBounds  worldBounds;
+	proxy->GetBoundsWorld( worldBounds );
+
+	RelocateProxy( proxy, worldBounds );
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Update
+//
+void mxSpatialDatabase_AABBTree::Update( const mxTime deltaTime )
+{
+	MX_PROFILE("AABB tree: refit");
+
+	mxSpatialDatabase::Update( deltaTime );
+
+	// Gather the proxies that have moved since the last update.
+	// NOTE: moving a proxy doesn't reallocate the node pool
+	// (a leaf is removed before it is re-inserted, proxies with infinite bounds are only removed).
+	for( IndexT iNode = 0; iNode < this->nodes.Num(); iNode++ )
+	{
+		const Node & node = this->nodes[ iNode ];
+		if( node.height != 0 ) {
+			continue;	// free or internal node
+		}
+
+		mxSpatialProxy * proxy = node.proxy;
+
+		mxBounds  worldBounds;
+		proxy->GetBoundsWorld( worldBounds );
+
+		if( worldBounds != node.bounds ) {
+			RelocateProxy( proxy, worldBounds );
+		}
+	}
+
+	// Insert the unbounded proxies whose bounds have become finite
+	// (iterating backwards, because they are removed from the list).
+	for( IndexT i = this->unbounded.Num(); i > 0; i-- )
+	{
+		mxSpatialProxy * proxy = this->unbounded[ i - 1 ];
+
+		mxBounds  worldBounds;
+		proxy->GetBoundsWorld( worldBounds );
+
+		RelocateProxy( proxy, worldBounds );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::Validate
+//
+void mxSpatialDatabase_AABBTree::Validate()
+{
+	mxSpatialDatabase::Validate();
+
+	if( this->root != NULL_NODE ) {
+		Assert( this->nodes[ this->root ].parent == NULL_NODE );
+		ValidateStructure( this->root );
+	}
+
+	mxUInt freeCount = 0;
+	INT32 freeIndex = this->freeList;
+	while( freeIndex != NULL_NODE ) {
+		Assert( this->nodes[ freeIndex ].height == -1 );
+		freeIndex = this->nodes[ freeIndex ].next;
+		++freeCount;
+	}
+	Assert( freeCount <= this->nodes.Num() );
+}
+
+void mxSpatialDatabase_AABBTree::ValidateStructure( INT32 nodeId ) const
+{
+	const Node & node = this->nodes[ nodeId ];
+
+	if( node.IsLeaf() )
+	{
+		Assert( node.height == 0 );
+		AssertPtr( node.proxy );
+		Assert( node.proxy->spatialHandle == nodeId );
+		return;
+	}
+
+	const Node & child1 = this->nodes[ node.child1 ];
+	const Node & child2 = this->nodes[ node.child2 ];
+
+	Assert( child1.parent == nodeId );
+	Assert( child2.parent == nodeId );
+	Assert( node.height == 1 + Max( child1.height, child2.height ) );
+	Assert( node.box.Contains( child1.box ) && node.box.Contains( child2.box ) );
+
+	ValidateStructure( node.child1 );
+	ValidateStructure( node.child2 );
+}
+
+//
+//	mxSpatialDatabase_AABBTree::TraceRay
+//
+void mxSpatialDatabase_AABBTree::TraceRay( const mxTraceInput& traceInput, mxTraceResult &OutTraceResult )
+{
+	const Vec3D & origin = traceInput.GetStart();
+	const Vec3D & direction = traceInput.GetDirection();
+	Assert( direction.IsNormalized() );
+
+	const Vec3D invDir( GetInverseRayDirection( direction ) );
+
+	// NOTE: hit positions and normals are given in world space.
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		FLOAT entryFraction;
+		if( !RayIntersectsAABB( origin, invDir, node.box, MAX_SCENE_SIZE, entryFraction ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			mxSpatialProxy * proxy = node.proxy;
+			mxEntity * entity = proxy->GetOwner();
+
+			if( !OutTraceResult.NeedsChecking( *entity ) ) {
+				continue;
+			}
+
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if( proxy->CastRay( origin, direction, hitFraction ) && hitFraction >= 0.0f )
+			{
+				mxLocalRayResult  result;
+				result.m_entityHit		= entity;
+				result.m_position		= origin + direction * hitFraction;
+				result.m_normal			= GetClosestAABBFaceNormal( node.bounds, result.m_position );
+				result.m_hitFraction	= hitFraction;
+
+				OutTraceResult.AddSingleResult( result );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	// Proxies with infinite extents never block rays.
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetEntitiesInPoint
+//
+void mxSpatialDatabase_AABBTree::GetEntitiesInPoint( const Vec3D& point, mxEntityCache &OutEntities )
+{
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		if( !node.box.ContainsPoint( point ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			if( node.bounds.ContainsPoint( point ) ) {
+				OutEntities.Append( node.proxy->GetOwner() );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ ) {
+		OutEntities.Append( this->unbounded[ i ]->GetOwner() );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetEntitiesAlongLine
+//
+void mxSpatialDatabase_AABBTree::GetEntitiesAlongLine( const Vec3D& start, const Vec3D& end, mxEntityCache &OutEntities )
+{
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		if( !node.box.LineIntersection( start, end ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			if( node.bounds.LineIntersection( start, end ) ) {
+				OutEntities.Append( node.proxy->GetOwner() );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	// Objects with infinite extents intersect any line.
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ ) {
+		OutEntities.Append( this->unbounded[ i ]->GetOwner() );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetEntitiesAlongRay
+//
+void mxSpatialDatabase_AABBTree::GetEntitiesAlongRay( const Vec3D& origin, const Vec3D& direction, mxEntityCache &OutEntities )
+{
+	Assert( direction.IsNormalized() );
+
+	const Vec3D invDir( GetInverseRayDirection( direction ) );
+
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		FLOAT entryFraction;
+		if( !RayIntersectsAABB( origin, invDir, node.box, MAX_SCENE_SIZE, entryFraction ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if( node.proxy->CastRay( origin, direction, hitFraction ) && hitFraction >= 0.0f ) {
+				OutEntities.Append( node.proxy->GetOwner() );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	// Objects with infinite extents can't be culled, but their own ray tests are still applied.
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ )
+	{
+		mxSpatialProxy * proxy = this->unbounded[ i ];
+
+		FLOAT hitFraction = MAX_SCENE_SIZE;
+		if( proxy->CastRay( origin, direction, hitFraction ) && hitFraction >= 0.0f ) {
+			OutEntities.Append( proxy->GetOwner() );
+		}
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetEntitiesInBox
+//
+void mxSpatialDatabase_AABBTree::GetEntitiesInBox( const Vec3D& min, const Vec3D& max, mxEntityCache &OutEntities )
+{
+	const AABB queryBox( min, max );
+
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		if( !node.box.IntersectsBounds( queryBox ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			if( node.bounds.IntersectsBounds( queryBox ) ) {
+				OutEntities.Append( node.proxy->GetOwner() );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ ) {
+		OutEntities.Append( this->unbounded[ i ]->GetOwner() );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetEntitiesInSphere
+//
+void mxSpatialDatabase_AABBTree::GetEntitiesInSphere( const Vec3D& origin, FLOAT radius, mxEntityCache &OutEntities )
+{
+	Assert( radius >= 0.0f );
+
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		if( !SphereIntersectsAABB( origin, radius, node.box ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			if( SphereIntersectsAABB( origin, radius, node.bounds ) ) {
+				OutEntities.Append( node.proxy->GetOwner() );
+			}
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ ) {
+		OutEntities.Append( this->unbounded[ i ]->GetOwner() );
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::IsPotentiallyVisible
+//
+mxBool mxSpatialDatabase_AABBTree::IsPotentiallyVisible( const mxSceneView& view, const mxSpatialProxy* obj ) const
+{
+	if( obj->spatialHandle != INDEX_NONE ) {
+		return view.GetFrustum().IntersectsAABB( this->nodes[ obj->spatialHandle ].bounds );
+	}
+	Sphere  s;
+	obj->GetBoundingSphereWorld( s );
+	return view.GetFrustum().IntersectSphere( s );
+}
+
+//
+//	mxSpatialDatabase_AABBTree::AddSubtreeToVisibleSet
+//
+//	Adds all proxies under the given node without further testing.
+//
+void mxSpatialDatabase_AABBTree::AddSubtreeToVisibleSet( INT32 nodeId, mxVisibleSet &OutVisibleSet )
+{
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	stack[ top++ ] = nodeId;
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		if( node.IsLeaf() ) {
+			OutVisibleSet.Add( node.proxy->GetOwner() );
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+}
+
+//
+//	mxSpatialDatabase_AABBTree::GetVisibleSet
+//
+void mxSpatialDatabase_AABBTree::GetVisibleSet( const mxSceneView& view, mxVisibleSet &OutVisibleSet )
+{
+	// Clear the output visible set first.
+	OutVisibleSet.Empty();
+
+	const mxViewFrustum & frustum = view.GetFrustum();
+
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const INT32 nodeId = stack[ --top ];
+		const Node & node = this->nodes[ nodeId ];
+
+		if( node.IsLeaf() )
+		{
+			// the leaves are tested in batches
+			this->cullingBatch.Add( node.bounds, node.proxy );
+			continue;
+		}
+
+		const ESpatialRelation relation = frustum.Classify( node.box );
+
+		if( relation == ESpatialRelation::Outside ) {
+			continue;
+		}
+		if( relation == ESpatialRelation::Inside ) {
+			// the whole subtree is visible, no need to test its children
+			AddSubtreeToVisibleSet( nodeId, OutVisibleSet );
+			continue;
+		}
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		stack[ top++ ] = node.child1;
+		stack[ top++ ] = node.child2;
+	}
+
+	this->cullingBatch.Flush( frustum, OutVisibleSet );
+
+	// Objects with infinite extents are always visible.
+	for( IndexT i = 0; i < this->unbounded.Num(); i++ ) {
+		OutVisibleSet.Add( this->unbounded[ i ]->GetOwner() );
+	}
+}
+
+void mxSpatialDatabase_AABBTree::GetBoundsLocal( mxBounds & OutBounds ) const
+{
+	OutBounds = this->bounds;
+}
+
+void mxSpatialDatabase_AABBTree::GetBoundsWorld( mxBounds & OutBounds ) const
+{
+	OutBounds = this->bounds;
+}
+
+//
+//	mxSpatialDatabase_AABBTree::FindClosestHit
+//
+//	Returns the closest solid proxy hit by the ray.
+//	Subtrees farther than the current closest hit are skipped.
+//
+mxSpatialProxy * mxSpatialDatabase_AABBTree::FindClosestHit( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const
+{
+	Assert( direction.IsNormalized() );
+
+	const Vec3D invDir( GetInverseRayDirection( direction ) );
+
+	mxSpatialProxy * pHitObject = null;
+
+	INT32 stack[ MAX_STACK_DEPTH ];
+	INT32 top = 0;
+
+	if( this->root != NULL_NODE ) {
+		stack[ top++ ] = this->root;
+	}
+
+	while( top > 0 )
+	{
+		const Node & node = this->nodes[ stack[ --top ] ];
+
+		FLOAT entryFraction;
+		if( !RayIntersectsAABB( origin, invDir, node.box, fraction, entryFraction ) ) {
+			continue;
+		}
+
+		if( node.IsLeaf() )
+		{
+			mxSpatialProxy * pObject = node.proxy;
+
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if ( (pObject->hitFilterMask & HM_Solid)
+				&& pObject->CastRay( origin, direction, hitFraction ) )
+			{
+				if ( hitFraction >= 0.0f && hitFraction < fraction ) {
+					pHitObject = pObject;
+					fraction = hitFraction;
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearest child first so that the farther one can be rejected early.
+		const Node & child1 = this->nodes[ node.child1 ];
+		const Node & child2 = this->nodes[ node.child2 ];
+
+		FLOAT t1 = MAX_SCENE_SIZE, t2 = MAX_SCENE_SIZE;
+		const bool bHit1 = RayIntersectsAABB( origin, invDir, child1.box, fraction, t1 );
+		const bool bHit2 = RayIntersectsAABB( origin, invDir, child2.box, fraction, t2 );
+
+		Assert( top + 2 <= MAX_STACK_DEPTH );
+		if( t1 < t2 ) {
+			if( bHit2 ) stack[ top++ ] = node.child2;
+			if( bHit1 ) stack[ top++ ] = node.child1;
+		} else {
+			if( bHit1 ) stack[ top++ ] = node.child1;
+			if( bHit2 ) stack[ top++ ] = node.child2;
+		}
+	}
+
+	return pHitObject;
+}
+
+bool mxSpatialDatabase_AABBTree::CastRay( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const
+{
+	Assert2( fraction == MAX_SCENE_SIZE, "fraction must be init'ed to 'infinity' on entering" );
+
+	return ( FindClosestHit( origin, direction, fraction ) != null );
+}
+
+mxEntity* mxSpatialDatabase_AABBTree::CastRay( const Vec3D& origin, const Vec3D& direction, Vec3D& hitPosition ) const
+{
+	FLOAT fraction = MAX_SCENE_SIZE;
+
+	mxSpatialProxy * pHitObject = FindClosestHit( origin, direction, fraction );
+
+	hitPosition = origin + direction * fraction;
+
+	if( pHitObject ) {
+		return pHitObject->GetOwner();
+	}
+	return null;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
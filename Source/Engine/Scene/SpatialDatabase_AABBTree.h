@@ -0,0 +1,161 @@
+/*
+=============================================================================
+	File:	SpatialDatabase_AABBTree.h
+	Desc:	Spatial database based on a dynamic AABB tree
+			(bounding volume hierarchy of axis-aligned boxes).
+=============================================================================
+*/
+
+#ifndef __MX_SCENE_COMPONENT_SPATIAL_DATABASE_AABB_TREE_H__
+#define __MX_SCENE_COMPONENT_SPATIAL_DATABASE_AABB_TREE_H__
+
+namespace abc {
+
+//
+//	mxSpatialDatabase_AABBTree
+//
+//	Dynamic bounding volume hierarchy.
+//	Each spatial proxy is stored in a leaf with a 'fat' AABB
+//	(the proxy's world bounds enlarged by a small margin),
+//	so that a proxy can move a bit without the tree being modified.
+//	Internal nodes are kept balanced with tree rotations,
+//	queries descend the tree hierarchically ( O(log N) on average ).
+//
+//	Proxies with infinite extents (e.g. directional lights)
+//	are kept in a separate list and are always considered.
+//
+class mxSpatialDatabase_AABBTree : public mxSpatialDatabase {
+public:
+			mxSpatialDatabase_AABBTree( FLOAT fatMargin = 0.1f );
+			~mxSpatialDatabase_AABBTree();
+
+	virtual void	Setup( mxScene& theParentScene );
+	virtual void	Close();
+
+	//
+	//	Query.
+	//
+	virtual void	TraceRay( const mxTraceInput& traceInput, mxTraceResult &OutTraceResult );
+
+	virtual void	GetEntitiesInPoint( const Vec3D& point, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesAlongLine( const Vec3D& start, const Vec3D& end, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesAlongRay( const Vec3D& origin, const Vec3D& direction, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesInBox( const Vec3D& min, const Vec3D& max, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesInSphere( const Vec3D& origin, FLOAT radius, mxEntityCache &OutEntities );
+
+	virtual mxEntity *	CastRay( const Vec3D& origin, const Vec3D& direction, Vec3D& hitPosition ) const;
+
+	//
+	// Visibility information and high-level culling.
+	//
+	virtual mxBool	IsPotentiallyVisible( const mxSceneView& rView, const mxSpatialProxy* obj ) const;
+	virtual void	GetVisibleSet( const mxSceneView& rView, mxVisibleSet &OutVisibleSet );
+
+	//
+	//	Override ( mxSceneComponent ) :
+	//
+	virtual void	Add( mxEntity* entity );
+	virtual void	Remove( mxEntity* entity );
+
+					// Refits the bounds of proxies that have moved
+					// and inserts unbounded proxies into the tree when their bounds become finite.
+	virtual void	Update( const mxTime deltaTime );
+
+	virtual void	Validate();
+
+	//
+	//	Override ( mxSpatialProxy ) :
+	//
+	void GetBoundsLocal( mxBounds & OutBounds ) const;
+	void GetBoundsWorld( mxBounds & OutBounds ) const;
+	bool CastRay( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const;
+
+	//
+	//	mxSpatialDatabase_AABBTree interface :
+	//
+
+					// Should be called when the world bounds of the given proxy have changed
+					// (can be used instead of waiting for the next Update()).
+	void	Refit( mxSpatialProxy* proxy );
+
+	mxUInt	GetNumProxies() const;
+	mxUInt	GetHeight() const;	// returns the height of the tree (0 if the tree is empty)
+
+private:
+	enum { NULL_NODE = -1 };
+
+	//
+	//	Node - a node of the tree. Leaf nodes hold references to spatial proxies.
+	//
+	struct Node
+	{
+		AABB	box;	// enlarged ('fat') AABB for leaves, union of children's boxes for internal nodes
+		AABB	bounds;	// exact world-space bounds of the proxy (only valid for leaves)
+
+		union {
+			INT32	parent;
+			INT32	next;	// next node in the free list
+		};
+		INT32	child1;
+		INT32	child2;
+
+		INT32	height;	// leaf = 0, free node = -1
+
+		mxSpatialProxy *	proxy;	// null for internal nodes
+
+	public:
+		bool IsLeaf() const { return (child1 == NULL_NODE); }
+	};
+
+	INT32	AllocateNode();
+	void	FreeNode( INT32 nodeId );
+
+	INT32	CreateProxy( mxSpatialProxy* proxy, const AABB& worldBounds );
+	void	DestroyProxy( INT32 leafId );
+	bool	MoveProxy( INT32 leafId, const AABB& worldBounds );
+
+	// Moves the proxy between the tree and the list of unbounded proxies when its bounds become finite or infinite.
+	void	RelocateProxy( mxSpatialProxy* proxy, const AABB& worldBounds );
+
+	void	InsertLeaf( INT32 leafId );
+	void	RemoveLeaf( INT32 leafId );
+
+	INT32	Balance( INT32 iA );
+
+	mxSpatialProxy *	FindClosestHit( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const;
+
+	void	AddSubtreeToVisibleSet( INT32 nodeId, mxVisibleSet &OutVisibleSet );
+
+	void	ValidateStructure( INT32 nodeId ) const;
+
+	static bool	IsUnbounded( const AABB& worldBounds );
+
+private:
+	TArray< Node >		nodes;			// node pool
+	INT32				root;
+	INT32				freeList;		// index of the first free node
+	mxUInt				numProxies;		// number of leaves in the tree
+
+	TArray< mxSpatialProxy* >	unbounded;	// proxies with infinite extents
+
+	mxCullingBatch		cullingBatch;	// leaves which must be tested against the view frustum
+
+	FLOAT		fatMargin;	// by how much leaf boxes are enlarged
+	mxBounds	bounds;
+};
+
+FORCEINLINE mxUInt mxSpatialDatabase_AABBTree::GetNumProxies() const {
+	return numProxies + unbounded.Num();
+}
+
+FORCEINLINE mxUInt mxSpatialDatabase_AABBTree::GetHeight() const {
+	return (root == NULL_NODE) ? 0 : nodes[ root ].height + 1;
+}
+
+} //end of namespace abc
+
+#endif // ! __MX_SCENE_COMPONENT_SPATIAL_DATABASE_AABB_TREE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -0,0 +1,893 @@
+/*
+=============================================================================
+	File:	SpatialDatabase_LooseOctree.cpp
+	Desc:	Spatial database based on a loose octree.
+	Note:	See "Loose Octrees" by Thatcher Ulrich (Game Programming Gems, 2000).
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <Engine.h>
+
+namespace abc {
+
+namespace {
+
+	//
+	//	Queries executed by mxSpatialDatabase_LooseOctree::Traverse().
+	//
+	//	IntersectsCell() is called to decide whether a cell (and all its children) should be visited,
+	//	VisitEntry() is called for each object in the visited cells.
+	//
+
+	struct PointQuery
+	{
+		const Vec3D &		point;
+		mxEntityCache &		result;
+
+		PointQuery( const Vec3D& p, mxEntityCache & r )
+			: point( p ), result( r )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			return looseBounds.ContainsPoint( point );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || bounds.ContainsPoint( point ) ) {
+				result.Append( proxy->GetOwner() );
+			}
+		}
+	};
+
+	struct BoxQuery
+	{
+		const AABB			box;
+		mxEntityCache &		result;
+
+		BoxQuery( const Vec3D& min, const Vec3D& max, mxEntityCache & r )
+			: box( min, max ), result( r )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			return looseBounds.IntersectsBounds( box );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || bounds.IntersectsBounds( box ) ) {
+				result.Append( proxy->GetOwner() );
+			}
+		}
+	};
+
+	struct SphereQuery
+	{
+		const Vec3D &		center;
+		const FLOAT			radius;
+		mxEntityCache &		result;
+
+		SphereQuery( const Vec3D& c, FLOAT r, mxEntityCache & res )
+			: center( c ), radius( r ), result( res )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			return SphereIntersectsAABB( center, radius, looseBounds );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || SphereIntersectsAABB( center, radius, bounds ) ) {
+				result.Append( proxy->GetOwner() );
+			}
+		}
+	};
+
+	struct LineQuery
+	{
+		const Vec3D &		start;
+		const Vec3D &		end;
+		mxEntityCache &		result;
+
+		LineQuery( const Vec3D& s, const Vec3D& e, mxEntityCache & r )
+			: start( s ), end( e ), result( r )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			return looseBounds.LineIntersection( start, end );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( !bUnbounded && bounds.LineIntersection( start, end ) ) {
+				result.Append( proxy->GetOwner() );
+			}
+		}
+	};
+
+	struct RayQuery
+	{
+		const Vec3D &		origin;
+		const Vec3D &		direction;
+		const Vec3D			invDir;
+		mxEntityCache &		result;
+
+		RayQuery( const Vec3D& o, const Vec3D& d, mxEntityCache & r )
+			: origin( o ), direction( d ), invDir( GetInverseRayDirection( d ) ), result( r )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			FLOAT entryFraction;
+			return RayIntersectsAABB( origin, invDir, looseBounds, MAX_SCENE_SIZE, entryFraction );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || !IntersectsCell( bounds ) ) {
+				return;
+			}
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if( proxy->CastRay( origin, direction, hitFraction ) && hitFraction >= 0.0f ) {
+				result.Append( proxy->GetOwner() );
+			}
+		}
+	};
+
+	struct TraceQuery
+	{
+		const Vec3D &		origin;
+		const Vec3D &		direction;
+		const Vec3D			invDir;
+		mxTraceResult &		result;
+
+		TraceQuery( const mxTraceInput& input, mxTraceResult & r )
+			: origin( input.GetStart() ), direction( input.GetDirection() )
+			, invDir( GetInverseRayDirection( input.GetDirection() ) ), result( r )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			FLOAT entryFraction;
+			return RayIntersectsAABB( origin, invDir, looseBounds, MAX_SCENE_SIZE, entryFraction );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || !IntersectsCell( bounds ) ) {
+				return;
+			}
+			mxEntity * entity = proxy->GetOwner();
+			if( !result.NeedsChecking( *entity ) ) {
+				return;
+			}
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if( proxy->CastRay( origin, direction, hitFraction ) && hitFraction >= 0.0f )
+			{
+				// NOTE: hit positions and normals are given in world space.
+				mxLocalRayResult  hit;
+				hit.m_entityHit		= entity;
+				hit.m_position		= origin + direction * hitFraction;
+				hit.m_normal		= GetClosestAABBFaceNormal( bounds, hit.m_position );
+				hit.m_hitFraction	= hitFraction;
+
+				result.AddSingleResult( hit );
+			}
+		}
+	};
+
+	struct ClosestHitQuery
+	{
+		const Vec3D &		origin;
+		const Vec3D &		direction;
+		const Vec3D			invDir;
+		FLOAT				fraction;	// closest hit so far
+		mxSpatialProxy *	hitObject;
+
+		ClosestHitQuery( const Vec3D& o, const Vec3D& d )
+			: origin( o ), direction( d ), invDir( GetInverseRayDirection( d ) )
+			, fraction( MAX_SCENE_SIZE ), hitObject( null )
+		{}
+		bool IntersectsCell( const AABB& looseBounds ) const
+		{
+			// skip cells which are farther than the closest hit
+			FLOAT entryFraction;
+			return RayIntersectsAABB( origin, invDir, looseBounds, fraction, entryFraction );
+		}
+		void VisitEntry( const AABB& bounds, mxSpatialProxy* proxy, bool bUnbounded )
+		{
+			if( bUnbounded || !(proxy->hitFilterMask & HM_Solid) || !IntersectsCell( bounds ) ) {
+				return;
+			}
+			FLOAT hitFraction = MAX_SCENE_SIZE;
+			if( proxy->CastRay( origin, direction, hitFraction )
+				&& hitFraction >= 0.0f && hitFraction < fraction )
+			{
+				fraction = hitFraction;
+				hitObject = proxy;
+			}
+		}
+	};
+
+}//end of anonymous namespace
+
+/*================================
+	mxSpatialDatabase_LooseOctree
+================================*/
+
+mxSpatialDatabase_LooseOctree::mxSpatialDatabase_LooseOctree( const mxBounds& worldBounds, mxUInt maxDepth )
+	: cells( 64 )
+	, entries( 256 )
+	, freeCells( NULL_INDEX )
+	, freeEntries( NULL_INDEX )
+	, overflowList( NULL_INDEX )
+	, numCells( 0 )
+	, numProxies( 0 )
+	, maxDepth( Min< mxUInt >( maxDepth, MAX_DEPTH ) )
+{
+	Assert( !IsUnbounded( worldBounds ) );
+
+	// Make the region covered by the octree cubic.
+	const Vec3D size( worldBounds.Size() );
+	const Vec3D center( worldBounds.GetCenter() );
+	const FLOAT halfSize = Max3( size.x, size.y, size.z ) * 0.5f;
+
+	this->worldSize = halfSize * 2.0f;
+	this->worldBox.Set( center - Vec3D( halfSize ), center + Vec3D( halfSize ) );
+
+	// Create the root cell.
+	const INT32 rootId = AllocateCell( NULL_INDEX, 0 );
+	Assert( rootId == ROOT_CELL );
+	(void) rootId;
+}
+
+mxSpatialDatabase_LooseOctree::~mxSpatialDatabase_LooseOctree()
+{
+}
+
+void mxSpatialDatabase_LooseOctree::Setup( mxScene& theParentScene )
+{
+	mxSpatialDatabase::Setup( theParentScene );
+}
+
+void mxSpatialDatabase_LooseOctree::Close()
+{
+	for( IndexT iEntry = 0; iEntry < this->entries.Num(); iEntry++ )
+	{
+		if( this->entries[ iEntry ].proxy ) {
+			this->entries[ iEntry ].proxy->spatialHandle = INDEX_NONE;
+		}
+	}
+	this->entries.Clear();
+	this->freeEntries = NULL_INDEX;
+	this->overflowList = NULL_INDEX;
+	this->numProxies = 0;
+
+	// Keep only the empty root cell.
+	this->cells.SetNum( 0, false );
+	this->freeCells = NULL_INDEX;
+	this->numCells = 0;
+	AllocateCell( NULL_INDEX, 0 );
+
+	mxSpatialDatabase::Close();
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::IsUnbounded
+//
+bool mxSpatialDatabase_LooseOctree::IsUnbounded( const AABB& worldBounds )
+{
+	for( INT i = 0; i < 3; i++ )
+	{
+		if( !( worldBounds.GetMin()[i] >= -MAX_SCENE_SIZE )
+			|| !( worldBounds.GetMax()[i] <= MAX_SCENE_SIZE ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::AllocateEntry
+//
+INT32 mxSpatialDatabase_LooseOctree::AllocateEntry()
+{
+	INT32 entryId = this->freeEntries;
+	if( entryId != NULL_INDEX ) {
+		this->freeEntries = this->entries[ entryId ].next;
+	} else {
+		entryId = this->entries.Num();
+		this->entries.Alloc();
+	}
+
+	Entry & entry = this->entries[ entryId ];
+	entry.proxy = null;
+	entry.cell = NULL_INDEX;
+	entry.prev = NULL_INDEX;
+	entry.next = NULL_INDEX;
+	entry.unbounded = false;
+
+	return entryId;
+}
+
+void mxSpatialDatabase_LooseOctree::FreeEntry( INT32 entryId )
+{
+	Entry & entry = this->entries[ entryId ];
+	entry.proxy = null;
+	entry.cell = NULL_INDEX;
+	entry.prev = NULL_INDEX;
+	entry.next = this->freeEntries;
+
+	this->freeEntries = entryId;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::AllocateCell
+//
+INT32 mxSpatialDatabase_LooseOctree::AllocateCell( INT32 parentId, UINT childIndex )
+{
+	INT32 cellId = this->freeCells;
+	if( cellId != NULL_INDEX ) {
+		this->freeCells = this->cells[ cellId ].next;
+	} else {
+		cellId = this->cells.Num();
+		this->cells.Alloc();
+	}
+
+	Cell & cell = this->cells[ cellId ];
+
+	if( parentId == NULL_INDEX )
+	{
+		cell.center = this->worldBox.GetCenter();
+		cell.halfSize = this->worldSize * 0.5f;
+		cell.depth = 0;
+	}
+	else
+	{
+		const Cell & parent = this->cells[ parentId ];
+		const FLOAT offset = parent.halfSize * 0.5f;
+
+		cell.center.x = parent.center.x + ( (childIndex & 1) ? offset : -offset );
+		cell.center.y = parent.center.y + ( (childIndex & 2) ? offset : -offset );
+		cell.center.z = parent.center.z + ( (childIndex & 4) ? offset : -offset );
+		cell.halfSize = offset;
+		cell.depth = parent.depth + 1;
+	}
+
+	// Loose bounds are twice as large as the cell.
+	const Vec3D looseHalfSize( cell.halfSize * 2.0f );
+	cell.looseBounds.Set( cell.center - looseHalfSize, cell.center + looseHalfSize );
+
+	cell.parent = parentId;
+	for( UINT i = 0; i < 8; i++ ) {
+		cell.children[i] = NULL_INDEX;
+	}
+	cell.firstEntry = NULL_INDEX;
+	cell.numEntries = 0;
+
+	if( parentId != NULL_INDEX ) {
+		this->cells[ parentId ].children[ childIndex ] = cellId;
+	}
+
+	this->numCells++;
+
+	return cellId;
+}
+
+void mxSpatialDatabase_LooseOctree::FreeCell( INT32 cellId )
+{
+	Assert( cellId != ROOT_CELL );
+
+	Cell & cell = this->cells[ cellId ];
+	Assert( cell.numEntries == 0 && cell.firstEntry == NULL_INDEX );
+
+	// Detach from the parent.
+	Cell & parent = this->cells[ cell.parent ];
+	for( UINT i = 0; i < 8; i++ ) {
+		if( parent.children[i] == cellId ) {
+			parent.children[i] = NULL_INDEX;
+			break;
+		}
+	}
+
+	cell.next = this->freeCells;
+	this->freeCells = cellId;
+
+	this->numCells--;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::GetDepthForSize
+//
+//	Returns the deepest level at which an object of the given size
+//	would fit into a cell regardless of where its center lies in the cell.
+//
+mxUInt mxSpatialDatabase_LooseOctree::GetDepthForSize( FLOAT radius ) const
+{
+	// An object fits at depth 'd' if its radius <= (cell size at depth 'd') / 2,
+	// i.e. d = floor( log2( worldSize / (2 * radius) ) ).
+	const FLOAT ratio = this->worldSize * 0.5f / radius;
+	if( ratio < 1.0f ) {
+		return 0;
+	}
+	const INT depth = mxMath::ILog2( ratio );
+	return Min< mxUInt >( depth, this->maxDepth );
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::FindCell
+//
+//	Returns NULL_INDEX if the given bounds don't fit into the octree
+//	or if the cell doesn't exist and 'bCreateMissing' is false.
+//
+INT32 mxSpatialDatabase_LooseOctree::FindCell( const AABB& bounds, bool bCreateMissing )
+{
+	const Vec3D center( bounds.GetCenter() );
+	const Vec3D halfSize( bounds.GetHalfSize() );
+	const FLOAT radius = Max3( halfSize.x, halfSize.y, halfSize.z );
+
+	if( !this->worldBox.ContainsPoint( center ) || radius > this->worldSize * 0.5f ) {
+		return NULL_INDEX;
+	}
+
+	const mxUInt depth = (radius > 0.0f) ? GetDepthForSize( radius ) : this->maxDepth;
+
+	// Integer coordinates of the cell at the selected depth.
+	const INT32 numCellsPerAxis = 1 << depth;
+	const FLOAT invCellSize = FLOAT( numCellsPerAxis ) / this->worldSize;
+	const Vec3D offset( center - this->worldBox.GetMin() );
+
+	const INT32 ix = Clamp< INT32 >( INT32( offset.x * invCellSize ), 0, numCellsPerAxis - 1 );
+	const INT32 iy = Clamp< INT32 >( INT32( offset.y * invCellSize ), 0, numCellsPerAxis - 1 );
+	const INT32 iz = Clamp< INT32 >( INT32( offset.z * invCellSize ), 0, numCellsPerAxis - 1 );
+
+	// Walk down from the root creating missing cells
+	// (the depth is bounded by 'maxDepth', so this takes constant time).
+	INT32 cellId = ROOT_CELL;
+	for( mxUInt level = 1; level <= depth; level++ )
+	{
+		const INT32 shift = depth - level;
+		const UINT childIndex =
+			( (ix >> shift) & 1 )
+			| ( ((iy >> shift) & 1) << 1 )
+			| ( ((iz >> shift) & 1) << 2 );
+
+		const INT32 childId = this->cells[ cellId ].children[ childIndex ];
+		if( childId != NULL_INDEX ) {
+			cellId = childId;
+		} else if( bCreateMissing ) {
+			cellId = AllocateCell( cellId, childIndex );
+		} else {
+			return NULL_INDEX;
+		}
+	}
+
+	return cellId;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::LinkEntry
+//
+void mxSpatialDatabase_LooseOctree::LinkEntry( INT32 entryId, INT32 cellId )
+{
+	Entry & entry = this->entries[ entryId ];
+
+	INT32 & listHead = ( cellId != NULL_INDEX ) ? this->cells[ cellId ].firstEntry : this->overflowList;
+
+	entry.cell = cellId;
+	entry.prev = NULL_INDEX;
+	entry.next = listHead;
+	if( listHead != NULL_INDEX ) {
+		this->entries[ listHead ].prev = entryId;
+	}
+	listHead = entryId;
+
+	// Update object counts.
+	while( cellId != NULL_INDEX )
+	{
+		Cell & cell = this->cells[ cellId ];
+		cell.numEntries++;
+		cellId = cell.parent;
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::UnlinkEntry
+//
+void mxSpatialDatabase_LooseOctree::UnlinkEntry( INT32 entryId )
+{
+	Entry & entry = this->entries[ entryId ];
+
+	INT32 cellId = entry.cell;
+	INT32 & listHead = ( cellId != NULL_INDEX ) ? this->cells[ cellId ].firstEntry : this->overflowList;
+
+	if( entry.prev != NULL_INDEX ) {
+		this->entries[ entry.prev ].next = entry.next;
+	} else {
+		listHead = entry.next;
+	}
+	if( entry.next != NULL_INDEX ) {
+		this->entries[ entry.next ].prev = entry.prev;
+	}
+
+	entry.cell = NULL_INDEX;
+	entry.prev = NULL_INDEX;
+	entry.next = NULL_INDEX;
+
+	// Update object counts and release empty cells.
+	while( cellId != NULL_INDEX )
+	{
+		Cell & cell = this->cells[ cellId ];
+		const INT32 parentId = cell.parent;
+
+		Assert( cell.numEntries > 0 );
+		cell.numEntries--;
+
+		if( cell.numEntries == 0 && cellId != ROOT_CELL ) {
+			FreeCell( cellId );
+		}
+		cellId = parentId;
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Relocate
+//
+void mxSpatialDatabase_LooseOctree::Relocate( INT32 entryId, const AABB& newBounds )
+{
+	Entry & entry = this->entries[ entryId ];
+	entry.bounds = newBounds;
+	entry.unbounded = IsUnbounded( newBounds );
+
+	// Most moving objects stay in their cells.
+	if( entry.cell != NULL_INDEX && !entry.unbounded
+		&& FindCell( newBounds, false ) == entry.cell )
+	{
+		return;
+	}
+
+	// The entry is unlinked before the new cell is created, because unlinking
+	// releases cells which become empty (they can be ancestors of the new cell).
+	UnlinkEntry( entryId );
+
+	const INT32 newCell = entry.unbounded ? NULL_INDEX : FindCell( newBounds, true );
+	LinkEntry( entryId, newCell );
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Add
+//
+void mxSpatialDatabase_LooseOctree::Add( mxEntity* entity )
+{
+	AssertPtr( entity );
+
+	mxSpatialProxy * spatialProxy = entity->GetSpatialProxy();
+	if( !spatialProxy ) {
+		return;
+	}
+	Assert2( spatialProxy->spatialHandle == INDEX_NONE, "the proxy has already been added" );
+
+	const INT32 entryId = AllocateEntry();
+
+	Entry & entry = this->entries[ entryId ];
+	entry.proxy = spatialProxy;
+	spatialProxy->GetBoundsWorld( entry.bounds );
+	entry.unbounded = IsUnbounded( entry.bounds );
+
+	const INT32 cellId = entry.unbounded ? NULL_INDEX : FindCell( entry.bounds, true );
+	LinkEntry( entryId, cellId );
+
+	spatialProxy->spatialHandle = entryId;
+
+	this->numProxies++;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Remove
+//
+void mxSpatialDatabase_LooseOctree::Remove( mxEntity* entity )
+{
+	AssertPtr( entity );
+
+	mxSpatialProxy * spatialProxy = entity->GetSpatialProxy();
+	if( !spatialProxy || spatialProxy->spatialHandle == INDEX_NONE ) {
+		return;
+	}
+
+	const INT32 entryId = spatialProxy->spatialHandle;
+	Assert( this->entries[ entryId ].proxy == spatialProxy );
+
+	UnlinkEntry( entryId );
+	FreeEntry( entryId );
+
+	spatialProxy->spatialHandle = INDEX_NONE;
+
+	this->numProxies--;
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Refit
+//
+void mxSpatialDatabase_LooseOctree::Refit( mxSpatialProxy* proxy )
+{
+	AssertPtr( proxy );
+	if( proxy->spatialHandle == INDEX_NONE ) {
+		return;
+	}
+
+	mxBounds  worldBounds;
+	proxy->GetBoundsWorld( worldBounds );
+
+	if( worldBounds != this->entries[ proxy->spatialHandle ].bounds ) {
+		Relocate( proxy->spatialHandle, worldBounds );
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Update
+//
+void mxSpatialDatabase_LooseOctree::Update( const mxTime deltaTime )
+{
+	MX_PROFILE("Loose octree: relocate");
+
+	mxSpatialDatabase::Update( deltaTime );
+
+	// Only the proxies which have moved since the last tick are relocated.
+	for( IndexT iEntry = 0; iEntry < this->entries.Num(); iEntry++ )
+	{
+		mxSpatialProxy * proxy = this->entries[ iEntry ].proxy;
+		if( !proxy ) {
+			continue;	// free entry
+		}
+
+		mxBounds  worldBounds;
+		proxy->GetBoundsWorld( worldBounds );
+
+		if( worldBounds != this->entries[ iEntry ].bounds ) {
+			Relocate( iEntry, worldBounds );
+		}
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Validate
+//
+void mxSpatialDatabase_LooseOctree::Validate()
+{
+	mxSpatialDatabase::Validate();
+
+	ValidateCell_R( ROOT_CELL );
+
+	mxUInt numOverflow = 0;
+	for( INT32 e = this->overflowList; e != NULL_INDEX; e = this->entries[ e ].next ) {
+		Assert( this->entries[ e ].cell == NULL_INDEX );
+		++numOverflow;
+	}
+	Assert( this->cells[ ROOT_CELL ].numEntries + numOverflow == this->numProxies );
+}
+
+void mxSpatialDatabase_LooseOctree::ValidateCell_R( INT32 cellId ) const
+{
+	const Cell & cell = this->cells[ cellId ];
+
+	mxUInt count = 0;
+	for( INT32 e = cell.firstEntry; e != NULL_INDEX; e = this->entries[ e ].next )
+	{
+		const Entry & entry = this->entries[ e ];
+		Assert( entry.cell == cellId );
+		Assert( entry.proxy && entry.proxy->spatialHandle == e );
+		Assert( cell.looseBounds.Contains( entry.bounds ) );
+		++count;
+	}
+	for( UINT i = 0; i < 8; i++ )
+	{
+		const INT32 childId = cell.children[i];
+		if( childId != NULL_INDEX ) {
+			Assert( this->cells[ childId ].parent == cellId );
+			Assert( this->cells[ childId ].numEntries > 0 );
+			count += this->cells[ childId ].numEntries;
+			ValidateCell_R( childId );
+		}
+	}
+	Assert( count == cell.numEntries );
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Traverse_R
+//
+template< class QUERY >
+void mxSpatialDatabase_LooseOctree::Traverse_R( INT32 cellId, QUERY & query ) const
+{
+	const Cell & cell = this->cells[ cellId ];
+
+	if( !query.IntersectsCell( cell.looseBounds ) ) {
+		return;
+	}
+
+	for( INT32 e = cell.firstEntry; e != NULL_INDEX; e = this->entries[ e ].next )
+	{
+		const Entry & entry = this->entries[ e ];
+		query.VisitEntry( entry.bounds, entry.proxy, false );
+	}
+
+	for( UINT i = 0; i < 8; i++ )
+	{
+		if( cell.children[i] != NULL_INDEX ) {
+			Traverse_R( cell.children[i], query );
+		}
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::Traverse
+//
+template< class QUERY >
+void mxSpatialDatabase_LooseOctree::Traverse( QUERY & query ) const
+{
+	if( this->cells[ ROOT_CELL ].numEntries > 0 ) {
+		Traverse_R( ROOT_CELL, query );
+	}
+
+	// Objects outside the octree are tested individually.
+	for( INT32 e = this->overflowList; e != NULL_INDEX; e = this->entries[ e ].next )
+	{
+		const Entry & entry = this->entries[ e ];
+		query.VisitEntry( entry.bounds, entry.proxy, entry.unbounded );
+	}
+}
+
+void mxSpatialDatabase_LooseOctree::TraceRay( const mxTraceInput& traceInput, mxTraceResult &OutTraceResult )
+{
+	Assert( traceInput.GetDirection().IsNormalized() );
+	TraceQuery  query( traceInput, OutTraceResult );
+	Traverse( query );
+}
+
+void mxSpatialDatabase_LooseOctree::GetEntitiesInPoint( const Vec3D& point, mxEntityCache &OutEntities )
+{
+	PointQuery  query( point, OutEntities );
+	Traverse( query );
+}
+
+void mxSpatialDatabase_LooseOctree::GetEntitiesAlongLine( const Vec3D& start, const Vec3D& end, mxEntityCache &OutEntities )
+{
+	LineQuery  query( start, end, OutEntities );
+	Traverse( query );
+}
+
+void mxSpatialDatabase_LooseOctree::GetEntitiesAlongRay( const Vec3D& origin, const Vec3D& direction, mxEntityCache &OutEntities )
+{
+	Assert( direction.IsNormalized() );
+	RayQuery  query( origin, direction, OutEntities );
+	Traverse( query );
+}
+
+void mxSpatialDatabase_LooseOctree::GetEntitiesInBox( const Vec3D& min, const Vec3D& max, mxEntityCache &OutEntities )
+{
+	BoxQuery  query( min, max, OutEntities );
+	Traverse( query );
+}
+
+void mxSpatialDatabase_LooseOctree::GetEntitiesInSphere( const Vec3D& origin, FLOAT radius, mxEntityCache &OutEntities )
+{
+	Assert( radius >= 0.0f );
+	SphereQuery  query( origin, radius, OutEntities );
+	Traverse( query );
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::IsPotentiallyVisible
+//
+mxBool mxSpatialDatabase_LooseOctree::IsPotentiallyVisible( const mxSceneView& view, const mxSpatialProxy* obj ) const
+{
+	if( obj->spatialHandle != INDEX_NONE )
+	{
+		const Entry & entry = this->entries[ obj->spatialHandle ];
+		return entry.unbounded || view.GetFrustum().IntersectsAABB( entry.bounds );
+	}
+	Sphere  s;
+	obj->GetBoundingSphereWorld( s );
+	return view.GetFrustum().IntersectSphere( s );
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::GetVisibleSet_R
+//
+void mxSpatialDatabase_LooseOctree::GetVisibleSet_R( INT32 cellId, const mxViewFrustum& frustum,
+	bool bFullyInside, mxVisibleSet &OutVisibleSet )
+{
+	const Cell & cell = this->cells[ cellId ];
+
+	if( !bFullyInside )
+	{
+		// Reject whole cells (along with all their children).
+		const ESpatialRelation relation = frustum.Classify( cell.looseBounds );
+		if( relation == ESpatialRelation::Outside ) {
+			return;
+		}
+		bFullyInside = ( relation == ESpatialRelation::Inside );
+	}
+
+	// Objects in cells which intersect the frustum are tested in batches.
+	for( INT32 e = cell.firstEntry; e != NULL_INDEX; e = this->entries[ e ].next )
+	{
+		const Entry & entry = this->entries[ e ];
+		if( bFullyInside ) {
+			OutVisibleSet.Add( entry.proxy->GetOwner() );
+		} else {
+			this->cullingBatch.Add( entry.bounds, entry.proxy );
+		}
+	}
+
+	for( UINT i = 0; i < 8; i++ )
+	{
+		if( cell.children[i] != NULL_INDEX ) {
+			GetVisibleSet_R( cell.children[i], frustum, bFullyInside, OutVisibleSet );
+		}
+	}
+}
+
+//
+//	mxSpatialDatabase_LooseOctree::GetVisibleSet
+//
+void mxSpatialDatabase_LooseOctree::GetVisibleSet( const mxSceneView& view, mxVisibleSet &OutVisibleSet )
+{
+	// Clear the output visible set first.
+	OutVisibleSet.Empty();
+
+	const mxViewFrustum & frustum = view.GetFrustum();
+
+	if( this->cells[ ROOT_CELL ].numEntries > 0 ) {
+		GetVisibleSet_R( ROOT_CELL, frustum, false, OutVisibleSet );
+	}
+
+	for( INT32 e = this->overflowList; e != NULL_INDEX; e = this->entries[ e ].next )
+	{
+		const Entry & entry = this->entries[ e ];
+		if( entry.unbounded ) {
+			OutVisibleSet.Add( entry.proxy->GetOwner() );
+		} else {
+			this->cullingBatch.Add( entry.bounds, entry.proxy );
+		}
+	}
+
+	this->cullingBatch.Flush( frustum, OutVisibleSet );
+}
+
+void mxSpatialDatabase_LooseOctree::GetBoundsLocal( mxBounds & OutBounds ) const
+{
+	OutBounds = this->worldBox;
+}
+
+void mxSpatialDatabase_LooseOctree::GetBoundsWorld( mxBounds & OutBounds ) const
+{
+	OutBounds = this->worldBox;
+}
+
+bool mxSpatialDatabase_LooseOctree::CastRay( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const
+{
+	Assert( direction.IsNormalized() );
+	Assert2( fraction == MAX_SCENE_SIZE, "fraction must be init'ed to 'infinity' on entering" );
+
+	ClosestHitQuery  query( origin, direction );
+	Traverse( query );
+
+	fraction = query.fraction;
+	return ( query.hitObject != null );
+}
+
+mxEntity* mxSpatialDatabase_LooseOctree::CastRay( const Vec3D& origin, const Vec3D& direction, Vec3D& hitPosition ) const
+{
+	Assert( direction.IsNormalized() );
+
+	ClosestHitQuery  query( origin, direction );
+	Traverse( query );
+
+	hitPosition = origin + direction * query.fraction;
+
+	if( query.hitObject ) {
+		return query.hitObject->GetOwner();
+	}
+	return null;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
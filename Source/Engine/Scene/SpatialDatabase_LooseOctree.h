@@ -0,0 +1,182 @@
+/*
+=============================================================================
+	File:	SpatialDatabase_LooseOctree.h
+	Desc:	Spatial database based on a loose octree,
+			suited for scenes with many moving objects.
+=============================================================================
+*/
+
+#ifndef __MX_SCENE_COMPONENT_SPATIAL_DATABASE_LOOSE_OCTREE_H__
+#define __MX_SCENE_COMPONENT_SPATIAL_DATABASE_LOOSE_OCTREE_H__
+
+namespace abc {
+
+//
+//	mxSpatialDatabase_LooseOctree
+//
+//	Loose octree (looseness factor = 2, i.e. each cell's bounds
+//	are twice as large as the cell it encloses).
+//
+//	The depth at which a proxy is stored depends only on its size
+//	and the cell is selected by its center, so insertion and relocation
+//	take constant time (cells are created on demand and released when they become empty).
+//	No rebuilding or refitting is ever needed, only the proxies
+//	whose world bounds have changed since the last update are relocated.
+//
+//	Proxies which don't fit into the world bounds (or have infinite extents)
+//	are stored in a separate list and are tested individually.
+//
+class mxSpatialDatabase_LooseOctree : public mxSpatialDatabase {
+public:
+			mxSpatialDatabase_LooseOctree( const mxBounds& worldBounds, mxUInt maxDepth = 6 );
+			~mxSpatialDatabase_LooseOctree();
+
+	virtual void	Setup( mxScene& theParentScene );
+	virtual void	Close();
+
+	//
+	//	Query.
+	//
+	virtual void	TraceRay( const mxTraceInput& traceInput, mxTraceResult &OutTraceResult );
+
+	virtual void	GetEntitiesInPoint( const Vec3D& point, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesAlongLine( const Vec3D& start, const Vec3D& end, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesAlongRay( const Vec3D& origin, const Vec3D& direction, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesInBox( const Vec3D& min, const Vec3D& max, mxEntityCache &OutEntities );
+	virtual void	GetEntitiesInSphere( const Vec3D& origin, FLOAT radius, mxEntityCache &OutEntities );
+
+	virtual mxEntity *	CastRay( const Vec3D& origin, const Vec3D& direction, Vec3D& hitPosition ) const;
+
+	//
+	// Visibility information and high-level culling.
+	//
+	virtual mxBool	IsPotentiallyVisible( const mxSceneView& rView, const mxSpatialProxy* obj ) const;
+	virtual void	GetVisibleSet( const mxSceneView& rView, mxVisibleSet &OutVisibleSet );
+
+	//
+	//	Override ( mxSceneComponent ) :
+	//
+	virtual void	Add( mxEntity* entity );
+	virtual void	Remove( mxEntity* entity );
+
+					// Relocates the proxies whose world bounds have changed.
+	virtual void	Update( const mxTime deltaTime );
+
+	virtual void	Validate();
+
+	//
+	//	Override ( mxSpatialProxy ) :
+	//
+	void GetBoundsLocal( mxBounds & OutBounds ) const;
+	void GetBoundsWorld( mxBounds & OutBounds ) const;
+	bool CastRay( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const;
+
+	//
+	//	mxSpatialDatabase_LooseOctree interface :
+	//
+
+					// Should be called when the world bounds of the given proxy have changed
+					// (can be used instead of waiting for the next Update()).
+	void	Refit( mxSpatialProxy* proxy );
+
+	mxUInt	GetNumProxies() const;
+	mxUInt	GetNumCells() const;	// returns the number of currently allocated cells
+
+private:
+	enum {
+		NULL_INDEX	= -1,
+		ROOT_CELL	= 0,
+		MAX_DEPTH	= 10,
+	};
+
+	//
+	//	Cell - a node of the octree.
+	//
+	struct Cell
+	{
+		AABB	looseBounds;	// enlarged bounds, all objects in this cell are contained inside
+		Vec3D	center;			// center of the (tight) cell
+		FLOAT	halfSize;		// half size of the (tight) cell
+
+		union {
+			INT32	parent;
+			INT32	next;		// next cell in the free list
+		};
+		INT32	children[8];	// NULL_INDEX if the child doesn't exist
+		INT32	firstEntry;		// linked list of objects in this cell
+		mxUInt	numEntries;		// total number of objects in this cell and all its children
+		mxUInt	depth;
+	};
+
+	//
+	//	Entry - a spatial proxy stored in the octree.
+	//
+	struct Entry
+	{
+		AABB				bounds;		// world-space bounds of the proxy
+		mxSpatialProxy *	proxy;		// null for free entries
+		INT32				cell;		// NULL_INDEX if the entry is stored in the overflow list
+		INT32				prev;
+		INT32				next;		// next entry in the cell's list (or in the free list)
+		bool				unbounded;	// true if the proxy has infinite extents
+	};
+
+	INT32	AllocateEntry();
+	void	FreeEntry( INT32 entryId );
+
+	INT32	AllocateCell( INT32 parentId, UINT childIndex );
+	void	FreeCell( INT32 cellId );
+
+	mxUInt	GetDepthForSize( FLOAT radius ) const;
+	INT32	FindCell( const AABB& bounds, bool bCreateMissing );
+
+	void	LinkEntry( INT32 entryId, INT32 cellId );
+	void	UnlinkEntry( INT32 entryId );
+
+	void	Relocate( INT32 entryId, const AABB& newBounds );
+
+	template< class QUERY >
+	void	Traverse_R( INT32 cellId, QUERY & query ) const;
+
+	template< class QUERY >
+	void	Traverse( QUERY & query ) const;
+
+	void	GetVisibleSet_R( INT32 cellId, const mxViewFrustum& frustum, bool bFullyInside, mxVisibleSet &OutVisibleSet );
+
+	void	ValidateCell_R( INT32 cellId ) const;
+
+	static bool	IsUnbounded( const AABB& worldBounds );
+
+private:
+	TArray< Cell >		cells;
+	TArray< Entry >		entries;
+
+	INT32		freeCells;
+	INT32		freeEntries;
+	INT32		overflowList;	// objects which don't fit into the octree
+
+	mxUInt		numCells;
+	mxUInt		numProxies;
+
+	AABB		worldBox;		// cubic region covered by the octree
+	FLOAT		worldSize;		// length of the cube side
+	mxUInt		maxDepth;
+
+	mxCullingBatch	cullingBatch;	// objects which must be tested against the view frustum
+};
+
+FORCEINLINE mxUInt mxSpatialDatabase_LooseOctree::GetNumProxies() const {
+	return numProxies;
+}
+
+FORCEINLINE mxUInt mxSpatialDatabase_LooseOctree::GetNumCells() const {
+	return numCells;
+}
+
+} //end of namespace abc
+
+#endif // ! __MX_SCENE_COMPONENT_SPATIAL_DATABASE_LOOSE_OCTREE_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
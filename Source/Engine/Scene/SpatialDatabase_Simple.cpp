@@ -18,6 +18,7 @@ namespace abc {
 
 mxSpatialDatabase_Simple::mxSpatialDatabase_Simple()
 	: bounds( mxBounds::INFINITE_EXTENT )
+	, bSpheresDirty( false )
 {
 }
 
@@ -35,6 +36,11 @@ void mxSpatialDatabase_Simple::Setup( mxScene& theParentScene )
 
 void mxSpatialDatabase_Simple::Close()
 {
+	this->objects.Clear();
+	this->spheres.Clear();
+	this->visibilityMask.Clear();
+	this->bSpheresDirty = false;
+
 	mxSpatialDatabase::Close();
 }
 
@@ -140,17 +146,75 @@ void mxSpatialDatabase_Simple::GetVisibleSet( const mxSceneView& view, mxVisible
 	// Clear the output visible set first.
 	OutVisibleSet.Empty();
 
+	if ( this->bSpheresDirty ) {
+		UpdateBoundingSpheres();
+	}
+	Assert( this->spheres.Num() == this->objects.Num() );
+
 	// Find all (potentially) visible objects.
-	for ( IndexT iObject = 0; iObject < this->objects.Num(); iObject++ )
 	{
-		mxSpatialProxy * pObject = this->objects[ iObject ];
+		MX_PROFILE("Batch culling");
+		this->visibilityMask.SetNum( GetVisibilityMaskSize( this->spheres.Num() ), false );
+		view.GetFrustum().CullSpheres( this->spheres, this->visibilityMask.Ptr() );
+	}
 
-		if ( IsPotentiallyVisible( view, pObject ) ) {
-			OutVisibleSet.Add( pObject->GetOwner() );
+	for ( IndexT iWord = 0; iWord < this->visibilityMask.Num(); iWord++ )
+	{
+		UDWORD bits = this->visibilityMask[ iWord ];
+
+		// Skips the remaining bits as soon as they are all zero.
+		for ( IndexT iObject = iWord << 5; bits; iObject++, bits >>= 1 )
+		{
+			if ( bits & 1 ) {
+				OutVisibleSet.Add( this->objects[ iObject ]->GetOwner() );
+			}
 		}
 	}
 }
 
+void mxSpatialDatabase_Simple::Update( const mxTime deltaTime )
+{
+	mxSpatialDatabase::Update( deltaTime );
+
+	UpdateBoundingSpheres();
+}
+
+//
+//	mxSpatialDatabase_Simple::UpdateBoundingSpheres
+//
+void mxSpatialDatabase_Simple::UpdateBoundingSpheres()
+{
+	MX_PROFILE("Update bounding spheres");
+
+	this->spheres.SetNum( this->objects.Num() );
+
+	for ( IndexT iObject = 0; iObject < this->objects.Num(); iObject++ )
+	{
+		Sphere  s;
+		this->objects[ iObject ]->GetBoundingSphereWorld( s );
+		this->spheres.Set( iObject, s );
+	}
+
+	this->bSpheresDirty = false;
+}
+
+//
+//	mxSpatialDatabase_Simple::Refit
+//
+void mxSpatialDatabase_Simple::Refit( mxSpatialProxy* proxy )
+{
+	AssertPtr( proxy );
+
+	mxUInt  index;
+	if ( this->bSpheresDirty || ! this->objects.FindIndex( proxy, index ) ) {
+		return;	// all the spheres will be rebuilt anyway
+	}
+
+	Sphere  s;
+	proxy->GetBoundingSphereWorld( s );
+	this->spheres.Set( index, s );
+}
+
 void mxSpatialDatabase_Simple::Add( mxEntity* entity )
 {
 	AssertPtr( entity );
@@ -165,6 +229,10 @@ void mxSpatialDatabase_Simple::Add( mxEntity* entity )
 	if ( mxSpatialProxy* spatialProxy = entity->GetSpatialProxy() )
 	{
 		this->objects.Append( spatialProxy );
+
+		Sphere  s;
+		spatialProxy->GetBoundingSphereWorld( s );
+		this->spheres.Add( s );
 	}
 #endif
 }
@@ -172,14 +240,15 @@ void mxSpatialDatabase_Simple::Add( mxEntity* entity )
 void mxSpatialDatabase_Simple::Remove( mxEntity* entity )
 {
 	AssertPtr( entity );
-	Unimplemented;
-	//TComponentPtr ptr( entity->FindComponent( mxSpatialProxy::Type ) );
-	//if ( ptr.IsValid() )
-	//{
-	//	mxSpatialProxy * spatialProxy = checked_cast< mxSpatialProxy*, mxEntityComponent* >( ptr );
-	//	const bool bRemoved = this->objects.Remove( spatialProxy );
-	//	Assert( bRemoved );
-	//}
+	if ( mxSpatialProxy* spatialProxy = entity->GetSpatialProxy() )
+	{
+		const bool bRemoved = this->objects.Remove( spatialProxy );
+		Assert( bRemoved );
+		(void) bRemoved;
+
+		// The spheres are rebuilt before the next culling.
+		this->bSpheresDirty = true;
+	}
 }
 
 void mxSpatialDatabase_Simple::GetBoundsLocal( mxBounds & OutBounds ) const
@@ -18,6 +18,9 @@ namespace abc {
 //	All entities are processed sequentially.
 //	(Uses view frustum culling only.)
 //
+//	Bounding spheres of the objects are cached in SoA layout
+//	(they are refreshed in Update() or by Refit()) and culled in batches.
+//
 class mxSpatialDatabase_Simple : public mxSpatialDatabase {
 public:
 			mxSpatialDatabase_Simple();
@@ -51,6 +54,9 @@ public:
 	virtual void	Add( mxEntity* entity );
 	virtual void	Remove( mxEntity* entity );
 
+					// Refreshes the cached bounding spheres.
+	virtual void	Update( const mxTime deltaTime );
+
 	//
 	//	Override ( mxSpatialProxy ) :
 	//
@@ -58,9 +64,24 @@ public:
 	void GetBoundsWorld( mxBounds & OutBounds ) const;
 	bool CastRay( const Vec3D& origin, const Vec3D& direction, FLOAT &fraction ) const;
 
+	//
+	//	mxSpatialDatabase_Simple interface :
+	//
+
+					// Should be called when the world bounds of the given proxy have changed
+					// (can be used instead of waiting for the next Update()).
+	void	Refit( mxSpatialProxy* proxy );
+
+private:
+	void	UpdateBoundingSpheres();
+
 private:
 	TArray< mxSpatialProxy* >	objects;
 	mxBounds					bounds;
+
+	mxSphereSoA			spheres;			// world-space bounding spheres of the objects
+	TArray< UDWORD >	visibilityMask;		// used during culling
+	bool				bSpheresDirty;		// true if the spheres should be updated before culling
 };
 
 } //end of namespace abc
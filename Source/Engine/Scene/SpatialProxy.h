@@ -21,6 +21,10 @@ class mxSpatialProxy : public mxEntityComponent
 public:
 	UINT32		hitFilterMask;	// bits from EHitMask
 
+	// Internal handle used by the spatial database this proxy was inserted into
+	// (e.g. index of the tree leaf). INDEX_NONE if not inserted.
+	INT32		spatialHandle;
+
 public:
 
 	// Returns the extent of the object in local space.
@@ -64,7 +68,7 @@ public:
 	// Work in progress...
 
 protected:
-	mxSpatialProxy() : hitFilterMask(0) {}
+	mxSpatialProxy() : hitFilterMask(0), spatialHandle(INDEX_NONE) {}
 	virtual	~mxSpatialProxy() {}
 };
 
@@ -11,12 +11,64 @@
 
 namespace abc {
 
+/*================================
+		mxCullingBatch
+================================*/
+
+mxCullingBatch::mxCullingBatch()
+	: boxes( 256 )
+	, proxies( 256 )
+	, visibilityMask( 16 )
+{
+}
+
+void mxCullingBatch::Add( const AABB& bounds, mxSpatialProxy* proxy )
+{
+	this->boxes.Add( bounds );
+	this->proxies.Append( proxy );
+}
+
+void mxCullingBatch::Flush( const mxViewFrustum& frustum, mxVisibleSet &OutVisibleSet )
+{
+	Assert( this->boxes.Num() == this->proxies.Num() );
+
+	if ( this->proxies.Num() == 0 ) {
+		return;
+	}
+
+	{
+		MX_PROFILE("Batch culling");
+		this->visibilityMask.SetNum( GetVisibilityMaskSize( this->boxes.Num() ), false );
+		frustum.CullBoxes( this->boxes, this->visibilityMask.Ptr() );
+	}
+
+	for ( IndexT iWord = 0; iWord < this->visibilityMask.Num(); iWord++ )
+	{
+		UDWORD bits = this->visibilityMask[ iWord ];
+
+		// Skips the remaining bits as soon as they are all zero.
+		for ( IndexT iProxy = iWord << 5; bits; iProxy++, bits >>= 1 )
+		{
+			if ( bits & 1 ) {
+				OutVisibleSet.Add( this->proxies[ iProxy ]->GetOwner() );
+			}
+		}
+	}
+
+	this->boxes.Empty();
+	this->proxies.SetNum( 0, false );
+}
+
 /*================================
 	mxTraceResult_ClosestHit
 ================================*/
 
 mxTraceResult_ClosestHit::mxTraceResult_ClosestHit()
 {
+	m_result.m_entityHit = null;
+	m_result.m_position.SetZero();
+	m_result.m_normal.SetZero();
+	m_result.m_hitFraction = MAX_SCENE_SIZE;
 }
 
 mxLocalRayResult & mxTraceResult_ClosestHit::GetResult()
@@ -26,11 +78,14 @@ mxLocalRayResult & mxTraceResult_ClosestHit::GetResult()
 
 bool mxTraceResult_ClosestHit::HasHit() const
 {
-	return false;
+	return ( m_result.m_entityHit != null );
 }
 
 void mxTraceResult_ClosestHit::AddSingleResult( mxLocalRayResult& newResult )
 {
+	if ( newResult.m_hitFraction < m_result.m_hitFraction ) {
+		m_result = newResult;
+	}
 }
 
 }//End of namespace abc
@@ -26,6 +26,9 @@ class mxEntity;
 class mxTraceInput;
 class mxTraceResult;
 
+class mxSpatialProxy;
+class mxVisibleSet;
+
 //
 //	mxTraceInput
 //
@@ -96,6 +99,112 @@ private:
 	mxLocalRayResult	m_result;
 };
 
+//
+//	mxCullingBatch - collects bounding boxes which have to be tested against the view frustum
+//	and tests them all at once with mxViewFrustum::CullBoxes().
+//
+//	Used by spatial databases for testing the objects in the nodes which intersect the frustum.
+//
+class mxCullingBatch {
+public:
+			mxCullingBatch();
+
+	void	Add( const AABB& bounds, mxSpatialProxy* proxy );
+
+			// Adds the owners of visible proxies to the visible set and empties the batch.
+	void	Flush( const mxViewFrustum& frustum, mxVisibleSet &OutVisibleSet );
+
+private:
+	mxAABBSoA					boxes;
+	TArray< mxSpatialProxy* >	proxies;
+	TArray< UDWORD >			visibilityMask;
+};
+
+//
+//	Helpers for hierarchical spatial queries.
+//
+
+// Returns the reciprocal of the ray direction which is used for fast ray-box tests.
+// Zero components are replaced with large values to avoid producing NaNs.
+//
+FORCEINLINE Vec3D GetInverseRayDirection( const Vec3D& direction )
+{
+	const FLOAT BIG_NUMBER = 1e30f;
+	Vec3D  invDir;
+	for( INT i = 0; i < 3; i++ ) {
+		invDir[i] = ( mxMath::Fabs( direction[i] ) > 1e-20f )
+			? ( 1.0f / direction[i] )
+			: ( (direction[i] < 0.0f) ? -BIG_NUMBER : BIG_NUMBER );
+	}
+	return invDir;
+}
+
+// Slab test. Returns true if the ray (origin + dir * t, 0 <= t <= maxFraction)
+// hits the given box; 'OutFraction' receives the fraction at the entry point.
+//
+FORCEINLINE bool RayIntersectsAABB( const Vec3D& origin, const Vec3D& invDir, const AABB& box,
+								   FLOAT maxFraction, FLOAT &OutFraction )
+{
+	FLOAT tmin = 0.0f;
+	FLOAT tmax = maxFraction;
+	for( INT i = 0; i < 3; i++ )
+	{
+		FLOAT t1 = ( box.GetMin()[i] - origin[i] ) * invDir[i];
+		FLOAT t2 = ( box.GetMax()[i] - origin[i] ) * invDir[i];
+		if( t1 > t2 ) {
+			Swap( t1, t2 );
+		}
+		tmin = Max( tmin, t1 );
+		tmax = Min( tmax, t2 );
+		if( tmin > tmax ) {
+			return false;
+		}
+	}
+	OutFraction = tmin;
+	return true;
+}
+
+// Returns true if the sphere touches the given box.
+//
+FORCEINLINE bool SphereIntersectsAABB( const Vec3D& center, FLOAT radius, const AABB& box )
+{
+	FLOAT distSqr = 0.0f;
+	for( INT i = 0; i < 3; i++ )
+	{
+		if( center[i] < box.GetMin()[i] ) {
+			distSqr += Square( box.GetMin()[i] - center[i] );
+		}
+		else if( center[i] > box.GetMax()[i] ) {
+			distSqr += Square( center[i] - box.GetMax()[i] );
+		}
+	}
+	return distSqr <= radius * radius;
+}
+
+// Returns the normal of the box face which is the closest to the given point
+// (used for approximating surface normals at hit points).
+//
+FORCEINLINE Vec3D GetClosestAABBFaceNormal( const AABB& box, const Vec3D& point )
+{
+	INT		bestAxis = 0;
+	FLOAT	bestSign = -1.0f;
+	FLOAT	bestDist = MAX_SCENE_SIZE;
+	for( INT i = 0; i < 3; i++ )
+	{
+		const FLOAT dMin = mxMath::Fabs( point[i] - box.GetMin()[i] );
+		const FLOAT dMax = mxMath::Fabs( box.GetMax()[i] - point[i] );
+		if( dMin < bestDist ) {
+			bestDist = dMin;	bestAxis = i;	bestSign = -1.0f;
+		}
+		if( dMax < bestDist ) {
+			bestDist = dMax;	bestAxis = i;	bestSign = +1.0f;
+		}
+	}
+	Vec3D  normal( 0.0f, 0.0f, 0.0f );
+	normal[ bestAxis ] = bestSign;
+	return normal;
+}
+
 } //end of namespace abc
 
 #endif // ! __MX_SPATIAL_QUERY_H__
@@ -534,7 +534,7 @@ private:
 	Token *			m_token;		// current token in the token list
 	TokenList		m_tokenList;	// parsed tokens
 
-	TStringHash< int >	m_keywords;	// keyword IDs hashed by their names
+	THashMap< String, int >	m_keywords;	// keyword IDs hashed by their names
 };
 
 INLINE bool Lexer::IsWhitespace( char c ) {
@@ -944,7 +944,7 @@ void Lexer::SetKeyword( const char* name, int type )
 	Assert( IsValidIdentifier( name ) );
 
 #ifdef MX_DEBUG
-	if ( m_keywords.Get( name ) ) {
+	if ( m_keywords.Contains( name ) ) {
 		sys::Warning( "keyword '%s' already exists", name );
 	}
 #endif // MX_DEBUG
@@ -1106,7 +1106,7 @@ BOOL Lexer::EndOfFile() const
 
 bool Lexer::IsKeyword( const char * text )
 {
-	return m_keywords.Get( text );
+	return m_keywords.Contains( text );
 }
 
 bool Lexer::IsValidIdentifier( const char * text )
@@ -1428,11 +1428,8 @@ void Lexer::Scan( Token * token )
 			ReadName();
 			token->m_text = m_buffer.ToChar();
 
-			int		value;
-			int *	p = & value;
-
 			// if we got a keyword
-			if ( m_keywords.Get( m_buffer, &p ) ) {
+			if ( const int * p = m_keywords.Find( m_buffer ) ) {
 				token->m_type = *p;
 			}
 			else {
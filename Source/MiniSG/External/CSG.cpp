@@ -38,6 +38,34 @@ const mxChar* GetSetOpName( ESetOp op )
 	return null;
 }
 
+/*
+================================
+	GetSplitterHeuristicName
+================================
+*/
+const mxChar* GetSplitterHeuristicName( ESplitterHeuristic heuristic )
+{
+	switch( heuristic )
+	{
+	case Splitter_First :
+		return TEXT("First");
+
+	case Splitter_MinSplits :
+		return TEXT("MinSplits");
+
+	case Splitter_Balanced :
+		return TEXT("Balanced");
+
+	case Splitter_Weighted :
+		return TEXT("Weighted");
+
+	default:
+		;
+	}
+	Unreachable;
+	return null;
+}
+
 //------------------------------------------------------------------------
 //	Settings
 //------------------------------------------------------------------------
@@ -117,6 +145,233 @@ void DynamicMesh::Transform( const Matrix4& mat )
 	}
 }
 
+namespace {
+
+	//
+	//	ClippedPoly - a convex polygon produced by clipping.
+	//
+	struct ClippedPoly
+	{
+		enum { MAX_VERTICES = HPoly::MAX_VERTICES + 8 };	// clipping by a box adds at most six vertices
+
+		HVertex		vertices[ MAX_VERTICES ];
+		mxUInt		numVertices;
+	};
+
+	// Clips the polygon by an axis-aligned plane, keeps the part where ( sign * (p[axis] - value) ) >= 0.
+	// Polygons lying on the maximum sides of boxes are discarded (sign < 0)
+	// so that they are not duplicated in adjacent boxes.
+	void ClipByAxialPlane( const ClippedPoly& in, mxUInt axis, FLOAT value, FLOAT sign, ClippedPoly &OutPoly )
+	{
+		const bool  bKeepOnPlane = ( sign > 0.0f );
+
+		OutPoly.numVertices = 0;
+
+		for( mxUInt iVertex = 0; iVertex < in.numVertices; iVertex++ )
+		{
+			const HVertex & v1 = in.vertices[ iVertex ];
+			const HVertex & v2 = in.vertices[ (iVertex + 1) % in.numVertices ];
+
+			const FLOAT  d1 = sign * ( v1.XYZ[ axis ] - value );
+			const FLOAT  d2 = sign * ( v2.XYZ[ axis ] - value );
+
+			const bool  bInside1 = bKeepOnPlane ? ( d1 >= 0.0f ) : ( d1 > 0.0f );
+			const bool  bInside2 = bKeepOnPlane ? ( d2 >= 0.0f ) : ( d2 > 0.0f );
+
+			if ( bInside1 ) {
+				OutPoly.vertices[ OutPoly.numVertices++ ] = v1;
+			}
+			if ( bInside1 != bInside2 && d1 != d2 )
+			{
+				HVertex & mid = OutPoly.vertices[ OutPoly.numVertices++ ];
+				mid.Lerp( v1, v2, d1 / ( d1 - d2 ) );
+			}
+			Assert( OutPoly.numVertices < ClippedPoly::MAX_VERTICES );
+		}
+	}
+
+	// Clips the polygon by the given box. Returns false if nothing is left.
+	bool ClipPolygonToBounds( const HVertex* vertices, mxUInt numVertices, const mxBounds& bounds, ClippedPoly &OutPoly )
+	{
+		Assert( numVertices <= HPoly::MAX_VERTICES );
+
+		ClippedPoly  temp;
+		temp.numVertices = numVertices;
+		for( mxUInt iVertex = 0; iVertex < numVertices; iVertex++ ) {
+			temp.vertices[ iVertex ] = vertices[ iVertex ];
+		}
+
+		for( mxUInt axis = 0; axis < 3; axis++ )
+		{
+			ClipByAxialPlane( temp, axis, bounds.GetMin()[ axis ], +1.0f, OutPoly );
+			if ( OutPoly.numVertices < 3 ) {
+				return false;
+			}
+			ClipByAxialPlane( OutPoly, axis, bounds.GetMax()[ axis ], -1.0f, temp );
+			if ( temp.numVertices < 3 ) {
+				return false;
+			}
+		}
+
+		OutPoly = temp;
+		return true;
+	}
+
+}//End of anonymous namespace
+
+void DynamicMesh::Copy( const mxMesh* mesh, const mxBounds& clipBounds )
+{
+	Assert( mesh->IsValid() );
+
+	Reset();
+
+	for( mxUInt i = 0; i < mesh->numIndices; i += 3 )
+	{
+		const HVertex  triangle[3] =
+		{
+			mesh->vertices[ mesh->indices[ i + 0 ] ],
+			mesh->vertices[ mesh->indices[ i + 1 ] ],
+			mesh->vertices[ mesh->indices[ i + 2 ] ]
+		};
+
+		ClippedPoly  poly;
+		if ( !ClipPolygonToBounds( triangle, 3, clipBounds, poly ) ) {
+			continue;
+		}
+
+		// Triangulate the clipped polygon.
+		const rxIndex  iBaseVertex = this->vertices.Num();
+		for( mxUInt iVertex = 0; iVertex < poly.numVertices; iVertex++ ) {
+			this->vertices.Append( poly.vertices[ iVertex ] );
+		}
+		for( mxUInt iVertex = 1; iVertex < poly.numVertices - 1; iVertex++ ) {
+			this->triangles.Append( IndexTriple( iBaseVertex, iBaseVertex + iVertex, iBaseVertex + iVertex + 1 ) );
+		}
+	}
+}
+
+namespace {
+
+	FORCEINLINE bool VerticesEqual( const HVertex& a, const HVertex& b )
+	{
+		return a.XYZ.Compare( b.XYZ )
+			&& a.Normal.Compare( b.Normal )
+			&& a.UV.Compare( b.UV )
+			&& a.Tangent.Compare( b.Tangent );
+	}
+
+	FORCEINLINE UINT32 GetVertexHash( const HVertex& v )
+	{
+		const UINT32 * bits = reinterpret_cast< const UINT32* >( &v.XYZ );
+		return ( bits[0] * 73856093UL ) ^ ( bits[1] * 19349663UL ) ^ ( bits[2] * 83492791UL );
+	}
+
+}//End of anonymous namespace
+
+void DynamicMesh::WeldVertices( mxUInt firstVertex, mxUInt firstTriangle )
+{
+	Assert( firstVertex <= this->vertices.Num() );
+	Assert( firstTriangle <= this->triangles.Num() );
+
+	const mxUInt  numOldVertices = this->vertices.Num() - firstVertex;
+	if ( numOldVertices == 0 ) {
+		return;
+	}
+
+	// Small ranges (e.g. polygons of a single BSP node) are welded with a linear search.
+	enum { MAX_LINEAR_SEARCH = 64 };
+	const bool  bUseHash = ( numOldVertices > MAX_LINEAR_SEARCH );
+
+	// The scratch arrays are freed before returning, so they are taken from the frame arena
+	// (if the engine is running, otherwise from the heap).
+	IMemoryAllocator *	scratch = GetFrameArena().IsInitialized() ? &GetFrameArena() : null;
+
+	rxIndex					smallRemap[ MAX_LINEAR_SEARCH ];
+	TAllocArray< rxIndex >	bigRemap( scratch );	// old vertex index -> new vertex index
+	TAllocArray< INT >		hashHeads( scratch );	// first unique vertex in each bucket
+	TAllocArray< INT >		hashNext( scratch );	// next unique vertex in the same bucket
+	UINT32					hashMask = 0;
+
+	rxIndex * remap = smallRemap;
+
+	if ( bUseHash )
+	{
+		// Number of hash buckets must be a power of two.
+		mxUInt  numBuckets = 64;
+		while ( numBuckets < numOldVertices ) {
+			numBuckets <<= 1;
+		}
+		hashMask = numBuckets - 1;
+
+		hashHeads.SetNum( numBuckets );
+		for( mxUInt i = 0; i < numBuckets; i++ ) {
+			hashHeads[ i ] = INDEX_NONE;
+		}
+		hashNext.SetNum( numOldVertices );
+		bigRemap.SetNum( numOldVertices );
+		remap = bigRemap.Ptr();
+	}
+
+	// Unique vertices are compacted in place (a unique vertex is never stored after the vertex being processed).
+	HVertex * uniqueVertices = this->vertices.Ptr() + firstVertex;
+	mxUInt  numNewVertices = 0;
+
+	for( mxUInt iVertex = 0; iVertex < numOldVertices; iVertex++ )
+	{
+		const HVertex  vertex( uniqueVertices[ iVertex ] );
+
+		INT  iExisting = INDEX_NONE;
+		UINT32  bucket = 0;
+
+		if ( bUseHash )
+		{
+			bucket = GetVertexHash( vertex ) & hashMask;
+			iExisting = hashHeads[ bucket ];
+			while ( iExisting != INDEX_NONE && !VerticesEqual( uniqueVertices[ iExisting ], vertex ) ) {
+				iExisting = hashNext[ iExisting ];
+			}
+		}
+		else
+		{
+			for( mxUInt iUnique = 0; iUnique < numNewVertices; iUnique++ ) {
+				if ( VerticesEqual( uniqueVertices[ iUnique ], vertex ) ) {
+					iExisting = iUnique;
+					break;
+				}
+			}
+		}
+
+		if ( iExisting == INDEX_NONE )
+		{
+			iExisting = numNewVertices++;
+			uniqueVertices[ iExisting ] = vertex;
+			if ( bUseHash ) {
+				hashNext[ iExisting ] = hashHeads[ bucket ];
+				hashHeads[ bucket ] = iExisting;
+			}
+		}
+		remap[ iVertex ] = firstVertex + iExisting;
+	}
+
+	// Remap indices and remove triangles which have collapsed.
+	mxUInt  numNewTriangles = firstTriangle;
+	for( mxUInt iTri = firstTriangle; iTri < this->triangles.Num(); iTri++ )
+	{
+		IndexTriple  tri = this->triangles[ iTri ];
+		Assert( tri.iA >= firstVertex && tri.iB >= firstVertex && tri.iC >= firstVertex );
+		tri.iA = remap[ tri.iA - firstVertex ];
+		tri.iB = remap[ tri.iB - firstVertex ];
+		tri.iC = remap[ tri.iC - firstVertex ];
+
+		if ( tri.iA == tri.iB || tri.iB == tri.iC || tri.iC == tri.iA ) {
+			continue;
+		}
+		this->triangles[ numNewTriangles++ ] = tri;
+	}
+	this->triangles.SetNum( numNewTriangles, false );
+	this->vertices.SetNum( firstVertex + numNewVertices, false );
+}
+
 /*================================
 			BSPStats
 ================================*/
@@ -157,13 +412,14 @@ void BSPNode::CalculateBounds( mxBounds &OutBounds ) const
 void BSPStats::Dump()
 {
 	sys::Print(TEXT( "\n=== BSP statistics ========\n")				);
+	sys::Print(TEXT( "Splitter heuristic: %s\n"), GetSplitterHeuristicName( heuristic ) );
 	sys::Print(TEXT( "Num. Polys(Begin): %u\n"), numOrigPolygons	);
 	sys::Print(TEXT( "Num. Polys(End):   %u\n"), numPolygons		);
 	sys::Print(TEXT( "Num. Splits:	     %u\n"), numSplits			);
 	sys::Print(TEXT( "Num. Inner Nodes:  %u\n"), numInternalNodes	);
-	//sys::Print(TEXT( "Num. Solid Leaves: %d\n"), numSolidLeaves		);
-	//sys::Print(TEXT( "Num. Empty Leaves: %d\n"), numEmptyLeaves		);
-	//sys::Print(TEXT( "Tree Depth:        %d\n"), depth			);
+	sys::Print(TEXT( "Num. Solid Leaves: %u\n"), numSolidLeaves		);
+	sys::Print(TEXT( "Num. Empty Leaves: %u\n"), numEmptyLeaves		);
+	sys::Print(TEXT( "Tree Depth:        %u\n"), depth			);
 	sys::Print(TEXT( "Time elapsed(msec): %u\n"), elapsedTime		);
 	sys::Print(TEXT( "==== End ====================\n")				);
 }
@@ -190,12 +446,103 @@ namespace {
 static BSPNode  emptyLeaf( BSPNode::ENodeType::OutCell );
 static BSPNode  solidLeaf( BSPNode::ENodeType::InCell );
 
+// Calculates the plane of the given polygon.
+FORCEINLINE void GetPolygonPlane( const HPoly* poly, mxPlane &OutPlane )
+{
+	// counter-clockwise polys are front-facing
+	OutPlane.FromPoints(
+		poly->GetPosition( 2 ),
+		poly->GetPosition( 1 ),
+		poly->GetPosition( 0 )
+	);
+}
+
+// Classifies the polygon with respect to the plane without splitting it.
+FORCEINLINE EPlaneSide ClassifyPolygon( const HPoly* poly, const mxPlane& plane, const FLOAT epsilon )
+{
+	mxUInt  numFront = 0, numBack = 0;
+	for( mxUInt iVertex = 0; iVertex < poly->NumVertices(); iVertex++ )
+	{
+		const FLOAT fDistance = plane.Distance( poly->GetPosition( iVertex ) );
+		if ( fDistance > +epsilon ) {
+			++numFront;
+		}
+		else if ( fDistance < -epsilon ) {
+			++numBack;
+		}
+	}
+	if ( numFront && numBack ) {
+		return PLANESIDE_CROSS;
+	}
+	if ( numFront ) {
+		return PLANESIDE_FRONT;
+	}
+	if ( numBack ) {
+		return PLANESIDE_BACK;
+	}
+	return PLANESIDE_ON;
+}
+
+#ifdef PROFILE_CSG
+
+// Gathers tree depth and leaf counts.
+void CollectTreeStats_R( const BSPNode* node, mxUInt depth, BSPStats & stats )
+{
+	if ( node->type == BSPNode::ENodeType::InCell ) {
+		++stats.numSolidLeaves;
+		stats.depth = Max( stats.depth, depth );
+		return;
+	}
+	if ( node->type == BSPNode::ENodeType::OutCell ) {
+		++stats.numEmptyLeaves;
+		stats.depth = Max( stats.depth, depth );
+		return;
+	}
+	CollectTreeStats_R( node->front, depth + 1, stats );
+	CollectTreeStats_R( node->back, depth + 1, stats );
+}
+
+#endif // PROFILE_CSG
+
 }//End of anonymous namespace
 
+//
+//	SolidBSP::BuildSubtreeTask - builds a subtree on a worker thread.
+//
+class SolidBSP::BuildSubtreeTask : public mxTask {
+public:
+	BuildSubtreeTask( SolidBSP* tree, HPoly* faces, mxUInt numFaces )
+		: tree( tree ), faces( faces ), numFaces( numFaces ), result( null )
+	{
+		this->context = tree->CreateTaskContext();
+		BSP_STATS( this->context.stats = &this->stats );
+	}
+
+	virtual void Execute()
+	{
+		this->result = this->tree->BuildTree_R( this->faces, this->numFaces, this->context );
+	}
+
+	BSPNode * GetResult() const { return this->result; }
+
+	BSP_STATS( const BSPStats & GetStats() const { return this->stats; } )
+
+private:
+	SolidBSP *		tree;
+	HPoly *			faces;
+	mxUInt			numFaces;
+	BSPNode *		result;
+	BuildContext	context;
+	BSP_STATS( BSPStats  stats; )
+};
+
 //
 //	SolidBSP::SolidBSP
 //
 SolidBSP::SolidBSP()
+	: bWeldVertices( true )
+	, clipBounds( mxBounds::INFINITE_EXTENT )
+	, bClipToBounds( false )
 {}
 
 //
@@ -214,6 +561,7 @@ void SolidBSP::Build( const mxMesh* mesh )
 	Clear();
 
 	BSP_STATS( bspStats.Reset() );
+	BSP_STATS( bspStats.heuristic = this->buildSettings.heuristic );
 
 	mxUInt  numPolys;
 	HPoly * polys = BuildPolygonList( mesh, numPolys );
@@ -221,9 +569,77 @@ void SolidBSP::Build( const mxMesh* mesh )
 	BSP_STATS( bspStats.numPolygons = bspStats.numOrigPolygons = numPolys );
 
 //	this->nodes.Resize( mesh->GetNumFaces() );
-	this->root = BuildTree_R( polys );
+	BuildContext  context = GetMainContext();
+	this->root = BuildTree_R( polys, numPolys, context );
+
+	BSP_STATS( bspStats.Stop(); CollectTreeStats_R( this->root, 0, bspStats ); bspStats.Dump() );
+}
+
+void SolidBSP::Build( const DynamicMesh& mesh, bool bSolidIfEmpty )
+{
+	Clear();
+
+	BSP_STATS( bspStats.Reset() );
+	BSP_STATS( bspStats.heuristic = this->buildSettings.heuristic );
+
+	mxUInt  numPolys;
+	HPoly * polys = BuildPolygonList( mesh, numPolys );
+
+	if ( !numPolys )
+	{
+		// The tree consists of a single leaf.
+		this->root = bSolidIfEmpty ? &solidLeaf : &emptyLeaf;
+		return;
+	}
+
+	BSP_STATS( bspStats.numPolygons = bspStats.numOrigPolygons = numPolys );
+
+	BuildContext  context = GetMainContext();
+	this->root = BuildTree_R( polys, numPolys, context );
+
+	BSP_STATS( bspStats.Stop() );
+}
+
+//
+//	SolidBSP::CompareSplitterHeuristics
+//
+void SolidBSP::CompareSplitterHeuristics( const mxMesh* mesh )
+{
+	AssertPtr( mesh );
+
+	for( mxUInt iHeuristic = 0; iHeuristic < NUM_SPLITTER_HEURISTICS; iHeuristic++ )
+	{
+		BSPBuildSettings  settings;
+		settings.heuristic = (ESplitterHeuristic) iHeuristic;
+
+		SolidBSP  tree;
+		tree.SetBuildSettings( settings );
+		tree.Build( mesh );	// dumps statistics if PROFILE_CSG is defined
+	}
+}
+
+//
+//	SolidBSP::GetMainContext
+//
+SolidBSP::BuildContext SolidBSP::GetMainContext()
+{
+	BuildContext  context;
+	context.nodes = &this->nodes;
+	context.polys = &this->polys;
+	BSP_STATS( context.stats = &this->bspStats );
+	return context;
+}
 
-	BSP_STATS( bspStats.Stop(); bspStats.Dump() );
+//
+//	SolidBSP::CreateTaskContext
+//
+SolidBSP::BuildContext SolidBSP::CreateTaskContext()
+{
+	BuildContext  context;
+	context.nodes = &this->nodes;
+	context.polys = &this->polys;
+	BSP_STATS( context.stats = null );
+	return context;
 }
 
 //
@@ -290,24 +706,38 @@ HPoly * SolidBSP::BuildPolygonList( const DynamicMesh& mesh, mxUInt &OutNumPolys
 	return prevFace;
 }
 
-BSPNode * SolidBSP::BuildTree_R( HPoly* pFaces )
+BSPNode * SolidBSP::BuildTree_R( HPoly* pFaces, mxUInt numFaces, BuildContext & context )
 {
-	HPoly * splitter = SelectSplitter( pFaces );
+	HPoly * splitter = SelectSplitter( pFaces, numFaces );
 
-	BSPNode * pNewNode = AllocNode( splitter );
+	BSPNode * pNewNode = AllocNode( splitter, context );
 
 	HPoly * pFrontPolys = null;
 	HPoly * pBackPolys = null;
 
+	mxUInt  numFrontPolys = 0;
+	mxUInt  numBackPolys = 0;
+
 	HPoly * pCurrPoly = pFaces;
 
 	while( pCurrPoly != null )
 	{
 		HPoly * pNextPoly = pCurrPoly->next;
 
-		SplitFace( pCurrPoly, pNewNode->plane,
+		const EPlaneSide  side = SplitFace( pCurrPoly, pNewNode->plane,
 			pFrontPolys, pBackPolys, pNewNode->polys,
-			SPLIT_THRESHOLD );
+			SPLIT_THRESHOLD, context );
+
+		if ( side == PLANESIDE_FRONT ) {
+			++numFrontPolys;
+		}
+		else if ( side == PLANESIDE_BACK ) {
+			++numBackPolys;
+		}
+		else if ( side == PLANESIDE_CROSS ) {
+			++numFrontPolys;
+			++numBackPolys;
+		}
 
 		// Update node bounds.
 		pNewNode->polys->ExpandBounds( pNewNode->bounds );
@@ -315,8 +745,31 @@ BSPNode * SolidBSP::BuildTree_R( HPoly* pFaces )
 		pCurrPoly = pNextPoly;
 	}
 
-	pNewNode->front	= pFrontPolys ?	BuildTree_R( pFrontPolys )	: & emptyLeaf;
-	pNewNode->back	= pBackPolys ?	BuildTree_R( pBackPolys )	: & solidLeaf;
+	const mxUInt  parallelThreshold = this->buildSettings.parallelThreshold;
+	mxTaskPool &  taskPool = GetGlobalTaskPool();
+
+	if ( pFrontPolys && pBackPolys
+		&& parallelThreshold && ( numFrontPolys + numBackPolys >= parallelThreshold )
+		&& taskPool.IsInitialized() )
+	{
+		// Build the front subtree on a worker thread and the back subtree on this thread.
+		// Both threads allocate from the same pools, they keep separate caches of free items.
+		BuildSubtreeTask  frontTask( this, pFrontPolys, numFrontPolys );
+		mxTaskCounter  counter;
+		taskPool.Submit( &frontTask, &counter );
+
+		pNewNode->back = BuildTree_R( pBackPolys, numBackPolys, context );
+
+		taskPool.Wait( counter );
+		pNewNode->front = frontTask.GetResult();
+
+		BSP_STATS( context.stats->Merge( frontTask.GetStats() ) );
+	}
+	else
+	{
+		pNewNode->front	= pFrontPolys ?	BuildTree_R( pFrontPolys, numFrontPolys, context )	: & emptyLeaf;
+		pNewNode->back	= pBackPolys ?	BuildTree_R( pBackPolys, numBackPolys, context )	: & solidLeaf;
+	}
 
 	pNewNode->bounds.AddBounds( pNewNode->front->bounds );
 	pNewNode->bounds.AddBounds( pNewNode->back->bounds );
@@ -327,23 +780,95 @@ BSPNode * SolidBSP::BuildTree_R( HPoly* pFaces )
 //
 //	SolidBSP::SelectSplitter
 //
-HPoly * SolidBSP::SelectSplitter( HPoly *& polygons )
+HPoly * SolidBSP::SelectSplitter( HPoly *& polygons, mxUInt numPolygons ) const
 {
 	AssertPtr( polygons );
 
-	//HPoly * currPoly = polygons;
-	//HPoly * bestSplitter = null;
-	//while ( currPoly != null )
-	//{
-	//	TODO: ...
-	//}
+	const BSPBuildSettings & settings = this->buildSettings;
+
+	FLOAT  splitWeight, balanceWeight;
+	switch( settings.heuristic )
+	{
+	case Splitter_MinSplits :
+		splitWeight = 1.0f;
+		balanceWeight = 0.0f;
+		break;
+
+	case Splitter_Balanced :
+		splitWeight = 0.0f;
+		balanceWeight = 1.0f;
+		break;
+
+	case Splitter_Weighted :
+		splitWeight = settings.splitWeight;
+		balanceWeight = settings.balanceWeight;
+		break;
+
+	default:
+		splitWeight = balanceWeight = 0.0f;
+	}
 
-	// Debugging.
-	// Take the first poly from the list as a splitter.
 	HPoly * splitter = polygons;
+	HPoly * prevSplitter = null;	// the poly preceding the splitter in the list
+
+	if ( settings.heuristic != Splitter_First && numPolygons > 1 && settings.maxCandidates > 1 )
+	{
+		// Evaluate a few candidates sampled evenly from the list;
+		// each candidate is classified against all polygons, so the cost is O(numCandidates * numPolygons).
+		const mxUInt  numCandidates = Min( numPolygons, settings.maxCandidates );
+		// round the stride up, so that no more than 'numCandidates' polygons are tested
+		const mxUInt  stride = ( numPolygons + numCandidates - 1 ) / numCandidates;
+
+		FLOAT  bestScore = mxMath::INFINITY;
+
+		HPoly * prevPoly = null;
+		HPoly * currPoly = polygons;
+		mxUInt  iPoly = 0;
+
+		while ( currPoly != null )
+		{
+			if ( iPoly % stride == 0 )
+			{
+				mxPlane  plane;
+				GetPolygonPlane( currPoly, plane );
+
+				mxUInt  counts[ 4 ] = { 0 };
+				for( const HPoly * poly = polygons; poly != null; poly = poly->next )
+				{
+					if ( poly != currPoly ) {
+						++counts[ ClassifyPolygon( poly, plane, SPLIT_THRESHOLD ) ];
+					}
+				}
+
+				const mxUInt  numSplits = counts[ PLANESIDE_CROSS ];
+				const mxUInt  numFront = counts[ PLANESIDE_FRONT ] + numSplits;
+				const mxUInt  numBack = counts[ PLANESIDE_BACK ] + numSplits;
+				const mxUInt  imbalance = ( numFront > numBack ) ? ( numFront - numBack ) : ( numBack - numFront );
+
+				const FLOAT  score = splitWeight * (FLOAT)numSplits + balanceWeight * (FLOAT)imbalance;
+				if ( score < bestScore )
+				{
+					bestScore = score;
+					splitter = currPoly;
+					prevSplitter = prevPoly;
+
+					if ( score == 0.0f ) {
+						break;	// can't do better
+					}
+				}
+			}
+			prevPoly = currPoly;
+			currPoly = currPoly->next;
+			++iPoly;
+		}
+	}
 
 	// Remove splitter from the given list of polygons.
-	polygons = splitter->next;
+	if ( prevSplitter ) {
+		prevSplitter->next = splitter->next;
+	} else {
+		polygons = splitter->next;
+	}
 	splitter->next = null;
 
 	return splitter;
@@ -353,9 +878,17 @@ HPoly * SolidBSP::SelectSplitter( HPoly *& polygons )
 //	If the specified faces straddles the splitting plane,
 //	then two new faces are created and the original face is deleted.
 //
-void SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
+EPlaneSide SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
 			HPoly *& pOutFrontPolys, HPoly *& pOutBackPolys, HPoly *& pOutCoplanars,
 			const FLOAT epsilon /*  = SPLIT_THRESHOLD */ )
+{
+	BuildContext  context = GetMainContext();
+	return SplitFace( inFace, splitPlane, pOutFrontPolys, pOutBackPolys, pOutCoplanars, epsilon, context );
+}
+
+EPlaneSide SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
+			HPoly *& pOutFrontPolys, HPoly *& pOutBackPolys, HPoly *& pOutCoplanars,
+			const FLOAT epsilon, BuildContext & context )
 {
 	FLOAT  dists[ HPoly::MAX_VERTICES + 4 ];
 	TEnum<EPlaneSide,mxUInt>  sides[ HPoly::MAX_VERTICES + 4 ];
@@ -390,20 +923,20 @@ void SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
 
 	if ( counts[ PLANESIDE_ON ] == inFace->NumVertices() ) {
 		PrependItem< HPoly >( pOutCoplanars, inFace );	// the poly is aligned with the splitPlane.
-		return;
+		return PLANESIDE_ON;
 	}
 	if ( 0 == counts[ PLANESIDE_FRONT ] ) {
 		PrependItem< HPoly >( pOutBackPolys, inFace );	// the poly is completely behind the splitPlane.
-		return;
+		return PLANESIDE_BACK;
 	}
 	if ( 0 == counts[ PLANESIDE_BACK ] ) {
 		PrependItem< HPoly >( pOutFrontPolys, inFace );	// the poly is completely in front of the splitPlane.
-		return;
+		return PLANESIDE_FRONT;
 	}
 
 	// Straddles the splitPlane - we must clip.
 
-	BSP_STATS( bspStats.numSplits++ );
+	BSP_STATS( context.stats->numSplits++ );
 
 	const mxUInt  maxPoints = inFace->NumVertices() + 4; // Estimated number of points.
 
@@ -412,10 +945,10 @@ void SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
 		Unimplemented2( "polygons with more than 16 vertices" );
 	}
 
-	HPoly * frontPoly = new (this->polys) HPoly();
-	HPoly * backPoly = new (this->polys) HPoly();
+	HPoly * frontPoly = new (*context.polys) HPoly();
+	HPoly * backPoly = new (*context.polys) HPoly();
 
-	BSP_STATS( bspStats.numPolygons++ );
+	BSP_STATS( context.stats->numPolygons++ );
 
 	for( mxUInt iVertex = 0; iVertex < inFace->NumVertices(); iVertex++ )
 	{
@@ -500,27 +1033,18 @@ void SolidBSP::SplitFace( HPoly* inFace, const mxPlane& splitPlane,
 	PrependItem< HPoly >( pOutFrontPolys, frontPoly );
 	PrependItem< HPoly >( pOutBackPolys, backPoly );
 	DiscardPoly( inFace );
+
+	return PLANESIDE_CROSS;
 }
 
-BSPNode * SolidBSP::AllocNode( HPoly* splitter )
+BSPNode * SolidBSP::AllocNode( HPoly* splitter, BuildContext & context )
 {
-	BSPNode * newNode = new (this->nodes) BSPNode(_NoInit);
+	BSPNode * newNode = new (*context.nodes) BSPNode(_NoInit);
 
 	newNode->type = BSPNode::ENodeType::Internal;
 
 	// Initialize splitting plane.
-#if 0
-	const Vec3D n( (v1 - v2).Cross( p3 - v2 ) );
-	newNode->plane.SetNormal( n );
-	newNode->plane.SetDist( -( Normal() * v2 ) );
-#else
-	// counter-clockwise polys are front-facing
-	newNode->plane.FromPoints(
-		splitter->GetPosition( 2 ),
-		splitter->GetPosition( 1 ),
-		splitter->GetPosition( 0 )
-	);
-#endif
+	GetPolygonPlane( splitter, newNode->plane );
 
 	newNode->front = null;
 	newNode->back = null;
@@ -532,7 +1056,10 @@ BSPNode * SolidBSP::AllocNode( HPoly* splitter )
 
 	newNode->flags = 0;
 
-	BSP_STATS( bspStats.numInternalNodes++ );
+	newNode->firstVertex = newNode->numVertices = 0;
+	newNode->firstTriangle = newNode->numTriangles = 0;
+
+	BSP_STATS( context.stats->numInternalNodes++ );
 
 	return newNode;
 }
@@ -708,6 +1235,35 @@ const mxBounds & SolidBSP::GetBoundsLocal() const
 	return this->root->bounds;
 }
 
+void SolidBSP::SetClipBounds( const mxBounds* bounds )
+{
+	this->bClipToBounds = ( bounds != null );
+	this->clipBounds = bounds ? *bounds : mxBounds::INFINITE_EXTENT;
+}
+
+bool SolidBSP::IsSolidAt( const Vec3D& point )
+{
+	return this->root->GetContainingNode( point )->IsSolid();
+}
+
+//
+//	SolidBSP::IsSolidBox
+//
+bool SolidBSP::IsSolidBox( const mxBounds& bounds ) const
+{
+	// The surface doesn't pass through the box, so all its points are either inside or outside,
+	// even if planes of polygons elsewhere cross the box. The center is classified taking
+	// either side of a plane it lies on (IsSolidAt() would stop at such a plane and report empty space).
+	const Vec3D  center( bounds.GetCenter() );
+
+	const BSPNode * node = this->root.get();
+	while( node->IsInternal() )
+	{
+		node = ( node->plane.Distance( center ) >= 0.0f ) ? node->front : node->back;
+	}
+	return node->IsSolid();
+}
+
 //
 //	SolidBSP::Clear
 //
@@ -716,6 +1272,7 @@ void SolidBSP::Clear()
 	this->root = null;
 	this->nodes.Clear();
 	this->polys.Clear();
+	this->prevMesh.Clear();
 
 	BSP_STATS( bspStats.Reset() );
 	CSG_STATS( csgStats.Reset() );
@@ -727,7 +1284,8 @@ void SolidBSP::DoCSG( ESetOp setOp, const DynamicMesh& mesh )
 
 	mxUInt  numPolys;
 	HPoly * polys = BuildPolygonList( mesh, numPolys );
-	BSPNode * node = BuildTree_R( polys );
+	BuildContext  context = GetMainContext();
+	BSPNode * node = BuildTree_R( polys, numPolys, context );
 
 	switch( setOp )
 	{
@@ -761,6 +1319,9 @@ void SolidBSP::MergeSubtract_R( BSPNode*& pMyNode, BSPNode* pOtherNode )
 		return;
 	}
 
+	// The geometry of this subtree is going to change.
+	pMyNode->flags |= BSPNode::Dirty;
+
 	const EPlaneSide  eRelation = pOtherNode->bounds.PlaneSide( pMyNode->plane );
 
 	if ( eRelation == PLANESIDE_FRONT ) {
@@ -803,6 +1364,9 @@ void SolidBSP::MergeUnion_R( BSPNode*& pMyNode, BSPNode* pOtherNode )
 		return;
 	}
 
+	// The geometry of this subtree is going to change.
+	pMyNode->flags |= BSPNode::Dirty;
+
 	const EPlaneSide  eRelation = pOtherNode->bounds.PlaneSide( pMyNode->plane );
 
 	if ( eRelation == PLANESIDE_FRONT ) {
@@ -1121,19 +1685,70 @@ void SolidBSP::RemoveFacesOutsideNode_R( HPoly* inFaces, const BSPNode* pNode, H
 //
 //	SolidBSP::EmitMesh
 //
-void SolidBSP::EmitMesh( DynamicMesh &OutMesh )
+void SolidBSP::EmitMesh( DynamicMesh &OutMesh, bool bWeldVertices )
+{
+	this->bWeldVertices = bWeldVertices;
+
+	EmitContext  context;
+	context.mesh = &OutMesh;
+	context.prevMesh = null;
+
+	EmitMesh( context );
+}
+
+//
+//	SolidBSP::UpdateMesh
+//
+void SolidBSP::UpdateMesh( DynamicMesh &InOutMesh, mxUInt &OutFirstChangedVertex, mxUInt &OutFirstChangedTriangle )
+{
+	// Keep the previous mesh for copying the unchanged subtrees.
+	this->prevMesh.vertices.Swap( InOutMesh.vertices );
+	this->prevMesh.triangles.Swap( InOutMesh.triangles );
+
+	EmitContext  context;
+	context.mesh = &InOutMesh;
+	context.prevMesh = &this->prevMesh;
+
+	EmitMesh( context );
+
+	OutFirstChangedVertex = context.firstChangedVertex;
+	OutFirstChangedTriangle = context.firstChangedTriangle;
+}
+
+void SolidBSP::EmitMesh( EmitContext & context )
 {
 	DEBUG_CODE( mxUInt	startTime = sys::GetMilliseconds() );
 
+	DynamicMesh & OutMesh = *context.mesh;
+
 	OutMesh.Reset();
-	EmitNode_R( this->root, OutMesh );
+
+	context.firstChangedVertex = INDEX_NONE;
+	context.firstChangedTriangle = INDEX_NONE;
+	context.numWeldedVertices = 0;
+	context.numWeldedTriangles = 0;
+
+	EmitNode_R( this->root, context );
+
+	// The mesh may also have been truncated.
+	if ( context.firstChangedVertex == INDEX_NONE )
+	{
+		const bool bSameSize = context.prevMesh
+			&& ( context.prevMesh->vertices.Num() == OutMesh.vertices.Num() )
+			&& ( context.prevMesh->triangles.Num() == OutMesh.triangles.Num() );
+
+		context.firstChangedVertex = bSameSize ? OutMesh.vertices.Num() : 0;
+		context.firstChangedTriangle = bSameSize ? OutMesh.triangles.Num() : 0;
+	}
 
 	DEBUG_CODE(
 		mxUInt	elapsedTime = sys::GetMilliseconds() - startTime;
 		sys::Print("\nMesh Gen: %u msec\n", elapsedTime );
 
-		sys::Print("\nNew mesh: verts: %u, tris: %u\n",
-				OutMesh.vertices.Num(), OutMesh.triangles.Num() );
+		sys::Print("\nNew mesh: verts: %u -> %u, indices: %u -> %u (changed from vertex %u, index %u)\n",
+				OutMesh.vertices.Num() + context.numWeldedVertices, OutMesh.vertices.Num(),
+				( OutMesh.triangles.Num() + context.numWeldedTriangles ) * 3, OutMesh.triangles.Num() * 3,
+				context.firstChangedVertex, context.firstChangedTriangle * 3 );
 	);
 
 /*
@@ -1156,6 +1771,7 @@ void SolidBSP::EmitMesh( DynamicMesh &OutMesh )
 
 //
 //	CreateRenderVertex - creates a new vertex, appends to the mesh and returns a new index to that vertex.
+//	NOTE: consecutive calls return consecutive indices.
 //
 rxIndex CreateRenderVertex( const HVertex& v, DynamicMesh &OutMesh )
 {
@@ -1169,97 +1785,157 @@ rxIndex CreateRenderVertex( const HVertex& v, DynamicMesh &OutMesh )
 	return OutMesh.vertices.Num() - 1;
 }
 
-void SolidBSP::EmitNode_R( BSPNode* pNode, DynamicMesh &OutMesh )
+void SolidBSP::EmitNode_R( BSPNode* pNode, EmitContext & context )
 {
-#if 1
 	if( pNode->IsInternal() )
 	{
-		// TODO: don't emit this node if the data in this node hasn't been changed.
+		DynamicMesh & OutMesh = *context.mesh;
 
-		EmitNode_R( pNode->back, OutMesh );
-		EmitNode_R( pNode->front, OutMesh );
+		const mxUInt  firstVertex = OutMesh.vertices.Num();
+		const mxUInt  firstTriangle = OutMesh.triangles.Num();
 
-		// Update bounding box of this node.
-		pNode->bounds.SetZero();
-		pNode->bounds.AddBounds( pNode->front->bounds );
-		pNode->bounds.AddBounds( pNode->back->bounds );
-
-		// Loop through all faces of this node.
-		const HPoly * poly = pNode->polys;
-		while( poly != null )
+		// Don't emit this subtree if its data hasn't been changed, copy it from the previous mesh instead.
+		if( context.prevMesh
+			&& ( pNode->flags & BSPNode::Emitted ) && !( pNode->flags & BSPNode::Dirty ) )
 		{
-			Assert( poly->NumVertices() >= 3 );
+			const DynamicMesh & prevMesh = *context.prevMesh;
+			Assert( pNode->firstVertex + pNode->numVertices <= prevMesh.vertices.Num() );
+			Assert( pNode->firstTriangle + pNode->numTriangles <= prevMesh.triangles.Num() );
 
-			const UINT numTriangles = poly->NumVertices() - 2;
+			if( firstVertex != pNode->firstVertex && context.firstChangedVertex == INDEX_NONE )
+			{
+				// The subtree has moved, its indices must be rebased.
+				context.firstChangedVertex = firstVertex;
+				context.firstChangedTriangle = firstTriangle;
+			}
 
-			// Triangulate the current convex polygon...
-			
-			const HVertex & basePoint = poly->vertices[ 0 ];
+			OutMesh.vertices.SetNum( firstVertex + pNode->numVertices, false );
+			MemCopy( OutMesh.vertices.Ptr() + firstVertex,
+				prevMesh.vertices.Ptr() + pNode->firstVertex,
+				pNode->numVertices * sizeof(HVertex) );
 
-			// Update bounding box of this node.
-			pNode->bounds.AddPoint( basePoint.XYZ );
+			OutMesh.triangles.SetNum( firstTriangle + pNode->numTriangles, false );
 
-			const rxIndex iBasePoint = CreateRenderVertex( basePoint, OutMesh );
+			const rxIndex  indexOffset = firstVertex - pNode->firstVertex;	// wraps around if negative
+			const IndexTriple * src = prevMesh.triangles.Ptr() + pNode->firstTriangle;
+			IndexTriple * dest = OutMesh.triangles.Ptr() + firstTriangle;
 
-			for ( UINT i = 1; i < numTriangles + 1; i++ )
+			for( mxUInt iTri = 0; iTri < pNode->numTriangles; iTri++ )
 			{
-				IndexTriple & rNewTriangle = OutMesh.triangles.Alloc();
-
-				rNewTriangle.iA = iBasePoint;
-				rNewTriangle.iB = CreateRenderVertex( poly->vertices[ i ],	OutMesh );
-				rNewTriangle.iC = CreateRenderVertex( poly->vertices[ i+1 ],OutMesh );
-
-				// Update bounding box of this node.
-				pNode->bounds.AddPoint( poly->vertices[ i ].XYZ );
-				pNode->bounds.AddPoint( poly->vertices[ i+1 ].XYZ );
+				dest[ iTri ].iA = src[ iTri ].iA + indexOffset;
+				dest[ iTri ].iB = src[ iTri ].iB + indexOffset;
+				dest[ iTri ].iC = src[ iTri ].iC + indexOffset;
 			}
 
-			poly = poly->GetNext();
+			// The whole subtree has moved, not only its root
+			// (its children will be copied from this mesh when one of their siblings changes).
+			RebaseSubtree_R( pNode, firstVertex - pNode->firstVertex, firstTriangle - pNode->firstTriangle );
+			return;
 		}
-	}
-#else
-	if( pNode->IsInternal() )
-	{
-		// TODO: don't emit this node if the data in this node hasn't been changed.
 
-		EmitNode_R( pNode->back, OutMesh );
-		EmitNode_R( pNode->front, OutMesh );
+		EmitNode_R( pNode->back, context );
+		EmitNode_R( pNode->front, context );
 
 		// Update bounding box of this node.
 		pNode->bounds.SetZero();
 		pNode->bounds.AddBounds( pNode->front->bounds );
 		pNode->bounds.AddBounds( pNode->back->bounds );
 
+		const mxUInt  firstPolyVertex = OutMesh.vertices.Num();
+		const mxUInt  firstPolyTriangle = OutMesh.triangles.Num();
+
+		if( context.firstChangedVertex == INDEX_NONE )
+		{
+			context.firstChangedVertex = firstPolyVertex;
+			context.firstChangedTriangle = firstPolyTriangle;
+		}
+
 		// Loop through all faces of this node.
 		const HPoly * poly = pNode->polys;
 		while( poly != null )
 		{
 			Assert( poly->NumVertices() >= 3 );
 
-			const UINT numTriangles = poly->NumVertices() - 2;
+			const HVertex * polyVertices = poly->vertices.Ptr();
+			UINT numPolyVertices = poly->NumVertices();
+
+			ClippedPoly  clippedPoly;
+			if( this->bClipToBounds )
+			{
+				if( !ClipPolygonToBounds( polyVertices, numPolyVertices, this->clipBounds, clippedPoly ) ) {
+					poly = poly->GetNext();
+					continue;
+				}
+				polyVertices = clippedPoly.vertices;
+				numPolyVertices = clippedPoly.numVertices;
+			}
+
+			const UINT numTriangles = numPolyVertices - 2;
 
 			// Triangulate the current convex polygon...
 			
-			const HVertex & basePoint = poly->vertices[ 0 ];
+			// Emit one vertex per polygon corner; the triangles of the fan share them.
+			const rxIndex iBasePoint = CreateRenderVertex( polyVertices[ 0 ], OutMesh );
+			pNode->bounds.AddPoint( polyVertices[ 0 ].XYZ );
+
+			for ( UINT i = 1; i < numPolyVertices; i++ ) {
+				CreateRenderVertex( polyVertices[ i ], OutMesh );
+
+				// Update bounding box of this node.
+				pNode->bounds.AddPoint( polyVertices[ i ].XYZ );
+			}
 
 			for ( UINT i = 1; i < numTriangles + 1; i++ )
 			{
 				IndexTriple & rNewTriangle = OutMesh.triangles.Alloc();
 
-				rNewTriangle.iA = CreateRenderVertex( basePoint,			OutMesh );
-				rNewTriangle.iB = CreateRenderVertex( poly->vertices[ i ],	OutMesh );
-				rNewTriangle.iC = CreateRenderVertex( poly->vertices[ i+1 ],OutMesh );
-
-				// Update bounding box of this node.
-				pNode->bounds.AddPoint( basePoint.XYZ );
-				pNode->bounds.AddPoint( poly->vertices[ i ].XYZ );
-				pNode->bounds.AddPoint( poly->vertices[ i+1 ].XYZ );
+				rNewTriangle.iA = iBasePoint;
+				rNewTriangle.iB = iBasePoint + i;
+				rNewTriangle.iC = iBasePoint + i + 1;
 			}
 
 			poly = poly->GetNext();
 		}
+
+		// All polygons of the node are coplanar, merge their shared corners.
+		// NOTE: vertices are not welded across nodes (only coplanar nodes could share them),
+		// because that would move vertices of unchanged subtrees and break partial updates.
+		if( this->bWeldVertices )
+		{
+			const mxUInt  numEmittedVertices = OutMesh.vertices.Num();
+			const mxUInt  numEmittedTriangles = OutMesh.triangles.Num();
+
+			OutMesh.WeldVertices( firstPolyVertex, firstPolyTriangle );
+
+			context.numWeldedVertices += numEmittedVertices - OutMesh.vertices.Num();
+			context.numWeldedTriangles += numEmittedTriangles - OutMesh.triangles.Num();
+		}
+
+		pNode->firstVertex = firstVertex;
+		pNode->numVertices = OutMesh.vertices.Num() - firstVertex;
+		pNode->firstTriangle = firstTriangle;
+		pNode->numTriangles = OutMesh.triangles.Num() - firstTriangle;
+
+		pNode->flags &= ~BSPNode::Dirty;
+		pNode->flags |= BSPNode::Emitted;
+	}
+}
+
+//
+//	SolidBSP::RebaseSubtree_R - moves the locations of the subtree's geometry in the emitted mesh.
+//	The offsets wrap around if the subtree has moved towards the start of the mesh.
+//
+void SolidBSP::RebaseSubtree_R( BSPNode* pNode, UINT32 vertexOffset, UINT32 triangleOffset )
+{
+	if( pNode->IsInternal() )
+	{
+		Assert( pNode->flags & BSPNode::Emitted );
+		pNode->firstVertex += vertexOffset;
+		pNode->firstTriangle += triangleOffset;
+
+		RebaseSubtree_R( pNode->back, vertexOffset, triangleOffset );
+		RebaseSubtree_R( pNode->front, vertexOffset, triangleOffset );
 	}
-#endif
 }
 
 /*================================
@@ -1270,6 +1946,8 @@ DEFINE_CLASS( mxSolid, 'BSPS', CSGModel );
 
 mxSolid::mxSolid()
 	: mLocalToWorld( null )
+	, cellBounds( mxBounds::INFINITE_EXTENT )
+	, bIsCell( false )
 {
 	this->hitFilterMask = HM_Solid;
 }
@@ -1287,12 +1965,39 @@ void mxSolid::Setup( const CSGInfo& buildInfo )
 	this->bsp.Build( buildInfo.mesh );
 }
 
+void mxSolid::SetupCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid )
+{
+	this->cellBounds = cellBounds;
+	this->bIsCell = true;
+
+	this->srcMesh.Copy( mesh );
+	this->bsp.SetClipBounds( &cellBounds );
+	this->bsp.Build( mesh, bSolid );
+}
+
+bool mxSolid::IsEmpty() const
+{
+	return ( this->srcMesh.NumTriangles() == 0 );
+}
+
+bool mxSolid::IsSolidAt( const Vec3D& localPoint )
+{
+	return this->bsp.IsSolidAt( localPoint );
+}
+
+void mxSolid::GetRenderMesh( rxDynMeshData &OutMeshData )
+{
+	this->srcMesh.ToRenderMesh( OutMeshData );
+}
+
 void mxSolid::Shutdown()
 {
 	this->mLocalToWorld = null;
 	this->bsp.Clear();
+	this->bsp.SetClipBounds( null );
 	this->srcMesh.Clear();
 	this->srcMesh.Clear();
+	this->bIsCell = false;
 }
 
 void mxSolid::SetTransform( const Matrix4* worldTransform )
@@ -1334,16 +2039,23 @@ void mxSolid::Apply( const CSGInput& csgInput, CSGOutput &Out )
 
 	this->bsp.DoCSG( csgInput.type, other->dynMesh );
 
-	this->bsp.EmitMesh( this->srcMesh );
+	mxUInt  firstChangedVertex, firstChangedTriangle;
+	this->bsp.UpdateMesh( this->srcMesh, firstChangedVertex, firstChangedTriangle );
 
 
 	Out.flags = CSGOutput::EFlags::MeshChanged;
 	this->srcMesh.ToRenderMesh( Out.meshData );
+	Out.meshData.firstChangedVertex = firstChangedVertex;
+	Out.meshData.firstChangedIndex = firstChangedTriangle * 3;
 }
 
 void mxSolid::GetBoundsLocal( mxBounds & OutBounds ) const
 {
-	OutBounds = this->bsp.GetBoundsLocal();
+	if( this->bIsCell ) {
+		OutBounds = this->cellBounds;
+	} else {
+		OutBounds = this->bsp.GetBoundsLocal();
+	}
 }
 
 void mxSolid::GetBoundsWorld( mxBounds & OutBounds ) const
@@ -1386,6 +2098,18 @@ CSGModel * NewCSGModel( const CSGInfo& buildInfo )
 	return pNewSolid;
 }
 
+/*
+================================
+		NewCSGCell
+================================
+*/
+CSGModel * NewCSGCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid )
+{
+	mxSolid * pNewSolid = MX_NEW mxSolid();
+	pNewSolid->SetupCell( mesh, cellBounds, bSolid );
+	return pNewSolid;
+}
+
 }//End of namespace abc
 
 //--------------------------------------------------------------//
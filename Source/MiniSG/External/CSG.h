@@ -131,6 +131,15 @@ public:
 //
 extern CSGModel *	NewCSGModel( const CSGInfo& = CSGInfo() );
 
+struct DynamicMesh;
+
+//
+// Creates a CSG model for a single cell of a chunked solid;
+// its geometry is always clipped by the cell bounds.
+// If the mesh is empty, 'bSolid' specifies whether the cell is inside the solid.
+//
+extern CSGModel *	NewCSGCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid );
+
 //=======================================================================
 
 
@@ -249,6 +258,7 @@ public:
 	UINT NumVertices() const { return vertices.Num(); }
 
 	void Copy( const mxMesh* mesh );
+	void Copy( const mxMesh* mesh, const mxBounds& clipBounds );	// copies the triangles clipped by the given box
 	
 	void Copy( const DynamicMesh& other )
 	{
@@ -258,6 +268,11 @@ public:
 
 	void Transform( const Matrix4& mat );
 
+	// Merges vertices with identical attributes and removes degenerate triangles.
+	// Only the vertices starting from 'firstVertex' are welded;
+	// the triangles starting from 'firstTriangle' must only reference those vertices.
+	void WeldVertices( mxUInt firstVertex = 0, mxUInt firstTriangle = 0 );
+
 	void Reset()
 	{
 		vertices.SetNum( 0, false );
@@ -314,7 +329,19 @@ ALIGN_16 struct BSPNode
 	// Miscellaneous bit flags.
 	UINT32				flags;	// (4)
 
-	// 4 + 16 + 4 + 4 + 24 + 4 + 4 = 60 bytes.
+	// Location of the subtree's geometry in the emitted mesh (valid if the Emitted flag is set).
+	UINT32				firstVertex;	// (4)
+	UINT32				numVertices;	// (4)
+	UINT32				firstTriangle;	// (4)
+	UINT32				numTriangles;	// (4)
+
+	// 4 + 16 + 4 + 4 + 24 + 4 + 4 + 16 = 76 bytes.
+
+	enum EFlags
+	{
+		Dirty	= BIT(0),	// the subtree has been modified by a CSG operation since it was emitted
+		Emitted	= BIT(1),	// the subtree's geometry is stored in the last emitted mesh
+	};
 
 public:
 			BSPNode( ENoInit )
@@ -326,6 +353,8 @@ public:
 				, bounds( Vec3D(0,0,0) )
 				, polys( null )
 				, flags( null )
+				, firstVertex( 0 ), numVertices( 0 )
+				, firstTriangle( 0 ), numTriangles( 0 )
 			{}
 
 	FORCEINLINE bool IsLeaf() const
@@ -363,6 +392,58 @@ public:
 	void CalculateBounds( mxBounds &OutBounds ) const;
 };
 
+//
+//	ESplitterHeuristic - specifies how splitting planes are selected during BSP tree construction.
+//
+enum ESplitterHeuristic
+{
+	Splitter_First,		// Take the first polygon from the list (fastest build, deep and unbalanced trees).
+	Splitter_MinSplits,	// Minimize the number of polygons cut by the splitting plane.
+	Splitter_Balanced,	// Minimize the difference between the numbers of polygons in front and behind the plane.
+	Splitter_Weighted,	// Weighted sum of split count and imbalance (see BSPBuildSettings).
+
+	NUM_SPLITTER_HEURISTICS
+};
+
+const mxChar* GetSplitterHeuristicName( ESplitterHeuristic heuristic );
+
+//
+//	BSPBuildSettings - controls BSP tree construction.
+//
+struct BSPBuildSettings
+{
+	// Splitter_First by default, other heuristics build better trees but take longer
+	// (run 'Benchmarks BuildBSP' to compare them).
+	ESplitterHeuristic	heuristic;
+
+	// Weights used by the Splitter_Weighted heuristic:
+	// score = splitWeight * (number of split polygons) + balanceWeight * | (number of front polygons) - (number of back polygons) |.
+	FLOAT	splitWeight;
+	FLOAT	balanceWeight;
+
+	// Maximal number of candidate splitters evaluated for each node
+	// (the candidates are sampled evenly from the polygon list).
+	mxUInt	maxCandidates;
+
+	// Front and back subtrees are built in parallel if the node has more polygons than this (0 - never).
+	mxUInt	parallelThreshold;
+
+public:
+	BSPBuildSettings()
+	{
+		SetDefaults();
+	}
+
+	void SetDefaults()
+	{
+		heuristic			= Splitter_First;
+		splitWeight			= 8.0f;
+		balanceWeight		= 1.0f;
+		maxCandidates		= 16;
+		parallelThreshold	= 1024;
+	}
+};
+
 //------------------------------------------------------------------------
 //	Testing & debugging
 //------------------------------------------------------------------------
@@ -379,8 +460,10 @@ public:
 	mxUInt	numSplits;		// number of cuts caused by BSP
 
 	mxUInt	numInternalNodes;
-	//mxUInt	numSolidLeaves, numEmptyLeaves;
-	//mxUInt	depth;
+	mxUInt	numSolidLeaves, numEmptyLeaves;
+	mxUInt	depth;
+
+	ESplitterHeuristic	heuristic;	// heuristic used for selecting splitters
 
 public:
 	BSPStats()
@@ -394,13 +477,22 @@ public:
 		numSplits = 0;
 
 		numInternalNodes = 0;
-		//numSolidLeaves = 0;
-		//numEmptyLeaves = 0;
-		//depth = 0;
+		numSolidLeaves = 0;
+		numEmptyLeaves = 0;
+		depth = 0;
+
+		heuristic = Splitter_First;
 
 		startTime = sys::GetMilliseconds();
 		elapsedTime = 0;
 	}
+	// Accumulates the counters gathered while building a subtree.
+	void Merge( const BSPStats& other )
+	{
+		numPolygons += other.numPolygons;
+		numSplits += other.numSplits;
+		numInternalNodes += other.numInternalNodes;
+	}
 	void Stop()
 	{
 		elapsedTime = sys::GetMilliseconds() - startTime;
@@ -471,11 +563,33 @@ public:
 				~SolidBSP();
 
 	void		Build( const mxMesh* mesh );
-	void		EmitMesh( DynamicMesh &OutMesh );
+	void		Build( const DynamicMesh& mesh, bool bSolidIfEmpty = false );
+	void		EmitMesh( DynamicMesh &OutMesh, bool bWeldVertices = true );
+
+	// Re-emits only the subtrees modified since the last call to EmitMesh() or UpdateMesh(),
+	// the unchanged subtrees are copied from the previous mesh.
+	// 'InOutMesh' must contain the previously emitted mesh. Returns the first vertex and triangle that have changed.
+	void		UpdateMesh( DynamicMesh &InOutMesh, mxUInt &OutFirstChangedVertex, mxUInt &OutFirstChangedTriangle );
+
+	void		SetBuildSettings( const BSPBuildSettings& newSettings );
+	const BSPBuildSettings & GetBuildSettings() const;
+
+	// Builds trees from the given mesh with each splitter heuristic and prints their statistics.
+	static void	CompareSplitterHeuristics( const mxMesh* mesh );
 
 	// Returns the bounding volume of the entire tree in local space.
 	const mxBounds & GetBoundsLocal() const;
 
+	// If the bounds are not null, emitted polygons are clipped by the given box.
+	void SetClipBounds( const mxBounds* bounds );
+
+	// Returns true if the given point is inside the solid.
+	bool IsSolidAt( const Vec3D& point );
+
+	// Returns true if the given box is inside the solid. The surface must not pass through the box
+	// (e.g. a cell without polygons), so the box is classified without epsilon tests.
+	bool IsSolidBox( const mxBounds& bounds ) const;
+
 	// intersection point is start + dir * scale
 	bool RayIntersection( const Vec3D &start, const Vec3D &dir, FLOAT &OutScale ) const;
 
@@ -492,25 +606,57 @@ public:
 	};
 
 private:
+	// Memory pools and statistics used by a single thread during tree construction.
+	struct BuildContext
+	{
+		TConcurrentPool< BSPNode > *	nodes;
+		TConcurrentPool< HPoly > *		polys;
+		BSP_STATS( BSPStats *		stats; )
+	};
+
+	class BuildSubtreeTask;
+	friend class BuildSubtreeTask;
+
+	// State for emitting renderable geometry.
+	struct EmitContext
+	{
+		DynamicMesh *			mesh;		// output mesh
+		const DynamicMesh *		prevMesh;	// previously emitted mesh (can be null)
+		mxUInt					firstChangedVertex;
+		mxUInt					firstChangedTriangle;
+		mxUInt					numWeldedVertices;	// vertices removed by welding the emitted polygons
+		mxUInt					numWeldedTriangles;	// degenerate triangles removed by welding
+	};
+
 	// Internal functions
 
+	// Returns the context for building the tree on the calling thread.
+	BuildContext	GetMainContext();
+
+	// Returns the context for building a subtree on another thread (with its own statistics).
+	BuildContext	CreateTaskContext();
+
 	// Converts the given mesh into a linked list of polygons and returns the head of the list.
 	HPoly *	BuildPolygonList( const mxMesh* mesh, mxUInt &OutNumPolys );
 	HPoly *	BuildPolygonList( const DynamicMesh& mesh, mxUInt &OutNumPolys );
 
 	// Builds a tree from the given linked list of polygons and returns the root of the tree.
-	BSPNode * BuildTree_R( HPoly* pFaces );
+	BSPNode * BuildTree_R( HPoly* pFaces, mxUInt numFaces, BuildContext & context );
 
 	// Selects the best splitter polygon from the given linked list of polygons and removes the splitter from the list.
-	HPoly *	SelectSplitter( HPoly *& polygons );
+	HPoly *	SelectSplitter( HPoly *& polygons, mxUInt numPolygons ) const;
 
 	// Partitions the given polygon by the specified plane and returns the resulting polygons.
-	void SplitFace( HPoly* inFace, const mxPlane& splitPlane,
+	// Returns the side of the plane the polygon was on (PLANESIDE_CROSS if it has been split).
+	EPlaneSide SplitFace( HPoly* inFace, const mxPlane& splitPlane,
 					HPoly *& pOutFrontPolys, HPoly *& pOutBackPolys, HPoly *& pOutCoplanars,
 					const FLOAT epsilon );
+	EPlaneSide SplitFace( HPoly* inFace, const mxPlane& splitPlane,
+					HPoly *& pOutFrontPolys, HPoly *& pOutBackPolys, HPoly *& pOutCoplanars,
+					const FLOAT epsilon, BuildContext & context );
 
 				// Creates a new (internal) BSP node and assigns the given poly.
-	BSPNode *	AllocNode( HPoly* splitter );
+	BSPNode *	AllocNode( HPoly* splitter, BuildContext & context );
 
 	void		Discard( BSPNode* node );
 
@@ -531,13 +677,25 @@ private:
 	void RemoveFacesOutsideNode( HPoly *& inFaces, const BSPNode* pNode );
 	void RemoveFacesOutsideNode_R( HPoly* inFaces, const BSPNode* pNode, HPoly *& OutFaces );
 
-	void EmitNode_R( BSPNode* pNode, DynamicMesh &OutMesh );
+	void EmitNode_R( BSPNode* pNode, EmitContext & context );
+	void EmitMesh( EmitContext & context );
+
+	static void RebaseSubtree_R( BSPNode* pNode, UINT32 vertexOffset, UINT32 triangleOffset );
 
 private:
 	TPtr< BSPNode >		root;	// Root node of the entire tree.
 
-	mxMemoryPool< BSPNode >	nodes;	// all nodes are stored here
-	mxMemoryPool< HPoly >	polys;	// all polygons are stored here
+	// Thread-safe, subtrees are built in parallel.
+	TConcurrentPool< BSPNode >	nodes;	// all nodes are stored here
+	TConcurrentPool< HPoly >	polys;	// all polygons are stored here
+
+	BSPBuildSettings	buildSettings;
+
+	DynamicMesh			prevMesh;		// the previously emitted mesh, used by UpdateMesh()
+	bool				bWeldVertices;	// weld vertices of emitted polygons
+
+	mxBounds			clipBounds;		// emitted polygons are clipped by this box
+	bool				bClipToBounds;
 
 	// For testing & debugging.
 	BSP_STATS( BSPStats  bspStats; )
@@ -548,6 +706,14 @@ FORCEINLINE BSPNode * SolidBSP::GetRoot() {
 	return this->root;
 }
 
+FORCEINLINE void SolidBSP::SetBuildSettings( const BSPBuildSettings& newSettings ) {
+	this->buildSettings = newSettings;
+}
+
+FORCEINLINE const BSPBuildSettings & SolidBSP::GetBuildSettings() const {
+	return this->buildSettings;
+}
+
 //
 //	mxSolid
 //
@@ -564,6 +730,17 @@ public:
 	void	Setup( const CSGInfo& buildInfo );
 	void	Shutdown();
 
+	// Sets up this solid as a cell of a chunked solid (see NewCSGCell()).
+	void	SetupCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid );
+
+	// Returns true if this solid has no polygons.
+	bool	IsEmpty() const;
+
+	// Returns true if the given point (in local space) is inside the solid.
+	bool	IsSolidAt( const Vec3D& localPoint );
+
+	void	GetRenderMesh( rxDynMeshData &OutMeshData );
+
 	//
 	//	Override ( CSGModel ) :
 	//
@@ -582,6 +759,9 @@ private:
 	SolidBSP			bsp;
 	DynamicMesh			srcMesh;	// source geometry, modified only when this model is CSG'ed
 	DynamicMesh			dynMesh;	// generated mesh (for rendering)
+
+	mxBounds			cellBounds;	// bounds of the cell if this solid is a part of a chunked solid
+	bool				bIsCell;
 };
 
 }//End of namespace abc
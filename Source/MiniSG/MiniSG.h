@@ -15,6 +15,7 @@
 #include <Utilities/UserControlledCamera.h>
 #include <Utilities/MaterialLoader.h>
 #include <Utilities/MeshLoader.h>
+#include <Utilities/AsyncLoader.h>
 #include <Utilities/Misc.h>
 
 // External libraries.
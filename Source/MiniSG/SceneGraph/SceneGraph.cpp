@@ -377,6 +377,40 @@ rxModel* MakeRenderModel( const mxMesh* mesh, const ModelDescription& desc )
 	return scene.CreateModel( modelDesc );
 }
 
+/*
+================================
+		MakeCellRenderModel
+================================
+*/
+rxModel* MakeCellRenderModel( const rxDynMeshData& meshData )
+{
+	rxModelDescription	modelDesc;
+
+	// Cells are small and usually change a little, so their buffers only grow when needed.
+	modelDesc.flags |= EModelFlags::MF_DynamicGeometry;
+
+	modelDesc.dynamicGeom.allocationType	= EHWBufferAlloc::HWA_Fixed;
+	modelDesc.dynamicGeom.updateType		= EHWBufferUpdate::HWU_GrowAsNeeded;
+
+	rxMeshDescription &	meshDesc = modelDesc.meshDesc;
+
+	rxVertexBufferDescription &  vbDesc = meshDesc.Vertices;
+	vbDesc.VertexCount	= meshData.numVertices;
+	vbDesc.VertexSize	= sizeof(rxVertex);
+	vbDesc.Data			= meshData.vertices;
+
+	meshDesc.PrimitiveType = EPrimitiveType::PT_TriangleList;
+
+	rxIndexBufferDescription &  ibDesc = meshDesc.Indices;
+	ibDesc.IndexCount	= meshData.numIndices;
+	ibDesc.IndexSize	= sizeof(rxIndex);
+	ibDesc.Data			= meshData.indices;
+
+	rxScene & scene = mxEngine::get().GetRenderer().GetScene();
+
+	return scene.CreateModel( modelDesc );
+}
+
 /*
 ================================
 	MakeCSGModelFromMesh
@@ -468,6 +502,58 @@ void Model::SetupSphere( mxReal radius, mxUInt slices, mxUInt stacks, const Mode
 	Unimplemented;
 }
 
+/*
+================================
+		Model::SetupCell
+================================
+*/
+void Model::SetupCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid, SceneGraph* sceneMgr )
+{
+	AssertPtr( this->parent );
+
+	this->parentScene = sceneMgr;
+	this->bCsgModel = true;
+
+	// Cells are not moved relative to the parent.
+	this->localToWorld = this->parent->GetAbsoluteTransform();
+
+	if( mxSolid * solid = DynamicCast<mxSolid>(this->GetSpatialProxy()) )
+	{
+		// The cell is being reused.
+		solid->SetupCell( mesh, cellBounds, bSolid );
+		solid->SetTransform( &this->localToWorld );
+	}
+	else
+	{
+		CSGModel * newSolid = NewCSGCell( mesh, cellBounds, bSolid );
+		newSolid->SetTransform( &this->localToWorld );
+		this->SetSpatialProxy( newSolid );
+	}
+}
+
+/*
+================================
+		Model::SetCellGeometry
+================================
+*/
+void Model::SetCellGeometry( const rxDynMeshData& meshData )
+{
+	if( this->GetGraphics() == &rxNullDrawEntity::dummy )
+	{
+		if( !meshData.numIndices ) {
+			return;
+		}
+		rxModel * newRenderModel = MakeCellRenderModel( meshData );
+		newRenderModel->SetTransform( this->localToWorld );
+		this->SetGraphics( newRenderModel );
+	}
+	else
+	{
+		rxModel* renderModel = checked_cast< rxModel*, rxDrawEntity* >( this->GetGraphics() );
+		renderModel->SetGeometry( &meshData );
+	}
+}
+
 void Model::Close()
 {
 	this->GetGraphics()->Remove();
@@ -503,6 +589,286 @@ void Model::_onWorldTransformChanged()
 	model->SetTransform( this->GetAbsoluteTransform() );
 }
 
+/*================================
+			ChunkedModel
+================================*/
+
+DEFINE_CLASS( ChunkedModel, 'CHMD', Node );
+
+ChunkedModel::ChunkedModel()
+	: cellSize( 0.0f )
+{
+	numCells[0] = numCells[1] = numCells[2] = 0;
+}
+
+ChunkedModel::~ChunkedModel()
+{}
+
+/*
+================================
+		ChunkedModel::Setup
+================================
+*/
+void ChunkedModel::Setup( const mxMesh* mesh, FLOAT cellSize, const ModelDescription& desc, SceneGraph* sceneMgr )
+{
+	AssertPtr( mesh );
+	Assert( cellSize > 0.0f );
+	UnusedParameter( desc );
+
+	this->parentScene = sceneMgr;
+	this->cellSize = cellSize;
+
+	// Polygons lying on the maximum faces of a cell belong to the next cell,
+	// so expand the grid a little to keep the polygons on the outer faces.
+	this->gridBounds = mesh->bounds;
+	this->gridBounds.ExpandSelf( cellSize * 0.01f );
+
+	const Vec3D  gridSize( this->gridBounds.GetMax() - this->gridBounds.GetMin() );
+
+	mxUInt  totalNumCells = 1;
+	for( mxUInt axis = 0; axis < 3; axis++ )
+	{
+		this->numCells[ axis ] = Max< mxUInt >( (mxUInt) mxMath::Ceil( gridSize[ axis ] / cellSize ), 1 );
+		totalNumCells *= this->numCells[ axis ];
+	}
+
+	this->slots.SetNum( totalNumCells );
+	this->slotIsSolid.SetNum( totalNumCells );
+
+	// The tree of the whole mesh is only needed for classifying cells without geometry.
+	SolidBSP	wholeTree;
+	bool		bWholeTreeBuilt = false;
+
+	DynamicMesh  cellMesh;
+
+	for( mxUInt z = 0; z < this->numCells[2]; z++ )
+	{
+		for( mxUInt y = 0; y < this->numCells[1]; y++ )
+		{
+			for( mxUInt x = 0; x < this->numCells[0]; x++ )
+			{
+				const IndexT  slot = GetSlotIndex( x, y, z );
+
+				mxBounds  cellBounds;
+				GetCellBounds( x, y, z, cellBounds );
+
+				cellMesh.Copy( mesh, cellBounds );
+
+				this->slots[ slot ] = null;
+				this->slotIsSolid[ slot ] = false;
+
+				if( cellMesh.NumTriangles() > 0 )
+				{
+					Model * cell = AcquireCell( slot, cellMesh, cellBounds, false );
+
+					rxDynMeshData  meshData;
+					checked_cast< mxSolid*, mxSpatialProxy* >( cell->GetSpatialProxy() )->GetRenderMesh( meshData );
+					cell->SetCellGeometry( meshData );
+				}
+				else
+				{
+					if( !bWholeTreeBuilt ) {
+						wholeTree.Build( mesh );
+						bWholeTreeBuilt = true;
+					}
+					this->slotIsSolid[ slot ] = wholeTree.IsSolidBox( cellBounds );
+				}
+			}
+		}
+	}
+
+	DEBUG_CODE( sys::Print( TEXT("Chunked model: %u x %u x %u cells, %u active\n"),
+		this->numCells[0], this->numCells[1], this->numCells[2], NumActiveCells() ) );
+}
+
+void ChunkedModel::Close()
+{
+	for( mxUInt iSlot = 0; iSlot < this->slots.Num(); iSlot++ )
+	{
+		if( this->slots[ iSlot ] != null ) {
+			ReleaseCell( iSlot, false );
+		}
+	}
+	for( mxUInt iCell = 0; iCell < this->freeCells.Num(); iCell++ )
+	{
+		Model * cell = this->freeCells[ iCell ];
+		cell->GetGraphics()->Remove();
+	}
+	this->freeCells.Clear();
+	this->slots.Clear();
+	this->slotIsSolid.Clear();
+}
+
+void ChunkedModel::SetMaterial( rxMaterial* newMaterial )
+{
+	AssertPtr( newMaterial );
+	this->material = newMaterial;
+
+	for( mxUInt iSlot = 0; iSlot < this->slots.Num(); iSlot++ )
+	{
+		Model * cell = this->slots[ iSlot ];
+		if( cell != null && cell->GetGraphics() != &rxNullDrawEntity::dummy ) {
+			cell->SetMaterial( newMaterial );
+		}
+	}
+}
+
+/*
+================================
+		ChunkedModel::ApplyCSG
+================================
+*/
+void ChunkedModel::ApplyCSG( const CSGInput& csgInput )
+{
+	Assert( csgInput.IsOk() );
+
+	// Find the cells overlapped by the brush.
+
+	mxBounds  brushBounds;
+	csgInput.operand->GetBoundsWorld( brushBounds );
+	brushBounds.TrasformSelf( this->GetAbsoluteTransform().Inverse() );
+
+	if( !brushBounds.IntersectsBounds( this->gridBounds ) ) {
+		return;
+	}
+
+	mxUInt  minCell[3], maxCell[3];
+	for( mxUInt axis = 0; axis < 3; axis++ )
+	{
+		const FLOAT  gridMin = this->gridBounds.GetMin()[ axis ];
+		const INT  lastCell = (INT) this->numCells[ axis ] - 1;
+		minCell[ axis ] = Clamp< INT >( (INT) mxMath::Floor( (brushBounds.GetMin()[ axis ] - gridMin) / this->cellSize ), 0, lastCell );
+		maxCell[ axis ] = Clamp< INT >( (INT) mxMath::Floor( (brushBounds.GetMax()[ axis ] - gridMin) / this->cellSize ), 0, lastCell );
+	}
+
+	const bool  bSubtract = ( csgInput.type == ESetOp::CSG_Difference );
+
+	DynamicMesh  emptyMesh;
+
+	for( mxUInt z = minCell[2]; z <= maxCell[2]; z++ )
+	{
+		for( mxUInt y = minCell[1]; y <= maxCell[1]; y++ )
+		{
+			for( mxUInt x = minCell[0]; x <= maxCell[0]; x++ )
+			{
+				const IndexT  slot = GetSlotIndex( x, y, z );
+
+				mxBounds  cellBounds;
+				GetCellBounds( x, y, z, cellBounds );
+
+				Model * cell = this->slots[ slot ];
+				if( cell == null )
+				{
+					// Subtracting from empty space or adding to solid space doesn't change anything.
+					const bool bSolid = ( this->slotIsSolid[ slot ] != 0 );
+					if( bSubtract != bSolid ) {
+						continue;
+					}
+					cell = AcquireCell( slot, emptyMesh, cellBounds, bSolid );
+				}
+
+				mxSolid * solid = checked_cast< mxSolid*, mxSpatialProxy* >( cell->GetSpatialProxy() );
+
+				CSGOutput  csgOutput;
+				solid->Apply( csgInput, csgOutput );
+
+				if( solid->IsEmpty() )
+				{
+					// No surface is left in the cell. The cell's own tree is built from the clipped,
+					// open surface and can't classify the cell, but the result follows from the operation:
+					// the brush has emptied (or filled) its part of the cell,
+					// and without a surface the rest of the cell must be the same.
+					ReleaseCell( slot, !bSubtract );
+				}
+				else if( csgOutput.flags & CSGOutput::MeshChanged )
+				{
+					const bool bNewRenderModel = ( cell->GetGraphics() == &rxNullDrawEntity::dummy );
+
+					cell->SetCellGeometry( csgOutput.meshData );
+
+					if( bNewRenderModel && this->material != null ) {
+						cell->SetMaterial( this->material );
+					}
+				}
+			}
+		}
+	}
+}
+
+mxUInt ChunkedModel::NumActiveCells() const
+{
+	mxUInt  numActiveCells = 0;
+	for( mxUInt iSlot = 0; iSlot < this->slots.Num(); iSlot++ )
+	{
+		if( this->slots[ iSlot ] != null ) {
+			numActiveCells++;
+		}
+	}
+	return numActiveCells;
+}
+
+IndexT ChunkedModel::GetSlotIndex( mxUInt x, mxUInt y, mxUInt z ) const
+{
+	Assert( x < numCells[0] && y < numCells[1] && z < numCells[2] );
+	return ( z * numCells[1] + y ) * numCells[0] + x;
+}
+
+void ChunkedModel::GetCellBounds( mxUInt x, mxUInt y, mxUInt z, mxBounds &OutBounds ) const
+{
+	const Vec3D  cellMin( this->gridBounds.GetMin() + Vec3D( (FLOAT)x, (FLOAT)y, (FLOAT)z ) * this->cellSize );
+	OutBounds.Set( cellMin, cellMin + Vec3D( this->cellSize ) );
+}
+
+/*
+================================
+		ChunkedModel::AcquireCell
+================================
+*/
+Model * ChunkedModel::AcquireCell( IndexT slot, const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid )
+{
+	Assert( this->slots[ slot ] == null );
+
+	Model * cell = null;
+	if( this->freeCells.Num() > 0 )
+	{
+		cell = this->freeCells.GetLast();
+		this->freeCells.SetNum( this->freeCells.Num() - 1, false );
+	}
+	else
+	{
+		cell = Model::New();
+	}
+
+	this->AddKid( cell );
+	cell->SetupCell( mesh, cellBounds, bSolid, this->parentScene );
+
+	// Make the cell visible to culling.
+	this->parentScene->parentScene->Add( cell );
+
+	this->slots[ slot ] = cell;
+	return cell;
+}
+
+/*
+================================
+		ChunkedModel::ReleaseCell
+================================
+*/
+void ChunkedModel::ReleaseCell( IndexT slot, bool bSolid )
+{
+	Model * cell = this->slots[ slot ];
+	AssertPtr( cell );
+
+	this->parentScene->parentScene->Remove( cell );
+	this->RemoveKid( cell );
+
+	// Keep the render model, its buffers will be reused.
+	this->freeCells.Append( cell );
+
+	this->slots[ slot ] = null;
+	this->slotIsSolid[ slot ] = bSolid;
+}
+
 /*================================
 			Light
 ================================*/
@@ -916,7 +1282,7 @@ void SceneGraph::Add( Node* newNode )
 		if ( FindNodeByName( newNode->name ) ) {
 			sys::Error("a node with name '%s' already exist", newNode->name );
 		} else {
-			this->nodesByName.Insert( newNode->name, newNode );
+			this->nodesByName.Set( mxNameId( newNode->name ), newNode );
 		}
 	}
 }
@@ -926,7 +1292,7 @@ void SceneGraph::Remove( Node* node )
 	Unimplemented;
 
 	if ( node->name != null ) {
-		this->nodesByName.Remove( node->name );
+		this->nodesByName.Remove( mxNameId::Find( node->name ) );
 	}
 }
 
@@ -940,8 +1306,15 @@ void SceneGraph::Update( const mxTime dt )
 Node * SceneGraph::FindNodeByName( const char* name )
 {
 	AssertPtr( name );
-	Node ** ppNode = null;
-	if ( this->nodesByName.Get( name, &ppNode ) )
+	return FindNodeByName( mxNameId::Find( name ) );
+}
+
+Node * SceneGraph::FindNodeByName( const mxNameId& name )
+{
+	if ( name.IsEmpty() ) {
+		return null;
+	}
+	if ( Node ** ppNode = this->nodesByName.Find( name ) )
 	{
 		return *ppNode;
 	}
@@ -1015,6 +1388,24 @@ Model * SceneGraph::AddSphere( mxReal radius, mxUInt slices, mxUInt stacks,
 	return newModel;
 }
 
+ChunkedModel * SceneGraph::AddChunkedMesh( const mxMesh* mesh, FLOAT cellSize,
+							  const char* name, const ModelDescription& desc )
+{
+	AssertPtr( mesh );
+	mesh->Grab();
+
+	ChunkedModel * newModel = ChunkedModel::New();
+	newModel->SetName( name );
+
+	// Cells are attached to the model, so it must be in the graph first.
+	this->Add( newModel );
+	newModel->Setup( mesh, cellSize, desc, this );
+
+	mesh->Drop();
+
+	return newModel;
+}
+
 Light * SceneGraph::AddLight( const LightCreationInfo& desc, const char* name )
 {
 	TPtr< Light > newLight( Light::New() );
@@ -15,6 +15,7 @@ namespace abc {
 // Forward declarations.
 class	Node;
 class		Model;
+class		ChunkedModel;
 class		Light;
 class		Camera;
 class		Billboard;
@@ -356,6 +357,7 @@ public:
 };
 
 class CSGInput;
+struct DynamicMesh;
 
 //
 //	Model - is a scene node containing renderable geometry.
@@ -387,12 +389,69 @@ private:
 	void	SetupBox( mxReal length, mxReal height, mxReal depth, const ModelDescription& desc, SceneGraph* sceneMgr );
 	void	SetupSphere( mxReal radius, mxUInt slices, mxUInt stacks, const ModelDescription& desc, SceneGraph* sceneMgr );
 
+	// Cells of chunked models.
+	friend class ChunkedModel;
+
+			// (the cell should have been attached to its parent node)
+	void	SetupCell( const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid, SceneGraph* sceneMgr );
+
+			// creates the render model on first use
+	void	SetCellGeometry( const rxDynMeshData& meshData );
+
 	void	Close();
 
 private:
 	bool	bCsgModel;
 };
 
+//
+//	ChunkedModel - is a large CSG model split into a regular grid of cells.
+//
+//	Each cell is a child model with its own small BSP tree and render model,
+//	so a CSG operation only rebuilds the cells overlapped by the brush
+//	and the cells are culled separately.
+//
+//	Cells without geometry are not allocated (only their 'solid'/'empty' state is stored);
+//	cells which become empty are returned to the free list for reuse.
+//
+class ChunkedModel : public Node {
+public:
+			// set the given material to all cells
+	void	SetMaterial( rxMaterial* newMaterial );
+
+	void	ApplyCSG( const CSGInput& csgInput );
+
+	mxUInt	NumActiveCells() const;
+
+private:
+	friend class SceneGraph;
+
+	DECLARE_CLASS( ChunkedModel );
+
+			ChunkedModel();
+			~ChunkedModel();
+
+	void	Setup( const mxMesh* mesh, FLOAT cellSize, const ModelDescription& desc, SceneGraph* sceneMgr );
+	void	Close();
+
+	IndexT	GetSlotIndex( mxUInt x, mxUInt y, mxUInt z ) const;
+	void	GetCellBounds( mxUInt x, mxUInt y, mxUInt z, mxBounds &OutBounds ) const;
+
+	Model *	AcquireCell( IndexT slot, const DynamicMesh& mesh, const mxBounds& cellBounds, bool bSolid );
+	void	ReleaseCell( IndexT slot, bool bSolid );
+
+private:
+	mxBounds	gridBounds;		// bounds of the grid in local space
+	FLOAT		cellSize;		// length of the cell's side
+	mxUInt		numCells[3];	// grid dimensions
+
+	TArray< Model* >	slots;			// cells with geometry (null if the cell is entirely solid or empty)
+	TArray< BYTE >		slotIsSolid;	// state of the cells without geometry
+	TArray< Model* >	freeCells;		// unused cells which can be reused
+
+	TPtr< rxMaterial >	material;
+};
+
 //
 //	LightCreationInfo - contains generic light info.
 //
@@ -608,6 +667,7 @@ public:
 	void Update( const mxTime dt );
 
 	Node *	FindNodeByName( const char* name );
+	Node *	FindNodeByName( const mxNameId& name );
 
 public:
 
@@ -630,6 +690,11 @@ public:
 	Model *	AddSphere( mxReal radius, mxUInt slices, mxUInt stacks,
 					const char* name = null, const ModelDescription& desc = ModelDescription() );
 
+	// Creates a CSG model split into cubic cells with the given side length.
+	//
+	ChunkedModel * AddChunkedMesh( const mxMesh* mesh, FLOAT cellSize,
+					const char* name = null, const ModelDescription& desc = ModelDescription() );
+
 	Light *	AddLight( const LightCreationInfo& desc,
 					const char* name = null );
 
@@ -642,11 +707,13 @@ public:
 	Camera* AddCamera( mxCamera& theCamera, const char* name = null );
 
 private:
+	friend class ChunkedModel;	// adds and removes cells
+
 	TPtr< Node >	rootNode;
 	TPtr< mxScene >	parentScene;
 //	TArray< Node* >	allNodes;
 
-	TStringHash< Node* >	nodesByName;
+	THashMap< mxNameId, Node* >	nodesByName;
 };
 
 }//End of namespace abc
@@ -0,0 +1,619 @@
+/*
+=============================================================================
+	File:	AsyncLoader.cpp
+	Desc:	Background loading of meshes, materials and textures.
+=============================================================================
+*/
+
+#include <precompiled.h>
+#pragma hdrstop
+#include <MiniSG.h>
+
+namespace abc {
+
+namespace {
+
+//
+//	ReadWholeFile - reads the contents of a (binary) file into memory.
+//	The file can be loose or stored in a mounted archive.
+//
+bool ReadWholeFile( const mxChar* filename, TArray< BYTE > &OutData )
+{
+	mxDataStream * file = mxEngine::get().GetFileSystem().OpenFile( filename );
+	if ( ! file ) {
+		sys::Warning( TEXT("Failed to open file '%s'"), filename );
+		return false;
+	}
+
+	const SizeT fileSize = file->GetSize();
+
+	bool bOk = ( fileSize > 0 );
+	if ( bOk )
+	{
+		OutData.SetNum( fileSize );
+		bOk = ( file->Read( OutData.Ptr(), fileSize ) == fileSize );
+	}
+
+	MX_FREE( file );
+	return bOk;
+}
+
+//
+//	MeshLoadRequest - the mesh is imported (or mapped from the mesh cache) on the worker thread.
+//
+class MeshLoadRequest : public mxLoadRequest {
+public:
+	MeshLoadRequest( const mxChar* filename, const MeshDescription& meshDesc, INT priority )
+		: mxLoadRequest( filename, priority )
+		, desc( meshDesc )
+	{}
+
+	bool Load()
+	{
+		this->mesh = LoadMeshFromFile( this->fileName.ToChar(), this->desc );
+		return ( this->mesh != null );
+	}
+
+	bool Commit()
+	{
+		// meshes are kept in system memory, nothing to do
+		return true;
+	}
+
+private:
+	const MeshDescription	desc;
+};
+
+//
+//	TextureLoadRequest - the image file is read on the worker thread,
+//	the texture is created from memory on the main thread.
+//
+class TextureLoadRequest : public mxLoadRequest {
+public:
+	TextureLoadRequest( const mxChar* filename, INT priority )
+		: mxLoadRequest( filename, priority )
+	{}
+
+	bool Load()
+	{
+		return ReadWholeFile( this->fileName.ToChar(), this->fileData );
+	}
+
+	bool Commit()
+	{
+		rxResources & resources = mxEngine::get().GetRenderer().GetResources();
+		this->texture = resources.LoadTextureFromMemory( this->fileName.ToChar(), this->fileData.Ptr(), this->fileData.Num() );
+		return ( this->texture != null );
+	}
+
+	void Discard()
+	{
+		this->fileData.Clear();
+	}
+
+private:
+	TArray< BYTE >	fileData;
+};
+
+//
+//	MaterialLoadRequest - the material script is parsed and the textures are read on the worker thread.
+//
+class MaterialLoadRequest : public mxLoadRequest {
+public:
+	MaterialLoadRequest( const mxChar* filename, INT priority )
+		: mxLoadRequest( filename, priority )
+	{}
+
+	bool Load()
+	{
+		if ( ! ParseMaterialScript( this->fileName.ToChar(), this->definitions ) ) {
+			return false;
+		}
+
+		// read the textures referenced by the materials
+		for ( mxUInt iMaterial = 0; iMaterial < this->definitions.Num(); iMaterial++ )
+		{
+			const MaterialDefinition & material = this->definitions[ iMaterial ];
+
+			for ( mxUInt iLayer = 0; iLayer < TL_Num_Layers; iLayer++ )
+			{
+				const String & textureFile = material.textureFiles[ iLayer ];
+				if ( textureFile.IsEmpty() || HasTextureFile( textureFile ) ) {
+					continue;
+				}
+
+				TextureFile & newFile = this->textureFiles.Alloc();
+				newFile.name = textureFile;
+				ReadWholeFile( textureFile.ToChar(), newFile.data );
+			}
+		}
+		return true;
+	}
+
+	bool Commit()
+	{
+		rxResources & resources = mxEngine::get().GetRenderer().GetResources();
+
+		// create the textures first, so that CreateMaterials() finds them by names
+		for ( mxUInt iTexture = 0; iTexture < this->textureFiles.Num(); iTexture++ )
+		{
+			const TextureFile & textureFile = this->textureFiles[ iTexture ];
+			if ( textureFile.data.Num() > 0 ) {
+				resources.LoadTextureFromMemory( textureFile.name.ToChar(), textureFile.data.Ptr(), textureFile.data.Num() );
+			}
+		}
+
+		this->material = CreateMaterials( this->definitions );
+		return ( this->material != null );
+	}
+
+	void Discard()
+	{
+		this->definitions.Clear();
+		this->textureFiles.Clear();
+	}
+
+private:
+	struct TextureFile
+	{
+		String			name;
+		TArray< BYTE >	data;
+	};
+
+	bool HasTextureFile( const String& name ) const
+	{
+		for ( mxUInt i = 0; i < this->textureFiles.Num(); i++ ) {
+			if ( this->textureFiles[i].name == name ) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	MaterialDefinitions		definitions;
+	TArray< TextureFile >	textureFiles;
+};
+
+}//End of anonymous namespace
+
+/*================================
+		mxLoadRequest
+================================*/
+
+mxLoadRequest::mxLoadRequest( const mxChar* filename, INT priority )
+	: fileName( filename )
+	, priority( priority )
+	, sequence( 0 )
+	, status( LOAD_PENDING )
+	, bCancelled( false )
+	, material( null )
+	, texture( null )
+{
+}
+
+mxLoadRequest::~mxLoadRequest()
+{
+}
+
+ELoadStatus mxLoadRequest::GetStatus() const
+{
+	return this->status;
+}
+
+bool mxLoadRequest::IsFinished() const
+{
+	const ELoadStatus currentStatus = this->status;
+	return ( currentStatus == LOAD_SUCCEEDED )
+		|| ( currentStatus == LOAD_FAILED )
+		|| ( currentStatus == LOAD_CANCELLED )
+		;
+}
+
+bool mxLoadRequest::Succeeded() const
+{
+	return ( this->status == LOAD_SUCCEEDED );
+}
+
+INT mxLoadRequest::GetPriority() const
+{
+	return this->priority;
+}
+
+const mxChar * mxLoadRequest::GetFileName() const
+{
+	return this->fileName.ToChar();
+}
+
+mxMesh * mxLoadRequest::GetMesh() const
+{
+	return ( Succeeded() && this->mesh != null ) ? (mxMesh*) this->mesh : null;
+}
+
+rxMaterial * mxLoadRequest::GetMaterial() const
+{
+	return Succeeded() ? this->material : null;
+}
+
+rxTexture * mxLoadRequest::GetTexture() const
+{
+	return Succeeded() ? this->texture : null;
+}
+
+/*================================
+		mxAsyncLoader
+================================*/
+
+mxAsyncLoader::mxAsyncLoader()
+	: numInProgress( 0 )
+	, nextSequence( 0 )
+	, semaphore( NULL )
+	, numThreads( 0 )
+	, bQuit( false )
+{
+}
+
+mxAsyncLoader::~mxAsyncLoader()
+{
+	Shutdown();
+}
+
+//
+//	mxAsyncLoader::Initialize
+//
+void mxAsyncLoader::Initialize( mxUInt numLoaderThreads )
+{
+	Assert( this->numThreads == 0 );
+
+	numLoaderThreads = Min< mxUInt >( numLoaderThreads, MAX_LOADER_THREADS );
+	if( numLoaderThreads == 0 ) {
+		return;	// requests will be loaded in Update()
+	}
+
+	this->bQuit = false;
+	this->semaphore = ::CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+	Assert( this->semaphore != NULL );
+
+	for( mxUInt iThread = 0; iThread < numLoaderThreads; iThread++ )
+	{
+		const uintptr_t hThread = ::_beginthreadex( NULL, 0, &WorkerThreadFunc, this, 0, NULL );
+		if( !hThread ) {
+			sys::Warning( TEXT("Failed to create a loader thread\n") );
+			break;
+		}
+		// loading should not steal time from the main thread
+		::SetThreadPriority( (HANDLE) hThread, THREAD_PRIORITY_BELOW_NORMAL );
+		this->threads[ this->numThreads++ ] = (HANDLE) hThread;
+	}
+}
+
+//
+//	mxAsyncLoader::Shutdown
+//
+void mxAsyncLoader::Shutdown()
+{
+	// requests which haven't been loaded yet are cancelled
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+		for( mxUInt i = 0; i < this->pending.Num(); i++ ) {
+			this->pending[i]->status = LOAD_CANCELLED;
+		}
+		this->pending.Clear();
+	}
+
+	if( this->numThreads > 0 )
+	{
+		this->bQuit = true;
+		::ReleaseSemaphore( this->semaphore, this->numThreads, NULL );
+
+		::WaitForMultipleObjects( this->numThreads, this->threads, TRUE, INFINITE );
+
+		for( mxUInt iThread = 0; iThread < this->numThreads; iThread++ ) {
+			::CloseHandle( this->threads[ iThread ] );
+		}
+		this->numThreads = 0;
+
+		::CloseHandle( this->semaphore );
+		this->semaphore = NULL;
+	}
+
+	// the renderer may be already destroyed, so loaded requests are not committed
+	for( mxUInt i = 0; i < this->loaded.Num(); i++ )
+	{
+		this->loaded[i]->Discard();
+		this->loaded[i]->status = LOAD_CANCELLED;
+	}
+	this->loaded.Clear();
+}
+
+mxLoadRequestPtr mxAsyncLoader::LoadMesh( const mxChar* filename, const MeshDescription& desc, INT priority )
+{
+	return Submit( MX_NEW MeshLoadRequest( filename, desc, priority ) );
+}
+
+mxLoadRequestPtr mxAsyncLoader::LoadMaterials( const mxChar* filename, INT priority )
+{
+	return Submit( MX_NEW MaterialLoadRequest( filename, priority ) );
+}
+
+mxLoadRequestPtr mxAsyncLoader::LoadTexture( const mxChar* filename, INT priority )
+{
+	return Submit( MX_NEW TextureLoadRequest( filename, priority ) );
+}
+
+mxLoadRequestPtr mxAsyncLoader::Submit( mxLoadRequest* request )
+{
+	AssertPtr( request );
+	mxLoadRequestPtr  result( request );
+
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+		request->sequence = this->nextSequence++;
+		this->pending.Append( result );
+	}
+
+	if( this->numThreads > 0 ) {
+		::ReleaseSemaphore( this->semaphore, 1, NULL );
+	}
+	return result;
+}
+
+void mxAsyncLoader::SetPriority( mxLoadRequest* request, INT priority )
+{
+	AssertPtr( request );
+	sys::ScopedLock  scopedLock( this->lock );
+	request->priority = priority;
+}
+
+//
+//	mxAsyncLoader::Cancel
+//
+void mxAsyncLoader::Cancel( mxLoadRequest* request )
+{
+	AssertPtr( request );
+	mxLoadRequestPtr  keepAlive( request );
+
+	mxLoadRequestPtr  discarded;
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+
+		switch( request->status )
+		{
+		case LOAD_PENDING :
+			this->pending.Remove( request );
+			request->status = LOAD_CANCELLED;
+			break;
+
+		case LOAD_IN_PROGRESS :
+			// the result will be discarded by the worker thread
+			request->bCancelled = true;
+			break;
+
+		case LOAD_READY :
+			discarded = request;
+			this->loaded.Remove( request );
+			request->status = LOAD_CANCELLED;
+			break;
+
+		default:
+			break;	// already finished
+		}
+	}
+
+	if( discarded != null ) {
+		discarded->Discard();
+	}
+}
+
+//
+//	mxAsyncLoader::Update
+//
+mxUInt mxAsyncLoader::Update( mxUInt maxCommits )
+{
+	MX_PROFILE("Async Loader");
+
+	// without worker threads requests are loaded here
+	if( this->numThreads == 0 )
+	{
+		for( mxUInt i = 0; i < maxCommits && LoadNext(); i++ )
+			;
+	}
+
+	mxUInt numCommitted = 0;
+	while( numCommitted < maxCommits )
+	{
+		mxLoadRequestPtr  request;
+		{
+			sys::ScopedLock  scopedLock( this->lock );
+			if( this->loaded.Num() == 0 ) {
+				break;
+			}
+			request = this->loaded[ 0 ];
+			this->loaded.RemoveIndex( 0 );
+		}
+		ExecuteCommit( request );
+		numCommitted++;
+	}
+	return numCommitted;
+}
+
+//
+//	mxAsyncLoader::Wait
+//
+void mxAsyncLoader::Wait( mxLoadRequest* request )
+{
+	AssertPtr( request );
+	mxLoadRequestPtr  keepAlive( request );
+
+	while( !request->IsFinished() )
+	{
+		bool bLoadHere = false;
+		bool bCommitHere = false;
+		{
+			sys::ScopedLock  scopedLock( this->lock );
+
+			if( request->status == LOAD_PENDING )
+			{
+				this->pending.Remove( request );
+				request->status = LOAD_IN_PROGRESS;
+				this->numInProgress++;
+				bLoadHere = true;
+			}
+			else if( request->status == LOAD_READY )
+			{
+				this->loaded.Remove( request );
+				bCommitHere = true;
+			}
+		}
+
+		if( bLoadHere ) {
+			ExecuteLoad( request );
+		}
+		else if( bCommitHere ) {
+			ExecuteCommit( request );
+		}
+		else {
+			sys::Sleep( 1 );	// a worker thread is loading the request
+		}
+	}
+}
+
+void mxAsyncLoader::WaitAll()
+{
+	while( NumUnfinishedRequests() > 0 )
+	{
+		if( !Update() ) {
+			sys::Sleep( 1 );
+		}
+	}
+}
+
+mxUInt mxAsyncLoader::NumUnfinishedRequests() const
+{
+	sys::ScopedLock  scopedLock( this->lock );
+	return this->pending.Num() + this->numInProgress + this->loaded.Num();
+}
+
+//
+//	mxAsyncLoader::TakeNextPending - removes the request with the highest priority from the queue.
+//	The queue is short, so it's simply scanned. Must be called under the lock.
+//
+mxLoadRequest * mxAsyncLoader::TakeNextPending()
+{
+	if( this->pending.Num() == 0 ) {
+		return null;
+	}
+
+	mxUInt bestIndex = 0;
+	for( mxUInt i = 1; i < this->pending.Num(); i++ )
+	{
+		const mxLoadRequest * request = this->pending[ i ];
+		const mxLoadRequest * best = this->pending[ bestIndex ];
+
+		if( request->priority > best->priority
+			|| ( request->priority == best->priority && request->sequence < best->sequence ) )
+		{
+			bestIndex = i;
+		}
+	}
+
+	mxLoadRequest * request = this->pending[ bestIndex ];
+	request->Grab();	// released in ExecuteLoad()
+	this->pending.RemoveIndex( bestIndex );
+
+	request->status = LOAD_IN_PROGRESS;
+	this->numInProgress++;
+
+	return request;
+}
+
+bool mxAsyncLoader::LoadNext()
+{
+	mxLoadRequest * request = null;
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+		request = TakeNextPending();
+	}
+	if( !request ) {
+		return false;
+	}
+
+	ExecuteLoad( request );
+	request->Drop();
+	return true;
+}
+
+//
+//	mxAsyncLoader::ExecuteLoad
+//
+void mxAsyncLoader::ExecuteLoad( mxLoadRequest* request )
+{
+	Assert( request->status == LOAD_IN_PROGRESS );
+
+	const bool bLoaded = request->Load();
+
+	bool bDiscard = false;
+	{
+		sys::ScopedLock  scopedLock( this->lock );
+
+		this->numInProgress--;
+
+		if( request->bCancelled ) {
+			request->status = LOAD_CANCELLED;
+			bDiscard = true;
+		}
+		else if( !bLoaded ) {
+			request->status = LOAD_FAILED;
+			bDiscard = true;
+		}
+		else {
+			request->status = LOAD_READY;
+			this->loaded.Append( request );
+		}
+	}
+
+	if( bDiscard ) {
+		request->Discard();
+	}
+}
+
+//
+//	mxAsyncLoader::ExecuteCommit
+//
+void mxAsyncLoader::ExecuteCommit( mxLoadRequest* request )
+{
+	const bool bCommitted = request->Commit();
+	request->Discard();
+
+	sys::ScopedLock  scopedLock( this->lock );
+	request->status = bCommitted ? LOAD_SUCCEEDED : LOAD_FAILED;
+}
+
+//
+//	mxAsyncLoader::WorkerThreadFunc
+//
+unsigned int __stdcall mxAsyncLoader::WorkerThreadFunc( void* param )
+{
+	mxAsyncLoader * loader = static_cast< mxAsyncLoader* >( param );
+
+	for(;;)
+	{
+		::WaitForSingleObject( loader->semaphore, INFINITE );
+
+		// requests can also be taken by Wait(), so the semaphore count is only a hint
+		while( !loader->bQuit && loader->LoadNext() )
+			;
+
+		if( loader->bQuit ) {
+			break;
+		}
+	}
+
+	mxConcurrentPool::ReleaseThreadCaches();
+	return 0;
+}
+
+}//End of namespace abc
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
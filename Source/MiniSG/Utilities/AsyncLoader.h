@@ -0,0 +1,177 @@
+/*
+=============================================================================
+	File:	AsyncLoader.h
+	Desc:	Background loading of meshes, materials and textures.
+=============================================================================
+*/
+
+#ifndef __MINISG_ASYNC_LOADER_H__
+#define __MINISG_ASYNC_LOADER_H__
+
+namespace abc {
+
+class mxAsyncLoader;
+
+//
+//	ELoadStatus
+//
+enum ELoadStatus
+{
+	LOAD_PENDING,		// waiting in the queue
+	LOAD_IN_PROGRESS,	// being loaded by a worker thread
+	LOAD_READY,			// loaded, waiting to be committed on the main thread
+	LOAD_SUCCEEDED,
+	LOAD_FAILED,
+	LOAD_CANCELLED,
+};
+
+//
+//	ELoadPriority - requests with higher priorities are loaded first.
+//
+enum ELoadPriority
+{
+	LOAD_PRIORITY_LOW		= 0,
+	LOAD_PRIORITY_NORMAL	= 50,
+	LOAD_PRIORITY_HIGH		= 100,
+};
+
+//
+//	mxLoadRequest - a handle to an asset being loaded in the background.
+//
+//	The results become available after the request has been committed
+//	on the main thread (see mxAsyncLoader::Update() and mxAsyncLoader::Wait()).
+//
+class mxLoadRequest : public ReferenceCounted {
+public:
+	ELoadStatus		GetStatus() const;
+
+	// Returns true if the request has succeeded, failed or has been cancelled.
+	bool			IsFinished() const;
+	bool			Succeeded() const;
+
+	INT				GetPriority() const;
+	const mxChar *	GetFileName() const;
+
+	// Results (null until the request has succeeded).
+	// NOTE: the mesh is owned by the request, use mxMeshPtr to keep it alive.
+	mxMesh *		GetMesh() const;
+	rxMaterial *	GetMaterial() const;	// the last material in the script
+	rxTexture *		GetTexture() const;
+
+protected:
+	mxLoadRequest( const mxChar* filename, INT priority );
+	virtual	~mxLoadRequest();
+
+	// Reads and parses the file, called on a worker thread.
+	virtual bool	Load() = 0;
+
+	// Creates graphics resources, called on the main thread.
+	virtual bool	Commit() = 0;
+
+	// Frees the intermediate data (called after committing or cancelling the request).
+	virtual void	Discard() {}
+
+protected:
+	friend class mxAsyncLoader;
+
+	String		fileName;
+	INT			priority;
+	UINT32		sequence;	// requests with equal priorities are loaded in the order of submission
+
+	volatile ELoadStatus	status;
+	volatile bool			bCancelled;	// set if the request is cancelled while being loaded
+
+	mxMeshPtr		mesh;
+	rxMaterial *	material;
+	rxTexture *		texture;
+
+private:
+	NO_COPY_CONSTRUCTOR( mxLoadRequest );
+	NO_ASSIGNMENT( mxLoadRequest );
+};
+
+typedef RefPtr< mxLoadRequest >	mxLoadRequestPtr;
+
+//
+//	mxAsyncLoader - loads assets in the background.
+//
+//	Worker threads read and parse files (mesh import, material scripts, image files);
+//	graphics resources are created in Update() on the main thread,
+//	so the renderer is never accessed by the worker threads.
+//
+//	The loader has its own threads instead of using the global task pool,
+//	because they spend most of the time blocked on disk I/O.
+//
+class mxAsyncLoader {
+public:
+	enum {
+		DEFAULT_NUM_THREADS	= 2,
+		MAX_LOADER_THREADS	= 8,
+	};
+
+					mxAsyncLoader();
+					~mxAsyncLoader();
+
+					// Creates worker threads. With zero threads requests are loaded on the main thread in Update().
+	void			Initialize( mxUInt numLoaderThreads = DEFAULT_NUM_THREADS );
+
+					// Cancels unfinished requests and waits for the worker threads to finish.
+	void			Shutdown();
+
+	mxLoadRequestPtr	LoadMesh( const mxChar* filename, const MeshDescription& desc = MeshDescription(), INT priority = LOAD_PRIORITY_NORMAL );
+	mxLoadRequestPtr	LoadMaterials( const mxChar* filename, INT priority = LOAD_PRIORITY_NORMAL );
+	mxLoadRequestPtr	LoadTexture( const mxChar* filename, INT priority = LOAD_PRIORITY_NORMAL );
+
+					// Changes the priority of a request which is still waiting in the queue.
+	void			SetPriority( mxLoadRequest* request, INT priority );
+
+					// Pending requests are removed from the queue,
+					// the results of requests which are being loaded are discarded.
+	void			Cancel( mxLoadRequest* request );
+
+					// Commits loaded requests, must be called on the main thread (e.g. once per frame).
+					// Returns the number of committed requests.
+	mxUInt			Update( mxUInt maxCommits = MAX_SDWORD );
+
+					// Blocks until the request has finished, must be called on the main thread.
+					// A pending request is loaded on the calling thread.
+	void			Wait( mxLoadRequest* request );
+
+					// Blocks until all submitted requests have finished.
+	void			WaitAll();
+
+					// Returns the number of requests which haven't been committed yet.
+	mxUInt			NumUnfinishedRequests() const;
+
+private:
+	mxLoadRequestPtr	Submit( mxLoadRequest* request );
+
+	mxLoadRequest *	TakeNextPending();
+	bool			LoadNext();
+	void			ExecuteLoad( mxLoadRequest* request );
+	void			ExecuteCommit( mxLoadRequest* request );
+
+	static unsigned int __stdcall WorkerThreadFunc( void* param );
+
+private:
+	TArray< mxLoadRequestPtr >	pending;	// waiting for a worker thread
+	TArray< mxLoadRequestPtr >	loaded;		// waiting to be committed
+	mxUInt		numInProgress;
+	UINT32		nextSequence;
+
+	mutable sys::CriticalSection	lock;	// protects the queues and the request states
+
+	HANDLE		semaphore;	// signalled when a new request has been submitted
+	HANDLE		threads[ MAX_LOADER_THREADS ];
+	mxUInt		numThreads;
+
+	volatile bool	bQuit;
+};
+
+}//End of namespace abc
+
+#endif // ! __MINISG_ASYNC_LOADER_H__
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -543,7 +543,7 @@ private:
 	Token *			m_token;		// current token in the token list
 	TokenList		m_tokenList;	// parsed tokens
 
-	TStringHash< int >	m_keywords;	// keyword IDs hashed by their names
+	THashMap< String, int >	m_keywords;	// keyword IDs hashed by their names
 };
 
 INLINE bool Lexer::IsWhitespace( char c ) {
@@ -957,7 +957,7 @@ void Lexer::SetKeyword( const char* name, int type )
 	Assert( IsValidIdentifier( name ) );
 
 #ifdef MX_DEBUG
-	if ( m_keywords.Get( name ) ) {
+	if ( m_keywords.Contains( name ) ) {
 		sys::Warning( "keyword '%s' already exists", name );
 	}
 #endif // MX_DEBUG
@@ -1119,7 +1119,7 @@ BOOL Lexer::EndOfFile() const
 
 bool Lexer::IsKeyword( const char * text )
 {
-	return m_keywords.Get( text );
+	return m_keywords.Contains( text );
 }
 
 bool Lexer::IsValidIdentifier( const char * text )
@@ -1441,11 +1441,8 @@ void Lexer::Scan( Token * token )
 			ReadName();
 			token->m_text = m_buffer.ToChar();
 
-			int		value;
-			int *	p = & value;
-
 			// if we got a keyword
-			if ( m_keywords.Get( m_buffer, &p ) ) {
+			if ( const int * p = m_keywords.Find( m_buffer ) ) {
 				token->m_type = *p;
 			}
 			else {
@@ -1771,10 +1768,10 @@ public:
 	MaterialParser();
 	~MaterialParser();
 
-	rxMaterial* ParseMaterialScript( const mxChar* filename );
+	bool ParseMaterialScript( const mxChar* filename, MaterialDefinitions &OutMaterials );
 
 private:
-	bool ParseMaterial( rxMaterialDescription &OutDesc );
+	bool ParseMaterial( MaterialDefinition &OutMaterial );
 
 	void ReadOptional( int tokenType );
 	void Expect( int tokenType );
@@ -1905,43 +1902,44 @@ MaterialParser::~MaterialParser()
 {
 }
 
-rxMaterial* MaterialParser::ParseMaterialScript( const mxChar* filename )
+bool MaterialParser::ParseMaterialScript( const mxChar* filename, MaterialDefinitions &OutMaterials )
 {
 	mxFile_ReadOnly  file( filename );
 	if( ! file.IsOk() ) {
-		return null;
+		return false;
 	}
 
 	const mxSizeT  numBytes = file.GetSize();
+	// not from the frame arena: scripts are also parsed on loader threads, which can take longer than two frames
 	BYTE * pScript = (BYTE*) Allocate( numBytes+1, EMemoryClass::MX_MEMORY_CLASS_SCRIPT );
 	file.Read( pScript, numBytes );
 	pScript[ numBytes ] = '\0';
 
 	Lexer::Reset( (const char*) pScript );
 
-	rxResources & resources = mxEngine::get().GetRenderer().GetResources();
-	rxMaterial * lastMaterial = null;
-
 	this->numMaterials = 0;
 
 	while( PeekTokenType() != T_END_OF_FILE )
 	{
-		rxMaterialDescription matDesc;
+		MaterialDefinition & newMaterial = OutMaterials.Alloc();
 
-		if( ParseMaterial( matDesc ) ) {
-			lastMaterial = resources.CreateMaterial( matDesc );
+		if( ParseMaterial( newMaterial ) ) {
 			this->numMaterials++;
+		} else {
+			OutMaterials.RemoveIndex( OutMaterials.Num() - 1 );
 		}
 	}
 
 	Free( pScript, EMemoryClass::MX_MEMORY_CLASS_SCRIPT );
 
 	Assert( this->numMaterials > 0 );
-	return lastMaterial;
+	return ( this->numMaterials > 0 );
 }
 
-bool MaterialParser::ParseMaterial( rxMaterialDescription &OutDesc )
+bool MaterialParser::ParseMaterial( MaterialDefinition &OutMaterial )
 {
+	rxMaterialDescription & OutDesc = OutMaterial.desc;
+
 	Expect( T_MATERIAL );
 	
 	B_RET( ExpectToken( L_IDENTIFIER ) );
@@ -1949,8 +1947,6 @@ bool MaterialParser::ParseMaterial( rxMaterialDescription &OutDesc )
 	
 	Expect( P_LEFT_BRACE );
 
-	rxResources & resources = mxEngine::get().GetRenderer().GetResources();
-
 
 	enum
 	{
@@ -1971,25 +1967,25 @@ bool MaterialParser::ParseMaterial( rxMaterialDescription &OutDesc )
 		{
 			case T_DIFFUSE_MAP :
 				{
-					if( null != OutDesc.layers[TL_Diffuse] ) {
+					if( ! OutMaterial.textureFiles[TL_Diffuse].IsEmpty() ) {
 						sys::Warning("material already has diffuse layer defined");
 						return false;
 					}
 					ReadToken();
 					B_RET( ExpectToken( L_STRING ) );
-					OutDesc.layers[TL_Diffuse] = resources.LoadTexture( CurrentToken().Text() );
+					OutMaterial.textureFiles[TL_Diffuse] = CurrentToken().Text();
 				}
 				continue;
 
 			case T_NORMAL_MAP :
 				{
-					if( null != OutDesc.layers[TL_Normals] ) {
+					if( ! OutMaterial.textureFiles[TL_Normals].IsEmpty() ) {
 						sys::Warning("material already has normal map defined");
 						return false;
 					}
 					ReadToken();
 					B_RET( ExpectToken( L_STRING ) );
-					OutDesc.layers[TL_Normals] = resources.LoadTexture( CurrentToken().Text() );
+					OutMaterial.textureFiles[TL_Normals] = CurrentToken().Text();
 				}
 				continue;
 
@@ -2047,16 +2043,49 @@ void MaterialParser::Expect( int tokenType )
 
 //----------------------------------------------------------------------------------------------------
 
-static MaterialParser  theParser;
+//
+//	ParseMaterialScript
+//
+bool ParseMaterialScript( const mxChar* filename, MaterialDefinitions &OutMaterials )
+{
+	// each call uses its own parser so that scripts can be parsed by several threads at once
+	MaterialParser  parser;
+	return parser.ParseMaterialScript( filename, OutMaterials );
+}
+
+//
+//	CreateMaterials
+//
+rxMaterial* CreateMaterials( const MaterialDefinitions& materials )
+{
+	rxResources & resources = mxEngine::get().GetRenderer().GetResources();
+	rxMaterial * lastMaterial = null;
+
+	for( mxUInt iMaterial = 0; iMaterial < materials.Num(); iMaterial++ )
+	{
+		const MaterialDefinition & material = materials[ iMaterial ];
+
+		rxMaterialDescription  matDesc( material.desc );
+		for( mxUInt iLayer = 0; iLayer < TL_Num_Layers; iLayer++ )
+		{
+			if( ! material.textureFiles[ iLayer ].IsEmpty() ) {
+				matDesc.layers[ iLayer ] = resources.LoadTexture( material.textureFiles[ iLayer ].ToChar() );
+			}
+		}
+		lastMaterial = resources.CreateMaterial( matDesc );
+	}
+	return lastMaterial;
+}
 
 //
 //	LoadMaterialFromFile
 //
 rxMaterial* LoadMaterialFromFile( const mxChar* filename )
 {
-	if( rxMaterial * pLastMaterial = theParser.ParseMaterialScript( filename ) )
+	MaterialDefinitions  materials;
+	if( ParseMaterialScript( filename, materials ) )
 	{
-		return pLastMaterial;
+		return CreateMaterials( materials );
 	} else {
 		sys::Warning( TEXT("Failed to load material script '%s'"), filename );
 		return null;
@@ -10,6 +10,30 @@
 
 namespace abc {
 
+//
+//	MaterialDefinition - a parsed material, textures are referenced by file names.
+//
+struct MaterialDefinition
+{
+	rxMaterialDescription	desc;	// texture layers are set when the material is created
+	String					textureFiles[ TL_Num_Layers ];
+};
+
+typedef TArray< MaterialDefinition >	MaterialDefinitions;
+
+//
+//	ParseMaterialScript - parses a file with material descriptions.
+//
+//	Doesn't create any graphics resources, so it can be called on any thread.
+//
+bool ParseMaterialScript( const mxChar* filename, MaterialDefinitions &OutMaterials );
+
+//
+//	CreateMaterials - creates the parsed materials (and loads their textures),
+//	returns the last created material. Must be called on the main thread.
+//
+rxMaterial* CreateMaterials( const MaterialDefinitions& materials );
+
 //
 //	LoadMaterialFromFile - loads graphics materials from file.
 //
@@ -11,14 +11,23 @@
 
 namespace abc {
 
-mxMesh* LoadMeshFromFile( const mxChar* filename, const MeshDescription& desc )
+namespace {
+
+// The mesh is imported again if any of the import options changes.
+UINT32 GetImportOptionsHash( const MeshDescription& desc )
 {
-	mxFilePath  filepath( filename );
-	if( !filepath.Exists() ) {
-		sys::Warning(TEXT("File %s not found"),filename);
-		return null;
-	}
+	UINT32 hash = mxHashBytes( desc.initialTransform.ToFloatPtr(), sizeof(desc.initialTransform) );
+	hash = mxHashBytes( &desc.texCoordScale, sizeof(desc.texCoordScale), hash );
+	return hash;
+}
 
+// The resource loader (Irrlicht) is not thread-safe,
+// meshes requested by the background loading threads are imported one at a time.
+sys::CriticalSection	gImportLock;
+
+// Imports the mesh from the source file.
+mxMesh* ImportMesh( const mxFilePath& filepath, const MeshDescription& desc )
+{
 	struct MyAlloc : public lol::IAlloc
 	{
 		void * Allocate( size_t numBytes )
@@ -42,6 +51,8 @@ mxMesh* LoadMeshFromFile( const mxChar* filename, const MeshDescription& desc )
 	options.pAlloc		= &myAlloc;
 	options.flags		= lol::Options::ALL;
 
+	sys::ScopedLock  scopedLock( gImportLock );
+
 	lol::Mesh  temp;
 	if( lol::LoadMeshFromFile( filepath.GetName(), &temp, options ) )
 	{
@@ -51,6 +62,7 @@ mxMesh* LoadMeshFromFile( const mxChar* filename, const MeshDescription& desc )
 		newMesh->numIndices		= temp.numIndices;
 		newMesh->indices		= temp.indices;
 		newMesh->bounds			= *(mxBounds*)&temp.bounds;
+		newMesh->RecalculateBounds();
 		return newMesh;
 	}
 	else
@@ -59,6 +71,41 @@ mxMesh* LoadMeshFromFile( const mxChar* filename, const MeshDescription& desc )
 	}
 }
 
+}//End of anonymous namespace
+
+//
+//	Imported meshes are saved into binary cache files next to the source files
+//	and subsequent loads map the cache files instead of parsing the source data.
+//
+mxMesh* LoadMeshFromFile( const mxChar* filename, const MeshDescription& desc )
+{
+	mxFilePath  filepath( filename );
+	if( !filepath.Exists() ) {
+		sys::Warning(TEXT("File %s not found"),filename);
+		return null;
+	}
+
+	mxMeshCacheKey  cacheKey;
+	cacheKey.sourceTimestamp	= sys::GetFileTimestamp( filepath.GetName() );
+	cacheKey.optionsHash		= GetImportOptionsHash( desc );
+
+	String  cacheFileName;
+	_sprintf( cacheFileName, "%s.%08x.mesh", filepath.GetName(), cacheKey.optionsHash );
+
+	if( mxMesh * cachedMesh = LoadMeshCache( cacheFileName.ToChar(), cacheKey ) ) {
+		return cachedMesh;
+	}
+
+	mxMesh * newMesh = ImportMesh( filepath, desc );
+	if( newMesh )
+	{
+		if( !SaveMeshCache( newMesh, cacheFileName.ToChar(), cacheKey ) ) {
+			sys::Warning(TEXT("Failed to write mesh cache file %s"),cacheFileName.ToChar());
+		}
+	}
+	return newMesh;
+}
+
 }//End of namespace abc
 
 //--------------------------------------------------------------//
@@ -0,0 +1,230 @@
+/*
+=============================================================================
+	File:	PackFiles.cpp
+	Desc:	Command-line tool for building pack files.
+=============================================================================
+*/
+
+#include <Base.h>
+
+#include <stdlib.h>
+
+using namespace ::abc;
+
+namespace {
+
+enum
+{
+	NUM_LOOKUP_ITERATIONS	= 100,
+	NUM_READ_ITERATIONS		= 5,
+};
+
+void PrintUsage()
+{
+	sys::Print( "\nUsage: PackFiles [-c] [-b] <archive> <root folder>\n" );
+	sys::Print( "\nPacks all files in the root folder and its subfolders into the archive\n" );
+	sys::Print( "(the archive should be created outside of the root folder).\n" );
+	sys::Print( "\t-c\tcompress files (only if that makes them smaller)\n" );
+	sys::Print( "\t-b\tmeasure lookups and raw reads from the archive and from loose files\n" );
+	sys::Print( "\t\t('Benchmarks PackFiles <folder>' measures them through the file system)\n" );
+}
+
+//
+//	CollectFiles - adds relative names of files in the folder and its subfolders.
+//
+void CollectFiles( const String& rootFolder, const String& relativePath, TArray< String > &OutFileNames )
+{
+	String  searchPattern;
+	_sprintf( searchPattern, "%s%s*", rootFolder.ToChar(), relativePath.ToChar() );
+
+	WIN32_FIND_DATA  findData;
+	const HANDLE hFind = ::FindFirstFile( searchPattern.ToChar(), &findData );
+	if ( hFind == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+
+	do
+	{
+		// skip ".", ".." and hidden folders (e.g. of version control systems)
+		if ( findData.cFileName[0] == '.' ) {
+			continue;
+		}
+
+		String  relativeName( relativePath );
+		relativeName.Append( findData.cFileName );
+
+		if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+		{
+			relativeName.Append( '/' );
+			CollectFiles( rootFolder, relativeName, OutFileNames );
+			continue;
+		}
+
+		OutFileNames.Append( relativeName );
+	}
+	while ( ::FindNextFile( hFind, &findData ) );
+
+	::FindClose( hFind );
+}
+
+struct FileNameLess
+{
+	FORCEINLINE bool operator () ( const String& a, const String& b ) const {
+		return ( String::Icmp( a.ToChar(), b.ToChar() ) < 0 );
+	}
+};
+
+FORCEINLINE mxReal MegabytesPerSecond( UINT64 numBytes, mxUInt milliseconds )
+{
+	return (mxReal) numBytes / ( 1024.0f * 1024.0f ) / ( Max< mxUInt >( milliseconds, 1 ) * 0.001f );
+}
+
+//
+//	RunBenchmarks - compares reading files from the archive with reading loose files.
+//
+void RunBenchmarks( const mxChar* archiveName, const String& rootFolder )
+{
+	mxPackFilePtr  archive( MX_NEW mxPackFile() );
+	if ( ! archive->Open( archiveName ) ) {
+		return;
+	}
+
+	const mxUInt numEntries = archive->NumEntries();
+	if ( numEntries == 0 ) {
+		return;
+	}
+
+	mxUInt  maxFileSize = 0;
+	for ( mxUInt i = 0; i < numEntries; i++ ) {
+		maxFileSize = Max< mxUInt >( maxFileSize, archive->GetEntry( i ).size );
+	}
+
+	TArray< BYTE >  buffer;
+	buffer.SetNum( maxFileSize + 1 );
+
+	// lookups
+	{
+		mxUInt  numFound = 0;
+		const mxUInt startTime = sys::GetMilliseconds();
+		for ( mxUInt iter = 0; iter < NUM_LOOKUP_ITERATIONS; iter++ ) {
+			for ( mxUInt i = 0; i < numEntries; i++ ) {
+				numFound += ( archive->FindEntry( archive->GetEntryName( i ) ) != INDEX_NONE );
+			}
+		}
+		const mxUInt elapsed = sys::GetMilliseconds() - startTime;
+
+		sys::Print( "Lookups: %u in %u ms (%u found)\n",
+			numEntries * NUM_LOOKUP_ITERATIONS, elapsed, numFound );
+	}
+
+	// reads from the archive
+	{
+		UINT64  numBytes = 0;
+		const mxUInt startTime = sys::GetMilliseconds();
+		for ( mxUInt iter = 0; iter < NUM_READ_ITERATIONS; iter++ ) {
+			for ( mxUInt i = 0; i < numEntries; i++ ) {
+				if ( archive->ReadEntry( i, buffer.Ptr() ) ) {
+					numBytes += archive->GetEntry( i ).size;
+				}
+			}
+		}
+		const mxUInt elapsed = sys::GetMilliseconds() - startTime;
+
+		sys::Print( "Packed reads: %u files in %u ms, %.1f MB/s\n",
+			numEntries * NUM_READ_ITERATIONS, elapsed, MegabytesPerSecond( numBytes, elapsed ) );
+	}
+
+	// reads of loose files (the OS file cache is warm after packing)
+	{
+		UINT64  numBytes = 0;
+		const mxUInt startTime = sys::GetMilliseconds();
+		for ( mxUInt iter = 0; iter < NUM_READ_ITERATIONS; iter++ ) {
+			for ( mxUInt i = 0; i < numEntries; i++ )
+			{
+				String  filePath;
+				_sprintf( filePath, "%s%s", rootFolder.ToChar(), archive->GetEntryName( i ) );
+
+				FILE * file = fopen( filePath.ToChar(), "rb" );
+				if ( file ) {
+					numBytes += fread( buffer.Ptr(), 1, buffer.Num(), file );
+					fclose( file );
+				}
+			}
+		}
+		const mxUInt elapsed = sys::GetMilliseconds() - startTime;
+
+		sys::Print( "Loose reads: %u files in %u ms, %.1f MB/s\n",
+			numEntries * NUM_READ_ITERATIONS, elapsed, MegabytesPerSecond( numBytes, elapsed ) );
+	}
+}
+
+}//End of anonymous namespace
+
+int main( int argc, char *argv[] )
+{
+	bool  bCompress = false;
+	bool  bBenchmark = false;
+	const char * archiveName = null;
+	const char * rootFolderName = null;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( String::Cmp( argv[i], "-c" ) == 0 ) {
+			bCompress = true;
+		}
+		else if ( String::Cmp( argv[i], "-b" ) == 0 ) {
+			bBenchmark = true;
+		}
+		else if ( ! archiveName ) {
+			archiveName = argv[i];
+		}
+		else if ( ! rootFolderName ) {
+			rootFolderName = argv[i];
+		}
+		else {
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ( ! archiveName || ! rootFolderName ) {
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	// file names are appended to the root folder
+	String  rootFolder( rootFolderName );
+	if ( ! rootFolder.IsEmpty() ) {
+		const mxChar lastChar = rootFolder[ rootFolder.Length() - 1 ];
+		if ( lastChar != '/' && lastChar != '\\' ) {
+			rootFolder.Append( '/' );
+		}
+	}
+
+	TArray< String >  fileNames;
+	CollectFiles( rootFolder, String(), fileNames );
+
+	// the names are sorted so that the archive doesn't depend on the order of enumeration
+	fileNames.Sort( FileNameLess() );
+
+	sys::Print( "Packing %u files from '%s' into '%s'...\n",
+		fileNames.Num(), rootFolder.ToChar(), archiveName );
+
+	const mxUInt startTime = sys::GetMilliseconds();
+
+	if ( ! mxWritePackFile( archiveName, rootFolder.ToChar(), fileNames, bCompress ) ) {
+		return EXIT_FAILURE;
+	}
+
+	sys::Print( "Done in %u ms\n", sys::GetMilliseconds() - startTime );
+
+	if ( bBenchmark ) {
+		RunBenchmarks( archiveName, rootFolder );
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------//
+//				End Of File.									//
+//--------------------------------------------------------------//
@@ -148,6 +148,7 @@ int main( int argc, char *argv[] )
 	cInfo.driverType = 
 	//	EDriverType::GAPI_DirectX_9
 		EDriverType::GAPI_DirectX_10
+	//	EDriverType::GAPI_None	// headless, for profiling the CPU side of the renderer
 	//	EDriverType::GAPI_AutomaticSelection
 		;
 